@@ -21,6 +21,38 @@ declare interface ScriptConnection {
 }
 
 
+/** ControlHandleJSProxy */
+
+declare interface ControlHandle {
+    /** Group of the control e.g. "[Channel1]" */
+    readonly group: string;
+
+    /** Name of the control e.g. "play_indicator" */
+    readonly item: string;
+
+    /**
+     * Value of the control (within it's range according Mixxx Controls manual page:
+     * https://manual.mixxx.org/latest/chapters/appendix/mixxx_controls.html)
+     *
+     * Same as {@link engine.getValue} and {@link engine.setValue}, but without looking up the control
+     */
+    value: number;
+
+    /**
+     * Value of the control normalized to a range of 0..1
+     *
+     * Same as {@link engine.getParameter} and {@link engine.setParameter}, but without looking up the control
+     */
+    parameter: number;
+
+    /** Resets the control to its default value */
+    reset(): void;
+
+    /** Triggers the execution of all callback functions connected to the control */
+    trigger(): void;
+}
+
+
 /** ControllerScriptInterfaceLegacy */
 
 declare namespace engine {
@@ -101,6 +133,25 @@ declare namespace engine {
      */
     function getDefaultParameter(group: string, name: string): number;
 
+    /**
+     * Returns a handle to a control, which provides fast access to its value
+     *
+     * Mappings that access a control frequently, e.g. for each message of a jog wheel,
+     * should get the handle once and use it instead of {@link engine.getValue} and {@link engine.setValue}.
+     *
+     * @param group Group of the control e.g. "[Channel1]"
+     * @param name Name of the control e.g. "play_indicator"
+     * @returns Returns the handle on success, otherwise 'undefined'
+     */
+    function getControl(group: string, name: string): ControlHandle | undefined;
+
+    /**
+     * Sets the values of multiple controls with a single call
+     *
+     * @param handlesAndValues Array of pairs of a handle returned by {@link engine.getControl} and the value to be set
+     */
+    function setValues(handlesAndValues: [ControlHandle, number][]): void;
+
     type CoCallback = (value: number, group: string, name: string) => void
 
     /**
@@ -280,4 +331,18 @@ declare namespace engine {
      *               SoftStart with low factors would take a while until sound is audible. [default = 1.0]
      */
     function softStart(deck: number, activate: boolean, factor?: number): void;
+
+    /**
+     * Passes the data of incoming packets to the incomingData functions in recycled arrays
+     * instead of allocating a new Uint8Array for every packet. This avoids frequent garbage
+     * collection for devices that send packets at a high rate, e.g. HID jog wheels.
+     *
+     * An array is overwritten with the data of a later packet of the same size after
+     * 4 further packets of that size, i.e. the previous packets may be kept for comparison,
+     * but arrays that are needed for longer must be copied. Recycling is disabled by default
+     * and needs to be enabled again after the scripts have been reloaded, e.g. in init().
+     *
+     * @param enable Set true to recycle the arrays
+     */
+    function setIncomingDataRecycling(enable: boolean): void;
 }
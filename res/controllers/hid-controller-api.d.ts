@@ -44,7 +44,9 @@ declare namespace controller {
      * Sends an OutputReport to HID device
      *
      *  @param reportID 1...255 for HID devices that uses ReportIDs - or 0 for devices, which don't use ReportIDs
-     *  @param dataArray Data to send as byte array
+     *  @param dataArray Data to send as byte array. The data is copied into memory that is
+     *                   allocated once per report, i.e. the same array can be modified and
+     *                   sent again instead of allocating a new array for every report.
      *  @param useNonSkippingFIFO If set, the report will send in FIFO mode
      *
      *   `false` (default):
@@ -6,6 +6,11 @@ declare namespace midi {
     /**
      * Sends a 3 byte MIDI short message
      *
+     * If output coalescing is enabled in the preferences, the message is sent
+     * at the end of the current output frame and replaces earlier messages for
+     * the same note or controller. Messages that don't change the last sent
+     * value are dropped.
+     *
      * @param status Status byte
      * @param byte1 Data byte 1
      * @param byte2 Data byte 2
@@ -124,6 +124,7 @@ void AnalyzerThread::doRun() {
 
     mixxx::AudioSource::OpenParams openParams;
     openParams.setChannelCount(mixxx::kAnalysisChannels);
+    openParams.setAccessPattern(mixxx::AudioSource::AccessPattern::Sequential);
 
     while (awaitWorkItemsFetched()) {
         DEBUG_ASSERT(m_currentTrack.has_value());
@@ -1,6 +1,8 @@
 #include "control/control.h"
 
+#include "control/controlnotificationqueue.h"
 #include "control/controlobject.h"
+#include "control/controlregistry.h"
 #include "moc_control.cpp"
 #include "util/stat.h"
 
@@ -13,24 +15,24 @@ namespace {
 /// configuration object would be arduous.
 UserSettingsPointer s_pUserConfig;
 
-/// Mutex guarding access to s_qCOHash and s_qCOAliasHash.
-MMutex s_qCOHashMutex;
-
-/// Hash of ControlDoublePrivate instantiations.
-QHash<ConfigKey, QWeakPointer<ControlDoublePrivate>> s_qCOHash
-        GUARDED_BY(s_qCOHashMutex);
+/// Mutex guarding access to s_qCOAliasHash.
+MMutex s_qCOAliasHashMutex;
 
 /// Hash of aliases between ConfigKeys. Solely used for looking up the first
 /// alias associated with a key.
 QHash<ConfigKey, ConfigKey> s_qCOAliasHash
-        GUARDED_BY(s_qCOHashMutex);
+        GUARDED_BY(s_qCOAliasHashMutex);
+
+/// Mutex guarding the creation of s_pDefaultCO.
+MMutex s_defaultCOMutex;
 
 /// is used instead of a nullptr, helps to omit null checks everywhere
 QWeakPointer<ControlDoublePrivate> s_pDefaultCO;
 } // namespace
 
 ControlDoublePrivate::ControlDoublePrivate()
-        : m_bPersistInConfiguration(false),
+        : m_id(ControlRegistry::kInvalidId),
+          m_bPersistInConfiguration(false),
           m_bIgnoreNops(true),
           m_bTrack(false),
           m_trackType(Stat::UNSPECIFIED),
@@ -38,7 +40,9 @@ ControlDoublePrivate::ControlDoublePrivate()
                   Stat::SAMPLE_VARIANCE | Stat::MIN | Stat::MAX),
           // default CO is read only
           m_confirmRequired(true),
-          m_kbdRepeatable(false) {
+          m_kbdRepeatable(false),
+          m_deferredNotification(false),
+          m_valueChangedPending(false) {
     m_value.setValue(0.0);
 }
 
@@ -51,6 +55,7 @@ ControlDoublePrivate::ControlDoublePrivate(
         double defaultValue)
         : m_key(key),
           m_pCreatorCO(pCreatorCO),
+          m_id(ControlRegistry::kInvalidId),
           m_bPersistInConfiguration(bPersist),
           m_bIgnoreNops(bIgnoreNops),
           m_bTrack(bTrack),
@@ -58,7 +63,9 @@ ControlDoublePrivate::ControlDoublePrivate(
           m_trackFlags(Stat::COUNT | Stat::SUM | Stat::AVERAGE |
                   Stat::SAMPLE_VARIANCE | Stat::MIN | Stat::MAX),
           m_confirmRequired(false),
-          m_kbdRepeatable(false) {
+          m_kbdRepeatable(false),
+          m_deferredNotification(false),
+          m_valueChangedPending(false) {
     initialize(defaultValue);
 }
 
@@ -87,10 +94,7 @@ void ControlDoublePrivate::initialize(double defaultValue) {
 }
 
 ControlDoublePrivate::~ControlDoublePrivate() {
-    s_qCOHashMutex.lock();
-    //qDebug() << "ControlDoublePrivate::s_qCOHash.remove(" << m_key.group << "," << m_key.item << ")";
-    s_qCOHash.remove(m_key);
-    s_qCOHashMutex.unlock();
+    ControlRegistry::removeExpired(m_key);
 
     if (m_bPersistInConfiguration) {
         UserSettingsPointer pConfig = s_pUserConfig;
@@ -109,22 +113,13 @@ void ControlDoublePrivate::setUserConfig(const UserSettingsPointer& pConfig) {
 
 // static
 void ControlDoublePrivate::insertAlias(const ConfigKey& alias, const ConfigKey& key) {
-    MMutexLocker locker(&s_qCOHashMutex);
-
-    auto it = s_qCOHash.constFind(key);
-    VERIFY_OR_DEBUG_ASSERT(it != s_qCOHash.constEnd()) {
-        qWarning() << "cannot create alias for null control" << key;
-        return;
-    }
-
-    QSharedPointer<ControlDoublePrivate> pControl = it.value();
-    VERIFY_OR_DEBUG_ASSERT(!pControl.isNull()) {
-        qWarning() << "cannot create alias for expired control" << key;
+    VERIFY_OR_DEBUG_ASSERT(ControlRegistry::insertAlias(alias, key)) {
+        qWarning() << "cannot create alias for null or expired control" << key;
         return;
     }
 
+    MMutexLocker locker(&s_qCOAliasHashMutex);
     s_qCOAliasHash.insert(key, alias);
-    s_qCOHash.insert(alias, pControl);
 }
 
 // static
@@ -145,28 +140,18 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getControl(
         return nullptr;
     }
 
-    // Scope for MMutexLocker.
-    {
-        const MMutexLocker locker(&s_qCOHashMutex);
-        const auto it = s_qCOHash.find(key);
-        if (it != s_qCOHash.end()) {
-            auto pControl = it.value().lock();
-            if (pControl) {
-                // Control object already exists
-                if (pCreatorCO) {
-                    qWarning()
-                            << "ControlObject"
-                            << key.group << key.item
-                            << "already created";
-                    DEBUG_ASSERT(!"pCreatorCO != nullptr, ControlObject already created");
-                    return nullptr;
-                }
-                return pControl;
-            } else {
-                // The weak pointer has become invalid and can be cleaned up
-                s_qCOHash.erase(it);
-            }
+    auto pExistingControl = ControlRegistry::lookup(key);
+    if (pExistingControl) {
+        // Control object already exists
+        if (pCreatorCO) {
+            qWarning()
+                    << "ControlObject"
+                    << key.group << key.item
+                    << "already created";
+            DEBUG_ASSERT(!"pCreatorCO != nullptr, ControlObject already created");
+            return nullptr;
         }
+        return pExistingControl;
     }
 
     if (pCreatorCO) {
@@ -177,9 +162,9 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getControl(
                         bTrack,
                         bPersist,
                         defaultValue));
-        const MMutexLocker locker(&s_qCOHashMutex);
-        //qDebug() << "ControlDoublePrivate::s_qCOHash.insert(" << key.group << "," << key.item << ")";
-        s_qCOHash.insert(key, pControl);
+        // The id must be valid before the control is published
+        pControl->m_id = ControlRegistry::intern(key);
+        ControlRegistry::insert(pControl->m_id, pControl);
         return pControl;
     }
 
@@ -198,7 +183,7 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getDefaultControl() {
         // Try again with the mutex locked to protect against creating two
         // ControlDoublePrivateConst objects. Access to s_defaultCO itself is
         // thread save.
-        MMutexLocker locker(&s_qCOHashMutex);
+        MMutexLocker locker(&s_defaultCOMutex);
         defaultCO = s_pDefaultCO.lock();
         if (!defaultCO) {
             defaultCO = QSharedPointer<ControlDoublePrivate>(new ControlDoublePrivateConst());
@@ -210,39 +195,17 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getDefaultControl() {
 
 // static
 QList<QSharedPointer<ControlDoublePrivate>> ControlDoublePrivate::getAllInstances() {
-    QList<QSharedPointer<ControlDoublePrivate>> result;
-    MMutexLocker locker(&s_qCOHashMutex);
-    result.reserve(s_qCOHash.size());
-    for (auto it = s_qCOHash.begin(); it != s_qCOHash.end(); ++it) {
-        auto pControl = it.value().lock();
-        if (pControl) {
-            result.append(std::move(pControl));
-        } else {
-            // The weak pointer has become invalid and can be cleaned up
-            s_qCOHash.erase(it);
-        }
-    }
-    return result;
+    return ControlRegistry::getAll();
 }
 
 // static
 QList<QSharedPointer<ControlDoublePrivate>> ControlDoublePrivate::takeAllInstances() {
-    QList<QSharedPointer<ControlDoublePrivate>> result;
-    MMutexLocker locker(&s_qCOHashMutex);
-    result.reserve(s_qCOHash.size());
-    for (auto it = s_qCOHash.begin(); it != s_qCOHash.end(); ++it) {
-        auto pControl = it.value().lock();
-        if (pControl) {
-            result.append(std::move(pControl));
-        }
-    }
-    s_qCOHash.clear();
-    return result;
+    return ControlRegistry::takeAll();
 }
 
 //static
 QHash<ConfigKey, ConfigKey> ControlDoublePrivate::getControlAliases() {
-    MMutexLocker locker(&s_qCOHashMutex);
+    MMutexLocker locker(&s_qCOAliasHashMutex);
     // lock thread-unsafe copy constructors of QHash
     return s_qCOAliasHash;
 }
@@ -281,7 +244,15 @@ void ControlDoublePrivate::setInner(double value, QObject* pSender) {
         return;
     }
     m_value.setValue(value);
-    emit valueChanged(value, pSender);
+    // Listeners that are connected to the creator CO ignore its own changes,
+    // so only the delivery to other threads is deferred.
+    if (m_deferredNotification &&
+            pSender == getCreatorCO() &&
+            ControlNotificationQueue::isProducerThread()) {
+        enqueueValueChanged();
+    } else {
+        emit valueChanged(value, pSender);
+    }
 
     if (m_bTrack) {
         Stat::track(m_trackKey, static_cast<Stat::StatType>(m_trackType),
@@ -289,6 +260,23 @@ void ControlDoublePrivate::setInner(double value, QObject* pSender) {
     }
 }
 
+void ControlDoublePrivate::enqueueValueChanged() {
+    if (m_valueChangedPending.exchange(true)) {
+        // Already enqueued, the current value will be emitted on dispatch
+        return;
+    }
+    if (!ControlNotificationQueue::enqueue(sharedFromThis())) {
+        m_valueChangedPending.store(false);
+        emit valueChanged(get(), getCreatorCO());
+    }
+}
+
+void ControlDoublePrivate::emitDeferredValueChanged() {
+    // Reset before reading the value to not miss any subsequent change
+    m_valueChangedPending.store(false);
+    emit valueChanged(get(), getCreatorCO());
+}
+
 void ControlDoublePrivate::setBehavior(ControlNumericBehavior* pBehavior) {
     // This marks the old mpBehavior for deletion. It is deleted once it is not
     // used in any other function
@@ -5,6 +5,7 @@
 #include <QObject>
 #include <QSharedPointer>
 #include <QString>
+#include <atomic>
 
 #include "control/controlbehavior.h"
 #include "control/controlvalue.h"
@@ -29,7 +30,8 @@ enum class ControlFlag {
 Q_DECLARE_FLAGS(ControlFlags, ControlFlag)
 Q_DECLARE_OPERATORS_FOR_FLAGS(ControlFlags)
 
-class ControlDoublePrivate : public QObject {
+class ControlDoublePrivate : public QObject,
+                             public QEnableSharedFromThis<ControlDoublePrivate> {
     Q_OBJECT
   public:
     ~ControlDoublePrivate() override;
@@ -88,6 +90,18 @@ class ControlDoublePrivate : public QObject {
         return m_kbdRepeatable;
     }
 
+    // If enabled, changes that the creator CO sets from the engine thread are
+    // not emitted immediately but delivered coalesced from the main thread,
+    // see ControlNotificationQueue. Only suitable for controls whose
+    // listeners do not depend on being notified synchronously.
+    void setDeferredNotification(bool deferred) {
+        m_deferredNotification = deferred;
+    }
+
+    bool hasDeferredNotification() const {
+        return m_deferredNotification;
+    }
+
     // Sets the control value.
     void set(double value, QObject* pSender);
     // directly sets the control value. Must be used from and only from the
@@ -141,6 +155,12 @@ class ControlDoublePrivate : public QObject {
         return m_key;
     }
 
+    // The interned id of the key for repeated lookups with
+    // ControlRegistry::lookup().
+    int getId() const {
+        return m_id;
+    }
+
     // Connects a slot to the ValueChange request for CO validation. All change
     // requests issued by set are routed though the connected slot. This can
     // decide with its own thread safe solution if the requested value can be
@@ -181,10 +201,15 @@ class ControlDoublePrivate : public QObject {
     void initialize(double defaultValue);
     virtual void setInner(double value, QObject* pSender);
 
+    void enqueueValueChanged();
+    void emitDeferredValueChanged();
+
     const ConfigKey m_key;
 
     QAtomicPointer<ControlObject> m_pCreatorCO;
 
+    int m_id;
+
     // Whether the control should persist in the Mixxx user configuration. The
     // value is loaded from configuration when the control is created and
     // written to the configuration when the control is deleted.
@@ -209,12 +234,18 @@ class ControlDoublePrivate : public QObject {
     // If true, this control will be issued repeatedly if the keyboard key is held.
     bool m_kbdRepeatable;
 
+    bool m_deferredNotification;
+    // Set while the control is waiting in the ControlNotificationQueue.
+    std::atomic<bool> m_valueChangedPending;
+
     // The control value.
     ControlValueAtomic<double> m_value;
     // The default control value.
     ControlValueAtomic<double> m_defaultValue;
 
     QSharedPointer<ControlNumericBehavior> m_pBehavior;
+
+    friend class ControlNotificationQueue;
 };
 
 /// The constant ControlDoublePrivate version is used as dummy for default
@@ -0,0 +1,21 @@
+#include "control/controlnotificationdispatcher.h"
+
+#include "control/controlnotificationqueue.h"
+#include "moc_controlnotificationdispatcher.cpp"
+
+namespace mixxx {
+
+ControlNotificationDispatcher::ControlNotificationDispatcher(QObject* pParent)
+        : QObject(pParent) {
+    connect(&m_timer,
+            &QTimer::timeout,
+            this,
+            &ControlNotificationDispatcher::slotTimeout);
+    m_timer.start(kIntervalMillis);
+}
+
+void ControlNotificationDispatcher::slotTimeout() {
+    ControlNotificationQueue::dispatch();
+}
+
+} // namespace mixxx
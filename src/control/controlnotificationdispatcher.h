@@ -0,0 +1,28 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+
+namespace mixxx {
+
+/// Periodically delivers the deferred control change notifications of the
+/// engine thread, see ControlNotificationQueue, on the main thread.
+///
+/// Legacy skins additionally dispatch them once per rendered frame, see
+/// GuiTick. Controllers and QML skins only rely on this timer.
+class ControlNotificationDispatcher : public QObject {
+    Q_OBJECT
+  public:
+    /// About once per frame at 60 Hz
+    static constexpr int kIntervalMillis = 16;
+
+    ControlNotificationDispatcher(QObject* pParent = nullptr);
+
+  private slots:
+    void slotTimeout();
+
+  private:
+    QTimer m_timer;
+};
+
+} // namespace mixxx
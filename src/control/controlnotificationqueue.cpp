@@ -0,0 +1,86 @@
+#include "control/controlnotificationqueue.h"
+
+#include <atomic>
+
+#include "control/control.h"
+#include "rigtorp/SPSCQueue.h"
+#include "util/assert.h"
+
+namespace {
+
+/// Each control is enqueued at most once until the next dispatch, i.e. the
+/// capacity only needs to exceed the number of controls with deferred
+/// notifications.
+constexpr std::size_t kQueueCapacity = 4096;
+
+/// Allocated during static initialization and not on first use, which might
+/// happen on the engine thread.
+rigtorp::SPSCQueue<QWeakPointer<ControlDoublePrivate>> s_queue(kQueueCapacity);
+
+std::atomic<int> s_producerCount = 0;
+
+std::atomic<int> s_overflowCount = 0;
+
+thread_local bool s_isProducerThread = false;
+
+} // namespace
+
+ControlNotificationQueue::ProducerScope::ProducerScope()
+        : m_wasProducerThread(s_isProducerThread) {
+    if (!m_wasProducerThread) {
+        // The queue only supports a single producer
+        const int producerCount = s_producerCount.fetch_add(1);
+        DEBUG_ASSERT(producerCount == 0);
+        Q_UNUSED(producerCount);
+        s_isProducerThread = true;
+    }
+}
+
+ControlNotificationQueue::ProducerScope::~ProducerScope() {
+    if (!m_wasProducerThread) {
+        s_isProducerThread = false;
+        s_producerCount.fetch_sub(1);
+    }
+}
+
+// static
+bool ControlNotificationQueue::isProducerThread() {
+    return s_isProducerThread;
+}
+
+// static
+bool ControlNotificationQueue::enqueue(QWeakPointer<ControlDoublePrivate>&& pControl) {
+    DEBUG_ASSERT(s_isProducerThread);
+    if (!s_queue.try_emplace(std::move(pControl))) {
+        s_overflowCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+// static
+int ControlNotificationQueue::dispatch() {
+    int count = 0;
+    // Only dispatch what is pending now, the producer might keep on appending
+    // notifications while dispatching.
+    for (std::size_t pending = s_queue.size(); pending > 0; --pending) {
+        QWeakPointer<ControlDoublePrivate>* pFront = s_queue.front();
+        VERIFY_OR_DEBUG_ASSERT(pFront) {
+            break;
+        }
+        // The last reference to a control might be released by pop(), which
+        // is fine on the main thread.
+        const QSharedPointer<ControlDoublePrivate> pControl = pFront->toStrongRef();
+        s_queue.pop();
+        if (pControl) {
+            pControl->emitDeferredValueChanged();
+            ++count;
+        }
+    }
+    return count;
+}
+
+// static
+int ControlNotificationQueue::overflowCount() {
+    return s_overflowCount.load(std::memory_order_relaxed);
+}
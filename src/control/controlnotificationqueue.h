@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QSharedPointer>
+
+class ControlDoublePrivate;
+
+/// Delivers the value change notifications of controls that are set from the
+/// real-time engine thread to the main thread.
+///
+/// Emitting a signal on the engine thread allocates a QMetaCallEvent and
+/// takes the connection list locks for every queued connection. Instead,
+/// controls with deferred notifications that are set on the producer thread
+/// are only marked as changed and appended to a lock-free queue with a
+/// fixed capacity. Each control is enqueued at most once until dispatch()
+/// has emitted its current value, i.e. notifications are coalesced.
+class ControlNotificationQueue final {
+  public:
+    /// Marks the current thread as the single producer for the lifetime of
+    /// the scope, e.g. for the duration of an audio callback.
+    class ProducerScope final {
+      public:
+        ProducerScope();
+        ~ProducerScope();
+
+        ProducerScope(const ProducerScope&) = delete;
+        ProducerScope& operator=(const ProducerScope&) = delete;
+
+      private:
+        const bool m_wasProducerThread;
+    };
+
+    static bool isProducerThread();
+
+    /// Real-time safe. Returns false if the queue is full.
+    static bool enqueue(QWeakPointer<ControlDoublePrivate>&& pControl);
+
+    /// Emits the pending notifications with the current control values.
+    /// Must only be called from the main thread, see
+    /// mixxx::ControlNotificationDispatcher. Returns the number of
+    /// notifications that have been emitted.
+    static int dispatch();
+
+    /// The number of notifications that had to be emitted immediately on
+    /// the producer thread because the queue was full.
+    static int overflowCount();
+};
@@ -66,6 +66,14 @@ class ControlObject : public QObject {
         return m_pControl ? m_pControl->getKbdRepeatable() : false;
     }
 
+    // Deliver the changes that are set by this object from the engine thread
+    // coalesced from the main thread, see ControlNotificationQueue.
+    void setDeferredNotification(bool deferred) {
+        if (m_pControl) {
+            m_pControl->setDeferredNotification(deferred);
+        }
+    }
+
     // Return the key of the object
     inline ConfigKey getKey() const {
         return m_key;
@@ -26,6 +26,12 @@ class ControlObjectScript : public ControlProxy {
             return m_scriptConnections.first(); };
     void disconnectAllConnectionsToFunction(const QJSValue& function);
 
+    /// The ControlObject of the control, e.g. for soft-takeover. Unlike
+    /// ControlObject::getControl() this doesn't look up the key.
+    ControlObject* getControlObject() const {
+        return m_pControl->getCreatorCO();
+    }
+
     // Called from update();
     void emitValueChanged() override {
         emit trigger(get(), this);
@@ -0,0 +1,203 @@
+#include "control/controlregistry.h"
+
+#include <QHash>
+#include <QVector>
+#include <array>
+
+#include "control/control.h"
+#include "util/assert.h"
+#include "util/mutex.h"
+
+namespace {
+
+constexpr int kShardCount = 16;
+
+/// The hash of a key is calculated only once per lookup, both for selecting
+/// the shard and for the lookup within the shard.
+struct HashedKey {
+    ConfigKey key;
+    qhash_seed_t hash;
+};
+
+inline bool operator==(const HashedKey& lhs, const HashedKey& rhs) {
+    return lhs.hash == rhs.hash && lhs.key == rhs.key;
+}
+
+inline qhash_seed_t qHash(
+        const HashedKey& hashedKey,
+        qhash_seed_t seed = 0) {
+    return hashedKey.hash ^ seed;
+}
+
+HashedKey hashKey(const ConfigKey& key) {
+    return HashedKey{key, qHash(key)};
+}
+
+struct KeyEntry {
+    int id;
+    bool isAlias;
+};
+
+struct Shard {
+    MReadWriteLock lock;
+    /// The interned keys that hash to this shard. The ids of aliases might
+    /// refer to controls of other shards.
+    QHash<HashedKey, KeyEntry> keys GUARDED_BY(lock);
+    /// The controls for the ids of this shard, indexed by id / kShardCount.
+    QVector<QWeakPointer<ControlDoublePrivate>> controls GUARDED_BY(lock);
+};
+
+std::array<Shard, kShardCount> s_shards;
+
+inline int shardIndexOfHash(qhash_seed_t hash) {
+    return static_cast<int>(hash % kShardCount);
+}
+
+inline int shardIndexOfId(int id) {
+    return id % kShardCount;
+}
+
+inline int slotIndexOfId(int id) {
+    return id / kShardCount;
+}
+
+} // namespace
+
+// static
+int ControlRegistry::findId(const ConfigKey& key) {
+    const HashedKey hashedKey = hashKey(key);
+    Shard& shard = s_shards[shardIndexOfHash(hashedKey.hash)];
+    const MReadLocker locker(&shard.lock);
+    const auto it = shard.keys.constFind(hashedKey);
+    if (it == shard.keys.constEnd()) {
+        return kInvalidId;
+    }
+    return it->id;
+}
+
+// static
+QSharedPointer<ControlDoublePrivate> ControlRegistry::lookup(const ConfigKey& key) {
+    return lookup(findId(key));
+}
+
+// static
+QSharedPointer<ControlDoublePrivate> ControlRegistry::lookup(int id) {
+    if (id == kInvalidId) {
+        return nullptr;
+    }
+    DEBUG_ASSERT(id >= 0);
+    Shard& shard = s_shards[shardIndexOfId(id)];
+    const int slotIndex = slotIndexOfId(id);
+    const MReadLocker locker(&shard.lock);
+    VERIFY_OR_DEBUG_ASSERT(slotIndex < shard.controls.size()) {
+        return nullptr;
+    }
+    return shard.controls.at(slotIndex).toStrongRef();
+}
+
+// static
+int ControlRegistry::intern(const ConfigKey& key) {
+    const HashedKey hashedKey = hashKey(key);
+    const int shardIndex = shardIndexOfHash(hashedKey.hash);
+    Shard& shard = s_shards[shardIndex];
+    {
+        const MReadLocker locker(&shard.lock);
+        const auto it = shard.keys.constFind(hashedKey);
+        if (it != shard.keys.constEnd() && !it->isAlias) {
+            return it->id;
+        }
+    }
+    const MWriteLocker locker(&shard.lock);
+    const auto it = shard.keys.constFind(hashedKey);
+    if (it != shard.keys.constEnd() && !it->isAlias) {
+        // Interned concurrently
+        return it->id;
+    }
+    // A new key or an alias that is replaced by a separate control
+    const int id = shard.controls.size() * kShardCount + shardIndex;
+    shard.controls.append(QWeakPointer<ControlDoublePrivate>());
+    shard.keys.insert(hashedKey, KeyEntry{id, false});
+    return id;
+}
+
+// static
+void ControlRegistry::insert(int id,
+        const QSharedPointer<ControlDoublePrivate>& pControl) {
+    VERIFY_OR_DEBUG_ASSERT(id >= 0) {
+        return;
+    }
+    Shard& shard = s_shards[shardIndexOfId(id)];
+    const int slotIndex = slotIndexOfId(id);
+    const MWriteLocker locker(&shard.lock);
+    VERIFY_OR_DEBUG_ASSERT(slotIndex < shard.controls.size()) {
+        return;
+    }
+    shard.controls[slotIndex] = pControl;
+}
+
+// static
+bool ControlRegistry::insertAlias(const ConfigKey& alias, const ConfigKey& key) {
+    const int id = findId(key);
+    if (!lookup(id)) {
+        return false;
+    }
+    const HashedKey hashedAlias = hashKey(alias);
+    Shard& shard = s_shards[shardIndexOfHash(hashedAlias.hash)];
+    const MWriteLocker locker(&shard.lock);
+    shard.keys.insert(hashedAlias, KeyEntry{id, true});
+    return true;
+}
+
+// static
+void ControlRegistry::removeExpired(const ConfigKey& key) {
+    const HashedKey hashedKey = hashKey(key);
+    Shard& shard = s_shards[shardIndexOfHash(hashedKey.hash)];
+    const MWriteLocker locker(&shard.lock);
+    const auto it = shard.keys.constFind(hashedKey);
+    if (it == shard.keys.constEnd() || it->isAlias) {
+        return;
+    }
+    QWeakPointer<ControlDoublePrivate>& pControl = shard.controls[slotIndexOfId(it->id)];
+    if (pControl.isNull()) {
+        // Might have been replaced by a new control for the same key
+        pControl.clear();
+    }
+}
+
+// static
+QList<QSharedPointer<ControlDoublePrivate>> ControlRegistry::getAll() {
+    QList<QSharedPointer<ControlDoublePrivate>> result;
+    for (auto& shard : s_shards) {
+        const MReadLocker locker(&shard.lock);
+        for (const auto& pWeakControl : qAsConst(shard.controls)) {
+            auto pControl = pWeakControl.toStrongRef();
+            if (pControl) {
+                result.append(std::move(pControl));
+            }
+        }
+    }
+    return result;
+}
+
+// static
+QList<QSharedPointer<ControlDoublePrivate>> ControlRegistry::takeAll() {
+    QList<QSharedPointer<ControlDoublePrivate>> result;
+    for (auto& shard : s_shards) {
+        const MWriteLocker locker(&shard.lock);
+        for (auto& pWeakControl : shard.controls) {
+            auto pControl = pWeakControl.toStrongRef();
+            pWeakControl.clear();
+            if (pControl) {
+                result.append(std::move(pControl));
+            }
+        }
+        for (auto it = shard.keys.begin(); it != shard.keys.end();) {
+            if (it->isAlias) {
+                it = shard.keys.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    return result;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QList>
+#include <QSharedPointer>
+
+#include "preferences/configobject.h"
+
+class ControlDoublePrivate;
+
+/// Registry of all ControlDoublePrivate instances by ConfigKey.
+///
+/// Each ConfigKey is interned to an integer id when it is registered for the
+/// first time. Ids are never reused while the process is running. Callers
+/// can store them for repeated lookups that neither hash nor compare the
+/// strings of the key.
+///
+/// The registry is split into shards with separate read-write locks. Lookups
+/// only take the read lock of a single shard and do not contend with each
+/// other, e.g. while a skin and a controller mapping are loaded concurrently.
+///
+/// All functions are thread-safe.
+class ControlRegistry final {
+  public:
+    static constexpr int kInvalidId = -1;
+
+    /// Returns kInvalidId if the key has never been registered.
+    static int findId(const ConfigKey& key);
+
+    /// Returns nullptr if no control is registered for the key or id.
+    static QSharedPointer<ControlDoublePrivate> lookup(const ConfigKey& key);
+    static QSharedPointer<ControlDoublePrivate> lookup(int id);
+
+    /// Returns the id of the key, which is allocated if the key has never
+    /// been registered or is an alias.
+    static int intern(const ConfigKey& key);
+
+    /// Registers the control for the id of its interned key.
+    static void insert(int id,
+            const QSharedPointer<ControlDoublePrivate>& pControl);
+
+    /// Makes the control of key available by alias. Returns false if no
+    /// control is registered for key.
+    static bool insertAlias(const ConfigKey& alias, const ConfigKey& key);
+
+    /// Releases the entry of the key if the control has expired, e.g. when
+    /// it is destroyed.
+    static void removeExpired(const ConfigKey& key);
+
+    /// Returns all registered controls, without duplicates for aliases.
+    static QList<QSharedPointer<ControlDoublePrivate>> getAll();
+    /// Unregisters all controls and aliases and returns the controls. The
+    /// ids of the keys are kept.
+    static QList<QSharedPointer<ControlDoublePrivate>> takeAll();
+};
@@ -0,0 +1,103 @@
+#include "control/controlsnapshot.h"
+
+#include <QThread>
+#include <QVector>
+
+#include "control/control.h"
+#include "util/assert.h"
+#include "util/mutex.h"
+
+namespace {
+
+/// Guards s_snapshots and serializes the refreshes, i.e. there is only a
+/// single writer per snapshot at any time.
+MMutex s_snapshotsMutex;
+
+QVector<ControlSnapshot*> s_snapshots GUARDED_BY(s_snapshotsMutex);
+
+/// The number of refreshes by the engine.
+std::atomic<quint64> s_engineRefreshCount = 0;
+
+quint64 s_lastEngineRefreshCount GUARDED_BY(s_snapshotsMutex) = 0;
+
+} // namespace
+
+ControlSnapshot::ControlSnapshot(const QList<ConfigKey>& keys)
+        : m_values(std::make_unique<std::atomic<double>[]>(keys.size())),
+          m_sequence(0) {
+    m_controls.reserve(keys.size());
+    for (const auto& key : keys) {
+        auto pControl = ControlDoublePrivate::getControl(
+                key, ControlFlag::AllowMissingOrInvalid);
+        if (!pControl) {
+            pControl = ControlDoublePrivate::getDefaultControl();
+        }
+        m_controls.push_back(std::move(pControl));
+    }
+
+    const MMutexLocker locker(&s_snapshotsMutex);
+    refresh();
+    s_snapshots.append(this);
+}
+
+ControlSnapshot::~ControlSnapshot() {
+    const MMutexLocker locker(&s_snapshotsMutex);
+    s_snapshots.removeOne(this);
+}
+
+quint64 ControlSnapshot::read(double* pValues) const {
+    const std::size_t count = m_controls.size();
+    while (true) {
+        const quint64 sequence = m_sequence.load(std::memory_order_acquire);
+        if (sequence & 1) {
+            // A refresh is in progress
+            QThread::yieldCurrentThread();
+            continue;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            pValues[i] = m_values[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_sequence.load(std::memory_order_relaxed) == sequence) {
+            return sequence / 2;
+        }
+    }
+}
+
+void ControlSnapshot::refresh() {
+    const quint64 sequence = m_sequence.load(std::memory_order_relaxed);
+    DEBUG_ASSERT(!(sequence & 1));
+    m_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    const std::size_t count = m_controls.size();
+    for (std::size_t i = 0; i < count; ++i) {
+        m_values[i].store(m_controls[i]->get(), std::memory_order_relaxed);
+    }
+    m_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+// static
+void ControlSnapshot::refreshAll() {
+    if (!s_snapshotsMutex.tryLock()) {
+        return;
+    }
+    for (ControlSnapshot* pSnapshot : qAsConst(s_snapshots)) {
+        pSnapshot->refresh();
+    }
+    s_engineRefreshCount.fetch_add(1, std::memory_order_relaxed);
+    s_snapshotsMutex.unlock();
+}
+
+// static
+void ControlSnapshot::refreshAllIfEngineIdle() {
+    const MMutexLocker locker(&s_snapshotsMutex);
+    const quint64 engineRefreshCount =
+            s_engineRefreshCount.load(std::memory_order_relaxed);
+    if (engineRefreshCount != s_lastEngineRefreshCount) {
+        s_lastEngineRefreshCount = engineRefreshCount;
+        return;
+    }
+    for (ControlSnapshot* pSnapshot : qAsConst(s_snapshots)) {
+        pSnapshot->refresh();
+    }
+}
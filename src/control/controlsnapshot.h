@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QList>
+#include <QSharedPointer>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "preferences/configobject.h"
+
+class ControlDoublePrivate;
+
+/// A coherent, versioned copy of the values of a fixed set of controls.
+///
+/// Consumers that read many controls per frame or per message register the
+/// controls once and read all values together instead of reading each
+/// ControlProxy separately. The values of all snapshots are captured after
+/// each engine callback, i.e. a snapshot never mixes values of different
+/// callbacks. A seqlock protects the values, i.e. readers never block the
+/// engine thread and retry if a refresh has happened while reading.
+///
+/// If the engine is not running, the snapshots are refreshed from the main
+/// thread by refreshAllIfEngineIdle().
+class ControlSnapshot final {
+  public:
+    /// Missing controls are replaced by the default control with the value 0.
+    explicit ControlSnapshot(const QList<ConfigKey>& keys);
+    ~ControlSnapshot();
+
+    ControlSnapshot(const ControlSnapshot&) = delete;
+    ControlSnapshot& operator=(const ControlSnapshot&) = delete;
+
+    int size() const {
+        return static_cast<int>(m_controls.size());
+    }
+
+    /// Copies the values in the order of the keys into pValues, which must
+    /// provide room for size() values. Returns the version of the values,
+    /// which is incremented with every refresh.
+    quint64 read(double* pValues) const;
+
+    quint64 version() const {
+        return m_sequence.load(std::memory_order_acquire) / 2;
+    }
+
+    /// Captures the values of all snapshots. Called by the engine after each
+    /// callback and real-time safe, i.e. skips the refresh instead of
+    /// waiting if snapshots are currently added or removed.
+    static void refreshAll();
+
+    /// Captures the values of all snapshots if refreshAll() has not been
+    /// called since the last invocation, e.g. because no sound device is
+    /// open. Called once per frame from the main thread.
+    static void refreshAllIfEngineIdle();
+
+  private:
+    void refresh();
+
+    std::vector<QSharedPointer<ControlDoublePrivate>> m_controls;
+    std::unique_ptr<std::atomic<double>[]> m_values;
+    /// Odd while a refresh is in progress
+    std::atomic<quint64> m_sequence;
+};
@@ -7,6 +7,7 @@
 
 #include "controllers/defs_controllers.h"
 #include "moc_controller.cpp"
+#include "util/inputtimestamp.h"
 #include "util/screensaver.h"
 
 namespace {
@@ -16,6 +17,9 @@ QString loggingCategoryPrefix(const QString& deviceName) {
 }
 } // namespace
 
+// static
+const mixxx::Duration Controller::kDefaultScriptTimeSlice = mixxx::Duration::fromMillis(1000);
+
 Controller::Controller(const QString& deviceName)
         : m_sDeviceName(deviceName),
           m_logBase(loggingCategoryPrefix(deviceName)),
@@ -25,8 +29,19 @@ Controller::Controller(const QString& deviceName)
           m_bIsOutputDevice(false),
           m_bIsInputDevice(false),
           m_bIsOpen(false),
-          m_bLearning(false) {
+          m_bIsPolling(false),
+          m_bLearning(false),
+          m_scriptTimeSlice(kDefaultScriptTimeSlice),
+          m_outputFrameTimer(this),
+          m_outputSentCounter(QStringLiteral("Controller output sent ") + deviceName),
+          m_outputSuppressedCounter(
+                  QStringLiteral("Controller output suppressed ") + deviceName),
+          m_outputSuppressedCountReported(0),
+          m_outputSentUncoalescedCount(0) {
     m_userActivityInhibitTimer.start();
+    m_outputFrameTimer.setSingleShot(true);
+    m_outputFrameTimer.setInterval(0);
+    connect(&m_outputFrameTimer, &QTimer::timeout, this, &Controller::flushOutput);
 }
 
 Controller::~Controller() {
@@ -103,9 +118,64 @@ void Controller::send(const QList<int>& data, unsigned int length) {
     QByteArray msg;
     msg.resize(data.size());
     std::copy(data.cbegin(), data.cend(), msg.begin());
+    // Raw messages are not queued and might change the state of any output
+    flushOutput();
+    forgetSentOutput();
     sendBytes(msg);
 }
 
+void Controller::setOutputFrameInterval(std::chrono::milliseconds interval) {
+    VERIFY_OR_DEBUG_ASSERT(interval.count() >= 0) {
+        interval = std::chrono::milliseconds(0);
+    }
+    if (interval.count() == 0) {
+        flushOutput();
+    }
+    m_outputFrameTimer.setInterval(interval);
+}
+
+void Controller::queueOutput(quint32 address, quint32 value) {
+    if (m_outputFrameTimer.interval() == 0) {
+        // Coalescing is disabled, don't suppress anything
+        const ControllerOutputQueue::Message message{address, value};
+        sendOutputBatch(std::span(&message, 1));
+        // Not counted by m_outputSentCounter, which only tracks
+        // the coalesced messages
+        ++m_outputSentUncoalescedCount;
+        return;
+    }
+    m_outputQueue.enqueue(address, value);
+    if (!m_outputFrameTimer.isActive()) {
+        m_outputFrameTimer.start();
+    }
+}
+
+void Controller::flushOutput() {
+    m_outputFrameTimer.stop();
+    if (m_outputQueue.isEmpty()) {
+        return;
+    }
+    m_outputQueue.takePending(&m_outputBatch);
+    if (!m_outputBatch.empty()) {
+        sendOutputBatch(m_outputBatch);
+        m_outputSentCounter.increment(static_cast<int>(m_outputBatch.size()));
+    }
+    const quint64 suppressedCount = m_outputQueue.suppressedCount();
+    m_outputSuppressedCounter.increment(
+            static_cast<int>(suppressedCount - m_outputSuppressedCountReported));
+    m_outputSuppressedCountReported = suppressedCount;
+}
+
+void Controller::forgetSentOutput() {
+    m_outputQueue.forgetSentValues();
+}
+
+void Controller::sendOutputBatch(std::span<const ControllerOutputQueue::Message> messages) {
+    Q_UNUSED(messages);
+    // The encoding of the messages depends on the protocol
+    DEBUG_ASSERT(!"Output queued by a sub-class that does not send it");
+}
+
 void Controller::triggerActivity()
 {
      // Inhibit Updates for 1000 milliseconds
@@ -147,5 +217,6 @@ void Controller::receive(const QByteArray& data, mixxx::Duration timestamp) {
         qCDebug(m_logInput).noquote() << message;
     }
 
+    const mixxx::InputTimestamp::Scope timestampScope(timestamp);
     m_pScriptEngineLegacy->handleIncomingData(data);
 }
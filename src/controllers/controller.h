@@ -2,12 +2,19 @@
 
 #include <QElapsedTimer>
 #include <QLoggingCategory>
+#include <QTimer>
 #include <QTimerEvent>
+#include <atomic>
+#include <chrono>
+#include <span>
+#include <vector>
 
 #include "controllers/controllermappinginfo.h"
+#include "controllers/controlleroutputqueue.h"
 #include "controllers/legacycontrollermapping.h"
 #include "controllers/legacycontrollermappingfilehandler.h"
 #include "controllers/scripting/legacy/controllerscriptenginelegacy.h"
+#include "util/counter.h"
 #include "util/duration.h"
 #include "util/runtimeloggingcategory.h"
 
@@ -37,8 +44,10 @@ class Controller : public QObject {
     /// Clone the mapping before passing to setMapping for use in the controller polling thread.
     virtual void setMapping(std::shared_ptr<LegacyControllerMapping> pMapping) = 0;
 
+    /// Thread-safe, the ControllerManager checks it while the controller
+    /// is opened or closed on its own thread.
     inline bool isOpen() const {
-        return m_bIsOpen;
+        return m_bIsOpen.load(std::memory_order_acquire);
     }
     inline bool isOutputDevice() const {
         return m_bIsOutputDevice;
@@ -59,6 +68,34 @@ class Controller : public QObject {
 
     virtual bool matchMapping(const MappingInfo& mapping) = 0;
 
+    /// The default time after which script callbacks are interrupted
+    static const mixxx::Duration kDefaultScriptTimeSlice;
+
+    /// Sets the time after which a callback of the script engine is
+    /// interrupted, see ControllerScriptWatchdog. Applies to engines that
+    /// are started afterwards.
+    void setScriptTimeSlice(mixxx::Duration timeSlice) {
+        m_scriptTimeSlice = timeSlice;
+    }
+    mixxx::Duration getScriptTimeSlice() const {
+        return m_scriptTimeSlice;
+    }
+
+    /// Sets the interval of the frames in which queued output messages are
+    /// coalesced and sent as a batch. With an interval of 0, the default,
+    /// queued output messages are sent immediately without deduplication.
+    void setOutputFrameInterval(std::chrono::milliseconds interval);
+
+    /// The number of queued output messages that have been sent
+    quint64 outputSentCount() const {
+        return m_outputQueue.sentCount() + m_outputSentUncoalescedCount;
+    }
+    /// The number of queued output messages that have been suppressed
+    /// because they have been superseded or have not changed the output
+    quint64 outputSuppressedCount() const {
+        return m_outputQueue.suppressedCount();
+    }
+
   signals:
     /// Emitted when the controller is opened or closed.
     void openChanged(bool bOpen);
@@ -106,6 +143,25 @@ class Controller : public QObject {
     // controller.
     virtual void sendBytes(const QByteArray& data) = 0;
 
+    /// Queues an output message for the address, see ControllerOutputQueue.
+    /// The queued messages are passed to sendOutputBatch() at the end of the
+    /// current output frame.
+    void queueOutput(quint32 address, quint32 value);
+
+    /// Sends the queued output messages now, e.g. to preserve the order with
+    /// messages that are not queued.
+    void flushOutput();
+
+    /// Forgets the last sent value of all addresses, e.g. after sending a
+    /// message that might have changed the state of the device.
+    void forgetSentOutput();
+
+    /// Sub-classes that queue output messages must reimplement this to write
+    /// the messages to the device, at once if possible. Only the sub-class
+    /// knows how the queued values are encoded, so nothing is sent by
+    /// default.
+    virtual void sendOutputBatch(std::span<const ControllerOutputQueue::Message> messages);
+
     // To be called in sub-class' open() functions after opening the device but
     // before starting any input polling/processing.
     virtual void startEngine();
@@ -130,8 +186,11 @@ class Controller : public QObject {
         m_bIsInputDevice = inputDevice;
     }
     inline void setOpen(bool open) {
-        m_bIsOpen = open;
-        emit openChanged(m_bIsOpen);
+        m_bIsOpen.store(open, std::memory_order_release);
+        emit openChanged(open);
+    }
+    inline void setPolling(bool polling) {
+        m_bIsPolling.store(polling, std::memory_order_release);
     }
 
     const QString m_sDeviceName;
@@ -148,9 +207,9 @@ class Controller : public QObject {
     virtual bool poll() { return false; }
 
     // Returns true if this device should receive polling signals via calls to
-    // its poll() method.
-    virtual bool isPolling() const {
-        return false;
+    // its poll() method. Thread-safe like isOpen().
+    bool isPolling() const {
+        return m_bIsPolling.load(std::memory_order_acquire);
     }
 
   private:
@@ -164,13 +223,27 @@ class Controller : public QObject {
     // Flag indicating if this device supports input (sending data to Mixxx)
     bool m_bIsInputDevice;
     // Indicates whether or not the device has been opened for input/output.
-    bool m_bIsOpen;
+    std::atomic<bool> m_bIsOpen;
+    // Indicates whether or not the device needs to be polled, see isPolling().
+    std::atomic<bool> m_bIsPolling;
     bool m_bLearning;
     QElapsedTimer m_userActivityInhibitTimer;
+    mixxx::Duration m_scriptTimeSlice;
+
+    ControllerOutputQueue m_outputQueue;
+    std::vector<ControllerOutputQueue::Message> m_outputBatch;
+    QTimer m_outputFrameTimer;
+    Counter m_outputSentCounter;
+    Counter m_outputSuppressedCounter;
+    quint64 m_outputSuppressedCountReported;
+    /// Sent while coalescing has been disabled
+    quint64 m_outputSentUncoalescedCount;
 
     friend class ControllerJSProxy;
     // accesses lots of our stuff, but in the same thread
     friend class ControllerManager;
+    // polls in its own thread
+    friend class ControllerThread;
     // For testing
     friend class LegacyControllerMappingValidationTest;
 };
@@ -2,13 +2,16 @@
 
 #include <QSet>
 #include <QThread>
+#include <utility>
 
 #include "controllers/controllerlearningeventfilter.h"
+#include "controllers/controllerthread.h"
 #include "controllers/defs_controllers.h"
 #include "controllers/midi/portmidienumerator.h"
 #include "moc_controllermanager.cpp"
 #include "util/cmdlineargs.h"
 #include "util/compatibility/qmutex.h"
+#include "util/math.h"
 #include "util/time.h"
 #include "util/trace.h"
 #ifdef __HSS1394__
@@ -61,6 +64,37 @@ QFileInfo findMappingFile(const QString& pathOrFilename, const QStringList& path
 // kept for backwards compatibility.
 const QString kSettingsGroup = QLatin1String("[ControllerPreset]");
 
+/// The interval in which the output messages of controllers are coalesced,
+/// 0 disables coalescing
+const ConfigKey kOutputFrameIntervalConfigKey =
+        ConfigKey(QStringLiteral("[Controller]"), QStringLiteral("OutputFrameIntervalMs"));
+
+/// The time after which script callbacks of controllers are interrupted
+const ConfigKey kScriptTimeSliceConfigKey =
+        ConfigKey(QStringLiteral("[Controller]"), QStringLiteral("ScriptTimeSliceMs"));
+
+/// Controllers that are enabled in this group are processed on a thread of
+/// their own, see ControllerThread
+const QString kDedicatedThreadSettingsGroup =
+        QStringLiteral("[ControllerDedicatedThread]");
+
+/// The maximum number of poll cycles a controller is skipped after its poll
+/// has exceeded the poll interval
+constexpr int kMaxSkippedPollCycles = 10;
+
+/// Invokes function in the thread of the controller and waits until it
+/// has finished
+template<typename Function>
+void invokeOnControllerThread(Controller* pController, Function&& function) {
+    if (pController->thread() == QThread::currentThread()) {
+        function();
+        return;
+    }
+    QMetaObject::invokeMethod(pController,
+            std::forward<Function>(function),
+            Qt::BlockingQueuedConnection);
+}
+
 } // anonymous namespace
 
 QString firstAvailableFilename(QSet<QString>& filenames,
@@ -87,7 +121,8 @@ ControllerManager::ControllerManager(UserSettingsPointer pConfig)
           // its own event loop.
           m_pControllerLearningEventFilter(new ControllerLearningEventFilter()),
           m_pollTimer(this),
-          m_skipPoll(false) {
+          m_skipPoll(false),
+          m_pollStartIndex(0) {
     qRegisterMetaType<std::shared_ptr<LegacyControllerMapping>>(
             "std::shared_ptr<LegacyControllerMapping>");
 
@@ -160,6 +195,20 @@ void ControllerManager::slotInitialize() {
 
 void ControllerManager::slotShutdown() {
     stopPolling();
+    m_skippedPollCycles.clear();
+
+    // The controllers are deleted with the enumerators in this thread
+    for (ControllerThread* pControllerThread : qAsConst(m_controllerThreads)) {
+        Controller* pController = pControllerThread->controller();
+        invokeOnControllerThread(pController, [pController] {
+            if (pController->isOpen()) {
+                pController->close();
+            }
+        });
+        pControllerThread->stop();
+        delete pControllerThread;
+    }
+    m_controllerThreads.clear();
 
     // Clear m_enumerators before deleting the enumerators to prevent other code
     // paths from accessing them.
@@ -241,9 +290,11 @@ void ControllerManager::slotSetUpDevices() {
     for (Controller* pController : deviceList) {
         QString name = pController->getName();
 
-        if (pController->isOpen()) {
-            pController->close();
-        }
+        invokeOnControllerThread(pController, [pController] {
+            if (pController->isOpen()) {
+                pController->close();
+            }
+        });
 
         // The filename for this device name.
         QString deviceName = sanitizeDeviceName(name);
@@ -275,8 +326,13 @@ void ControllerManager::slotSetUpDevices() {
             continue;
         }
 
+        configureController(pController);
+
         // This runs on the main thread but LegacyControllerMapping is not thread safe, so clone it.
-        pController->setMapping(pMapping->clone());
+        invokeOnControllerThread(pController,
+                [pController, pClonedMapping = pMapping->clone()]() mutable {
+                    pController->setMapping(std::move(pClonedMapping));
+                });
 
         // If we are in safe mode, skip opening controllers.
         if (CmdlineArgs::Instance().getSafeMode()) {
@@ -286,12 +342,14 @@ void ControllerManager::slotSetUpDevices() {
 
         qDebug() << "Opening controller:" << name;
 
-        int value = pController->open();
-        if (value != 0) {
-            qWarning() << "There was a problem opening" << name;
-            continue;
-        }
-        pController->applyMapping();
+        invokeOnControllerThread(pController, [pController, &name] {
+            int value = pController->open();
+            if (value != 0) {
+                qWarning() << "There was a problem opening" << name;
+                return;
+            }
+            pController->applyMapping();
+        });
     }
 
     pollIfAnyControllersOpen();
@@ -304,7 +362,9 @@ void ControllerManager::pollIfAnyControllersOpen() {
 
     bool shouldPoll = false;
     for (Controller* pController : controllers) {
-        if (pController->isOpen() && pController->isPolling()) {
+        // Controllers on their own thread are polled by it
+        if (pController->isOpen() && pController->isPolling() &&
+                pController->thread() == thread()) {
             shouldPoll = true;
         }
     }
@@ -356,12 +416,36 @@ void ControllerManager::pollDevices() {
         return;
     }
 
+    // In addition, each controller has a budget of one poll interval. A
+    // controller that exceeds it is skipped for as many cycles as it has
+    // taken, while the other controllers are polled as usual. The first
+    // controller is rotated, i.e. a slow controller doesn't always delay the
+    // same controllers.
     mixxx::Duration start = mixxx::Time::elapsed();
-    for (Controller* pDevice : qAsConst(m_controllers)) {
-        if (pDevice->isOpen() && pDevice->isPolling()) {
-            pDevice->poll();
+    const int controllerCount = m_controllers.size();
+    for (int i = 0; i < controllerCount; ++i) {
+        Controller* pDevice = m_controllers.at((m_pollStartIndex + i) % controllerCount);
+        if (!pDevice->isOpen() || !pDevice->isPolling() ||
+                pDevice->thread() != thread()) {
+            continue;
+        }
+        int& skippedPollCycles = m_skippedPollCycles[pDevice];
+        if (skippedPollCycles > 0) {
+            --skippedPollCycles;
+            continue;
+        }
+        const mixxx::Duration pollStart = mixxx::Time::elapsed();
+        pDevice->poll();
+        const mixxx::Duration pollDuration = mixxx::Time::elapsed() - pollStart;
+        if (pollDuration > kPollInterval) {
+            skippedPollCycles = static_cast<int>(math_min(
+                    pollDuration.toIntegerNanos() / kPollInterval.toIntegerNanos(),
+                    qint64{kMaxSkippedPollCycles}));
         }
     }
+    if (controllerCount > 0) {
+        m_pollStartIndex = (m_pollStartIndex + 1) % controllerCount;
+    }
 
     mixxx::Duration duration = mixxx::Time::elapsed() - start;
     if (duration > kPollInterval) {
@@ -374,16 +458,26 @@ void ControllerManager::openController(Controller* pController) {
     if (!pController) {
         return;
     }
-    if (pController->isOpen()) {
-        pController->close();
-    }
-    int result = pController->open();
+    invokeOnControllerThread(pController, [pController] {
+        if (pController->isOpen()) {
+            pController->close();
+        }
+    });
+    // Don't skip the reopened controller for an overrun of the last session
+    m_skippedPollCycles.remove(pController);
+    configureController(pController);
+    int result;
+    invokeOnControllerThread(pController, [pController, &result] {
+        result = pController->open();
+    });
     pollIfAnyControllersOpen();
 
     // If successfully opened the device, apply the mapping and save the
     // preference setting.
     if (result == 0) {
-        pController->applyMapping();
+        invokeOnControllerThread(pController, [pController] {
+            pController->applyMapping();
+        });
 
         // Update configuration to reflect controller is enabled.
         m_pConfig->setValue(
@@ -395,7 +489,10 @@ void ControllerManager::closeController(Controller* pController) {
     if (!pController) {
         return;
     }
-    pController->close();
+    invokeOnControllerThread(pController, [pController] {
+        pController->close();
+    });
+    m_skippedPollCycles.remove(pController);
     pollIfAnyControllersOpen();
     // Update configuration to reflect controller is disabled.
     m_pConfig->setValue(
@@ -429,7 +526,10 @@ void ControllerManager::slotApplyMapping(Controller* pController,
     m_pConfig->set(key, pMapping->filePath());
 
     // This runs on the main thread but LegacyControllerMapping is not thread safe, so clone it.
-    pController->setMapping(pMapping->clone());
+    invokeOnControllerThread(pController,
+            [pController, pClonedMapping = pMapping->clone()]() mutable {
+                pController->setMapping(std::move(pClonedMapping));
+            });
 
     if (bEnabled) {
         openController(pController);
@@ -440,6 +540,38 @@ void ControllerManager::slotApplyMapping(Controller* pController,
     }
 }
 
+void ControllerManager::configureController(Controller* pController) {
+    const QString deviceName = sanitizeDeviceName(pController->getName());
+    const bool dedicatedThread = m_pConfig->getValue(
+            ConfigKey(kDedicatedThreadSettingsGroup, deviceName), false);
+    ControllerThread* pControllerThread = m_controllerThreads.value(pController);
+    if (dedicatedThread && !pControllerThread) {
+        qDebug() << "Processing controller" << pController->getName()
+                 << "on a dedicated thread";
+        pControllerThread = new ControllerThread(pController, kPollInterval);
+        m_controllerThreads.insert(pController, pControllerThread);
+        // The heavy controllers that get a thread of their own are the ones
+        // that affect the audio, e.g. when scratching
+        pControllerThread->start(QThread::HighPriority);
+    } else if (!dedicatedThread && pControllerThread) {
+        m_controllerThreads.remove(pController);
+        pControllerThread->stop();
+        delete pControllerThread;
+    }
+
+    const auto outputFrameInterval = std::chrono::milliseconds(
+            m_pConfig->getValue(kOutputFrameIntervalConfigKey, 0));
+    const auto scriptTimeSlice = mixxx::Duration::fromMillis(
+            m_pConfig->getValue(kScriptTimeSliceConfigKey,
+                    static_cast<int>(
+                            Controller::kDefaultScriptTimeSlice.toIntegerMillis())));
+    invokeOnControllerThread(pController,
+            [pController, outputFrameInterval, scriptTimeSlice] {
+                pController->setOutputFrameInterval(outputFrameInterval);
+                pController->setScriptTimeSlice(scriptTimeSlice);
+            });
+}
+
 // static
 QList<QString> ControllerManager::getMappingPaths(UserSettingsPointer pConfig) {
     QList<QString> scriptPaths;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QHash>
 #include <QMutex>
 #include <QSharedPointer>
 #include <QTimer>
@@ -13,6 +14,7 @@
 // Forward declaration(s)
 class Controller;
 class ControllerLearningEventFilter;
+class ControllerThread;
 
 /// Function to sort controllers by name
 bool controllerCompare(Controller *a, Controller *b);
@@ -74,6 +76,10 @@ class ControllerManager : public QObject {
     void pollIfAnyControllersOpen();
 
   private:
+    /// Applies the preferences that must be set while the controller is
+    /// closed, i.e. moves it into or out of a dedicated thread
+    void configureController(Controller* pController);
+
     UserSettingsPointer m_pConfig;
     ControllerLearningEventFilter* m_pControllerLearningEventFilter;
     QTimer m_pollTimer;
@@ -84,4 +90,12 @@ class ControllerManager : public QObject {
     QSharedPointer<MappingInfoEnumerator> m_pMainThreadUserMappingEnumerator;
     QSharedPointer<MappingInfoEnumerator> m_pMainThreadSystemMappingEnumerator;
     bool m_skipPoll;
+    /// The index of the controller that is polled first in the next cycle
+    int m_pollStartIndex;
+    /// The number of cycles each controller is skipped after exceeding its
+    /// poll budget
+    QHash<Controller*, int> m_skippedPollCycles;
+    QHash<Controller*, ControllerThread*> m_controllerThreads;
+
+    friend class ControllerManagerTest;
 };
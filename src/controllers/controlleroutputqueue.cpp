@@ -0,0 +1,48 @@
+#include "controllers/controlleroutputqueue.h"
+
+ControllerOutputQueue::ControllerOutputQueue()
+        : m_sentCount(0),
+          m_suppressedCount(0) {
+}
+
+bool ControllerOutputQueue::enqueue(quint32 address, quint32 value) {
+    const auto pendingIt = m_pendingIndices.constFind(address);
+    if (pendingIt != m_pendingIndices.constEnd()) {
+        // Unchanged values are dropped when taking the pending messages
+        m_pending[pendingIt.value()].value = value;
+        ++m_suppressedCount;
+        return true;
+    }
+    const auto sentIt = m_sentValues.constFind(address);
+    if (sentIt != m_sentValues.constEnd() && sentIt.value() == value) {
+        ++m_suppressedCount;
+        return false;
+    }
+    m_pendingIndices.insert(address, m_pending.size());
+    m_pending.push_back(Message{address, value});
+    return true;
+}
+
+void ControllerOutputQueue::takePending(std::vector<Message>* pMessages) {
+    pMessages->clear();
+    for (const auto& message : m_pending) {
+        auto sentIt = m_sentValues.find(message.address);
+        if (sentIt == m_sentValues.end()) {
+            m_sentValues.insert(message.address, message.value);
+        } else if (sentIt.value() == message.value) {
+            // Changed and changed back within the same frame
+            ++m_suppressedCount;
+            continue;
+        } else {
+            sentIt.value() = message.value;
+        }
+        pMessages->push_back(message);
+    }
+    m_sentCount += pMessages->size();
+    m_pending.clear();
+    m_pendingIndices.clear();
+}
+
+void ControllerOutputQueue::forgetSentValues() {
+    m_sentValues.clear();
+}
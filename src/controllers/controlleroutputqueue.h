@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QHash>
+#include <QtGlobal>
+#include <vector>
+
+/// Coalesces and deduplicates the output messages of a controller.
+///
+/// Output messages are identified by an address, e.g. the status and control
+/// byte of a MIDI message, and carry a value that is the complete message.
+/// Until the pending messages are taken, only the last value of each address
+/// is kept, and values that equal the last sent value of their address are
+/// suppressed. This avoids flooding the device with LED updates of controls
+/// that change with every engine callback, e.g. VU meters and beat indicators.
+class ControllerOutputQueue final {
+  public:
+    struct Message {
+        quint32 address;
+        quint32 value;
+    };
+
+    ControllerOutputQueue();
+
+    /// Returns false if the message has been suppressed because its value
+    /// has already been sent.
+    bool enqueue(quint32 address, quint32 value);
+
+    bool isEmpty() const {
+        return m_pending.empty();
+    }
+
+    /// Replaces the contents of pMessages with the pending messages in the
+    /// order their addresses have been enqueued first and remembers them as
+    /// sent.
+    void takePending(std::vector<Message>* pMessages);
+
+    /// Forgets the last sent values, i.e. the next value of each address is
+    /// sent regardless. Needed if the state of the device might have changed
+    /// otherwise, e.g. by a SysEx message or by reopening the device.
+    void forgetSentValues();
+
+    /// The number of messages taken for sending
+    quint64 sentCount() const {
+        return m_sentCount;
+    }
+    /// The number of messages that have been replaced by a later message
+    /// for the same address or that have been dropped as unchanged
+    quint64 suppressedCount() const {
+        return m_suppressedCount;
+    }
+
+  private:
+    std::vector<Message> m_pending;
+    /// The index of the pending message for each address
+    QHash<quint32, std::size_t> m_pendingIndices;
+    QHash<quint32, quint32> m_sentValues;
+    quint64 m_sentCount;
+    quint64 m_suppressedCount;
+};
@@ -0,0 +1,49 @@
+#include "controllers/controllerthread.h"
+
+#include <QTimer>
+
+#include "controllers/controller.h"
+#include "moc_controllerthread.cpp"
+#include "util/assert.h"
+
+ControllerThread::ControllerThread(Controller* pController, mixxx::Duration pollInterval)
+        : m_pController(pController),
+          m_pollInterval(pollInterval),
+          m_pReturnThread(nullptr) {
+    DEBUG_ASSERT(m_pController->thread() == QThread::currentThread());
+    DEBUG_ASSERT(!m_pController->isOpen());
+    setObjectName(QStringLiteral("Controller ") + m_pController->getName());
+    m_pController->moveToThread(this);
+}
+
+ControllerThread::~ControllerThread() {
+    DEBUG_ASSERT(!isRunning());
+}
+
+void ControllerThread::stop() {
+    DEBUG_ASSERT(!m_pController->isOpen());
+    m_pReturnThread = QThread::currentThread();
+    quit();
+    wait();
+}
+
+void ControllerThread::run() {
+    // Polls only this controller, the ControllerManager skips it
+    QTimer pollTimer;
+    pollTimer.setInterval(m_pollInterval.toIntegerMillis());
+    connect(&pollTimer, &QTimer::timeout, m_pController, [this] {
+        if (m_pController->isOpen() && m_pController->isPolling()) {
+            m_pController->poll();
+        }
+    });
+    pollTimer.start();
+
+    exec();
+
+    pollTimer.stop();
+    // Only possible from the thread the controller lives in
+    VERIFY_OR_DEBUG_ASSERT(m_pReturnThread) {
+        return;
+    }
+    m_pController->moveToThread(m_pReturnThread);
+}
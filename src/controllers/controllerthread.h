@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QThread>
+
+#include "util/duration.h"
+
+class Controller;
+
+/// Processes a single controller on a thread of its own, i.e. a controller
+/// with a heavy mapping or a busy device doesn't delay the other controllers
+/// that share the thread of the ControllerManager. The script engine of the
+/// controller is created in this thread when the controller is opened.
+///
+/// The controller must be closed while it is moved between threads.
+class ControllerThread : public QThread {
+    Q_OBJECT
+  public:
+    /// Moves pController to the new thread, must be invoked from the
+    /// thread of pController
+    ControllerThread(Controller* pController, mixxx::Duration pollInterval);
+    ~ControllerThread() override;
+
+    Controller* controller() const {
+        return m_pController;
+    }
+
+    /// Stops the thread and moves the controller back to the calling thread
+    void stop();
+
+  protected:
+    void run() override;
+
+  private:
+    Controller* const m_pController;
+    const mixxx::Duration m_pollInterval;
+    QThread* m_pReturnThread;
+};
@@ -5,6 +5,8 @@
 #include "controllers/defs_controllers.h"
 #include "controllers/hid/legacyhidcontrollermappingfilehandler.h"
 #include "moc_hidcontroller.cpp"
+#include "util/math.h"
+#include "util/stat.h"
 #include "util/string.h"
 #include "util/time.h"
 #include "util/trace.h"
@@ -12,7 +14,11 @@
 HidController::HidController(
         mixxx::hid::DeviceInfo&& deviceInfo)
         : Controller(deviceInfo.formatName()),
-          m_deviceInfo(std::move(deviceInfo)) {
+          m_deviceInfo(std::move(deviceInfo)),
+          m_inputLatencyStatTag(QStringLiteral("HID input latency ") +
+                  m_deviceInfo.formatName()),
+          m_inputLatencyHistogramStatTag(
+                  m_inputLatencyStatTag + QStringLiteral(" histogram")) {
     setDeviceCategory(mixxx::hid::DeviceCategory::guessFromDeviceInfo(m_deviceInfo));
 
     // All HID devices are full-duplex
@@ -206,6 +212,24 @@ void HidController::sendBytes(const QByteArray& data) {
     m_pHidIoThread->updateCachedOutputReportData(0, data, false);
 }
 
+void HidController::receive(const QByteArray& data, mixxx::Duration timestamp) {
+    const mixxx::Duration latency = mixxx::Time::elapsed() - timestamp;
+    Stat::track(m_inputLatencyStatTag,
+            Stat::DURATION_NANOSEC,
+            Stat::COUNT | Stat::AVERAGE | Stat::MIN | Stat::MAX,
+            static_cast<double>(latency.toIntegerNanos()));
+    // The histogram tracks each distinct value, i.e. the latency is rounded
+    // up to powers of two microseconds.
+    const qint64 latencyMicros = math_clamp(latency.toIntegerMicros(), qint64{0}, qint64{1} << 30);
+    const double bucketNanos =
+            roundUpToPowerOf2(static_cast<unsigned int>(latencyMicros)) * 1000.0;
+    Stat::track(m_inputLatencyHistogramStatTag,
+            Stat::DURATION_NANOSEC,
+            Stat::HISTOGRAM,
+            bucketNanos);
+    Controller::receive(data, timestamp);
+}
+
 ControllerJSProxy* HidController::jsProxy() {
     return new HidControllerJSProxy(this);
 }
@@ -32,6 +32,11 @@ class HidController final : public Controller {
 
     bool matchMapping(const MappingInfo& mapping) override;
 
+  protected slots:
+    /// Tracks the input latency, i.e. the time between reading an
+    /// InputReport in the HidIoThread and processing it in the mapping.
+    void receive(const QByteArray& data, mixxx::Duration timestamp) override;
+
   private slots:
     int open() override;
     int close() override;
@@ -42,6 +47,10 @@ class HidController final : public Controller {
     void sendBytes(const QByteArray& data) override;
 
     const mixxx::hid::DeviceInfo m_deviceInfo;
+    const QString m_inputLatencyStatTag;
+    /// Stats are keyed by their tag, so the histogram of the rounded
+    /// latencies needs its own
+    const QString m_inputLatencyHistogramStatTag;
 
     std::unique_ptr<HidIoThread> m_pHidIoThread;
     std::shared_ptr<LegacyHidControllerMapping> m_pMapping;
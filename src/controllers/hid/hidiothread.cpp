@@ -4,6 +4,16 @@
 
 #include <QTimer>
 
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
 #include "controllers/defs_controllers.h"
 #include "controllers/hid/legacyhidcontrollermappingfilehandler.h"
 #include "moc_hidiothread.cpp"
@@ -24,6 +34,16 @@ constexpr size_t kMaxHidErrorMessageSize = 512;
 // the fastest possible rate of HID devices with USB HighSpeed or USB SuperSpeed interface is 8kHz
 constexpr int kSleepTimeWhenIdleMicros = 250;
 
+#ifdef Q_OS_LINUX
+// Upper limit for waiting in the event driven run loop. All state changes
+// wake up the run loop immediately, this is only a safety net.
+constexpr int kMaxWaitTimeMillis = 100;
+
+// Path prefix of the devices of the hidapi hidraw backend. Other backends,
+// e.g. libusb, use paths that can't be opened as a file.
+constexpr char kHidrawPathPrefix[] = "/dev/hidraw";
+#endif
+
 QString loggingCategoryPrefix(const QString& deviceName) {
     return QStringLiteral("controller.") +
             RuntimeLoggingCategory::removeInvalidCharsFromCategory(deviceName.toLower());
@@ -44,22 +64,41 @@ HidIoThread::HidIoThread(
           m_lastPollSize(0),
           m_pollingBufferIndex(0),
           m_globalOutputReportFifo(),
-          m_runLoopSemaphore(1) {
+          m_runLoopSemaphore(1),
+          m_inputFd(-1),
+          m_epollFd(-1),
+          m_wakeUpFd(-1) {
     // Initializing isn't strictly necessary but is good practice.
     for (int i = 0; i < kNumBuffers; i++) {
         memset(m_pPollData[i], 0, kBufferSize);
     }
     m_outputReportIterator = m_outputReports.begin();
     m_state.storeRelease(static_cast<int>(HidIoThreadState::Initialized));
+    if (openEventDrivenInput()) {
+        qCInfo(m_logBase) << "Waiting for HID InputReports of"
+                          << m_deviceInfo.formatName() << "with epoll";
+    } else {
+        qCInfo(m_logBase) << "Polling HID InputReports of"
+                          << m_deviceInfo.formatName();
+    }
 }
 
 HidIoThread::~HidIoThread() {
+    closeEventDrivenInput();
     hid_close(m_pHidDevice);
 }
 
 void HidIoThread::run() {
     const QSemaphoreReleaser releaser(m_runLoopSemaphore);
     m_runLoopSemaphore.acquire();
+    if (isEventDriven()) {
+        runEventLoop();
+    } else {
+        runPollingLoop();
+    }
+}
+
+void HidIoThread::runPollingLoop() {
     while (!testAndSetThreadState(HidIoThreadState::StopRequested, HidIoThreadState::Stopped)) {
         // Ensure that all InputReports are read from the ring buffer, before the next OutputReport blocks the IO again
         // Polling available Input-Reports is a cheap software only operation, which takes insignificiant time
@@ -83,6 +122,129 @@ void HidIoThread::run() {
     }
 }
 
+bool HidIoThread::openEventDrivenInput() {
+#ifdef Q_OS_LINUX
+    if (std::strncmp(m_deviceInfo.pathRaw(),
+                kHidrawPathPrefix,
+                sizeof(kHidrawPathPrefix) - 1) != 0) {
+        return false;
+    }
+    // The kernel passes each InputReport to all open file descriptors of a
+    // hidraw device, i.e. the reports can be read here while hidapi keeps
+    // using its own file descriptor for all other operations.
+    m_inputFd = ::open(m_deviceInfo.pathRaw(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    m_wakeUpFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_inputFd >= 0 && m_epollFd >= 0 && m_wakeUpFd >= 0) {
+        epoll_event inputEvent = {};
+        inputEvent.events = EPOLLIN;
+        inputEvent.data.fd = m_inputFd;
+        epoll_event wakeUpEvent = {};
+        wakeUpEvent.events = EPOLLIN;
+        wakeUpEvent.data.fd = m_wakeUpFd;
+        if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_inputFd, &inputEvent) == 0 &&
+                epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeUpFd, &wakeUpEvent) == 0) {
+            return true;
+        }
+    }
+    qCWarning(m_logBase) << "Unable to wait for HID InputReports of"
+                         << m_deviceInfo.formatName() << ":" << std::strerror(errno);
+    closeEventDrivenInput();
+#endif
+    return false;
+}
+
+void HidIoThread::closeEventDrivenInput() {
+#ifdef Q_OS_LINUX
+    for (int* pFd : {&m_inputFd, &m_epollFd, &m_wakeUpFd}) {
+        if (*pFd >= 0) {
+            ::close(*pFd);
+            *pFd = -1;
+        }
+    }
+#endif
+}
+
+void HidIoThread::runEventLoop() {
+    while (!testAndSetThreadState(HidIoThreadState::StopRequested, HidIoThreadState::Stopped)) {
+        readAvailableInputReports();
+
+        // Send all cached OutputReports as a batch before waiting again, but
+        // read the InputReports, that were received in the meantime, between
+        // the time consuming sends
+        if (sendNextCachedOutputReport()) {
+            continue;
+        }
+        if (testAndSetThreadState(HidIoThreadState::StopWhenAllReportsSent,
+                    HidIoThreadState::Stopped)) {
+            break;
+        }
+        waitForEvents();
+    }
+}
+
+void HidIoThread::readAvailableInputReports() {
+#ifdef Q_OS_LINUX
+    Trace hidRead("HidIoThread readAvailableInputReports");
+    auto hidDeviceLock = lockMutex(&m_hidDeviceAndPollMutex);
+    if (m_inputFd < 0) {
+        return;
+    }
+    while (true) {
+        // Like hid_read of the hidraw backend, each read returns a single
+        // InputReport, prefixed by the report ID for numbered reports.
+        const ssize_t bytesRead = ::read(m_inputFd, m_pPollData[m_pollingBufferIndex], kBufferSize);
+        if (bytesRead < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                // E.g. the device has been unplugged. Stop waiting for input,
+                // which would otherwise wake up the run loop continuously.
+                qCWarning(m_logInput) << "Unable to read HID InputReports from"
+                                      << m_deviceInfo.formatName() << ":"
+                                      << std::strerror(errno);
+                epoll_ctl(m_epollFd, EPOLL_CTL_DEL, m_inputFd, nullptr);
+                ::close(m_inputFd);
+                m_inputFd = -1;
+            }
+            break;
+        }
+        if (bytesRead == 0) {
+            break;
+        }
+        if (m_state.loadAcquire() != static_cast<int>(HidIoThreadState::InputOutputActive)) {
+            // Discard InputReports, that are received before the mapping has
+            // been initialized or after it has been shut down
+            continue;
+        }
+        processInputReport(static_cast<int>(bytesRead));
+    }
+#endif
+}
+
+void HidIoThread::waitForEvents() {
+#ifdef Q_OS_LINUX
+    epoll_event events[2];
+    const int eventCount = epoll_wait(m_epollFd, events, 2, kMaxWaitTimeMillis);
+    for (int i = 0; i < eventCount; ++i) {
+        if (events[i].data.fd == m_wakeUpFd) {
+            // Reset the counter of the eventfd
+            eventfd_t value;
+            eventfd_read(m_wakeUpFd, &value);
+        }
+    }
+#endif
+}
+
+void HidIoThread::wakeUp() {
+#ifdef Q_OS_LINUX
+    if (m_wakeUpFd >= 0) {
+        eventfd_write(m_wakeUpFd, 1);
+    }
+#endif
+}
+
 void HidIoThread::pollBufferedInputReports() {
     Trace hidRead("HidIoThread pollBufferedInputReports");
     auto hidDeviceLock = lockMutex(&m_hidDeviceAndPollMutex);
@@ -214,6 +376,8 @@ void HidIoThread::updateCachedOutputReportData(quint8 reportID,
     if (useNonSkippingFIFO) {
         m_globalOutputReportFifo.addReportDatasetToFifo(reportID, data, m_deviceInfo, m_logOutput);
     }
+
+    wakeUp();
 }
 
 bool HidIoThread::sendNextCachedOutputReport() {
@@ -345,6 +509,7 @@ bool HidIoThread::testAndSetThreadState(HidIoThreadState expectedState,
         return false;
     }
 
+    wakeUp();
     return true;
 }
 
@@ -356,4 +521,5 @@ bool HidIoThread::waitUntilRunLoopIsStopped(unsigned int timeoutMillis) {
 
 void HidIoThread::setThreadState(HidIoThreadState expectedState) {
     m_state.storeRelease(static_cast<int>(expectedState));
+    wakeUp();
 }
@@ -50,6 +50,12 @@ class HidIoThread : public QThread {
     void sendFeatureReport(quint8 reportID, const QByteArray& reportData);
     QByteArray getFeatureReport(quint8 reportID);
 
+    /// Returns true if the run loop waits for InputReports and OutputReports
+    /// instead of polling. Only available for hidraw devices on Linux.
+    bool isEventDriven() const {
+        return m_epollFd >= 0;
+    }
+
   signals:
     /// Signals that a HID InputReport received by Interrupt triggered from HID device
     void receive(const QByteArray& data, mixxx::Duration timestamp);
@@ -57,9 +63,22 @@ class HidIoThread : public QThread {
   private:
     bool sendNextCachedOutputReport();
 
+    /// Polls the InputReports and sleeps between the polls if idle
+    void runPollingLoop();
+
     void pollBufferedInputReports();
     void processInputReport(int bytesRead);
 
+    /// Waits with epoll until InputReports are available or the run loop
+    /// is woken up, i.e. the thread doesn't consume any CPU while idle.
+    void runEventLoop();
+    bool openEventDrivenInput();
+    void closeEventDrivenInput();
+    void readAvailableInputReports();
+    void waitForEvents();
+    /// Wakes up the run loop, e.g. if an OutputReport needs to be sent
+    void wakeUp();
+
     const mixxx::hid::DeviceInfo m_deviceInfo;
     const RuntimeLoggingCategory m_logBase;
     const RuntimeLoggingCategory m_logInput;
@@ -100,4 +119,12 @@ class HidIoThread : public QThread {
 
     /// Semaphore with capacity 1, which is left acquired, as long as the run loop of the thread runs
     QSemaphore m_runLoopSemaphore;
+
+    /// A separate file descriptor of the hidraw device for reading the
+    /// InputReports, because hidapi doesn't expose its own one.
+    int m_inputFd;
+    /// Set to -1 if the InputReports are polled
+    int m_epollFd;
+    /// An eventfd, that wakes up the run loop
+    int m_wakeUpFd;
 };
@@ -7,9 +7,17 @@
 #include "errordialoghandler.h"
 #include "mixer/playermanager.h"
 #include "moc_midicontroller.cpp"
+#include "util/inputtimestamp.h"
 #include "util/math.h"
 #include "util/screensaver.h"
 
+namespace {
+
+/// Controllers 120-127 are reserved for channel mode messages
+constexpr unsigned char kFirstChannelModeController = 120;
+
+} // namespace
+
 MidiController::MidiController(const QString& deviceName)
         : Controller(deviceName) {
     setDeviceCategory(tr("MIDI Controller"));
@@ -31,6 +39,7 @@ QString MidiController::mappingExtension() {
 
 void MidiController::setMapping(std::shared_ptr<LegacyControllerMapping> pMapping) {
     m_pMapping = downcastAndTakeOwnership<LegacyMidiControllerMapping>(std::move(pMapping));
+    compileInputMappings();
 }
 
 std::shared_ptr<LegacyControllerMapping> MidiController::cloneMapping() {
@@ -42,9 +51,68 @@ std::shared_ptr<LegacyControllerMapping> MidiController::cloneMapping() {
 
 int MidiController::close() {
     destroyOutputHandlers();
+    // Sub-classes close the device afterwards
+    flushOutput();
+    forgetSentOutput();
+    if (outputSuppressedCount() > 0) {
+        qCInfo(m_logOutput) << "Sent" << outputSentCount()
+                            << "queued output messages, suppressed"
+                            << outputSuppressedCount();
+    }
     return 0;
 }
 
+void MidiController::queueShortMsg(unsigned char status,
+        unsigned char byte1,
+        unsigned char byte2) {
+    const quint32 message = (static_cast<quint32>(byte2) << 16) |
+            (static_cast<quint32>(byte1) << 8) | status;
+    quint32 address;
+    switch (MidiUtils::opCodeFromStatus(status)) {
+    case MidiOpCode::NoteOff:
+        // Note off and note on messages address the same note
+        address = MidiUtils::statusFromOpCodeAndChannel(MidiOpCode::NoteOn,
+                          MidiUtils::channelFromStatus(status)) |
+                (static_cast<quint32>(byte1) << 8);
+        break;
+    case MidiOpCode::ControlChange:
+        if (byte1 >= kFirstChannelModeController) {
+            // Channel mode messages like "All Notes Off" affect other
+            // addresses
+            flushOutput();
+            forgetSentOutput();
+            sendShortMsg(status, byte1, byte2);
+            return;
+        }
+        address = status | (static_cast<quint32>(byte1) << 8);
+        break;
+    case MidiOpCode::NoteOn:
+    case MidiOpCode::PolyphonicKeyPressure:
+        address = status | (static_cast<quint32>(byte1) << 8);
+        break;
+    case MidiOpCode::ProgramChange:
+    case MidiOpCode::ChannelPressure:
+    case MidiOpCode::PitchBendChange:
+        address = status;
+        break;
+    default:
+        // System messages like the MIDI clock must not be coalesced
+        flushOutput();
+        sendShortMsg(status, byte1, byte2);
+        return;
+    }
+    queueOutput(address, message);
+}
+
+void MidiController::sendOutputBatch(
+        std::span<const ControllerOutputQueue::Message> messages) {
+    for (const auto& message : messages) {
+        sendShortMsg(static_cast<unsigned char>(message.value),
+                static_cast<unsigned char>(message.value >> 8),
+                static_cast<unsigned char>(message.value >> 16));
+    }
+}
+
 bool MidiController::matchMapping(const MappingInfo& mapping) {
     // Product info mapping not implemented for MIDI devices yet
     Q_UNUSED(mapping);
@@ -55,6 +123,13 @@ bool MidiController::applyMapping() {
     // Handles the engine
     bool result = Controller::applyMapping();
 
+    // The device might have been reset since the output has been sent
+    forgetSentOutput();
+
+    // The engine might have been replaced by a new one at the same address
+    m_inputDispatchTable.bindScriptFunctions(getScriptEngine());
+    m_temporaryInputDispatchTable.bindScriptFunctions(getScriptEngine());
+
     // Only execute this code if this is an output device
     if (isOutputDevice()) {
         if (m_outputs.count() > 0) {
@@ -165,6 +240,14 @@ void MidiController::destroyOutputHandlers() {
     }
 }
 
+void MidiController::compileInputMappings() {
+    if (!m_pMapping) {
+        m_inputDispatchTable.clear();
+        return;
+    }
+    m_inputDispatchTable.compile(m_pMapping->getInputMappings().values());
+}
+
 void MidiController::learnTemporaryInputMappings(const MidiInputMappings& mappings) {
     foreach (const MidiInputMapping& mapping, mappings) {
         m_temporaryInputMappings.insert(mapping.key.key, mapping);
@@ -180,10 +263,12 @@ void MidiController::learnTemporaryInputMappings(const MidiInputMappings& mappin
         qDebug() << "Set mapping for" << message << "to"
                  << mapping.control.group << mapping.control.item;
     }
+    m_temporaryInputDispatchTable.compile(m_temporaryInputMappings.values());
 }
 
 void MidiController::clearTemporaryInputMappings() {
     m_temporaryInputMappings.clear();
+    m_temporaryInputDispatchTable.clear();
 }
 
 void MidiController::commitTemporaryInputMappings() {
@@ -207,6 +292,8 @@ void MidiController::commitTemporaryInputMappings() {
         m_pMapping->addInputMapping(it.key(), it.value());
     }
     m_temporaryInputMappings.clear();
+    m_temporaryInputDispatchTable.clear();
+    compileInputMappings();
 }
 
 void MidiController::receivedShortMessage(unsigned char status,
@@ -238,40 +325,50 @@ void MidiController::receivedShortMessage(unsigned char status,
 
     MidiKey mappingKey(status, control);
     triggerActivity();
+    const mixxx::InputTimestamp::Scope timestampScope(timestamp);
     if (isLearning()) {
         emit messageReceived(status, control, value);
 
-        auto it = m_temporaryInputMappings.constFind(mappingKey.key);
-        if (it != m_temporaryInputMappings.constEnd()) {
-            for (; it != m_temporaryInputMappings.constEnd() && it.key() == mappingKey.key; ++it) {
-                processInputMapping(it.value(), status, control, value, timestamp);
+        const auto entries = dispatchTableEntries(&m_temporaryInputDispatchTable, mappingKey);
+        if (!entries.empty()) {
+            for (auto& entry : entries) {
+                processInputMapping(&entry, status, control, value, timestamp);
             }
             return;
         }
     }
 
-    auto it = m_pMapping->getInputMappings().constFind(mappingKey.key);
-    for (; it != m_pMapping->getInputMappings().constEnd() && it.key() == mappingKey.key; ++it) {
-        processInputMapping(it.value(), status, control, value, timestamp);
+    for (auto& entry : dispatchTableEntries(&m_inputDispatchTable, mappingKey)) {
+        processInputMapping(&entry, status, control, value, timestamp);
     }
 }
 
-void MidiController::processInputMapping(const MidiInputMapping& mapping,
-                                         unsigned char status,
-                                         unsigned char control,
-                                         unsigned char value,
-                                         mixxx::Duration timestamp) {
+std::span<MidiInputDispatchTable::Entry> MidiController::dispatchTableEntries(
+        MidiInputDispatchTable* pTable, MidiKey key) {
+    ControllerScriptEngineLegacy* pEngine = getScriptEngine();
+    if (pTable->scriptEngine() != pEngine) {
+        // The engine has been (re)started since compiling
+        pTable->bindScriptFunctions(pEngine);
+    }
+    return pTable->entries(key);
+}
+
+void MidiController::processInputMapping(MidiInputDispatchTable::Entry* pEntry,
+        unsigned char status,
+        unsigned char control,
+        unsigned char value,
+        mixxx::Duration timestamp) {
     Q_UNUSED(timestamp);
-    unsigned char channel = MidiUtils::channelFromStatus(status);
+    const MidiInputMapping& mapping = pEntry->mapping;
     MidiOpCode opCode = MidiUtils::opCodeFromStatus(status);
 
-    if (mapping.options.testFlag(MidiOption::Script)) {
+    if (pEntry->action == MidiInputDispatchTable::Action::Script) {
         ControllerScriptEngineLegacy* pEngine = getScriptEngine();
         if (pEngine == nullptr) {
             return;
         }
 
-        QJSValue function = pEngine->wrapFunctionCode(mapping.control.item, 5);
+        unsigned char channel = MidiUtils::channelFromStatus(status);
         const auto args = QJSValueList{
                 channel,
                 control,
@@ -279,7 +376,7 @@ void MidiController::processInputMapping(const MidiInputMapping& mapping,
                 status,
                 mapping.control.group,
         };
-        if (!pEngine->executeFunction(function, args)) {
+        if (!pEngine->executeBoundFunction(pEntry->functionHandle, args)) {
             qCWarning(m_logBase) << "MidiController: Invalid script function"
                                  << mapping.control.item;
         }
@@ -287,15 +384,15 @@ void MidiController::processInputMapping(const MidiInputMapping& mapping,
     }
 
     // Only pass values on to valid ControlObjects.
-    ControlObject* pCO = ControlObject::getControl(mapping.control);
+    ControlObject* pCO = MidiInputDispatchTable::control(pEntry);
     if (pCO == nullptr) {
         return;
     }
 
     double newValue = value;
 
-    const bool mapping_is_14bit = mapping.options &
-            (MidiOption::FourteenBitMSB | MidiOption::FourteenBitLSB);
+    const bool mapping_is_14bit =
+            pEntry->action == MidiInputDispatchTable::Action::FourteenBit;
     if (!mapping_is_14bit && !m_fourteen_bit_queued_mappings.isEmpty()) {
         qCWarning(m_logBase) << "MidiController was waiting for the MSB/LSB of a 14-bit"
                              << "message but the next message received was not mapped as 14-bit."
@@ -355,7 +452,7 @@ void MidiController::processInputMapping(const MidiInputMapping& mapping,
             m_fourteen_bit_queued_mappings.append(qMakePair(mapping, value));
             return;
         }
-    } else if (opCode == MidiOpCode::PitchBendChange) {
+    } else if (pEntry->action == MidiInputDispatchTable::Action::PitchBend) {
         // compute 14-bit value for pitch bend messages
         int iValue;
         iValue = (value << 7) | control;
@@ -375,7 +472,7 @@ void MidiController::processInputMapping(const MidiInputMapping& mapping,
 
     // ControlPushButton ControlObjects only accept NOTE_ON, so if the midi
     // mapping is <button> we override the Midi 'status' appropriately.
-    if (mapping.options & (MidiOption::Button | MidiOption::Switch)) {
+    if (pEntry->setAsNoteOn) {
         opCode = MidiOpCode::NoteOn;
     }
 
@@ -498,6 +595,7 @@ void MidiController::receive(const QByteArray& data, mixxx::Duration timestamp)
     MidiKey mappingKey(data.at(0), 0xFF);
 
     triggerActivity();
+    const mixxx::InputTimestamp::Scope timestampScope(timestamp);
     // TODO(rryan): Need to review how MIDI learn works with sysex messages. I
     // don't think this actually does anything useful.
     if (isLearning()) {
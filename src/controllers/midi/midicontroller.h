@@ -3,6 +3,7 @@
 #include "controllers/controller.h"
 #include "controllers/midi/legacymidicontrollermapping.h"
 #include "controllers/midi/legacymidicontrollermappingfilehandler.h"
+#include "controllers/midi/midiinputdispatchtable.h"
 #include "controllers/midi/midimessage.h"
 #include "controllers/midi/midioutputhandler.h"
 #include "controllers/softtakeover.h"
@@ -45,6 +46,17 @@ class MidiController : public Controller {
             unsigned char byte1,
             unsigned char byte2) = 0;
 
+    /// Queues a short message for the next output frame. Messages for the
+    /// same note, controller or channel supersede each other, see
+    /// Controller::queueOutput().
+    void queueShortMsg(unsigned char status,
+            unsigned char byte1,
+            unsigned char byte2);
+
+    /// Sends each message with sendShortMsg(). Sub-classes should reimplement
+    /// this if the API allows to write multiple messages at once.
+    void sendOutputBatch(std::span<const ControllerOutputQueue::Message> messages) override;
+
     /// Alias for send()
     /// The length parameter is here for backwards compatibility for when scripts
     /// were required to specify it.
@@ -72,7 +84,7 @@ class MidiController : public Controller {
 
   private:
     void processInputMapping(
-            const MidiInputMapping& mapping,
+            MidiInputDispatchTable::Entry* pEntry,
             unsigned char status,
             unsigned char control,
             unsigned char value,
@@ -82,12 +94,21 @@ class MidiController : public Controller {
             const QByteArray& data,
             mixxx::Duration timestamp);
 
+    /// Binds the script functions of the table if the engine has changed
+    /// since compiling and returns the entries for the key.
+    std::span<MidiInputDispatchTable::Entry> dispatchTableEntries(
+            MidiInputDispatchTable* pTable, MidiKey key);
+    void compileInputMappings();
+
     double computeValue(MidiOptions options, double _prevmidivalue, double _newmidivalue);
     void createOutputHandlers();
     void updateAllOutputs();
     void destroyOutputHandlers();
 
     QHash<uint16_t, MidiInputMapping> m_temporaryInputMappings;
+    /// Compiled from m_pMapping and m_temporaryInputMappings respectively
+    MidiInputDispatchTable m_inputDispatchTable;
+    MidiInputDispatchTable m_temporaryInputDispatchTable;
     QList<MidiOutputHandler*> m_outputs;
     std::shared_ptr<LegacyMidiControllerMapping> m_pMapping;
     SoftTakeoverCtrl m_st;
@@ -113,7 +134,7 @@ class MidiControllerJSProxy : public ControllerJSProxy {
     Q_INVOKABLE void sendShortMsg(unsigned char status,
             unsigned char byte1,
             unsigned char byte2) {
-        m_pMidiController->sendShortMsg(status, byte1, byte2);
+        m_pMidiController->queueShortMsg(status, byte1, byte2);
     }
 
     Q_INVOKABLE void sendSysexMsg(const QList<int>& data, unsigned int length = 0) {
@@ -0,0 +1,114 @@
+#include "controllers/midi/midiinputdispatchtable.h"
+
+#include <algorithm>
+
+#include "control/control.h"
+#include "control/controlregistry.h"
+#include "controllers/midi/midiutils.h"
+#include "controllers/scripting/legacy/controllerscriptenginelegacy.h"
+
+namespace {
+
+// The same number of arguments as passed by
+// MidiController::processInputMapping()
+constexpr int kScriptFunctionArgumentCount = 5;
+
+MidiInputDispatchTable::Action actionOf(const MidiInputMapping& mapping) {
+    if (mapping.options.testFlag(MidiOption::Script)) {
+        return MidiInputDispatchTable::Action::Script;
+    }
+    if (mapping.options & (MidiOption::FourteenBitMSB | MidiOption::FourteenBitLSB)) {
+        return MidiInputDispatchTable::Action::FourteenBit;
+    }
+    if (MidiUtils::opCodeFromStatus(mapping.key.status) == MidiOpCode::PitchBendChange) {
+        return MidiInputDispatchTable::Action::PitchBend;
+    }
+    return MidiInputDispatchTable::Action::Value;
+}
+
+} // namespace
+
+MidiInputDispatchTable::MidiInputDispatchTable()
+        : m_pScriptEngine(nullptr) {
+}
+
+MidiInputDispatchTable::~MidiInputDispatchTable() = default;
+
+void MidiInputDispatchTable::compile(const MidiInputMappings& mappings) {
+    clear();
+    if (mappings.isEmpty()) {
+        return;
+    }
+
+    m_entries.reserve(mappings.size());
+    for (const auto& mapping : mappings) {
+        Entry entry{mapping,
+                actionOf(mapping),
+                static_cast<bool>(mapping.options & (MidiOption::Button | MidiOption::Switch)),
+                ControlRegistry::kInvalidId,
+                {},
+                kInvalidHandle};
+        if (entry.action != Action::Script && mapping.control.isValid()) {
+            // Resolves aliases
+            entry.controlId = ControlRegistry::findId(mapping.control);
+            if (entry.controlId == ControlRegistry::kInvalidId) {
+                // The control might be created later, e.g. when adding decks
+                entry.controlId = ControlRegistry::intern(mapping.control);
+            }
+            entry.pControl = ControlRegistry::lookup(entry.controlId);
+        }
+        m_entries.push_back(std::move(entry));
+    }
+    // Stable to preserve the order of multiple mappings for the same key
+    std::stable_sort(m_entries.begin(),
+            m_entries.end(),
+            [](const Entry& lhs, const Entry& rhs) {
+                return lhs.mapping.key.key < rhs.mapping.key.key;
+            });
+
+    m_offsets = std::make_unique<quint32[]>(kKeyCount + 1);
+    quint32 offset = 0;
+    for (int key = 0; key < kKeyCount; ++key) {
+        m_offsets[key] = offset;
+        while (offset < m_entries.size() && m_entries[offset].mapping.key.key == key) {
+            ++offset;
+        }
+    }
+    m_offsets[kKeyCount] = offset;
+    DEBUG_ASSERT(offset == m_entries.size());
+}
+
+void MidiInputDispatchTable::clear() {
+    m_entries.clear();
+    m_offsets.reset();
+    m_pScriptEngine = nullptr;
+}
+
+void MidiInputDispatchTable::bindScriptFunctions(ControllerScriptEngineLegacy* pEngine) {
+    m_pScriptEngine = pEngine;
+    for (auto& entry : m_entries) {
+        if (entry.action != Action::Script) {
+            continue;
+        }
+        if (pEngine) {
+            entry.functionHandle = pEngine->bindFunctionCode(
+                    entry.mapping.control.item, kScriptFunctionArgumentCount);
+        } else {
+            entry.functionHandle = kInvalidHandle;
+        }
+    }
+}
+
+// static
+ControlObject* MidiInputDispatchTable::control(Entry* pEntry) {
+    auto pControl = pEntry->pControl.toStrongRef();
+    if (!pControl) {
+        // Missing when compiling or deleted since then
+        pControl = ControlRegistry::lookup(pEntry->controlId);
+        if (!pControl) {
+            return nullptr;
+        }
+        pEntry->pControl = pControl;
+    }
+    return pControl->getCreatorCO();
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <QSharedPointer>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "controllers/midi/midimessage.h"
+
+class ControlDoublePrivate;
+class ControlObject;
+class ControllerScriptEngineLegacy;
+
+/// The input mappings of a MIDI controller compiled for dispatching incoming
+/// short messages.
+///
+/// Instead of looking up the mappings in a hash for every message, the
+/// mappings are indexed by the MidiKey, i.e. the status byte and the control,
+/// in a flat table with 64K entries. The options that select how a message is
+/// processed are decoded and the target controls and script functions are
+/// resolved once when compiling.
+class MidiInputDispatchTable final {
+  public:
+    enum class Action {
+        Script,
+        FourteenBit,
+        PitchBend,
+        Value,
+    };
+
+    struct Entry {
+        MidiInputMapping mapping;
+        Action action;
+        /// ControlPushButton only accepts NOTE_ON, so <button> and <switch>
+        /// mappings are set as NOTE_ON regardless of the status.
+        bool setAsNoteOn;
+        /// The interned id of the control, used to resolve the control again
+        /// if it has been missing when compiling or has been replaced since.
+        int controlId;
+        /// Weak to not prevent the control from being deleted and created
+        /// again for the same key
+        QWeakPointer<ControlDoublePrivate> pControl;
+        /// The handle of the bound script function or kInvalidHandle
+        int functionHandle;
+    };
+
+    static constexpr int kInvalidHandle = -1;
+
+    MidiInputDispatchTable();
+    ~MidiInputDispatchTable();
+
+    MidiInputDispatchTable(const MidiInputDispatchTable&) = delete;
+    MidiInputDispatchTable& operator=(const MidiInputDispatchTable&) = delete;
+
+    /// Replaces all entries. Multiple mappings for the same key are
+    /// dispatched in the order of mappings.
+    void compile(const MidiInputMappings& mappings);
+    void clear();
+
+    /// Binds the functions of all script entries to pEngine, which might be
+    /// nullptr. Needs to be invoked again after the engine has been replaced.
+    void bindScriptFunctions(ControllerScriptEngineLegacy* pEngine);
+
+    const ControllerScriptEngineLegacy* scriptEngine() const {
+        return m_pScriptEngine;
+    }
+
+    std::span<Entry> entries(MidiKey key) {
+        if (!m_offsets) {
+            return {};
+        }
+        const quint32 first = m_offsets[key.key];
+        return std::span<Entry>(m_entries.data() + first, m_offsets[key.key + 1] - first);
+    }
+
+    /// Returns the control of the entry or nullptr if it does not exist.
+    static ControlObject* control(Entry* pEntry);
+
+  private:
+    static constexpr int kKeyCount = 1 << 16;
+
+    std::vector<Entry> m_entries;
+    /// The entries of a key are in [m_offsets[key], m_offsets[key + 1]).
+    std::unique_ptr<quint32[]> m_offsets;
+    ControllerScriptEngineLegacy* m_pScriptEngine;
+};
@@ -35,6 +35,7 @@ PortMidiController::PortMidiController(const PmDeviceInfo* inputDeviceInfo,
         m_pOutputDevice.reset(new PortMidiDevice(
             outputDeviceInfo, outputDeviceIndex));
     }
+    setPolling(true);
 }
 
 PortMidiController::~PortMidiController() {
@@ -222,6 +223,37 @@ void PortMidiController::sendShortMsg(unsigned char status, unsigned char byte1,
     }
 }
 
+void PortMidiController::sendOutputBatch(
+        std::span<const ControllerOutputQueue::Message> messages) {
+    if (messages.size() == 1) {
+        const quint32 message = messages.front().value;
+        sendShortMsg(static_cast<unsigned char>(message),
+                static_cast<unsigned char>(message >> 8),
+                static_cast<unsigned char>(message >> 16));
+        return;
+    }
+    if (m_pOutputDevice.isNull() || !m_pOutputDevice->isOpen()) {
+        return;
+    }
+
+    m_outputEvents.clear();
+    m_outputEvents.reserve(messages.size());
+    for (const auto& message : messages) {
+        PmEvent event;
+        event.message = static_cast<PmMessage>(message.value);
+        event.timestamp = 0;
+        m_outputEvents.push_back(event);
+    }
+    PmError err = m_pOutputDevice->write(
+            m_outputEvents.data(), static_cast<int32_t>(m_outputEvents.size()));
+    if (err == pmNoError) {
+        qCDebug(m_logOutput) << "outgoing:" << messages.size() << "short messages";
+    } else {
+        qCWarning(m_logOutput) << "Error sending" << messages.size() << "short messages";
+        qCWarning(m_logOutput) << "PortMidi error:" << Pm_GetErrorText(err);
+    }
+}
+
 void PortMidiController::sendBytes(const QByteArray& data) {
     // PortMidi does not receive a length argument for the buffer we provide to
     // Pm_WriteSysEx. Instead, it scans for a MidiOpCode::EndOfExclusive byte
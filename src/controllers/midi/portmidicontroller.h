@@ -3,6 +3,7 @@
 #include <portmidi.h>
 
 #include <QScopedPointer>
+#include <vector>
 
 #include "controllers/midi/midicontroller.h"
 #include "controllers/midi/portmididevice.h"
@@ -66,14 +67,13 @@ class PortMidiController : public MidiController {
                       unsigned char byte2) override;
 
   private:
+    /// Writes the messages with a single Pm_Write()
+    void sendOutputBatch(std::span<const ControllerOutputQueue::Message> messages) override;
+
     // The sysex data must already contain the start byte 0xf0 and the end byte
     // 0xf7.
     void sendBytes(const QByteArray& data) override;
 
-    bool isPolling() const override {
-        return true;
-    }
-
     // For testing only so that test fixtures can install mock PortMidiDevices.
     void setPortMidiInputDevice(PortMidiDevice* device) {
         m_pInputDevice.reset(device);
@@ -86,6 +86,8 @@ class PortMidiController : public MidiController {
     QScopedPointer<PortMidiDevice> m_pOutputDevice;
 
     PmEvent m_midiBuffer[MIXXX_PORTMIDI_BUFFER_LEN];
+    /// Reused by sendOutputBatch()
+    std::vector<PmEvent> m_outputEvents;
 
     // Storage for SysEx messages
     unsigned char m_cReceiveMsg[MIXXX_SYSEX_BUFFER_LEN];
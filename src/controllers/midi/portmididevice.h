@@ -2,6 +2,8 @@
 
 #include <portmidi.h>
 
+#include "util/time.h"
+
 class PortMidiDevice {
   public:
     PortMidiDevice(const PmDeviceInfo* deviceInfo,
@@ -30,7 +32,7 @@ class PortMidiDevice {
         return Pm_OpenInput(&m_pStream, m_deviceIndex,
                             NULL, // no drive hacks
                             bufferSize,
-                            NULL,
+                            &timestampMillis,
                             NULL);
     }
 
@@ -62,11 +64,22 @@ class PortMidiDevice {
         return Pm_WriteShort(m_pStream, 0, message);
     }
 
+    virtual PmError write(PmEvent* buffer, int32_t length) {
+        return Pm_Write(m_pStream, buffer, length);
+    }
+
     virtual PmError writeSysEx(unsigned char* message) {
         return Pm_WriteSysEx(m_pStream, 0, message);
     }
 
   private:
+    /// Timestamps the input in the time base of mixxx::Time::elapsed()
+    /// instead of PortTime, see mixxx::InputTimestamp.
+    static PmTimestamp timestampMillis(void* pTimeInfo) {
+        Q_UNUSED(pTimeInfo);
+        return static_cast<PmTimestamp>(mixxx::Time::elapsed().toIntegerMillis());
+    }
+
     const PmDeviceInfo* m_pDeviceInfo;
     int m_deviceIndex;
     PortMidiStream* m_pStream;
@@ -32,6 +32,10 @@ bool ControllerScriptEngineBase::initialize() {
 
     m_pJSEngine->installExtensions(QJSEngine::ConsoleExtension);
 
+    m_pWatchdog = std::make_unique<ControllerScriptWatchdog>(m_pJSEngine.get(),
+            m_pController ? m_pController->getScriptTimeSlice()
+                          : Controller::kDefaultScriptTimeSlice);
+
     QJSValue engineGlobalObject = m_pJSEngine->globalObject();
 
     QJSValue mapper = m_pJSEngine->newQMetaObject(
@@ -58,6 +62,7 @@ bool ControllerScriptEngineBase::initialize() {
 
 void ControllerScriptEngineBase::shutdown() {
     DEBUG_ASSERT(m_pJSEngine.use_count() == 1);
+    m_pWatchdog.reset();
     m_pJSEngine.reset();
 }
 
@@ -91,7 +96,11 @@ bool ControllerScriptEngineBase::executeFunction(
     }
 
     // If it does happen to be a function, call it.
-    QJSValue returnValue = functionObject.call(args);
+    QJSValue returnValue;
+    {
+        const ControllerScriptWatchdog::Callback callback(m_pWatchdog.get());
+        returnValue = functionObject.call(args);
+    }
     if (returnValue.isError()) {
         showScriptExceptionDialog(returnValue);
         return false;
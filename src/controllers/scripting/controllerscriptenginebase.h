@@ -7,6 +7,7 @@
 #include <memory>
 
 #include "controllers/legacycontrollermapping.h"
+#include "controllers/scripting/controllerscriptwatchdog.h"
 #include "util/duration.h"
 #include "util/runtimeloggingcategory.h"
 
@@ -44,6 +45,12 @@ class ControllerScriptEngineBase : public QObject {
         return m_bTesting;
     }
 
+    /// Must be passed to a ControllerScriptWatchdog::Callback around each
+    /// call into the script. nullptr if the engine has not been initialized.
+    ControllerScriptWatchdog* watchdog() const {
+        return m_pWatchdog.get();
+    }
+
   protected:
     virtual void shutdown();
 
@@ -51,6 +58,7 @@ class ControllerScriptEngineBase : public QObject {
 
     bool m_bDisplayingExceptionDialog;
     std::shared_ptr<QJSEngine> m_pJSEngine;
+    std::unique_ptr<ControllerScriptWatchdog> m_pWatchdog;
 
     Controller* m_pController;
     const RuntimeLoggingCategory m_logger;
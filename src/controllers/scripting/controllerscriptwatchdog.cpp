@@ -0,0 +1,155 @@
+#include "controllers/scripting/controllerscriptwatchdog.h"
+
+#include <QJSEngine>
+#include <QThread>
+#include <QVector>
+#include <QtDebug>
+
+#include "util/assert.h"
+#include "util/math.h"
+#include "util/mutex.h"
+#include "util/time.h"
+
+namespace {
+
+/// The resolution of the deadlines
+constexpr unsigned long kCheckIntervalMillis = 10;
+
+/// Checks the deadlines of all watchdogs. Only runs while at least one
+/// script engine exists.
+class WatchdogThread : public QThread {
+  public:
+    WatchdogThread()
+            : m_stop(false) {
+        setObjectName(QStringLiteral("ControllerScriptWatchdog"));
+    }
+
+    void add(ControllerScriptWatchdog* pWatchdog) {
+        const MMutexLocker lifecycleLocker(&m_lifecycleMutex);
+        {
+            const MMutexLocker locker(&m_mutex);
+            m_watchdogs.append(pWatchdog);
+        }
+        if (!isRunning()) {
+            m_stop = false;
+            start(QThread::HighPriority);
+        }
+    }
+
+    void remove(ControllerScriptWatchdog* pWatchdog) {
+        const MMutexLocker lifecycleLocker(&m_lifecycleMutex);
+        bool empty;
+        {
+            // Waits until the watchdog is not checked anymore
+            const MMutexLocker locker(&m_mutex);
+            m_watchdogs.removeOne(pWatchdog);
+            empty = m_watchdogs.isEmpty();
+        }
+        if (empty) {
+            m_stop = true;
+            wait();
+        }
+    }
+
+  protected:
+    void run() override {
+        while (!m_stop) {
+            QThread::msleep(kCheckIntervalMillis);
+            const qint64 nowNanos = mixxx::Time::elapsed().toIntegerNanos();
+            const MMutexLocker locker(&m_mutex);
+            for (ControllerScriptWatchdog* pWatchdog : qAsConst(m_watchdogs)) {
+                pWatchdog->interruptIfOverrun(nowNanos);
+            }
+        }
+    }
+
+  private:
+    /// Serializes starting and stopping the thread
+    MMutex m_lifecycleMutex;
+    MMutex m_mutex;
+    QVector<ControllerScriptWatchdog*> m_watchdogs GUARDED_BY(m_mutex);
+    std::atomic<bool> m_stop;
+};
+
+WatchdogThread* watchdogThread() {
+    // Never deleted, the thread is stopped when the last engine is deleted
+    static WatchdogThread* s_pThread = new WatchdogThread;
+    return s_pThread;
+}
+
+} // namespace
+
+ControllerScriptWatchdog::ControllerScriptWatchdog(
+        QJSEngine* pEngine, mixxx::Duration timeSlice)
+        : m_pEngine(pEngine),
+          m_timeSlice(timeSlice),
+          m_callbackDepth(0),
+          m_callbackStartNanos(0),
+          m_overrunCount(0),
+          m_deadlineNanos(0),
+          m_interrupting(false) {
+    DEBUG_ASSERT(m_pEngine);
+    DEBUG_ASSERT(m_timeSlice > mixxx::Duration::empty());
+    watchdogThread()->add(this);
+}
+
+ControllerScriptWatchdog::~ControllerScriptWatchdog() {
+    DEBUG_ASSERT(m_callbackDepth == 0);
+    watchdogThread()->remove(this);
+}
+
+void ControllerScriptWatchdog::beginCallback() {
+    if (m_callbackDepth++ > 0) {
+        return;
+    }
+    m_callbackStartNanos = mixxx::Time::elapsed().toIntegerNanos();
+    // 0 is reserved for idle
+    m_deadlineNanos.store(
+            math_max(m_callbackStartNanos + m_timeSlice.toIntegerNanos(), qint64{1}),
+            std::memory_order_relaxed);
+}
+
+void ControllerScriptWatchdog::endCallback() {
+    DEBUG_ASSERT(m_callbackDepth > 0);
+    if (--m_callbackDepth > 0) {
+        return;
+    }
+    const qint64 deadlineNanos = m_deadlineNanos.exchange(0, std::memory_order_acq_rel);
+    if (deadlineNanos == kInterrupted) {
+        // Don't reset the interruption before it has been requested,
+        // otherwise the next callback would be interrupted instead
+        while (m_interrupting.load(std::memory_order_acquire)) {
+            QThread::yieldCurrentThread();
+        }
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+        m_pEngine->setInterrupted(false);
+#endif
+    }
+    const auto duration = mixxx::Duration::fromNanos(
+            mixxx::Time::elapsed().toIntegerNanos() - m_callbackStartNanos);
+    if (duration > m_timeSlice) {
+        ++m_overrunCount;
+        qWarning() << "Controller script callback"
+                   << (deadlineNanos == kInterrupted ? "interrupted after"
+                                                     : "exceeded its time slice after")
+                   << duration.formatMillisWithUnit();
+    }
+}
+
+void ControllerScriptWatchdog::interruptIfOverrun(qint64 nowNanos) {
+    qint64 deadlineNanos = m_deadlineNanos.load(std::memory_order_relaxed);
+    if (deadlineNanos <= 0 || nowNanos < deadlineNanos) {
+        // Idle, already interrupted or in time
+        return;
+    }
+    m_interrupting.store(true, std::memory_order_release);
+    // Fails if the callback has finished in the meantime
+    if (m_deadlineNanos.compare_exchange_strong(deadlineNanos,
+                kInterrupted,
+                std::memory_order_acq_rel)) {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+        m_pEngine->setInterrupted(true);
+#endif
+    }
+    m_interrupting.store(false, std::memory_order_release);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+
+#include "util/duration.h"
+
+class QJSEngine;
+
+/// Interrupts the callbacks of a controller script engine that run longer
+/// than their time slice, e.g. because of an endless loop in a mapping.
+/// Otherwise such a callback would block all other controllers that are
+/// processed by the same thread.
+///
+/// The engine marks the begin and end of each callback with atomic stores,
+/// i.e. callbacks never lock. A single thread that is shared by all
+/// watchdogs checks the deadlines of the running callbacks periodically.
+/// Interrupting requires Qt 5.14, with earlier versions overlong callbacks
+/// are only reported after they have finished.
+class ControllerScriptWatchdog final {
+  public:
+    /// Marks a callback for its lifetime. Nested callbacks, e.g. a
+    /// connection callback triggered by a control set from a callback, are
+    /// part of the outermost callback.
+    class Callback final {
+      public:
+        /// pWatchdog might be nullptr
+        explicit Callback(ControllerScriptWatchdog* pWatchdog)
+                : m_pWatchdog(pWatchdog) {
+            if (m_pWatchdog) {
+                m_pWatchdog->beginCallback();
+            }
+        }
+        ~Callback() {
+            if (m_pWatchdog) {
+                m_pWatchdog->endCallback();
+            }
+        }
+
+        Callback(const Callback&) = delete;
+        Callback& operator=(const Callback&) = delete;
+
+      private:
+        ControllerScriptWatchdog* const m_pWatchdog;
+    };
+
+    ControllerScriptWatchdog(QJSEngine* pEngine, mixxx::Duration timeSlice);
+    ~ControllerScriptWatchdog();
+
+    ControllerScriptWatchdog(const ControllerScriptWatchdog&) = delete;
+    ControllerScriptWatchdog& operator=(const ControllerScriptWatchdog&) = delete;
+
+    mixxx::Duration timeSlice() const {
+        return m_timeSlice;
+    }
+
+    /// The number of callbacks that have exceeded their time slice
+    int overrunCount() const {
+        return m_overrunCount;
+    }
+
+    /// Invoked by the watchdog thread
+    void interruptIfOverrun(qint64 nowNanos);
+
+  private:
+    void beginCallback();
+    void endCallback();
+
+    /// Marks m_deadlineNanos of an interrupted callback
+    static constexpr qint64 kInterrupted = -1;
+
+    QJSEngine* const m_pEngine;
+    const mixxx::Duration m_timeSlice;
+    /// Only accessed by the thread of the engine
+    int m_callbackDepth;
+    qint64 m_callbackStartNanos;
+    int m_overrunCount;
+    /// The deadline of the running callback, 0 if idle
+    std::atomic<qint64> m_deadlineNanos;
+    /// Set while the watchdog thread interrupts the engine
+    std::atomic<bool> m_interrupting;
+};
@@ -0,0 +1,44 @@
+#include "controllers/scripting/legacy/controlhandlejsproxy.h"
+
+#include "control/controlobjectscript.h"
+#include "controllers/scripting/legacy/controllerscriptinterfacelegacy.h"
+#include "moc_controlhandlejsproxy.cpp"
+
+ControlHandleJSProxy::ControlHandleJSProxy(
+        ControllerScriptInterfaceLegacy* pScriptInterface,
+        ControlObjectScript* pControl)
+        : m_pScriptInterface(pScriptInterface),
+          m_pControl(pControl) {
+}
+
+QString ControlHandleJSProxy::readGroup() const {
+    return m_pControl->getKey().group;
+}
+
+QString ControlHandleJSProxy::readItem() const {
+    return m_pControl->getKey().item;
+}
+
+double ControlHandleJSProxy::readValue() const {
+    return m_pControl->get();
+}
+
+void ControlHandleJSProxy::writeValue(double value) {
+    m_pScriptInterface->setControlValue(m_pControl, value);
+}
+
+double ControlHandleJSProxy::readParameter() const {
+    return m_pControl->getParameter();
+}
+
+void ControlHandleJSProxy::writeParameter(double parameter) {
+    m_pScriptInterface->setControlParameter(m_pControl, parameter);
+}
+
+void ControlHandleJSProxy::reset() {
+    m_pControl->reset();
+}
+
+void ControlHandleJSProxy::trigger() {
+    m_pControl->emitValueChanged();
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QObject>
+
+class ControllerScriptInterfaceLegacy;
+class ControlObjectScript;
+
+/// ControlHandleJSProxy provides scripts with a handle to a single control,
+/// returned by engine.getControl(). The control is resolved when creating the
+/// handle, i.e. accessing its value neither passes the group and item strings
+/// from JS nor looks up the control.
+class ControlHandleJSProxy : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(QString group READ readGroup CONSTANT)
+    Q_PROPERTY(QString item READ readItem CONSTANT)
+    Q_PROPERTY(double value READ readValue WRITE writeValue)
+    Q_PROPERTY(double parameter READ readParameter WRITE writeParameter)
+  public:
+    ControlHandleJSProxy(ControllerScriptInterfaceLegacy* pScriptInterface,
+            ControlObjectScript* pControl);
+
+    QString readGroup() const;
+    QString readItem() const;
+    double readValue() const;
+    void writeValue(double value);
+    double readParameter() const;
+    void writeParameter(double parameter);
+
+    Q_INVOKABLE void reset();
+    Q_INVOKABLE void trigger();
+
+    ControlObjectScript* control() const {
+        return m_pControl;
+    }
+
+  private:
+    ControllerScriptInterfaceLegacy* const m_pScriptInterface;
+    ControlObjectScript* const m_pControl;
+};
@@ -8,9 +8,29 @@
 #include "mixer/playermanager.h"
 #include "moc_controllerscriptenginelegacy.cpp"
 
+namespace {
+
+/// Recycled arrays are filled with one call per byte, i.e. larger packets
+/// are faster copied into a new ArrayBuffer.
+constexpr int kMaxRecycledIncomingDataSize = 1024;
+
+/// Limits the arrays kept for devices that send packets of varying size
+constexpr int kMaxRecycledIncomingDataSizes = 16;
+
+/// A Uint8Array and the ArrayBuffer that holds its data
+constexpr int kJSObjectsPerArray = 2;
+
+} // namespace
+
 ControllerScriptEngineLegacy::ControllerScriptEngineLegacy(
         Controller* controller, const RuntimeLoggingCategory& logger)
-        : ControllerScriptEngineBase(controller, logger) {
+        : ControllerScriptEngineBase(controller, logger),
+          m_recycleIncomingData(false),
+          m_incomingDataAllocationCount(0),
+          m_incomingDataRecycledCount(0),
+          m_incomingDataAllocationCounter(
+                  QStringLiteral("Controller script incoming data allocations ") +
+                  (controller ? controller->getName() : QString())) {
     connect(&m_fileWatcher,
             &QFileSystemWatcher::fileChanged,
             this,
@@ -48,7 +68,11 @@ bool ControllerScriptEngineLegacy::callFunctionOnObjects(
         }
         qCDebug(m_logger) << "Executing"
                           << prefixName << "." << function;
-        QJSValue result = init.callWithInstance(prefix, args);
+        QJSValue result;
+        {
+            const ControllerScriptWatchdog::Callback callback(m_pWatchdog.get());
+            result = init.callWithInstance(prefix, args);
+        }
         if (result.isError()) {
             showScriptExceptionDialog(result, bFatalError);
             success = false;
@@ -90,6 +114,32 @@ QJSValue ControllerScriptEngineLegacy::wrapFunctionCode(
     return wrappedFunction;
 }
 
+int ControllerScriptEngineLegacy::bindFunctionCode(
+        const QString& codeSnippet, int numberOfArgs) {
+    const auto it = m_boundFunctionHandles.constFind(codeSnippet);
+    if (it != m_boundFunctionHandles.constEnd()) {
+        DEBUG_ASSERT(m_boundFunctions.at(it.value()).numberOfArgs == numberOfArgs);
+        return it.value();
+    }
+    const int handle = m_boundFunctions.size();
+    m_boundFunctions.append(BoundFunction{codeSnippet, numberOfArgs, QJSValue()});
+    m_boundFunctionHandles.insert(codeSnippet, handle);
+    return handle;
+}
+
+bool ControllerScriptEngineLegacy::executeBoundFunction(
+        int handle, const QJSValueList& args) {
+    VERIFY_OR_DEBUG_ASSERT(handle >= 0 && handle < m_boundFunctions.size()) {
+        return false;
+    }
+    BoundFunction& boundFunction = m_boundFunctions[handle];
+    if (boundFunction.function.isUndefined()) {
+        boundFunction.function = wrapFunctionCode(
+                boundFunction.codeSnippet, boundFunction.numberOfArgs);
+    }
+    return executeFunction(boundFunction.function, args);
+}
+
 void ControllerScriptEngineLegacy::setScriptFiles(
         const QList<LegacyControllerMapping::ScriptFileInfo>& scripts) {
     const QStringList paths = m_fileWatcher.files();
@@ -108,16 +158,14 @@ bool ControllerScriptEngineLegacy::initialize() {
     // QJSEngine::toScriptValue converts to an ArrayBuffer in JavaScript.
     // ArrayBuffer cannot be accessed with the [] operator in JS; it needs
     // to be converted to a typed array (Uint8Array in this case) first.
-    // This function generates a wrapper function from a JS callback to do
-    // that conversion automatically.
-    m_makeArrayBufferWrapperFunction = m_pJSEngine->evaluate(QStringLiteral(
-            // arg2 is the timestamp for ControllerScriptModuleEngine.
-            // In ControllerScriptEngineLegacy it is the length of the array.
-            "(function(callback) {"
-            "    return function(arrayBuffer, arg2) {"
-            "        callback(new Uint8Array(arrayBuffer), arg2);"
-            "    };"
+    // The conversion is done once per packet for all incomingData functions.
+    // The same function allocates the recycled arrays.
+    m_makeUint8ArrayFunction = m_pJSEngine->evaluate(QStringLiteral(
+            "(function(arrayBuffer) {"
+            "    return new Uint8Array(arrayBuffer);"
             "})"));
+    m_incomingDataAllocationCount = 0;
+    m_incomingDataRecycledCount = 0;
 
     // Make this ControllerScriptHandler instance available to scripts as 'engine'.
     QJSValue engineGlobalObject = m_pJSEngine->globalObject();
@@ -147,9 +195,7 @@ bool ControllerScriptEngineLegacy::initialize() {
             continue;
         }
         functionName.append(QStringLiteral(".incomingData"));
-        m_incomingDataFunctions.append(
-                wrapArrayBufferCallback(
-                        wrapFunctionCode(functionName, 2)));
+        m_incomingDataFunctions.append(wrapFunctionCode(functionName, 2));
     }
 
     // m_pController is nullptr in tests.
@@ -173,8 +219,19 @@ void ControllerScriptEngineLegacy::shutdown() {
         callFunctionOnObjects(m_scriptFunctionPrefixes, "shutdown");
     }
     m_scriptWrappedFunctionCache.clear();
+    for (auto& boundFunction : m_boundFunctions) {
+        boundFunction.function = QJSValue();
+    }
     m_incomingDataFunctions.clear();
     m_scriptFunctionPrefixes.clear();
+    if (m_incomingDataAllocationCount > 0) {
+        qCDebug(m_logger) << "Allocated" << m_incomingDataAllocationCount
+                          << "JS objects for incoming data, recycled arrays for"
+                          << m_incomingDataRecycledCount << "packets";
+    }
+    m_recycledIncomingData.clear();
+    m_recycleIncomingData = false;
+    m_makeUint8ArrayFunction = QJSValue();
     if (m_pJSEngine) {
         ControllerScriptEngineBase::shutdown();
     }
@@ -187,8 +244,12 @@ bool ControllerScriptEngineLegacy::handleIncomingData(const QByteArray& data) {
         return false;
     }
 
+    if (m_incomingDataFunctions.isEmpty()) {
+        return true;
+    }
+
     const auto args = QJSValueList{
-            m_pJSEngine->toScriptValue(data),
+            incomingDataArray(data),
             static_cast<uint>(data.size()),
     };
 
@@ -256,7 +317,12 @@ bool ControllerScriptEngineLegacy::evaluateScriptFile(const QFileInfo& scriptFil
     QString scriptCode = QString(input.readAll()) + QStringLiteral("\n");
     input.close();
 
-    QJSValue scriptFunction = m_pJSEngine->evaluate(scriptCode, filename);
+    QJSValue scriptFunction;
+    {
+        // The top-level code of the mapping might not terminate either
+        const ControllerScriptWatchdog::Callback callback(m_pWatchdog.get());
+        scriptFunction = m_pJSEngine->evaluate(scriptCode, filename);
+    }
     if (scriptFunction.isError()) {
         showScriptExceptionDialog(scriptFunction, true);
         return false;
@@ -265,6 +331,45 @@ bool ControllerScriptEngineLegacy::evaluateScriptFile(const QFileInfo& scriptFil
     return true;
 }
 
-QJSValue ControllerScriptEngineLegacy::wrapArrayBufferCallback(const QJSValue& callback) {
-    return m_makeArrayBufferWrapperFunction.call(QJSValueList{callback});
+void ControllerScriptEngineLegacy::setIncomingDataRecycling(bool enabled) {
+    m_recycleIncomingData = enabled;
+    if (!enabled) {
+        m_recycledIncomingData.clear();
+    }
+}
+
+QJSValue ControllerScriptEngineLegacy::incomingDataArray(const QByteArray& data) {
+    const int size = data.size();
+    QJSValue* pArray = nullptr;
+    if (m_recycleIncomingData && size <= kMaxRecycledIncomingDataSize) {
+        auto it = m_recycledIncomingData.find(size);
+        if (it == m_recycledIncomingData.end()) {
+            if (m_recycledIncomingData.size() >= kMaxRecycledIncomingDataSizes) {
+                // The dropped arrays are left to the garbage collector
+                m_recycledIncomingData.clear();
+            }
+            it = m_recycledIncomingData.insert(size, RecycledArrays{{}, 0});
+        }
+        RecycledArrays& recycled = it.value();
+        pArray = &recycled.arrays[recycled.next];
+        recycled.next = (recycled.next + 1) % kRecycledIncomingDataArrayCount;
+        if (!pArray->isUndefined()) {
+            // Fill in place, setting array elements does not allocate
+            const auto* pData = reinterpret_cast<const quint8*>(data.constData());
+            for (int i = 0; i < size; ++i) {
+                pArray->setProperty(static_cast<quint32>(i), static_cast<int>(pData[i]));
+            }
+            ++m_incomingDataRecycledCount;
+            return *pArray;
+        }
+    }
+
+    m_incomingDataAllocationCount += kJSObjectsPerArray;
+    m_incomingDataAllocationCounter.increment(kJSObjectsPerArray);
+    QJSValue array = m_makeUint8ArrayFunction.call(
+            QJSValueList{m_pJSEngine->toScriptValue(data)});
+    if (pArray) {
+        *pArray = array;
+    }
+    return array;
 }
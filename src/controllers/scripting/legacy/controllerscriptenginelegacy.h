@@ -4,9 +4,11 @@
 #include <QJSEngine>
 #include <QJSValue>
 #include <QMessageBox>
+#include <array>
 
 #include "controllers/legacycontrollermapping.h"
 #include "controllers/scripting/controllerscriptenginebase.h"
+#include "util/counter.h"
 
 /// ControllerScriptEngineLegacy loads and executes controller scripts for the legacy
 /// JS/XML hybrid controller mapping system.
@@ -21,11 +23,39 @@ class ControllerScriptEngineLegacy : public ControllerScriptEngineBase {
 
     bool handleIncomingData(const QByteArray& data);
 
+    /// If enabled, the data of incoming packets is passed in Uint8Arrays that
+    /// are allocated once per packet size and recycled after
+    /// kRecycledIncomingDataArrayCount further packets of the same size,
+    /// i.e. scripts may keep the previous packets for comparison but not an
+    /// unlimited history. Disabled by default and when reloading the scripts.
+    void setIncomingDataRecycling(bool enabled);
+    bool isIncomingDataRecycling() const {
+        return m_recycleIncomingData;
+    }
+
+    /// The number of JS objects allocated for passing incoming data to the
+    /// scripts since initialize(), i.e. the garbage produced per packet.
+    quint64 incomingDataAllocationCount() const {
+        return m_incomingDataAllocationCount;
+    }
+    /// The number of packets passed in recycled arrays since initialize().
+    quint64 incomingDataRecycledCount() const {
+        return m_incomingDataRecycledCount;
+    }
+
+    static constexpr int kRecycledIncomingDataArrayCount = 4;
+
     /// Wrap a string of JS code in an anonymous function. This allows any JS
     /// string that evaluates to a function to be used in MIDI mapping XML files
     /// and ensures the function is executed with the correct 'this' object.
     QJSValue wrapFunctionCode(const QString& codeSnippet, int numberOfArgs);
 
+    /// Registers a code snippet for wrapFunctionCode() once and returns a
+    /// handle for executeBoundFunction(), i.e. the snippet is not looked up
+    /// for every invocation. Handles stay valid when the scripts are reloaded.
+    int bindFunctionCode(const QString& codeSnippet, int numberOfArgs);
+    bool executeBoundFunction(int handle, const QJSValueList& args);
+
   public slots:
     void setScriptFiles(const QList<LegacyControllerMapping::ScriptFileInfo>& scripts);
 
@@ -33,16 +63,37 @@ class ControllerScriptEngineLegacy : public ControllerScriptEngineBase {
     bool evaluateScriptFile(const QFileInfo& scriptFile);
     void shutdown() override;
 
-    QJSValue wrapArrayBufferCallback(const QJSValue& callback);
+    /// Returns a Uint8Array with the contents of data.
+    QJSValue incomingDataArray(const QByteArray& data);
     bool callFunctionOnObjects(const QList<QString>& scriptFunctionPrefixes,
             const QString&,
             const QJSValueList& args = {},
             bool bFatalError = false);
 
-    QJSValue m_makeArrayBufferWrapperFunction;
+    QJSValue m_makeUint8ArrayFunction;
     QList<QString> m_scriptFunctionPrefixes;
     QList<QJSValue> m_incomingDataFunctions;
+
+    struct RecycledArrays {
+        std::array<QJSValue, kRecycledIncomingDataArrayCount> arrays;
+        int next;
+    };
+    /// By the size of the packets
+    QHash<int, RecycledArrays> m_recycledIncomingData;
+    bool m_recycleIncomingData;
+    quint64 m_incomingDataAllocationCount;
+    quint64 m_incomingDataRecycledCount;
+    Counter m_incomingDataAllocationCounter;
     QHash<QString, QJSValue> m_scriptWrappedFunctionCache;
+
+    struct BoundFunction {
+        QString codeSnippet;
+        int numberOfArgs;
+        /// Wrapped on first invocation after (re)loading the scripts
+        QJSValue function;
+    };
+    QVector<BoundFunction> m_boundFunctions;
+    QHash<QString, int> m_boundFunctionHandles;
     QList<LegacyControllerMapping::ScriptFileInfo> m_scriptFiles;
 
     QFileSystemWatcher m_fileWatcher;
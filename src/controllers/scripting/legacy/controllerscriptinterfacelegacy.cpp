@@ -2,11 +2,13 @@
 
 #include "control/controlobject.h"
 #include "control/controlobjectscript.h"
+#include "controllers/scripting/legacy/controlhandlejsproxy.h"
 #include "controllers/scripting/legacy/controllerscriptenginelegacy.h"
 #include "controllers/scripting/legacy/scriptconnectionjsproxy.h"
 #include "mixer/playermanager.h"
 #include "moc_controllerscriptinterfacelegacy.cpp"
 #include "util/fpclassify.h"
+#include "util/inputtimestamp.h"
 #include "util/time.h"
 
 #define SCRATCH_DEBUG_OUTPUT false
@@ -118,23 +120,26 @@ double ControllerScriptInterfaceLegacy::getValue(const QString& group, const QSt
 
 void ControllerScriptInterfaceLegacy::setValue(
         const QString& group, const QString& name, double newValue) {
+    ControlObjectScript* coScript = getControlObjectScript(group, name);
+
+    if (coScript != nullptr) {
+        setControlValue(coScript, newValue);
+    }
+}
+
+void ControllerScriptInterfaceLegacy::setControlValue(
+        ControlObjectScript* pControl, double newValue) {
     if (util_isnan(newValue)) {
         logOrThrowError(QStringLiteral(
                 "Script tried setting (%1, %2) to NotANumber (NaN)")
-                                .arg(group, name));
+                                .arg(pControl->getKey().group, pControl->getKey().item));
         return;
     }
-
-    ControlObjectScript* coScript = getControlObjectScript(group, name);
-
-    if (coScript != nullptr) {
-        ControlObject* pControl = ControlObject::getControl(
-                coScript->getKey(), ControlFlag::AllowMissingOrInvalid);
-        if (pControl &&
-                !m_st.ignore(
-                        pControl, coScript->getParameterForValue(newValue))) {
-            coScript->set(newValue);
-        }
+    ControlObject* pControlObject = pControl->getControlObject();
+    if (pControlObject &&
+            !m_st.ignore(
+                    pControlObject, pControl->getParameterForValue(newValue))) {
+        pControl->set(newValue);
     }
 }
 
@@ -149,21 +154,24 @@ double ControllerScriptInterfaceLegacy::getParameter(const QString& group, const
 
 void ControllerScriptInterfaceLegacy::setParameter(
         const QString& group, const QString& name, double newParameter) {
+    ControlObjectScript* coScript = getControlObjectScript(group, name);
+
+    if (coScript != nullptr) {
+        setControlParameter(coScript, newParameter);
+    }
+}
+
+void ControllerScriptInterfaceLegacy::setControlParameter(
+        ControlObjectScript* pControl, double newParameter) {
     if (util_isnan(newParameter)) {
         logOrThrowError(QStringLiteral(
                 "Script tried setting (%1, %2) to NotANumber (NaN)")
-                                .arg(group, name));
+                                .arg(pControl->getKey().group, pControl->getKey().item));
         return;
     }
-
-    ControlObjectScript* coScript = getControlObjectScript(group, name);
-
-    if (coScript != nullptr) {
-        ControlObject* pControl = ControlObject::getControl(
-                coScript->getKey(), ControlFlag::AllowMissingOrInvalid);
-        if (pControl && !m_st.ignore(pControl, newParameter)) {
-            coScript->setParameter(newParameter);
-        }
+    ControlObject* pControlObject = pControl->getControlObject();
+    if (pControlObject && !m_st.ignore(pControlObject, newParameter)) {
+        pControl->setParameter(newParameter);
     }
 }
 
@@ -216,6 +224,43 @@ double ControllerScriptInterfaceLegacy::getDefaultParameter(
     return coScript->getParameterForValue(coScript->getDefault());
 }
 
+QJSValue ControllerScriptInterfaceLegacy::getControl(
+        const QString& group, const QString& name) {
+    auto pJsEngine = m_pScriptEngineLegacy->jsEngine();
+    VERIFY_OR_DEBUG_ASSERT(pJsEngine) {
+        return QJSValue();
+    }
+
+    ControlObjectScript* coScript = getControlObjectScript(group, name);
+    if (coScript == nullptr) {
+        logOrThrowError(QStringLiteral("Unknown control (%1, %2) returning undefined")
+                                .arg(group, name));
+        return QJSValue();
+    }
+    return pJsEngine->newQObject(new ControlHandleJSProxy(this, coScript));
+}
+
+void ControllerScriptInterfaceLegacy::setValues(const QJSValue& handlesAndValues) {
+    if (!handlesAndValues.isArray()) {
+        logOrThrowError(QStringLiteral(
+                "setValues expects an array of [control, value] pairs"));
+        return;
+    }
+    const int length = handlesAndValues.property(QStringLiteral("length")).toInt();
+    for (int i = 0; i < length; ++i) {
+        const QJSValue handleAndValue = handlesAndValues.property(i);
+        auto* pHandle = qobject_cast<ControlHandleJSProxy*>(
+                handleAndValue.property(0).toQObject());
+        if (!pHandle) {
+            logOrThrowError(QStringLiteral(
+                    "setValues expects controls returned by getControl at index %1")
+                                    .arg(i));
+            continue;
+        }
+        setControlValue(pHandle->control(), handleAndValue.property(1).toNumber());
+    }
+}
+
 QJSValue ControllerScriptInterfaceLegacy::makeConnection(
         const QString& group, const QString& name, const QJSValue& callback) {
     return ControllerScriptInterfaceLegacy::makeConnectionInternal(group, name, callback, false);
@@ -701,7 +746,9 @@ void ControllerScriptInterfaceLegacy::scratchEnable(int deck,
 }
 
 void ControllerScriptInterfaceLegacy::scratchTick(int deck, int interval) {
-    m_lastMovement[deck] = mixxx::Time::elapsed();
+    // The time when the controller has sent the tick, which might have
+    // been processed with a delay
+    m_lastMovement[deck] = mixxx::InputTimestamp::current();
     m_intervalAccumulator[deck] += interval;
 }
 
@@ -1002,3 +1049,7 @@ void ControllerScriptInterfaceLegacy::softStart(int deck, bool activate, double
     // activate the ramping in scratchProcess()
     m_ramp[deck] = true;
 }
+
+void ControllerScriptInterfaceLegacy::setIncomingDataRecycling(bool enable) {
+    m_pScriptEngineLegacy->setIncomingDataRecycling(enable);
+}
@@ -31,6 +31,13 @@ class ControllerScriptInterfaceLegacy : public QObject {
     Q_INVOKABLE void reset(const QString& group, const QString& name);
     Q_INVOKABLE double getDefaultValue(const QString& group, const QString& name);
     Q_INVOKABLE double getDefaultParameter(const QString& group, const QString& name);
+    /// Returns a handle with the properties value and parameter, that avoids
+    /// looking up the control on each access, or undefined if the control
+    /// doesn't exist.
+    Q_INVOKABLE QJSValue getControl(const QString& group, const QString& name);
+    /// Sets the values of multiple controls with a single call, passed as
+    /// an array of [handle, value] pairs with handles from getControl().
+    Q_INVOKABLE void setValues(const QJSValue& handlesAndValues);
     Q_INVOKABLE QJSValue makeConnection(const QString& group,
             const QString& name,
             const QJSValue& callback);
@@ -68,6 +75,9 @@ class ControllerScriptInterfaceLegacy : public QObject {
             double factor = 1.8,
             const double rate = -10.0);
     Q_INVOKABLE void softStart(const int deck, bool activate, double factor = 1.0);
+    /// Passes incoming data in recycled arrays, see
+    /// ControllerScriptEngineLegacy::setIncomingDataRecycling()
+    Q_INVOKABLE void setIncomingDataRecycling(bool enable);
 
     bool removeScriptConnection(const ScriptConnection& conn);
     /// Execute a ScriptConnection's JS callback
@@ -83,6 +93,8 @@ class ControllerScriptInterfaceLegacy : public QObject {
             bool skipSuperseded = false);
     QHash<ConfigKey, ControlObjectScript*> m_controlCache;
     ControlObjectScript* getControlObjectScript(const QString& group, const QString& name);
+    void setControlValue(ControlObjectScript* pControl, double newValue);
+    void setControlParameter(ControlObjectScript* pControl, double newParameter);
     void logOrThrowError(const QString& errorMessage) const;
 
     SoftTakeoverCtrl m_st;
@@ -109,4 +121,6 @@ class ControllerScriptInterfaceLegacy : public QObject {
 
     ControllerScriptEngineLegacy* m_pScriptEngineLegacy;
     const RuntimeLoggingCategory m_logger;
+
+    friend class ControlHandleJSProxy;
 };
@@ -11,7 +11,12 @@ void ScriptConnection::executeCallback(double value) const {
             key.item,
     };
     QJSValue func = callback; // copy function because QJSValue::call is not const
-    QJSValue result = func.call(args);
+    QJSValue result;
+    {
+        const ControllerScriptWatchdog::Callback watchdogCallback(
+                controllerEngine ? controllerEngine->watchdog() : nullptr);
+        result = func.call(args);
+    }
     if (result.isError()) {
         if (controllerEngine != nullptr) {
             controllerEngine->showScriptExceptionDialog(result);
@@ -9,12 +9,14 @@
 #include "broadcast/broadcastmanager.h"
 #endif
 #include "control/controlindicatortimer.h"
+#include "control/controlnotificationdispatcher.h"
 #include "controllers/controllermanager.h"
 #include "controllers/keyboard/keyboardeventfilter.h"
 #include "database/mixxxdb.h"
 #include "effects/effectsmanager.h"
 #include "engine/enginemaster.h"
 #include "library/coverartcache.h"
+#include "library/coverartthumbnailpack.h"
 #include "library/library.h"
 #include "library/library_prefs.h"
 #include "library/trackcollection.h"
@@ -27,6 +29,12 @@
 #include "preferences/dialog/dlgprefmodplug.h"
 #endif
 #include "soundio/soundmanager.h"
+#ifdef __FFMPEG__
+#include "sources/ffmpegseekindex.h"
+#endif
+#ifdef __MAD__
+#include "sources/mp3seektablecache.h"
+#endif
 #include "sources/soundsourceproxy.h"
 #include "util/db/dbconnectionpooled.h"
 #include "util/font.h"
@@ -60,6 +68,9 @@ namespace {
 const mixxx::Logger kLogger("CoreServices");
 constexpr int kMicrophoneCount = 4;
 constexpr int kAuxiliaryCount = 4;
+// Covers quickly browsing through tracks with the preview deck and
+// reloading a few samplers
+constexpr int kSoundSourcePoolCapacity = 8;
 
 #define CLEAR_AND_CHECK_DELETED(x) clearHelper(x, #x);
 
@@ -234,6 +245,18 @@ void CoreServices::initialize(QApplication* pApp) {
 
     Sandbox::setPermissionsFilePath(QDir(pConfig->getSettingsPath()).filePath("sandbox.cfg"));
 
+#ifdef __FFMPEG__
+    mixxx::FFmpegSeekIndexCache::setDirectory(
+            QDir(pConfig->getSettingsPath()).filePath("ffmpegseekindex"));
+#endif
+#ifdef __MAD__
+    mixxx::Mp3SeekTableCache::setDirectory(
+            QDir(pConfig->getSettingsPath()).filePath("mp3seektables"));
+#endif
+    CoverArtThumbnailPack::setFilePath(
+            QDir(pConfig->getSettingsPath()).filePath("coverart_thumbnails.pack"));
+    SoundSourceProxy::setSoundSourcePoolCapacity(kSoundSourcePoolCapacity);
+
     QString resourcePath = pConfig->getResourcePath();
 
     emit initializationProgressUpdate(0, tr("fonts"));
@@ -252,6 +275,8 @@ void CoreServices::initialize(QApplication* pApp) {
     }
 
     m_pControlIndicatorTimer = std::make_shared<mixxx::ControlIndicatorTimer>(this);
+    m_pControlNotificationDispatcher =
+            std::make_shared<mixxx::ControlNotificationDispatcher>(this);
 
     auto pChannelHandleFactory = std::make_shared<ChannelHandleFactory>();
 
@@ -599,6 +624,9 @@ void CoreServices::finalize() {
     // or samplers when PlayerManager was destroyed!
     PlayerInfo::destroy();
 
+    // Close all decoders that have been kept open for reuse
+    SoundSourceProxy::setSoundSourcePoolCapacity(0);
+
     // Delete the library after the view so there are no dangling pointers to
     // the data models.
     // Depends on RecordingManager and PlayerManager
@@ -637,6 +665,7 @@ void CoreServices::finalize() {
     m_uiControls.clear();
 
     m_pControlIndicatorTimer.reset();
+    m_pControlNotificationDispatcher.reset();
 
     t.elapsed(true);
 }
@@ -30,6 +30,7 @@ class LV2Backend;
 namespace mixxx {
 
 class ControlIndicatorTimer;
+class ControlNotificationDispatcher;
 class DbConnectionPool;
 class ScreensaverManager;
 
@@ -127,6 +128,7 @@ class CoreServices : public QObject {
 
     std::shared_ptr<SettingsManager> m_pSettingsManager;
     std::shared_ptr<mixxx::ControlIndicatorTimer> m_pControlIndicatorTimer;
+    std::shared_ptr<mixxx::ControlNotificationDispatcher> m_pControlNotificationDispatcher;
     std::shared_ptr<EffectsManager> m_pEffectsManager;
     // owned by EffectsManager
     LV2Backend* m_pLV2Backend;
@@ -47,6 +47,22 @@ EffectManifestPointer BitCrusherEffect::getManifest() {
     frequency->setNeutralPointOnScale(1.0);
     frequency->setRange(0.02, 1.0, 1.0);
 
+    EffectManifestParameterPointer oversampling = pManifest->addParameter();
+    oversampling->setId("oversampling");
+    oversampling->setName(QObject::tr("Oversampling"));
+    oversampling->setShortName(QObject::tr("OS"));
+    oversampling->setDescription(QObject::tr(
+            "Processes the audio at a multiple of the sample rate to reduce "
+            "aliasing.\n"
+            "Higher factors sound cleaner, but need more CPU and add a few "
+            "samples of latency."));
+    oversampling->setValueScaler(EffectManifestParameter::ValueScaler::Toggle);
+    oversampling->setRange(0, 0, 3);
+    oversampling->appendStep(qMakePair(QObject::tr("Off"), Oversampling::Off));
+    oversampling->appendStep(qMakePair(QObject::tr("2x"), Oversampling::TwoTimes));
+    oversampling->appendStep(qMakePair(QObject::tr("4x"), Oversampling::FourTimes));
+    oversampling->appendStep(qMakePair(QObject::tr("8x"), Oversampling::EightTimes));
+
     return pManifest;
 }
 
@@ -54,6 +70,27 @@ void BitCrusherEffect::loadEngineEffectParameters(
         const QMap<QString, EngineEffectParameterPointer>& parameters) {
     m_pBitDepthParameter = parameters.value("bit_depth");
     m_pDownsampleParameter = parameters.value("downsample");
+    m_pOversamplingParameter = parameters.value("oversampling");
+}
+
+int BitCrusherEffect::oversamplingFactor() const {
+    if (!m_pOversamplingParameter) {
+        return 1;
+    }
+    switch (m_pOversamplingParameter->toInt()) {
+    case TwoTimes:
+        return 2;
+    case FourTimes:
+        return 4;
+    case EightTimes:
+        return 8;
+    default:
+        return 1;
+    }
+}
+
+SINT BitCrusherEffect::getGroupDelayFrames() {
+    return EngineFilterOversampler::latencyFramesForFactor(oversamplingFactor());
 }
 
 void BitCrusherEffect::processChannel(
@@ -78,33 +115,45 @@ void BitCrusherEffect::processChannel(
     // rarely used, to achieve equal loudness and maximum dynamic
     const CSAMPLE gainCorrection = (17 - bit_depth) / 8;
 
-    for (SINT i = 0;
-            i < engineParameters.samplesPerBuffer();
-            i += engineParameters.channelCount()) {
-        pState->accumulator += downsample;
-
-        if (pState->accumulator >= 1.0) {
-            pState->accumulator -= 1.0f;
-            if (bit_depth < 16) {
-                pState->hold_l = floorf(SampleUtil::clampSample(
-                                                pInput[i] * gainCorrection) *
-                                                 scale +
-                                         0.5f) /
-                        scale / gainCorrection;
-                pState->hold_r = floorf(SampleUtil::clampSample(pInput[i + 1] *
-                                                gainCorrection) *
-                                                 scale +
-                                         0.5f) /
-                        scale / gainCorrection;
-            } else {
-                // Mixxx float has 24 bit depth, Audio CDs are 16 bit
-                // here we do not change the depth
-                pState->hold_l = pInput[i];
-                pState->hold_r = pInput[i + 1];
-            }
-        }
-
-        pOutput[i] = pState->hold_l;
-        pOutput[i + 1] = pState->hold_r;
-    }
+    // The sample and hold runs at the oversampled rate. Its steps create
+    // harmonics far above the Nyquist frequency of the engine rate, which
+    // are removed by the decimation filter instead of being folded back.
+    pState->oversampler.setFactor(oversamplingFactor());
+    const CSAMPLE downsamplePerFrame =
+            downsample / pState->oversampler.getFactor();
+
+    pState->oversampler.process(pInput,
+            pOutput,
+            engineParameters.samplesPerBuffer(),
+            [pState, downsamplePerFrame, bit_depth, scale, gainCorrection](
+                    CSAMPLE* pSamples, SINT numSamples) {
+                for (SINT i = 0; i < numSamples; i += mixxx::kEngineChannelCount) {
+                    pState->accumulator += downsamplePerFrame;
+
+                    if (pState->accumulator >= 1.0) {
+                        pState->accumulator -= 1.0f;
+                        if (bit_depth < 16) {
+                            pState->hold_l = floorf(SampleUtil::clampSample(
+                                                            pSamples[i] * gainCorrection) *
+                                                             scale +
+                                                     0.5f) /
+                                    scale / gainCorrection;
+                            pState->hold_r = floorf(SampleUtil::clampSample(
+                                                            pSamples[i + 1] *
+                                                            gainCorrection) *
+                                                             scale +
+                                                     0.5f) /
+                                    scale / gainCorrection;
+                        } else {
+                            // Mixxx float has 24 bit depth, Audio CDs are 16 bit
+                            // here we do not change the depth
+                            pState->hold_l = pSamples[i];
+                            pState->hold_r = pSamples[i + 1];
+                        }
+                    }
+
+                    pSamples[i] = pState->hold_l;
+                    pSamples[i + 1] = pState->hold_r;
+                }
+            });
 }
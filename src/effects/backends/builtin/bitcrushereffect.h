@@ -5,6 +5,7 @@
 #include "effects/backends/effectprocessor.h"
 #include "engine/effects/engineeffect.h"
 #include "engine/effects/engineeffectparameter.h"
+#include "engine/filters/enginefilteroversampler.h"
 #include "util/class.h"
 #include "util/types.h"
 
@@ -18,6 +19,7 @@ struct BitCrusherGroupState : public EffectState {
     }
     ~BitCrusherGroupState() override = default;
 
+    EngineFilterOversampler oversampler;
     CSAMPLE hold_l;
     CSAMPLE hold_r;
     // Accumulated fractions of a samplerate period.
@@ -43,13 +45,25 @@ class BitCrusherEffect : public EffectProcessorImpl<BitCrusherGroupState> {
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatureState) override;
 
+    SINT getGroupDelayFrames() override;
+
   private:
+    enum Oversampling {
+        Off = 0,
+        TwoTimes = 1,
+        FourTimes = 2,
+        EightTimes = 3,
+    };
+
+    int oversamplingFactor() const;
+
     QString debugString() const {
         return getId();
     }
 
     EngineEffectParameterPointer m_pBitDepthParameter;
     EngineEffectParameterPointer m_pDownsampleParameter;
+    EngineEffectParameterPointer m_pOversamplingParameter;
 
     DISALLOW_COPY_AND_ASSIGN(BitCrusherEffect);
 };
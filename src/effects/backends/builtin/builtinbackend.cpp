@@ -8,6 +8,7 @@
 #include "effects/backends/builtin/bessel8lvmixeqeffect.h"
 #include "effects/backends/builtin/biquadfullkilleqeffect.h"
 #include "effects/backends/builtin/bitcrushereffect.h"
+#include "effects/backends/builtin/compressoreffect.h"
 #include "effects/backends/builtin/filtereffect.h"
 #include "effects/backends/builtin/flangereffect.h"
 #include "effects/backends/builtin/graphiceqeffect.h"
@@ -41,6 +42,8 @@ BuiltInBackend::BuiltInBackend() {
     registerEffect<GraphicEQEffect>();
     registerEffect<ParametricEQEffect>();
     registerEffect<LoudnessContourEffect>();
+    // Dynamics
+    registerEffect<CompressorEffect>();
     // Fading Effects
     registerEffect<FilterEffect>();
     registerEffect<MoogLadder4FilterEffect>();
@@ -0,0 +1,187 @@
+#include "effects/backends/builtin/compressoreffect.h"
+
+#include "util/math.h"
+
+namespace {
+// The compressor processes larger buffers in chunks of this size
+constexpr SINT kMaxChunkFrames = 1024;
+constexpr double kMaxLookaheadMs = 10;
+} // anonymous namespace
+
+// static
+QString CompressorEffect::getId() {
+    return "org.mixxx.effects.compressor";
+}
+
+// static
+EffectManifestPointer CompressorEffect::getManifest() {
+    EffectManifestPointer pManifest(new EffectManifest());
+    pManifest->setId(getId());
+    pManifest->setName(QObject::tr("Multiband Compressor"));
+    pManifest->setShortName(QObject::tr("Compressor"));
+    pManifest->setAuthor("The Mixxx Team");
+    pManifest->setVersion("1.0");
+    pManifest->setDescription(QObject::tr(
+            "Reduces the dynamic range of the low, mid and high band "
+            "independently. The bands are split at the crossover frequencies "
+            "of the mixing EQs."));
+    pManifest->setEffectRampsFromDry(true);
+    pManifest->setMetaknobDefault(0.0);
+
+    EffectManifestParameterPointer threshold = pManifest->addParameter();
+    threshold->setId("threshold");
+    threshold->setName(QObject::tr("Threshold"));
+    threshold->setShortName(QObject::tr("Threshold"));
+    threshold->setDescription(QObject::tr(
+            "The level above which a band is compressed"));
+    threshold->setValueScaler(EffectManifestParameter::ValueScaler::LinearInverse);
+    threshold->setUnitsHint(EffectManifestParameter::UnitsHint::Decibel);
+    threshold->setDefaultLinkType(EffectManifestParameter::LinkType::Linked);
+    threshold->setNeutralPointOnScale(0);
+    threshold->setRange(-40, 0, 0);
+
+    EffectManifestParameterPointer ratio = pManifest->addParameter();
+    ratio->setId("ratio");
+    ratio->setName(QObject::tr("Ratio"));
+    ratio->setShortName(QObject::tr("Ratio"));
+    ratio->setDescription(QObject::tr(
+            "The amount of compression above the threshold.\n"
+            "A ratio of 4 reduces a level 4 dB above the threshold to 1 dB "
+            "above the threshold."));
+    ratio->setValueScaler(EffectManifestParameter::ValueScaler::Logarithmic);
+    ratio->setUnitsHint(EffectManifestParameter::UnitsHint::Coefficient);
+    ratio->setDefaultLinkType(EffectManifestParameter::LinkType::None);
+    ratio->setRange(1, 4, 20);
+
+    EffectManifestParameterPointer attack = pManifest->addParameter();
+    attack->setId("attack");
+    attack->setName(QObject::tr("Attack"));
+    attack->setShortName(QObject::tr("Attack"));
+    attack->setDescription(QObject::tr(
+            "The time until the compression follows a rising level"));
+    attack->setValueScaler(EffectManifestParameter::ValueScaler::Logarithmic);
+    attack->setUnitsHint(EffectManifestParameter::UnitsHint::Millisecond);
+    attack->setDefaultLinkType(EffectManifestParameter::LinkType::None);
+    attack->setRange(0.1, 10, 200);
+
+    EffectManifestParameterPointer release = pManifest->addParameter();
+    release->setId("release");
+    release->setName(QObject::tr("Release"));
+    release->setShortName(QObject::tr("Release"));
+    release->setDescription(QObject::tr(
+            "The time until the compression follows a falling level"));
+    release->setValueScaler(EffectManifestParameter::ValueScaler::Logarithmic);
+    release->setUnitsHint(EffectManifestParameter::UnitsHint::Millisecond);
+    release->setDefaultLinkType(EffectManifestParameter::LinkType::None);
+    release->setRange(10, 150, 2000);
+
+    EffectManifestParameterPointer lookahead = pManifest->addParameter();
+    lookahead->setId("lookahead");
+    lookahead->setName(QObject::tr("Look-ahead"));
+    lookahead->setShortName(QObject::tr("Look-ahead"));
+    lookahead->setDescription(QObject::tr(
+            "Delays the audio so the compression starts before a transient.\n"
+            "The delay is compensated on the other channels."));
+    lookahead->setValueScaler(EffectManifestParameter::ValueScaler::Linear);
+    lookahead->setUnitsHint(EffectManifestParameter::UnitsHint::Millisecond);
+    lookahead->setDefaultLinkType(EffectManifestParameter::LinkType::None);
+    lookahead->setRange(0, 0, kMaxLookaheadMs);
+
+    EffectManifestParameterPointer makeupGain = pManifest->addParameter();
+    makeupGain->setId("makeup_gain");
+    makeupGain->setName(QObject::tr("Makeup Gain"));
+    makeupGain->setShortName(QObject::tr("Gain"));
+    makeupGain->setDescription(QObject::tr(
+            "Amplifies the compressed signal"));
+    makeupGain->setValueScaler(EffectManifestParameter::ValueScaler::Linear);
+    makeupGain->setUnitsHint(EffectManifestParameter::UnitsHint::Decibel);
+    makeupGain->setDefaultLinkType(EffectManifestParameter::LinkType::None);
+    makeupGain->setRange(0, 0, 24);
+
+    return pManifest;
+}
+
+CompressorGroupState::CompressorGroupState(
+        const mixxx::EngineParameters& engineParameters)
+        : EffectState(engineParameters),
+          m_compressor(kMaxChunkFrames),
+          m_previousMakeupGain(CSAMPLE_GAIN_ONE) {
+    m_compressor.setSampleRate(engineParameters.sampleRate());
+}
+
+CompressorEffect::CompressorEffect()
+        : m_sampleRate(mixxx::audio::SampleRate(44100)) {
+    m_pLoFreqCorner = new ControlProxy("[Mixer Profile]", "LoEQFrequency");
+    m_pHiFreqCorner = new ControlProxy("[Mixer Profile]", "HiEQFrequency");
+}
+
+CompressorEffect::~CompressorEffect() {
+    delete m_pLoFreqCorner;
+    delete m_pHiFreqCorner;
+}
+
+void CompressorEffect::loadEngineEffectParameters(
+        const QMap<QString, EngineEffectParameterPointer>& parameters) {
+    m_pThreshold = parameters.value("threshold");
+    m_pRatio = parameters.value("ratio");
+    m_pAttack = parameters.value("attack");
+    m_pRelease = parameters.value("release");
+    m_pLookahead = parameters.value("lookahead");
+    m_pMakeupGain = parameters.value("makeup_gain");
+}
+
+SINT CompressorEffect::getGroupDelayFrames() {
+    if (!m_pLookahead) {
+        return 0;
+    }
+    return EngineMultiBandCompressor::lookaheadFramesForMs(
+            m_pLookahead->value(), m_sampleRate);
+}
+
+void CompressorEffect::processChannel(
+        CompressorGroupState* pState,
+        const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        const mixxx::EngineParameters& engineParameters,
+        const EffectEnableState enableState,
+        const GroupFeatureState& groupFeatures) {
+    Q_UNUSED(groupFeatures);
+
+    if (enableState == EffectEnableState::Enabling) {
+        // Don't output the look-ahead buffer from the last time the effect
+        // was enabled
+        pState->m_compressor.reset();
+    }
+
+    m_sampleRate = engineParameters.sampleRate();
+    EngineMultiBandCompressor* pCompressor = &pState->m_compressor;
+    pCompressor->setSampleRate(engineParameters.sampleRate());
+    const double loFreq = m_pLoFreqCorner->get();
+    const double hiFreq = m_pHiFreqCorner->get();
+    if (loFreq > 0 && loFreq < hiFreq) {
+        pCompressor->setCrossoverFrequencies(loFreq, hiFreq);
+    }
+    pCompressor->setAttackMs(m_pAttack->value());
+    pCompressor->setReleaseMs(m_pRelease->value());
+    pCompressor->setLookaheadMs(m_pLookahead->value());
+
+    const EngineMultiBandCompressor::BandParameters parameters{
+            static_cast<CSAMPLE>(db2ratio(m_pThreshold->value())),
+            static_cast<CSAMPLE>(m_pRatio->value()),
+            CSAMPLE_GAIN_ZERO};
+    for (int band = 0; band < EngineMultiBandCompressor::kNumBands; ++band) {
+        pCompressor->setBandParameters(band, parameters);
+    }
+
+    const SINT numSamples = engineParameters.samplesPerBuffer();
+    pCompressor->process(pInput, pOutput, numSamples);
+
+    const auto makeupGain = static_cast<CSAMPLE_GAIN>(db2ratio(m_pMakeupGain->value()));
+    if (makeupGain != CSAMPLE_GAIN_ONE || pState->m_previousMakeupGain != CSAMPLE_GAIN_ONE) {
+        SampleUtil::applyRampingGain(pOutput,
+                pState->m_previousMakeupGain,
+                makeupGain,
+                numSamples);
+    }
+    pState->m_previousMakeupGain = makeupGain;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "control/controlproxy.h"
+#include "effects/backends/effectprocessor.h"
+#include "engine/effects/engineeffect.h"
+#include "engine/effects/engineeffectparameter.h"
+#include "engine/enginemultibandcompressor.h"
+#include "util/class.h"
+#include "util/defs.h"
+#include "util/sample.h"
+#include "util/types.h"
+
+class CompressorGroupState : public EffectState {
+  public:
+    CompressorGroupState(const mixxx::EngineParameters& engineParameters);
+    ~CompressorGroupState() override = default;
+
+    EngineMultiBandCompressor m_compressor;
+    CSAMPLE_GAIN m_previousMakeupGain;
+};
+
+/// A 3-band compressor that splits the bands at the crossover frequencies
+/// of the mixing EQs.
+class CompressorEffect : public EffectProcessorImpl<CompressorGroupState> {
+  public:
+    CompressorEffect();
+    ~CompressorEffect() override;
+
+    static QString getId();
+    static EffectManifestPointer getManifest();
+
+    void loadEngineEffectParameters(
+            const QMap<QString, EngineEffectParameterPointer>& parameters) override;
+
+    void processChannel(
+            CompressorGroupState* pState,
+            const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            const mixxx::EngineParameters& engineParameters,
+            const EffectEnableState enableState,
+            const GroupFeatureState& groupFeatures) override;
+
+    SINT getGroupDelayFrames() override;
+
+  private:
+    QString debugString() const {
+        return getId();
+    }
+
+    EngineEffectParameterPointer m_pThreshold;
+    EngineEffectParameterPointer m_pRatio;
+    EngineEffectParameterPointer m_pAttack;
+    EngineEffectParameterPointer m_pRelease;
+    EngineEffectParameterPointer m_pLookahead;
+    EngineEffectParameterPointer m_pMakeupGain;
+
+    ControlProxy* m_pLoFreqCorner;
+    ControlProxy* m_pHiFreqCorner;
+
+    // The sample rate of the last processed buffer for the group delay
+    mixxx::audio::SampleRate m_sampleRate;
+
+    DISALLOW_COPY_AND_ASSIGN(CompressorEffect);
+};
@@ -48,6 +48,22 @@ EffectManifestPointer DistortionEffect::getManifest() {
     drive->setNeutralPointOnScale(0);
     drive->setRange(0, 0, 1);
 
+    EffectManifestParameterPointer oversampling = pManifest->addParameter();
+    oversampling->setId("oversampling");
+    oversampling->setName(QObject::tr("Oversampling"));
+    oversampling->setShortName(QObject::tr("OS"));
+    oversampling->setDescription(QObject::tr(
+            "Processes the audio at a multiple of the sample rate to reduce "
+            "aliasing.\n"
+            "Higher factors sound cleaner, but need more CPU and add a few "
+            "samples of latency."));
+    oversampling->setValueScaler(EffectManifestParameter::ValueScaler::Toggle);
+    oversampling->setRange(0, 0, 3);
+    oversampling->appendStep(qMakePair(QObject::tr("Off"), Oversampling::Off));
+    oversampling->appendStep(qMakePair(QObject::tr("2x"), Oversampling::TwoTimes));
+    oversampling->appendStep(qMakePair(QObject::tr("4x"), Oversampling::FourTimes));
+    oversampling->appendStep(qMakePair(QObject::tr("8x"), Oversampling::EightTimes));
+
     return pManifest;
 }
 
@@ -59,7 +75,9 @@ DistortionGroupState::DistortionGroupState(
           m_samplerate(engineParameters.sampleRate()),
           m_previousMakeUpGain(1),
           m_previousNormalizationGain(1) {
+    audioParametersChanged(engineParameters);
 }
+
 struct DistortionEffect::SoftClippingParameters {
     static constexpr const CSAMPLE normalizationLevel = 0.2f;
     static constexpr const CSAMPLE crossfadeEndParam = 0.2f;
@@ -84,6 +102,27 @@ void DistortionEffect::loadEngineEffectParameters(
         const QMap<QString, EngineEffectParameterPointer>& parameters) {
     m_pMode = parameters.value("mode");
     m_pDrive = parameters.value("drive");
+    m_pOversampling = parameters.value("oversampling");
+}
+
+int DistortionEffect::oversamplingFactor() const {
+    if (!m_pOversampling) {
+        return 1;
+    }
+    switch (m_pOversampling->toInt()) {
+    case TwoTimes:
+        return 2;
+    case FourTimes:
+        return 4;
+    case EightTimes:
+        return 8;
+    default:
+        return 1;
+    }
+}
+
+SINT DistortionEffect::getGroupDelayFrames() {
+    return EngineFilterOversampler::latencyFramesForFactor(oversamplingFactor());
 }
 
 void DistortionEffect::processChannel(
@@ -96,30 +135,40 @@ void DistortionEffect::processChannel(
     Q_UNUSED(groupFeatures);
     Q_UNUSED(enableState);
 
-    // TODO: anti-aliasing
-
     SINT numSamples = engineParameters.samplesPerBuffer();
     CSAMPLE driveParam = static_cast<CSAMPLE>(m_pDrive->value());
 
-    if (driveParam < 0.01) {
+    // The effect reports the latency of the oversampler as its group delay,
+    // so the dry signal needs the same delay in every code path.
+    pState->m_oversampler.setFactor(oversamplingFactor());
+    pState->m_dryDelay.setDelay(static_cast<unsigned int>(
+            pState->m_oversampler.getLatencyFrames() * mixxx::kEngineChannelCount));
+    VERIFY_OR_DEBUG_ASSERT(pState->m_dryBuffer.size() >= numSamples) {
         SampleUtil::copy(pOutput, pInput, numSamples);
         return;
     }
+    CSAMPLE* pDry = pState->m_dryBuffer.data();
+    pState->m_dryDelay.process(pInput, pDry, static_cast<int>(numSamples));
+
+    if (driveParam < 0.01) {
+        SampleUtil::copy(pOutput, pDry, numSamples);
+        return;
+    }
 
     switch (m_pMode->toInt()) {
     case SoftClipping:
         processDistortion<SoftClippingParameters>(
-                driveParam, pState, pOutput, pInput, engineParameters);
+                driveParam, pState, pOutput, pInput, pDry, engineParameters);
         break;
 
     case HardClipping:
         processDistortion<HardClippingParameters>(
-                driveParam, pState, pOutput, pInput, engineParameters);
+                driveParam, pState, pOutput, pInput, pDry, engineParameters);
         break;
 
     default:
         // We should never enter here, but we act as a noop effect just in case.
-        SampleUtil::copy(pOutput, pInput, numSamples);
+        SampleUtil::copy(pOutput, pDry, numSamples);
         return;
     }
 }
@@ -3,9 +3,12 @@
 #include "effects/backends/effectprocessor.h"
 #include "engine/effects/engineeffect.h"
 #include "engine/effects/engineeffectparameter.h"
+#include "engine/filters/enginefilterdelay.h"
+#include "engine/filters/enginefilteroversampler.h"
 #include "util/class.h"
 #include "util/defs.h"
 #include "util/sample.h"
+#include "util/samplebuffer.h"
 #include "util/types.h"
 
 class DistortionGroupState : public EffectState {
@@ -13,6 +16,18 @@ class DistortionGroupState : public EffectState {
     DistortionGroupState(const mixxx::EngineParameters& engineParameters);
     ~DistortionGroupState() override = default;
 
+    void audioParametersChanged(const mixxx::EngineParameters& engineParameters) {
+        m_dryBuffer = mixxx::SampleBuffer(engineParameters.samplesPerBuffer());
+    }
+
+    // Large enough for the latency of the 8x oversampler
+    static constexpr unsigned int kDryDelaySize = 64;
+
+    EngineFilterOversampler m_oversampler;
+    // Aligns the dry signal with the latency of the oversampler
+    EngineFilterDelay<kDryDelaySize> m_dryDelay;
+    mixxx::SampleBuffer m_dryBuffer;
+
     CSAMPLE_GAIN m_driveGain;
     CSAMPLE m_crossfadeParameter;
     double m_samplerate;
@@ -40,12 +55,23 @@ class DistortionEffect : public EffectProcessorImpl<DistortionGroupState> {
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatures) override;
 
+    SINT getGroupDelayFrames() override;
+
   private:
     enum Mode {
         SoftClipping = 0,
         HardClipping = 1,
     };
 
+    enum Oversampling {
+        Off = 0,
+        TwoTimes = 1,
+        FourTimes = 2,
+        EightTimes = 3,
+    };
+
+    int oversamplingFactor() const;
+
     struct SoftClippingParameters;
     struct HardClippingParameters;
 
@@ -54,6 +80,7 @@ class DistortionEffect : public EffectProcessorImpl<DistortionGroupState> {
             DistortionGroupState* pState,
             CSAMPLE* pOutput,
             const CSAMPLE* pInput,
+            const CSAMPLE* pDry,
             const mixxx::EngineParameters& engineParameters) {
         SINT numSamples = engineParameters.samplesPerBuffer();
 
@@ -70,17 +97,20 @@ class DistortionEffect : public EffectProcessorImpl<DistortionGroupState> {
         SampleUtil::copyWithRampingGain(
                 pOutput, pInput, pState->m_driveGain, driveGain, numSamples);
 
-        // Waveshape
-        for (SINT i = 0;
-                i < engineParameters.samplesPerBuffer();
-                i += engineParameters.channelCount()) {
-            for (int channel = 0; channel < engineParameters.channelCount(); ++channel) {
-                pOutput[i + channel] = ModeParams::process(pOutput[i + channel]);
-            }
-        }
+        // Waveshape at the oversampled rate, so that the harmonics above
+        // the Nyquist frequency are removed instead of being folded back
+        pState->m_oversampler.process(pOutput,
+                pOutput,
+                numSamples,
+                [](CSAMPLE* pSamples, SINT numOversampledSamples) {
+                    // note: LOOP VECTORIZED.
+                    for (SINT i = 0; i < numOversampledSamples; ++i) {
+                        pSamples[i] = ModeParams::process(pSamples[i]);
+                    }
+                });
 
         // Volume compensation
-        CSAMPLE pInputRMS = SampleUtil::rms(pInput, numSamples);
+        CSAMPLE pInputRMS = SampleUtil::rms(pDry, numSamples);
         CSAMPLE pOutputRMS = SampleUtil::rms(pOutput, numSamples);
         CSAMPLE_GAIN gain = pOutputRMS == CSAMPLE_ZERO
                 ? 1
@@ -100,7 +130,7 @@ class DistortionEffect : public EffectProcessorImpl<DistortionGroupState> {
                 crossfadeParam,
                 numSamples);
         SampleUtil::addWithRampingGain(pOutput,
-                pInput,
+                pDry,
                 1 - pState->m_crossfadeParameter,
                 1 - crossfadeParam,
                 numSamples);
@@ -115,6 +145,7 @@ class DistortionEffect : public EffectProcessorImpl<DistortionGroupState> {
 
     EngineEffectParameterPointer m_pMode;
     EngineEffectParameterPointer m_pDrive;
+    EngineEffectParameterPointer m_pOversampling;
 
     DISALLOW_COPY_AND_ASSIGN(DistortionEffect);
 };
@@ -14,12 +14,14 @@ static const QString kFormantPreservingParameterId = QStringLiteral("formantPres
 } // anonymous namespace
 
 PitchShiftEffect::PitchShiftEffect()
-        : m_currentFormant(false) {
+        : m_currentFormant(false),
+          m_groupDelayFrames(0) {
 }
 
 PitchShiftGroupState::PitchShiftGroupState(
         const mixxx::EngineParameters& engineParameters)
-        : EffectState(engineParameters) {
+        : EffectState(engineParameters),
+          m_paddingFrames(0) {
     initializeBuffer(engineParameters);
     audioParametersChanged(engineParameters);
 }
@@ -48,6 +50,7 @@ void PitchShiftGroupState::audioParametersChanged(
     // RubberBand::RubberBandStretcher::process call.
     m_pRubberBand->setMaxProcessSize(engineParameters.framesPerBuffer());
     m_pRubberBand->setTimeRatio(1.0);
+    m_paddingFrames = 0;
 };
 
 // static
@@ -237,8 +240,19 @@ void PitchShiftEffect::processChannel(
             pState->m_retrieveBuffer,
             framesToRead);
 
-    SampleUtil::interleaveBuffer(pOutput,
+    // Pad missing frames with silence at the beginning of the buffer, so
+    // the output is a continuous stream with a known delay
+    const SINT paddingFrames = engineParameters.framesPerBuffer() - receivedFrames;
+    SampleUtil::clear(pOutput, paddingFrames * engineParameters.channelCount());
+    SampleUtil::interleaveBuffer(
+            pOutput + paddingFrames * engineParameters.channelCount(),
             pState->m_retrieveBuffer[0],
             pState->m_retrieveBuffer[1],
             receivedFrames);
+    pState->m_paddingFrames += paddingFrames;
+
+    // Report the delay for the latency compensation of the effect chain
+    // and of the other channels
+    m_groupDelayFrames = static_cast<SINT>(pState->m_pRubberBand->getLatency()) +
+            pState->m_paddingFrames;
 }
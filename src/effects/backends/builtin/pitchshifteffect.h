@@ -27,6 +27,9 @@ class PitchShiftGroupState : public EffectState {
 
     std::unique_ptr<RubberBand::RubberBandStretcher> m_pRubberBand;
     CSAMPLE* m_retrieveBuffer[2];
+    // The number of silent frames that were output while Rubber Band
+    // had not enough frames available
+    SINT m_paddingFrames;
 };
 
 class PitchShiftEffect final : public EffectProcessorImpl<PitchShiftGroupState> {
@@ -48,12 +51,18 @@ class PitchShiftEffect final : public EffectProcessorImpl<PitchShiftGroupState>
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatures) override;
 
+    SINT getGroupDelayFrames() override {
+        return m_groupDelayFrames;
+    }
+
   private:
     QString debugString() const {
         return getId();
     }
 
     bool m_currentFormant;
+    // The group delay of the last processed channel
+    SINT m_groupDelayFrames;
     EngineEffectParameterPointer m_pPitchParameter;
     EngineEffectParameterPointer m_pRangeParameter;
     EngineEffectParameterPointer m_pSemitonesModeParameter;
@@ -39,6 +39,10 @@ EffectsManager::EffectsManager(
     m_pMessenger = EffectsMessengerPointer(new EffectsMessenger(
             std::move(pRequestPipe)));
     m_pEngineEffectsManager = std::make_unique<EngineEffectsManager>(std::move(pResponsePipe));
+    // Opt-in: Process the effect chains of independent channels on additional
+    // real-time threads. 0 keeps all effects processing on the audio thread.
+    m_pEngineEffectsManager->setParallelProcessingThreads(
+            m_pConfig->getValue(ConfigKey("[Effects]", "ParallelProcessingThreads"), 0));
 
     m_pEffectPresetManager = EffectPresetManagerPointer(
             new EffectPresetManager(pConfig, m_pBackendManager));
@@ -9,10 +9,13 @@
 #include "moc_cachingreaderworker.cpp"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
+#include "util/cmdlineargs.h"
 #include "util/compatibility/qmutex.h"
 #include "util/event.h"
 #include "util/logger.h"
 #include "util/span.h"
+#include "util/stat.h"
+#include "util/timer.h"
 
 namespace {
 
@@ -150,6 +153,25 @@ void CachingReaderWorker::closeAudioSource() {
     discardAllPendingRequests();
 
     if (m_pAudioSource) {
+        const auto copyStats = m_pAudioSource->getCopyStats();
+        if (copyStats.readFrameCount > 0) {
+            kLogger.debug()
+                    << "Copied"
+                    << copyStats.copiedBytesPerFrame()
+                    << "bytes per decoded frame while reading"
+                    << copyStats.readFrameCount
+                    << "frames from"
+                    << m_pAudioSource->getUrlString();
+            if (CmdlineArgs::Instance().getDeveloper()) {
+                Stat::track(QStringLiteral("CachingReaderWorker copied bytes per frame ") +
+                                QFileInfo(m_pAudioSource->getLocalFileName())
+                                        .suffix()
+                                        .toLower(),
+                        Stat::UNSPECIFIED,
+                        kDefaultComputeFlags,
+                        copyStats.copiedBytesPerFrame());
+            }
+        }
         // Closes open file handles of the old track.
         m_pAudioSource->close();
         m_pAudioSource.reset();
@@ -189,6 +211,8 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
 
     mixxx::AudioSource::OpenParams config;
     config.setChannelCount(CachingReaderChunk::kChannels);
+    // Decks seek frequently, e.g. for hotcues, loops, and scratching
+    config.setAccessPattern(mixxx::AudioSource::AccessPattern::Random);
     m_pAudioSource = SoundSourceProxy(pTrack).openAudioSource(config);
     if (!m_pAudioSource) {
         kLogger.warning()
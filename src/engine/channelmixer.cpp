@@ -23,30 +23,28 @@ void ChannelMixer::applyEffectsAndMixChannels(const EngineMaster::GainCalculator
     // The original channel input buffers are not modified.
     SampleUtil::clear(pOutput, iBufferSize);
     ScopedTimer t("EngineMaster::applyEffectsAndMixChannels");
-    for (auto* pChannelInfo : activeChannels) {
-        EngineMaster::GainCache& gainCache = (*channelGainCache)[pChannelInfo->m_index];
-        CSAMPLE_GAIN oldGain = gainCache.m_gain;
-        CSAMPLE_GAIN newGain;
-        bool fadeout = gainCache.m_fadeout ||
-                (pChannelInfo->m_pChannel &&
-                        !pChannelInfo->m_pChannel->isActive());
-        if (fadeout) {
-            newGain = 0;
-            gainCache.m_fadeout = false;
-        } else {
-            newGain = gainCalculator.getGain(pChannelInfo);
-        }
-        gainCache.m_gain = newGain;
-        pEngineEffectsManager->processPostFaderAndMix(pChannelInfo->m_handle,
+    QVarLengthArray<EngineEffectsManager::PostFaderChannel, kPreallocatedChannels> channels;
+    calculateGains(gainCalculator, activeChannels, channelGainCache, &channels);
+    if (pEngineEffectsManager->processPostFaderChannelsInParallel(outputHandle,
+                channels.constData(),
+                channels.size(),
+                pOutput,
+                false,
+                iBufferSize,
+                iSampleRate)) {
+        return;
+    }
+    for (const auto& channel : std::as_const(channels)) {
+        pEngineEffectsManager->processPostFaderAndMix(channel.inputHandle,
                 outputHandle,
-                pChannelInfo->m_pBuffer,
+                channel.pBuffer,
                 pOutput,
                 iBufferSize,
                 iSampleRate,
-                pChannelInfo->m_features,
-                oldGain,
-                newGain,
-                fadeout);
+                *channel.pGroupFeatures,
+                channel.oldGain,
+                channel.newGain,
+                channel.fadeout);
     }
 }
 
@@ -69,6 +67,40 @@ void ChannelMixer::applyEffectsInPlaceAndMixChannels(
     // 4. Mix the channel buffers together to make pOutput, overwriting the pOutput buffer from the last engine callback
     ScopedTimer t("EngineMaster::applyEffectsInPlaceAndMixChannels");
     SampleUtil::clear(pOutput, iBufferSize);
+    QVarLengthArray<EngineEffectsManager::PostFaderChannel, kPreallocatedChannels> channels;
+    calculateGains(gainCalculator, activeChannels, channelGainCache, &channels);
+    if (pEngineEffectsManager->processPostFaderChannelsInParallel(outputHandle,
+                channels.constData(),
+                channels.size(),
+                pOutput,
+                true,
+                iBufferSize,
+                iSampleRate)) {
+        return;
+    }
+    for (const auto& channel : std::as_const(channels)) {
+        pEngineEffectsManager->processPostFaderChannelInPlace(channel.inputHandle,
+                outputHandle,
+                channel.pBuffer,
+                iBufferSize,
+                iSampleRate,
+                *channel.pGroupFeatures,
+                channel.oldGain,
+                channel.newGain,
+                channel.fadeout);
+        SampleUtil::add(pOutput, channel.pBuffer, iBufferSize);
+    }
+}
+
+// static
+void ChannelMixer::calculateGains(
+        const EngineMaster::GainCalculator& gainCalculator,
+        const QVarLengthArray<EngineMaster::ChannelInfo*, kPreallocatedChannels>&
+                activeChannels,
+        QVarLengthArray<EngineMaster::GainCache, kPreallocatedChannels>*
+                channelGainCache,
+        QVarLengthArray<EngineEffectsManager::PostFaderChannel, kPreallocatedChannels>*
+                pChannels) {
     for (auto* pChannelInfo : activeChannels) {
         EngineMaster::GainCache& gainCache = (*channelGainCache)[pChannelInfo->m_index];
         CSAMPLE_GAIN oldGain = gainCache.m_gain;
@@ -83,15 +115,12 @@ void ChannelMixer::applyEffectsInPlaceAndMixChannels(
             newGain = gainCalculator.getGain(pChannelInfo);
         }
         gainCache.m_gain = newGain;
-        pEngineEffectsManager->processPostFaderInPlace(pChannelInfo->m_handle,
-                outputHandle,
+        pChannels->append(EngineEffectsManager::PostFaderChannel{
+                pChannelInfo->m_handle,
                 pChannelInfo->m_pBuffer,
-                iBufferSize,
-                iSampleRate,
-                pChannelInfo->m_features,
+                &pChannelInfo->m_features,
                 oldGain,
                 newGain,
-                fadeout);
-        SampleUtil::add(pOutput, pChannelInfo->m_pBuffer, iBufferSize);
+                fadeout});
     }
 }
@@ -34,4 +34,17 @@ class ChannelMixer {
             unsigned int iBufferSize,
             unsigned int iSampleRate,
             EngineEffectsManager* pEngineEffectsManager);
+
+  private:
+    // Calculates the gain of each channel for this callback and updates
+    // channelGainCache. The channels are processed by EngineEffectsManager
+    // afterwards, either in parallel or one after another.
+    static void calculateGains(
+            const EngineMaster::GainCalculator& gainCalculator,
+            const QVarLengthArray<EngineMaster::ChannelInfo*,
+                    kPreallocatedChannels>& activeChannels,
+            QVarLengthArray<EngineMaster::GainCache, kPreallocatedChannels>*
+                    channelGainCache,
+            QVarLengthArray<EngineEffectsManager::PostFaderChannel,
+                    kPreallocatedChannels>* pChannels);
 };
@@ -210,6 +210,7 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
     CSAMPLE lastCallbackMixKnob = channelStatus.oldMixKnob;
 
     bool processingOccured = false;
+    channelStatus.latencyFrames = 0;
     if (effectiveChainEnableState != EffectEnableState::Disabled) {
         // Ramping code inside the effects need to access the original samples
         // after writing to the output buffer. This requires not to use the same buffer
@@ -273,6 +274,7 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         m_effectsDelay.process(pIn, numSamples);
 
         if (processingOccured) {
+            channelStatus.latencyFrames = effectChainGroupDelayFrames;
             // pIntermediateInput is the output of the last processed effect. It would be the
             // intermediate input of the next effect if there was one.
             if (m_mixMode == EffectChainMixMode::DrySlashWet) {
@@ -318,11 +320,60 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         channelStatus.enableState = EffectEnableState::Enabling;
     }
 
+    advanceEnableState();
+
+    return processingOccured;
+}
+
+bool EngineEffectChain::isActiveForChannel(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle) const {
+    // Use const lookups to not expand the matrix, this might be called
+    // concurrently for different chains.
+    if (!inputHandle.valid() ||
+            inputHandle.handle() >= m_chainStatusForChannelMatrix.size()) {
+        return false;
+    }
+    const ChannelHandleMap<ChannelStatus>& outputMap =
+            m_chainStatusForChannelMatrix.at(inputHandle);
+    if (!outputHandle.valid() || outputHandle.handle() >= outputMap.size()) {
+        return false;
+    }
+    return outputMap.at(outputHandle).enableState != EffectEnableState::Disabled;
+}
+
+void EngineEffectChain::processInactiveChannel(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle,
+        bool advanceChainEnableState) {
+    // This mirrors process() for a channel that is fully disabled: No effect
+    // is processed and the channel state stays disabled, even with fadeout.
+    ChannelStatus& channelStatus = m_chainStatusForChannelMatrix[inputHandle][outputHandle];
+    DEBUG_ASSERT(channelStatus.enableState == EffectEnableState::Disabled);
+    channelStatus.oldMixKnob = m_dMix;
+    channelStatus.latencyFrames = 0;
+
+    if (advanceChainEnableState) {
+        advanceEnableState();
+    }
+}
+
+SINT EngineEffectChain::getLatencyFrames(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle) const {
+    if (!inputHandle.valid() ||
+            inputHandle.handle() >= m_chainStatusForChannelMatrix.size()) {
+        return 0;
+    }
+    const ChannelHandleMap<ChannelStatus>& outputMap =
+            m_chainStatusForChannelMatrix.at(inputHandle);
+    if (!outputHandle.valid() || outputHandle.handle() >= outputMap.size()) {
+        return 0;
+    }
+    return outputMap.at(outputHandle).latencyFrames;
+}
+
+void EngineEffectChain::advanceEnableState() {
     if (m_enableState == EffectEnableState::Disabling) {
         m_enableState = EffectEnableState::Disabled;
     } else if (m_enableState == EffectEnableState::Enabling) {
         m_enableState = EffectEnableState::Enabled;
     }
-
-    return processingOccured;
 }
@@ -46,14 +46,40 @@ class EngineEffectChain final : public EffectsRequestHandler {
             const GroupFeatureState& groupFeatures,
             bool fadeout);
 
+    /// called from audio thread
+    /// Returns false if process() would not touch any of the chain's buffers
+    /// or effects for this combination of input and output channel, i.e. if
+    /// the chain is fully disabled for the input channel.
+    bool isActiveForChannel(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle) const;
+
+    /// called from audio thread
+    /// Performs the bookkeeping of process() for a combination of input and
+    /// output channel for which isActiveForChannel() returned false. The
+    /// chain's own enable state is only advanced if advanceChainEnableState
+    /// is set, which must be done only if this is the first time the chain
+    /// is processed during the current callback.
+    void processInactiveChannel(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle,
+            bool advanceChainEnableState);
+
+    /// called from audio thread
+    /// Returns the number of frames by which the last call of process() has
+    /// delayed the signal of the input channel, i.e. the sum of the group
+    /// delays of the processed effects. 0 if no effect was processed.
+    SINT getLatencyFrames(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle) const;
+
   private:
     struct ChannelStatus {
         ChannelStatus()
                 : oldMixKnob(0),
-                  enableState(EffectEnableState::Disabled) {
+                  enableState(EffectEnableState::Disabled),
+                  latencyFrames(0) {
         }
         CSAMPLE oldMixKnob;
         EffectEnableState enableState;
+        SINT latencyFrames;
     };
 
     QString debugString() const {
@@ -65,6 +91,7 @@ class EngineEffectChain final : public EffectsRequestHandler {
     bool removeEffect(EngineEffect* pEffect, int iIndex);
     bool enableForInputChannel(ChannelHandle inputHandle);
     bool disableForInputChannel(ChannelHandle inputHandle);
+    void advanceEnableState();
 
     QString m_group;
     EffectEnableState m_enableState;
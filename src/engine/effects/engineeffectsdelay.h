@@ -9,8 +9,6 @@
 namespace {
 static constexpr int kMaxDelayFrames =
         mixxx::audio::SampleRate::kValueMax - 1;
-static constexpr int kDelayBufferSize =
-        mixxx::audio::SampleRate::kValueMax * mixxx::kEngineChannelCount;
 } // anonymous namespace
 
 /// The effect can produce the output signal with a specific delay caused
@@ -30,7 +28,10 @@ static constexpr int kDelayBufferSize =
 /// and non-delayed) can be mixed and used together.
 class EngineEffectsDelay final : public EngineObject {
   public:
-    EngineEffectsDelay();
+    /// The memory of the delay buffer is allocated up front for the
+    /// maximum delay, so a smaller maximum saves memory if the delay
+    /// is known to be bounded.
+    explicit EngineEffectsDelay(SINT maxDelayFrames = kMaxDelayFrames);
 
     ~EngineEffectsDelay() override;
 
@@ -48,6 +49,9 @@ class EngineEffectsDelay final : public EngineObject {
         VERIFY_OR_DEBUG_ASSERT(delayFrames <= kMaxDelayFrames) {
             delayFrames = kMaxDelayFrames;
         }
+        VERIFY_OR_DEBUG_ASSERT(delayFrames <= m_maxDelayFrames) {
+            delayFrames = m_maxDelayFrames;
+        }
 
         // Delay is reported from the effect chain by a number of frames
         // to aware problems with a number of channels. The inner
@@ -56,6 +60,23 @@ class EngineEffectsDelay final : public EngineObject {
         m_currentDelaySamples = delayFrames * mixxx::kEngineChannelCount;
     }
 
+    SINT getDelayFrames() const {
+        return m_currentDelaySamples / mixxx::kEngineChannelCount;
+    }
+
+    SINT getMaxDelayFrames() const {
+        return m_maxDelayFrames;
+    }
+
+    /// Returns true if the next call of EngineEffectsDelay::process still
+    /// delays the signal or crossfades from a previous delay.
+    bool isDelaying() const {
+        return m_currentDelaySamples != 0 || m_prevDelaySamples != 0;
+    }
+
+    /// Forgets the delayed signal and resets the delay to zero.
+    void clear();
+
     /// The method delays the input buffer by the set number of samples
     /// and returns the result in the output buffer. The input buffer
     /// is not changed. For zero delay the input buffer is copied into
@@ -74,6 +95,8 @@ class EngineEffectsDelay final : public EngineObject {
     void process(CSAMPLE* pInOut, const int iBufferSize) override;
 
   private:
+    const SINT m_maxDelayFrames;
+    const SINT m_delayBufferSize;
     SINT m_currentDelaySamples;
     SINT m_prevDelaySamples;
     SINT m_delayBufferWritePos;
@@ -0,0 +1,140 @@
+#include "engine/effects/engineeffectslatencycompensator.h"
+
+#include <QtDebug>
+
+#include "util/math.h"
+
+EngineEffectsLatencyCompensator::EngineEffectsLatencyCompensator()
+        : m_warnedExhausted(false) {
+    m_delayLines.reserve(kMaxCompensatedPaths);
+    for (int i = 0; i < kMaxCompensatedPaths; ++i) {
+        m_delayLines.emplace_back(kMaxCompensationFrames);
+    }
+}
+
+EngineEffectsLatencyCompensator::~EngineEffectsLatencyCompensator() = default;
+
+void EngineEffectsLatencyCompensator::onCallbackStart() {
+    for (auto&& outputLatency : m_outputLatencies) {
+        outputLatency.latencyFrames = outputLatency.nextLatencyFrames;
+        outputLatency.nextLatencyFrames = 0;
+    }
+    // A path that was not processed during the last callback has been
+    // inactive. Its delayed signal is outdated when it is back.
+    for (int i = 0; i < kMaxCompensatedPaths; ++i) {
+        DelayLine& delayLine = m_delayLines[i];
+        if (delayLine.inputHandle.valid() && !delayLine.processed) {
+            releaseDelayLine(i);
+        }
+        delayLine.processed = false;
+    }
+}
+
+void EngineEffectsLatencyCompensator::process(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle,
+        SINT latencyFrames,
+        CSAMPLE* pInOut,
+        unsigned int numSamples) {
+    VERIFY_OR_DEBUG_ASSERT(latencyFrames >= 0) {
+        latencyFrames = 0;
+    }
+    VERIFY_OR_DEBUG_ASSERT(outputHandle.valid() &&
+            outputHandle.handle() < kMaxOutputChannels) {
+        return;
+    }
+    OutputLatency& outputLatency = m_outputLatencies[outputHandle.handle()];
+    outputLatency.nextLatencyFrames = math_max(
+            outputLatency.nextLatencyFrames, latencyFrames);
+
+    const SINT delayFrames = compensationFrames(outputHandle, latencyFrames);
+    int index = delayLineIndex(inputHandle, outputHandle);
+    if (index < 0) {
+        if (delayFrames == 0) {
+            // This is the common case without any latent effect
+            return;
+        }
+        index = acquireDelayLine(inputHandle, outputHandle);
+        if (index < 0) {
+            if (!m_warnedExhausted) {
+                qWarning() << "EngineEffectsLatencyCompensator: More than"
+                           << kMaxCompensatedPaths
+                           << "channels need to be delayed, the latency of "
+                              "the remaining channels is not compensated";
+                m_warnedExhausted = true;
+            }
+            return;
+        }
+    }
+
+    DelayLine& delayLine = m_delayLines[index];
+    delayLine.processed = true;
+    delayLine.pDelay->setDelayFrames(delayFrames);
+    delayLine.pDelay->process(pInOut, static_cast<int>(numSamples));
+    if (!delayLine.pDelay->isDelaying()) {
+        // The crossfade back to zero delay is done
+        releaseDelayLine(index);
+    }
+}
+
+bool EngineEffectsLatencyCompensator::isDelaying(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle,
+        SINT latencyFrames) const {
+    return compensationFrames(outputHandle, latencyFrames) > 0 ||
+            delayLineIndex(inputHandle, outputHandle) >= 0;
+}
+
+SINT EngineEffectsLatencyCompensator::getOutputLatencyFrames(
+        const ChannelHandle& outputHandle) const {
+    if (!outputHandle.valid() || outputHandle.handle() >= kMaxOutputChannels) {
+        return 0;
+    }
+    return m_outputLatencies[outputHandle.handle()].latencyFrames;
+}
+
+SINT EngineEffectsLatencyCompensator::compensationFrames(
+        const ChannelHandle& outputHandle,
+        SINT latencyFrames) const {
+    return math_clamp(getOutputLatencyFrames(outputHandle) - latencyFrames,
+            static_cast<SINT>(0),
+            kMaxCompensationFrames);
+}
+
+int EngineEffectsLatencyCompensator::delayLineIndex(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle) const {
+    // Free delay lines have invalid handles
+    if (!inputHandle.valid()) {
+        return -1;
+    }
+    // Only a few paths are delayed at the same time, a linear search is
+    // cheaper than maintaining a lookup table for all paths.
+    for (int i = 0; i < kMaxCompensatedPaths; ++i) {
+        const DelayLine& delayLine = m_delayLines[i];
+        if (delayLine.inputHandle == inputHandle && delayLine.outputHandle == outputHandle) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int EngineEffectsLatencyCompensator::acquireDelayLine(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle) {
+    if (!inputHandle.valid() || !outputHandle.valid()) {
+        return -1;
+    }
+    for (int i = 0; i < kMaxCompensatedPaths; ++i) {
+        DelayLine& delayLine = m_delayLines[i];
+        if (!delayLine.inputHandle.valid()) {
+            delayLine.inputHandle = inputHandle;
+            delayLine.outputHandle = outputHandle;
+            return i;
+        }
+    }
+    return -1;
+}
+
+void EngineEffectsLatencyCompensator::releaseDelayLine(int index) {
+    DelayLine& delayLine = m_delayLines[index];
+    delayLine.pDelay->clear();
+    delayLine.inputHandle = ChannelHandle();
+    delayLine.outputHandle = ChannelHandle();
+}
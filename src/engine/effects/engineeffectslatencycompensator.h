@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "engine/channelhandle.h"
+#include "engine/effects/engineeffectsdelay.h"
+#include "util/class.h"
+#include "util/types.h"
+
+/// Keeps all input channels that are mixed into the same output channel
+/// phase-aligned when their postfader effects have different latencies,
+/// for example if a pitch shift effect is enabled on one deck only.
+///
+/// Only the channels of a single mix stage must be passed, i.e. the channels
+/// that are mixed together by ChannelMixer. The effects of the buses and of
+/// the output channel itself process the already aligned mix and would be
+/// delayed a second time.
+///
+/// Each (input channel, output channel) path reports the latency of its
+/// processing every callback. The path with the highest latency determines
+/// the latency of the output channel, and all other paths are delayed by the
+/// difference before they are mixed. The plan is made from the latencies
+/// reported during the previous callback, so a change of latency is
+/// compensated one callback later. EngineEffectsDelay crossfades between the
+/// old and the new delay, so this does not click.
+///
+/// The delay lines and the latencies of all possible output channels are
+/// allocated up front and only the paths that actually need to be delayed
+/// occupy a delay line, so nothing is allocated in the audio thread.
+/// The keylock scalers are not part of the plan, because they discard their
+/// start delay and are already aligned with the other channels.
+class EngineEffectsLatencyCompensator final {
+  public:
+    /// Higher latency differences are compensated only up to this
+    /// number of frames (~170 ms at 48 kHz).
+    static constexpr SINT kMaxCompensationFrames = 8192;
+    /// The number of paths that can be delayed at the same time.
+    static constexpr int kMaxCompensatedPaths = 32;
+    /// Output channels with a higher handle are not compensated.
+    static constexpr int kMaxOutputChannels = 256;
+
+    EngineEffectsLatencyCompensator();
+    ~EngineEffectsLatencyCompensator();
+
+    /// Called from the audio thread before any path is processed.
+    /// Plans the latency of each output channel from the latencies that
+    /// were reported during the previous callback.
+    void onCallbackStart();
+
+    /// Called from the audio thread after the effects of the path have been
+    /// processed and before the path is mixed into the output channel.
+    /// latencyFrames is the total latency of the effects of the path.
+    /// pInOut is delayed to match the latency of the output channel.
+    /// This must be called for every path that is mixed into the output
+    /// channel, even if it is not delayed, for planning the next callback.
+    void process(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle,
+            SINT latencyFrames,
+            CSAMPLE* pInOut,
+            unsigned int numSamples);
+
+    /// Returns true if process() would modify the buffer of the path.
+    /// This allows callers to avoid copying a buffer that must not be
+    /// modified in place.
+    bool isDelaying(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle,
+            SINT latencyFrames) const;
+
+    /// Returns the latency that all paths into the output channel are
+    /// aligned to during the current callback.
+    SINT getOutputLatencyFrames(const ChannelHandle& outputHandle) const;
+
+  private:
+    struct OutputLatency {
+        OutputLatency()
+                : latencyFrames(0),
+                  nextLatencyFrames(0) {
+        }
+        // The planned latency for the current callback
+        SINT latencyFrames;
+        // The maximum latency reported during the current callback
+        SINT nextLatencyFrames;
+    };
+
+    struct DelayLine {
+        explicit DelayLine(SINT maxDelayFrames)
+                : pDelay(std::make_unique<EngineEffectsDelay>(maxDelayFrames)),
+                  processed(false) {
+        }
+        std::unique_ptr<EngineEffectsDelay> pDelay;
+        // The path that occupies the delay line, invalid if it is free
+        ChannelHandle inputHandle;
+        ChannelHandle outputHandle;
+        bool processed;
+    };
+
+    SINT compensationFrames(const ChannelHandle& outputHandle,
+            SINT latencyFrames) const;
+    int delayLineIndex(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle) const;
+    int acquireDelayLine(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle);
+    void releaseDelayLine(int index);
+
+    /// Indexed by the handle of the output channel. Channels are registered
+    /// from the main thread while the engine is running, so the array is
+    /// sized for all handles instead of growing at registration.
+    std::array<OutputLatency, kMaxOutputChannels> m_outputLatencies;
+    std::vector<DelayLine> m_delayLines;
+    bool m_warnedExhausted;
+
+    DISALLOW_COPY_AND_ASSIGN(EngineEffectsLatencyCompensator);
+};
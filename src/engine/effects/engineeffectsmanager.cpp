@@ -1,10 +1,183 @@
 #include "engine/effects/engineeffectsmanager.h"
 
+#include <algorithm>
+#include <array>
+
 #include "engine/effects/engineeffect.h"
 #include "engine/effects/engineeffectchain.h"
+#include "engine/effects/engineeffectsworkerpool.h"
 #include "util/defs.h"
 #include "util/sample.h"
 
+namespace {
+
+int findGroup(std::array<int, EngineEffectsManager::kMaxParallelChannels>* pGroups,
+        int channel) {
+    auto& groups = *pGroups;
+    while (groups[channel] != channel) {
+        // Path halving
+        groups[channel] = groups[groups[channel]];
+        channel = groups[channel];
+    }
+    return channel;
+}
+
+void uniteGroups(std::array<int, EngineEffectsManager::kMaxParallelChannels>* pGroups,
+        int channel1,
+        int channel2) {
+    const int group1 = findGroup(pGroups, channel1);
+    const int group2 = findGroup(pGroups, channel2);
+    // The group is always represented by its first channel
+    if (group1 < group2) {
+        (*pGroups)[group2] = group1;
+    } else if (group2 < group1) {
+        (*pGroups)[group1] = group2;
+    }
+}
+
+} // anonymous namespace
+
+/// Processes the channels of one call of processPostFaderChannelsInParallel.
+/// Each slot owns a pair of intermediate buffers, so that chains of different
+/// channel groups can be processed at the same time.
+class EngineEffectsManager::ParallelPostFaderTask final : public EngineEffectsWorkerTask {
+  public:
+    explicit ParallelPostFaderTask(int numSlots)
+            : m_pChains(nullptr),
+              m_pChannels(nullptr),
+              m_numChannels(0),
+              m_inPlace(false),
+              m_numSamples(0),
+              m_sampleRate(0),
+              m_slotForChannel(),
+              m_results(),
+              m_latencyFrames() {
+        m_slotBuffers.reserve(2 * numSlots);
+        for (int i = 0; i < 2 * numSlots; ++i) {
+            m_slotBuffers.emplace_back(MAX_BUFFER_LEN);
+        }
+        m_channelBuffers.reserve(kMaxParallelChannels);
+        for (int i = 0; i < kMaxParallelChannels; ++i) {
+            m_channelBuffers.emplace_back(MAX_BUFFER_LEN);
+        }
+    }
+
+    void run(int slot) override {
+        for (int i = 0; i < m_numChannels; ++i) {
+            if (m_slotForChannel[i] == slot) {
+                processChannel(i, slot);
+            }
+        }
+    }
+
+    const QList<EngineEffectChain*>* m_pChains;
+    ChannelHandle m_outputHandle;
+    const PostFaderChannel* m_pChannels;
+    int m_numChannels;
+    bool m_inPlace;
+    unsigned int m_numSamples;
+    unsigned int m_sampleRate;
+    std::array<int, kMaxParallelChannels> m_slotForChannel;
+    std::array<CSAMPLE*, kMaxParallelChannels> m_results;
+    std::array<SINT, kMaxParallelChannels> m_latencyFrames;
+
+    /// Returns the result of the channel in a buffer that may be modified.
+    /// Called from the audio thread after the task has finished.
+    CSAMPLE* writableResult(int channelIndex) {
+        const PostFaderChannel& channel = m_pChannels[channelIndex];
+        if (!m_inPlace && m_results[channelIndex] == channel.pBuffer) {
+            // The input buffer must not be modified
+            CSAMPLE* pResult = m_channelBuffers[channelIndex].data();
+            SampleUtil::copy(pResult, channel.pBuffer, m_numSamples);
+            m_results[channelIndex] = pResult;
+        }
+        return m_results[channelIndex];
+    }
+
+  private:
+    // Same as EngineEffectsManager::processInner, but skips the chains that
+    // are inactive for the channel. Their bookkeeping has already been done
+    // before the task was started.
+    void processChannel(int channelIndex, int slot) {
+        const PostFaderChannel& channel = m_pChannels[channelIndex];
+        SINT latencyFrames = 0;
+
+        if (m_inPlace) {
+            SampleUtil::applyRampingGain(channel.pBuffer,
+                    channel.oldGain,
+                    channel.newGain,
+                    m_numSamples);
+            for (EngineEffectChain* pChain : *m_pChains) {
+                if (pChain &&
+                        pChain->isActiveForChannel(
+                                channel.inputHandle, m_outputHandle)) {
+                    if (pChain->process(channel.inputHandle,
+                                m_outputHandle,
+                                channel.pBuffer,
+                                channel.pBuffer,
+                                m_numSamples,
+                                m_sampleRate,
+                                *channel.pGroupFeatures,
+                                channel.fadeout)) {
+                        latencyFrames += pChain->getLatencyFrames(
+                                channel.inputHandle, m_outputHandle);
+                    }
+                }
+            }
+            m_results[channelIndex] = channel.pBuffer;
+            m_latencyFrames[channelIndex] = latencyFrames;
+            return;
+        }
+
+        CSAMPLE* pSlotBuffer1 = m_slotBuffers[2 * slot].data();
+        CSAMPLE* pSlotBuffer2 = m_slotBuffers[2 * slot + 1].data();
+        CSAMPLE* pIntermediateInput = pSlotBuffer1;
+        if (channel.oldGain == CSAMPLE_GAIN_ONE && channel.newGain == CSAMPLE_GAIN_ONE) {
+            pIntermediateInput = channel.pBuffer;
+        } else {
+            SampleUtil::copyWithRampingGain(pIntermediateInput,
+                    channel.pBuffer,
+                    channel.oldGain,
+                    channel.newGain,
+                    m_numSamples);
+        }
+
+        for (EngineEffectChain* pChain : *m_pChains) {
+            if (pChain &&
+                    pChain->isActiveForChannel(
+                            channel.inputHandle, m_outputHandle)) {
+                CSAMPLE* pIntermediateOutput =
+                        pIntermediateInput == pSlotBuffer1 ? pSlotBuffer2 : pSlotBuffer1;
+                if (pChain->process(channel.inputHandle,
+                            m_outputHandle,
+                            pIntermediateInput,
+                            pIntermediateOutput,
+                            m_numSamples,
+                            m_sampleRate,
+                            *channel.pGroupFeatures,
+                            channel.fadeout)) {
+                    pIntermediateInput = pIntermediateOutput;
+                    latencyFrames += pChain->getLatencyFrames(
+                            channel.inputHandle, m_outputHandle);
+                }
+            }
+        }
+
+        m_latencyFrames[channelIndex] = latencyFrames;
+        if (pIntermediateInput == channel.pBuffer) {
+            m_results[channelIndex] = channel.pBuffer;
+        } else {
+            // The slot buffers are reused for the next channel of this slot
+            CSAMPLE* pResult = m_channelBuffers[channelIndex].data();
+            SampleUtil::copy(pResult, pIntermediateInput, m_numSamples);
+            m_results[channelIndex] = pResult;
+        }
+    }
+
+    std::vector<mixxx::SampleBuffer> m_slotBuffers;
+    std::vector<mixxx::SampleBuffer> m_channelBuffers;
+};
+
 EngineEffectsManager::EngineEffectsManager(std::unique_ptr<EffectsResponsePipe> pResponsePipe)
         : m_pResponsePipe(std::move(pResponsePipe)),
           m_buffer1(MAX_BUFFER_LEN),
@@ -13,7 +186,26 @@ EngineEffectsManager::EngineEffectsManager(std::unique_ptr<EffectsResponsePipe>
     m_effects.reserve(256);
 }
 
+EngineEffectsManager::~EngineEffectsManager() = default;
+
+void EngineEffectsManager::setParallelProcessingThreads(int numHelperThreads) {
+    // Stop the helper threads before their buffers are released
+    m_pWorkerPool.reset();
+    m_pParallelTask.reset();
+    if (numHelperThreads <= 0) {
+        return;
+    }
+    // More slots than channels would never be used.
+    numHelperThreads = std::min(numHelperThreads, kMaxParallelChannels - 1);
+    qDebug() << debugString() << "Processing effects in parallel with"
+             << numHelperThreads << "helper threads";
+    m_pWorkerPool = std::make_unique<EngineEffectsWorkerPool>(numHelperThreads);
+    m_pParallelTask = std::make_unique<ParallelPostFaderTask>(m_pWorkerPool->numSlots());
+}
+
 void EngineEffectsManager::onCallbackStart() {
+    m_latencyCompensator.onCallbackStart();
+
     EffectsRequest* request = nullptr;
     while (m_pResponsePipe->readMessage(&request)) {
         EffectsResponse response(*request);
@@ -100,6 +292,7 @@ void EngineEffectsManager::processPreFaderInPlace(const ChannelHandle& inputHand
     // This is okay because the equalizer effects do not make use of it.
     GroupFeatureState featureState;
     processInner(SignalProcessingStage::Prefader,
+            false,
             inputHandle,
             outputHandle,
             pInOut,
@@ -120,6 +313,31 @@ void EngineEffectsManager::processPostFaderInPlace(
         CSAMPLE_GAIN newGain,
         bool fadeout) {
     processInner(SignalProcessingStage::Postfader,
+            false,
+            inputHandle,
+            outputHandle,
+            pInOut,
+            pInOut,
+            numSamples,
+            sampleRate,
+            groupFeatures,
+            oldGain,
+            newGain,
+            fadeout);
+}
+
+void EngineEffectsManager::processPostFaderChannelInPlace(
+        const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle,
+        CSAMPLE* pInOut,
+        unsigned int numSamples,
+        unsigned int sampleRate,
+        const GroupFeatureState& groupFeatures,
+        CSAMPLE_GAIN oldGain,
+        CSAMPLE_GAIN newGain,
+        bool fadeout) {
+    processInner(SignalProcessingStage::Postfader,
+            true,
             inputHandle,
             outputHandle,
             pInOut,
@@ -144,6 +362,7 @@ void EngineEffectsManager::processPostFaderAndMix(
         CSAMPLE_GAIN newGain,
         bool fadeout) {
     processInner(SignalProcessingStage::Postfader,
+            true,
             inputHandle,
             outputHandle,
             pIn,
@@ -158,6 +377,7 @@ void EngineEffectsManager::processPostFaderAndMix(
 
 void EngineEffectsManager::processInner(
         const SignalProcessingStage stage,
+        bool compensateLatency,
         const ChannelHandle& inputHandle,
         const ChannelHandle& outputHandle,
         CSAMPLE* pIn,
@@ -174,6 +394,7 @@ void EngineEffectsManager::processInner(
         // Gain and effects are applied to the buffer in place,
         // modifying the original input buffer
         SampleUtil::applyRampingGain(pIn, oldGain, newGain, numSamples);
+        SINT latencyFrames = 0;
         for (EngineEffectChain* pChain : chains) {
             if (pChain) {
                 if (pChain->process(inputHandle,
@@ -184,9 +405,17 @@ void EngineEffectsManager::processInner(
                             sampleRate,
                             groupFeatures,
                             fadeout)) {
+                    latencyFrames += pChain->getLatencyFrames(inputHandle, outputHandle);
                 }
             }
         }
+        if (compensateLatency) {
+            m_latencyCompensator.process(inputHandle,
+                    outputHandle,
+                    latencyFrames,
+                    pOut,
+                    numSamples);
+        }
     } else {
         // Do not modify the input buffer.
         // 1. Copy input buffer to a temporary buffer
@@ -205,6 +434,7 @@ void EngineEffectsManager::processInner(
         }
 
         CSAMPLE* pIntermediateOutput;
+        SINT latencyFrames = 0;
         for (EngineEffectChain* pChain : chains) {
             if (pChain) {
                 // Select an unused intermediate buffer for the next output
@@ -224,15 +454,162 @@ void EngineEffectsManager::processInner(
                             fadeout)) {
                     // Output of this chain becomes the input of the next chain.
                     pIntermediateInput = pIntermediateOutput;
+                    latencyFrames += pChain->getLatencyFrames(inputHandle, outputHandle);
                 }
             }
         }
+        if (compensateLatency) {
+            if (pIntermediateInput == pIn &&
+                    m_latencyCompensator.isDelaying(
+                            inputHandle, outputHandle, latencyFrames)) {
+                // The input buffer must not be modified
+                SampleUtil::copy(m_buffer1.data(), pIn, numSamples);
+                pIntermediateInput = m_buffer1.data();
+            }
+            m_latencyCompensator.process(inputHandle,
+                    outputHandle,
+                    latencyFrames,
+                    pIntermediateInput,
+                    numSamples);
+        }
         // pIntermediateInput is the output of the last processed chain. It would
         // be the intermediate input of the next chain if there was one.
         SampleUtil::add(pOut, pIntermediateInput, numSamples);
     }
 }
 
+bool EngineEffectsManager::processPostFaderChannelsInParallel(
+        const ChannelHandle& outputHandle,
+        const PostFaderChannel* pChannels,
+        int numChannels,
+        CSAMPLE* pOut,
+        bool inPlace,
+        unsigned int numSamples,
+        unsigned int sampleRate) {
+    if (!m_pWorkerPool || numChannels < 2 || numChannels > kMaxParallelChannels) {
+        return false;
+    }
+    const auto chainsIt = m_chainsByStage.constFind(SignalProcessingStage::Postfader);
+    if (chainsIt == m_chainsByStage.constEnd()) {
+        return false;
+    }
+    const QList<EngineEffectChain*>& chains = chainsIt.value();
+
+    // Channels that share an active chain must be processed in series by
+    // the same thread, because the chain's intermediate buffers and the
+    // effect processors' scratch buffers are shared by all channels.
+    std::array<int, kMaxParallelChannels> groups;
+    std::array<int, kMaxParallelChannels> activeChainCount;
+    for (int i = 0; i < numChannels; ++i) {
+        groups[i] = i;
+        activeChainCount[i] = 0;
+    }
+    for (const EngineEffectChain* pChain : chains) {
+        if (!pChain) {
+            continue;
+        }
+        int firstActiveChannel = -1;
+        for (int i = 0; i < numChannels; ++i) {
+            if (!pChain->isActiveForChannel(pChannels[i].inputHandle, outputHandle)) {
+                continue;
+            }
+            ++activeChainCount[i];
+            if (firstActiveChannel < 0) {
+                firstActiveChannel = i;
+            } else {
+                uniteGroups(&groups, firstActiveChannel, i);
+            }
+        }
+    }
+
+    std::array<int, kMaxParallelChannels> groupCost;
+    groupCost.fill(0);
+    for (int i = 0; i < numChannels; ++i) {
+        groupCost[findGroup(&groups, i)] += activeChainCount[i];
+    }
+    int numBusyGroups = 0;
+    for (int i = 0; i < numChannels; ++i) {
+        if (groups[i] == i && groupCost[i] > 0) {
+            ++numBusyGroups;
+        }
+    }
+    if (numBusyGroups < 2) {
+        // Nothing to gain, everything would run on the same thread anyway
+        return false;
+    }
+
+    // Distribute the groups to the slots with a deterministic greedy
+    // scheduling. Groups without any active chain only apply the gain
+    // and stay on the audio thread.
+    const int numSlots = std::min(m_pWorkerPool->numSlots(), numBusyGroups);
+    std::array<int, kMaxParallelChannels> slotCost;
+    slotCost.fill(0);
+    std::array<int, kMaxParallelChannels>& slotForChannel = m_pParallelTask->m_slotForChannel;
+    for (int i = 0; i < numChannels; ++i) {
+        const int group = findGroup(&groups, i);
+        if (group != i) {
+            // The first channel of the group has already been assigned
+            slotForChannel[i] = slotForChannel[group];
+            continue;
+        }
+        int slot = 0;
+        if (groupCost[i] > 0) {
+            for (int s = 1; s < numSlots; ++s) {
+                if (slotCost[s] < slotCost[slot]) {
+                    slot = s;
+                }
+            }
+            slotCost[slot] += groupCost[i];
+        }
+        slotForChannel[i] = slot;
+    }
+
+    // Do the bookkeeping of the inactive chains up front on this thread.
+    // Only the first time a chain is processed during a callback advances
+    // its own enable state, this must happen in the same order as in
+    // processInner.
+    for (EngineEffectChain* pChain : chains) {
+        if (!pChain) {
+            continue;
+        }
+        bool processedBefore = false;
+        for (int i = 0; i < numChannels; ++i) {
+            if (!pChain->isActiveForChannel(pChannels[i].inputHandle, outputHandle)) {
+                pChain->processInactiveChannel(pChannels[i].inputHandle,
+                        outputHandle,
+                        !processedBefore);
+            }
+            processedBefore = true;
+        }
+    }
+
+    m_pParallelTask->m_pChains = &chains;
+    m_pParallelTask->m_outputHandle = outputHandle;
+    m_pParallelTask->m_pChannels = pChannels;
+    m_pParallelTask->m_numChannels = numChannels;
+    m_pParallelTask->m_inPlace = inPlace;
+    m_pParallelTask->m_numSamples = numSamples;
+    m_pParallelTask->m_sampleRate = sampleRate;
+    m_pWorkerPool->run(m_pParallelTask.get(), numSlots);
+
+    // Join the results in the original order of the channels
+    for (int i = 0; i < numChannels; ++i) {
+        const ChannelHandle& inputHandle = pChannels[i].inputHandle;
+        const SINT latencyFrames = m_pParallelTask->m_latencyFrames[i];
+        CSAMPLE* pResult = m_pParallelTask->m_results[i];
+        if (m_latencyCompensator.isDelaying(inputHandle, outputHandle, latencyFrames)) {
+            pResult = m_pParallelTask->writableResult(i);
+        }
+        m_latencyCompensator.process(inputHandle,
+                outputHandle,
+                latencyFrames,
+                pResult,
+                numSamples);
+        SampleUtil::add(pOut, pResult, numSamples);
+    }
+    return true;
+}
+
 bool EngineEffectsManager::addEffectChain(EngineEffectChain* pChain,
         SignalProcessingStage stage) {
     QList<EngineEffectChain*>& chains = m_chainsByStage[stage];
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <QScopedPointer>
+#include <memory>
+#include <vector>
 
 #include "engine/channelhandle.h"
+#include "engine/effects/engineeffectslatencycompensator.h"
 #include "engine/effects/groupfeaturestate.h"
 #include "engine/effects/message.h"
 #include "util/fifo.h"
@@ -11,6 +14,7 @@
 
 class EngineEffectChain;
 class EngineEffect;
+class EngineEffectsWorkerPool;
 
 /// EngineEffectsManager is the entry point for processing effects in the audio
 /// thread. It also passes EffectsRequests from EffectsMessenger down to the
@@ -20,10 +24,38 @@ class EngineEffect;
 /// EngineChannel ---> EqualizerEffectChains --> channel faders & crossfader --> QuickEffectChains & StandardEffectChains --> mix channels into main mix --> main mix effect processing
 ///                                          |
 ///                                      PFL switch --> QuickEffectChains & StandardEffectChains --> mix channels into headphone mix --> headphone effect processing
+///
+/// Before the postfader output of a channel is mixed, it is delayed so that it
+/// is aligned with the channel with the highest postfader effect latency of
+/// the same mix, see EngineEffectsLatencyCompensator.
 class EngineEffectsManager final : public EffectsRequestHandler {
   public:
     EngineEffectsManager(std::unique_ptr<EffectsResponsePipe> pResponsePipe);
-    ~EngineEffectsManager() override = default;
+    ~EngineEffectsManager() override;
+
+    /// One input channel of processPostFaderChannelsInParallel.
+    struct PostFaderChannel {
+        ChannelHandle inputHandle;
+        CSAMPLE* pBuffer;
+        const GroupFeatureState* pGroupFeatures;
+        CSAMPLE_GAIN oldGain;
+        CSAMPLE_GAIN newGain;
+        bool fadeout;
+    };
+
+    /// The maximum number of channels that are mixed in one call of
+    /// processPostFaderChannelsInParallel.
+    static constexpr int kMaxParallelChannels = 16;
+
+    /// Called from the main thread before the engine is started.
+    /// With numHelperThreads > 0 the postfader effects of input channels that
+    /// do not share any EngineEffectChain are processed concurrently on
+    /// real-time helper threads. 0 disables parallel processing.
+    void setParallelProcessingThreads(int numHelperThreads);
+
+    bool isParallelProcessingEnabled() const {
+        return static_cast<bool>(m_pWorkerPool);
+    }
 
     void onCallbackStart();
 
@@ -37,7 +69,8 @@ class EngineEffectsManager final : public EffectsRequestHandler {
             unsigned int sampleRate);
 
     /// Process the postfader EngineEffectChains on the pInOut buffer, modifying
-    /// the contents of the input buffer.
+    /// the contents of the input buffer. Used for the buses and the output
+    /// channels, which are not compensated for the latency of the effects.
     void processPostFaderInPlace(
             const ChannelHandle& inputHandle,
             const ChannelHandle& outputHandle,
@@ -49,11 +82,28 @@ class EngineEffectsManager final : public EffectsRequestHandler {
             CSAMPLE_GAIN newGain = CSAMPLE_GAIN_ONE,
             bool fadeout = false);
 
+    /// Like processPostFaderInPlace for a channel that is mixed with other
+    /// channels into outputHandle afterwards. The channel is delayed to be
+    /// phase-aligned with the other channels of the mix if their effects
+    /// have a higher latency.
+    void processPostFaderChannelInPlace(
+            const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle,
+            CSAMPLE* pInOut,
+            unsigned int numSamples,
+            unsigned int sampleRate,
+            const GroupFeatureState& groupFeatures,
+            CSAMPLE_GAIN oldGain = CSAMPLE_GAIN_ONE,
+            CSAMPLE_GAIN newGain = CSAMPLE_GAIN_ONE,
+            bool fadeout = false);
+
     /// Process the postfader EngineEffectChains, leaving the pIn buffer unmodified
     /// and mixing the output into the pOut buffer. Using EngineEffectsManager's
     /// temporary buffers for this avoids the need for ChannelMixer to allocate a
     /// buffer for every channel, which would potentially require allocation on the
     /// audio thread because ChannelMixer supports an arbitrary number of channels.
+    /// The channel is phase-aligned with the other channels of the mix like
+    /// with processPostFaderChannelInPlace.
     void processPostFaderAndMix(
             const ChannelHandle& inputHandle,
             const ChannelHandle& outputHandle,
@@ -66,11 +116,38 @@ class EngineEffectsManager final : public EffectsRequestHandler {
             CSAMPLE_GAIN newGain = CSAMPLE_GAIN_ONE,
             bool fadeout = false);
 
+    /// Process the postfader EngineEffectChains of all pChannels and mix them
+    /// into pOut like subsequent calls of processPostFaderInPlace (inPlace) or
+    /// processPostFaderAndMix (!inPlace) in the order of pChannels would do.
+    /// Channels are split into groups that do not share an enabled chain, and
+    /// the groups are processed concurrently. The channels are mixed in their
+    /// original order afterwards, so the result is bit-identical to the serial
+    /// processing.
+    /// Returns false without processing anything if parallel processing is
+    /// disabled or would not pay off. The caller must then process the
+    /// channels serially.
+    bool processPostFaderChannelsInParallel(
+            const ChannelHandle& outputHandle,
+            const PostFaderChannel* pChannels,
+            int numChannels,
+            CSAMPLE* pOut,
+            bool inPlace,
+            unsigned int numSamples,
+            unsigned int sampleRate);
+
     bool processEffectsRequest(
             EffectsRequest& message,
             EffectsResponsePipe* pResponsePipe) override;
 
+    /// Returns the number of frames by which all channels that are mixed into
+    /// the output channel are delayed by effects during the current callback.
+    SINT getLatencyFrames(const ChannelHandle& outputHandle) const {
+        return m_latencyCompensator.getOutputLatencyFrames(outputHandle);
+    }
+
   private:
+    class ParallelPostFaderTask;
+
     QString debugString() const {
         return QString("EngineEffectsManager");
     }
@@ -84,8 +161,10 @@ class EngineEffectsManager final : public EffectsRequestHandler {
     // then the operation must occur in-place. Both pInput and pOutput are
     // represented as stereo interleaved samples. There are numSamples total
     // samples, so numSamples/2 left channel samples and numSamples/2 right
-    // channel samples.
+    // channel samples. If compensateLatency is set, the result is delayed to
+    // align it with the other channels that are mixed into outputHandle.
     void processInner(const SignalProcessingStage stage,
+            bool compensateLatency,
             const ChannelHandle& inputHandle,
             const ChannelHandle& outputHandle,
             CSAMPLE* pIn,
@@ -103,4 +182,9 @@ class EngineEffectsManager final : public EffectsRequestHandler {
 
     mixxx::SampleBuffer m_buffer1;
     mixxx::SampleBuffer m_buffer2;
+
+    EngineEffectsLatencyCompensator m_latencyCompensator;
+
+    std::unique_ptr<EngineEffectsWorkerPool> m_pWorkerPool;
+    std::unique_ptr<ParallelPostFaderTask> m_pParallelTask;
 };
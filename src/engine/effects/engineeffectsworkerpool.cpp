@@ -0,0 +1,147 @@
+#include "engine/effects/engineeffectsworkerpool.h"
+
+#include <QtDebug>
+#ifdef __LINUX__
+#include <pthread.h>
+#endif
+
+#include "moc_engineeffectsworkerpool.cpp"
+#include "util/assert.h"
+
+EngineEffectsWorker::EngineEffectsWorker(EngineEffectsWorkerPool* pPool, int slot)
+        : m_pPool(pPool),
+          m_slot(slot),
+#ifdef __cpp_lib_atomic_wait
+          m_wakeUpCount(0),
+          m_lastWakeUpCount(0),
+#endif
+          m_bQuit(false),
+          m_appliedPriority(0) {
+    setObjectName(QStringLiteral("EngineEffectsWorker %1").arg(slot));
+}
+
+EngineEffectsWorker::~EngineEffectsWorker() {
+    stop();
+}
+
+void EngineEffectsWorker::stop() {
+    if (!isRunning()) {
+        return;
+    }
+    m_bQuit.store(true);
+    wakeUp();
+    wait();
+}
+
+void EngineEffectsWorker::wakeUp() {
+#ifdef __cpp_lib_atomic_wait
+    m_wakeUpCount.fetch_add(1, std::memory_order_release);
+    m_wakeUpCount.notify_one();
+#else
+    m_semaRun.release();
+#endif
+}
+
+void EngineEffectsWorker::waitForWakeUp() {
+#ifdef __cpp_lib_atomic_wait
+    // Returns immediately if woken up since the last invocation
+    m_wakeUpCount.wait(m_lastWakeUpCount, std::memory_order_acquire);
+    m_lastWakeUpCount = m_wakeUpCount.load(std::memory_order_acquire);
+#else
+    m_semaRun.acquire();
+#endif
+}
+
+void EngineEffectsWorker::inheritAudioThreadPriority() {
+#ifdef __LINUX__
+    const int priority = m_pPool->m_audioThreadPriority.load(std::memory_order_relaxed);
+    if (priority == m_appliedPriority) {
+        return;
+    }
+    m_appliedPriority = priority;
+    struct sched_param param = {};
+    param.sched_priority = priority;
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+        qWarning() << objectName()
+                   << "Failed to adopt the SCHED_FIFO priority" << priority
+                   << "of the audio thread";
+    }
+#endif
+}
+
+void EngineEffectsWorker::run() {
+    while (true) {
+        waitForWakeUp();
+        if (m_bQuit.load()) {
+            return;
+        }
+        inheritAudioThreadPriority();
+        m_pPool->runSlot(m_slot);
+    }
+}
+
+EngineEffectsWorkerPool::EngineEffectsWorkerPool(int numHelperThreads)
+        : m_audioThreadPriority(0),
+          m_audioThreadPriorityChecked(false),
+          m_pTask(nullptr),
+          m_pendingSlots(0) {
+    DEBUG_ASSERT(numHelperThreads >= 0);
+    m_workers.reserve(numHelperThreads);
+    for (int i = 0; i < numHelperThreads; ++i) {
+        auto* pWorker = new EngineEffectsWorker(this, i + 1);
+        // Only effective on Windows, see inheritAudioThreadPriority() for
+        // Linux.
+        pWorker->start(QThread::TimeCriticalPriority);
+        m_workers.push_back(pWorker);
+    }
+}
+
+EngineEffectsWorkerPool::~EngineEffectsWorkerPool() {
+    for (auto* pWorker : m_workers) {
+        pWorker->stop();
+        delete pWorker;
+    }
+}
+
+void EngineEffectsWorkerPool::run(EngineEffectsWorkerTask* pTask, int numSlots) {
+    DEBUG_ASSERT(pTask);
+    VERIFY_OR_DEBUG_ASSERT(numSlots <= this->numSlots()) {
+        numSlots = this->numSlots();
+    }
+    if (numSlots <= 1) {
+        pTask->run(0);
+        return;
+    }
+
+#ifdef __LINUX__
+    if (!m_audioThreadPriorityChecked) {
+        // Done once, the helpers adopt the priority when woken up
+        m_audioThreadPriorityChecked = true;
+        int policy;
+        struct sched_param param;
+        if (pthread_getschedparam(pthread_self(), &policy, &param) == 0 &&
+                (policy == SCHED_FIFO || policy == SCHED_RR)) {
+            m_audioThreadPriority.store(param.sched_priority, std::memory_order_relaxed);
+        }
+    }
+#endif
+
+    m_pTask = pTask;
+    m_pendingSlots.store(numSlots - 1, std::memory_order_relaxed);
+    // Waking up the helpers publishes m_pTask to them
+    for (int slot = 1; slot < numSlots; ++slot) {
+        m_workers[slot - 1]->wakeUp();
+    }
+
+    pTask->run(0);
+
+    while (m_pendingSlots.load(std::memory_order_acquire) > 0) {
+        QThread::yieldCurrentThread();
+    }
+    m_pTask = nullptr;
+}
+
+void EngineEffectsWorkerPool::runSlot(int slot) {
+    m_pTask->run(slot);
+    m_pendingSlots.fetch_sub(1, std::memory_order_release);
+}
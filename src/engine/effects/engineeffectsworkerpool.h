@@ -0,0 +1,113 @@
+#pragma once
+
+#include <QThread>
+#include <atomic>
+#ifndef __cpp_lib_atomic_wait
+#include <QSemaphore>
+#endif
+#include <vector>
+
+#include "util/class.h"
+
+/// A unit of work that is split into a fixed number of slots by the caller
+/// of EngineEffectsWorkerPool::run. Each slot is processed exactly once by
+/// exactly one thread.
+class EngineEffectsWorkerTask {
+  public:
+    virtual ~EngineEffectsWorkerTask() = default;
+
+    /// Called from the audio thread or one of the helper threads
+    virtual void run(int slot) = 0;
+};
+
+class EngineEffectsWorkerPool;
+
+/// Real-time helper thread that processes one slot of an
+/// EngineEffectsWorkerTask per audio callback.
+///
+/// The helper sleeps on an atomic counter (std::atomic::wait). Waking it up
+/// is a single futex (Linux) or WaitOnAddress (Windows) call without taking
+/// a lock in user space. If std::atomic::wait is not available, e.g. with a
+/// deployment target before macOS 11, a QSemaphore is used instead, which
+/// briefly locks a mutex when waking up the helper.
+class EngineEffectsWorker final : public QThread {
+    Q_OBJECT
+  public:
+    EngineEffectsWorker(EngineEffectsWorkerPool* pPool, int slot);
+    ~EngineEffectsWorker() override;
+
+    void stop();
+
+    /// Called from the audio thread
+    void wakeUp();
+
+  protected:
+    void run() override;
+
+  private:
+    void waitForWakeUp();
+    void inheritAudioThreadPriority();
+
+    EngineEffectsWorkerPool* const m_pPool;
+    const int m_slot;
+#ifdef __cpp_lib_atomic_wait
+    /// Incremented for every wake up
+    std::atomic<int> m_wakeUpCount;
+    int m_lastWakeUpCount;
+#else
+    QSemaphore m_semaRun;
+#endif
+    std::atomic<bool> m_bQuit;
+    int m_appliedPriority;
+};
+
+/// EngineEffectsWorkerPool allows the audio thread to fan out independent
+/// effect processing to a fixed set of real-time helper threads and to join
+/// them again before the callback continues.
+///
+/// The audio thread always processes slot 0 itself, the helper threads
+/// process the slots 1..numThreads(). No memory is allocated on the audio
+/// thread. While waiting for the helpers, the audio thread spins on an
+/// atomic counter and yields instead of blocking, because the helpers are
+/// expected to finish within a fraction of the callback and being woken up
+/// again would take longer. The price is that a helper which is preempted
+/// keeps a core busy until it is scheduled again.
+///
+/// The helpers only meet the deadline if they are scheduled like the audio
+/// thread. QThread::TimeCriticalPriority does not change the scheduling
+/// policy on Linux and macOS. On Linux, the helpers therefore adopt the
+/// SCHED_FIFO priority of the audio thread on the first callback, which
+/// requires the same permissions (RLIMIT_RTPRIO) as the audio thread. On
+/// macOS, the helpers are not part of the audio workgroup and may be
+/// delayed under load.
+class EngineEffectsWorkerPool final {
+  public:
+    /// Called from the main thread
+    explicit EngineEffectsWorkerPool(int numHelperThreads);
+    /// Called from the main thread
+    ~EngineEffectsWorkerPool();
+
+    /// The number of slots that can be processed concurrently, including
+    /// the slot that is processed by the calling thread.
+    int numSlots() const {
+        return static_cast<int>(m_workers.size()) + 1;
+    }
+
+    /// Called from the audio thread. Processes the slots 0..numSlots-1 of
+    /// pTask and returns after all of them have been processed.
+    void run(EngineEffectsWorkerTask* pTask, int numSlots);
+
+  private:
+    friend class EngineEffectsWorker;
+
+    void runSlot(int slot);
+
+    std::vector<EngineEffectsWorker*> m_workers;
+    /// The SCHED_FIFO priority of the audio thread or 0 if not known yet
+    std::atomic<int> m_audioThreadPriority;
+    bool m_audioThreadPriorityChecked;
+    EngineEffectsWorkerTask* m_pTask;
+    std::atomic<int> m_pendingSlots;
+
+    DISALLOW_COPY_AND_ASSIGN(EngineEffectsWorkerPool);
+};
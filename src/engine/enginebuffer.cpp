@@ -166,6 +166,8 @@ EngineBuffer::EngineBuffer(const QString& group,
     connect(m_playposSlider, &ControlObject::valueChanged,
             this, &EngineBuffer::slotControlSeek,
             Qt::DirectConnection);
+    // Updated with every callback
+    m_playposSlider->setDeferredNotification(true);
 
     // Control used to communicate ratio playpos to GUI thread
     m_visualPlayPos = VisualPlayPosition::getVisualPlayPosition(m_group);
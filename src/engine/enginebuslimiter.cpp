@@ -0,0 +1,91 @@
+#include "engine/enginebuslimiter.h"
+
+#include "control/controlobject.h"
+#include "control/controlpotmeter.h"
+#include "control/controlpushbutton.h"
+#include "moc_enginebuslimiter.cpp"
+#include "util/assert.h"
+#include "util/math.h"
+
+namespace {
+
+constexpr double kMinCeilingDb = -12.0;
+constexpr double kMaxCeilingDb = 0.0;
+constexpr double kDefaultCeilingDb = -1.0;
+
+// Avoid flooding the GUI and controllers with tiny changes
+constexpr double kGainReductionEpsilonDb = 0.05;
+
+} // namespace
+
+EngineBusLimiter::EngineBusLimiter(const QString& group, const QString& name)
+        : m_bEnabled(false),
+          m_sampleRate("[Master]", "samplerate") {
+    m_pEnabled = new ControlPushButton(ConfigKey(group, name), true);
+    m_pEnabled->setButtonMode(ControlPushButton::TOGGLE);
+
+    m_pCeiling = new ControlPotmeter(ConfigKey(group, name + QStringLiteral("_ceiling")),
+            kMinCeilingDb,
+            kMaxCeilingDb,
+            false,
+            true,
+            false,
+            true,
+            kDefaultCeilingDb);
+
+    m_pGainReduction = new ControlObject(
+            ConfigKey(group, name + QStringLiteral("_gain_reduction")));
+    m_pGainReduction->setReadOnly();
+    // Updated from the engine thread, deliver the changes without locking
+    m_pGainReduction->setDeferredNotification(true);
+}
+
+EngineBusLimiter::~EngineBusLimiter() {
+    delete m_pEnabled;
+    delete m_pCeiling;
+    delete m_pGainReduction;
+}
+
+void EngineBusLimiter::onCallbackStart() {
+    const bool enabled = m_pEnabled->toBool();
+    if (enabled != m_bEnabled) {
+        // Start without stale look-ahead data. The bus jumps by the latency
+        // of the limiter anyway when it is switched.
+        m_limiter.reset();
+        m_bEnabled = enabled;
+    }
+    if (!enabled) {
+        return;
+    }
+    m_limiter.setSampleRate(mixxx::audio::SampleRate::fromDouble(m_sampleRate.get()));
+    m_limiter.setCeiling(db2ratio(static_cast<CSAMPLE_GAIN>(m_pCeiling->get())));
+}
+
+void EngineBusLimiter::setAlignedLatencyFrames(SINT latencyFrames) {
+    const SINT paddingFrames = latencyFrames - getLatencyFrames();
+    VERIFY_OR_DEBUG_ASSERT(paddingFrames >= 0) {
+        m_alignmentDelay.setDelay(0);
+        return;
+    }
+    m_alignmentDelay.setDelay(
+            static_cast<unsigned int>(paddingFrames * mixxx::kEngineChannelCount));
+}
+
+void EngineBusLimiter::process(CSAMPLE* pInOut, const int iBufferSize) {
+    if (m_bEnabled) {
+        m_limiter.process(pInOut, iBufferSize);
+        updateGainReduction(-ratio2db(static_cast<double>(m_limiter.getMinimumGain())));
+    } else {
+        updateGainReduction(0.0);
+    }
+    m_alignmentDelay.process(pInOut, pInOut, iBufferSize);
+}
+
+void EngineBusLimiter::updateGainReduction(double gainReductionDb) {
+    if (fabs(gainReductionDb - m_pGainReduction->get()) > kGainReductionEpsilonDb ||
+            (gainReductionDb == 0.0 && m_pGainReduction->get() != 0.0)) {
+        // The control is read-only for everyone else. With the deferred
+        // notification this is only an atomic store and a lock-free enqueue.
+        m_pGainReduction->setAndConfirm(gainReductionDb);
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "control/pollingcontrolproxy.h"
+#include "engine/enginelimiter.h"
+#include "engine/filters/enginefilterdelay.h"
+#include "engine/engineobject.h"
+
+class ControlObject;
+class ControlPotmeter;
+class ControlPushButton;
+
+/// Connects an EngineLimiter to the controls of an output bus:
+///   [group],name                  enables the limiter (persistent)
+///   [group],name_ceiling          true-peak ceiling in dBTP (persistent)
+///   [group],name_gain_reduction   current gain reduction in dB (read-only)
+///
+/// The limiter is bypassed by default, because it delays the bus by a
+/// few milliseconds. Buses that are heard together are kept aligned with
+/// setAlignedLatencyFrames(), which pads a bus with a smaller latency.
+class EngineBusLimiter : public EngineObject {
+    Q_OBJECT
+  public:
+    /// Large enough for the maximum latency of the limiter
+    static constexpr unsigned int kAlignmentDelaySize =
+            static_cast<unsigned int>(2 * EngineLimiter::kMaxLookaheadFrames *
+                    mixxx::kEngineChannelCount);
+
+    EngineBusLimiter(const QString& group, const QString& name);
+    ~EngineBusLimiter() override;
+
+    /// Reads the controls. Must be called at the start of each callback,
+    /// before getLatencyFrames() and process().
+    void onCallbackStart();
+
+    /// The latency of the limiter in frames, 0 if it is bypassed
+    SINT getLatencyFrames() const {
+        return m_bEnabled ? m_limiter.getLatencyFrames() : 0;
+    }
+
+    /// Delays the bus to a total latency of latencyFrames, which must not
+    /// be less than getLatencyFrames().
+    void setAlignedLatencyFrames(SINT latencyFrames);
+
+    void process(CSAMPLE* pInOut, const int iBufferSize) override;
+
+  private:
+    void updateGainReduction(double gainReductionDb);
+
+    EngineLimiter m_limiter;
+    EngineFilterDelay<kAlignmentDelaySize> m_alignmentDelay;
+    bool m_bEnabled;
+
+    ControlPushButton* m_pEnabled;
+    ControlPotmeter* m_pCeiling;
+    ControlObject* m_pGainReduction;
+    PollingControlProxy m_sampleRate;
+};
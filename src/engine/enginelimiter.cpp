@@ -0,0 +1,222 @@
+#include "engine/enginelimiter.h"
+
+#include <cmath>
+
+#include "util/assert.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kDefaultSampleRate(44100);
+
+// Designs a Hann windowed sinc interpolator that estimates the signal
+// phase / (numPhases + 1) frames after the center of the taps.
+template<int numPhases, int numTaps>
+std::array<std::array<CSAMPLE, numTaps>, numPhases> designInterpolator() {
+    std::array<std::array<CSAMPLE, numTaps>, numPhases> coefficients;
+    const double center = numTaps / 2;
+    for (int phase = 0; phase < numPhases; ++phase) {
+        const double fraction = static_cast<double>(phase + 1) / (numPhases + 1);
+        std::array<double, numTaps> taps;
+        double sum = 0;
+        for (int k = 0; k < numTaps; ++k) {
+            // Tap k is applied to the input frame i - k, the interpolated
+            // position is i - center + fraction.
+            const double distance = k - center + fraction;
+            const double sinc = std::sin(M_PI * distance) / (M_PI * distance);
+            const double window = 0.5 + 0.5 * std::cos(M_PI * distance / (center + 1));
+            taps[k] = sinc * window;
+            sum += taps[k];
+        }
+        // Normalize to unity gain at DC
+        for (int k = 0; k < numTaps; ++k) {
+            coefficients[phase][k] = static_cast<CSAMPLE>(taps[k] / sum);
+        }
+    }
+    return coefficients;
+}
+
+} // anonymous namespace
+
+EngineLimiter::EngineLimiter()
+        : m_sampleRate(),
+          m_lookaheadFrames(1),
+          m_ceiling(CSAMPLE_GAIN_ONE),
+          m_releaseCoefficient(CSAMPLE_GAIN_ONE),
+          m_minimumGain(CSAMPLE_GAIN_ONE),
+          m_coefficients(designInterpolator<kNumPhases, kTapsPerPhase>()),
+          m_detectorInput(kHistoryLength + kBlockFrames),
+          m_interpolated(kBlockFrames),
+          m_framePeaks(kBlockFrames),
+          m_dequeFront(0),
+          m_dequeSize(0),
+          m_frameCounter(0),
+          m_releaseGain(CSAMPLE_GAIN_ONE),
+          m_gainWindowPos(0),
+          m_gainWindowSum(0),
+          m_delayPos(0) {
+    setSampleRate(kDefaultSampleRate);
+    reset();
+}
+
+void EngineLimiter::setSampleRate(mixxx::audio::SampleRate sampleRate) {
+    VERIFY_OR_DEBUG_ASSERT(sampleRate.isValid()) {
+        return;
+    }
+    if (sampleRate == m_sampleRate) {
+        return;
+    }
+    m_sampleRate = sampleRate;
+    m_lookaheadFrames = math_clamp(
+            static_cast<SINT>(std::lround(kLookaheadSeconds * sampleRate.toDouble())),
+            SINT(1),
+            kMaxLookaheadFrames);
+    m_releaseCoefficient = static_cast<CSAMPLE_GAIN>(
+            1 - std::exp(-1 / (kReleaseSeconds * sampleRate.toDouble())));
+    reset();
+}
+
+void EngineLimiter::setCeiling(CSAMPLE_GAIN ceiling) {
+    VERIFY_OR_DEBUG_ASSERT(ceiling > 0) {
+        return;
+    }
+    m_ceiling = ceiling;
+}
+
+void EngineLimiter::reset() {
+    for (auto& history : m_detectorHistory) {
+        history.fill(CSAMPLE_ZERO);
+    }
+    m_dequeFront = 0;
+    m_dequeSize = 0;
+    m_frameCounter = 0;
+    m_releaseGain = CSAMPLE_GAIN_ONE;
+    m_minimumGain = CSAMPLE_GAIN_ONE;
+    m_gainWindow.fill(CSAMPLE_GAIN_ONE);
+    m_gainWindowPos = 0;
+    m_gainWindowSum = static_cast<double>(m_lookaheadFrames);
+    m_delayLine.fill(CSAMPLE_ZERO);
+    m_delayPos = 0;
+}
+
+void EngineLimiter::detectPeaks(const CSAMPLE* pIn, SINT numFrames) {
+    DEBUG_ASSERT(numFrames <= kBlockFrames);
+    CSAMPLE* pPeaks = m_framePeaks.data();
+    CSAMPLE* pInterpolated = m_interpolated.data();
+    SampleUtil::clear(pPeaks, numFrames);
+
+    for (int channel = 0; channel < kNumChannels; ++channel) {
+        // pWork[kHistoryLength + i] is the input frame i
+        CSAMPLE* pWork = m_detectorInput.data();
+        auto& history = m_detectorHistory[channel];
+        std::copy(history.begin(), history.end(), pWork);
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < numFrames; ++i) {
+            pWork[kHistoryLength + i] = pIn[i * kNumChannels + channel];
+        }
+
+        // The sample itself is the first of the 4 phases
+        const CSAMPLE* pCenter = pWork + kHistoryLength - kDetectorDelayFrames;
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < numFrames; ++i) {
+            pPeaks[i] = math_max(pPeaks[i], std::abs(pCenter[i]));
+        }
+
+        for (const auto& coefficients : m_coefficients) {
+            SampleUtil::clear(pInterpolated, numFrames);
+            for (int k = 0; k < kTapsPerPhase; ++k) {
+                const CSAMPLE coefficient = coefficients[k];
+                const CSAMPLE* pTap = pWork + kHistoryLength - k;
+                // note: LOOP VECTORIZED.
+                for (SINT i = 0; i < numFrames; ++i) {
+                    pInterpolated[i] += coefficient * pTap[i];
+                }
+            }
+            // note: LOOP VECTORIZED.
+            for (SINT i = 0; i < numFrames; ++i) {
+                pPeaks[i] = math_max(pPeaks[i], std::abs(pInterpolated[i]));
+            }
+        }
+
+        std::copy(pWork + numFrames, pWork + numFrames + kHistoryLength, history.begin());
+    }
+}
+
+CSAMPLE_GAIN EngineLimiter::nextGain(CSAMPLE peak) {
+    // Sliding window maximum: Peaks that are smaller than the new one can
+    // never become the maximum again, and the oldest peak leaves the window.
+    constexpr SINT kDequeCapacity = kMaxLookaheadFrames + 1;
+    while (m_dequeSize > 0) {
+        const SINT back = (m_dequeFront + m_dequeSize - 1) % kDequeCapacity;
+        if (m_peakDeque[back].peak > peak) {
+            break;
+        }
+        --m_dequeSize;
+    }
+    m_peakDeque[(m_dequeFront + m_dequeSize) % kDequeCapacity] = {m_frameCounter, peak};
+    ++m_dequeSize;
+    if (m_peakDeque[m_dequeFront].frame <= m_frameCounter - m_lookaheadFrames) {
+        m_dequeFront = (m_dequeFront + 1) % kDequeCapacity;
+        --m_dequeSize;
+    }
+    ++m_frameCounter;
+    const CSAMPLE windowPeak = m_peakDeque[m_dequeFront].peak;
+
+    // The gain drops immediately to the required value and is held for the
+    // look-ahead window by the sliding maximum. Afterwards it is released.
+    const CSAMPLE_GAIN targetGain =
+            windowPeak > m_ceiling ? m_ceiling / windowPeak : CSAMPLE_GAIN_ONE;
+    if (targetGain < m_releaseGain) {
+        m_releaseGain = targetGain;
+    } else {
+        m_releaseGain += (targetGain - m_releaseGain) * m_releaseCoefficient;
+    }
+
+    // The moving average over the look-ahead window turns the gain steps into
+    // ramps that have reached the required gain when the peak is output.
+    m_gainWindowSum += m_releaseGain - m_gainWindow[m_gainWindowPos];
+    m_gainWindow[m_gainWindowPos] = m_releaseGain;
+    if (++m_gainWindowPos == m_lookaheadFrames) {
+        m_gainWindowPos = 0;
+    }
+    // The running sum can exceed the window size slightly due to rounding
+    // errors, but the limiter must never amplify.
+    return math_min(static_cast<CSAMPLE_GAIN>(m_gainWindowSum / m_lookaheadFrames),
+            CSAMPLE_GAIN_ONE);
+}
+
+void EngineLimiter::process(CSAMPLE* pInOut, SINT numSamples) {
+    const SINT latencyFrames = getLatencyFrames();
+    constexpr SINT kDelayLineFrames = kMaxLatencyFrames;
+    m_minimumGain = CSAMPLE_GAIN_ONE;
+
+    const SINT numFrames = numSamples / kNumChannels;
+    for (SINT offset = 0; offset < numFrames; offset += kBlockFrames) {
+        CSAMPLE* pBlock = pInOut + offset * kNumChannels;
+        const SINT blockFrames = math_min(kBlockFrames, numFrames - offset);
+        detectPeaks(pBlock, blockFrames);
+
+        const CSAMPLE* pPeaks = m_framePeaks.data();
+        for (SINT i = 0; i < blockFrames; ++i) {
+            const CSAMPLE_GAIN gain = nextGain(pPeaks[i]);
+            m_minimumGain = math_min(m_minimumGain, gain);
+
+            // Write the new frame to the delay line and apply the gain to
+            // the frame that has been written latencyFrames ago.
+            SINT readPos = m_delayPos - latencyFrames;
+            if (readPos < 0) {
+                readPos += kDelayLineFrames;
+            }
+            for (int channel = 0; channel < kNumChannels; ++channel) {
+                const CSAMPLE sample = pBlock[i * kNumChannels + channel];
+                m_delayLine[m_delayPos * kNumChannels + channel] = sample;
+                pBlock[i * kNumChannels + channel] =
+                        m_delayLine[readPos * kNumChannels + channel] * gain;
+            }
+            if (++m_delayPos == kDelayLineFrames) {
+                m_delayPos = 0;
+            }
+        }
+    }
+}
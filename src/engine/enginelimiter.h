@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+
+#include "engine/engine.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+/// A look-ahead true-peak limiter for the output buses.
+///
+/// The inter-sample peaks of the signal are estimated by a 4x oversampling
+/// polyphase interpolator, similar to the true-peak meter of ITU-R BS.1770.
+/// The gain that is required to keep the estimated peaks below the ceiling
+/// is held over the look-ahead window using a sliding window maximum of the
+/// peaks (monotonic deque), released exponentially and finally smoothed by
+/// a moving average over the look-ahead window. Because the audio is delayed
+/// by the same window, the gain reduction has fully ramped in when a peak
+/// reaches the output. The result never exceeds the ceiling and the gain
+/// changes without discontinuities.
+///
+/// The peak detection runs on planar, contiguous buffers so the compiler can
+/// vectorize it. Only the gain computation is processed frame by frame.
+class EngineLimiter final {
+  public:
+    /// The look-ahead window, including the attack time
+    static constexpr double kLookaheadSeconds = 0.0015;
+    static constexpr double kReleaseSeconds = 0.1;
+    static constexpr SINT kMaxLookaheadFrames = 512;
+    /// The peak detector estimates the peaks between the input frames
+    /// i - kDetectorDelayFrames and i - kDetectorDelayFrames + 1.
+    static constexpr int kDetectorDelayFrames = 6;
+
+    EngineLimiter();
+
+    /// Resets the limiter if the sample rate changes.
+    void setSampleRate(mixxx::audio::SampleRate sampleRate);
+
+    /// The maximum true-peak amplitude of the output as linear gain
+    void setCeiling(CSAMPLE_GAIN ceiling);
+    CSAMPLE_GAIN getCeiling() const {
+        return m_ceiling;
+    }
+
+    /// The delay of the output in frames
+    SINT getLatencyFrames() const {
+        return m_lookaheadFrames + kDetectorDelayFrames - 1;
+    }
+
+    /// The smallest gain that has been applied by the last call to process.
+    CSAMPLE_GAIN getMinimumGain() const {
+        return m_minimumGain;
+    }
+
+    /// Clears the look-ahead buffers and the gain reduction.
+    void reset();
+
+    void process(CSAMPLE* pInOut, SINT numSamples);
+
+  private:
+    static constexpr int kNumChannels = mixxx::kEngineChannelCount;
+    /// Number of interpolated phases between two input frames
+    static constexpr int kNumPhases = 3;
+    static constexpr int kTapsPerPhase = 2 * kDetectorDelayFrames;
+    static constexpr int kHistoryLength = kTapsPerPhase - 1;
+    static constexpr SINT kBlockFrames = 256;
+    static constexpr SINT kMaxLatencyFrames = kMaxLookaheadFrames + kDetectorDelayFrames;
+
+    /// Writes the estimated true-peak amplitude of each frame to m_framePeaks.
+    void detectPeaks(const CSAMPLE* pIn, SINT numFrames);
+    /// Returns the gain for the next frame, given the peak of the newest frame.
+    CSAMPLE_GAIN nextGain(CSAMPLE peak);
+
+    mixxx::audio::SampleRate m_sampleRate;
+    SINT m_lookaheadFrames;
+    CSAMPLE_GAIN m_ceiling;
+    CSAMPLE_GAIN m_releaseCoefficient;
+    CSAMPLE_GAIN m_minimumGain;
+
+    // Peak detection
+    std::array<std::array<CSAMPLE, kTapsPerPhase>, kNumPhases> m_coefficients;
+    std::array<std::array<CSAMPLE, kHistoryLength>, kNumChannels> m_detectorHistory;
+    mixxx::SampleBuffer m_detectorInput;
+    mixxx::SampleBuffer m_interpolated;
+    mixxx::SampleBuffer m_framePeaks;
+
+    // Sliding window maximum of the peaks. The deque holds the peaks of the
+    // window in decreasing order together with their frame index.
+    struct WindowPeak {
+        SINT frame;
+        CSAMPLE peak;
+    };
+    std::array<WindowPeak, kMaxLookaheadFrames + 1> m_peakDeque;
+    SINT m_dequeFront;
+    SINT m_dequeSize;
+    SINT m_frameCounter;
+
+    // Release and moving average of the gain
+    CSAMPLE_GAIN m_releaseGain;
+    std::array<CSAMPLE_GAIN, kMaxLookaheadFrames> m_gainWindow;
+    SINT m_gainWindowPos;
+    double m_gainWindowSum;
+
+    // Delay line for the audio, interleaved
+    std::array<CSAMPLE, kMaxLatencyFrames * kNumChannels> m_delayLine;
+    SINT m_delayPos;
+};
@@ -5,14 +5,17 @@
 #include <QtDebug>
 
 #include "control/controlaudiotaperpot.h"
+#include "control/controlnotificationqueue.h"
 #include "control/controlpotmeter.h"
 #include "control/controlpushbutton.h"
+#include "control/controlsnapshot.h"
 #include "effects/effectsmanager.h"
 #include "engine/channelmixer.h"
 #include "engine/channels/enginechannel.h"
 #include "engine/channels/enginedeck.h"
 #include "engine/effects/engineeffectsmanager.h"
 #include "engine/enginebuffer.h"
+#include "engine/enginebuslimiter.h"
 #include "engine/enginedelay.h"
 #include "engine/enginetalkoverducking.h"
 #include "engine/enginevumeter.h"
@@ -24,6 +27,7 @@
 #include "moc_enginemaster.cpp"
 #include "preferences/usersettings.h"
 #include "util/defs.h"
+#include "util/math.h"
 #include "util/sample.h"
 #include "util/timer.h"
 #include "util/trace.h"
@@ -113,6 +117,12 @@ EngineMaster::EngineMaster(
         ConfigKey(group, "microphoneLatencyCompensation"));
     m_pNumMicsConfigured = new ControlObject(ConfigKey(group, "num_mics_configured"));
 
+    // True-peak limiters, bypassed by default
+    m_pMasterLimiter = new EngineBusLimiter(group, "limiter");
+    m_pBoothLimiter = new EngineBusLimiter(group, "booth_limiter");
+    m_pHeadLimiter = new EngineBusLimiter(group, "head_limiter");
+    m_pRecordLimiter = new EngineBusLimiter(group, "record_limiter");
+
     // Headphone volume
     m_pHeadGain = new ControlAudioTaperPot(ConfigKey(group, "headGain"), -14, 14, 0.5);
 
@@ -210,6 +220,10 @@ EngineMaster::~EngineMaster() {
     delete m_pHeadDelay;
     delete m_pBoothDelay;
     delete m_pLatencyCompensationDelay;
+    delete m_pMasterLimiter;
+    delete m_pBoothLimiter;
+    delete m_pHeadLimiter;
+    delete m_pRecordLimiter;
     delete m_pNumMicsConfigured;
 
     delete m_pXFaderReverse;
@@ -395,12 +409,14 @@ void EngineMaster::process(const int iBufferSize) {
         haveSetName = true;
     }
     //Trace t("EngineMaster::process");
+    const ControlNotificationQueue::ProducerScope notificationScope;
 
     bool masterEnabled = m_pMasterEnabled->toBool();
     bool boothEnabled = m_pBoothEnabled->toBool();
     bool headphoneEnabled = m_pHeadphoneEnabled->toBool();
 
     m_sampleRate = mixxx::audio::SampleRate::fromDouble(m_pMasterSampleRate->get());
+    updateLimiterLatencies();
     // TODO: remove assumption of stereo buffer
     constexpr unsigned int kChannels = 2;
     const unsigned int iFrames = iBufferSize / kChannels;
@@ -491,21 +507,10 @@ void EngineMaster::process(const int iBufferSize) {
                 false);
     }
 
-    switch (m_pTalkoverDucking->getMode()) {
-    case EngineTalkoverDucking::OFF:
-        m_pTalkoverDucking->setAboveThreshold(false);
-        break;
-    case EngineTalkoverDucking::AUTO:
-        m_pTalkoverDucking->processKey(m_pTalkover, iBufferSize);
-        break;
-    case EngineTalkoverDucking::MANUAL:
-        m_pTalkoverDucking->setAboveThreshold(m_activeTalkoverChannels.size());
-        break;
-    default:
-        DEBUG_ASSERT("!Unknown Ducking mode");
-        m_pTalkoverDucking->setAboveThreshold(false);
-        break;
-    }
+    // Feed the talkover mix to the ducking compressor
+    m_pTalkoverDucking->processKey(m_pTalkover,
+            iBufferSize,
+            !m_activeTalkoverChannels.isEmpty());
 
     // Calculate the crossfader gains for left and right side of the crossfader
     CSAMPLE_GAIN crossfaderLeftGain, crossfaderRightGain;
@@ -517,12 +522,11 @@ void EngineMaster::process(const int iBufferSize) {
 
     // Make the mix for each crossfader orientation output bus.
     // m_masterGain takes care of applying the attenuation from
-    // channel volume faders, crossfader, and talkover ducking.
+    // channel volume faders and crossfader. The buses are ducked afterwards.
     // Talkover is mixed in later according to the configured MicMonitorMode
     m_masterGain.setGains(crossfaderLeftGain,
             1.0f,
-            crossfaderRightGain,
-            m_pTalkoverDucking->getGain(iFrames));
+            crossfaderRightGain);
 
     for (int o = EngineChannel::LEFT; o <= EngineChannel::RIGHT; o++) {
         ChannelMixer::applyEffectsInPlaceAndMixChannels(m_masterGain,
@@ -534,6 +538,7 @@ void EngineMaster::process(const int iBufferSize) {
                 iBufferSize,
                 static_cast<int>(m_sampleRate.value()),
                 m_pEngineEffectsManager);
+        m_pTalkoverDucking->process(o, m_pOutputBusBuffers[o], iBufferSize);
     }
 
     // Process crossfader orientation bus channel effects
@@ -741,6 +746,7 @@ void EngineMaster::process(const int iBufferSize) {
         // EngineSideChain::receiveBuffer has copied the input buffer to m_pSidechainMix
         // via before (called by SoundManager::pushInputBuffers())
         if (m_pEngineSideChain) {
+            m_pRecordLimiter->process(m_pSidechainMix, iBufferSize);
             m_pEngineSideChain->writeSamples(m_pSidechainMix, iFrames);
         }
 
@@ -776,6 +782,8 @@ void EngineMaster::process(const int iBufferSize) {
         m_balleftOld = balleft;
         m_balrightOld = balright;
 
+        m_pMasterLimiter->process(m_pMaster, iBufferSize);
+
         // Update VU meter (it does not return anything). Needs to be here so that
         // master balance and talkover is reflected in the VU meter.
         if (m_pVumeter != nullptr) {
@@ -793,17 +801,40 @@ void EngineMaster::process(const int iBufferSize) {
         SampleUtil::clear(m_pMaster, iBufferSize);
     }
     if (headphoneEnabled) {
+        m_pHeadLimiter->process(m_pHead, iBufferSize);
         m_pHeadDelay->process(m_pHead, iBufferSize);
     }
     if (boothEnabled) {
+        m_pBoothLimiter->process(m_pBooth, iBufferSize);
         m_pBoothDelay->process(m_pBooth, iBufferSize);
     }
 
+    // All controls have been updated for this callback
+    ControlSnapshot::refreshAll();
+
     // We're close to the end of the callback. Wake up the engine worker
     // scheduler so that it runs the workers.
     m_pWorkerScheduler->runWorkers();
 }
 
+void EngineMaster::updateLimiterLatencies() {
+    m_pMasterLimiter->onCallbackStart();
+    m_pBoothLimiter->onCallbackStart();
+    m_pHeadLimiter->onCallbackStart();
+    m_pRecordLimiter->onCallbackStart();
+
+    // The main, booth and headphone outputs are heard together, so all of
+    // them are delayed by the largest latency of their limiters. The
+    // record/broadcast mix is not heard live and keeps its own latency.
+    const SINT latencyFrames = math_max(m_pMasterLimiter->getLatencyFrames(),
+            math_max(m_pBoothLimiter->getLatencyFrames(),
+                    m_pHeadLimiter->getLatencyFrames()));
+    m_pMasterLimiter->setAlignedLatencyFrames(latencyFrames);
+    m_pBoothLimiter->setAlignedLatencyFrames(latencyFrames);
+    m_pHeadLimiter->setAlignedLatencyFrames(latencyFrames);
+    m_pRecordLimiter->setAlignedLatencyFrames(m_pRecordLimiter->getLatencyFrames());
+}
+
 void EngineMaster::applyMasterEffects(int iBufferSize) {
     // Apply master effects
     if (m_pEngineEffectsManager) {
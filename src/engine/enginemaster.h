@@ -30,6 +30,7 @@ class GuiTick;
 class EngineSync;
 class EngineTalkoverDucking;
 class EngineDelay;
+class EngineBusLimiter;
 
 // The number of channels to pre-allocate in various structures in the
 // engine. Prevents memory allocation in EngineMaster::addChannel.
@@ -159,8 +160,7 @@ class EngineMaster : public QObject, public AudioSource {
         OrientationVolumeGainCalculator()
                 : m_dLeftGain(1.0),
                   m_dCenterGain(1.0),
-                  m_dRightGain(1.0),
-                  m_dTalkoverDuckingGain(1.0) {
+                  m_dRightGain(1.0) {
         }
 
         inline CSAMPLE_GAIN getGain(ChannelInfo* pChannelInfo) const {
@@ -171,24 +171,21 @@ class EngineMaster : public QObject, public AudioSource {
                     m_dLeftGain,
                     m_dCenterGain,
                     m_dRightGain);
-            return channelVolume * orientationGain * m_dTalkoverDuckingGain;
+            return channelVolume * orientationGain;
         }
 
         inline void setGains(CSAMPLE_GAIN leftGain,
                 CSAMPLE_GAIN centerGain,
-                CSAMPLE_GAIN rightGain,
-                CSAMPLE_GAIN talkoverDuckingGain) {
+                CSAMPLE_GAIN rightGain) {
             m_dLeftGain = leftGain;
             m_dCenterGain = centerGain;
             m_dRightGain = rightGain;
-            m_dTalkoverDuckingGain = talkoverDuckingGain;
         }
 
       private:
         CSAMPLE_GAIN m_dLeftGain;
         CSAMPLE_GAIN m_dCenterGain;
         CSAMPLE_GAIN m_dRightGain;
-        CSAMPLE_GAIN m_dTalkoverDuckingGain;
     };
 
     enum class MicMonitorMode {
@@ -263,6 +260,8 @@ class EngineMaster : public QObject, public AudioSource {
     void processChannels(int iBufferSize);
 
     ChannelHandleFactoryPointer m_pChannelHandleFactory;
+    /// Reads the limiter controls and aligns the outputs to their latency.
+    void updateLimiterLatencies();
     void applyMasterEffects(int iBufferSize);
     void processHeadphones(
             const CSAMPLE_GAIN masterMixGainInHeadphones,
@@ -313,6 +312,10 @@ class EngineMaster : public QObject, public AudioSource {
     EngineDelay* m_pHeadDelay;
     EngineDelay* m_pBoothDelay;
     EngineDelay* m_pLatencyCompensationDelay;
+    EngineBusLimiter* m_pMasterLimiter;
+    EngineBusLimiter* m_pBoothLimiter;
+    EngineBusLimiter* m_pHeadLimiter;
+    EngineBusLimiter* m_pRecordLimiter;
 
     EngineVuMeter* m_pVumeter;
     EngineSideChain* m_pEngineSideChain;
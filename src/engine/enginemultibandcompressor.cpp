@@ -0,0 +1,477 @@
+#include "engine/enginemultibandcompressor.h"
+
+#include <cmath>
+
+#include "util/assert.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kDefaultSampleRate(44100);
+constexpr double kDefaultLowFrequency = 246;
+constexpr double kDefaultHighFrequency = 2484;
+constexpr double kDefaultAttackMs = 10;
+constexpr double kDefaultReleaseMs = 100;
+// Gains closer to the target are snapped to it, so the release reaches unity
+// in finite time.
+constexpr CSAMPLE_GAIN kGainEpsilon = 1e-6f;
+
+CSAMPLE_GAIN smoothingCoefficient(double timeMs, mixxx::audio::SampleRate sampleRate) {
+    if (timeMs <= 0) {
+        // Instant
+        return CSAMPLE_GAIN_ONE;
+    }
+    return static_cast<CSAMPLE_GAIN>(
+            1 - std::exp(-1000 / (timeMs * sampleRate.toDouble())));
+}
+
+// Clears the filter state without the fade in of a paused filter. The
+// compressor crossfades from the dry signal itself.
+template<typename Filter>
+void restartFilter(Filter* pFilter) {
+    pFilter->pauseFilter();
+    pFilter->assumeSettled();
+}
+
+} // anonymous namespace
+
+EngineMultiBandCompressor::BandSplitter::BandSplitter(
+        int sampleRate, double lowFrequency, double highFrequency)
+        : m_lowLow(sampleRate, lowFrequency),
+          m_lowHigh(sampleRate, lowFrequency),
+          m_highLow(sampleRate, highFrequency),
+          m_highHigh(sampleRate, highFrequency),
+          m_allpassLow(sampleRate, lowFrequency),
+          m_allpassHigh(sampleRate, lowFrequency) {
+}
+
+void EngineMultiBandCompressor::BandSplitter::setFrequencies(
+        int sampleRate, double lowFrequency, double highFrequency) {
+    m_lowLow.setFrequencyCorners(sampleRate, lowFrequency);
+    m_lowHigh.setFrequencyCorners(sampleRate, lowFrequency);
+    m_highLow.setFrequencyCorners(sampleRate, highFrequency);
+    m_highHigh.setFrequencyCorners(sampleRate, highFrequency);
+    m_allpassLow.setFrequencyCorners(sampleRate, lowFrequency);
+    m_allpassHigh.setFrequencyCorners(sampleRate, lowFrequency);
+}
+
+void EngineMultiBandCompressor::BandSplitter::reset() {
+    restartFilter(&m_lowLow);
+    restartFilter(&m_lowHigh);
+    restartFilter(&m_highLow);
+    restartFilter(&m_highHigh);
+    restartFilter(&m_allpassLow);
+    restartFilter(&m_allpassHigh);
+}
+
+void EngineMultiBandCompressor::BandSplitter::process(const CSAMPLE* pIn,
+        CSAMPLE* pLow,
+        CSAMPLE* pMid,
+        CSAMPLE* pHigh,
+        CSAMPLE* pTemp,
+        SINT numSamples) {
+    // Split at the high crossover first, then split the lower part at the
+    // low crossover. The sum of a Linkwitz-Riley low and high pass is an
+    // allpass, so the high band needs the allpass of the low crossover to
+    // stay in phase with the sum of the low and mid band.
+    m_highLow.process(pIn, pLow, static_cast<int>(numSamples));
+    m_highHigh.process(pIn, pHigh, static_cast<int>(numSamples));
+    m_lowHigh.process(pLow, pMid, static_cast<int>(numSamples));
+    m_lowLow.process(pLow, pLow, static_cast<int>(numSamples));
+    m_allpassLow.process(pHigh, pTemp, static_cast<int>(numSamples));
+    m_allpassHigh.process(pHigh, pHigh, static_cast<int>(numSamples));
+    SampleUtil::add(pHigh, pTemp, numSamples);
+}
+
+EngineMultiBandCompressor::ProgramPath::ProgramPath(
+        int sampleRate, double lowFrequency, double highFrequency)
+        : splitter(sampleRate, lowFrequency, highFrequency),
+          delayLine((kMaxLookaheadFrames + 1) * kNumChannels),
+          delayPos(0),
+          processing(false),
+          crossfadeFrames(0) {
+    delayLine.fill(CSAMPLE_ZERO);
+}
+
+EngineMultiBandCompressor::EngineMultiBandCompressor(SINT maxFrames, int numPrograms)
+        : m_maxFrames(maxFrames),
+          m_sampleRate(kDefaultSampleRate),
+          m_lowFrequency(kDefaultLowFrequency),
+          m_highFrequency(kDefaultHighFrequency),
+          m_attackMs(kDefaultAttackMs),
+          m_releaseMs(kDefaultReleaseMs),
+          m_lookaheadMs(0),
+          m_lookaheadFrames(0),
+          m_attackCoefficient(CSAMPLE_GAIN_ONE),
+          m_releaseCoefficient(CSAMPLE_GAIN_ONE),
+          m_bandsLinked(false),
+          m_keySplitter(kDefaultSampleRate.value(), kDefaultLowFrequency, kDefaultHighFrequency),
+          m_keyFrames(0),
+          m_unityGains(true),
+          m_tempBuffer(kBlockSamples) {
+    DEBUG_ASSERT(maxFrames > 0);
+    DEBUG_ASSERT(numPrograms > 0);
+    for (int i = 0; i < numPrograms; ++i) {
+        m_programs.push_back(std::make_unique<ProgramPath>(
+                kDefaultSampleRate.value(), kDefaultLowFrequency, kDefaultHighFrequency));
+    }
+    for (int band = 0; band < kNumBands; ++band) {
+        mixxx::SampleBuffer(m_maxFrames).swap(m_gains[band]);
+        mixxx::SampleBuffer(kBlockSamples).swap(m_bandBuffers[band]);
+    }
+    updateTimeConstants();
+    reset();
+}
+
+EngineMultiBandCompressor::~EngineMultiBandCompressor() = default;
+
+void EngineMultiBandCompressor::setSampleRate(mixxx::audio::SampleRate sampleRate) {
+    VERIFY_OR_DEBUG_ASSERT(sampleRate.isValid()) {
+        return;
+    }
+    if (sampleRate == m_sampleRate) {
+        return;
+    }
+    m_sampleRate = sampleRate;
+    updateFilters();
+    updateTimeConstants();
+}
+
+void EngineMultiBandCompressor::setCrossoverFrequencies(
+        double lowFrequency, double highFrequency) {
+    VERIFY_OR_DEBUG_ASSERT(lowFrequency > 0 && lowFrequency < highFrequency) {
+        return;
+    }
+    if (lowFrequency == m_lowFrequency && highFrequency == m_highFrequency) {
+        return;
+    }
+    m_lowFrequency = lowFrequency;
+    m_highFrequency = highFrequency;
+    updateFilters();
+}
+
+void EngineMultiBandCompressor::setAttackMs(double attackMs) {
+    if (attackMs == m_attackMs) {
+        return;
+    }
+    m_attackMs = attackMs;
+    updateTimeConstants();
+}
+
+void EngineMultiBandCompressor::setReleaseMs(double releaseMs) {
+    if (releaseMs == m_releaseMs) {
+        return;
+    }
+    m_releaseMs = releaseMs;
+    updateTimeConstants();
+}
+
+void EngineMultiBandCompressor::setLookaheadMs(double lookaheadMs) {
+    if (lookaheadMs == m_lookaheadMs) {
+        return;
+    }
+    m_lookaheadMs = lookaheadMs;
+    updateTimeConstants();
+}
+
+void EngineMultiBandCompressor::setBandParameters(
+        int band, const BandParameters& parameters) {
+    VERIFY_OR_DEBUG_ASSERT(band >= 0 && band < kNumBands) {
+        return;
+    }
+    VERIFY_OR_DEBUG_ASSERT(parameters.threshold > 0 && parameters.ratio >= 1) {
+        return;
+    }
+    m_bandParameters[band] = parameters;
+}
+
+void EngineMultiBandCompressor::setBandsLinked(bool linked) {
+    m_bandsLinked = linked;
+}
+
+// static
+SINT EngineMultiBandCompressor::lookaheadFramesForMs(
+        double lookaheadMs, mixxx::audio::SampleRate sampleRate) {
+    return math_clamp(
+            static_cast<SINT>(std::lround(lookaheadMs * sampleRate.toDouble() / 1000)),
+            SINT(0),
+            kMaxLookaheadFrames);
+}
+
+void EngineMultiBandCompressor::updateFilters() {
+    const int sampleRate = static_cast<int>(m_sampleRate.value());
+    m_keySplitter.setFrequencies(sampleRate, m_lowFrequency, m_highFrequency);
+    for (const auto& pProgram : m_programs) {
+        pProgram->splitter.setFrequencies(sampleRate, m_lowFrequency, m_highFrequency);
+    }
+}
+
+void EngineMultiBandCompressor::updateTimeConstants() {
+    m_attackCoefficient = smoothingCoefficient(m_attackMs, m_sampleRate);
+    m_releaseCoefficient = smoothingCoefficient(m_releaseMs, m_sampleRate);
+    const SINT lookaheadFrames = lookaheadFramesForMs(m_lookaheadMs, m_sampleRate);
+    if (lookaheadFrames != m_lookaheadFrames) {
+        m_lookaheadFrames = lookaheadFrames;
+        // Don't output stale samples from a previous look-ahead time
+        for (const auto& pProgram : m_programs) {
+            pProgram->delayLine.fill(CSAMPLE_ZERO);
+        }
+    }
+}
+
+void EngineMultiBandCompressor::reset() {
+    m_keySplitter.reset();
+    for (const auto& pProgram : m_programs) {
+        pProgram->splitter.reset();
+        pProgram->delayLine.fill(CSAMPLE_ZERO);
+        pProgram->delayPos = 0;
+        pProgram->processing = false;
+        pProgram->crossfadeFrames = 0;
+    }
+    m_currentGains.fill(CSAMPLE_GAIN_ONE);
+    m_keyFrames = 0;
+    m_unityGains = true;
+}
+
+void EngineMultiBandCompressor::processKey(const CSAMPLE* pKey, SINT numSamples) {
+    const SINT numFrames = numSamples / kNumChannels;
+    VERIFY_OR_DEBUG_ASSERT(numFrames <= m_maxFrames) {
+        m_keyFrames = 0;
+        return;
+    }
+    if (m_bandsLinked) {
+        // One broadband level for all bands
+        CSAMPLE* pLevels = m_gains[Low].data();
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < numFrames; ++i) {
+            pLevels[i] = math_max(std::abs(pKey[i * kNumChannels]),
+                    std::abs(pKey[i * kNumChannels + 1]));
+        }
+        computeTargetGains(Low, 0, numFrames);
+        SampleUtil::copy(m_gains[Mid].data(), pLevels, numFrames);
+        SampleUtil::copy(m_gains[High].data(), pLevels, numFrames);
+        smoothGains(numFrames);
+        m_keyFrames = numFrames;
+        return;
+    }
+    for (SINT offset = 0; offset < numFrames; offset += kBlockFrames) {
+        const SINT blockFrames = math_min(kBlockFrames, numFrames - offset);
+        m_keySplitter.process(pKey + offset * kNumChannels,
+                m_bandBuffers[Low].data(),
+                m_bandBuffers[Mid].data(),
+                m_bandBuffers[High].data(),
+                m_tempBuffer.data(),
+                blockFrames * kNumChannels);
+        // Rectify: The level of a frame is the peak of both channels
+        for (int band = 0; band < kNumBands; ++band) {
+            const CSAMPLE* pBand = m_bandBuffers[band].data();
+            CSAMPLE* pLevels = m_gains[band].data() + offset;
+            // note: LOOP VECTORIZED.
+            for (SINT i = 0; i < blockFrames; ++i) {
+                pLevels[i] = math_max(std::abs(pBand[i * kNumChannels]),
+                        std::abs(pBand[i * kNumChannels + 1]));
+            }
+        }
+        for (int band = 0; band < kNumBands; ++band) {
+            computeTargetGains(band, offset, blockFrames);
+        }
+    }
+    smoothGains(numFrames);
+    m_keyFrames = numFrames;
+}
+
+void EngineMultiBandCompressor::processForcedKey(bool bAboveThreshold, SINT numSamples) {
+    const SINT numFrames = numSamples / kNumChannels;
+    VERIFY_OR_DEBUG_ASSERT(numFrames <= m_maxFrames) {
+        m_keyFrames = 0;
+        return;
+    }
+    for (int band = 0; band < kNumBands; ++band) {
+        const int parametersBand = m_bandsLinked ? Low : band;
+        const CSAMPLE_GAIN targetGain = bAboveThreshold
+                ? m_bandParameters[parametersBand].minimumGain
+                : CSAMPLE_GAIN_ONE;
+        SampleUtil::fill(m_gains[band].data(), targetGain, numFrames);
+    }
+    smoothGains(numFrames);
+    m_keyFrames = numFrames;
+}
+
+void EngineMultiBandCompressor::computeTargetGains(
+        int band, SINT offset, SINT numFrames) {
+    const BandParameters& parameters = m_bandParameters[band];
+    const CSAMPLE threshold = parameters.threshold;
+    const CSAMPLE_GAIN minimumGain = parameters.minimumGain;
+    CSAMPLE* pGains = m_gains[band].data() + offset;
+    if (parameters.gate) {
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < numFrames; ++i) {
+            pGains[i] = pGains[i] > threshold ? minimumGain : CSAMPLE_GAIN_ONE;
+        }
+    } else if (std::isinf(parameters.ratio)) {
+        // Limiting: The gain keeps the level at the threshold
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < numFrames; ++i) {
+            pGains[i] = math_max(threshold / math_max(pGains[i], threshold),
+                    minimumGain);
+        }
+    } else if (parameters.ratio > 1) {
+        // Every dB above the threshold is reduced to 1 / ratio dB
+        const CSAMPLE exponent = 1 / parameters.ratio - 1;
+        for (SINT i = 0; i < numFrames; ++i) {
+            pGains[i] = math_max(
+                    std::pow(math_max(pGains[i], threshold) / threshold, exponent),
+                    minimumGain);
+        }
+    } else {
+        SampleUtil::fill(pGains, CSAMPLE_GAIN_ONE, numFrames);
+    }
+}
+
+void EngineMultiBandCompressor::smoothGains(SINT numFrames) {
+    // The one pole recursion depends on the previous frame, so it can't be
+    // vectorized, but the bands are independent.
+    CSAMPLE_GAIN minimumGain = CSAMPLE_GAIN_ONE;
+    for (int band = 0; band < kNumBands; ++band) {
+        CSAMPLE* pGains = m_gains[band].data();
+        CSAMPLE_GAIN gain = m_currentGains[band];
+        for (SINT i = 0; i < numFrames; ++i) {
+            const CSAMPLE_GAIN targetGain = pGains[i];
+            const CSAMPLE_GAIN difference = targetGain - gain;
+            const CSAMPLE_GAIN coefficient = difference < 0
+                    ? m_attackCoefficient
+                    : m_releaseCoefficient;
+            gain = std::abs(difference) < kGainEpsilon
+                    ? targetGain
+                    : gain + difference * coefficient;
+            pGains[i] = gain;
+            minimumGain = math_min(minimumGain, gain);
+        }
+        m_currentGains[band] = gain;
+    }
+    m_unityGains = minimumGain == CSAMPLE_GAIN_ONE;
+}
+
+void EngineMultiBandCompressor::delayBlock(
+        ProgramPath* pPath, const CSAMPLE* pIn, CSAMPLE* pOut, SINT numFrames) {
+    if (m_lookaheadFrames == 0) {
+        if (pIn != pOut) {
+            SampleUtil::copy(pOut, pIn, numFrames * kNumChannels);
+        }
+        return;
+    }
+    constexpr SINT kDelayLineFrames = kMaxLookaheadFrames + 1;
+    CSAMPLE* pDelayLine = pPath->delayLine.data();
+    for (SINT i = 0; i < numFrames; ++i) {
+        SINT readPos = pPath->delayPos - m_lookaheadFrames;
+        if (readPos < 0) {
+            readPos += kDelayLineFrames;
+        }
+        // Write before reading, pIn and pOut may be the same buffer
+        for (int channel = 0; channel < kNumChannels; ++channel) {
+            pDelayLine[pPath->delayPos * kNumChannels + channel] =
+                    pIn[i * kNumChannels + channel];
+            pOut[i * kNumChannels + channel] =
+                    pDelayLine[readPos * kNumChannels + channel];
+        }
+        if (++pPath->delayPos == kDelayLineFrames) {
+            pPath->delayPos = 0;
+        }
+    }
+}
+
+void EngineMultiBandCompressor::processProgram(
+        int program, const CSAMPLE* pIn, CSAMPLE* pOut, SINT numSamples) {
+    VERIFY_OR_DEBUG_ASSERT(program >= 0 && program < static_cast<int>(m_programs.size())) {
+        return;
+    }
+    const SINT numFrames = numSamples / kNumChannels;
+    VERIFY_OR_DEBUG_ASSERT(numFrames <= m_keyFrames) {
+        // processKey has not been called for this buffer
+        if (pIn != pOut) {
+            SampleUtil::copy(pOut, pIn, numSamples);
+        }
+        return;
+    }
+    ProgramPath* pPath = m_programs[program].get();
+    const bool wet = !m_unityGains;
+    if (wet && !pPath->processing && !m_bandsLinked) {
+        // The filter states are outdated
+        pPath->splitter.reset();
+        pPath->processing = true;
+    }
+
+    for (SINT offset = 0; offset < numFrames; offset += kBlockFrames) {
+        const SINT blockFrames = math_min(kBlockFrames, numFrames - offset);
+        const SINT blockSamples = blockFrames * kNumChannels;
+        CSAMPLE* pBlockOut = pOut + offset * kNumChannels;
+        delayBlock(pPath, pIn + offset * kNumChannels, pBlockOut, blockFrames);
+        if (m_bandsLinked) {
+            if (wet) {
+                // All bands share the gains of the low band
+                const CSAMPLE* pGains = m_gains[Low].data() + offset;
+                // note: LOOP VECTORIZED.
+                for (SINT i = 0; i < blockFrames; ++i) {
+                    for (int channel = 0; channel < kNumChannels; ++channel) {
+                        pBlockOut[i * kNumChannels + channel] *= pGains[i];
+                    }
+                }
+            }
+            continue;
+        }
+        if (!pPath->processing) {
+            continue;
+        }
+
+        CSAMPLE* pLow = m_bandBuffers[Low].data();
+        CSAMPLE* pMid = m_bandBuffers[Mid].data();
+        CSAMPLE* pHigh = m_bandBuffers[High].data();
+        CSAMPLE* pProcessed = m_tempBuffer.data();
+        pPath->splitter.process(pBlockOut, pLow, pMid, pHigh, pProcessed, blockSamples);
+
+        const CSAMPLE* pLowGains = m_gains[Low].data() + offset;
+        const CSAMPLE* pMidGains = m_gains[Mid].data() + offset;
+        const CSAMPLE* pHighGains = m_gains[High].data() + offset;
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < blockFrames; ++i) {
+            for (int channel = 0; channel < kNumChannels; ++channel) {
+                const SINT sample = i * kNumChannels + channel;
+                pProcessed[sample] = pLow[sample] * pLowGains[i] +
+                        pMid[sample] * pMidGains[i] +
+                        pHigh[sample] * pHighGains[i];
+            }
+        }
+
+        if (wet && pPath->crossfadeFrames == kCrossfadeFrames) {
+            SampleUtil::copy(pBlockOut, pProcessed, blockSamples);
+            continue;
+        }
+        // Crossfade between the dry input in pBlockOut and the processed bands
+        const SINT step = wet ? 1 : -1;
+        for (SINT i = 0; i < blockFrames; ++i) {
+            pPath->crossfadeFrames = math_clamp(
+                    pPath->crossfadeFrames + step, SINT(0), kCrossfadeFrames);
+            const CSAMPLE_GAIN processedGain =
+                    static_cast<CSAMPLE_GAIN>(pPath->crossfadeFrames) / kCrossfadeFrames;
+            for (int channel = 0; channel < kNumChannels; ++channel) {
+                const SINT sample = i * kNumChannels + channel;
+                pBlockOut[sample] +=
+                        (pProcessed[sample] - pBlockOut[sample]) * processedGain;
+            }
+        }
+        if (pPath->crossfadeFrames == 0) {
+            pPath->processing = false;
+        }
+    }
+}
+
+void EngineMultiBandCompressor::process(const CSAMPLE* pIn, CSAMPLE* pOut, SINT numSamples) {
+    DEBUG_ASSERT(m_programs.size() == 1);
+    const SINT maxSamples = m_maxFrames * kNumChannels;
+    for (SINT offset = 0; offset < numSamples; offset += maxSamples) {
+        const SINT chunkSamples = math_min(maxSamples, numSamples - offset);
+        processKey(pIn + offset, chunkSamples);
+        processProgram(0, pIn + offset, pOut + offset, chunkSamples);
+    }
+}
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "engine/engine.h"
+#include "engine/filters/enginefilterlinkwitzriley4.h"
+#include "util/class.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+/// A per-sample, 3-band compressor with an optional sidechain key.
+///
+/// The key signal and each program signal are split into low, mid and high
+/// bands by Linkwitz-Riley 4th order crossovers. The high band is passed
+/// through an allpass matching the low crossover, so the unprocessed bands
+/// sum up to a flat magnitude response.
+///
+/// For every band, the peak level of each key frame is turned into a target
+/// gain: Above the threshold, the gain is reduced according to the ratio, but
+/// never below the minimum gain. The target gains are followed per sample
+/// with separate attack and release times. The program signals are delayed
+/// by the look-ahead time so the gain reduction can start before a transient
+/// of the key.
+///
+/// The rectification and the gain computer run on contiguous per-band
+/// buffers so the compiler can vectorize them. Only the attack/release
+/// smoothing is a serial recursion.
+///
+/// While all gains are at unity, the band splitting of a program is skipped
+/// and the (delayed) input is passed through bit-exact. The transitions
+/// between the dry input and the processed bands are crossfaded, because the
+/// crossover is an allpass and not a plain wire.
+///
+/// For a compressor that acts like a single band compressor, the bands can be
+/// linked. The gain is then computed from the broadband key and applied to
+/// the unsplit programs.
+///
+/// A compressor uses the program as key. For ducking, the key is a different
+/// signal (e.g. the microphones) and several programs (e.g. the output buses)
+/// can be ducked with the gains that have been computed for the same key:
+///     compressor.processKey(pTalkover, numSamples);
+///     compressor.processProgram(0, pBus0, pBus0, numSamples);
+///     compressor.processProgram(1, pBus1, pBus1, numSamples);
+class EngineMultiBandCompressor final {
+  public:
+    enum Band {
+        Low = 0,
+        Mid = 1,
+        High = 2,
+    };
+    static constexpr int kNumBands = 3;
+    static constexpr SINT kMaxLookaheadFrames = 2048;
+
+    struct BandParameters {
+        /// Linear key level above which the band is compressed
+        CSAMPLE threshold = CSAMPLE_ONE;
+        /// Compression ratio above the threshold, may be infinity
+        CSAMPLE ratio = CSAMPLE_ONE;
+        /// The lower bound of the gain of the band
+        CSAMPLE_GAIN minimumGain = CSAMPLE_GAIN_ZERO;
+        /// Above the threshold, the gain drops straight to the minimum gain
+        /// regardless of the ratio, like a ducker
+        bool gate = false;
+    };
+
+    /// maxFrames is the largest number of frames that can be passed to
+    /// processKey and processProgram. The convenience function process
+    /// accepts any size.
+    EngineMultiBandCompressor(SINT maxFrames, int numPrograms = 1);
+    ~EngineMultiBandCompressor();
+
+    /// Called from the audio thread. The setters only recalculate the
+    /// coefficients if the value has changed.
+    void setSampleRate(mixxx::audio::SampleRate sampleRate);
+    void setCrossoverFrequencies(double lowFrequency, double highFrequency);
+    void setAttackMs(double attackMs);
+    void setReleaseMs(double releaseMs);
+    void setLookaheadMs(double lookaheadMs);
+    void setBandParameters(int band, const BandParameters& parameters);
+    /// Linked bands share one gain that is computed from the broadband key
+    /// with the parameters of the low band, i.e. the programs are not split
+    /// into bands and keep their phase.
+    void setBandsLinked(bool linked);
+
+    /// The delay of the program signals, limited to kMaxLookaheadFrames
+    SINT getLookaheadFrames() const {
+        return m_lookaheadFrames;
+    }
+    static SINT lookaheadFramesForMs(double lookaheadMs,
+            mixxx::audio::SampleRate sampleRate);
+
+    /// The gain of the band after the last processed frame
+    CSAMPLE_GAIN getGain(int band) const {
+        return m_currentGains[band];
+    }
+
+    /// Clears the filters, the envelopes and the look-ahead buffers.
+    void reset();
+
+    /// Computes the per-sample gains of every band from the key signal.
+    void processKey(const CSAMPLE* pKey, SINT numSamples);
+    /// Computes the gains as if the key was far above (bAboveThreshold)
+    /// or below the threshold in all bands, e.g. for manual ducking.
+    void processForcedKey(bool bAboveThreshold, SINT numSamples);
+
+    /// Applies the gains of the last call to processKey to a program signal.
+    /// pIn and pOut may be the same buffer.
+    void processProgram(int program,
+            const CSAMPLE* pIn,
+            CSAMPLE* pOut,
+            SINT numSamples);
+
+    /// Compresses pIn with itself as key. Only for a single program.
+    void process(const CSAMPLE* pIn, CSAMPLE* pOut, SINT numSamples);
+
+  private:
+    static constexpr int kNumChannels = mixxx::kEngineChannelCount;
+    static constexpr SINT kBlockFrames = 256;
+    static constexpr SINT kBlockSamples = kBlockFrames * kNumChannels;
+    static constexpr SINT kCrossfadeFrames = 256;
+
+    /// Linkwitz-Riley crossover into 3 bands with phase compensation
+    class BandSplitter {
+      public:
+        BandSplitter(int sampleRate, double lowFrequency, double highFrequency);
+
+        void setFrequencies(int sampleRate, double lowFrequency, double highFrequency);
+        void reset();
+        /// Splits interleaved stereo samples. pIn must not alias any of the
+        /// band buffers, pTemp is a scratch buffer.
+        void process(const CSAMPLE* pIn,
+                CSAMPLE* pLow,
+                CSAMPLE* pMid,
+                CSAMPLE* pHigh,
+                CSAMPLE* pTemp,
+                SINT numSamples);
+
+      private:
+        EngineFilterLinkwitzRiley4Low m_lowLow;
+        EngineFilterLinkwitzRiley4High m_lowHigh;
+        EngineFilterLinkwitzRiley4Low m_highLow;
+        EngineFilterLinkwitzRiley4High m_highHigh;
+        // Allpass at the low crossover frequency for the high band
+        EngineFilterLinkwitzRiley4Low m_allpassLow;
+        EngineFilterLinkwitzRiley4High m_allpassHigh;
+    };
+
+    struct ProgramPath {
+        ProgramPath(int sampleRate, double lowFrequency, double highFrequency);
+
+        BandSplitter splitter;
+        // Interleaved look-ahead delay line
+        mixxx::SampleBuffer delayLine;
+        SINT delayPos;
+        // The splitter is running, the output is (partially) processed
+        bool processing;
+        // Position of the crossfade from dry (0) to processed
+        // (kCrossfadeFrames)
+        SINT crossfadeFrames;
+    };
+
+    void updateFilters();
+    void updateTimeConstants();
+    /// Turns the key levels of numFrames frames starting at frame offset
+    /// into target gains.
+    void computeTargetGains(int band, SINT offset, SINT numFrames);
+    /// Applies attack and release to the target gains of numFrames frames.
+    void smoothGains(SINT numFrames);
+    /// Delays a block of the program by the look-ahead time.
+    void delayBlock(ProgramPath* pPath, const CSAMPLE* pIn, CSAMPLE* pOut, SINT numFrames);
+
+    const SINT m_maxFrames;
+    mixxx::audio::SampleRate m_sampleRate;
+    double m_lowFrequency;
+    double m_highFrequency;
+    double m_attackMs;
+    double m_releaseMs;
+    double m_lookaheadMs;
+    SINT m_lookaheadFrames;
+    CSAMPLE_GAIN m_attackCoefficient;
+    CSAMPLE_GAIN m_releaseCoefficient;
+    std::array<BandParameters, kNumBands> m_bandParameters;
+    bool m_bandsLinked;
+
+    BandSplitter m_keySplitter;
+    std::vector<std::unique_ptr<ProgramPath>> m_programs;
+
+    // Key levels and afterwards gains of the last call to processKey,
+    // one value per frame and band
+    std::array<mixxx::SampleBuffer, kNumBands> m_gains;
+    std::array<CSAMPLE_GAIN, kNumBands> m_currentGains;
+    SINT m_keyFrames;
+    // All gains of the last call to processKey are at unity
+    bool m_unityGains;
+
+    // Scratch buffers for a block of interleaved samples
+    std::array<mixxx::SampleBuffer, kNumBands> m_bandBuffers;
+    mixxx::SampleBuffer m_tempBuffer;
+
+    DISALLOW_COPY_AND_ASSIGN(EngineMultiBandCompressor);
+};
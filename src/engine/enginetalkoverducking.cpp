@@ -1,22 +1,28 @@
 #include "engine/enginetalkoverducking.h"
 
+#include <limits>
+
 #include "control/controlproxy.h"
+#include "engine/channels/enginechannel.h"
 #include "moc_enginetalkoverducking.cpp"
+#include "util/defs.h"
 
 namespace {
 
 constexpr CSAMPLE kDuckThreshold = 0.1f;
+constexpr double kDuckAttackMs = 50;
+constexpr double kDuckReleaseMs = 500;
+// One output bus per crossfader orientation
+constexpr int kNumBuses = EngineChannel::RIGHT + 1;
 
 } // namespace
 
 EngineTalkoverDucking::EngineTalkoverDucking(
         UserSettingsPointer pConfig, const QString& group)
-        : EngineSideChainCompressor(group),
-          m_pConfig(pConfig),
-          m_group(group) {
+        : m_pConfig(pConfig),
+          m_group(group),
+          m_compressor(MAX_BUFFER_LEN / mixxx::kEngineChannelCount, kNumBuses) {
     m_pMasterSampleRate = new ControlProxy(m_group, "samplerate", this);
-    m_pMasterSampleRate->connectValueChanged(this, &EngineTalkoverDucking::slotSampleRateChanged,
-                                             Qt::DirectConnection);
 
     m_pDuckStrength = new ControlPotmeter(ConfigKey(m_group, "duckStrength"), 0.0, 1.0);
     m_pDuckStrength->set(
@@ -28,11 +34,12 @@ EngineTalkoverDucking::EngineTalkoverDucking(
     // We only allow the strength to be configurable for now.  The next most likely
     // candidate for customization is the threshold, which may be too low for
     // noisy club situations.
-    setParameters(
-            kDuckThreshold,
-            static_cast<CSAMPLE>(m_pDuckStrength->get()),
-            static_cast<unsigned int>(m_pMasterSampleRate->get() / 2 * .1),
-            static_cast<unsigned int>(m_pMasterSampleRate->get() / 2));
+    // Speech has most of its energy in the mid band, unlinked bands would
+    // mostly duck the mids of the music.
+    m_compressor.setBandsLinked(true);
+    m_compressor.setAttackMs(kDuckAttackMs);
+    m_compressor.setReleaseMs(kDuckReleaseMs);
+    updateParameters();
 
     m_pTalkoverDucking = new ControlPushButton(ConfigKey(m_group, "talkoverDucking"));
     m_pTalkoverDucking->setButtonMode(ControlPushButton::TOGGLE);
@@ -53,19 +60,8 @@ EngineTalkoverDucking::~EngineTalkoverDucking() {
     delete m_pTalkoverDucking;
 }
 
-void EngineTalkoverDucking::slotSampleRateChanged(double samplerate) {
-    setParameters(
-            kDuckThreshold,
-            static_cast<CSAMPLE>(m_pDuckStrength->get()),
-            static_cast<unsigned int>(samplerate / 2 * .1),
-            static_cast<unsigned int>(samplerate / 2));
-}
-
 void EngineTalkoverDucking::slotDuckStrengthChanged(double strength) {
-    setParameters(kDuckThreshold,
-            static_cast<CSAMPLE>(strength),
-            static_cast<unsigned int>(m_pMasterSampleRate->get() / 2 * .1),
-            static_cast<unsigned int>(m_pMasterSampleRate->get() / 2));
+    // The new strength is picked up by the next callback
     m_pConfig->set(ConfigKey(m_group, "duckStrength"), ConfigValue(strength * 100));
 }
 
@@ -73,16 +69,46 @@ void EngineTalkoverDucking::slotDuckModeChanged(double mode) {
    m_pConfig->set(ConfigKey(m_group, "duckMode"), ConfigValue(mode));
 }
 
-CSAMPLE EngineTalkoverDucking::getGain(int numFrames) {
-    // Apply microphone ducking.
+void EngineTalkoverDucking::updateParameters() {
+    const auto sampleRate = mixxx::audio::SampleRate::fromDouble(m_pMasterSampleRate->get());
+    if (sampleRate.isValid()) {
+        m_compressor.setSampleRate(sampleRate);
+    }
+    // Above the threshold, the gain drops to the ducking strength. The linked
+    // bands use the parameters of the low band.
+    const EngineMultiBandCompressor::BandParameters parameters{
+            kDuckThreshold,
+            std::numeric_limits<CSAMPLE>::infinity(),
+            static_cast<CSAMPLE_GAIN>(m_pDuckStrength->get()),
+            true};
+    m_compressor.setBandParameters(EngineMultiBandCompressor::Low, parameters);
+}
+
+void EngineTalkoverDucking::processKey(
+        const CSAMPLE* pTalkover, int iBufferSize, bool bTalkoverActive) {
+    updateParameters();
     switch (getMode()) {
     case EngineTalkoverDucking::OFF:
-        return 1.0f;
+        m_compressor.processForcedKey(false, iBufferSize);
+        break;
     case EngineTalkoverDucking::AUTO:
+        m_compressor.processKey(pTalkover, iBufferSize);
+        break;
     case EngineTalkoverDucking::MANUAL:
-        return static_cast<CSAMPLE>(calculateCompressedGain(numFrames));
+        m_compressor.processForcedKey(bTalkoverActive, iBufferSize);
+        break;
     default:
         DEBUG_ASSERT("!Unknown Ducking mode");
-        return 1.0f;
+        m_compressor.processForcedKey(false, iBufferSize);
+        break;
+    }
+}
+
+void EngineTalkoverDucking::process(int bus, CSAMPLE* pInOut, int iBufferSize) {
+    if (getMode() == EngineTalkoverDucking::OFF &&
+            m_compressor.getGain(EngineMultiBandCompressor::Low) == CSAMPLE_GAIN_ONE) {
+        // Fully released
+        return;
     }
+    m_compressor.processProgram(bus, pInOut, pInOut, iBufferSize);
 }
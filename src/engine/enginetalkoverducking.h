@@ -1,13 +1,17 @@
 #pragma once
 
-#include "engine/enginesidechaincompressor.h"
 #include "control/controlpotmeter.h"
 #include "control/controlpushbutton.h"
+#include "engine/enginemultibandcompressor.h"
 
 class ConfigValue;
 class ControlProxy;
 
-class EngineTalkoverDucking : public QObject, public EngineSideChainCompressor {
+/// Ducks the crossfader orientation buses while the microphones are active.
+/// The talkover mix is the sidechain key of a compressor with linked bands, so
+/// the ducking follows the microphones per sample, independent of the audio
+/// buffer size, and all frequencies of the music are ducked alike.
+class EngineTalkoverDucking : public QObject {
   Q_OBJECT
   public:
 
@@ -24,18 +28,27 @@ class EngineTalkoverDucking : public QObject, public EngineSideChainCompressor {
         return static_cast<TalkoverDuckSetting>(int(m_pTalkoverDucking->get()));
     }
 
-    CSAMPLE getGain(int numFrames);
+    /// Every callback, call this once with the talkover mix before
+    /// processing the buses. bTalkoverActive is used in MANUAL mode.
+    void processKey(const CSAMPLE* pTalkover, int iBufferSize, bool bTalkoverActive);
+
+    /// Applies the ducking to one of the crossfader orientation buses,
+    /// see EngineChannel::ChannelOrientation.
+    void process(int bus, CSAMPLE* pInOut, int iBufferSize);
 
   public slots:
-    void slotSampleRateChanged(double);
     void slotDuckStrengthChanged(double);
     void slotDuckModeChanged(double);
 
   private:
+    void updateParameters();
+
     UserSettingsPointer m_pConfig;
     const QString m_group;
 
     ControlProxy* m_pMasterSampleRate;
     ControlPotmeter* m_pDuckStrength;
     ControlPushButton* m_pTalkoverDucking;
+
+    EngineMultiBandCompressor m_compressor;
 };
@@ -36,6 +36,13 @@ EngineVuMeter::EngineVuMeter(const QString& group)
                                               0., 1.);
     m_ctrlPeakIndicatorR = new ControlPotmeter(ConfigKey(group, "PeakIndicatorR"),
                                               0., 1.);
+    // The meters are only displayed, don't notify the GUI from the engine thread
+    m_ctrlVuMeter->setDeferredNotification(true);
+    m_ctrlVuMeterL->setDeferredNotification(true);
+    m_ctrlVuMeterR->setDeferredNotification(true);
+    m_ctrlPeakIndicator->setDeferredNotification(true);
+    m_ctrlPeakIndicatorL->setDeferredNotification(true);
+    m_ctrlPeakIndicatorR->setDeferredNotification(true);
     // Initialize the calculation:
     reset();
 }
@@ -0,0 +1,313 @@
+#include "engine/filters/enginefilteroversampler.h"
+
+#include <cmath>
+
+#include "util/assert.h"
+#include "util/math.h"
+
+namespace {
+
+// The first stage has to separate the audible band from its image just
+// above the engine's Nyquist frequency and needs a steep filter. The
+// following stages only need to reject the images of an already band
+// limited signal, so much shorter filters are sufficient.
+constexpr int kFirstStageHalfLength = 12;
+constexpr int kOtherStagesHalfLength = 4;
+constexpr double kKaiserBeta = 7.0;
+
+// Modified Bessel function of the first kind, order 0. Only used for
+// designing the filters. std::cyl_bessel_i is not available on all
+// platforms we support.
+double besselI0(double x) {
+    const double halfX = x / 2;
+    double term = 1.0;
+    double sum = 1.0;
+    for (int k = 1; k < 64; ++k) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < sum * 1e-12) {
+            break;
+        }
+    }
+    return sum;
+}
+
+// Designs a Kaiser windowed half-band low pass with 4 * halfLength - 1 taps.
+// Besides the center tap of 0.5 only the taps at odd distances d = 2k + 1
+// from the center are non-zero. Returns these halfLength symmetric taps.
+template<int halfLength>
+std::array<CSAMPLE, halfLength> designHalfBand() {
+    std::array<double, halfLength> taps;
+    const double centerDistance = 2 * halfLength - 1;
+    double sum = 0;
+    for (int k = 0; k < halfLength; ++k) {
+        const double distance = 2 * k + 1;
+        const double ratio = distance / (centerDistance + 1);
+        const double window = besselI0(kKaiserBeta * std::sqrt(1 - ratio * ratio)) /
+                besselI0(kKaiserBeta);
+        // sin(pi * d / 2) / (pi * d / 2) * 0.5 with d odd
+        const double sinc = ((k % 2 == 0) ? 1.0 : -1.0) / (M_PI * distance);
+        taps[k] = sinc * window;
+        sum += taps[k];
+    }
+    // Normalize to unity gain at DC: 0.5 + 2 * sum(taps) = 1
+    std::array<CSAMPLE, halfLength> coefficients;
+    for (int k = 0; k < halfLength; ++k) {
+        coefficients[k] = static_cast<CSAMPLE>(taps[k] * 0.25 / sum);
+    }
+    return coefficients;
+}
+
+const CSAMPLE* firstStageCoefficients() {
+    static const auto kCoefficients = designHalfBand<kFirstStageHalfLength>();
+    return kCoefficients.data();
+}
+
+const CSAMPLE* otherStagesCoefficients() {
+    static const auto kCoefficients = designHalfBand<kOtherStagesHalfLength>();
+    return kCoefficients.data();
+}
+
+int numStagesForFactor(int factor) {
+    switch (factor) {
+    case 2:
+        return 1;
+    case 4:
+        return 2;
+    case 8:
+        return 3;
+    default:
+        return 0;
+    }
+}
+
+int halfLengthOfStage(int stage) {
+    return stage == 0 ? kFirstStageHalfLength : kOtherStagesHalfLength;
+}
+
+// The delay of all interpolators and decimators counted in samples at the
+// highest rate.
+int latencySamplesAtHighestRate(int numStages) {
+    int latency = 0;
+    for (int stage = 0; stage < numStages; ++stage) {
+        // Both the interpolator and the decimator of a stage delay by
+        // 2 * halfLength - 1 samples at the rate after interpolation.
+        const int stageDelay = 2 * (2 * halfLengthOfStage(stage) - 1);
+        latency += stageDelay << (numStages - stage - 1);
+    }
+    return latency;
+}
+
+} // anonymous namespace
+
+EngineFilterOversampler::EngineFilterOversampler()
+        : m_factor(1),
+          m_numStages(0),
+          m_latencyFrames(0),
+          m_paddingSamples(0),
+          m_oversampled(kMaxStageSamples * kNumChannels),
+          m_stageBuffer1(kMaxStageSamples),
+          m_stageBuffer2(kMaxStageSamples),
+          m_work1(kMaxStageSamples + kMaxHistoryLength),
+          m_work2(kMaxStageSamples + kMaxHistoryLength) {
+    for (auto& channelStages : m_stages) {
+        for (int stage = 0; stage < kMaxStages; ++stage) {
+            channelStages[stage].halfLength = halfLengthOfStage(stage);
+            channelStages[stage].pCoefficients = stage == 0
+                    ? firstStageCoefficients()
+                    : otherStagesCoefficients();
+        }
+    }
+    reset();
+}
+
+// static
+SINT EngineFilterOversampler::latencyFramesForFactor(int factor) {
+    const int numStages = numStagesForFactor(factor);
+    if (numStages == 0) {
+        return 0;
+    }
+    // Round up to whole frames at the engine rate
+    const int samplesPerFrame = 1 << numStages;
+    return (latencySamplesAtHighestRate(numStages) + samplesPerFrame - 1) / samplesPerFrame;
+}
+
+void EngineFilterOversampler::setFactor(int factor) {
+    VERIFY_OR_DEBUG_ASSERT(factor == 1 || numStagesForFactor(factor) > 0) {
+        factor = 1;
+    }
+    if (factor == m_factor) {
+        return;
+    }
+    m_factor = factor;
+    m_numStages = numStagesForFactor(factor);
+    m_latencyFrames = latencyFramesForFactor(factor);
+    m_paddingSamples = static_cast<int>(m_latencyFrames * m_factor) -
+            latencySamplesAtHighestRate(m_numStages);
+    DEBUG_ASSERT(m_paddingSamples >= 0 && m_paddingSamples < kMaxFactor);
+    reset();
+}
+
+void EngineFilterOversampler::reset() {
+    for (auto& channelStages : m_stages) {
+        for (auto& stage : channelStages) {
+            stage.upHistory.fill(CSAMPLE_ZERO);
+            stage.downEvenHistory.fill(CSAMPLE_ZERO);
+            stage.downOddHistory.fill(CSAMPLE_ZERO);
+        }
+    }
+    for (auto& history : m_paddingHistory) {
+        history.fill(CSAMPLE_ZERO);
+    }
+}
+
+void EngineFilterOversampler::upsample(const CSAMPLE* pIn, SINT numFrames) {
+    CSAMPLE* pOversampled = m_oversampled.data();
+    for (int channel = 0; channel < kNumChannels; ++channel) {
+        CSAMPLE* pStageIn = m_stageBuffer1.data();
+        CSAMPLE* pStageOut = m_stageBuffer2.data();
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < numFrames; ++i) {
+            pStageIn[i] = pIn[i * kNumChannels + channel];
+        }
+        SINT numSamples = numFrames;
+        for (int stage = 0; stage < m_numStages; ++stage) {
+            interpolate(&m_stages[channel][stage], pStageIn, pStageOut, numSamples);
+            numSamples *= 2;
+            std::swap(pStageIn, pStageOut);
+        }
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < numSamples; ++i) {
+            pOversampled[i * kNumChannels + channel] = pStageIn[i];
+        }
+    }
+}
+
+void EngineFilterOversampler::downsample(CSAMPLE* pOut, SINT numFrames) {
+    const CSAMPLE* pOversampled = m_oversampled.data();
+    const SINT numOversampledSamples = numFrames * m_factor;
+    for (int channel = 0; channel < kNumChannels; ++channel) {
+        CSAMPLE* pStageIn = m_stageBuffer1.data();
+        CSAMPLE* pStageOut = m_stageBuffer2.data();
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < numOversampledSamples; ++i) {
+            pStageIn[i] = pOversampled[i * kNumChannels + channel];
+        }
+        delayPadding(channel, pStageIn, numOversampledSamples);
+        SINT numSamples = numOversampledSamples;
+        for (int stage = m_numStages - 1; stage >= 0; --stage) {
+            numSamples /= 2;
+            decimate(&m_stages[channel][stage], pStageIn, pStageOut, numSamples);
+            std::swap(pStageIn, pStageOut);
+        }
+        DEBUG_ASSERT(numSamples == numFrames);
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < numFrames; ++i) {
+            pOut[i * kNumChannels + channel] = pStageIn[i];
+        }
+    }
+}
+
+void EngineFilterOversampler::interpolate(HalfBandStage* pStage,
+        const CSAMPLE* pIn,
+        CSAMPLE* pOut,
+        SINT numInputSamples) {
+    const int halfLength = pStage->halfLength;
+    const int historyLength = 2 * halfLength - 1;
+    const CSAMPLE* pCoefficients = pStage->pCoefficients;
+
+    // pWork[i + historyLength] is the input sample i
+    CSAMPLE* pWork = m_work1.data();
+    std::copy(pStage->upHistory.begin(),
+            pStage->upHistory.begin() + historyLength,
+            pWork);
+    SampleUtil::copy(pWork + historyLength, pIn, numInputSamples);
+
+    // The odd output samples only hit the center tap. With the gain of 2
+    // that compensates the zero stuffing, they are a delayed copy of the
+    // input. The even output samples are the dot product of the non-zero
+    // taps, which is computed tap by tap to get contiguous inner loops.
+    CSAMPLE* pEven = m_work2.data();
+    SampleUtil::clear(pEven, numInputSamples);
+    for (int k = 0; k < halfLength; ++k) {
+        const CSAMPLE coefficient = 2 * pCoefficients[k];
+        const CSAMPLE* pNewer = pWork + halfLength + k;
+        const CSAMPLE* pOlder = pWork + halfLength - 1 - k;
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < numInputSamples; ++i) {
+            pEven[i] += coefficient * (pNewer[i] + pOlder[i]);
+        }
+    }
+    const CSAMPLE* pCenter = pWork + halfLength;
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numInputSamples; ++i) {
+        pOut[2 * i] = pEven[i];
+        pOut[2 * i + 1] = pCenter[i];
+    }
+
+    std::copy(pWork + numInputSamples,
+            pWork + numInputSamples + historyLength,
+            pStage->upHistory.begin());
+}
+
+void EngineFilterOversampler::decimate(HalfBandStage* pStage,
+        const CSAMPLE* pIn,
+        CSAMPLE* pOut,
+        SINT numOutputSamples) {
+    const int halfLength = pStage->halfLength;
+    const int historyLength = 2 * halfLength - 1;
+    const CSAMPLE* pCoefficients = pStage->pCoefficients;
+
+    // Split the input into its even and odd polyphase components, each
+    // with its history prepended.
+    CSAMPLE* pEven = m_work1.data();
+    CSAMPLE* pOdd = m_work2.data();
+    std::copy(pStage->downEvenHistory.begin(),
+            pStage->downEvenHistory.begin() + historyLength,
+            pEven);
+    std::copy(pStage->downOddHistory.begin(),
+            pStage->downOddHistory.begin() + historyLength,
+            pOdd);
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numOutputSamples; ++i) {
+        pEven[historyLength + i] = pIn[2 * i];
+        pOdd[historyLength + i] = pIn[2 * i + 1];
+    }
+
+    // The odd polyphase component only hits the center tap
+    const CSAMPLE* pCenter = pOdd + halfLength - 1;
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numOutputSamples; ++i) {
+        pOut[i] = 0.5f * pCenter[i];
+    }
+    for (int k = 0; k < halfLength; ++k) {
+        const CSAMPLE coefficient = pCoefficients[k];
+        const CSAMPLE* pNewer = pEven + halfLength + k;
+        const CSAMPLE* pOlder = pEven + halfLength - 1 - k;
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < numOutputSamples; ++i) {
+            pOut[i] += coefficient * (pNewer[i] + pOlder[i]);
+        }
+    }
+
+    std::copy(pEven + numOutputSamples,
+            pEven + numOutputSamples + historyLength,
+            pStage->downEvenHistory.begin());
+    std::copy(pOdd + numOutputSamples,
+            pOdd + numOutputSamples + historyLength,
+            pStage->downOddHistory.begin());
+}
+
+void EngineFilterOversampler::delayPadding(int channel, CSAMPLE* pInOut, SINT numSamples) {
+    if (m_paddingSamples == 0) {
+        return;
+    }
+    // numSamples is always much larger than the padding
+    DEBUG_ASSERT(numSamples >= m_paddingSamples);
+    auto& history = m_paddingHistory[channel];
+    std::array<CSAMPLE, kMaxFactor> tail;
+    std::copy(pInOut + numSamples - m_paddingSamples, pInOut + numSamples, tail.begin());
+    std::copy_backward(pInOut, pInOut + numSamples - m_paddingSamples, pInOut + numSamples);
+    std::copy(history.begin(), history.begin() + m_paddingSamples, pInOut);
+    std::copy(tail.begin(), tail.begin() + m_paddingSamples, history.begin());
+}
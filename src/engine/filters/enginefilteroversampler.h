@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+
+#include "engine/engine.h"
+#include "util/sample.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+/// Runs a non-linear processing stage at 2x, 4x or 8x the engine sample rate
+/// to keep the harmonics it creates from aliasing back into the audible band.
+///
+/// Each factor of two is realized by a polyphase half-band FIR interpolator
+/// and decimator. Half of the coefficients of a half-band filter are zero and
+/// the remaining ones are symmetric, so each stage only needs halfLength
+/// multiplications per output sample. All loops work on planar,
+/// contiguous buffers so that the compiler can vectorize them.
+///
+/// The signal is delayed by getLatencyFrames() frames at the engine rate.
+/// The latency is always an integer number of frames, so the dry signal can
+/// be aligned with a simple delay line.
+///
+/// Usage:
+///     oversampler.setFactor(4);
+///     oversampler.process(pIn, pOut, numSamples,
+///             [](CSAMPLE* pOversampled, SINT numOversampledSamples) {
+///                 // Waveshape the interleaved stereo samples in place
+///             });
+class EngineFilterOversampler final {
+  public:
+    static constexpr int kMaxFactor = 8;
+    /// The input is processed in blocks of this many frames to keep the
+    /// internal buffers small and independent of the engine buffer size.
+    static constexpr SINT kBlockFrames = 128;
+
+    EngineFilterOversampler();
+
+    /// Accepts 1 (bypass), 2, 4 and 8. Changing the factor resets the
+    /// filter state.
+    void setFactor(int factor);
+    int getFactor() const {
+        return m_factor;
+    }
+
+    SINT getLatencyFrames() const {
+        return m_latencyFrames;
+    }
+    static SINT latencyFramesForFactor(int factor);
+
+    /// Clears the filter histories, e.g. when the effect is re-enabled.
+    void reset();
+
+    /// Upsamples the interleaved stereo pIn, calls processOversampled on
+    /// the upsampled interleaved stereo buffer and writes the downsampled
+    /// result to pOut. pIn and pOut may be the same buffer.
+    template<typename OversampledProcessor>
+    void process(const CSAMPLE* pIn,
+            CSAMPLE* pOut,
+            SINT numSamples,
+            OversampledProcessor processOversampled) {
+        if (m_factor == 1) {
+            if (pOut != pIn) {
+                SampleUtil::copy(pOut, pIn, numSamples);
+            }
+            processOversampled(pOut, numSamples);
+            return;
+        }
+        constexpr SINT kBlockSamples = kBlockFrames * mixxx::kEngineChannelCount;
+        for (SINT offset = 0; offset < numSamples; offset += kBlockSamples) {
+            const SINT blockFrames =
+                    math_min(kBlockSamples, numSamples - offset) /
+                    mixxx::kEngineChannelCount;
+            upsample(pIn + offset, blockFrames);
+            processOversampled(m_oversampled.data(),
+                    blockFrames * m_factor * mixxx::kEngineChannelCount);
+            downsample(pOut + offset, blockFrames);
+        }
+    }
+
+  private:
+    static constexpr int kNumChannels = mixxx::kEngineChannelCount;
+    static constexpr int kMaxStages = 3;
+    /// halfLength of the half-band filter of the first stage
+    static constexpr int kMaxHalfLength = 12;
+    static constexpr int kMaxHistoryLength = 2 * kMaxHalfLength - 1;
+    /// The samples of the largest planar block at the highest rate
+    static constexpr SINT kMaxStageSamples = kBlockFrames * kMaxFactor;
+
+    struct HalfBandStage {
+        int halfLength;
+        const CSAMPLE* pCoefficients;
+        // The last 2 * halfLength - 1 input samples of the interpolator
+        std::array<CSAMPLE, kMaxHistoryLength> upHistory;
+        // The last 2 * halfLength - 1 even and odd input samples of the
+        // decimator
+        std::array<CSAMPLE, kMaxHistoryLength> downEvenHistory;
+        std::array<CSAMPLE, kMaxHistoryLength> downOddHistory;
+    };
+
+    void upsample(const CSAMPLE* pIn, SINT numFrames);
+    void downsample(CSAMPLE* pOut, SINT numFrames);
+    void interpolate(HalfBandStage* pStage,
+            const CSAMPLE* pIn,
+            CSAMPLE* pOut,
+            SINT numInputSamples);
+    void decimate(HalfBandStage* pStage,
+            const CSAMPLE* pIn,
+            CSAMPLE* pOut,
+            SINT numOutputSamples);
+    void delayPadding(int channel, CSAMPLE* pInOut, SINT numSamples);
+
+    int m_factor;
+    int m_numStages;
+    SINT m_latencyFrames;
+    // Delay at the highest rate that rounds the latency up to whole frames
+    int m_paddingSamples;
+
+    std::array<std::array<HalfBandStage, kMaxStages>, kNumChannels> m_stages;
+    std::array<std::array<CSAMPLE, kMaxFactor>, kNumChannels> m_paddingHistory;
+
+    // Interleaved stereo at the oversampled rate, handed to the processor
+    mixxx::SampleBuffer m_oversampled;
+    // Planar ping-pong buffers for the cascaded stages
+    mixxx::SampleBuffer m_stageBuffer1;
+    mixxx::SampleBuffer m_stageBuffer2;
+    // Scratch buffers for a single stage: input with history prepended
+    mixxx::SampleBuffer m_work1;
+    mixxx::SampleBuffer m_work2;
+};
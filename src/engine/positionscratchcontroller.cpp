@@ -1,10 +1,20 @@
 #include "engine/positionscratchcontroller.h"
 
 #include <QtDebug>
+#include <algorithm>
 
 #include "engine/bufferscalers/enginebufferscale.h" // for MIN_SEEK_SPEED
 #include "moc_positionscratchcontroller.cpp"
+#include "util/inputtimestamp.h"
 #include "util/math.h"
+#include "util/time.h"
+
+namespace {
+
+// The rate is not low pass filtered for buffers longer than this, in seconds
+constexpr double kFilterBypassBufferDuration = 0.032;
+
+} // anonymous namespace
 
 class VelocityController {
   public:
@@ -74,9 +84,17 @@ PositionScratchController::PositionScratchController(const QString& group)
           m_dStartScratchPosition(0),
           m_dRate(0),
           m_dMoveDelay(0),
-          m_dMouseSampeTime(0) {
+          m_jogEvents(kMaxJogEvents),
+          m_jogTrajectorySize(0) {
     m_pScratchEnable = new ControlObject(ConfigKey(group, "scratch_position_enable"));
     m_pScratchPosition = new ControlObject(ConfigKey(group, "scratch_position"));
+    // Timestamp the positions when they are received instead of when the
+    // engine reads them, which might be up to a buffer later
+    connect(m_pScratchPosition,
+            &ControlObject::valueChanged,
+            this,
+            &PositionScratchController::slotScratchPositionChanged,
+            Qt::DirectConnection);
     m_pMasterSampleRate = ControlObject::getControl(ConfigKey("[Master]", "samplerate"));
     m_pVelocityController = new VelocityController();
     m_pRateIIFilter = new RateIIFilter;
@@ -99,7 +117,8 @@ void PositionScratchController::process(double currentSample, double releaseRate
 
     if (!m_bScratching && !scratchEnable) {
         // We were not previously in scratch mode are still not in scratch
-        // mode. Do nothing
+        // mode. Discard the jog events and do nothing else.
+        m_jogEvents.flushReadData(m_jogEvents.readAvailable());
         return;
     }
 
@@ -107,25 +126,30 @@ void PositionScratchController::process(double currentSample, double releaseRate
     const double dt = static_cast<double>(iBufferSize)
             / m_pMasterSampleRate->get() / 2;
 
-    // Sample Mouse with fixed timing intervals to iron out significant jitters
-    // that are added on the way from mouse to engine thread
-    // Normally the Mouse is sampled every 8 ms so with this 16 ms window we
-    // have 0 ... 3 samples. The remaining jitter is ironed by the following IIR
-    // lowpass filter
-    const double m_dMouseSampeIntervall = 0.016;
-    const auto callsPerDt = static_cast<int>(ceil(m_dMouseSampeIntervall / dt));
-    double scratchPosition = 0;
-    m_dMouseSampeTime += dt;
-    if (m_dMouseSampeTime >= m_dMouseSampeIntervall || !m_bScratching) {
-        scratchPosition = m_pScratchPosition->get();
-        m_dMouseSampeTime = 0;
+    // The jog events are interpolated with a delay of one buffer, i.e. the
+    // events that have been received during the last buffer are replayed
+    // with their original spacing. Otherwise the position would advance in
+    // steps of the events received per buffer, which is audible with large
+    // buffers.
+    const mixxx::Duration now = mixxx::Time::elapsed();
+    if (m_bScratching) {
+        receiveJogEvents();
+    } else {
+        resetJogTrajectory(now);
     }
 
+    // The jog events carry the time they have been received, so the jitter
+    // that is added on the way to the engine thread doesn't need to be
+    // ironed out by sampling them in a fixed, longer interval. The
+    // interpolated position is sampled every callback.
+    const double scratchPosition = interpolateScratchPosition(
+            now - mixxx::Duration::fromSeconds(dt));
+
     // Tweak PD controller for different latencies
     double p = 0.3;
     double d = p/-2;
     double f = 0.4;
-    if (dt > m_dMouseSampeIntervall * 2) {
+    if (dt > kFilterBypassBufferDuration) {
         f = 1;
     }
     m_pVelocityController->setPD(p, d);
@@ -181,59 +205,53 @@ void PositionScratchController::process(double currentSample, double releaseRate
             m_dPositionDeltaSum += (currentSample - m_dLastPlaypos) /
                     (iBufferSize * baserate);
 
-            // Continue with the last rate if we do not have a new
-            // Mouse position
-            if (m_dMouseSampeTime ==  0) {
-
-                // Set the scratch target to the current set position
-                // and normalize to one buffer
-                double targetDelta = (scratchPosition - m_dStartScratchPosition) /
-                        (iBufferSize * baserate);
-
-                bool calcRate = true;
-
-                if (m_dTargetDelta == targetDelta) {
-                    // we get here, if the next mouse position is delayed
-                    // the mouse is stopped or moves slow. Since we don't know the case
-                    // we assume delayed mouse updates for 40 ms
-                    m_dMoveDelay += dt * callsPerDt;
-                    if (m_dMoveDelay < 0.04) {
-                        // Assume a missing Mouse Update and continue with the
-                        // previously calculated rate.
-                        calcRate = false;
-                    } else {
-                        // Mouse has stopped
-                        m_pVelocityController->setPD(p, 0);
-                        if (targetDelta == 0) {
-                            // Mouse was not moved at all
-                            // Stop immediately by restarting the controller
-                            // in stopped mode
-                            m_pVelocityController->reset(0);
-                            m_pRateIIFilter->reset(0);
-                            m_dPositionDeltaSum = 0;
-                        }
-                    }
-                } else {
-                    m_dMoveDelay = 0;
-                    m_dTargetDelta = targetDelta;
-                }
+            // Set the scratch target to the current set position
+            // and normalize to one buffer
+            double targetDelta = (scratchPosition - m_dStartScratchPosition) /
+                    (iBufferSize * baserate);
 
-                if (calcRate) {
-                    double ctrlError = m_pRateIIFilter->filter(targetDelta - m_dPositionDeltaSum);
-                    m_dRate = m_pVelocityController->observation(ctrlError);
-                    m_dRate /= ceil(m_dMouseSampeIntervall/dt);
-                    // Note: The following SoundTouch changes the also rate by a ramp
-                    // This looks like average of the new and the old rate independent
-                    // from dt. Ramping is disabled when direction changes or rate = 0;
-                    // (determined experimentally)
-                    if (fabs(m_dRate) < MIN_SEEK_SPEED) {
-                        // we cannot get closer
-                        m_dRate = 0;
+            bool calcRate = true;
+
+            if (m_dTargetDelta == targetDelta) {
+                // we get here, if the next mouse position is delayed
+                // the mouse is stopped or moves slow. Since we don't know the case
+                // we assume delayed mouse updates for 40 ms
+                m_dMoveDelay += dt;
+                if (m_dMoveDelay < 0.04) {
+                    // Assume a missing Mouse Update and continue with the
+                    // previously calculated rate.
+                    calcRate = false;
+                } else {
+                    // Mouse has stopped
+                    m_pVelocityController->setPD(p, 0);
+                    if (targetDelta == 0) {
+                        // Mouse was not moved at all
+                        // Stop immediately by restarting the controller
+                        // in stopped mode
+                        m_pVelocityController->reset(0);
+                        m_pRateIIFilter->reset(0);
+                        m_dPositionDeltaSum = 0;
                     }
                 }
+            } else {
+                m_dMoveDelay = 0;
+                m_dTargetDelta = targetDelta;
+            }
 
-                //qDebug() << m_dRate << targetDelta << m_dPositionDeltaSum << dt;
+            if (calcRate) {
+                double ctrlError = m_pRateIIFilter->filter(targetDelta - m_dPositionDeltaSum);
+                m_dRate = m_pVelocityController->observation(ctrlError);
+                // Note: The following SoundTouch changes the also rate by a ramp
+                // This looks like average of the new and the old rate independent
+                // from dt. Ramping is disabled when direction changes or rate = 0;
+                // (determined experimentally)
+                if (fabs(m_dRate) < MIN_SEEK_SPEED) {
+                    // we cannot get closer
+                    m_dRate = 0;
+                }
             }
+
+            //qDebug() << m_dRate << targetDelta << m_dPositionDeltaSum << dt;
         } else {
             // We were previously in scratch mode and are no longer in scratch
             // mode. Disable everything, or optionally enable inertia mode if
@@ -258,7 +276,7 @@ void PositionScratchController::process(double currentSample, double releaseRate
             m_dMoveDelay = 0;
             // Set up initial values, in a way that the system is settled
             m_dRate = releaseRate;
-            m_dPositionDeltaSum = -(releaseRate / p) * callsPerDt; // Set to the remaining error of a p controller
+            m_dPositionDeltaSum = -(releaseRate / p); // Set to the remaining error of a p controller
             m_pVelocityController->reset(-m_dPositionDeltaSum);
             m_pRateIIFilter->reset(-m_dPositionDeltaSum);
             m_dStartScratchPosition = scratchPosition;
@@ -276,6 +294,64 @@ double PositionScratchController::getRate() {
     return m_dRate;
 }
 
+void PositionScratchController::slotScratchPositionChanged(double position) {
+    // Controllers might process their input with a delay
+    const JogEvent event{position, mixxx::InputTimestamp::current()};
+    const MMutexLocker locker(&m_jogEventsWriteMutex);
+    // Dropped if the engine is not running
+    m_jogEvents.write(&event, 1);
+}
+
+void PositionScratchController::receiveJogEvents() {
+    int available = m_jogEvents.readAvailable();
+    if (available > kMaxJogEvents - m_jogTrajectorySize) {
+        // Drop the oldest events to make room
+        const int dropCount = math_min(
+                available - (kMaxJogEvents - m_jogTrajectorySize),
+                m_jogTrajectorySize);
+        std::copy(m_jogTrajectory.begin() + dropCount,
+                m_jogTrajectory.begin() + m_jogTrajectorySize,
+                m_jogTrajectory.begin());
+        m_jogTrajectorySize -= dropCount;
+        available = math_min(available, kMaxJogEvents - m_jogTrajectorySize);
+    }
+    m_jogTrajectorySize += m_jogEvents.read(
+            m_jogTrajectory.data() + m_jogTrajectorySize, available);
+}
+
+void PositionScratchController::resetJogTrajectory(mixxx::Duration now) {
+    // The events before enabling scratching have already been applied
+    m_jogEvents.flushReadData(m_jogEvents.readAvailable());
+    m_jogTrajectory[0] = JogEvent{m_pScratchPosition->get(), now};
+    m_jogTrajectorySize = 1;
+}
+
+double PositionScratchController::interpolateScratchPosition(mixxx::Duration time) {
+    DEBUG_ASSERT(m_jogTrajectorySize > 0);
+    // Drop the events that are superseded by a later event before time,
+    // but keep one event to interpolate from
+    int first = 0;
+    while (first + 1 < m_jogTrajectorySize &&
+            m_jogTrajectory[first + 1].timestamp <= time) {
+        ++first;
+    }
+    if (first > 0) {
+        std::copy(m_jogTrajectory.begin() + first,
+                m_jogTrajectory.begin() + m_jogTrajectorySize,
+                m_jogTrajectory.begin());
+        m_jogTrajectorySize -= first;
+    }
+
+    const JogEvent& previous = m_jogTrajectory[0];
+    if (m_jogTrajectorySize == 1 || time <= previous.timestamp) {
+        return previous.position;
+    }
+    const JogEvent& next = m_jogTrajectory[1];
+    const double fraction = (time - previous.timestamp).toDoubleSeconds() /
+            (next.timestamp - previous.timestamp).toDoubleSeconds();
+    return previous.position + (next.position - previous.position) * fraction;
+}
+
 void PositionScratchController::notifySeek(mixxx::audio::FramePos position) {
     DEBUG_ASSERT(position.isValid());
     // scratching continues after seek due to calculating the relative distance traveled
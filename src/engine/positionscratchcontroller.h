@@ -2,9 +2,13 @@
 
 #include <QObject>
 #include <QString>
+#include <array>
 
 #include "audio/frame.h"
 #include "control/controlobject.h"
+#include "util/duration.h"
+#include "util/fifo.h"
+#include "util/mutex.h"
 
 class VelocityController;
 class RateIIFilter;
@@ -21,7 +25,29 @@ class PositionScratchController : public QObject {
     double getRate();
     void notifySeek(mixxx::audio::FramePos position);
 
+  private slots:
+    /// Invoked directly in the thread that has set the scratch position
+    void slotScratchPositionChanged(double position);
+
   private:
+    friend class PositionScratchControllerTest;
+
+    /// A scratch position with the time it has been received
+    struct JogEvent {
+        double position;
+        mixxx::Duration timestamp;
+    };
+
+    static constexpr int kMaxJogEvents = 128;
+
+    /// Moves the received jog events into m_jogTrajectory
+    void receiveJogEvents();
+    /// Restarts the trajectory at the current scratch position
+    void resetJogTrajectory(mixxx::Duration now);
+    /// Returns the scratch position at the given time, linearly interpolated
+    /// between the surrounding jog events
+    double interpolateScratchPosition(mixxx::Duration time);
+
     const QString m_group;
     ControlObject* m_pScratchEnable;
     ControlObject* m_pScratchPosition;
@@ -36,5 +62,13 @@ class PositionScratchController : public QObject {
     double m_dStartScratchPosition;
     double m_dRate;
     double m_dMoveDelay;
-    double m_dMouseSampeTime;
+
+    /// Written by the GUI and controller threads, read by the engine
+    FIFO<JogEvent> m_jogEvents;
+    /// Serializes the writers, the engine never locks
+    MMutex m_jogEventsWriteMutex;
+    /// The received jog events starting with the last event before the
+    /// time of the last interpolation. Only accessed by the engine.
+    std::array<JogEvent, kMaxJogEvents> m_jogTrajectory;
+    int m_jogTrajectorySize;
 };
@@ -43,6 +43,7 @@ InternalClock::InternalClock(const QString& group, SyncableListener* pEngineSync
     connect(m_pClockBeatDistance.data(), &ControlObject::valueChanged,
             this, &InternalClock::slotBeatDistanceChanged,
             Qt::DirectConnection);
+    m_pClockBeatDistance->setDeferredNotification(true);
 
     m_pSyncLeaderEnabled.reset(
             new ControlPushButton(ConfigKey(m_group, "sync_leader")));
@@ -5,6 +5,7 @@
 #include <QtConcurrentRun>
 #include <QtDebug>
 
+#include "library/coverartthumbnailpack.h"
 #include "library/coverartutils.h"
 #include "moc_coverartcache.cpp"
 #include "track/track.h"
@@ -180,6 +181,29 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
             signalWhenDone);
     DEBUG_ASSERT(!res.coverInfoUpdated);
 
+    // Thumbnails are only identified by image digests. Legacy hash
+    // values are too short for being used as a key.
+    const bool useThumbnailPack =
+            CoverArtThumbnailPack::thumbnailWidth(desiredWidth) > 0 &&
+            CoverArtThumbnailPack::isEnabled();
+    if (useThumbnailPack && !coverInfo.imageDigest().isEmpty()) {
+        QImage thumbnail = CoverArtThumbnailPack::load(
+                coverInfo.cacheKey(), desiredWidth);
+        if (!thumbnail.isNull()) {
+            // Neither load nor decode the original image
+            CoverInfo::LoadedImage loadedImage(CoverInfo::LoadedImage::Result::Ok);
+            loadedImage.image = std::move(thumbnail);
+            loadedImage.location = coverInfo.type == CoverInfo::FILE
+                    ? coverInfo.coverLocation
+                    : coverInfo.trackLocation;
+            res.coverArt = CoverArt(
+                    std::move(coverInfo),
+                    std::move(loadedImage),
+                    desiredWidth);
+            return res;
+        }
+    }
+
     auto loadedImage = coverInfo.loadImage(
             pTrack ? pTrack->getFileAccess().token() : SecurityTokenPointer());
     if (!loadedImage.image.isNull()) {
@@ -192,6 +216,10 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
             pTrack->setCoverInfo(coverInfo);
         }
 
+        if (useThumbnailPack && !coverInfo.imageDigest().isEmpty()) {
+            CoverArtThumbnailPack::store(coverInfo.cacheKey(), loadedImage.image);
+        }
+
         // Resize image to requested size
         if (desiredWidth > 0) {
             // Adjust the cover size according to the request
@@ -0,0 +1,381 @@
+#include "library/coverartthumbnailpack.h"
+
+#include <QBuffer>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPair>
+#include <QtEndian>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("CoverArtThumbnailPack");
+
+// "MXCT"
+constexpr quint32 kMagic = 0x4d584354;
+constexpr quint32 kVersion = 1;
+
+// Magic and version
+constexpr qint64 kFileHeaderSize = 8;
+
+// Cache key, thumbnail width, and the size of the encoded image
+constexpr qint64 kRecordHeaderSize = 16;
+
+// Compression artifacts are hardly visible in small thumbnails
+constexpr int kJpegQuality = 85;
+
+const Qt::TransformationMode kTransformationMode = Qt::SmoothTransformation;
+
+typedef QPair<mixxx::cache_key_t, int> ThumbnailId;
+
+struct ThumbnailLocation {
+    qint64 offset;
+    qint64 size;
+};
+
+QMutex s_mutex;
+QString s_filePath;
+qint64 s_maxFileSize = CoverArtThumbnailPack::kDefaultMaxFileSize;
+// Created lazily on first access
+std::unique_ptr<QFile> s_pFile;
+bool s_openFailed = false;
+uchar* s_pMappedData = nullptr;
+qint64 s_mappedSize = 0;
+// The end of the last valid record
+qint64 s_endOffset = 0;
+QHash<ThumbnailId, ThumbnailLocation> s_locations;
+CoverArtThumbnailPack::Metrics s_metrics;
+
+bool isThumbnailWidth(int width) {
+    return std::find(
+                   std::begin(CoverArtThumbnailPack::kThumbnailWidths),
+                   std::end(CoverArtThumbnailPack::kThumbnailWidths),
+                   width) != std::end(CoverArtThumbnailPack::kThumbnailWidths);
+}
+
+QByteArray encodeImage(const QImage& image) {
+    QByteArray encoded;
+    QBuffer buffer(&encoded);
+    if (!buffer.open(QIODevice::WriteOnly)) {
+        return QByteArray();
+    }
+    // JPEG does not support transparency
+    if (!image.hasAlphaChannel() && image.save(&buffer, "JPG", kJpegQuality)) {
+        return encoded;
+    }
+    buffer.seek(0);
+    encoded.clear();
+    if (image.save(&buffer, "PNG")) {
+        return encoded;
+    }
+    return QByteArray();
+}
+
+void appendRecord(
+        QByteArray* pRecords,
+        mixxx::cache_key_t cacheKey,
+        int width,
+        const QByteArray& encoded) {
+    char header[kRecordHeaderSize];
+    qToLittleEndian<quint64>(cacheKey, header);
+    qToLittleEndian<quint32>(static_cast<quint32>(width), header + 8);
+    qToLittleEndian<quint32>(static_cast<quint32>(encoded.size()), header + 12);
+    pRecords->append(header, kRecordHeaderSize);
+    pRecords->append(encoded);
+}
+
+void unmapLocked() {
+    if (s_pMappedData) {
+        DEBUG_ASSERT(s_pFile);
+        s_pFile->unmap(s_pMappedData);
+        s_pMappedData = nullptr;
+        s_mappedSize = 0;
+    }
+}
+
+void closeLocked() {
+    unmapLocked();
+    s_pFile.reset();
+    s_openFailed = false;
+    s_endOffset = 0;
+    s_locations.clear();
+}
+
+bool resetLocked() {
+    DEBUG_ASSERT(s_pFile);
+    unmapLocked();
+    s_locations.clear();
+    char header[kFileHeaderSize];
+    qToLittleEndian<quint32>(kMagic, header);
+    qToLittleEndian<quint32>(kVersion, header + 4);
+    if (!s_pFile->resize(0) ||
+            !s_pFile->seek(0) ||
+            s_pFile->write(header, kFileHeaderSize) != kFileHeaderSize) {
+        kLogger.warning()
+                << "Failed to reset pack file"
+                << s_pFile->fileName()
+                << s_pFile->errorString();
+        s_endOffset = 0;
+        return false;
+    }
+    s_endOffset = kFileHeaderSize;
+    return true;
+}
+
+/// Indexes all records and truncates the file after the
+/// last valid record
+bool scanLocked() {
+    DEBUG_ASSERT(s_pFile);
+    const qint64 fileSize = s_pFile->size();
+    char header[kRecordHeaderSize];
+    if (fileSize < kFileHeaderSize ||
+            !s_pFile->seek(0) ||
+            s_pFile->read(header, kFileHeaderSize) != kFileHeaderSize ||
+            qFromLittleEndian<quint32>(header) != kMagic ||
+            qFromLittleEndian<quint32>(header + 4) != kVersion) {
+        return resetLocked();
+    }
+    qint64 offset = kFileHeaderSize;
+    while (offset + kRecordHeaderSize <= fileSize) {
+        if (!s_pFile->seek(offset) ||
+                s_pFile->read(header, kRecordHeaderSize) != kRecordHeaderSize) {
+            break;
+        }
+        const auto cacheKey = qFromLittleEndian<quint64>(header);
+        const auto width = static_cast<int>(qFromLittleEndian<quint32>(header + 8));
+        const auto size = static_cast<qint64>(qFromLittleEndian<quint32>(header + 12));
+        const qint64 dataOffset = offset + kRecordHeaderSize;
+        if (!mixxx::isValidCacheKey(cacheKey) ||
+                !isThumbnailWidth(width) ||
+                size <= 0 ||
+                dataOffset + size > fileSize) {
+            break;
+        }
+        s_locations.insert(
+                ThumbnailId(cacheKey, width),
+                ThumbnailLocation{dataOffset, size});
+        offset = dataOffset + size;
+    }
+    if (offset < fileSize) {
+        kLogger.info()
+                << "Discarding"
+                << fileSize - offset
+                << "bytes of incomplete or corrupt thumbnails";
+        if (!s_pFile->resize(offset)) {
+            return resetLocked();
+        }
+    }
+    s_endOffset = offset;
+    return true;
+}
+
+bool openLocked() {
+    if (s_pFile) {
+        return true;
+    }
+    if (s_filePath.isEmpty() || s_openFailed) {
+        return false;
+    }
+    QDir().mkpath(QFileInfo(s_filePath).absolutePath());
+    s_pFile = std::make_unique<QFile>(s_filePath);
+    // Records are written with a single call and must be visible
+    // in the mapped memory immediately
+    if (!s_pFile->open(QIODevice::ReadWrite | QIODevice::Unbuffered) ||
+            !scanLocked()) {
+        kLogger.warning()
+                << "Failed to open pack file"
+                << s_filePath
+                << s_pFile->errorString();
+        s_pFile.reset();
+        s_openFailed = true;
+        return false;
+    }
+    kLogger.debug()
+            << "Opened pack file"
+            << s_filePath
+            << "with"
+            << s_locations.size()
+            << "thumbnails";
+    return true;
+}
+
+QByteArray readLocked(const ThumbnailLocation& location) {
+    DEBUG_ASSERT(s_pFile);
+    if (location.offset + location.size > s_mappedSize) {
+        // The file has grown since it has been mapped
+        unmapLocked();
+        s_pMappedData = s_pFile->map(0, s_endOffset);
+        if (s_pMappedData) {
+            s_mappedSize = s_endOffset;
+        }
+    }
+    if (s_pMappedData) {
+        return QByteArray(
+                reinterpret_cast<const char*>(s_pMappedData + location.offset),
+                static_cast<int>(location.size));
+    }
+    // Mapping might fail if the address space is exhausted
+    if (!s_pFile->seek(location.offset)) {
+        return QByteArray();
+    }
+    return s_pFile->read(location.size);
+}
+
+} // anonymous namespace
+
+// static
+void CoverArtThumbnailPack::setFilePath(
+        const QString& filePath,
+        qint64 maxFileSize) {
+    QMutexLocker locked(&s_mutex);
+    closeLocked();
+    s_filePath = filePath;
+    s_maxFileSize = maxFileSize;
+}
+
+// static
+bool CoverArtThumbnailPack::isEnabled() {
+    QMutexLocker locked(&s_mutex);
+    return !s_filePath.isEmpty();
+}
+
+// static
+int CoverArtThumbnailPack::thumbnailWidth(int desiredWidth) {
+    if (desiredWidth <= 0) {
+        return 0;
+    }
+    for (const int width : kThumbnailWidths) {
+        if (width >= desiredWidth) {
+            return width;
+        }
+    }
+    return 0;
+}
+
+// static
+QImage CoverArtThumbnailPack::load(
+        mixxx::cache_key_t cacheKey,
+        int desiredWidth) {
+    const int width = thumbnailWidth(desiredWidth);
+    if (width <= 0 || !mixxx::isValidCacheKey(cacheKey)) {
+        return QImage();
+    }
+    QByteArray encoded;
+    {
+        QMutexLocker locked(&s_mutex);
+        if (!openLocked()) {
+            return QImage();
+        }
+        const auto i = s_locations.constFind(ThumbnailId(cacheKey, width));
+        if (i == s_locations.constEnd()) {
+            ++s_metrics.missCount;
+            return QImage();
+        }
+        encoded = readLocked(i.value());
+    }
+    // Decode outside of the lock
+    QImage image;
+    const bool decoded = image.loadFromData(encoded);
+    {
+        QMutexLocker locked(&s_mutex);
+        if (decoded) {
+            ++s_metrics.hitCount;
+        } else {
+            ++s_metrics.missCount;
+        }
+    }
+    if (!decoded) {
+        kLogger.warning()
+                << "Failed to decode thumbnail"
+                << cacheKey
+                << width;
+        return QImage();
+    }
+    if (image.width() != desiredWidth) {
+        image = image.scaledToWidth(desiredWidth, kTransformationMode);
+    }
+    return image;
+}
+
+// static
+bool CoverArtThumbnailPack::store(
+        mixxx::cache_key_t cacheKey,
+        const QImage& image) {
+    if (!mixxx::isValidCacheKey(cacheKey) || image.isNull() || !isEnabled()) {
+        return false;
+    }
+    // Downscale and encode outside of the lock, each thumbnail
+    // from the previous, larger one. Images that are smaller
+    // than a thumbnail are stored in their original size.
+    QByteArray records;
+    QImage thumbnail = image;
+    for (auto i = std::rbegin(kThumbnailWidths); i != std::rend(kThumbnailWidths); ++i) {
+        const int width = *i;
+        if (thumbnail.width() > width) {
+            thumbnail = thumbnail.scaledToWidth(width, kTransformationMode);
+        }
+        const QByteArray encoded = encodeImage(thumbnail);
+        VERIFY_OR_DEBUG_ASSERT(!encoded.isEmpty()) {
+            return false;
+        }
+        appendRecord(&records, cacheKey, width, encoded);
+    }
+
+    QMutexLocker locked(&s_mutex);
+    if (!openLocked()) {
+        return false;
+    }
+    if (s_locations.contains(ThumbnailId(cacheKey, kThumbnailWidths[0]))) {
+        // Stored concurrently
+        return true;
+    }
+    if (s_endOffset + records.size() > s_maxFileSize) {
+        kLogger.info()
+                << "Clearing pack file after exceeding the maximum size of"
+                << s_maxFileSize
+                << "bytes";
+        if (!resetLocked()) {
+            return false;
+        }
+    }
+    if (!s_pFile->seek(s_endOffset) ||
+            s_pFile->write(records) != records.size()) {
+        kLogger.warning()
+                << "Failed to store thumbnails"
+                << s_pFile->errorString();
+        // Discard a partially written record
+        unmapLocked();
+        s_pFile->resize(s_endOffset);
+        return false;
+    }
+    qint64 offset = s_endOffset;
+    for (auto i = std::rbegin(kThumbnailWidths); i != std::rend(kThumbnailWidths); ++i) {
+        const auto size = static_cast<qint64>(qFromLittleEndian<quint32>(
+                records.constData() + (offset - s_endOffset) + 12));
+        s_locations.insert(
+                ThumbnailId(cacheKey, *i),
+                ThumbnailLocation{offset + kRecordHeaderSize, size});
+        offset += kRecordHeaderSize + size;
+    }
+    DEBUG_ASSERT(offset == s_endOffset + records.size());
+    s_endOffset = offset;
+    ++s_metrics.storedCount;
+    return true;
+}
+
+// static
+CoverArtThumbnailPack::Metrics CoverArtThumbnailPack::metrics() {
+    QMutexLocker locked(&s_mutex);
+    Metrics metrics = s_metrics;
+    metrics.fileSize = s_endOffset;
+    return metrics;
+}
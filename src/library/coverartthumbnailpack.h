@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QImage>
+#include <QString>
+
+#include "util/cache.h"
+
+/// Persists downscaled versions of cover art images in a single pack file,
+/// so library views could display covers without loading and decoding the
+/// original images, which are often embedded in the audio files.
+///
+/// Each image is stored as a pyramid with a fixed set of widths. Requests
+/// are served from the smallest thumbnail that is at least as wide as the
+/// desired width. Thumbnails are identified by the cache key of the image
+/// digest and never need to be invalidated.
+///
+/// New thumbnails are appended to the pack file that is memory-mapped for
+/// reading. The pack file is cleared when exceeding its maximum size.
+///
+/// All functions are thread-safe.
+class CoverArtThumbnailPack final {
+  public:
+    struct Metrics {
+        int hitCount = 0;
+        int missCount = 0;
+        int storedCount = 0;
+        qint64 fileSize = 0;
+    };
+
+    static constexpr int kThumbnailWidths[] = {64, 128, 256};
+
+    static constexpr qint64 kDefaultMaxFileSize = 256 * 1024 * 1024;
+
+    /// Called from the main thread at startup. An empty path disables the
+    /// pack, which is the default. Existing thumbnails are loaded lazily
+    /// on first access.
+    static void setFilePath(
+            const QString& filePath,
+            qint64 maxFileSize = kDefaultMaxFileSize);
+    static bool isEnabled();
+
+    /// The width of the thumbnail that is used for a desired width
+    /// or 0 if the desired width is not supported.
+    static int thumbnailWidth(int desiredWidth);
+
+    /// Returns a null image if no thumbnail is available. Otherwise
+    /// the returned image has the desired width.
+    static QImage load(
+            mixxx::cache_key_t cacheKey,
+            int desiredWidth);
+
+    /// Downscales the original image and stores all thumbnails.
+    static bool store(
+            mixxx::cache_key_t cacheKey,
+            const QImage& image);
+
+    static Metrics metrics();
+};
@@ -342,6 +342,9 @@ void TrackDAO::slotDatabaseTracksRelocated(const QList<RelocatedTrack>& relocate
     QSet<TrackId> removedTrackIds;
     QSet<TrackId> changedTrackIds;
     for (const auto& relocatedTrack : qAsConst(relocatedTracks)) {
+        // Don't keep decoders for the old location open
+        SoundSourceProxy::evictFromSoundSourcePool(
+                mixxx::FileInfo(relocatedTrack.deletedTrackLocation()));
         const auto changedTrackId = relocatedTrack.updatedTrackRef().getId();
         DEBUG_ASSERT(changedTrackId.isValid());
         DEBUG_ASSERT(!removedTrackIds.contains(changedTrackId));
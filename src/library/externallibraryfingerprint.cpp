@@ -0,0 +1,152 @@
+#include "library/externallibraryfingerprint.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+
+#include "library/dao/settingsdao.h"
+#include "util/logger.h"
+#include "util/xxhash64.h"
+
+namespace {
+
+const mixxx::Logger kLogger("ExternalLibraryFingerprint");
+
+const QChar kSeparator = QLatin1Char(' ');
+
+bool readFileMetadata(
+        const QString& filePath,
+        qint64* pLastModifiedMillis,
+        qint64* pSize) {
+    const QFileInfo fileInfo(filePath);
+    if (!fileInfo.exists() || !fileInfo.isFile()) {
+        return false;
+    }
+    *pLastModifiedMillis = fileInfo.lastModified().toMSecsSinceEpoch();
+    *pSize = fileInfo.size();
+    return true;
+}
+
+bool readFileDigest(
+        const QString& filePath,
+        quint64* pDigest) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        kLogger.warning()
+                << "Failed to open file"
+                << filePath
+                << file.errorString();
+        return false;
+    }
+    const qint64 size = file.size();
+    if (size == 0) {
+        *pDigest = mixxx::xxHash64("", 0);
+        return true;
+    }
+    // Mapping avoids copying the contents of large files
+    const uchar* pData = file.map(0, size);
+    if (pData) {
+        *pDigest = mixxx::xxHash64(pData, static_cast<std::size_t>(size));
+        file.unmap(const_cast<uchar*>(pData));
+        return true;
+    }
+    const QByteArray data = file.readAll();
+    if (data.size() != size) {
+        kLogger.warning()
+                << "Failed to read file"
+                << filePath
+                << file.errorString();
+        return false;
+    }
+    *pDigest = mixxx::xxHash64(data.constData(), data.size());
+    return true;
+}
+
+} // anonymous namespace
+
+// static
+ExternalLibraryFingerprint ExternalLibraryFingerprint::fromFile(
+        const QString& filePath) {
+    ExternalLibraryFingerprint fingerprint;
+    if (!readFileMetadata(filePath,
+                &fingerprint.m_lastModifiedMillis,
+                &fingerprint.m_size) ||
+            !readFileDigest(filePath, &fingerprint.m_digest)) {
+        return ExternalLibraryFingerprint();
+    }
+    fingerprint.m_filePath = filePath;
+    return fingerprint;
+}
+
+bool ExternalLibraryFingerprint::matchesFile(const QString& filePath) const {
+    if (!isValid() || filePath != m_filePath) {
+        return false;
+    }
+    qint64 lastModifiedMillis;
+    qint64 size;
+    if (!readFileMetadata(filePath, &lastModifiedMillis, &size)) {
+        return false;
+    }
+    if (size != m_size) {
+        return false;
+    }
+    if (lastModifiedMillis == m_lastModifiedMillis) {
+        return true;
+    }
+    quint64 digest;
+    if (!readFileDigest(filePath, &digest)) {
+        return false;
+    }
+    return digest == m_digest;
+}
+
+QString ExternalLibraryFingerprint::toString() const {
+    if (!isValid()) {
+        return QString();
+    }
+    // The file path might contain the separator and must be the last field
+    return QString::number(m_lastModifiedMillis) + kSeparator +
+            QString::number(m_size) + kSeparator +
+            QString::number(m_digest, 16) + kSeparator +
+            m_filePath;
+}
+
+// static
+ExternalLibraryFingerprint ExternalLibraryFingerprint::fromString(
+        const QString& str) {
+    ExternalLibraryFingerprint fingerprint;
+    bool lastModifiedValid = false;
+    bool sizeValid = false;
+    bool digestValid = false;
+    fingerprint.m_lastModifiedMillis =
+            str.section(kSeparator, 0, 0).toLongLong(&lastModifiedValid);
+    fingerprint.m_size =
+            str.section(kSeparator, 1, 1).toLongLong(&sizeValid);
+    fingerprint.m_digest =
+            str.section(kSeparator, 2, 2).toULongLong(&digestValid, 16);
+    fingerprint.m_filePath = str.section(kSeparator, 3);
+    if (!lastModifiedValid || !sizeValid || !digestValid) {
+        return ExternalLibraryFingerprint();
+    }
+    return fingerprint;
+}
+
+// static
+ExternalLibraryFingerprint ExternalLibraryFingerprint::load(
+        const QSqlDatabase& database,
+        const QString& settingsKey) {
+    return fromString(SettingsDAO(database).getValue(settingsKey));
+}
+
+bool ExternalLibraryFingerprint::save(
+        const QSqlDatabase& database,
+        const QString& settingsKey) const {
+    return SettingsDAO(database).setValue(settingsKey, toString());
+}
+
+// static
+bool ExternalLibraryFingerprint::reset(
+        const QSqlDatabase& database,
+        const QString& settingsKey) {
+    return SettingsDAO(database).setValue(settingsKey, QString());
+}
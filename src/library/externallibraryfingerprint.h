@@ -0,0 +1,81 @@
+#pragma once
+
+#include <QSqlDatabase>
+#include <QString>
+
+/// Identifies a revision of the library file of an external application,
+/// e.g. the iTunes XML or the Traktor NML, to detect if the file needs to
+/// be imported again.
+///
+/// Fingerprints consist of the file path, the modification time, the size
+/// and the XXH64 digest of the contents. They are persisted in the settings
+/// table of the library database.
+class ExternalLibraryFingerprint final {
+  public:
+    ExternalLibraryFingerprint()
+            : m_lastModifiedMillis(-1),
+              m_size(-1),
+              m_digest(0) {
+    }
+
+    /// Reads the whole file for calculating the digest. Returns an invalid
+    /// fingerprint if the file could not be read.
+    static ExternalLibraryFingerprint fromFile(const QString& filePath);
+
+    bool isValid() const {
+        return !m_filePath.isEmpty() && m_size >= 0;
+    }
+
+    const QString& filePath() const {
+        return m_filePath;
+    }
+    qint64 lastModifiedMillis() const {
+        return m_lastModifiedMillis;
+    }
+    qint64 size() const {
+        return m_size;
+    }
+    quint64 digest() const {
+        return m_digest;
+    }
+
+    /// Checks if the file has not been modified since the fingerprint has
+    /// been taken. The contents are only read if the modification time has
+    /// changed but not the size, e.g. if the application has rewritten the
+    /// file without any changes.
+    bool matchesFile(const QString& filePath) const;
+
+    QString toString() const;
+    static ExternalLibraryFingerprint fromString(const QString& str);
+
+    static ExternalLibraryFingerprint load(
+            const QSqlDatabase& database,
+            const QString& settingsKey);
+    bool save(
+            const QSqlDatabase& database,
+            const QString& settingsKey) const;
+    /// Forces a full import of the file on the next activation.
+    static bool reset(
+            const QSqlDatabase& database,
+            const QString& settingsKey);
+
+    friend bool operator==(
+            const ExternalLibraryFingerprint& lhs,
+            const ExternalLibraryFingerprint& rhs) {
+        return lhs.m_filePath == rhs.m_filePath &&
+                lhs.m_lastModifiedMillis == rhs.m_lastModifiedMillis &&
+                lhs.m_size == rhs.m_size &&
+                lhs.m_digest == rhs.m_digest;
+    }
+    friend bool operator!=(
+            const ExternalLibraryFingerprint& lhs,
+            const ExternalLibraryFingerprint& rhs) {
+        return !(lhs == rhs);
+    }
+
+  private:
+    QString m_filePath;
+    qint64 m_lastModifiedMillis;
+    qint64 m_size;
+    quint64 m_digest;
+};
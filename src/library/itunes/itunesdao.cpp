@@ -7,6 +7,7 @@
 #include "library/itunes/ituneslocalhosttoken.h"
 #include "library/itunes/itunespathmapping.h"
 #include "library/queryutil.h"
+#include "util/assert.h"
 
 std::ostream& operator<<(std::ostream& os, const ITunesTrack& track) {
     os << "ITunesTrack { "
@@ -36,20 +37,29 @@ std::ostream& operator<<(std::ostream& os, const ITunesPlaylist& playlist) {
 }
 
 void ITunesDAO::initialize(const QSqlDatabase& database) {
+    m_database = database;
     m_insertTrackQuery = QSqlQuery(database);
     m_insertPlaylistQuery = QSqlQuery(database);
+    m_updatePlaylistTreeQuery = QSqlQuery(database);
     m_insertPlaylistTrackQuery = QSqlQuery(database);
     m_applyPathMappingQuery = QSqlQuery(database);
 
+    // Rows are replaced when updating a previous import incrementally
     m_insertTrackQuery.prepare(
-            "INSERT INTO itunes_library (id, artist, title, album, "
+            "INSERT OR REPLACE INTO itunes_library (id, artist, title, album, "
             "album_artist, genre, grouping, year, duration, "
             "location, rating, comment, tracknumber, bpm, bitrate) "
             "VALUES (:id, :artist, :title, :album, :album_artist, "
             ":genre, :grouping, :year, :duration, :location, "
             ":rating, :comment, :tracknumber, :bpm, :bitrate)");
 
-    m_insertPlaylistQuery.prepare("INSERT INTO itunes_playlists (id, name) VALUES (:id, :name)");
+    m_insertPlaylistQuery.prepare(
+            "INSERT OR REPLACE INTO itunes_playlists (id, name, parent_id, "
+            "position) VALUES (:id, :name, :parent_id, :position)");
+
+    m_updatePlaylistTreeQuery.prepare(
+            "UPDATE itunes_playlists SET parent_id = :parent_id, "
+            "position = :position WHERE id = :id");
 
     m_insertPlaylistTrackQuery.prepare(
             "INSERT INTO itunes_playlist_tracks (playlist_id, track_id, "
@@ -62,47 +72,100 @@ void ITunesDAO::initialize(const QSqlDatabase& database) {
     m_isDatabaseInitialized = true;
 }
 
-bool ITunesDAO::importTrack(const ITunesTrack& track) {
-    if (m_isDatabaseInitialized) {
-        QSqlQuery& query = m_insertTrackQuery;
-
-        query.bindValue(":id", track.id);
-        query.bindValue(":artist", track.artist);
-        query.bindValue(":title", track.title);
-        query.bindValue(":album", track.album);
-        query.bindValue(":album_artist", track.albumArtist);
-        query.bindValue(":genre", track.genre);
-        query.bindValue(":grouping", track.grouping);
-        query.bindValue(":year", track.year > 0 ? QVariant(track.year) : QVariant());
-        query.bindValue(":duration", track.duration);
-        query.bindValue(":location", track.location);
-        query.bindValue(":rating", track.rating);
-        query.bindValue(":comment", track.comment);
-        query.bindValue(":tracknumber",
-                track.trackNumber > 0 ? QVariant(track.trackNumber) : QVariant());
-        query.bindValue(":bpm", track.bpm);
-        query.bindValue(":bitrate", track.bitrate);
+bool ITunesDAO::loadExistingRows() {
+    VERIFY_OR_DEBUG_ASSERT(m_isDatabaseInitialized) {
+        return false;
+    }
+    m_existingTracks.clear();
+    m_existingPlaylists.clear();
+
+    QSqlQuery trackQuery(m_database);
+    trackQuery.prepare(
+            "SELECT id, artist, title, album, album_artist, genre, grouping, "
+            "year, duration, location, rating, comment, tracknumber, bpm, "
+            "bitrate FROM itunes_library");
+    if (!trackQuery.exec()) {
+        LOG_FAILED_QUERY(trackQuery);
+        return false;
+    }
+    while (trackQuery.next()) {
+        ITunesTrack track = {
+                .id = trackQuery.value(0).toInt(),
+                .artist = trackQuery.value(1).toString(),
+                .title = trackQuery.value(2).toString(),
+                .album = trackQuery.value(3).toString(),
+                .albumArtist = trackQuery.value(4).toString(),
+                .genre = trackQuery.value(5).toString(),
+                .grouping = trackQuery.value(6).toString(),
+                .year = trackQuery.value(7).toInt(),
+                .duration = trackQuery.value(8).toInt(),
+                .location = trackQuery.value(9).toString(),
+                .rating = trackQuery.value(10).toInt(),
+                .comment = trackQuery.value(11).toString(),
+                .trackNumber = trackQuery.value(12).toInt(),
+                .bpm = trackQuery.value(13).toInt(),
+                .bitrate = trackQuery.value(14).toInt(),
+        };
+        m_existingTracks.insert(track.id, track);
+    }
 
-        if (!query.exec()) {
-            LOG_FAILED_QUERY(query);
-            return false;
-        }
+    QSqlQuery playlistQuery(m_database);
+    playlistQuery.prepare("SELECT id, name, parent_id, position FROM itunes_playlists");
+    if (!playlistQuery.exec()) {
+        LOG_FAILED_QUERY(playlistQuery);
+        return false;
+    }
+    while (playlistQuery.next()) {
+        PlaylistRow playlist;
+        playlist.name = playlistQuery.value(1).toString();
+        playlist.parentId = playlistQuery.value(2).toInt();
+        playlist.position = playlistQuery.value(3).toInt();
+        m_existingPlaylists.insert(playlistQuery.value(0).toInt(), playlist);
     }
 
+    m_isIncremental = !m_existingTracks.isEmpty() || !m_existingPlaylists.isEmpty();
     return true;
 }
 
-bool ITunesDAO::importPlaylist(const ITunesPlaylist& playlist) {
-    QString uniqueName = uniquifyPlaylistName(playlist.name);
+bool ITunesDAO::loadPlaylistTree() {
+    VERIFY_OR_DEBUG_ASSERT(m_isDatabaseInitialized) {
+        return false;
+    }
+    QSqlQuery query(m_database);
+    query.prepare("SELECT id, name, parent_id FROM itunes_playlists ORDER BY position");
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    while (query.next()) {
+        const int playlistId = query.value(0).toInt();
+        m_playlistNameById[playlistId] = query.value(1).toString();
+        m_playlistIdsByParentId.insert({query.value(2).toInt(), playlistId});
+    }
+    return true;
+}
 
+bool ITunesDAO::importTrack(const ITunesTrack& track) {
+    if (m_isIncremental) {
+        // Compared after parsing, when the path mapping is known
+        m_importedTracks.append(track);
+        return true;
+    }
     if (m_isDatabaseInitialized) {
-        QSqlQuery& query = m_insertPlaylistQuery;
+        return writeTrack(track);
+    }
+    return true;
+}
 
-        query.bindValue(":id", playlist.id);
-        query.bindValue(":name", uniqueName);
+bool ITunesDAO::importPlaylist(const ITunesPlaylist& playlist) {
+    QString uniqueName = uniquifyPlaylistName(playlist.name);
 
-        if (!query.exec()) {
-            LOG_FAILED_QUERY(query);
+    if (m_isIncremental) {
+        m_importedPlaylists[playlist.id].name = uniqueName;
+    } else if (m_isDatabaseInitialized) {
+        PlaylistRow row;
+        row.name = uniqueName;
+        if (!writePlaylist(playlist.id, row)) {
             return false;
         }
     }
@@ -114,10 +177,36 @@ bool ITunesDAO::importPlaylist(const ITunesPlaylist& playlist) {
 
 bool ITunesDAO::importPlaylistRelation(int parentId, int childId) {
     m_playlistIdsByParentId.insert({parentId, childId});
+    const int position = m_playlistCount++;
+
+    if (m_isIncremental) {
+        PlaylistRow& row = m_importedPlaylists[childId];
+        row.parentId = parentId;
+        row.position = position;
+    } else if (m_isDatabaseInitialized) {
+        // Persisted for restoring the tree without parsing the library
+        QSqlQuery& query = m_updatePlaylistTreeQuery;
+
+        query.bindValue(":id", childId);
+        query.bindValue(":parent_id", parentId);
+        query.bindValue(":position", position);
+
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+            return false;
+        }
+    }
+
     return true;
 }
 
 bool ITunesDAO::importPlaylistTrack(int playlistId, int trackId, int position) {
+    if (m_isIncremental) {
+        // The tracks are imported in order
+        DEBUG_ASSERT(m_importedPlaylistTracks.value(playlistId).size() == position - 1);
+        m_importedPlaylistTracks[playlistId].append(trackId);
+        return true;
+    }
     if (m_isDatabaseInitialized) {
         QSqlQuery& query = m_insertPlaylistTrackQuery;
 
@@ -135,11 +224,21 @@ bool ITunesDAO::importPlaylistTrack(int playlistId, int trackId, int position) {
 }
 
 bool ITunesDAO::applyPathMapping(const ITunesPathMapping& pathMapping) {
+    const QString iTunesPath =
+            QString(pathMapping.dbITunesRoot).replace(kiTunesLocalhostToken, "");
+    if (m_isIncremental) {
+        if (iTunesPath.isEmpty()) {
+            return true;
+        }
+        for (auto& track : m_importedTracks) {
+            track.location.replace(iTunesPath, pathMapping.mixxxITunesRoot);
+        }
+        return true;
+    }
     if (m_isDatabaseInitialized) {
-        QSqlQuery& query = m_insertPlaylistTrackQuery;
+        QSqlQuery& query = m_applyPathMappingQuery;
 
-        query.bindValue(":itunes_path",
-                QString(pathMapping.dbITunesRoot).replace(kiTunesLocalhostToken, ""));
+        query.bindValue(":itunes_path", iTunesPath);
         query.bindValue(":mixxx_path", pathMapping.mixxxITunesRoot);
 
         if (!query.exec()) {
@@ -151,6 +250,185 @@ bool ITunesDAO::applyPathMapping(const ITunesPathMapping& pathMapping) {
     return true;
 }
 
+bool ITunesDAO::finishImport() {
+    if (!m_isIncremental) {
+        return true;
+    }
+
+    int writtenTrackCount = 0;
+    for (const auto& track : qAsConst(m_importedTracks)) {
+        const auto existing = m_existingTracks.find(track.id);
+        if (existing != m_existingTracks.end()) {
+            const bool isUnchanged = existing.value() == track;
+            m_existingTracks.erase(existing);
+            if (isUnchanged) {
+                continue;
+            }
+        }
+        if (!writeTrack(track)) {
+            return false;
+        }
+        ++writtenTrackCount;
+    }
+    const int removedTrackCount = m_existingTracks.size();
+    for (auto it = m_existingTracks.constBegin(); it != m_existingTracks.constEnd(); ++it) {
+        if (!deleteTrack(it.key())) {
+            return false;
+        }
+    }
+
+    int writtenPlaylistCount = 0;
+    for (auto it = m_importedPlaylists.constBegin(); it != m_importedPlaylists.constEnd(); ++it) {
+        const int playlistId = it.key();
+        const QVector<int> trackIds = m_importedPlaylistTracks.value(playlistId);
+        const auto existing = m_existingPlaylists.find(playlistId);
+        const bool isNew = existing == m_existingPlaylists.end();
+        bool isChanged = isNew || existing.value() != it.value();
+        if (isChanged && !writePlaylist(playlistId, it.value())) {
+            return false;
+        }
+        if (!isNew) {
+            m_existingPlaylists.erase(existing);
+        }
+        if (isNew || loadPlaylistTracks(playlistId) != trackIds) {
+            if (!writePlaylistTracks(playlistId, trackIds)) {
+                return false;
+            }
+            isChanged = true;
+        }
+        if (isChanged) {
+            ++writtenPlaylistCount;
+        }
+    }
+    const int removedPlaylistCount = m_existingPlaylists.size();
+    for (auto it = m_existingPlaylists.constBegin(); it != m_existingPlaylists.constEnd(); ++it) {
+        if (!deletePlaylist(it.key())) {
+            return false;
+        }
+    }
+
+    qDebug() << "Updated iTunes library:"
+             << writtenTrackCount << "tracks written,"
+             << removedTrackCount << "tracks removed,"
+             << writtenPlaylistCount << "playlists written,"
+             << removedPlaylistCount << "playlists removed";
+
+    m_existingTracks.clear();
+    m_existingPlaylists.clear();
+    m_importedTracks.clear();
+    m_importedPlaylists.clear();
+    m_importedPlaylistTracks.clear();
+    return true;
+}
+
+bool ITunesDAO::writeTrack(const ITunesTrack& track) {
+    QSqlQuery& query = m_insertTrackQuery;
+
+    query.bindValue(":id", track.id);
+    query.bindValue(":artist", track.artist);
+    query.bindValue(":title", track.title);
+    query.bindValue(":album", track.album);
+    query.bindValue(":album_artist", track.albumArtist);
+    query.bindValue(":genre", track.genre);
+    query.bindValue(":grouping", track.grouping);
+    query.bindValue(":year", track.year > 0 ? QVariant(track.year) : QVariant());
+    query.bindValue(":duration", track.duration);
+    query.bindValue(":location", track.location);
+    query.bindValue(":rating", track.rating);
+    query.bindValue(":comment", track.comment);
+    query.bindValue(":tracknumber",
+            track.trackNumber > 0 ? QVariant(track.trackNumber) : QVariant());
+    query.bindValue(":bpm", track.bpm);
+    query.bindValue(":bitrate", track.bitrate);
+
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    return true;
+}
+
+bool ITunesDAO::writePlaylist(int playlistId, const PlaylistRow& playlist) {
+    // Replacing also removes a row with the same name that will either be
+    // renamed or removed afterwards
+    QSqlQuery& query = m_insertPlaylistQuery;
+
+    query.bindValue(":id", playlistId);
+    query.bindValue(":name", playlist.name);
+    query.bindValue(":parent_id", playlist.parentId);
+    query.bindValue(":position", playlist.position);
+
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    return true;
+}
+
+bool ITunesDAO::writePlaylistTracks(int playlistId, const QVector<int>& trackIds) {
+    QSqlQuery deleteQuery(m_database);
+    deleteQuery.prepare("DELETE FROM itunes_playlist_tracks WHERE playlist_id = :playlist_id");
+    deleteQuery.bindValue(":playlist_id", playlistId);
+    if (!deleteQuery.exec()) {
+        LOG_FAILED_QUERY(deleteQuery);
+        return false;
+    }
+
+    QSqlQuery& query = m_insertPlaylistTrackQuery;
+    for (int i = 0; i < trackIds.size(); ++i) {
+        query.bindValue(":playlist_id", playlistId);
+        query.bindValue(":track_id", trackIds[i]);
+        query.bindValue(":position", i + 1);
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ITunesDAO::deleteTrack(int trackId) {
+    QSqlQuery query(m_database);
+    query.prepare("DELETE FROM itunes_library WHERE id = :id");
+    query.bindValue(":id", trackId);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    return true;
+}
+
+bool ITunesDAO::deletePlaylist(int playlistId) {
+    if (!writePlaylistTracks(playlistId, {})) {
+        return false;
+    }
+    QSqlQuery query(m_database);
+    query.prepare("DELETE FROM itunes_playlists WHERE id = :id");
+    query.bindValue(":id", playlistId);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    return true;
+}
+
+QVector<int> ITunesDAO::loadPlaylistTracks(int playlistId) {
+    QVector<int> trackIds;
+    QSqlQuery query(m_database);
+    query.prepare(
+            "SELECT track_id FROM itunes_playlist_tracks "
+            "WHERE playlist_id = :playlist_id ORDER BY position");
+    query.bindValue(":playlist_id", playlistId);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return trackIds;
+    }
+    while (query.next()) {
+        trackIds.append(query.value(0).toInt());
+    }
+    return trackIds;
+}
+
 void ITunesDAO::appendPlaylistTree(gsl::not_null<TreeItem*> item, int playlistId) {
     auto childsRange = m_playlistIdsByParentId.equal_range(playlistId);
     std::for_each(childsRange.first,
@@ -4,6 +4,7 @@
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QString>
+#include <QVector>
 #include <gsl/pointers>
 #include <map>
 
@@ -75,35 +76,90 @@ std::ostream& operator<<(std::ostream& os, const ITunesPlaylist& playlist);
 /// A wrapper around the iTunes database tables. Keeps track of the
 /// playlist tree, deals with duplicate disambiguation and can export
 /// the tree afterwards.
+///
+/// Rows are inserted immediately while importing into empty tables. If
+/// the tables already contain a previous import of the library, only the
+/// differences are written by finishImport(), which leaves unchanged
+/// tracks and playlists untouched.
 class ITunesDAO : public DAO {
   public:
     ~ITunesDAO() override = default;
 
     void initialize(const QSqlDatabase& database) override;
 
+    /// Loads the rows of a previous import for updating them incrementally.
+    /// All imported tracks are kept in memory until finishImport().
+    bool loadExistingRows();
+    /// Restores the playlist tree of a previous import from the database
+    /// instead of importing the library again.
+    bool loadPlaylistTree();
+
     virtual bool importTrack(const ITunesTrack& track);
     virtual bool importPlaylist(const ITunesPlaylist& playlist);
     virtual bool importPlaylistRelation(int parentId, int childId);
     virtual bool importPlaylistTrack(int playlistId, int trackId, int position);
     virtual bool applyPathMapping(const ITunesPathMapping& pathMapping);
 
+    /// Writes the differences to the previous import and deletes the tracks
+    /// and playlists that have been removed from the library. Must only be
+    /// invoked if the whole library has been imported.
+    virtual bool finishImport();
+
     virtual void appendPlaylistTree(gsl::not_null<TreeItem*> item,
             int playlistId = kRootITunesPlaylistId);
 
+    bool isIncremental() const {
+        return m_isIncremental;
+    }
+
   private:
+    struct PlaylistRow {
+        QString name;
+        int parentId = kRootITunesPlaylistId;
+        int position = 0;
+
+        bool operator==(const PlaylistRow& other) const {
+            return name == other.name &&
+                    parentId == other.parentId &&
+                    position == other.position;
+        }
+        bool operator!=(const PlaylistRow& other) const {
+            return !(*this == other);
+        }
+    };
+
+    bool writeTrack(const ITunesTrack& track);
+    bool writePlaylist(int playlistId, const PlaylistRow& playlist);
+    bool writePlaylistTracks(int playlistId, const QVector<int>& trackIds);
+    bool deleteTrack(int trackId);
+    bool deletePlaylist(int playlistId);
+    QVector<int> loadPlaylistTracks(int playlistId);
+
     QHash<QString, int> m_playlistDuplicatesByName;
     QHash<int, QString> m_playlistNameById;
     std::multimap<int, int> m_playlistIdsByParentId;
+    int m_playlistCount = 0;
 
     // Keeps track of whether the database has been initialized.
     // In tests the database is not used, so the importer will
     // only be used to construct a TreeItem.
     bool m_isDatabaseInitialized = false;
 
+    // Set by loadExistingRows() if the tables are not empty
+    bool m_isIncremental = false;
+    QHash<int, ITunesTrack> m_existingTracks;
+    QHash<int, PlaylistRow> m_existingPlaylists;
+    QVector<ITunesTrack> m_importedTracks;
+    QHash<int, PlaylistRow> m_importedPlaylists;
+    QHash<int, QVector<int>> m_importedPlaylistTracks;
+
+    QSqlDatabase m_database;
+
     // Note that these queries reference the database, which is expected
     // to outlive the DAO.
     QSqlQuery m_insertTrackQuery;
     QSqlQuery m_insertPlaylistQuery;
+    QSqlQuery m_updatePlaylistTreeQuery;
     QSqlQuery m_insertPlaylistTrackQuery;
     QSqlQuery m_applyPathMappingQuery;
 
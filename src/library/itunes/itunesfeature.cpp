@@ -15,6 +15,7 @@
 #include "library/baseexternaltrackmodel.h"
 #include "library/basetrackcache.h"
 #include "library/dao/settingsdao.h"
+#include "library/externallibraryfingerprint.h"
 #include "library/itunes/itunesdao.h"
 #include "library/itunes/itunesimporter.h"
 #include "library/itunes/ituneslocalhosttoken.h"
@@ -35,6 +36,7 @@
 namespace {
 
 const QString kItdbPathKey = "mixxx.itunesfeature.itdbpath";
+const QString kItdbFingerprintKey = "mixxx.itunesfeature.itdbfingerprint";
 
 bool isMacOSImporterAvailable() {
 #ifdef __MACOS_ITUNES_LIBRARY__
@@ -167,14 +169,6 @@ void ITunesFeature::activate() {
 void ITunesFeature::activate(bool forceReload) {
     //qDebug("ITunesFeature::activate()");
     if (!m_isActivated || forceReload) {
-
-        //Delete all table entries of iTunes feature
-        ScopedTransaction transaction(m_database);
-        clearTable("itunes_playlist_tracks");
-        clearTable("itunes_library");
-        clearTable("itunes_playlists");
-        transaction.commit();
-
         emit showTrackModel(m_pITunesTrackModel);
 
         SettingsDAO settings(m_pTrackCollection->database());
@@ -212,6 +206,19 @@ void ITunesFeature::activate(bool forceReload) {
                 settings.setValue(kItdbPathKey, m_dbfile);
             }
         }
+
+        // The XML importer only updates the tables incrementally, unless a
+        // full import has been requested explicitly
+        if (forceReload || isMacOSImporterUsed()) {
+            // Delete all table entries of iTunes feature
+            ScopedTransaction transaction(m_database);
+            clearTable("itunes_playlist_tracks");
+            clearTable("itunes_library");
+            clearTable("itunes_playlists");
+            ExternalLibraryFingerprint::reset(m_database, kItdbFingerprintKey);
+            transaction.commit();
+        }
+
         m_isActivated =  true;
         // Let a worker thread do the XML parsing
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
@@ -315,6 +322,8 @@ std::unique_ptr<ITunesImporter> ITunesFeature::makeImporter() {
     }
 #endif
     qDebug() << "Using ITunesXMLImporter to read iTunes library from " << m_dbfile;
+    // Only the differences to a previous import will be written
+    dao->loadExistingRows();
     return std::make_unique<ITunesXMLImporter>(this, m_dbfile, m_cancelImport, std::move(dao));
 }
 
@@ -327,11 +336,27 @@ TreeItem* ITunesFeature::importLibrary() {
 
     qDebug() << "ITunesFeature::importLibrary() ";
 
+    ExternalLibraryFingerprint fingerprint;
+    if (!isMacOSImporterUsed()) {
+        if (ExternalLibraryFingerprint::load(m_database, kItdbFingerprintKey)
+                        .matchesFile(m_dbfile)) {
+            qDebug() << "iTunes library has not been modified since the last import";
+            return restorePlaylistTree();
+        }
+        fingerprint = ExternalLibraryFingerprint::fromFile(m_dbfile);
+    }
+
     ScopedTransaction transaction(m_database);
 
     std::unique_ptr<ITunesImporter> importer = makeImporter();
     ITunesImport iTunesImport = importer->importLibrary();
 
+    if (fingerprint.isValid() && !iTunesImport.hasError && !m_cancelImport.load()) {
+        fingerprint.save(m_database, kItdbFingerprintKey);
+    } else {
+        ExternalLibraryFingerprint::reset(m_database, kItdbFingerprintKey);
+    }
+
     // Even if an error occurred, commit the transaction. The file may have been
     // half-parsed.
     transaction.commit();
@@ -339,6 +364,17 @@ TreeItem* ITunesFeature::importLibrary() {
     return iTunesImport.playlistRoot.release();
 }
 
+TreeItem* ITunesFeature::restorePlaylistTree() {
+    ITunesDAO dao;
+    dao.initialize(m_database);
+    if (!dao.loadPlaylistTree()) {
+        return nullptr;
+    }
+    std::unique_ptr<TreeItem> pRootItem = TreeItem::newRoot(this);
+    dao.appendPlaylistTree(pRootItem.get());
+    return pRootItem.release();
+}
+
 void ITunesFeature::clearTable(const QString& table_name) {
     QSqlQuery query(m_database);
     query.prepare("delete from "+table_name);
@@ -45,6 +45,8 @@ class ITunesFeature : public BaseExternalLibraryFeature {
     std::unique_ptr<ITunesImporter> makeImporter();
     // returns the invisible rootItem for the sidebar model
     TreeItem* importLibrary();
+    /// Returns the playlist tree of the previous import
+    TreeItem* restorePlaylistTree();
     void clearTable(const QString& table_name);
 
     /// Presents an 'open file' dialog for selecting an iTunes library XML and
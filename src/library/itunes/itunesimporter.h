@@ -6,6 +6,8 @@
 
 struct ITunesImport {
     std::unique_ptr<TreeItem> playlistRoot;
+    /// Set if the library could only be imported partially
+    bool hasError = false;
 };
 
 class ITunesImporter {
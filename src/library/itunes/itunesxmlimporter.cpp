@@ -21,25 +21,112 @@
 
 namespace {
 
-const QString kDict = "dict";
-const QString kKey = "key";
-const QString kTrackId = "Track ID";
-const QString kName = "Name";
-const QString kArtist = "Artist";
-const QString kAlbum = "Album";
-const QString kAlbumArtist = "Album Artist";
-const QString kGenre = "Genre";
-const QString kGrouping = "Grouping";
-const QString kBPM = "BPM";
-const QString kBitRate = "Bit Rate";
-const QString kComments = "Comments";
-const QString kTotalTime = "Total Time";
-const QString kYear = "Year";
-const QString kLocation = "Location";
-const QString kTrackNumber = "Track Number";
-const QString kRating = "Rating";
-const QString kTrackType = "Track Type";
-const QString kRemote = "Remote";
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+using XmlStringView = QStringView;
+#else
+using XmlStringView = QStringRef;
+#endif
+
+const QLatin1String kDict("dict");
+const QLatin1String kKey("key");
+const QLatin1String kArray("array");
+const QLatin1String kFalse("false");
+const QLatin1String kRemote("Remote");
+
+/// The keys of the library, track and playlist dictionaries that are
+/// imported. All other keys are skipped.
+enum class Key {
+    Unknown,
+    MusicFolder,
+    Tracks,
+    Playlists,
+    TrackId,
+    Name,
+    Artist,
+    Album,
+    AlbumArtist,
+    Genre,
+    Grouping,
+    BPM,
+    BitRate,
+    Comments,
+    TotalTime,
+    Year,
+    Location,
+    TrackNumber,
+    Rating,
+    TrackType,
+    PlaylistId,
+    PlaylistPersistentId,
+    ParentPersistentId,
+    DistinguishedKind,
+    Visible,
+    PlaylistItems,
+};
+
+const struct {
+    QLatin1String text;
+    Key key;
+} kKeys[] = {
+        {QLatin1String("Music Folder"), Key::MusicFolder},
+        {QLatin1String("Tracks"), Key::Tracks},
+        {QLatin1String("Playlists"), Key::Playlists},
+        {QLatin1String("Track ID"), Key::TrackId},
+        {QLatin1String("Name"), Key::Name},
+        {QLatin1String("Artist"), Key::Artist},
+        {QLatin1String("Album"), Key::Album},
+        {QLatin1String("Album Artist"), Key::AlbumArtist},
+        {QLatin1String("Genre"), Key::Genre},
+        {QLatin1String("Grouping"), Key::Grouping},
+        {QLatin1String("BPM"), Key::BPM},
+        {QLatin1String("Bit Rate"), Key::BitRate},
+        {QLatin1String("Comments"), Key::Comments},
+        {QLatin1String("Total Time"), Key::TotalTime},
+        {QLatin1String("Year"), Key::Year},
+        {QLatin1String("Location"), Key::Location},
+        {QLatin1String("Track Number"), Key::TrackNumber},
+        {QLatin1String("Rating"), Key::Rating},
+        {QLatin1String("Track Type"), Key::TrackType},
+        {QLatin1String("Playlist ID"), Key::PlaylistId},
+        {QLatin1String("Playlist Persistent ID"), Key::PlaylistPersistentId},
+        {QLatin1String("Parent Persistent ID"), Key::ParentPersistentId},
+        {QLatin1String("Distinguished Kind"), Key::DistinguishedKind},
+        {QLatin1String("Visible"), Key::Visible},
+        {QLatin1String("Playlist Items"), Key::PlaylistItems},
+};
+
+Key keyFromText(XmlStringView text) {
+    for (const auto& key : kKeys) {
+        if (text == key.text) {
+            return key.key;
+        }
+    }
+    return Key::Unknown;
+}
+
+/// Reads the current <key> element. The text is only compared in place,
+/// because allocating a QString for each of the many keys of a track is
+/// a major cost when parsing large libraries.
+Key readKey(QXmlStreamReader& xml) {
+    Key key = Key::Unknown;
+    bool isFirstText = true;
+    while (xml.readNext() == QXmlStreamReader::Characters) {
+        // None of the imported keys contain entities that would split the text
+        key = isFirstText ? keyFromText(xml.text()) : Key::Unknown;
+        isFirstText = false;
+    }
+    return key;
+}
+
+/// Reads the text of the current element as an integer without
+/// allocating a QString.
+int readIntElement(QXmlStreamReader& xml) {
+    int value = 0;
+    while (xml.readNext() == QXmlStreamReader::Characters) {
+        value = xml.text().toInt();
+    }
+    return value;
+}
 
 } // anonymous namespace
 
@@ -76,18 +163,18 @@ ITunesImport ITunesXMLImporter::importLibrary() {
     while (!m_xml.atEnd() && !m_cancelImport.load()) {
         m_xml.readNext();
         if (m_xml.isStartElement()) {
-            if (m_xml.name() == QLatin1String("key")) {
-                QString key = m_xml.readElementText();
-                if (key == "Music Folder") {
+            if (m_xml.name() == kKey) {
+                const Key key = readKey(m_xml);
+                if (key == Key::MusicFolder) {
                     if (isTracksParsed) {
                         isMusicFolderLocatedAfterTracks = true;
                     }
                     if (readNextStartElement()) {
                         guessMusicLibraryMountpoint();
                     }
-                } else if (key == "Tracks") {
+                } else if (key == Key::Tracks) {
                     parseTracks();
-                } else if (key == "Playlists") {
+                } else if (key == Key::Playlists) {
                     parsePlaylists();
 
                     // The parent feature may ne null during testing
@@ -109,6 +196,7 @@ ITunesImport ITunesXMLImporter::importLibrary() {
         qDebug() << "line:" << m_xml.lineNumber()
                  << "column:" << m_xml.columnNumber()
                  << "error:" << m_xml.errorString();
+        iTunesImport.hasError = true;
     }
 
     if (isMusicFolderLocatedAfterTracks) {
@@ -120,6 +208,14 @@ ITunesImport ITunesXMLImporter::importLibrary() {
         m_dao->applyPathMapping(m_pathMapping);
     }
 
+    // Tracks and playlists that are missing from an incomplete file must
+    // not be removed from a previous import
+    if (!iTunesImport.hasError && !m_cancelImport.load()) {
+        if (!m_dao->finishImport()) {
+            iTunesImport.hasError = true;
+        }
+    }
+
     return iTunesImport;
 }
 
@@ -249,7 +345,7 @@ void ITunesXMLImporter::parseTrack() {
     QString artist;
     QString album;
     QString albumArtist;
-    QString year;
+    int year = 0;
     QString genre;
     QString grouping;
     QString location;
@@ -261,100 +357,88 @@ void ITunesXMLImporter::parseTrack() {
     int playtime = 0;
     int rating = 0;
     QString comment;
-    QString tracknumber;
-    QString tracktype;
+    int tracknumber = 0;
+    bool isRemote = false;
 
     while (!m_xml.atEnd()) {
         m_xml.readNext();
 
         if (m_xml.isStartElement()) {
             if (m_xml.name() == kKey) {
-                QString key = m_xml.readElementText();
-
-                QString content;
-                if (readNextStartElement()) {
-                    content = m_xml.readElementText();
+                const Key key = readKey(m_xml);
+                if (!readNextStartElement()) {
+                    break;
                 }
 
-                // qDebug() << "Key: " << key << " Content: " << content;
-
-                if (key == kTrackId) {
-                    id = content.toInt();
-                    continue;
-                }
-                if (key == kName) {
-                    title = content;
-                    continue;
-                }
-                if (key == kArtist) {
-                    artist = content;
-                    continue;
-                }
-                if (key == kAlbum) {
-                    album = content;
-                    continue;
-                }
-                if (key == kAlbumArtist) {
-                    albumArtist = content;
-                    continue;
-                }
-                if (key == kGenre) {
-                    genre = content;
-                    continue;
-                }
-                if (key == kGrouping) {
-                    grouping = content;
-                    continue;
-                }
-                if (key == kBPM) {
-                    bpm = content.toInt();
-                    continue;
-                }
-                if (key == kBitRate) {
-                    bitrate = content.toInt();
-                    continue;
-                }
-                if (key == kComments) {
-                    comment = content;
-                    continue;
-                }
-                if (key == kTotalTime) {
-                    playtime = (content.toInt() / 1000);
-                    continue;
-                }
-                if (key == kYear) {
-                    year = content;
-                    continue;
-                }
-                if (key == kLocation) {
+                switch (key) {
+                case Key::TrackId:
+                    id = readIntElement(m_xml);
+                    break;
+                case Key::Name:
+                    title = m_xml.readElementText();
+                    break;
+                case Key::Artist:
+                    artist = m_xml.readElementText();
+                    break;
+                case Key::Album:
+                    album = m_xml.readElementText();
+                    break;
+                case Key::AlbumArtist:
+                    albumArtist = m_xml.readElementText();
+                    break;
+                case Key::Genre:
+                    genre = m_xml.readElementText();
+                    break;
+                case Key::Grouping:
+                    grouping = m_xml.readElementText();
+                    break;
+                case Key::BPM:
+                    bpm = readIntElement(m_xml);
+                    break;
+                case Key::BitRate:
+                    bitrate = readIntElement(m_xml);
+                    break;
+                case Key::Comments:
+                    comment = m_xml.readElementText();
+                    break;
+                case Key::TotalTime:
+                    playtime = readIntElement(m_xml) / 1000;
+                    break;
+                case Key::Year:
+                    year = readIntElement(m_xml);
+                    break;
+                case Key::Location:
                     // Convert the location URL to a file path. Note that we intentionally
                     // do not use FileInfo::location here since it would prepend a drive letter
                     // prefix to Unix paths, something we already take care of through the
                     // path mapping below (otherwise we'd end up with duplicate drive letter
                     // prefixes, e.g. C:C:, if the translation rule already substitutes a
                     // path with a drive letter).
-                    location = mixxx::FileInfo::fromQUrl(QUrl(content)).asQFileInfo().filePath();
+                    location = mixxx::FileInfo::fromQUrl(QUrl(m_xml.readElementText()))
+                                       .asQFileInfo()
+                                       .filePath();
                     // Replace first part of location with the mixxx iTunes Root
                     // on systems where iTunes installed it only strips //localhost
                     // on iTunes from foreign systems the mount point is replaced
                     if (!m_pathMapping.dbITunesRoot.isEmpty()) {
                         location.replace(m_pathMapping.dbITunesRoot, m_pathMapping.mixxxITunesRoot);
                     }
-                    continue;
-                }
-                if (key == kTrackNumber) {
-                    tracknumber = content;
-                    continue;
-                }
-                if (key == kRating) {
+                    break;
+                case Key::TrackNumber:
+                    tracknumber = readIntElement(m_xml);
+                    break;
+                case Key::Rating:
                     // value is an integer and ranges from 0 to 100
-                    rating = (content.toInt() / 20);
-                    continue;
-                }
-                if (key == kTrackType) {
-                    tracktype = content;
-                    continue;
+                    rating = readIntElement(m_xml) / 20;
+                    break;
+                case Key::TrackType:
+                    isRemote = m_xml.readElementText() == kRemote;
+                    break;
+                default:
+                    m_xml.skipCurrentElement();
+                    break;
                 }
+                continue;
             }
         }
         // exit loop on closing </dict>
@@ -365,7 +449,7 @@ void ITunesXMLImporter::parseTrack() {
 
     // If file is a remote file from iTunes Match, don't save it to the database.
     // There's no way that mixxx can access it.
-    if (tracktype == kRemote) {
+    if (isRemote) {
         return;
     }
 
@@ -379,12 +463,12 @@ void ITunesXMLImporter::parseTrack() {
             .albumArtist = albumArtist,
             .genre = genre,
             .grouping = grouping,
-            .year = year.toInt(),
+            .year = year,
             .duration = playtime,
             .location = location,
             .rating = rating,
             .comment = comment,
-            .trackNumber = tracknumber.toInt(),
+            .trackNumber = tracknumber,
             .bpm = bpm,
             .bitrate = bitrate,
     };
@@ -405,7 +489,7 @@ void ITunesXMLImporter::parsePlaylists() {
             continue;
         }
         if (m_xml.isEndElement()) {
-            if (m_xml.name() == QLatin1String("array")) {
+            if (m_xml.name() == kArray) {
                 break;
             }
         }
@@ -441,48 +525,48 @@ void ITunesXMLImporter::parsePlaylist() {
 
         if (m_xml.isStartElement()) {
             if (m_xml.name() == kKey) {
-                QString key = m_xml.readElementText();
+                const Key key = readKey(m_xml);
                 // The rules are processed in sequence
                 // That is, XML is ordered.
                 // For iTunes Playlist names are always followed by the ID.
                 // Afterwars the playlist entries occur
-                if (key == "Name") {
+                if (key == Key::Name) {
                     readNextStartElement();
                     playlist.name = m_xml.readElementText();
                     continue;
                 }
                 // When parsing the ID, the playlistname has already been found
-                if (key == "Playlist ID") {
+                if (key == Key::PlaylistId) {
                     readNextStartElement();
-                    playlist.id = m_xml.readElementText().toInt();
+                    playlist.id = readIntElement(m_xml);
                     trackPosition = 1;
                     continue;
                 }
-                if (key == "Playlist Persistent ID") {
+                if (key == Key::PlaylistPersistentId) {
                     readNextStartElement();
                     persistentId = m_xml.readElementText();
                     continue;
                 }
-                if (key == "Parent Persistent ID") {
+                if (key == Key::ParentPersistentId) {
                     readNextStartElement();
                     parentPersistentId = m_xml.readElementText();
                     continue;
                 }
                 // Hide playlists that are system playlists
-                if (key == "Distinguished Kind") {
+                if (key == Key::DistinguishedKind) {
                     readNextStartElement();
                     isSystemPlaylist = true;
                     continue;
                 }
-                if (key == "Visible") {
+                if (key == Key::Visible) {
                     readNextStartElement();
-                    if (m_xml.name() == QString("false")) {
+                    if (m_xml.name() == kFalse) {
                         isSystemPlaylist = true;
                     }
                     continue;
                 }
 
-                if (key == "Playlist Items") {
+                if (key == Key::PlaylistItems) {
                     isPlaylistItemsStarted = true;
 
                     // if the playlist is prebuilt don't hit the database
@@ -497,9 +581,9 @@ void ITunesXMLImporter::parsePlaylist() {
                 }
                 // When processing playlist entries, playlist name and id have
                 // already been processed and persisted
-                if (key == kTrackId) {
+                if (key == Key::TrackId) {
                     readNextStartElement();
-                    trackReference = m_xml.readElementText().toInt();
+                    trackReference = readIntElement(m_xml);
 
                     // Insert tracks if we are not in a pre-built playlist
                     if (!isSystemPlaylist) {
@@ -511,7 +595,7 @@ void ITunesXMLImporter::parsePlaylist() {
             }
         }
         if (m_xml.isEndElement()) {
-            if (m_xml.name() == QLatin1String("array")) {
+            if (m_xml.name() == kArray) {
                 // qDebug() << "exit playlist";
                 break;
             }
@@ -1,5 +1,64 @@
+#pragma once
+
+#include <QString>
+
+#include "util/color/rgbcolor.h"
+
 namespace mixxx {
 namespace rekordboxconstants {
 const QString beatsSubversion = QStringLiteral("Rekordbox USB drive");
+
+const QString kRekordboxLibraryTable = QStringLiteral("rekordbox_library");
+const QString kRekordboxPlaylistsTable = QStringLiteral("rekordbox_playlists");
+const QString kRekordboxPlaylistTracksTable = QStringLiteral("rekordbox_playlist_tracks");
+
+const QString kPLaylistPathDelimiter = QStringLiteral("-->");
+
+// Stored as second element in the data of sidebar tree items
+const QString kIsRekordboxDevice = QStringLiteral("::isRecordboxDevice::");
+const QString kIsNotRekordboxDevice = QStringLiteral("::isNotRecordboxDevice::");
+
+enum class IDForColor : uint8_t {
+    Pink = 1,
+    Red,
+    Orange,
+    Yellow,
+    Green,
+    Aqua,
+    Blue,
+    Purple
+};
+
+constexpr mixxx::RgbColor kColorForIDPink(0xF870F8);
+constexpr mixxx::RgbColor kColorForIDRed(0xF870900);
+constexpr mixxx::RgbColor kColorForIDOrange(0xF8A030);
+constexpr mixxx::RgbColor kColorForIDYellow(0xF8E331);
+constexpr mixxx::RgbColor kColorForIDGreen(0x1EE000);
+constexpr mixxx::RgbColor kColorForIDAqua(0x16C0F8);
+constexpr mixxx::RgbColor kColorForIDBlue(0x0150F8);
+constexpr mixxx::RgbColor kColorForIDPurple(0x9808F8);
+constexpr mixxx::RgbColor kColorForIDNoColor(0x0);
+
+inline mixxx::RgbColor colorFromID(int colorID) {
+    switch (static_cast<IDForColor>(colorID)) {
+    case IDForColor::Pink:
+        return kColorForIDPink;
+    case IDForColor::Red:
+        return kColorForIDRed;
+    case IDForColor::Orange:
+        return kColorForIDOrange;
+    case IDForColor::Yellow:
+        return kColorForIDYellow;
+    case IDForColor::Green:
+        return kColorForIDGreen;
+    case IDForColor::Aqua:
+        return kColorForIDAqua;
+    case IDForColor::Blue:
+        return kColorForIDBlue;
+    case IDForColor::Purple:
+        return kColorForIDPurple;
+    }
+    return kColorForIDNoColor;
 }
+} // namespace rekordboxconstants
 } // namespace mixxx
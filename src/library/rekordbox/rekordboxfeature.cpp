@@ -2,19 +2,19 @@
 
 #include <mp3guessenc.h>
 
-#include <QMap>
 #include <QMessageBox>
 #include <QSettings>
 #include <QTextCodec>
 #include <QtDebug>
+#include <memory>
 
 #include "engine/engine.h"
 #include "library/dao/trackschema.h"
 #include "library/library.h"
 #include "library/queryutil.h"
 #include "library/rekordbox/kaitaistructs/rekordbox_anlz.h"
-#include "library/rekordbox/kaitaistructs/rekordbox_pdb.h"
 #include "library/rekordbox/rekordboxconstants.h"
+#include "library/rekordbox/rekordboxpdbimporter.h"
 #include "library/trackcollection.h"
 #include "library/trackcollectionmanager.h"
 #include "library/treeitem.h"
@@ -31,38 +31,16 @@
 #include "widget/wlibrary.h"
 #include "widget/wlibrarytextbrowser.h"
 
-#define IS_RECORDBOX_DEVICE "::isRecordboxDevice::"
-#define IS_NOT_RECORDBOX_DEVICE "::isNotRecordboxDevice::"
-
 namespace {
 
-const QString kRekordboxLibraryTable = QStringLiteral("rekordbox_library");
-const QString kRekordboxPlaylistsTable = QStringLiteral("rekordbox_playlists");
-const QString kRekordboxPlaylistTracksTable = QStringLiteral("rekordbox_playlist_tracks");
+using mixxx::rekordboxconstants::colorFromID;
+using mixxx::rekordboxconstants::kIsNotRekordboxDevice;
+using mixxx::rekordboxconstants::kIsRekordboxDevice;
+using mixxx::rekordboxconstants::kRekordboxLibraryTable;
+using mixxx::rekordboxconstants::kRekordboxPlaylistsTable;
+using mixxx::rekordboxconstants::kRekordboxPlaylistTracksTable;
 
 const QString kPdbPath = QStringLiteral("PIONEER/rekordbox/export.pdb");
-const QString kPLaylistPathDelimiter = QStringLiteral("-->");
-
-enum class IDForColor : uint8_t {
-    Pink = 1,
-    Red,
-    Orange,
-    Yellow,
-    Green,
-    Aqua,
-    Blue,
-    Purple
-};
-
-constexpr mixxx::RgbColor kColorForIDPink(0xF870F8);
-constexpr mixxx::RgbColor kColorForIDRed(0xF870900);
-constexpr mixxx::RgbColor kColorForIDOrange(0xF8A030);
-constexpr mixxx::RgbColor kColorForIDYellow(0xF8E331);
-constexpr mixxx::RgbColor kColorForIDGreen(0x1EE000);
-constexpr mixxx::RgbColor kColorForIDAqua(0x16C0F8);
-constexpr mixxx::RgbColor kColorForIDBlue(0x0150F8);
-constexpr mixxx::RgbColor kColorForIDPurple(0x9808F8);
-constexpr mixxx::RgbColor kColorForIDNoColor(0x0);
 
 struct memory_cue_loop_t {
     mixxx::audio::FramePos startPosition;
@@ -71,95 +49,6 @@ struct memory_cue_loop_t {
     mixxx::RgbColor::optional_t color;
 };
 
-bool createLibraryTable(QSqlDatabase& database, const QString& tableName) {
-    qDebug() << "Creating Rekordbox library table: " << tableName;
-
-    QSqlQuery query(database);
-    query.prepare(
-            "CREATE TABLE IF NOT EXISTS " + tableName +
-            " ("
-            "    id INTEGER PRIMARY KEY AUTOINCREMENT,"
-            "    rb_id INTEGER,"
-            "    artist TEXT,"
-            "    title TEXT,"
-            "    album TEXT,"
-            "    year INTEGER,"
-            "    genre TEXT,"
-            "    tracknumber TEXT,"
-            "    location TEXT UNIQUE,"
-            "    comment TEXT,"
-            "    duration INTEGER,"
-            "    bitrate TEXT,"
-            "    bpm FLOAT,"
-            "    key TEXT,"
-            "    rating INTEGER,"
-            "    analyze_path TEXT UNIQUE,"
-            "    device TEXT,"
-            "    color INTEGER"
-            ");");
-
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
-        return false;
-    }
-
-    return true;
-}
-
-bool createPlaylistsTable(QSqlDatabase& database, const QString& tableName) {
-    qDebug() << "Creating Rekordbox playlists table: " << tableName;
-
-    QSqlQuery query(database);
-    query.prepare(
-            "CREATE TABLE IF NOT EXISTS " + tableName +
-            " ("
-            "    id INTEGER PRIMARY KEY,"
-            "    name TEXT UNIQUE"
-            ");");
-
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
-        return false;
-    }
-
-    return true;
-}
-
-bool createPlaylistTracksTable(QSqlDatabase& database, const QString& tableName) {
-    qDebug() << "Creating Rekordbox playlist tracks table: " << tableName;
-
-    QSqlQuery query(database);
-    query.prepare(
-            "CREATE TABLE IF NOT EXISTS " + tableName +
-            " ("
-            "    id INTEGER PRIMARY KEY AUTOINCREMENT,"
-            "    playlist_id INTEGER REFERENCES rekordbox_playlists(id),"
-            "    track_id INTEGER REFERENCES rekordbox_library(id),"
-            "    position INTEGER"
-            ");");
-
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
-        return false;
-    }
-
-    return true;
-}
-
-bool dropTable(QSqlDatabase& database, const QString& tableName) {
-    qDebug() << "Dropping Rekordbox table: " << tableName;
-
-    QSqlQuery query(database);
-    query.prepare("DROP TABLE IF EXISTS " + tableName);
-
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
-        return false;
-    }
-
-    return true;
-}
-
 // This function is executed in a separate thread other than the main thread
 // The returned list owns the pointers, but we can't use a unique_ptr because
 // the result is passed by a const reference inside QFuture and than copied
@@ -193,7 +82,7 @@ QList<TreeItem*> findRekordboxDevices() {
             }
             QList<QString> data;
             data << drive.filePath();
-            data << IS_RECORDBOX_DEVICE;
+            data << kIsRekordboxDevice;
             auto* pFoundDevice = new TreeItem(
                     std::move(displayPath),
                     QVariant(data));
@@ -224,7 +113,7 @@ QList<TreeItem*> findRekordboxDevices() {
         if (rbDBFileInfo.exists() && rbDBFileInfo.isFile()) {
             QList<QString> data;
             data << device.filePath();
-            data << IS_RECORDBOX_DEVICE;
+            data << kIsRekordboxDevice;
             auto* pFoundDevice = new TreeItem(
                     device.fileName(),
                     QVariant(data));
@@ -240,7 +129,7 @@ QList<TreeItem*> findRekordboxDevices() {
         if (rbDBFileInfo.exists() && rbDBFileInfo.isFile()) {
             QList<QString> data;
             data << device.filePath();
-            data << IS_RECORDBOX_DEVICE;
+            data << kIsRekordboxDevice;
             auto* pFoundDevice = new TreeItem(
                     device.fileName(),
                     QVariant(data));
@@ -252,193 +141,19 @@ QList<TreeItem*> findRekordboxDevices() {
     return foundDevices;
 }
 
-template<typename Base, typename T>
-inline bool instanceof (const T* ptr) {
-    return dynamic_cast<const Base*>(ptr) != nullptr;
-}
-
 QString toUnicode(const std::string& toConvert) {
     return QTextCodec::codecForName("UTF-16BE")
             ->toUnicode(toConvert.data(), static_cast<int>(toConvert.length()));
 }
 
-// Functions getText and parseDeviceDB are roughly based on the following Java file:
-// https://github.com/Deep-Symmetry/crate-digger/commit/f09fa9fc097a2a428c43245ddd542ac1370c1adc
-// getText is needed because the strings in the PDB file "have a variety of obscure representations".
-
-QString getText(rekordbox_pdb_t::device_sql_string_t* deviceString) {
-    QString text;
-
-    if (instanceof <rekordbox_pdb_t::device_sql_short_ascii_t>(deviceString->body())) {
-        rekordbox_pdb_t::device_sql_short_ascii_t* shortAsciiString =
-                static_cast<rekordbox_pdb_t::device_sql_short_ascii_t*>(deviceString->body());
-        text = QString::fromStdString(shortAsciiString->text());
-    } else if (instanceof <rekordbox_pdb_t::device_sql_long_ascii_t>(deviceString->body())) {
-        rekordbox_pdb_t::device_sql_long_ascii_t* longAsciiString =
-                static_cast<rekordbox_pdb_t::device_sql_long_ascii_t*>(deviceString->body());
-        text = QString::fromStdString(longAsciiString->text());
-    } else if (instanceof <rekordbox_pdb_t::device_sql_long_utf16be_t>(deviceString->body())) {
-        rekordbox_pdb_t::device_sql_long_utf16be_t* longUtf16beString =
-                static_cast<rekordbox_pdb_t::device_sql_long_utf16be_t*>(deviceString->body());
-        text = toUnicode(longUtf16beString->text());
-    }
-
-    // Some strings read from Rekordbox *.PDB files contain random null characters
-    // which if not removed cause Mixxx to crash when attempting to read file paths
-    return text.remove(QChar('\x0'));
-}
-
-int createDevicePlaylist(QSqlDatabase& database, const QString& devicePath) {
-    int playlistID = kInvalidPlaylistId;
-
-    QSqlQuery queryInsertIntoDevicePlaylist(database);
-    queryInsertIntoDevicePlaylist.prepare(
-            "INSERT INTO " + kRekordboxPlaylistsTable +
-            " (name) "
-            "VALUES (:name)");
-
-    queryInsertIntoDevicePlaylist.bindValue(":name", devicePath);
-
-    if (!queryInsertIntoDevicePlaylist.exec()) {
-        LOG_FAILED_QUERY(queryInsertIntoDevicePlaylist)
-                << "devicePath: " << devicePath;
-        return playlistID;
-    }
-
-    QSqlQuery idQuery(database);
-    idQuery.prepare("select id from " + kRekordboxPlaylistsTable + " where name=:path");
-    idQuery.bindValue(":path", devicePath);
-
-    if (!idQuery.exec()) {
-        LOG_FAILED_QUERY(idQuery)
-                << "devicePath: " << devicePath;
-        return playlistID;
-    }
-
-    while (idQuery.next()) {
-        playlistID = idQuery.value(idQuery.record().indexOf("id")).toInt();
-    }
-
-    return playlistID;
-}
-
-mixxx::RgbColor colorFromID(int colorID) {
-    switch (static_cast<IDForColor>(colorID)) {
-    case IDForColor::Pink:
-        return kColorForIDPink;
-    case IDForColor::Red:
-        return kColorForIDRed;
-    case IDForColor::Orange:
-        return kColorForIDOrange;
-    case IDForColor::Yellow:
-        return kColorForIDYellow;
-    case IDForColor::Green:
-        return kColorForIDGreen;
-    case IDForColor::Aqua:
-        return kColorForIDAqua;
-    case IDForColor::Blue:
-        return kColorForIDBlue;
-    case IDForColor::Purple:
-        return kColorForIDPurple;
-    }
-    return kColorForIDNoColor;
-}
-
-void insertTrack(
-        QSqlDatabase& database,
-        rekordbox_pdb_t::track_row_t* track,
-        QSqlQuery& query,
-        QSqlQuery& queryInsertIntoDevicePlaylistTracks,
-        QMap<uint32_t, QString>& artistsMap,
-        QMap<uint32_t, QString>& albumsMap,
-        QMap<uint32_t, QString>& genresMap,
-        QMap<uint32_t, QString>& keysMap,
-        const QString& devicePath,
-        const QString& device,
-        int audioFilesCount) {
-    int rbID = static_cast<int>(track->id());
-    QString title = getText(track->title());
-    QString artist = artistsMap[track->artist_id()];
-    QString album = albumsMap[track->album_id()];
-    QString year = QString::number(track->year());
-    QString genre = genresMap[track->genre_id()];
-    QString location = devicePath + getText(track->file_path());
-    float bpm = static_cast<float>(track->tempo() / 100.0);
-    int bitrate = static_cast<int>(track->bitrate());
-    QString key = keysMap[track->key_id()];
-    int playtime = static_cast<int>(track->duration());
-    int rating = static_cast<int>(track->rating());
-    QString comment = getText(track->comment());
-    QString tracknumber = QString::number(track->track_number());
-    QString anlzPath = devicePath + getText(track->analyze_path());
-
-    query.bindValue(":rb_id", rbID);
-    query.bindValue(":artist", artist);
-    query.bindValue(":title", title);
-    query.bindValue(":album", album);
-    query.bindValue(":genre", genre);
-    query.bindValue(":year", year);
-    query.bindValue(":duration", playtime);
-    query.bindValue(":location", location);
-    query.bindValue(":rating", rating);
-    query.bindValue(":comment", comment);
-    query.bindValue(":tracknumber", tracknumber);
-    query.bindValue(":key", key);
-    query.bindValue(":bpm", bpm);
-    query.bindValue(":bitrate", bitrate);
-    query.bindValue(":analyze_path", anlzPath);
-    query.bindValue(":device", device);
-    query.bindValue(":color",
-            mixxx::RgbColor::toQVariant(
-                    colorFromID(static_cast<int>(track->color_id()))));
-
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
-    }
-
-    int trackID = -1;
-    QSqlQuery finderQuery(database);
-    finderQuery.prepare("select id from " + kRekordboxLibraryTable +
-            " where rb_id=:rb_id and device=:device");
-    finderQuery.bindValue(":rb_id", rbID);
-    finderQuery.bindValue(":device", device);
-
-    if (!finderQuery.exec()) {
-        LOG_FAILED_QUERY(finderQuery)
-                << "rbID:" << rbID;
-    }
-
-    if (finderQuery.next()) {
-        trackID = finderQuery.value(finderQuery.record().indexOf("id")).toInt();
-    }
-
-    // Insert into device all tracks playlist
-    queryInsertIntoDevicePlaylistTracks.bindValue(":track_id", trackID);
-    queryInsertIntoDevicePlaylistTracks.bindValue(":position", audioFilesCount);
-
-    if (!queryInsertIntoDevicePlaylistTracks.exec()) {
-        LOG_FAILED_QUERY(queryInsertIntoDevicePlaylistTracks)
-                << "trackID:" << trackID
-                << "position:" << audioFilesCount;
-    }
-}
-
-void buildPlaylistTree(
-        QSqlDatabase& database,
-        TreeItem* parent,
-        uint32_t parentID,
-        QMap<uint32_t, QString>& playlistNameMap,
-        QMap<uint32_t, bool>& playlistIsFolderMap,
-        QMap<uint32_t, QMap<uint32_t, uint32_t>>& playlistTreeMap,
-        QMap<uint32_t, QMap<uint32_t, uint32_t>>& playlistTrackMap,
-        const QString& playlistPath,
-        const QString& device);
-
-QString parseDeviceDB(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* deviceItem) {
-    QString device = deviceItem->getLabel();
-    QString devicePath = deviceItem->getData().toList()[0].toString();
+// This function is executed in a separate thread other than the main thread
+QString parseDeviceDB(mixxx::DbConnectionPoolPtr dbConnectionPool,
+        std::shared_ptr<RekordboxPdbImporter> pImporter,
+        TreeItem* deviceItem) {
+    const QString& devicePath = pImporter->devicePath();
 
-    qDebug() << "parseDeviceDB device: " << device << " devicePath: " << devicePath;
+    qDebug() << "parseDeviceDB device: " << pImporter->device()
+             << " devicePath: " << devicePath;
 
     QString dbPath = devicePath + QStringLiteral("/") + kPdbPath;
 
@@ -462,404 +177,18 @@ QString parseDeviceDB(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* dev
     QThread* thisThread = QThread::currentThread();
     thisThread->setPriority(QThread::LowPriority);
 
-    ScopedTransaction transaction(database);
-
-    QSqlQuery query(database);
-    query.prepare("INSERT INTO " + kRekordboxLibraryTable +
-            " (rb_id, artist, title, album, year,"
-            "genre,comment,tracknumber,bpm, bitrate,duration, location,"
-            "rating,key,analyze_path,device,color) VALUES (:rb_id, :artist, "
-            ":title, :album, :year,:genre,"
-            ":comment, :tracknumber,:bpm, :bitrate,:duration, :location,"
-            ":rating,:key,:analyze_path,:device,:color)");
-
-    int audioFilesCount = 0;
-
-    // Create a playlist for all the tracks on a device
-    int playlistID = createDevicePlaylist(database, devicePath);
-
-    QSqlQuery queryInsertIntoDevicePlaylistTracks(database);
-    queryInsertIntoDevicePlaylistTracks.prepare(
-            "INSERT INTO " + kRekordboxPlaylistTracksTable +
-            " (playlist_id, track_id, position) "
-            "VALUES (:playlist_id, :track_id, :position)");
-
-    queryInsertIntoDevicePlaylistTracks.bindValue(":playlist_id", playlistID);
-
     mixxx::FileInfo fileInfo(dbPath);
     if (!Sandbox::askForAccess(&fileInfo)) {
         return QString();
     }
-    std::ifstream ifs(dbPath.toStdString(), std::ifstream::binary);
-    kaitai::kstream ks(&ifs);
-
-    rekordbox_pdb_t reckordboxDB = rekordbox_pdb_t(&ks);
-
-    // There are other types of tables (eg. COLOR), these are the only ones we are
-    // interested at the moment. Perhaps when/if
-    // https://github.com/mixxxdj/mixxx/issues/6852
-    // is completed, this can be revisited.
-    // Attempt was made to also recover HISTORY
-    // playlists (which are found on removable Rekordbox devices), however
-    // they didn't appear to contain valid row_ref_t structures.
-    constexpr int totalTables = 8;
-
-    rekordbox_pdb_t::page_type_t tableOrder[totalTables] = {
-            rekordbox_pdb_t::PAGE_TYPE_KEYS,
-            rekordbox_pdb_t::PAGE_TYPE_GENRES,
-            rekordbox_pdb_t::PAGE_TYPE_ARTISTS,
-            rekordbox_pdb_t::PAGE_TYPE_ALBUMS,
-            rekordbox_pdb_t::PAGE_TYPE_PLAYLIST_ENTRIES,
-            rekordbox_pdb_t::PAGE_TYPE_TRACKS,
-            rekordbox_pdb_t::PAGE_TYPE_PLAYLIST_TREE,
-            rekordbox_pdb_t::PAGE_TYPE_HISTORY};
-
-    QMap<uint32_t, QString> keysMap;
-    QMap<uint32_t, QString> genresMap;
-    QMap<uint32_t, QString> artistsMap;
-    QMap<uint32_t, QString> albumsMap;
-    QMap<uint32_t, QString> playlistNameMap;
-    QMap<uint32_t, bool> playlistIsFolderMap;
-    QMap<uint32_t, QMap<uint32_t, uint32_t>> playlistTreeMap;
-    QMap<uint32_t, QMap<uint32_t, uint32_t>> playlistTrackMap;
-
-    bool folderOrPlaylistFound = false;
-
-    for (int tableOrderIndex = 0; tableOrderIndex < totalTables; tableOrderIndex++) {
-        for (std::vector<rekordbox_pdb_t::table_t*>::iterator table =
-                        reckordboxDB.tables()->begin();
-                table != reckordboxDB.tables()->end();
-                ++table) {
-            if ((*table)->type() == tableOrder[tableOrderIndex]) {
-                uint16_t lastIndex = (*table)->last_page()->index();
-                rekordbox_pdb_t::page_ref_t* currentRef = (*table)->first_page();
-
-                while (true) {
-                    rekordbox_pdb_t::page_t* page = currentRef->body();
-
-                    if (page->is_data_page()) {
-                        for (std::vector<rekordbox_pdb_t::row_group_t*>::
-                                        iterator rowGroup =
-                                                page->row_groups()->begin();
-                                rowGroup != page->row_groups()->end();
-                                ++rowGroup) {
-                            for (std::vector<rekordbox_pdb_t::row_ref_t*>::
-                                            iterator rowRef = (*rowGroup)
-                                                                      ->rows()
-                                                                      ->begin();
-                                    rowRef != (*rowGroup)->rows()->end();
-                                    ++rowRef) {
-                                if ((*rowRef)->present()) {
-                                    switch (tableOrder[tableOrderIndex]) {
-                                    case rekordbox_pdb_t::PAGE_TYPE_KEYS: {
-                                        // Key found, update map
-                                        rekordbox_pdb_t::key_row_t* key =
-                                                static_cast<rekordbox_pdb_t::
-                                                                key_row_t*>(
-                                                        (*rowRef)->body());
-                                        keysMap[key->id()] = getText(key->name());
-                                    } break;
-                                    case rekordbox_pdb_t::PAGE_TYPE_GENRES: {
-                                        // Genre found, update map
-                                        rekordbox_pdb_t::genre_row_t* genre =
-                                                static_cast<rekordbox_pdb_t::
-                                                                genre_row_t*>(
-                                                        (*rowRef)->body());
-                                        genresMap[genre->id()] = getText(genre->name());
-                                    } break;
-                                    case rekordbox_pdb_t::PAGE_TYPE_ARTISTS: {
-                                        // Artist found, update map
-                                        rekordbox_pdb_t::artist_row_t* artist =
-                                                static_cast<rekordbox_pdb_t::
-                                                                artist_row_t*>(
-                                                        (*rowRef)->body());
-                                        artistsMap[artist->id()] = getText(artist->name());
-                                    } break;
-                                    case rekordbox_pdb_t::PAGE_TYPE_ALBUMS: {
-                                        // Album found, update map
-                                        rekordbox_pdb_t::album_row_t* album =
-                                                static_cast<rekordbox_pdb_t::
-                                                                album_row_t*>(
-                                                        (*rowRef)->body());
-                                        albumsMap[album->id()] = getText(album->name());
-                                    } break;
-                                    case rekordbox_pdb_t::PAGE_TYPE_PLAYLIST_ENTRIES: {
-                                        // Playlist to track mapping found, update map
-                                        rekordbox_pdb_t::playlist_entry_row_t*
-                                                playlistEntry = static_cast<
-                                                        rekordbox_pdb_t::
-                                                                playlist_entry_row_t*>(
-                                                        (*rowRef)->body());
-                                        playlistTrackMap
-                                                [playlistEntry->playlist_id()]
-                                                [playlistEntry->entry_index()] =
-                                                        playlistEntry
-                                                                ->track_id();
-                                    } break;
-                                    case rekordbox_pdb_t::PAGE_TYPE_TRACKS: {
-                                        // Track found, insert into database
-                                        insertTrack(database,
-                                                static_cast<rekordbox_pdb_t::
-                                                                track_row_t*>(
-                                                        (*rowRef)->body()),
-                                                query,
-                                                queryInsertIntoDevicePlaylistTracks,
-                                                artistsMap,
-                                                albumsMap,
-                                                genresMap,
-                                                keysMap,
-                                                devicePath,
-                                                device,
-                                                audioFilesCount);
-
-                                        audioFilesCount++;
-                                    } break;
-                                    case rekordbox_pdb_t::PAGE_TYPE_PLAYLIST_TREE: {
-                                        // Playlist tree node found, update map
-                                        rekordbox_pdb_t::playlist_tree_row_t*
-                                                playlistTree = static_cast<
-                                                        rekordbox_pdb_t::
-                                                                playlist_tree_row_t*>(
-                                                        (*rowRef)->body());
-
-                                        playlistNameMap[playlistTree->id()] =
-                                                getText(playlistTree->name());
-                                        playlistIsFolderMap[playlistTree
-                                                                    ->id()] =
-                                                playlistTree->is_folder();
-                                        playlistTreeMap
-                                                [playlistTree->parent_id()]
-                                                [playlistTree->sort_order()] =
-                                                        playlistTree->id();
-
-                                        folderOrPlaylistFound = true;
-                                    } break;
-                                    default:
-                                        break;
-                                    }
-                                }
-                            }
-                        }
-                    }
 
-                    if (currentRef->index() == lastIndex) {
-                        break;
-                    } else {
-                        currentRef = page->next_page();
-                    }
-                }
-            }
-        }
-    }
-
-    if (audioFilesCount > 0 || folderOrPlaylistFound) {
-        // If we have found anything, recursively build playlist/folder TreeItem children
-        // for the original device TreeItem
-        buildPlaylistTree(database,
-                deviceItem,
-                0,
-                playlistNameMap,
-                playlistIsFolderMap,
-                playlistTreeMap,
-                playlistTrackMap,
-                devicePath,
-                device);
+    if (!pImporter->importPdb(database, dbPath, deviceItem)) {
+        return QString();
     }
 
-    qDebug() << "Found: " << audioFilesCount << " audio files in Rekordbox device " << device;
-
-    transaction.commit();
-
     return devicePath;
 }
 
-void buildPlaylistTree(
-        QSqlDatabase& database,
-        TreeItem* parent,
-        uint32_t parentID,
-        QMap<uint32_t, QString>& playlistNameMap,
-        QMap<uint32_t, bool>& playlistIsFolderMap,
-        QMap<uint32_t, QMap<uint32_t, uint32_t>>& playlistTreeMap,
-        QMap<uint32_t, QMap<uint32_t, uint32_t>>& playlistTrackMap,
-        const QString& playlistPath,
-        const QString& device) {
-    for (uint32_t childIndex = 0;
-            childIndex < (uint32_t)playlistTreeMap[parentID].size();
-            childIndex++) {
-        uint32_t childID = playlistTreeMap[parentID][childIndex];
-        if (childID == 0) {
-            continue;
-        }
-        QString playlistItemName = playlistNameMap[childID];
-
-        QString currentPath = playlistPath + kPLaylistPathDelimiter + playlistItemName;
-
-        QList<QString> data;
-
-        data << currentPath;
-        data << IS_NOT_RECORDBOX_DEVICE;
-
-        TreeItem* child = parent->appendChild(playlistItemName, QVariant(data));
-
-        // Create a playlist for this child
-        QSqlQuery queryInsertIntoPlaylist(database);
-        queryInsertIntoPlaylist.prepare(
-                "INSERT INTO " + kRekordboxPlaylistsTable +
-                " (name) "
-                "VALUES (:name)");
-
-        queryInsertIntoPlaylist.bindValue(":name", currentPath);
-
-        if (!queryInsertIntoPlaylist.exec()) {
-            LOG_FAILED_QUERY(queryInsertIntoPlaylist)
-                    << "currentPath" << currentPath;
-            return;
-        }
-
-        QSqlQuery idQuery(database);
-        idQuery.prepare("select id from " + kRekordboxPlaylistsTable + " where name=:path");
-        idQuery.bindValue(":path", currentPath);
-
-        if (!idQuery.exec()) {
-            LOG_FAILED_QUERY(idQuery)
-                    << "currentPath" << currentPath;
-            return;
-        }
-
-        int playlistID = kInvalidPlaylistId;
-        while (idQuery.next()) {
-            playlistID = idQuery.value(idQuery.record().indexOf("id")).toInt();
-        }
-
-        QSqlQuery queryInsertIntoPlaylistTracks(database);
-        queryInsertIntoPlaylistTracks.prepare(
-                "INSERT INTO " + kRekordboxPlaylistTracksTable +
-                " (playlist_id, track_id, position) "
-                "VALUES (:playlist_id, :track_id, :position)");
-
-        if (playlistTrackMap.count(childID)) {
-            // Add playlist tracks for children
-            for (uint32_t trackIndex = 1; trackIndex <=
-                    static_cast<uint32_t>(playlistTrackMap[childID].size());
-                    trackIndex++) {
-                uint32_t rbTrackID = playlistTrackMap[childID][trackIndex];
-
-                int trackID = -1;
-                QSqlQuery finderQuery(database);
-                finderQuery.prepare("select id from " + kRekordboxLibraryTable +
-                        " where rb_id=:rb_id and device=:device");
-                finderQuery.bindValue(":rb_id", rbTrackID);
-                finderQuery.bindValue(":device", device);
-
-                if (!finderQuery.exec()) {
-                    LOG_FAILED_QUERY(finderQuery)
-                            << "rbTrackID:" << rbTrackID
-                            << "device:" << device;
-                    return;
-                }
-
-                if (finderQuery.next()) {
-                    trackID = finderQuery.value(finderQuery.record().indexOf("id")).toInt();
-                }
-
-                queryInsertIntoPlaylistTracks.bindValue(":playlist_id", playlistID);
-                queryInsertIntoPlaylistTracks.bindValue(":track_id", trackID);
-                queryInsertIntoPlaylistTracks.bindValue(":position", static_cast<int>(trackIndex));
-
-                if (!queryInsertIntoPlaylistTracks.exec()) {
-                    LOG_FAILED_QUERY(queryInsertIntoPlaylistTracks)
-                            << "playlistID:" << playlistID
-                            << "trackID:" << trackID
-                            << "trackIndex:" << trackIndex;
-
-                    return;
-                }
-            }
-        }
-
-        if (playlistIsFolderMap[childID]) {
-            // If this child is a folder (playlists are only leaf nodes), build playlist tree for it
-            buildPlaylistTree(database,
-                    child,
-                    childID,
-                    playlistNameMap,
-                    playlistIsFolderMap,
-                    playlistTreeMap,
-                    playlistTrackMap,
-                    currentPath,
-                    device);
-        }
-    }
-}
-
-void clearDeviceTables(QSqlDatabase& database, TreeItem* child) {
-    ScopedTransaction transaction(database);
-
-    int trackID = -1;
-    int playlistID = kInvalidPlaylistId;
-    QSqlQuery tracksQuery(database);
-    tracksQuery.prepare("select id from " + kRekordboxLibraryTable + " where device=:device");
-    tracksQuery.bindValue(":device", child->getLabel());
-
-    QSqlQuery deletePlaylistsQuery(database);
-    deletePlaylistsQuery.prepare("delete from " + kRekordboxPlaylistsTable + " where id=:id");
-
-    QSqlQuery deletePlaylistTracksQuery(database);
-    deletePlaylistTracksQuery.prepare("delete from " +
-            kRekordboxPlaylistTracksTable + " where playlist_id=:playlist_id");
-
-    if (!tracksQuery.exec()) {
-        LOG_FAILED_QUERY(tracksQuery)
-                << "device:" << child->getLabel();
-    }
-
-    while (tracksQuery.next()) {
-        trackID = tracksQuery.value(tracksQuery.record().indexOf("id")).toInt();
-
-        QSqlQuery playlistTracksQuery(database);
-        playlistTracksQuery.prepare("select playlist_id from " +
-                kRekordboxPlaylistTracksTable + " where track_id=:track_id");
-        playlistTracksQuery.bindValue(":track_id", trackID);
-
-        if (!playlistTracksQuery.exec()) {
-            LOG_FAILED_QUERY(playlistTracksQuery)
-                    << "trackID:" << trackID;
-        }
-
-        while (playlistTracksQuery.next()) {
-            playlistID = playlistTracksQuery
-                                 .value(playlistTracksQuery.record().indexOf(
-                                         "playlist_id"))
-                                 .toInt();
-
-            deletePlaylistsQuery.bindValue(":id", playlistID);
-
-            if (!deletePlaylistsQuery.exec()) {
-                LOG_FAILED_QUERY(deletePlaylistsQuery)
-                        << "playlistID:" << playlistID;
-            }
-
-            deletePlaylistTracksQuery.bindValue(":playlist_id", playlistID);
-
-            if (!deletePlaylistTracksQuery.exec()) {
-                LOG_FAILED_QUERY(deletePlaylistTracksQuery)
-                        << "playlistID:" << playlistID;
-            }
-        }
-    }
-
-    QSqlQuery deleteTracksQuery(database);
-    deleteTracksQuery.prepare("delete from " + kRekordboxLibraryTable + " where device=:device");
-    deleteTracksQuery.bindValue(":device", child->getLabel());
-
-    if (!deleteTracksQuery.exec()) {
-        LOG_FAILED_QUERY(deleteTracksQuery)
-                << "device:" << child->getLabel();
-    }
-
-    transaction.commit();
-}
-
 void setHotCue(TrackPointer track,
         mixxx::audio::FramePos startPosition,
         mixxx::audio::FramePos endPosition,
@@ -895,30 +224,51 @@ void setHotCue(TrackPointer track,
     }
 }
 
-void readAnalyze(TrackPointer track,
-        mixxx::audio::SampleRate sampleRate,
-        int timingOffset,
-        bool ignoreCues,
-        const QString& anlzPath) {
-    if (!QFile(anlzPath).exists()) {
-        return;
+/// Owns the stream that the parsed structure has been read from
+class AnlzFile final {
+  public:
+    explicit AnlzFile(const QString& anlzPath)
+            : m_ifs(anlzPath.toStdString(), std::ifstream::binary),
+              m_stream(&m_ifs),
+              m_anlz(&m_stream) {
     }
 
-    qDebug() << "Rekordbox ANLZ path:" << anlzPath << " for: " << track->getTitle();
+    rekordbox_anlz_t* operator->() {
+        return &m_anlz;
+    }
 
-    std::ifstream ifs(anlzPath.toStdString(), std::ifstream::binary);
-    kaitai::kstream ks(&ifs);
+  private:
+    std::ifstream m_ifs;
+    kaitai::kstream m_stream;
+    rekordbox_anlz_t m_anlz;
+};
 
-    rekordbox_anlz_t anlz = rekordbox_anlz_t(&ks);
+// This function is executed in a separate thread other than the main thread
+std::shared_ptr<AnlzFile> parseAnlzFile(const QString& anlzPath) {
+    if (!QFile(anlzPath).exists()) {
+        return nullptr;
+    }
+    try {
+        return std::make_shared<AnlzFile>(anlzPath);
+    } catch (const std::exception& e) {
+        qWarning() << "Failed to parse Rekordbox ANLZ file" << anlzPath << e.what();
+        return nullptr;
+    }
+}
 
+void readAnalyze(TrackPointer track,
+        mixxx::audio::SampleRate sampleRate,
+        int timingOffset,
+        bool ignoreCues,
+        AnlzFile& anlz) {
     const double sampleRateKhz = sampleRate / 1000.0;
 
     QList<memory_cue_loop_t> memoryCuesAndLoops;
     int lastHotCueIndex = 0;
 
     for (std::vector<rekordbox_anlz_t::tagged_section_t*>::iterator section =
-                    anlz.sections()->begin();
-            section != anlz.sections()->end();
+                    anlz->sections()->begin();
+            section != anlz->sections()->end();
             ++section) {
         switch ((*section)->fourcc()) {
         case rekordbox_anlz_t::SECTION_TAGS_BEAT_GRID: {
@@ -1248,6 +598,16 @@ TrackPointer RekordboxPlaylistModel::getTrack(const QModelIndex& index) const {
         return track;
     }
 
+    const QString anlzPath = index.sibling(index.row(), fieldIndex("analyze_path")).data().toString();
+    const QString anlzPathExt = anlzPath.left(anlzPath.length() - 3) + "EXT";
+
+    // Both ANLZ files are parsed by worker threads while
+    // the timing offset of the audio file is determined.
+    QFuture<std::shared_ptr<AnlzFile>> anlzFuture =
+            QtConcurrent::run(parseAnlzFile, anlzPath);
+    QFuture<std::shared_ptr<AnlzFile>> anlzExtFuture =
+            QtConcurrent::run(parseAnlzFile, anlzPathExt);
+
     // The following code accounts for timing offsets required to
     // correctly align timing information (cue points, loops, beatgrids)
     // exported from Rekordbox. This is caused by different MP3
@@ -1299,15 +659,19 @@ TrackPointer RekordboxPlaylistModel::getTrack(const QModelIndex& index) const {
 
     mixxx::audio::SampleRate sampleRate = track->getSampleRate();
 
-    QString anlzPath = index.sibling(index.row(), fieldIndex("analyze_path")).data().toString();
-    QString anlzPathExt = anlzPath.left(anlzPath.length() - 3) + "EXT";
-
-    if (QFile(anlzPathExt).exists()) {
+    const std::shared_ptr<AnlzFile> pAnlz = anlzFuture.result();
+    const std::shared_ptr<AnlzFile> pAnlzExt = anlzExtFuture.result();
+    if (pAnlz) {
+        qDebug() << "Rekordbox ANLZ path:" << anlzPath << " for: " << track->getTitle();
+    }
+    if (pAnlzExt) {
         // Beatgrids appear to be only correct in legacy ANLZ file
-        readAnalyze(track, sampleRate, timingOffset, true, anlzPath);
-        readAnalyze(track, sampleRate, timingOffset, false, anlzPathExt);
-    } else {
-        readAnalyze(track, sampleRate, timingOffset, false, anlzPath);
+        if (pAnlz) {
+            readAnalyze(track, sampleRate, timingOffset, true, *pAnlz);
+        }
+        readAnalyze(track, sampleRate, timingOffset, false, *pAnlzExt);
+    } else if (pAnlz) {
+        readAnalyze(track, sampleRate, timingOffset, false, *pAnlz);
     }
 
     // Assume that the key of the file the has been analyzed in Recordbox is correct
@@ -1345,7 +709,8 @@ RekordboxFeature::RekordboxFeature(
         Library* pLibrary,
         UserSettingsPointer pConfig)
         : BaseExternalLibraryFeature(pLibrary, pConfig, QStringLiteral("rekordbox")),
-          m_pSidebarModel(make_parented<TreeItemModel>(this)) {
+          m_pSidebarModel(make_parented<TreeItemModel>(this)),
+          m_importProgressPercent(-1) {
     QString tableName = kRekordboxLibraryTable;
     QString idColumn = LIBRARYTABLE_ID;
     QStringList columns = {
@@ -1390,14 +755,10 @@ RekordboxFeature::RekordboxFeature(
     QSqlDatabase database = m_pTrackCollection->database();
     ScopedTransaction transaction(database);
     // Drop any leftover temporary Rekordbox database tables if they exist
-    dropTable(database, kRekordboxPlaylistTracksTable);
-    dropTable(database, kRekordboxPlaylistsTable);
-    dropTable(database, kRekordboxLibraryTable);
+    RekordboxPdbImporter::dropTables(database);
 
     // Create new temporary Rekordbox database tables
-    createLibraryTable(database, kRekordboxLibraryTable);
-    createPlaylistsTable(database, kRekordboxPlaylistsTable);
-    createPlaylistTracksTable(database, kRekordboxPlaylistTracksTable);
+    RekordboxPdbImporter::createTables(database);
     transaction.commit();
 
     connect(&m_devicesFutureWatcher,
@@ -1414,14 +775,13 @@ RekordboxFeature::RekordboxFeature(
 
 RekordboxFeature::~RekordboxFeature() {
     m_devicesFuture.waitForFinished();
+    cancelImport();
     m_tracksFuture.waitForFinished();
 
     // Drop temporary Rekordbox database tables on shutdown
     QSqlDatabase database = m_pTrackCollection->database();
     ScopedTransaction transaction(database);
-    dropTable(database, kRekordboxPlaylistTracksTable);
-    dropTable(database, kRekordboxPlaylistsTable);
-    dropTable(database, kRekordboxLibraryTable);
+    RekordboxPdbImporter::dropTables(database);
     transaction.commit();
 }
 
@@ -1536,14 +896,14 @@ void RekordboxFeature::activateChild(const QModelIndex& index) {
     }
 
     // TreeItem list data holds 2 values in a QList and have different meanings.
-    // If the 2nd QList element IS_RECORDBOX_DEVICE, the 1st element is the
+    // If the 2nd QList element kIsRekordboxDevice, the 1st element is the
     // filesystem device path, and the parseDeviceDB concurrent thread to parse
     // the Rekcordbox database is initiated. If the 2nd element is
-    // IS_NOT_RECORDBOX_DEVICE, the 1st element is the playlist path and it is
+    // kIsNotRekordboxDevice, the 1st element is the playlist path and it is
     // activated.
     QList<QVariant> data = item->getData().toList();
     QString playlist = data[0].toString();
-    bool doParseDeviceDB = data[1].toString() == IS_RECORDBOX_DEVICE;
+    bool doParseDeviceDB = data[1].toString() == kIsRekordboxDevice;
 
     qDebug() << "RekordboxFeature::activateChild " << item->getLabel()
              << " playlist: " << playlist << " doParseDeviceDB: " << doParseDeviceDB;
@@ -1551,13 +911,32 @@ void RekordboxFeature::activateChild(const QModelIndex& index) {
     if (doParseDeviceDB) {
         qDebug() << "Parse Rekordbox Device DB: " << playlist;
 
-        // Let a worker thread do the XML parsing
-        m_tracksFuture = QtConcurrent::run(parseDeviceDB, static_cast<Library*>(parent())->dbConnectionPool(), item);
+        // Only a single device is imported at a time
+        cancelImport();
+
+        m_pImporter = std::make_shared<RekordboxPdbImporter>(item->getLabel(), playlist);
+        m_pImporter->setProgressCallback(
+                [this, pImporter = m_pImporter.get()](int processedPages, int totalPages) {
+                    const int percent = processedPages * 100 / totalPages;
+                    QMetaObject::invokeMethod(
+                            this,
+                            [this, pImporter, percent] {
+                                slotImportProgress(pImporter, percent);
+                            },
+                            Qt::QueuedConnection);
+                });
+        m_importProgressPercent = -1;
+
+        // Let a worker thread do the PDB parsing
+        m_tracksFuture = QtConcurrent::run(parseDeviceDB,
+                static_cast<Library*>(parent())->dbConnectionPool(),
+                m_pImporter,
+                item);
         m_tracksFutureWatcher.setFuture(m_tracksFuture);
 
         // This device is now a playlist element, future activations should treat is
         // as such
-        data[1] = QVariant(IS_NOT_RECORDBOX_DEVICE);
+        data[1] = QVariant(kIsNotRekordboxDevice);
         item->setData(QVariant(data));
     } else {
         qDebug() << "Activate Rekordbox Playlist: " << playlist;
@@ -1577,16 +956,14 @@ void RekordboxFeature::onRekordboxDevicesFound() {
 
     if (foundDevices.size() == 0) {
         // No Rekordbox devices found
+        cancelImport();
+
         ScopedTransaction transaction(database);
 
-        dropTable(database, kRekordboxPlaylistTracksTable);
-        dropTable(database, kRekordboxPlaylistsTable);
-        dropTable(database, kRekordboxLibraryTable);
+        RekordboxPdbImporter::dropTables(database);
 
         // Create new temporary Rekordbox database tables
-        createLibraryTable(database, kRekordboxLibraryTable);
-        createPlaylistsTable(database, kRekordboxPlaylistsTable);
-        createPlaylistTracksTable(database, kRekordboxPlaylistTracksTable);
+        RekordboxPdbImporter::createTables(database);
 
         transaction.commit();
 
@@ -1608,7 +985,11 @@ void RekordboxFeature::onRekordboxDevicesFound() {
 
             if (removeChild) {
                 // Device has since been unmounted, cleanup DB
-                clearDeviceTables(database, child);
+                const QString devicePath = child->getData().toList()[0].toString();
+                if (m_pImporter && m_pImporter->devicePath() == devicePath) {
+                    cancelImport();
+                }
+                RekordboxPdbImporter::clearDevice(database, child->getLabel(), devicePath);
 
                 m_pSidebarModel->removeRows(deviceIndex, 1);
             }
@@ -1642,15 +1023,77 @@ void RekordboxFeature::onRekordboxDevicesFound() {
     emit featureLoadingFinished(this);
 }
 
+void RekordboxFeature::cancelImport() {
+    if (!m_pImporter) {
+        return;
+    }
+    m_pImporter->cancel();
+    m_tracksFuture.waitForFinished();
+    QString devicePlaylist;
+    try {
+        devicePlaylist = m_tracksFuture.result();
+    } catch (const std::exception&) {
+        // Failed imports remove the rows of the device as well
+    }
+    if (devicePlaylist.isEmpty()) {
+        // The rows of the device have been removed
+        resetDeviceItem(m_pImporter->devicePath());
+    }
+}
+
+void RekordboxFeature::resetDeviceItem(const QString& devicePath) {
+    TreeItem* root = m_pSidebarModel->getRootItem();
+    for (int deviceIndex = 0; deviceIndex < root->childRows(); deviceIndex++) {
+        TreeItem* child = root->child(deviceIndex);
+        QList<QVariant> data = child->getData().toList();
+        if (data[0].toString() == devicePath) {
+            // The playlists that have been appended before the import
+            // failed would be appended again when activating the device
+            m_pSidebarModel->removeRows(0,
+                    child->childRows(),
+                    m_pSidebarModel->index(deviceIndex, 0));
+            data[1] = QVariant(kIsRekordboxDevice);
+            child->setData(QVariant(data));
+        }
+    }
+}
+
+void RekordboxFeature::slotImportProgress(
+        const RekordboxPdbImporter* pImporter,
+        int percent) {
+    if (pImporter != m_pImporter.get() || percent == m_importProgressPercent) {
+        // Stale or redundant
+        return;
+    }
+    m_importProgressPercent = percent;
+    m_title = tr("(loading %1%) Rekordbox").arg(percent);
+    emit featureIsLoading(this, false);
+}
+
 void RekordboxFeature::onTracksFound() {
     qDebug() << "onTracksFound";
     m_pSidebarModel->triggerRepaint();
 
+    const bool canceled = m_pImporter && m_pImporter->isCanceled();
+    const QString devicePath = m_pImporter ? m_pImporter->devicePath() : QString();
+    m_pImporter.reset();
+    // Remove the progress from the feature title
+    m_title = tr("Rekordbox");
+    emit featureIsLoading(this, false);
+
     QString devicePlaylist;
     try {
         devicePlaylist = m_tracksFuture.result();
     } catch (const std::exception& e) {
         qWarning() << "Failed to load Rekordbox database:" << e.what();
+        resetDeviceItem(devicePath);
+        return;
+    }
+    if (devicePlaylist.isEmpty()) {
+        resetDeviceItem(devicePath);
+        return;
+    }
+    if (canceled) {
         return;
     }
 
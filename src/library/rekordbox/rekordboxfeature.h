@@ -29,6 +29,7 @@
 #include <QStringListModel>
 #include <QtConcurrentRun>
 #include <fstream>
+#include <memory>
 
 #include "library/baseexternallibraryfeature.h"
 #include "library/baseexternalplaylistmodel.h"
@@ -38,6 +39,7 @@
 
 class TrackCollectionManager;
 class BaseExternalPlaylistModel;
+class RekordboxPdbImporter;
 
 class RekordboxPlaylistModel : public BaseExternalPlaylistModel {
     Q_OBJECT
@@ -78,6 +80,13 @@ class RekordboxFeature : public BaseExternalLibraryFeature {
 
   private:
     QString formatRootViewHtml() const;
+    /// Cancels a pending import and blocks until it has been finished
+    void cancelImport();
+    /// Marks the device item of a canceled or failed import as not
+    /// imported and removes its playlists, i.e. the next activation imports
+    /// the device again.
+    void resetDeviceItem(const QString& devicePath);
+    void slotImportProgress(const RekordboxPdbImporter* pImporter, int percent);
     std::unique_ptr<BaseSqlTableModel> createPlaylistModelForPlaylist(
             const QString& playlist) override;
 
@@ -88,6 +97,8 @@ class RekordboxFeature : public BaseExternalLibraryFeature {
     QFuture<QList<TreeItem*>> m_devicesFuture;
     QFutureWatcher<QString> m_tracksFutureWatcher;
     QFuture<QString> m_tracksFuture;
+    std::shared_ptr<RekordboxPdbImporter> m_pImporter;
+    int m_importProgressPercent;
     QString m_title;
 
     QSharedPointer<BaseTrackCache> m_trackSource;
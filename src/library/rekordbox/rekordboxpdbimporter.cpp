@@ -0,0 +1,648 @@
+#include "library/rekordbox/rekordboxpdbimporter.h"
+
+#include <QFileInfo>
+#include <QHash>
+#include <QMap>
+#include <QSqlQuery>
+#include <QTextCodec>
+#include <QVariant>
+#include <algorithm>
+#include <fstream>
+#include <memory>
+
+#include "library/dao/playlistdao.h"
+#include "library/queryutil.h"
+#include "library/rekordbox/kaitaistructs/rekordbox_pdb.h"
+#include "library/rekordbox/rekordboxconstants.h"
+#include "library/treeitem.h"
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("RekordboxPdbImporter");
+
+using mixxx::rekordboxconstants::colorFromID;
+using mixxx::rekordboxconstants::kIsNotRekordboxDevice;
+using mixxx::rekordboxconstants::kPLaylistPathDelimiter;
+using mixxx::rekordboxconstants::kRekordboxLibraryTable;
+using mixxx::rekordboxconstants::kRekordboxPlaylistsTable;
+using mixxx::rekordboxconstants::kRekordboxPlaylistTracksTable;
+
+// There are other types of tables (eg. COLOR), these are the only ones we are
+// interested at the moment. Perhaps when/if
+// https://github.com/mixxxdj/mixxx/issues/6852
+// is completed, this can be revisited.
+// Attempt was made to also recover HISTORY
+// playlists (which are found on removable Rekordbox devices), however
+// they didn't appear to contain valid row_ref_t structures.
+//
+// The lookup tables must be parsed before the tracks that refer to them.
+constexpr rekordbox_pdb_t::page_type_t kTableOrder[] = {
+        rekordbox_pdb_t::PAGE_TYPE_KEYS,
+        rekordbox_pdb_t::PAGE_TYPE_GENRES,
+        rekordbox_pdb_t::PAGE_TYPE_ARTISTS,
+        rekordbox_pdb_t::PAGE_TYPE_ALBUMS,
+        rekordbox_pdb_t::PAGE_TYPE_PLAYLIST_ENTRIES,
+        rekordbox_pdb_t::PAGE_TYPE_TRACKS,
+        rekordbox_pdb_t::PAGE_TYPE_PLAYLIST_TREE};
+
+bool createLibraryTable(QSqlDatabase& database, const QString& tableName) {
+    qDebug() << "Creating Rekordbox library table: " << tableName;
+
+    QSqlQuery query(database);
+    query.prepare(
+            "CREATE TABLE IF NOT EXISTS " + tableName +
+            " ("
+            "    id INTEGER PRIMARY KEY AUTOINCREMENT,"
+            "    rb_id INTEGER,"
+            "    artist TEXT,"
+            "    title TEXT,"
+            "    album TEXT,"
+            "    year INTEGER,"
+            "    genre TEXT,"
+            "    tracknumber TEXT,"
+            "    location TEXT UNIQUE,"
+            "    comment TEXT,"
+            "    duration INTEGER,"
+            "    bitrate TEXT,"
+            "    bpm FLOAT,"
+            "    key TEXT,"
+            "    rating INTEGER,"
+            "    analyze_path TEXT UNIQUE,"
+            "    device TEXT,"
+            "    color INTEGER"
+            ");");
+
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+
+    return true;
+}
+
+bool createPlaylistsTable(QSqlDatabase& database, const QString& tableName) {
+    qDebug() << "Creating Rekordbox playlists table: " << tableName;
+
+    QSqlQuery query(database);
+    query.prepare(
+            "CREATE TABLE IF NOT EXISTS " + tableName +
+            " ("
+            "    id INTEGER PRIMARY KEY,"
+            "    name TEXT UNIQUE"
+            ");");
+
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+
+    return true;
+}
+
+bool createPlaylistTracksTable(QSqlDatabase& database, const QString& tableName) {
+    qDebug() << "Creating Rekordbox playlist tracks table: " << tableName;
+
+    QSqlQuery query(database);
+    query.prepare(
+            "CREATE TABLE IF NOT EXISTS " + tableName +
+            " ("
+            "    id INTEGER PRIMARY KEY AUTOINCREMENT,"
+            "    playlist_id INTEGER REFERENCES rekordbox_playlists(id),"
+            "    track_id INTEGER REFERENCES rekordbox_library(id),"
+            "    position INTEGER"
+            ");");
+
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+
+    return true;
+}
+
+bool dropTable(QSqlDatabase& database, const QString& tableName) {
+    qDebug() << "Dropping Rekordbox table: " << tableName;
+
+    QSqlQuery query(database);
+    query.prepare("DROP TABLE IF EXISTS " + tableName);
+
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+
+    return true;
+}
+
+template<typename Base, typename T>
+inline bool instanceof (const T* ptr) {
+    return dynamic_cast<const Base*>(ptr) != nullptr;
+}
+
+// Function getText is roughly based on the following Java file:
+// https://github.com/Deep-Symmetry/crate-digger/commit/f09fa9fc097a2a428c43245ddd542ac1370c1adc
+// getText is needed because the strings in the PDB file "have a variety of obscure representations".
+QString getText(rekordbox_pdb_t::device_sql_string_t* deviceString) {
+    QString text;
+
+    if (instanceof <rekordbox_pdb_t::device_sql_short_ascii_t>(deviceString->body())) {
+        rekordbox_pdb_t::device_sql_short_ascii_t* shortAsciiString =
+                static_cast<rekordbox_pdb_t::device_sql_short_ascii_t*>(deviceString->body());
+        text = QString::fromStdString(shortAsciiString->text());
+    } else if (instanceof <rekordbox_pdb_t::device_sql_long_ascii_t>(deviceString->body())) {
+        rekordbox_pdb_t::device_sql_long_ascii_t* longAsciiString =
+                static_cast<rekordbox_pdb_t::device_sql_long_ascii_t*>(deviceString->body());
+        text = QString::fromStdString(longAsciiString->text());
+    } else if (instanceof <rekordbox_pdb_t::device_sql_long_utf16be_t>(deviceString->body())) {
+        rekordbox_pdb_t::device_sql_long_utf16be_t* longUtf16beString =
+                static_cast<rekordbox_pdb_t::device_sql_long_utf16be_t*>(deviceString->body());
+        const std::string& utf16be = longUtf16beString->text();
+        text = QTextCodec::codecForName("UTF-16BE")
+                       ->toUnicode(utf16be.data(), static_cast<int>(utf16be.length()));
+    }
+
+    // Some strings read from Rekordbox *.PDB files contain random null characters
+    // which if not removed cause Mixxx to crash when attempting to read file paths
+    return text.remove(QChar('\x0'));
+}
+
+/// A single page that has been read from the file. In contrast to
+/// rekordbox_pdb_t::page_ref_t::body() the page is not cached and
+/// all memory is released when the page goes out of scope.
+class PdbPage final {
+  public:
+    PdbPage(rekordbox_pdb_t* pRoot, uint32_t index)
+            : m_raw(readPage(pRoot, index)),
+              m_stream(m_raw),
+              m_page(&m_stream, nullptr, pRoot) {
+    }
+
+    rekordbox_pdb_t::page_t* operator->() {
+        return &m_page;
+    }
+
+  private:
+    static std::string readPage(rekordbox_pdb_t* pRoot, uint32_t index) {
+        kaitai::kstream* pStream = pRoot->_io();
+        pStream->seek(static_cast<uint64_t>(pRoot->len_page()) * index);
+        return pStream->read_bytes(pRoot->len_page());
+    }
+
+    // Must be initialized before the members that refer to it
+    std::string m_raw;
+    kaitai::kstream m_stream;
+    rekordbox_pdb_t::page_t m_page;
+};
+
+/// Reuses all prepared statements and state while parsing
+/// the rows of all pages.
+class PdbImport final {
+  public:
+    PdbImport(
+            QSqlDatabase database,
+            const QString& device,
+            const QString& devicePath)
+            : m_database(database),
+              m_device(device),
+              m_devicePath(devicePath),
+              m_insertTrackQuery(database),
+              m_insertPlaylistQuery(database),
+              m_insertPlaylistTrackQuery(database),
+              m_devicePlaylistId(kInvalidPlaylistId),
+              m_trackCount(0),
+              m_playlistCount(0),
+              m_folderOrPlaylistFound(false) {
+        m_insertTrackQuery.prepare("INSERT INTO " + kRekordboxLibraryTable +
+                " (rb_id, artist, title, album, year,"
+                "genre,comment,tracknumber,bpm, bitrate,duration, location,"
+                "rating,key,analyze_path,device,color) VALUES (:rb_id, :artist, "
+                ":title, :album, :year,:genre,"
+                ":comment, :tracknumber,:bpm, :bitrate,:duration, :location,"
+                ":rating,:key,:analyze_path,:device,:color)");
+        m_insertPlaylistQuery.prepare(
+                "INSERT INTO " + kRekordboxPlaylistsTable +
+                " (name) "
+                "VALUES (:name)");
+        m_insertPlaylistTrackQuery.prepare(
+                "INSERT INTO " + kRekordboxPlaylistTracksTable +
+                " (playlist_id, track_id, position) "
+                "VALUES (:playlist_id, :track_id, :position)");
+    }
+
+    int trackCount() const {
+        return m_trackCount;
+    }
+    int playlistCount() const {
+        return m_playlistCount;
+    }
+    bool isEmpty() const {
+        return m_trackCount == 0 && !m_folderOrPlaylistFound;
+    }
+
+    bool insertDevicePlaylist() {
+        // A playlist for all the tracks on a device
+        m_devicePlaylistId = insertPlaylist(m_devicePath);
+        return m_devicePlaylistId != kInvalidPlaylistId;
+    }
+
+    /// Returns the number of inserted tracks
+    int parseRow(
+            rekordbox_pdb_t::page_type_t type,
+            rekordbox_pdb_t::row_ref_t* pRowRef) {
+        switch (type) {
+        case rekordbox_pdb_t::PAGE_TYPE_KEYS: {
+            auto* pKey = static_cast<rekordbox_pdb_t::key_row_t*>(pRowRef->body());
+            m_keys.insert(pKey->id(), getText(pKey->name()));
+            return 0;
+        }
+        case rekordbox_pdb_t::PAGE_TYPE_GENRES: {
+            auto* pGenre = static_cast<rekordbox_pdb_t::genre_row_t*>(pRowRef->body());
+            m_genres.insert(pGenre->id(), getText(pGenre->name()));
+            return 0;
+        }
+        case rekordbox_pdb_t::PAGE_TYPE_ARTISTS: {
+            auto* pArtist = static_cast<rekordbox_pdb_t::artist_row_t*>(pRowRef->body());
+            m_artists.insert(pArtist->id(), getText(pArtist->name()));
+            return 0;
+        }
+        case rekordbox_pdb_t::PAGE_TYPE_ALBUMS: {
+            auto* pAlbum = static_cast<rekordbox_pdb_t::album_row_t*>(pRowRef->body());
+            m_albums.insert(pAlbum->id(), getText(pAlbum->name()));
+            return 0;
+        }
+        case rekordbox_pdb_t::PAGE_TYPE_PLAYLIST_ENTRIES: {
+            auto* pEntry = static_cast<rekordbox_pdb_t::playlist_entry_row_t*>(
+                    pRowRef->body());
+            m_playlistTracks[pEntry->playlist_id()][pEntry->entry_index()] =
+                    pEntry->track_id();
+            return 0;
+        }
+        case rekordbox_pdb_t::PAGE_TYPE_TRACKS: {
+            insertTrack(static_cast<rekordbox_pdb_t::track_row_t*>(pRowRef->body()));
+            return 1;
+        }
+        case rekordbox_pdb_t::PAGE_TYPE_PLAYLIST_TREE: {
+            auto* pNode = static_cast<rekordbox_pdb_t::playlist_tree_row_t*>(
+                    pRowRef->body());
+            m_playlistNames.insert(pNode->id(), getText(pNode->name()));
+            m_playlistIsFolder.insert(pNode->id(), pNode->is_folder());
+            m_playlistTree[pNode->parent_id()][pNode->sort_order()] = pNode->id();
+            m_folderOrPlaylistFound = true;
+            return 0;
+        }
+        default:
+            return 0;
+        }
+    }
+
+    /// Recursively inserts all playlists and creates the corresponding
+    /// TreeItem children of the device item.
+    void buildPlaylistTree(
+            TreeItem* pParent,
+            uint32_t parentID,
+            const QString& playlistPath) {
+        const QMap<uint32_t, uint32_t> children = m_playlistTree.value(parentID);
+        for (uint32_t childIndex = 0;
+                childIndex < static_cast<uint32_t>(children.size());
+                childIndex++) {
+            const uint32_t childID = children.value(childIndex);
+            if (childID == 0) {
+                continue;
+            }
+            const QString playlistItemName = m_playlistNames.value(childID);
+            const QString currentPath = playlistPath + kPLaylistPathDelimiter + playlistItemName;
+
+            TreeItem* pChild = nullptr;
+            if (pParent) {
+                QList<QString> data;
+                data << currentPath;
+                data << kIsNotRekordboxDevice;
+                pChild = pParent->appendChild(playlistItemName, QVariant(data));
+            }
+
+            // Create a playlist for this child
+            const int playlistID = insertPlaylist(currentPath);
+            if (playlistID == kInvalidPlaylistId) {
+                return;
+            }
+            ++m_playlistCount;
+
+            // Add playlist tracks for children
+            const QMap<uint32_t, uint32_t> tracks = m_playlistTracks.value(childID);
+            for (uint32_t trackIndex = 1;
+                    trackIndex <= static_cast<uint32_t>(tracks.size());
+                    trackIndex++) {
+                const uint32_t rbTrackID = tracks.value(trackIndex);
+                if (!insertPlaylistTrack(playlistID,
+                            m_trackIds.value(rbTrackID, -1),
+                            static_cast<int>(trackIndex))) {
+                    return;
+                }
+            }
+
+            if (m_playlistIsFolder.value(childID)) {
+                // If this child is a folder (playlists are only leaf nodes),
+                // build playlist tree for it
+                buildPlaylistTree(pChild, childID, currentPath);
+            }
+        }
+    }
+
+  private:
+    int insertPlaylist(const QString& name) {
+        m_insertPlaylistQuery.bindValue(":name", name);
+        if (!m_insertPlaylistQuery.exec()) {
+            LOG_FAILED_QUERY(m_insertPlaylistQuery)
+                    << "name:" << name;
+            return kInvalidPlaylistId;
+        }
+        return m_insertPlaylistQuery.lastInsertId().toInt();
+    }
+
+    bool insertPlaylistTrack(int playlistID, int trackID, int position) {
+        m_insertPlaylistTrackQuery.bindValue(":playlist_id", playlistID);
+        m_insertPlaylistTrackQuery.bindValue(":track_id", trackID);
+        m_insertPlaylistTrackQuery.bindValue(":position", position);
+        if (!m_insertPlaylistTrackQuery.exec()) {
+            LOG_FAILED_QUERY(m_insertPlaylistTrackQuery)
+                    << "playlistID:" << playlistID
+                    << "trackID:" << trackID
+                    << "position:" << position;
+            return false;
+        }
+        return true;
+    }
+
+    void insertTrack(rekordbox_pdb_t::track_row_t* pTrack) {
+        const uint32_t rbID = pTrack->id();
+
+        m_insertTrackQuery.bindValue(":rb_id", static_cast<int>(rbID));
+        m_insertTrackQuery.bindValue(":artist", m_artists.value(pTrack->artist_id()));
+        m_insertTrackQuery.bindValue(":title", getText(pTrack->title()));
+        m_insertTrackQuery.bindValue(":album", m_albums.value(pTrack->album_id()));
+        m_insertTrackQuery.bindValue(":genre", m_genres.value(pTrack->genre_id()));
+        m_insertTrackQuery.bindValue(":year", QString::number(pTrack->year()));
+        m_insertTrackQuery.bindValue(":duration", static_cast<int>(pTrack->duration()));
+        m_insertTrackQuery.bindValue(":location", m_devicePath + getText(pTrack->file_path()));
+        m_insertTrackQuery.bindValue(":rating", static_cast<int>(pTrack->rating()));
+        m_insertTrackQuery.bindValue(":comment", getText(pTrack->comment()));
+        m_insertTrackQuery.bindValue(":tracknumber", QString::number(pTrack->track_number()));
+        m_insertTrackQuery.bindValue(":key", m_keys.value(pTrack->key_id()));
+        m_insertTrackQuery.bindValue(":bpm", static_cast<float>(pTrack->tempo() / 100.0));
+        m_insertTrackQuery.bindValue(":bitrate", static_cast<int>(pTrack->bitrate()));
+        m_insertTrackQuery.bindValue(":analyze_path",
+                m_devicePath + getText(pTrack->analyze_path()));
+        m_insertTrackQuery.bindValue(":device", m_device);
+        m_insertTrackQuery.bindValue(":color",
+                mixxx::RgbColor::toQVariant(
+                        colorFromID(static_cast<int>(pTrack->color_id()))));
+
+        int trackID = -1;
+        if (m_insertTrackQuery.exec()) {
+            trackID = m_insertTrackQuery.lastInsertId().toInt();
+            m_trackIds.insert(rbID, trackID);
+        } else {
+            LOG_FAILED_QUERY(m_insertTrackQuery)
+                    << "rbID:" << rbID;
+        }
+
+        // Insert into device all tracks playlist
+        insertPlaylistTrack(m_devicePlaylistId, trackID, m_trackCount);
+        ++m_trackCount;
+    }
+
+    QSqlDatabase m_database;
+    const QString m_device;
+    const QString m_devicePath;
+
+    QSqlQuery m_insertTrackQuery;
+    QSqlQuery m_insertPlaylistQuery;
+    QSqlQuery m_insertPlaylistTrackQuery;
+
+    QHash<uint32_t, QString> m_keys;
+    QHash<uint32_t, QString> m_genres;
+    QHash<uint32_t, QString> m_artists;
+    QHash<uint32_t, QString> m_albums;
+    QHash<uint32_t, QString> m_playlistNames;
+    QHash<uint32_t, bool> m_playlistIsFolder;
+    // Ordered by sort order and entry index respectively
+    QHash<uint32_t, QMap<uint32_t, uint32_t>> m_playlistTree;
+    QHash<uint32_t, QMap<uint32_t, uint32_t>> m_playlistTracks;
+    // Maps the Rekordbox track id onto the row id in the library table
+    QHash<uint32_t, int> m_trackIds;
+
+    int m_devicePlaylistId;
+    int m_trackCount;
+    int m_playlistCount;
+    bool m_folderOrPlaylistFound;
+};
+
+} // anonymous namespace
+
+RekordboxPdbImporter::RekordboxPdbImporter(
+        QString device,
+        QString devicePath)
+        : m_device(std::move(device)),
+          m_devicePath(std::move(devicePath)),
+          m_batchSize(kDefaultBatchSize),
+          m_canceled(0) {
+}
+
+void RekordboxPdbImporter::setBatchSize(int batchSize) {
+    VERIFY_OR_DEBUG_ASSERT(batchSize > 0) {
+        batchSize = 1;
+    }
+    m_batchSize = batchSize;
+}
+
+std::optional<RekordboxPdbImporter::Result> RekordboxPdbImporter::importPdb(
+        QSqlDatabase database,
+        const QString& pdbPath,
+        TreeItem* pDeviceItem) {
+    kLogger.debug()
+            << "Importing"
+            << pdbPath
+            << "from device"
+            << m_device;
+
+    std::ifstream ifs(pdbPath.toStdString(), std::ifstream::binary);
+    if (!ifs.is_open()) {
+        kLogger.warning() << "Failed to open" << pdbPath;
+        return std::nullopt;
+    }
+    const qint64 fileSize = QFileInfo(pdbPath).size();
+
+    // Previously committed batches must be removed if the import fails
+    // or has been canceled
+    const auto result = [&]() -> std::optional<Result> {
+        auto pTransaction = std::make_unique<ScopedTransaction>(database);
+        PdbImport import(database, m_device, m_devicePath);
+        if (!import.insertDevicePlaylist()) {
+            return std::nullopt;
+        }
+        int pendingTracks = 0;
+        try {
+            kaitai::kstream ks(&ifs);
+            // Only parses the file header with the table index
+            rekordbox_pdb_t pdb(&ks);
+
+            const uint32_t lenPage = pdb.len_page();
+            const int totalPages = lenPage > 0
+                    ? static_cast<int>(fileSize / lenPage)
+                    : 0;
+            int processedPages = 0;
+
+            for (const auto type : kTableOrder) {
+                for (const auto* pTable : *pdb.tables()) {
+                    if (pTable->type() != type) {
+                        continue;
+                    }
+                    const uint32_t lastIndex = pTable->last_page()->index();
+                    uint32_t pageIndex = pTable->first_page()->index();
+                    // Guards against corrupt files with cyclic page references
+                    int remainingPages = totalPages;
+                    while (remainingPages-- > 0) {
+                        if (isCanceled()) {
+                            kLogger.info() << "Import canceled" << pdbPath;
+                            return std::nullopt;
+                        }
+                        PdbPage page(&pdb, pageIndex);
+                        if (page->is_data_page()) {
+                            for (auto* pRowGroup : *page->row_groups()) {
+                                for (auto* pRowRef : *pRowGroup->rows()) {
+                                    if (pRowRef->present()) {
+                                        pendingTracks += import.parseRow(type, pRowRef);
+                                    }
+                                }
+                            }
+                        }
+                        if (pendingTracks >= m_batchSize) {
+                            // Release the write lock from time to time
+                            if (!pTransaction->commit()) {
+                                return std::nullopt;
+                            }
+                            pTransaction = std::make_unique<ScopedTransaction>(database);
+                            pendingTracks = 0;
+                        }
+                        ++processedPages;
+                        if (m_progressCallback) {
+                            m_progressCallback(
+                                    processedPages,
+                                    std::max(processedPages, totalPages));
+                        }
+                        if (pageIndex == lastIndex) {
+                            break;
+                        }
+                        pageIndex = page->next_page()->index();
+                    }
+                }
+            }
+
+            if (!import.isEmpty()) {
+                // If we have found anything, recursively build playlist/folder
+                // TreeItem children for the original device TreeItem
+                import.buildPlaylistTree(pDeviceItem, 0, m_devicePath);
+            }
+            if (m_progressCallback) {
+                m_progressCallback(processedPages, processedPages);
+            }
+        } catch (const std::exception& e) {
+            kLogger.warning()
+                    << "Failed to parse"
+                    << pdbPath
+                    << e.what();
+            return std::nullopt;
+        }
+        if (!pTransaction->commit()) {
+            return std::nullopt;
+        }
+        return Result{import.trackCount(), import.playlistCount()};
+    }();
+
+    if (!result) {
+        clearDevice(database, m_device, m_devicePath);
+        return std::nullopt;
+    }
+
+    kLogger.info()
+            << "Found"
+            << result->trackCount
+            << "audio files and"
+            << result->playlistCount
+            << "playlists in Rekordbox device"
+            << m_device;
+    return result;
+}
+
+// static
+bool RekordboxPdbImporter::createTables(QSqlDatabase& database) {
+    return createLibraryTable(database, kRekordboxLibraryTable) &&
+            createPlaylistsTable(database, kRekordboxPlaylistsTable) &&
+            createPlaylistTracksTable(database, kRekordboxPlaylistTracksTable);
+}
+
+// static
+bool RekordboxPdbImporter::dropTables(QSqlDatabase& database) {
+    return dropTable(database, kRekordboxPlaylistTracksTable) &&
+            dropTable(database, kRekordboxPlaylistsTable) &&
+            dropTable(database, kRekordboxLibraryTable);
+}
+
+// static
+bool RekordboxPdbImporter::clearDevice(
+        QSqlDatabase& database,
+        const QString& device,
+        const QString& devicePath) {
+    ScopedTransaction transaction(database);
+
+    // All playlists of a device are named by their path starting
+    // with the device path
+    const QString playlistsOfDevice =
+            "SELECT id FROM " + kRekordboxPlaylistsTable +
+            " WHERE name=:path OR substr(name,1,:prefix_length)=:prefix";
+    const QString prefix = devicePath + kPLaylistPathDelimiter;
+
+    QSqlQuery deletePlaylistTracksQuery(database);
+    deletePlaylistTracksQuery.prepare(
+            "DELETE FROM " + kRekordboxPlaylistTracksTable +
+            " WHERE playlist_id IN (" + playlistsOfDevice + ")" +
+            " OR track_id IN (SELECT id FROM " + kRekordboxLibraryTable +
+            " WHERE device=:device)");
+    deletePlaylistTracksQuery.bindValue(":path", devicePath);
+    deletePlaylistTracksQuery.bindValue(":prefix_length", prefix.length());
+    deletePlaylistTracksQuery.bindValue(":prefix", prefix);
+    deletePlaylistTracksQuery.bindValue(":device", device);
+    if (!deletePlaylistTracksQuery.exec()) {
+        LOG_FAILED_QUERY(deletePlaylistTracksQuery)
+                << "device:" << device;
+        return false;
+    }
+
+    QSqlQuery deletePlaylistsQuery(database);
+    deletePlaylistsQuery.prepare(
+            "DELETE FROM " + kRekordboxPlaylistsTable +
+            " WHERE id IN (" + playlistsOfDevice + ")");
+    deletePlaylistsQuery.bindValue(":path", devicePath);
+    deletePlaylistsQuery.bindValue(":prefix_length", prefix.length());
+    deletePlaylistsQuery.bindValue(":prefix", prefix);
+    if (!deletePlaylistsQuery.exec()) {
+        LOG_FAILED_QUERY(deletePlaylistsQuery)
+                << "devicePath:" << devicePath;
+        return false;
+    }
+
+    QSqlQuery deleteTracksQuery(database);
+    deleteTracksQuery.prepare(
+            "DELETE FROM " + kRekordboxLibraryTable +
+            " WHERE device=:device");
+    deleteTracksQuery.bindValue(":device", device);
+    if (!deleteTracksQuery.exec()) {
+        LOG_FAILED_QUERY(deleteTracksQuery)
+                << "device:" << device;
+        return false;
+    }
+
+    return transaction.commit();
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <QAtomicInteger>
+#include <QSqlDatabase>
+#include <QString>
+#include <functional>
+#include <optional>
+
+class TreeItem;
+
+/// Imports the tracks and playlists of a removable device that has been
+/// prepared by Rekordbox from its export.pdb file into the temporary
+/// Rekordbox tables of the library database.
+///
+/// The file is parsed lazily page by page, i.e. only a single page is kept
+/// in memory at a time. Rows are inserted with prepared queries that are
+/// reused for all rows and committed in batches, which allows other
+/// connections to access the database while importing large devices.
+///
+/// An import could be canceled from any thread. All rows that have
+/// been inserted so far are removed when canceled.
+class RekordboxPdbImporter final {
+  public:
+    /// Invoked on the importing thread for each parsed page.
+    typedef std::function<void(int processedPages, int totalPages)> ProgressCallback;
+
+    struct Result {
+        int trackCount = 0;
+        int playlistCount = 0;
+    };
+
+    static constexpr int kDefaultBatchSize = 1000;
+
+    RekordboxPdbImporter(
+            QString device,
+            QString devicePath);
+
+    const QString& device() const {
+        return m_device;
+    }
+    const QString& devicePath() const {
+        return m_devicePath;
+    }
+
+    /// The number of imported tracks per transaction.
+    void setBatchSize(int batchSize);
+
+    void setProgressCallback(ProgressCallback progressCallback) {
+        m_progressCallback = std::move(progressCallback);
+    }
+
+    /// Thread-safe
+    void cancel() {
+        m_canceled.storeRelease(1);
+    }
+    bool isCanceled() const {
+        return m_canceled.loadAcquire() != 0;
+    }
+
+    /// Parses the file and inserts all tracks and playlists. The playlist
+    /// tree is appended to the device item if provided.
+    ///
+    /// Returns std::nullopt if the import failed or has been canceled.
+    std::optional<Result> importPdb(
+            QSqlDatabase database,
+            const QString& pdbPath,
+            TreeItem* pDeviceItem);
+
+    static bool createTables(QSqlDatabase& database);
+    static bool dropTables(QSqlDatabase& database);
+
+    /// Deletes all tracks and playlists of a device.
+    static bool clearDevice(
+            QSqlDatabase& database,
+            const QString& device,
+            const QString& devicePath);
+
+  private:
+    const QString m_device;
+    const QString m_devicePath;
+    int m_batchSize;
+    ProgressCallback m_progressCallback;
+    QAtomicInteger<int> m_canceled;
+};
@@ -1,6 +1,7 @@
 #include "library/scanner/importfilestask.h"
 
 #include "library/scanner/libraryscanner.h"
+#include "sources/soundsourceproxy.h"
 #include "moc_importfilestask.cpp"
 #include "util/timer.h"
 
@@ -23,6 +24,8 @@ ImportFilesTask::ImportFilesTask(LibraryScanner* pScanner,
 
 void ImportFilesTask::run() {
     ScopedTimer timer("ImportFilesTask::run");
+    QStringList newTrackLocations;
+    QList<mixxx::TrackMetadataPrefetcher::Request> prefetchRequests;
     for (const QFileInfo& fileInfo: m_filesToImport) {
         // If a flag was raised telling us to cancel the library scan then stop.
         if (m_scannerGlobal->shouldCancel()) {
@@ -48,10 +51,29 @@ void ImportFilesTask::run() {
                         << trackLocation;
                 continue;
             }
-            qDebug() << "Importing track" << trackLocation;
+            newTrackLocations.append(trackLocation);
+            // New tracks don't have any metadata yet
+            mixxx::TrackMetadataPrefetcher::Request request;
+            request.fileAccess = mixxx::FileAccess(mixxx::FileInfo(fileInfo), m_pToken);
+            request.resetMissingTagMetadata =
+                    m_scannerGlobal->syncTrackMetadataParams()
+                            .resetMissingTagMetadataOnImport;
+            prefetchRequests.append(std::move(request));
+        }
+    }
 
-            emit addNewTrack(trackLocation);
+    // The files are parsed concurrently while the library scanner
+    // is adding them one after another
+    const auto prefetchBatchId =
+            SoundSourceProxy::prefetchTrackMetadata(prefetchRequests);
+    for (const auto& trackLocation : qAsConst(newTrackLocations)) {
+        if (m_scannerGlobal->shouldCancel()) {
+            SoundSourceProxy::cancelPrefetchingTrackMetadata(prefetchBatchId);
+            setSuccess(false);
+            return;
         }
+        qDebug() << "Importing track" << trackLocation;
+        emit addNewTrack(trackLocation);
     }
     // Insert or update the hash in the database.
     emit directoryHashedAndScanned(m_dirPath, !m_prevHashExists, m_newHash);
@@ -98,6 +98,8 @@ class LibraryScanner : public QThread {
 
     mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
 
+    const UserSettingsPointer m_pConfig;
+
     // The pool of threads used for worker tasks.
     QThreadPool m_pool;
 
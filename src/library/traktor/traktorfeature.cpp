@@ -1,5 +1,6 @@
 #include "library/traktor/traktorfeature.h"
 
+#include <QHash>
 #include <QMap>
 #include <QMessageBox>
 #include <QRegularExpression>
@@ -8,6 +9,7 @@
 #include <QXmlStreamReader>
 #include <QtDebug>
 
+#include "library/externallibraryfingerprint.h"
 #include "library/library.h"
 #include "library/librarytablemodel.h"
 #include "library/missingtablemodel.h"
@@ -22,13 +24,414 @@
 
 namespace {
 
+const QString kNmlFingerprintKey = "mixxx.traktorfeature.nmlfingerprint";
+
+const QString kPlaylistPathDelimiter = "-->";
+
 QString fromTraktorSeparators(QString path) {
     // Traktor uses /: instead of just / as delimiting character for some reasons
     return path.replace("/:", "/");
 }
 
+struct TraktorTrack {
+    QString artist;
+    QString title;
+    QString album;
+    QString year;
+    QString genre;
+    QString tracknumber;
+    QString location;
+    QString comment;
+    int duration = 0;
+    int bitrate = 0;
+    float bpm = 0.0;
+    QString key;
+    int rating = 0;
+
+    bool operator==(const TraktorTrack&) const = default;
+    bool operator!=(const TraktorTrack&) const = default;
+};
+
+/// Parses a track in the music collection
+TraktorTrack parseTrack(QXmlStreamReader& xml) {
+    QString title;
+    QString artist;
+    QString album;
+    QString year;
+    QString genre;
+    //drive letter
+    QString volume;
+    QString path;
+    QString filename;
+    QString location;
+    float bpm = 0.0;
+    int bitrate = 0;
+    QString key;
+    //duration of a track
+    int playtime = 0;
+    int rating = 0;
+    QString comment;
+    QString tracknumber;
+
+    //get XML attributes of starting ENTRY tag
+    QXmlStreamAttributes attr = xml.attributes ();
+    title = attr.value(QLatin1String("TITLE")).toString();
+    artist = attr.value(QLatin1String("ARTIST")).toString();
+
+    //read all sub tags of ENTRY until we reach the closing ENTRY tag
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (xml.isStartElement()) {
+            if (xml.name() == QLatin1String("ALBUM")) {
+                QXmlStreamAttributes attr = xml.attributes ();
+                album = attr.value(QLatin1String("TITLE")).toString();
+                tracknumber = attr.value(QLatin1String("TRACK")).toString();
+                continue;
+            }
+            if (xml.name() == QLatin1String("LOCATION")) {
+                QXmlStreamAttributes attr = xml.attributes ();
+                volume = attr.value(QLatin1String("VOLUME")).toString();
+                path = attr.value(QLatin1String("DIR")).toString();
+                filename = attr.value(QLatin1String("FILE")).toString();
+                // compute the location, i.e, combining all the values
+                // On Windows the volume holds the drive letter e.g., d:
+                // On OS X, the volume is supposed to be "Macintosh HD" or "Macintosh SSD",
+                // which is a folder in /Volumes/ symlinked to root folder /
+                #if defined(__APPLE__)
+                location = "/Volumes/" + volume;
+                #else
+                location = volume;
+                #endif
+                location += fromTraktorSeparators(path);
+                location += filename;
+                continue;
+            }
+            if (xml.name() == QLatin1String("INFO")) {
+                QXmlStreamAttributes attr = xml.attributes();
+                key = attr.value(QLatin1String("KEY")).toString();
+                bitrate = attr.value(QLatin1String("BITRATE")).toString().toInt() / 1000;
+                playtime = attr.value(QLatin1String("PLAYTIME")).toString().toInt();
+                genre = attr.value(QLatin1String("GENRE")).toString();
+                year = attr.value(QLatin1String("RELEASE_DATE")).toString();
+                comment = attr.value(QLatin1String("COMMENT")).toString();
+                QString ranking_str = attr.value(QLatin1String("RANKING")).toString();
+                // A ranking in Traktor has ranges between 0 and 255 internally.
+                // This is same as the POPULARIMETER tag in IDv2,
+                // see http://help.mp3tag.de/main_tags.html
+                //
+                // Our rating values range from 1 to 5. The mapping is defined as follow
+                // ourRatingValue = TraktorRating / 51
+                bool ok = false;
+                int parsed_rating = ranking_str.toInt(&ok) / 51;
+                if (ok) {
+                    rating = parsed_rating;
+                }
+                continue;
+            }
+            if (xml.name() == QLatin1String("TEMPO")) {
+                QXmlStreamAttributes attr = xml.attributes ();
+                bpm = attr.value(QLatin1String("BPM")).toString().toFloat();
+                continue;
+            }
+            if (xml.name() == QLatin1String("MUSICAL_KEY")) {
+                QXmlStreamAttributes attr = xml.attributes();
+                // Traktor happens to use the same key numbering
+                key = KeyUtils::keyToString(
+                        KeyUtils::keyFromNumericValue(
+                                attr.value(QLatin1String("VALUE")).toInt()),
+                        KeyUtils::KeyNotation::Custom);
+                continue;
+            }
+        }
+        //We leave the infinite loop, if twe have the closing tag "ENTRY"
+        if (xml.name() == QLatin1String("ENTRY") && xml.isEndElement()) {
+            break;
+        }
+    }
+
+    // If we reach the end of ENTRY within the COLLECTION tag
+    return TraktorTrack{
+            .artist = artist,
+            .title = title,
+            .album = album,
+            .year = year,
+            .genre = genre,
+            .tracknumber = tracknumber,
+            .location = location,
+            .comment = comment,
+            .duration = playtime,
+            .bitrate = bitrate,
+            .bpm = bpm,
+            .key = key,
+            .rating = rating,
+    };
+}
+
 } // anonymous namespace
 
+/// Writes the differences between the parsed collection and the previous
+/// import into the Traktor tables. Unchanged tracks and playlists are
+/// not touched.
+class TraktorFeature::LibraryUpdate {
+  public:
+    explicit LibraryUpdate(const QSqlDatabase& database);
+
+    bool loadExistingRows();
+
+    /// Returns the id of the track or -1 on failure.
+    int importTrack(const TraktorTrack& track);
+    int trackId(const QString& location) const {
+        return m_trackIdsByLocation.value(location, -1);
+    }
+
+    bool importPlaylist(const QString& path, const QVector<int>& trackIds);
+
+    /// Deletes all tracks and playlists that have not been imported. Must
+    /// only be invoked after the whole collection has been parsed.
+    bool removeStaleRows();
+
+  private:
+    struct ExistingTrack {
+        int id;
+        TraktorTrack track;
+    };
+
+    bool writePlaylistTracks(int playlistId, const QVector<int>& trackIds);
+
+    const QSqlDatabase m_database;
+    QSqlQuery m_insertTrackQuery;
+    QSqlQuery m_updateTrackQuery;
+    QSqlQuery m_insertPlaylistQuery;
+    QSqlQuery m_insertPlaylistTrackQuery;
+
+    QHash<QString, ExistingTrack> m_existingTracks;
+    QHash<QString, int> m_existingPlaylistIds;
+    QHash<QString, int> m_trackIdsByLocation;
+    int m_writtenTrackCount;
+    int m_writtenPlaylistCount;
+};
+
+TraktorFeature::LibraryUpdate::LibraryUpdate(const QSqlDatabase& database)
+        : m_database(database),
+          m_insertTrackQuery(database),
+          m_updateTrackQuery(database),
+          m_insertPlaylistQuery(database),
+          m_insertPlaylistTrackQuery(database),
+          m_writtenTrackCount(0),
+          m_writtenPlaylistCount(0) {
+    m_insertTrackQuery.prepare(
+            "INSERT INTO traktor_library (artist, title, album, year,"
+            "genre,comment,tracknumber,bpm, bitrate,duration, location,"
+            "rating,key) VALUES (:artist, :title, :album, :year,:genre,"
+            ":comment, :tracknumber,:bpm, :bitrate,:duration, :location,"
+            ":rating,:key)");
+    m_updateTrackQuery.prepare(
+            "UPDATE traktor_library SET artist=:artist, title=:title, "
+            "album=:album, year=:year, genre=:genre, comment=:comment, "
+            "tracknumber=:tracknumber, bpm=:bpm, bitrate=:bitrate, "
+            "duration=:duration, location=:location, rating=:rating, "
+            "key=:key WHERE id=:id");
+    m_insertPlaylistQuery.prepare(
+            "INSERT INTO traktor_playlists (name) VALUES (:name)");
+    m_insertPlaylistTrackQuery.prepare(
+            "INSERT INTO traktor_playlist_tracks (playlist_id, track_id, position) "
+            "VALUES (:playlist_id, :track_id, :position)");
+}
+
+bool TraktorFeature::LibraryUpdate::loadExistingRows() {
+    QSqlQuery trackQuery(m_database);
+    trackQuery.prepare(
+            "SELECT id, artist, title, album, year, genre, tracknumber, "
+            "location, comment, duration, bitrate, bpm, key, rating "
+            "FROM traktor_library");
+    if (!trackQuery.exec()) {
+        LOG_FAILED_QUERY(trackQuery);
+        return false;
+    }
+    while (trackQuery.next()) {
+        ExistingTrack existing{
+                .id = trackQuery.value(0).toInt(),
+                .track = TraktorTrack{
+                        .artist = trackQuery.value(1).toString(),
+                        .title = trackQuery.value(2).toString(),
+                        .album = trackQuery.value(3).toString(),
+                        .year = trackQuery.value(4).toString(),
+                        .genre = trackQuery.value(5).toString(),
+                        .tracknumber = trackQuery.value(6).toString(),
+                        .location = trackQuery.value(7).toString(),
+                        .comment = trackQuery.value(8).toString(),
+                        .duration = trackQuery.value(9).toInt(),
+                        .bitrate = trackQuery.value(10).toInt(),
+                        .bpm = trackQuery.value(11).toFloat(),
+                        .key = trackQuery.value(12).toString(),
+                        .rating = trackQuery.value(13).toInt(),
+                },
+        };
+        m_existingTracks.insert(existing.track.location, existing);
+    }
+
+    QSqlQuery playlistQuery(m_database);
+    playlistQuery.prepare("SELECT id, name FROM traktor_playlists");
+    if (!playlistQuery.exec()) {
+        LOG_FAILED_QUERY(playlistQuery);
+        return false;
+    }
+    while (playlistQuery.next()) {
+        m_existingPlaylistIds.insert(
+                playlistQuery.value(1).toString(),
+                playlistQuery.value(0).toInt());
+    }
+    return true;
+}
+
+int TraktorFeature::LibraryUpdate::importTrack(const TraktorTrack& track) {
+    // Only the first entry of a file is imported
+    const auto imported = m_trackIdsByLocation.constFind(track.location);
+    if (imported != m_trackIdsByLocation.constEnd()) {
+        return imported.value();
+    }
+
+    int id = -1;
+    QSqlQuery* pQuery = &m_insertTrackQuery;
+    const auto existing = m_existingTracks.find(track.location);
+    if (existing != m_existingTracks.end()) {
+        id = existing.value().id;
+        const bool isUnchanged = existing.value().track == track;
+        m_existingTracks.erase(existing);
+        if (isUnchanged) {
+            m_trackIdsByLocation.insert(track.location, id);
+            return id;
+        }
+        pQuery = &m_updateTrackQuery;
+        pQuery->bindValue(":id", id);
+    }
+
+    QSqlQuery& query = *pQuery;
+    query.bindValue(":artist", track.artist);
+    query.bindValue(":title", track.title);
+    query.bindValue(":album", track.album);
+    query.bindValue(":genre", track.genre);
+    query.bindValue(":year", track.year);
+    query.bindValue(":duration", track.duration);
+    query.bindValue(":location", track.location);
+    query.bindValue(":rating", track.rating);
+    query.bindValue(":comment", track.comment);
+    query.bindValue(":tracknumber", track.tracknumber);
+    query.bindValue(":key", track.key);
+    query.bindValue(":bpm", track.bpm);
+    query.bindValue(":bitrate", track.bitrate);
+
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "Failed to import Traktor track" << track.location;
+        return -1;
+    }
+    if (id < 0) {
+        id = query.lastInsertId().toInt();
+    }
+    m_trackIdsByLocation.insert(track.location, id);
+    ++m_writtenTrackCount;
+    return id;
+}
+
+bool TraktorFeature::LibraryUpdate::importPlaylist(
+        const QString& path, const QVector<int>& trackIds) {
+    // In the database, the name of a playlist is specified by the unique path,
+    // e.g., /someFolderA/someFolderB/playlistA"
+    const auto existing = m_existingPlaylistIds.find(path);
+    if (existing != m_existingPlaylistIds.end()) {
+        const int playlistId = existing.value();
+        m_existingPlaylistIds.erase(existing);
+
+        QSqlQuery query(m_database);
+        query.prepare(
+                "SELECT track_id FROM traktor_playlist_tracks "
+                "WHERE playlist_id=:playlist_id ORDER BY position");
+        query.bindValue(":playlist_id", playlistId);
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+            return false;
+        }
+        QVector<int> existingTrackIds;
+        while (query.next()) {
+            existingTrackIds.append(query.value(0).toInt());
+        }
+        if (existingTrackIds == trackIds) {
+            return true;
+        }
+        ++m_writtenPlaylistCount;
+        return writePlaylistTracks(playlistId, trackIds);
+    }
+
+    m_insertPlaylistQuery.bindValue(":name", path);
+    if (!m_insertPlaylistQuery.exec()) {
+        LOG_FAILED_QUERY(m_insertPlaylistQuery)
+                << "Failed to insert playlist in TraktorTableModel:"
+                << path;
+        return false;
+    }
+    ++m_writtenPlaylistCount;
+    return writePlaylistTracks(m_insertPlaylistQuery.lastInsertId().toInt(), trackIds);
+}
+
+bool TraktorFeature::LibraryUpdate::writePlaylistTracks(
+        int playlistId, const QVector<int>& trackIds) {
+    QSqlQuery deleteQuery(m_database);
+    deleteQuery.prepare("DELETE FROM traktor_playlist_tracks WHERE playlist_id=:playlist_id");
+    deleteQuery.bindValue(":playlist_id", playlistId);
+    if (!deleteQuery.exec()) {
+        LOG_FAILED_QUERY(deleteQuery);
+        return false;
+    }
+
+    QSqlQuery& query = m_insertPlaylistTrackQuery;
+    for (int i = 0; i < trackIds.size(); ++i) {
+        query.bindValue(":playlist_id", playlistId);
+        query.bindValue(":track_id", trackIds[i]);
+        query.bindValue(":position", i + 1);
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query)
+                    << "trackid" << trackIds[i]
+                    << "playlist ID" << playlistId;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TraktorFeature::LibraryUpdate::removeStaleRows() {
+    QSqlQuery deleteTrackQuery(m_database);
+    deleteTrackQuery.prepare("DELETE FROM traktor_library WHERE id=:id");
+    for (auto it = m_existingTracks.constBegin(); it != m_existingTracks.constEnd(); ++it) {
+        deleteTrackQuery.bindValue(":id", it.value().id);
+        if (!deleteTrackQuery.exec()) {
+            LOG_FAILED_QUERY(deleteTrackQuery);
+            return false;
+        }
+    }
+
+    QSqlQuery deletePlaylistQuery(m_database);
+    deletePlaylistQuery.prepare("DELETE FROM traktor_playlists WHERE id=:id");
+    for (auto it = m_existingPlaylistIds.constBegin(); it != m_existingPlaylistIds.constEnd(); ++it) {
+        if (!writePlaylistTracks(it.value(), {})) {
+            return false;
+        }
+        deletePlaylistQuery.bindValue(":id", it.value());
+        if (!deletePlaylistQuery.exec()) {
+            LOG_FAILED_QUERY(deletePlaylistQuery);
+            return false;
+        }
+    }
+
+    qDebug() << "Updated Traktor library:"
+             << m_writtenTrackCount << "tracks written,"
+             << m_existingTracks.size() << "tracks removed,"
+             << m_writtenPlaylistCount << "playlists written,"
+             << m_existingPlaylistIds.size() << "playlists removed";
+    m_existingTracks.clear();
+    m_existingPlaylistIds.clear();
+    return true;
+}
+
 
 TraktorTrackModel::TraktorTrackModel(QObject* parent,
                                      TrackCollectionManager* pTrackCollectionManager,
@@ -205,20 +608,6 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
     thisThread->setPriority(QThread::LowPriority);
     //Invisible root item of Traktor's child model
     TreeItem* root = nullptr;
-    //Delete all table entries of Traktor feature
-    ScopedTransaction transaction(m_database);
-    clearTable("traktor_playlist_tracks");
-    clearTable("traktor_library");
-    clearTable("traktor_playlists");
-    transaction.commit();
-
-    transaction.transaction();
-    QSqlQuery query(m_database);
-    query.prepare("INSERT INTO traktor_library (artist, title, album, year,"
-                  "genre,comment,tracknumber,bpm, bitrate,duration, location,"
-                  "rating,key) VALUES (:artist, :title, :album, :year,:genre,"
-                  ":comment, :tracknumber,:bpm, :bitrate,:duration, :location,"
-                  ":rating,:key)");
 
     //Parse Trakor XML file using SAX (for performance)
     mixxx::FileInfo fileInfo(file);
@@ -227,6 +616,21 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
         qDebug() << "Cannot open Traktor music collection";
         return nullptr;
     }
+
+    if (ExternalLibraryFingerprint::load(m_database, kNmlFingerprintKey).matchesFile(file)) {
+        qDebug() << "Traktor music collection has not been modified since the last import";
+        return restorePlaylistTree();
+    }
+    const auto fingerprint = ExternalLibraryFingerprint::fromFile(file);
+
+    // Only the differences to the previous import are written. The previous
+    // import is retained if the collection could not be parsed.
+    ScopedTransaction transaction(m_database);
+    LibraryUpdate update(m_database);
+    if (!update.loadExistingRows()) {
+        return nullptr;
+    }
+
     QXmlStreamReader xml(&traktor_file);
     bool inCollectionTag = false;
     bool inPlaylistsTag = false;
@@ -242,7 +646,7 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
             // Each "ENTRY" tag in <COLLECTION> represents a track
             if (inCollectionTag && xml.name() == QLatin1String("ENTRY")) {
                 //parse track
-                parseTrack(xml, query);
+                update.importTrack(parseTrack(xml));
                 ++nAudioFiles; //increment number of files in the music collection
             }
             if (xml.name() == QLatin1String("PLAYLISTS")) {
@@ -250,12 +654,10 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
             }
             if (inPlaylistsTag && !isRootFolderParsed && xml.name() == QLatin1String("NODE")) {
                 QXmlStreamAttributes attr = xml.attributes();
-                QString nodetype = attr.value("TYPE").toString();
-                QString name = attr.value("NAME").toString();
-
-                if (nodetype == "FOLDER" && name == "$ROOT") {
+                if (attr.value(QLatin1String("TYPE")) == QLatin1String("FOLDER") &&
+                        attr.value(QLatin1String("NAME")) == QLatin1String("$ROOT")) {
                     //process all playlists
-                    root = parsePlaylists(xml);
+                    root = parsePlaylists(xml, &update);
                     isRootFolderParsed = true;
                 }
             }
@@ -279,130 +681,53 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
     }
 
     qDebug() << "Found: " << nAudioFiles << " audio files in Traktor";
+    if (m_cancelImport) {
+        ExternalLibraryFingerprint::reset(m_database, kNmlFingerprintKey);
+    } else if (update.removeStaleRows()) {
+        fingerprint.save(m_database, kNmlFingerprintKey);
+    }
     //initialize TraktorTableModel
     transaction.commit();
 
     return root;
 }
 
-void TraktorFeature::parseTrack(QXmlStreamReader &xml, QSqlQuery &query) {
-    QString title;
-    QString artist;
-    QString album;
-    QString year;
-    QString genre;
-    //drive letter
-    QString volume;
-    QString path;
-    QString filename;
-    QString location;
-    float bpm = 0.0;
-    int bitrate = 0;
-    QString key;
-    //duration of a track
-    int playtime = 0;
-    int rating = 0;
-    QString comment;
-    QString tracknumber;
-
-    //get XML attributes of starting ENTRY tag
-    QXmlStreamAttributes attr = xml.attributes ();
-    title = attr.value("TITLE").toString();
-    artist = attr.value("ARTIST").toString();
+TreeItem* TraktorFeature::restorePlaylistTree() {
+    QSqlQuery query(m_database);
+    query.prepare("SELECT name FROM traktor_playlists ORDER BY id");
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return nullptr;
+    }
 
-    //read all sub tags of ENTRY until we reach the closing ENTRY tag
-    while (!xml.atEnd()) {
-        xml.readNext();
-        if (xml.isStartElement()) {
-            if (xml.name() == QLatin1String("ALBUM")) {
-                QXmlStreamAttributes attr = xml.attributes ();
-                album = attr.value("TITLE").toString();
-                tracknumber = attr.value("TRACK").toString();
-                continue;
-            }
-            if (xml.name() == QLatin1String("LOCATION")) {
-                QXmlStreamAttributes attr = xml.attributes ();
-                volume = attr.value("VOLUME").toString();
-                path = attr.value("DIR").toString();
-                filename = attr.value("FILE").toString();
-                // compute the location, i.e, combining all the values
-                // On Windows the volume holds the drive letter e.g., d:
-                // On OS X, the volume is supposed to be "Macintosh HD" or "Macintosh SSD",
-                // which is a folder in /Volumes/ symlinked to root folder /
-                #if defined(__APPLE__)
-                location = "/Volumes/" + volume;
-                #else
-                location = volume;
-                #endif
-                location += fromTraktorSeparators(path);
-                location += filename;
-                continue;
-            }
-            if (xml.name() == QLatin1String("INFO")) {
-                QXmlStreamAttributes attr = xml.attributes();
-                key = attr.value("KEY").toString();
-                bitrate = attr.value("BITRATE").toString().toInt() / 1000;
-                playtime = attr.value("PLAYTIME").toString().toInt();
-                genre = attr.value("GENRE").toString();
-                year = attr.value("RELEASE_DATE").toString();
-                comment = attr.value("COMMENT").toString();
-                QString ranking_str = attr.value("RANKING").toString();
-                // A ranking in Traktor has ranges between 0 and 255 internally.
-                // This is same as the POPULARIMETER tag in IDv2,
-                // see http://help.mp3tag.de/main_tags.html
-                //
-                // Our rating values range from 1 to 5. The mapping is defined as follow
-                // ourRatingValue = TraktorRating / 51
-                bool ok = false;
-                int parsed_rating = ranking_str.toInt(&ok) / 51;
-                if (ok) {
-                    rating = parsed_rating;
-                }
-                continue;
-            }
-            if (xml.name() == QLatin1String("TEMPO")) {
-                QXmlStreamAttributes attr = xml.attributes ();
-                bpm = attr.value("BPM").toString().toFloat();
-                continue;
-            }
-            if (xml.name() == QLatin1String("MUSICAL_KEY")) {
-                QXmlStreamAttributes attr = xml.attributes();
-                // Traktor happens to use the same key numbering
-                key = KeyUtils::keyToString(
-                        KeyUtils::keyFromNumericValue(
-                                attr.value("VALUE").toInt()),
-                        KeyUtils::KeyNotation::Custom);
-                continue;
-            }
+    std::unique_ptr<TreeItem> rootItem = TreeItem::newRoot(this);
+    QHash<QString, TreeItem*> foldersByPath;
+    while (query.next()) {
+        // The name is the path of the playlist, e.g. "-->Folder A-->Playlist A"
+        const QString playlistPath = query.value(0).toString();
+        const QStringList names = playlistPath.split(kPlaylistPathDelimiter,
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+                Qt::SkipEmptyParts);
+#else
+                QString::SkipEmptyParts);
+#endif
+        if (names.isEmpty()) {
+            continue;
         }
-        //We leave the infinite loop, if twe have the closing tag "ENTRY"
-        if (xml.name() == QLatin1String("ENTRY") && xml.isEndElement()) {
-            break;
+        TreeItem* parent = rootItem.get();
+        QString folderPath;
+        for (int i = 0; i < names.size() - 1; ++i) {
+            folderPath += kPlaylistPathDelimiter;
+            folderPath += names[i];
+            TreeItem*& folder = foldersByPath[folderPath];
+            if (!folder) {
+                folder = parent->appendChild(names[i], folderPath);
+            }
+            parent = folder;
         }
+        parent->appendChild(names.last(), playlistPath);
     }
-
-    // If we reach the end of ENTRY within the COLLECTION tag
-    // Save parsed track to database
-    query.bindValue(":artist", artist);
-    query.bindValue(":title", title);
-    query.bindValue(":album", album);
-    query.bindValue(":genre", genre);
-    query.bindValue(":year", year);
-    query.bindValue(":duration", playtime);
-    query.bindValue(":location", location);
-    query.bindValue(":rating", rating);
-    query.bindValue(":comment", comment);
-    query.bindValue(":tracknumber", tracknumber);
-    query.bindValue(":key", key);
-    query.bindValue(":bpm", bpm);
-    query.bindValue(":bitrate", bitrate);
-
-    bool success = query.exec();
-    if (!success) {
-        qDebug() << "SQL Error in TraktorTableModel.cpp: line"
-                 << __LINE__ << " " << query.lastError();
-        return;
-    }
+    return rootItem.release();
 }
 
 // Purpose: Parsing all the folder and playlists of Traktor
@@ -410,27 +735,19 @@ void TraktorFeature::parseTrack(QXmlStreamReader &xml, QSqlQuery &query) {
 // A folder can contain folders and playlists. A playlist contains entries but no folders.
 // In other words, Traktor uses a tree structure to organize music.
 // Inner nodes represent folders while leaves are playlists.
-TreeItem* TraktorFeature::parsePlaylists(QXmlStreamReader &xml) {
+TreeItem* TraktorFeature::parsePlaylists(
+        QXmlStreamReader& xml, LibraryUpdate* pUpdate) {
 
     qDebug() << "Process RootFolder";
     //Each playlist is unique and can be identified by a path in the tree structure.
     QString current_path = "";
     QMap<QString,QString> map;
 
-    QString delimiter = "-->";
+    const QString& delimiter = kPlaylistPathDelimiter;
 
     std::unique_ptr<TreeItem> rootItem = TreeItem::newRoot(this);
     TreeItem* parent = rootItem.get();
 
-    QSqlQuery query_insert_to_playlists(m_database);
-    query_insert_to_playlists.prepare("INSERT INTO traktor_playlists (name) "
-                  "VALUES (:name)");
-
-    QSqlQuery query_insert_to_playlist_tracks(m_database);
-    query_insert_to_playlist_tracks.prepare(
-        "INSERT INTO traktor_playlist_tracks (playlist_id, track_id, position) "
-        "VALUES (:playlist_id, :track_id, :position)");
-
     while (!xml.atEnd() && !m_cancelImport) {
         //read next XML element
         xml.readNext();
@@ -438,8 +755,8 @@ TreeItem* TraktorFeature::parsePlaylists(QXmlStreamReader &xml) {
         if (xml.isStartElement()) {
             if (xml.name() == QLatin1String("NODE")) {
                 QXmlStreamAttributes attr = xml.attributes();
-                QString name = attr.value("NAME").toString();
-                QString type = attr.value("TYPE").toString();
+                QString name = attr.value(QLatin1String("NAME")).toString();
+                QString type = attr.value(QLatin1String("TYPE")).toString();
                //TODO: What happens if the folder node is a leaf (empty folder)
                // Idea: Hide empty folders :-)
                if (type == "FOLDER") {
@@ -456,10 +773,7 @@ TreeItem* TraktorFeature::parsePlaylists(QXmlStreamReader &xml) {
 
                     parent->appendChild(name, current_path);
                     // process all the entries within the playlist 'name' having path 'current_path'
-                    parsePlaylistEntries(xml,
-                            current_path,
-                            std::move(query_insert_to_playlists),
-                            std::move(query_insert_to_playlist_tracks));
+                    parsePlaylistEntries(xml, current_path, pUpdate);
                 }
             }
         }
@@ -488,75 +802,22 @@ TreeItem* TraktorFeature::parsePlaylists(QXmlStreamReader &xml) {
 void TraktorFeature::parsePlaylistEntries(
         QXmlStreamReader& xml,
         const QString& playlist_path,
-        QSqlQuery query_insert_into_playlist,
-        QSqlQuery query_insert_into_playlisttracks) {
-    // In the database, the name of a playlist is specified by the unique path,
-    // e.g., /someFolderA/someFolderB/playlistA"
-    query_insert_into_playlist.bindValue(":name", playlist_path);
-
-    if (!query_insert_into_playlist.exec()) {
-        LOG_FAILED_QUERY(query_insert_into_playlist)
-                << "Failed to insert playlist in TraktorTableModel:"
-                << playlist_path;
-        return;
-    }
-
-    // Get playlist id
-    QSqlQuery id_query(m_database);
-    id_query.prepare("select id from traktor_playlists where name=:path");
-    id_query.bindValue(":path", playlist_path);
-
-    if (!id_query.exec()) {
-        LOG_FAILED_QUERY(id_query) << "Could not get inserted playlist id for Traktor playlist::"
-                                   << playlist_path;
-        return;
-    }
-
-    //playlist_id = id_query.lastInsertId().toInt();
-    int playlist_id = kInvalidPlaylistId;
-    const int idColumn = id_query.record().indexOf("id");
-    while (id_query.next()) {
-        playlist_id = id_query.value(idColumn).toInt();
-    }
-
-    int playlist_position = 1;
+        LibraryUpdate* pUpdate) {
+    QVector<int> trackIds;
     while (!xml.atEnd() && !m_cancelImport) {
         //read next XML element
         xml.readNext();
         if (xml.isStartElement()) {
             if (xml.name() == QLatin1String("PRIMARYKEY")) {
                 QXmlStreamAttributes attr = xml.attributes();
-                QString key = attr.value("KEY").toString();
-                QString type = attr.value("TYPE").toString();
-                if (type == "TRACK") {
-                    key = fromTraktorSeparators(key);
+                if (attr.value(QLatin1String("TYPE")) == QLatin1String("TRACK")) {
+                    QString key = fromTraktorSeparators(
+                            attr.value(QLatin1String("KEY")).toString());
                     #if defined(__APPLE__)
                     key.prepend("/Volumes/");
                     #endif
-
-                    //insert to database
-                    int track_id = -1;
-                    QSqlQuery finder_query(m_database);
-                    finder_query.prepare("select id from traktor_library where location=:path");
-                    finder_query.bindValue(":path", key);
-
-                    if (!finder_query.exec()) {
-                        LOG_FAILED_QUERY(finder_query) << "Could not get track id:" << key;
-                        continue;
-                    }
-
-                    if (finder_query.next()) {
-                        track_id = finder_query.value(finder_query.record().indexOf("id")).toInt();
-                    }
-
-                    query_insert_into_playlisttracks.bindValue(":playlist_id", playlist_id);
-                    query_insert_into_playlisttracks.bindValue(":track_id", track_id);
-                    query_insert_into_playlisttracks.bindValue(":position", playlist_position++);
-                    if (!query_insert_into_playlisttracks.exec()) {
-                        LOG_FAILED_QUERY(query_insert_into_playlisttracks)
-                                << "trackid" << track_id << " with path " << key
-                                << "playlistname; " << playlist_path <<" with ID " << playlist_id;
-                    }
+                    // The tracks of the collection have already been imported
+                    trackIds.append(pUpdate->trackId(key));
                 }
             }
         }
@@ -567,18 +828,7 @@ void TraktorFeature::parsePlaylistEntries(
             }
         }
     }
-}
-
-void TraktorFeature::clearTable(const QString& table_name) {
-    QSqlQuery query(m_database);
-    query.prepare("delete from "+table_name);
-
-    if (!query.exec()) {
-        qDebug() << "Could not delete remove old entries from table "
-                 << table_name << " : " << query.lastError();
-    } else {
-        qDebug() << "Traktor table entries of '" << table_name << "' have been cleared.";
-    }
+    pUpdate->importPlaylist(playlist_path, trackIds);
 }
 
 QString TraktorFeature::getTraktorMusicDatabase() {
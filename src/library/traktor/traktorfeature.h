@@ -50,17 +50,18 @@ class TraktorFeature : public BaseExternalLibraryFeature {
   private:
     std::unique_ptr<BaseSqlTableModel> createPlaylistModelForPlaylist(
             const QString& playlist) override;
+    class LibraryUpdate;
+
     TreeItem* importLibrary(const QString& file);
-    // parses a track in the music collection
-    void parseTrack(QXmlStreamReader &xml, QSqlQuery &query);
     // Iterates over all playliost and folders and constructs the childmodel
-    TreeItem* parsePlaylists(QXmlStreamReader &xml);
+    TreeItem* parsePlaylists(QXmlStreamReader& xml, LibraryUpdate* pUpdate);
     // processes a particular playlist
     void parsePlaylistEntries(QXmlStreamReader& xml,
             const QString& playlist_path,
-            QSqlQuery query_insert_into_playlist,
-            QSqlQuery query_insert_into_playlisttracks);
-    void clearTable(const QString& table_name);
+            LibraryUpdate* pUpdate);
+    /// Returns the playlist tree of the previous import. Folders without
+    /// any playlists are omitted.
+    TreeItem* restorePlaylistTree();
     static QString getTraktorMusicDatabase();
     // private fields
     parented_ptr<TreeItemModel> m_pSidebarModel;
@@ -115,6 +115,7 @@ QString ChromaPrinter::getFingerprint(TrackPointer pTrack) {
     mixxx::AudioSource::OpenParams config;
     // always stereo / 2 channels (see below)
     config.setChannelCount(mixxx::audio::ChannelCount(2));
+    config.setAccessPattern(mixxx::AudioSource::AccessPattern::Sequential);
     auto pAudioSource = SoundSourceProxy(pTrack).openAudioSource(config);
     if (!pAudioSource) {
         qDebug()
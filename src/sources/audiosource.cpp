@@ -17,7 +17,8 @@ constexpr SINT kVerifyReadableMaxFrameCount = 1;
 } // anonymous namespace
 
 AudioSource::AudioSource(const QUrl& url)
-        : UrlResource(url) {
+        : UrlResource(url),
+          m_pCopyCounters(std::make_shared<CopyCounters>()) {
 }
 
 AudioSource::AudioSource(
@@ -26,7 +27,8 @@ AudioSource::AudioSource(
         : UrlResource(inner),
           m_signalInfo(signalInfo),
           m_bitrate(inner.m_bitrate),
-          m_frameIndexRange(inner.m_frameIndexRange) {
+          m_frameIndexRange(inner.m_frameIndexRange),
+          m_pCopyCounters(inner.m_pCopyCounters) {
 }
 
 AudioSource::OpenResult AudioSource::open(
@@ -334,10 +336,22 @@ ReadableSampleFrames AudioSource::readSampleFrames(
             // not and for a future re-design we need to account for this fact!!
             adjustFrameIndexRange(shrinkedFrameIndexRange);
         }
+        m_pCopyCounters->readFrameCount.fetch_add(
+                static_cast<quint64>(readable.frameLength()),
+                std::memory_order_relaxed);
         return readable;
     }
 }
 
+AudioSource::CopyStats AudioSource::getCopyStats() const {
+    CopyStats copyStats;
+    copyStats.readFrameCount =
+            m_pCopyCounters->readFrameCount.load(std::memory_order_relaxed);
+    copyStats.copiedByteCount =
+            m_pCopyCounters->copiedByteCount.load(std::memory_order_relaxed);
+    return copyStats;
+}
+
 void AudioSource::adjustFrameIndexRange(
         IndexRange frameIndexRange) {
     DEBUG_ASSERT(frameIndexRange.isSubrangeOf(m_frameIndexRange));
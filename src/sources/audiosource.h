@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
+
 #include "audio/streaminfo.h"
 #include "engine/engine.h"
 #include "sources/urlresource.h"
@@ -189,6 +192,17 @@ class AudioSource : public UrlResource, public virtual /*implements*/ IAudioSour
         Failed,
     };
 
+    /// Describes how the audio stream is going to be read. Decoders
+    /// may pass this on to the operating system to tune the read-ahead
+    /// of the underlying file.
+    enum class AccessPattern {
+        Default,
+        /// From the beginning to the end, e.g. for analysis
+        Sequential,
+        /// Seeking frequently, e.g. for playback in a deck
+        Random,
+    };
+
     // Parameters for opening audio sources
     class OpenParams {
       public:
@@ -215,8 +229,17 @@ class AudioSource : public UrlResource, public virtual /*implements*/ IAudioSour
             m_signalInfo.setSampleRate(sampleRate);
         }
 
+        AccessPattern getAccessPattern() const {
+            return m_accessPattern;
+        }
+        void setAccessPattern(
+                AccessPattern accessPattern) {
+            m_accessPattern = accessPattern;
+        }
+
       private:
         audio::SignalInfo m_signalInfo;
+        AccessPattern m_accessPattern = AccessPattern::Default;
     };
 
     // Opens the AudioSource for reading audio data.
@@ -238,6 +261,13 @@ class AudioSource : public UrlResource, public virtual /*implements*/ IAudioSour
     // opened, has already been closed, or if opening has failed.
     virtual void close() = 0;
 
+    /// Changes the access pattern of an open source that has been
+    /// passed in OpenParams, e.g. when an open source is reused for
+    /// a different purpose. The default implementation ignores it.
+    virtual void adviseAccessPattern(AccessPattern accessPattern) {
+        Q_UNUSED(accessPattern);
+    }
+
     const audio::SignalInfo& getSignalInfo() const {
         return m_signalInfo;
     }
@@ -301,9 +331,46 @@ class AudioSource : public UrlResource, public virtual /*implements*/ IAudioSour
     ReadableSampleFrames readSampleFrames(
             const WritableSampleFrames& sampleFrames);
 
+    /// Accounting of decoded sample data that did not arrive in the
+    /// caller's output buffer directly.
+    ///
+    /// Decoders are supposed to write into the WritableSampleFrames that
+    /// are passed to readSampleFrames() whenever the decoded format and
+    /// the number of channels match. Copying sample data between buffers
+    /// is only an explicit fallback, e.g. for decoded blocks that exceed
+    /// the requested range or for converting the number of channels.
+    struct CopyStats {
+        /// Frames that have been returned by readSampleFrames()
+        quint64 readFrameCount = 0;
+        /// Bytes that have been copied between intermediate buffers
+        /// while reading those frames
+        quint64 copiedByteCount = 0;
+
+        double copiedBytesPerFrame() const {
+            if (readFrameCount == 0) {
+                return 0.0;
+            }
+            return static_cast<double>(copiedByteCount) / readFrameCount;
+        }
+    };
+
+    /// The statistics are accumulated since the source has been created
+    /// and are shared with all proxies that wrap it. Thread-safe.
+    CopyStats getCopyStats() const;
+
   protected:
     explicit AudioSource(const QUrl& url);
 
+    /// Must be invoked by implementations whenever decoded samples are
+    /// copied from one buffer into another instead of being decoded into
+    /// the output buffer.
+    void countCopiedSamples(SINT sampleCount) {
+        DEBUG_ASSERT(sampleCount >= 0);
+        m_pCopyCounters->copiedByteCount.fetch_add(
+                static_cast<quint64>(sampleCount) * sizeof(CSAMPLE),
+                std::memory_order_relaxed);
+    }
+
     bool initChannelCountOnce(audio::ChannelCount channelCount);
     bool initChannelCountOnce(int channelCount) {
         return initChannelCountOnce(audio::ChannelCount(channelCount));
@@ -377,11 +444,19 @@ class AudioSource : public UrlResource, public virtual /*implements*/ IAudioSour
     std::optional<WritableSampleFrames> clampWritableSampleFrames(
             const WritableSampleFrames& sampleFrames) const;
 
+    struct CopyCounters {
+        std::atomic<quint64> readFrameCount{0};
+        std::atomic<quint64> copiedByteCount{0};
+    };
+
     audio::SignalInfo m_signalInfo;
 
     audio::Bitrate m_bitrate;
 
     IndexRange m_frameIndexRange;
+
+    // Shared with all proxies of this source
+    std::shared_ptr<CopyCounters> m_pCopyCounters;
 };
 
 typedef std::shared_ptr<AudioSource> AudioSourcePointer;
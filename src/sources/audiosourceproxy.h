@@ -23,6 +23,10 @@ class AudioSourceProxy : public AudioSource {
         m_pAudioSource->close();
     }
 
+    void adviseAccessPattern(AccessPattern accessPattern) override {
+        m_pAudioSource->adviseAccessPattern(accessPattern);
+    }
+
   protected:
     OpenResult tryOpen(
             OpenMode mode,
@@ -45,7 +49,9 @@ class AudioSourceProxy : public AudioSource {
         adjustFrameIndexRangeOn(*m_pAudioSource, frameIndexRange);
     }
 
-    const AudioSourcePointer m_pAudioSource;
+    /// Only reset by derived classes that hand over the delegate, e.g.
+    /// to a pool, after which they must not forward any calls.
+    AudioSourcePointer m_pAudioSource;
 };
 
 } // namespace mixxx
@@ -66,6 +66,7 @@ inline bool isDisjunct(
 ReadableSampleFrames AudioSourceStereoProxy::readSampleFramesClamped(
         const WritableSampleFrames& sampleFrames) {
     if (m_pAudioSource->getSignalInfo().getChannelCount() == kChannelCount) {
+        // Zero-copy: The source decodes directly into the output buffer
         return readSampleFramesClampedOn(*m_pAudioSource, sampleFrames);
     }
 
@@ -125,6 +126,9 @@ ReadableSampleFrames AudioSourceStereoProxy::readSampleFramesClamped(
                 readableSampleFrames.frameLength(),
                 m_pAudioSource->getSignalInfo().getChannelCount());
     }
+    // The channel conversion is the fallback that copies all samples
+    // from the temporary buffer
+    countCopiedSamples(writableSlice.length());
     return ReadableSampleFrames(
             readableSampleFrames.frameIndexRange(),
             SampleBuffer::ReadableSlice(
@@ -0,0 +1,266 @@
+#include "sources/ffmpegseekindex.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFuture>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QtConcurrentRun>
+#include <algorithm>
+
+#include "util/assert.h"
+#include "util/cachedirectory.h"
+#include "util/fileidentity.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("FFmpegSeekIndexCache");
+
+// "MXFI"
+constexpr quint32 kMagic = 0x4d584649;
+constexpr quint32 kVersion = 1;
+
+const QString kFileSuffix = QStringLiteral(".ffseek");
+
+// The least recently used indexes are removed at startup when exceeding
+// this size. The index of a 5 minute track takes a few 10 KiB.
+constexpr qint64 kMaxCacheSize = 64 * 1024 * 1024;
+
+QMutex s_mutex;
+QString s_dirPath;
+
+QString filePathForKey(const QString& dirPath, const QString& cacheKey) {
+    return QDir(dirPath).filePath(cacheKey + kFileSuffix);
+}
+
+} // anonymous namespace
+
+bool FFmpegSeekIndex::append(const Entry& entry) {
+    VERIFY_OR_DEBUG_ASSERT(!m_complete) {
+        return false;
+    }
+    if (!m_entries.empty()) {
+        const auto& lastEntry = m_entries.back();
+        if (entry.pts <= lastEntry.pts ||
+                entry.pos <= lastEntry.pos ||
+                entry.frameIndex < lastEntry.frameIndex) {
+            return false;
+        }
+    }
+    m_entries.push_back(entry);
+    return true;
+}
+
+const FFmpegSeekIndex::Entry* FFmpegSeekIndex::findEntry(SINT frameIndex) const {
+    // The first entry that starts after frameIndex
+    const auto iNext = std::upper_bound(m_entries.begin(),
+            m_entries.end(),
+            frameIndex,
+            [](SINT frameIndex, const Entry& entry) {
+                return frameIndex < entry.frameIndex;
+            });
+    if (iNext == m_entries.begin()) {
+        return nullptr;
+    }
+    if (iNext == m_entries.end() && !m_complete) {
+        // The packet that contains frameIndex might not have
+        // been recorded yet
+        return nullptr;
+    }
+    return &*(iNext - 1);
+}
+
+// static
+void FFmpegSeekIndexCache::setDirectory(const QString& dirPath) {
+    {
+        QMutexLocker locked(&s_mutex);
+        s_dirPath = dirPath;
+    }
+    if (dirPath.isEmpty()) {
+        return;
+    }
+    // Nobody waits for the result
+    const QFuture<int> future = QtConcurrent::run([dirPath] {
+        return pruneCacheDirectory(dirPath, QChar('*') + kFileSuffix, kMaxCacheSize);
+    });
+    Q_UNUSED(future);
+}
+
+// static
+QString FFmpegSeekIndexCache::directory() {
+    QMutexLocker locked(&s_mutex);
+    return s_dirPath;
+}
+
+// static
+QString FFmpegSeekIndexCache::cacheKeyForFile(const QString& localFileName) {
+    const auto identity = FileIdentity::fromFile(localFileName);
+    if (!identity.isValid()) {
+        return QString();
+    }
+    // The cached index doesn't contain the identity for comparing
+    // the modification time when loading it
+    return QStringLiteral("%1-%2").arg(
+            identity.cacheKey(),
+            QString::number(identity.lastModifiedMs()));
+}
+
+// static
+std::optional<FFmpegSeekIndex> FFmpegSeekIndexCache::load(
+        const QString& cacheKey,
+        const FFmpegSeekIndex::StreamInfo& streamInfo) {
+    const QString dirPath = directory();
+    if (dirPath.isEmpty() || cacheKey.isEmpty()) {
+        return std::nullopt;
+    }
+    QFile file(filePathForKey(dirPath, cacheKey));
+    if (!file.open(QIODevice::ReadOnly)) {
+        // Not cached yet
+        return std::nullopt;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+    quint32 magic;
+    quint32 version;
+    in >> magic >> version;
+    if (in.status() != QDataStream::Ok || magic != kMagic || version != kVersion) {
+        kLogger.info() << "Ignoring seek index with unsupported format" << file.fileName();
+        return std::nullopt;
+    }
+    FFmpegSeekIndex::StreamInfo cachedStreamInfo;
+    QByteArray compressedEntries;
+    in >> cachedStreamInfo.streamIndex >> cachedStreamInfo.codecId >>
+            cachedStreamInfo.timeBaseNum >> cachedStreamInfo.timeBaseDen >>
+            cachedStreamInfo.sampleRate >> compressedEntries;
+    if (in.status() != QDataStream::Ok) {
+        kLogger.warning() << "Failed to read seek index" << file.fileName();
+        return std::nullopt;
+    }
+    if (cachedStreamInfo != streamInfo) {
+        // Might happen after upgrading FFmpeg
+        kLogger.info() << "Ignoring seek index of a different stream" << file.fileName();
+        return std::nullopt;
+    }
+
+    // The entries are delta encoded
+    const QByteArray entryData = qUncompress(compressedEntries);
+    QDataStream entryStream(entryData);
+    entryStream.setVersion(QDataStream::Qt_5_0);
+    quint32 entryCount;
+    entryStream >> entryCount;
+    if (entryStream.status() != QDataStream::Ok || entryCount == 0) {
+        kLogger.warning() << "Invalid seek index" << file.fileName();
+        return std::nullopt;
+    }
+    FFmpegSeekIndex seekIndex(streamInfo);
+    seekIndex.m_entries.reserve(entryCount);
+    qint64 firstPts;
+    qint64 firstPos;
+    qint64 firstFrameIndex;
+    entryStream >> firstPts >> firstPos >> firstFrameIndex;
+    FFmpegSeekIndex::Entry entry{firstPts, firstPos, 0, static_cast<SINT>(firstFrameIndex)};
+    for (quint32 i = 0; i < entryCount; ++i) {
+        if (i > 0) {
+            quint32 ptsDelta;
+            quint32 posDelta;
+            quint32 frameIndexDelta;
+            entryStream >> ptsDelta >> posDelta >> frameIndexDelta;
+            entry.pts += ptsDelta;
+            entry.pos += posDelta;
+            entry.frameIndex += frameIndexDelta;
+        }
+        qint32 size;
+        entryStream >> size;
+        entry.size = size;
+        if (entryStream.status() != QDataStream::Ok ||
+                entry.size < 0 ||
+                !seekIndex.append(entry)) {
+            kLogger.warning() << "Invalid seek index" << file.fileName();
+            return std::nullopt;
+        }
+    }
+    seekIndex.setComplete();
+    touchCacheFile(file.fileName());
+    return seekIndex;
+}
+
+// static
+bool FFmpegSeekIndexCache::store(
+        const QString& cacheKey,
+        const FFmpegSeekIndex& seekIndex) {
+    const QString dirPath = directory();
+    if (dirPath.isEmpty() || cacheKey.isEmpty() || seekIndex.isEmpty()) {
+        return false;
+    }
+    // Only complete indexes are shared with other SoundSources
+    VERIFY_OR_DEBUG_ASSERT(seekIndex.isComplete()) {
+        return false;
+    }
+    if (!QDir().mkpath(dirPath)) {
+        kLogger.warning() << "Failed to create directory" << dirPath;
+        return false;
+    }
+
+    QByteArray entryData;
+    {
+        QDataStream entryStream(&entryData, QIODevice::WriteOnly);
+        entryStream.setVersion(QDataStream::Qt_5_0);
+        const auto& entries = seekIndex.entries();
+        entryStream << static_cast<quint32>(entries.size());
+        const auto& firstEntry = entries.front();
+        entryStream << static_cast<qint64>(firstEntry.pts)
+                    << static_cast<qint64>(firstEntry.pos)
+                    << static_cast<qint64>(firstEntry.frameIndex)
+                    << static_cast<qint32>(firstEntry.size);
+        for (std::size_t i = 1; i < entries.size(); ++i) {
+            // Ensured by append()
+            DEBUG_ASSERT(entries[i].pts > entries[i - 1].pts);
+            DEBUG_ASSERT(entries[i].pos > entries[i - 1].pos);
+            DEBUG_ASSERT(entries[i].frameIndex >= entries[i - 1].frameIndex);
+            entryStream << static_cast<quint32>(entries[i].pts - entries[i - 1].pts)
+                        << static_cast<quint32>(entries[i].pos - entries[i - 1].pos)
+                        << static_cast<quint32>(entries[i].frameIndex - entries[i - 1].frameIndex)
+                        << static_cast<qint32>(entries[i].size);
+        }
+    }
+
+    // QSaveFile replaces the file atomically, so concurrent readers
+    // never see a partially written index
+    QSaveFile file(filePathForKey(dirPath, cacheKey));
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning() << "Failed to write seek index" << file.fileName();
+        return false;
+    }
+    const auto& streamInfo = seekIndex.streamInfo();
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << kMagic << kVersion;
+    out << streamInfo.streamIndex << streamInfo.codecId
+        << streamInfo.timeBaseNum << streamInfo.timeBaseDen
+        << streamInfo.sampleRate << qCompress(entryData);
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        kLogger.warning() << "Failed to write seek index" << file.fileName();
+        return false;
+    }
+    return true;
+}
+
+// static
+void FFmpegSeekIndexCache::storeInBackground(
+        const QString& cacheKey,
+        FFmpegSeekIndex seekIndex) {
+    // Nobody waits for the result
+    const QFuture<bool> future = QtConcurrent::run(
+            [cacheKey, seekIndex = std::move(seekIndex)] {
+                return store(cacheKey, seekIndex);
+            });
+    Q_UNUSED(future);
+}
+
+} // namespace mixxx
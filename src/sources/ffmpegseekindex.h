@@ -0,0 +1,124 @@
+#pragma once
+
+#include <QString>
+#include <optional>
+#include <vector>
+
+#include "util/types.h"
+
+namespace mixxx {
+
+/// A packet-level seek index of an audio stream that is decoded by
+/// SoundSourceFFmpeg.
+///
+/// Each entry maps the presentation time stamp of a packet to its byte
+/// offset in the file and to the index of the first sample frame that is
+/// decoded from it. The index is recorded while decoding the stream
+/// sequentially and allows to seek exactly to the start of any packet,
+/// independent of how accurately the demuxer itself is able to seek.
+class FFmpegSeekIndex final {
+  public:
+    struct Entry {
+        qint64 pts;
+        qint64 pos;
+        int size;
+        SINT frameIndex;
+    };
+
+    /// Identifies the stream that the index has been recorded for.
+    struct StreamInfo {
+        int streamIndex = -1;
+        int codecId = 0;
+        int timeBaseNum = 0;
+        int timeBaseDen = 0;
+        int sampleRate = 0;
+
+        friend bool operator==(const StreamInfo& lhs, const StreamInfo& rhs) {
+            return lhs.streamIndex == rhs.streamIndex &&
+                    lhs.codecId == rhs.codecId &&
+                    lhs.timeBaseNum == rhs.timeBaseNum &&
+                    lhs.timeBaseDen == rhs.timeBaseDen &&
+                    lhs.sampleRate == rhs.sampleRate;
+        }
+        friend bool operator!=(const StreamInfo& lhs, const StreamInfo& rhs) {
+            return !(lhs == rhs);
+        }
+    };
+
+    explicit FFmpegSeekIndex(const StreamInfo& streamInfo = StreamInfo())
+            : m_streamInfo(streamInfo),
+              m_complete(false) {
+    }
+
+    const StreamInfo& streamInfo() const {
+        return m_streamInfo;
+    }
+
+    const std::vector<Entry>& entries() const {
+        return m_entries;
+    }
+    bool isEmpty() const {
+        return m_entries.empty();
+    }
+
+    /// Packets must be appended in decoding order without gaps.
+    /// Returns false if the packet does not succeed the last entry.
+    bool append(const Entry& entry);
+
+    /// Marks the index as complete after the end of the stream has
+    /// been reached. A complete index is immutable.
+    void setComplete() {
+        m_complete = true;
+    }
+    bool isComplete() const {
+        return m_complete;
+    }
+
+    /// Returns the entry of the last packet that starts at or before
+    /// frameIndex if the index covers frameIndex, i.e. if a succeeding
+    /// packet is known or if the index is complete. Otherwise returns
+    /// nullptr.
+    const Entry* findEntry(SINT frameIndex) const;
+
+  private:
+    friend class FFmpegSeekIndexCache;
+
+    StreamInfo m_streamInfo;
+    std::vector<Entry> m_entries;
+    bool m_complete;
+};
+
+/// Persists complete seek indexes in a directory with one compressed
+/// binary file per audio file, so the index does not need to be recorded
+/// again each time a file is opened.
+///
+/// The files are keyed by the file size, the modification time, and a
+/// digest of the first and the last KiB of the audio file.
+///
+/// All functions are thread-safe.
+class FFmpegSeekIndexCache final {
+  public:
+    /// Called from the main thread at startup. An empty path disables the
+    /// cache, which is the default.
+    static void setDirectory(const QString& dirPath);
+    static QString directory();
+    static bool isEnabled() {
+        return !directory().isEmpty();
+    }
+
+    /// Returns an empty string if the file cannot be read.
+    static QString cacheKeyForFile(const QString& localFileName);
+
+    static std::optional<FFmpegSeekIndex> load(
+            const QString& cacheKey,
+            const FFmpegSeekIndex::StreamInfo& streamInfo);
+    static bool store(
+            const QString& cacheKey,
+            const FFmpegSeekIndex& seekIndex);
+    /// Stores the index on a background thread.
+    static void storeInBackground(
+            const QString& cacheKey,
+            FFmpegSeekIndex seekIndex);
+};
+
+} // namespace mixxx
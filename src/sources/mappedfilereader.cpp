@@ -0,0 +1,358 @@
+#include "sources/mappedfilereader.h"
+
+#include <QStorageInfo>
+#include <algorithm>
+#include <cstring>
+
+#if defined(Q_OS_UNIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("MappedFileReader");
+
+bool isOnNetworkShare(const QString& fileName) {
+    const QByteArray fileSystemType =
+            QStorageInfo(fileName).fileSystemType().toLower();
+    return fileSystemType.startsWith("nfs") ||
+            fileSystemType.startsWith("cifs") ||
+            fileSystemType.startsWith("smb") ||
+            fileSystemType.startsWith("afp") ||
+            fileSystemType.startsWith("webdav") ||
+            fileSystemType.startsWith("fuse.sshfs");
+}
+
+#if defined(Q_OS_UNIX)
+qint64 pageSize() {
+    static const qint64 s_pageSize = sysconf(_SC_PAGESIZE);
+    return s_pageSize;
+}
+#endif
+
+} // anonymous namespace
+
+MappedFileReader::MappedFileReader()
+        : m_size(0),
+          m_pos(0),
+          m_accessPattern(AudioSource::AccessPattern::Default),
+          m_pMappedData(nullptr),
+          m_uncheckedSize(0),
+          m_prefetchStart(0),
+          m_prefetchEnd(0),
+          m_blockStart(0),
+          m_blockLength(0) {
+}
+
+MappedFileReader::~MappedFileReader() {
+    close();
+}
+
+bool MappedFileReader::open(
+        const QString& fileName,
+        AudioSource::AccessPattern accessPattern,
+        Backend backend) {
+    close();
+    m_file.setFileName(fileName);
+    // Blocks are buffered by this class and Qt's buffer would
+    // only add another copy
+    if (!m_file.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        kLogger.warning()
+                << "Failed to open file"
+                << fileName
+                << m_file.errorString();
+        return false;
+    }
+    m_size = m_file.size();
+    if (backend == Backend::Auto) {
+        backend = accessPattern == AudioSource::AccessPattern::Random ||
+                        isOnNetworkShare(fileName)
+                ? Backend::Blocks
+                : Backend::Mapped;
+    }
+    if (backend == Backend::Mapped && m_size > 0) {
+        m_pMappedData = m_file.map(0, m_size);
+        if (!m_pMappedData) {
+            kLogger.info()
+                    << "Reading file in blocks, because it could not be mapped:"
+                    << fileName
+                    << m_file.errorString();
+        }
+    }
+    if (!m_pMappedData) {
+        m_block.resize(kBlockSize);
+    }
+    m_accessPattern = accessPattern;
+    applyAccessPattern();
+    return true;
+}
+
+void MappedFileReader::unmap() {
+    DEBUG_ASSERT(m_pMappedData);
+    m_file.unmap(m_pMappedData);
+    m_pMappedData = nullptr;
+    m_uncheckedSize = 0;
+    m_prefetchStart = 0;
+    m_prefetchEnd = 0;
+    m_block.resize(kBlockSize);
+    m_blockStart = 0;
+    m_blockLength = 0;
+}
+
+void MappedFileReader::close() {
+    if (m_pMappedData) {
+        m_file.unmap(m_pMappedData);
+        m_pMappedData = nullptr;
+    }
+    m_file.close();
+    m_size = 0;
+    m_pos = 0;
+    m_uncheckedSize = 0;
+    m_prefetchStart = 0;
+    m_prefetchEnd = 0;
+    m_block.clear();
+    m_block.shrink_to_fit();
+    m_blockStart = 0;
+    m_blockLength = 0;
+}
+
+void MappedFileReader::adviseAccessPattern(AudioSource::AccessPattern accessPattern) {
+    if (m_accessPattern == accessPattern) {
+        return;
+    }
+    m_accessPattern = accessPattern;
+    if (m_pMappedData && m_accessPattern == AudioSource::AccessPattern::Random) {
+        // The file might be kept open for a long time, see open()
+        unmap();
+    }
+    applyAccessPattern();
+}
+
+void MappedFileReader::applyAccessPattern() {
+    // Restart prefetching at the next read position
+    m_prefetchStart = 0;
+    m_prefetchEnd = 0;
+#if defined(Q_OS_UNIX)
+    if (m_pMappedData) {
+        int advice;
+        switch (m_accessPattern) {
+        case AudioSource::AccessPattern::Sequential:
+            advice = MADV_SEQUENTIAL;
+            break;
+        case AudioSource::AccessPattern::Random:
+            advice = MADV_RANDOM;
+            break;
+        default:
+            advice = MADV_NORMAL;
+        }
+        // The mapping starts at offset 0, i.e. on a page boundary
+        if (madvise(m_pMappedData, static_cast<size_t>(m_size), advice) != 0) {
+            kLogger.debug()
+                    << "madvise() failed:"
+                    << std::strerror(errno);
+        }
+    }
+#endif
+#if defined(POSIX_FADV_SEQUENTIAL)
+    const int fd = m_file.handle();
+    if (fd >= 0) {
+        int advice;
+        switch (m_accessPattern) {
+        case AudioSource::AccessPattern::Sequential:
+            advice = POSIX_FADV_SEQUENTIAL;
+            break;
+        case AudioSource::AccessPattern::Random:
+            advice = POSIX_FADV_RANDOM;
+            break;
+        default:
+            advice = POSIX_FADV_NORMAL;
+        }
+        // Returns the error number instead of setting errno
+        const int result = posix_fadvise(fd, 0, 0, advice);
+        if (result != 0) {
+            kLogger.debug()
+                    << "posix_fadvise() failed:"
+                    << std::strerror(result);
+        }
+    }
+#endif
+}
+
+void MappedFileReader::prefetch(qint64 pos, qint64 size) {
+    if (pos >= m_prefetchStart && pos + size <= m_prefetchEnd) {
+        return;
+    }
+    const qint64 end = std::min(m_size, pos + std::max(size, kPrefetchSize));
+    if (pos >= end) {
+        return;
+    }
+#if defined(Q_OS_UNIX)
+    if (m_pMappedData) {
+        // The advised range must start on a page boundary
+        const qint64 start = pos - (pos % pageSize());
+        madvise(m_pMappedData + start, static_cast<size_t>(end - start), MADV_WILLNEED);
+        m_prefetchStart = start;
+        m_prefetchEnd = end;
+        return;
+    }
+#endif
+#if defined(POSIX_FADV_WILLNEED)
+    const int fd = m_file.handle();
+    if (fd >= 0) {
+        // Starts reading the window asynchronously, i.e. only the
+        // first block is read synchronously by the caller
+        posix_fadvise(fd, pos, end - pos, POSIX_FADV_WILLNEED);
+        m_prefetchStart = pos;
+        m_prefetchEnd = end;
+    }
+#endif
+}
+
+void MappedFileReader::updateSize() {
+    const qint64 size = m_file.size();
+    if (size < m_size) {
+        kLogger.warning()
+                << "File has been truncated from"
+                << m_size
+                << "to"
+                << size
+                << "bytes:"
+                << m_file.fileName();
+        m_size = size;
+        m_pos = std::min(m_pos, m_size);
+    }
+}
+
+bool MappedFileReader::seek(qint64 pos) {
+    VERIFY_OR_DEBUG_ASSERT(isOpen()) {
+        return false;
+    }
+    if (pos < 0 || pos > m_size) {
+        return false;
+    }
+    m_pos = pos;
+    return true;
+}
+
+bool MappedFileReader::readBlock(qint64 pos) {
+    DEBUG_ASSERT(!m_pMappedData);
+    DEBUG_ASSERT(static_cast<qint64>(m_block.size()) == kBlockSize);
+    m_blockStart = pos;
+    m_blockLength = 0;
+    if (!m_file.seek(pos)) {
+        return false;
+    }
+    const qint64 length = m_file.read(m_block.data(), kBlockSize);
+    if (length < 0) {
+        kLogger.warning()
+                << "Failed to read from file"
+                << m_file.fileName()
+                << m_file.errorString();
+        return false;
+    }
+    m_blockLength = length;
+    if (length < std::min(kBlockSize, m_size - pos)) {
+        updateSize();
+    }
+    return true;
+}
+
+qint64 MappedFileReader::read(void* pData, qint64 maxSize) {
+    VERIFY_OR_DEBUG_ASSERT(isOpen()) {
+        return -1;
+    }
+    DEBUG_ASSERT(maxSize >= 0);
+    const qint64 readSize = std::min(maxSize, m_size - m_pos);
+    if (readSize <= 0) {
+        return 0;
+    }
+    if (m_accessPattern == AudioSource::AccessPattern::Random) {
+        prefetch(m_pos, readSize);
+    }
+    if (m_pMappedData) {
+        // Checking the size on every read would add a system call,
+        // which is amortized over kBlockSize bytes instead
+        m_uncheckedSize += readSize;
+        if (m_uncheckedSize > kBlockSize) {
+            m_uncheckedSize = 0;
+            if (m_file.size() < m_pos + readSize) {
+                // Accessing mapped pages beyond the end of a truncated
+                // file raises SIGBUS
+                kLogger.warning()
+                        << "Reading file in blocks, because it has been truncated:"
+                        << m_file.fileName();
+                unmap();
+            }
+        }
+    }
+    if (m_pMappedData) {
+        std::memcpy(pData, m_pMappedData + m_pos, static_cast<size_t>(readSize));
+        m_pos += readSize;
+        return readSize;
+    }
+    auto* pOutput = static_cast<char*>(pData);
+    qint64 totalSize = 0;
+    while (totalSize < readSize) {
+        if (m_pos < m_blockStart || m_pos >= m_blockStart + m_blockLength) {
+            if (readSize - totalSize >= kBlockSize) {
+                // Large reads bypass the block buffer
+                if (!m_file.seek(m_pos)) {
+                    break;
+                }
+                const qint64 length = m_file.read(pOutput + totalSize, readSize - totalSize);
+                if (length < readSize - totalSize) {
+                    updateSize();
+                }
+                if (length <= 0) {
+                    break;
+                }
+                totalSize += length;
+                m_pos += length;
+                continue;
+            }
+            if (!readBlock(m_pos) || m_blockLength == 0) {
+                break;
+            }
+        }
+        const qint64 offset = m_pos - m_blockStart;
+        const qint64 length = std::min(readSize - totalSize, m_blockLength - offset);
+        std::memcpy(pOutput + totalSize, m_block.data() + offset, static_cast<size_t>(length));
+        totalSize += length;
+        m_pos += length;
+    }
+    if (totalSize == 0) {
+        return -1;
+    }
+    return totalSize;
+}
+
+bool MappedFileReader::ungetByte(char byte) {
+    if (m_pos <= 0) {
+        return false;
+    }
+    char previousByte;
+    if (m_pMappedData) {
+        previousByte = static_cast<char>(m_pMappedData[m_pos - 1]);
+    } else if (m_pos - 1 >= m_blockStart && m_pos - 1 < m_blockStart + m_blockLength) {
+        previousByte = m_block[m_pos - 1 - m_blockStart];
+    } else {
+        // Not buffered, e.g. after a large read
+        if (!m_file.seek(m_pos - 1) || !m_file.getChar(&previousByte)) {
+            return false;
+        }
+    }
+    if (previousByte != byte) {
+        return false;
+    }
+    --m_pos;
+    return true;
+}
+
+} // namespace mixxx
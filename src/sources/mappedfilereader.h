@@ -0,0 +1,109 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <vector>
+
+#include "sources/audiosource.h"
+
+namespace mixxx {
+
+/// Provides the input of decoders that read the file through callbacks,
+/// i.e. SoundSourceFLAC, SoundSourceWV, and SoundSourceSndFile.
+///
+/// Local files that are read sequentially, e.g. during analysis, are
+/// memory-mapped. Files on network shares, files that cannot be mapped,
+/// and files that are accessed randomly, e.g. by a deck that keeps them
+/// open for a long time, are read in large blocks, bypassing the small
+/// reads of Qt's buffered I/O layer that perform poorly on remote file
+/// systems. Reading mapped pages of a file that has been truncated in the
+/// meantime would crash, so the mapping is replaced by blocks as soon as
+/// the file shrinks. The file size is checked again after each kBlockSize
+/// bytes that have been read from the mapping and whenever a block read
+/// returns less data than expected.
+///
+/// The expected access pattern is passed on to the operating system:
+/// Sequential access enables aggressive read-ahead. Random access disables
+/// read-ahead and instead prefetches a window of kPrefetchSize bytes at
+/// each read position outside of the previous window.
+class MappedFileReader final {
+  public:
+    enum class Backend {
+        /// Mapped for local files that are not accessed randomly,
+        /// blocks otherwise
+        Auto,
+        Mapped,
+        Blocks,
+    };
+
+    /// The size of blocks that are read if the file is not mapped
+    static constexpr qint64 kBlockSize = 256 * 1024;
+    /// The size of the window that is prefetched for random access
+    static constexpr qint64 kPrefetchSize = 512 * 1024;
+
+    MappedFileReader();
+    ~MappedFileReader();
+
+    bool open(
+            const QString& fileName,
+            AudioSource::AccessPattern accessPattern,
+            Backend backend = Backend::Auto);
+    void close();
+
+    bool isOpen() const {
+        return m_file.isOpen();
+    }
+    bool isMapped() const {
+        return m_pMappedData != nullptr;
+    }
+    QString fileName() const {
+        return m_file.fileName();
+    }
+
+    /// Might be invoked at any time while the file is open.
+    void adviseAccessPattern(AudioSource::AccessPattern accessPattern);
+
+    qint64 size() const {
+        return m_size;
+    }
+    qint64 pos() const {
+        return m_pos;
+    }
+    bool atEnd() const {
+        return m_pos >= m_size;
+    }
+    bool seek(qint64 pos);
+
+    /// Returns the number of bytes that have been read, 0 at the end
+    /// of the file, or -1 on errors.
+    qint64 read(void* pData, qint64 maxSize);
+
+    /// Steps back by one byte if it matches the given value, i.e.
+    /// only bytes that have just been read can be pushed back.
+    bool ungetByte(char byte);
+
+  private:
+    void unmap();
+    void applyAccessPattern();
+    void prefetch(qint64 pos, qint64 size);
+    bool readBlock(qint64 pos);
+    void updateSize();
+
+    QFile m_file;
+    qint64 m_size;
+    qint64 m_pos;
+    AudioSource::AccessPattern m_accessPattern;
+
+    uchar* m_pMappedData;
+    /// The number of bytes that have been read from the mapping
+    /// since the file size has been checked
+    qint64 m_uncheckedSize;
+    qint64 m_prefetchStart;
+    qint64 m_prefetchEnd;
+
+    std::vector<char> m_block;
+    qint64 m_blockStart;
+    qint64 m_blockLength;
+};
+
+} // namespace mixxx
@@ -0,0 +1,309 @@
+#include "sources/mp3seektablecache.h"
+
+#ifdef _MSC_VER
+// See soundsourcemp3.h
+#define FPM_64BIT
+#endif
+#include <mad.h>
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFuture>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QSet>
+#include <QtConcurrentRun>
+#include <algorithm>
+
+#include "util/cachedirectory.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("Mp3SeekTableCache");
+
+// "MXST"
+constexpr quint32 kMagic = 0x4d585354;
+constexpr quint32 kVersion = 1;
+
+const QString kFileSuffix = QStringLiteral(".mp3seek");
+
+// The least recently used tables are removed at startup when exceeding
+// this size. A table of a 5 minute track takes about 2 KiB.
+constexpr qint64 kMaxCacheSize = 32 * 1024 * 1024;
+
+// Frame headers that are closer to the end of the file are copied and
+// padded with MAD_BUFFER_GUARD bytes for decoding. Must be greater than
+// the maximum size of an MP3 frame.
+constexpr quint64 kTailSize = 2048;
+
+QMutex s_mutex;
+QString s_dirPath;
+// The cache keys of the tables that have already been validated
+QSet<QString> s_validatedKeys;
+
+QString filePathForKey(const QString& dirPath, const QString& cacheKey) {
+    return QDir(dirPath).filePath(cacheKey + kFileSuffix);
+}
+
+} // anonymous namespace
+
+// static
+void Mp3SeekTableCache::setDirectory(const QString& dirPath) {
+    {
+        QMutexLocker locked(&s_mutex);
+        s_dirPath = dirPath;
+    }
+    if (dirPath.isEmpty()) {
+        return;
+    }
+    // Nobody waits for the result
+    const QFuture<int> future = QtConcurrent::run([dirPath] {
+        return pruneCacheDirectory(dirPath, QChar('*') + kFileSuffix, kMaxCacheSize);
+    });
+    Q_UNUSED(future);
+}
+
+// static
+QString Mp3SeekTableCache::directory() {
+    QMutexLocker locked(&s_mutex);
+    return s_dirPath;
+}
+
+// static
+std::optional<Mp3SeekTable> Mp3SeekTableCache::load(const FileIdentity& identity) {
+    const QString dirPath = directory();
+    if (dirPath.isEmpty() || !identity.isValid()) {
+        return std::nullopt;
+    }
+    QFile file(filePathForKey(dirPath, identity.cacheKey()));
+    if (!file.open(QIODevice::ReadOnly)) {
+        // Not cached yet
+        return std::nullopt;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+    quint32 magic;
+    quint32 version;
+    in >> magic >> version;
+    if (in.status() != QDataStream::Ok || magic != kMagic || version != kVersion) {
+        kLogger.info() << "Ignoring seek table with unsupported format" << file.fileName();
+        return std::nullopt;
+    }
+    FileIdentity cachedIdentity;
+    quint32 channelCount;
+    quint32 sampleRate;
+    quint32 bitrate;
+    qint64 frameCount;
+    QByteArray compressedSeekFrames;
+    in >> cachedIdentity;
+    in >> channelCount >> sampleRate >> bitrate >> frameCount >> compressedSeekFrames;
+    if (in.status() != QDataStream::Ok) {
+        kLogger.warning() << "Failed to read seek table" << file.fileName();
+        return std::nullopt;
+    }
+    if (cachedIdentity != identity) {
+        // The file has been modified, the table is replaced when storing
+        // the table of the modified file
+        return std::nullopt;
+    }
+
+    Mp3SeekTable seekTable;
+    seekTable.channelCount = audio::ChannelCount(channelCount);
+    seekTable.sampleRate = audio::SampleRate(sampleRate);
+    seekTable.bitrate = audio::Bitrate(bitrate);
+    seekTable.frameCount = static_cast<SINT>(frameCount);
+    if (!seekTable.channelCount.isValid() || !seekTable.sampleRate.isValid() ||
+            seekTable.frameCount <= 0) {
+        kLogger.warning() << "Invalid seek table" << file.fileName();
+        return std::nullopt;
+    }
+
+    // The seek frames are delta encoded
+    const QByteArray seekFrameData = qUncompress(compressedSeekFrames);
+    QDataStream seekFrameStream(seekFrameData);
+    seekFrameStream.setVersion(QDataStream::Qt_5_0);
+    quint32 seekFrameCount;
+    seekFrameStream >> seekFrameCount;
+    if (seekFrameStream.status() != QDataStream::Ok || seekFrameCount == 0) {
+        kLogger.warning() << "Invalid seek table" << file.fileName();
+        return std::nullopt;
+    }
+    seekTable.seekFrames.reserve(seekFrameCount);
+    Mp3SeekTable::SeekFrame seekFrame{0, 0};
+    for (quint32 i = 0; i < seekFrameCount; ++i) {
+        quint32 frameIndexDelta;
+        quint64 byteOffsetDelta;
+        seekFrameStream >> frameIndexDelta >> byteOffsetDelta;
+        seekFrame.frameIndex += frameIndexDelta;
+        seekFrame.byteOffset += byteOffsetDelta;
+        // Only the first seek frame may have no distance to its predecessor
+        if (seekFrameStream.status() != QDataStream::Ok ||
+                (i > 0 && (frameIndexDelta == 0 || byteOffsetDelta == 0)) ||
+                seekFrame.frameIndex >= seekTable.frameCount ||
+                seekFrame.byteOffset >= identity.fileSize()) {
+            kLogger.warning() << "Invalid seek table" << file.fileName();
+            return std::nullopt;
+        }
+        seekTable.seekFrames.push_back(seekFrame);
+    }
+    if (seekTable.seekFrames.front().frameIndex != 0) {
+        kLogger.warning() << "Invalid seek table" << file.fileName();
+        return std::nullopt;
+    }
+    touchCacheFile(file.fileName());
+    return seekTable;
+}
+
+// static
+bool Mp3SeekTableCache::store(
+        const FileIdentity& identity,
+        const Mp3SeekTable& seekTable) {
+    const QString dirPath = directory();
+    if (dirPath.isEmpty() || !identity.isValid() || seekTable.seekFrames.empty()) {
+        return false;
+    }
+    if (!QDir().mkpath(dirPath)) {
+        kLogger.warning() << "Failed to create directory" << dirPath;
+        return false;
+    }
+
+    QByteArray seekFrameData;
+    {
+        QDataStream seekFrameStream(&seekFrameData, QIODevice::WriteOnly);
+        seekFrameStream.setVersion(QDataStream::Qt_5_0);
+        seekFrameStream << static_cast<quint32>(seekTable.seekFrames.size());
+        Mp3SeekTable::SeekFrame prevSeekFrame{0, 0};
+        for (const auto& seekFrame : seekTable.seekFrames) {
+            DEBUG_ASSERT(seekFrame.frameIndex >= prevSeekFrame.frameIndex);
+            DEBUG_ASSERT(seekFrame.byteOffset >= prevSeekFrame.byteOffset);
+            seekFrameStream
+                    << static_cast<quint32>(seekFrame.frameIndex - prevSeekFrame.frameIndex)
+                    << static_cast<quint64>(seekFrame.byteOffset - prevSeekFrame.byteOffset);
+            prevSeekFrame = seekFrame;
+        }
+    }
+
+    // QSaveFile replaces the file atomically, so concurrent readers
+    // never see a partially written table
+    QSaveFile file(filePathForKey(dirPath, identity.cacheKey()));
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning() << "Failed to write seek table" << file.fileName();
+        return false;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << kMagic << kVersion;
+    out << identity;
+    out << static_cast<quint32>(seekTable.channelCount)
+        << static_cast<quint32>(seekTable.sampleRate)
+        << static_cast<quint32>(seekTable.bitrate)
+        << static_cast<qint64>(seekTable.frameCount)
+        << qCompress(seekFrameData);
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        kLogger.warning() << "Failed to write seek table" << file.fileName();
+        return false;
+    }
+    // A table that has just been scanned does not need to be validated
+    QMutexLocker locked(&s_mutex);
+    s_validatedKeys.insert(identity.cacheKey());
+    return true;
+}
+
+// static
+void Mp3SeekTableCache::remove(const FileIdentity& identity) {
+    const QString dirPath = directory();
+    if (dirPath.isEmpty() || !identity.isValid()) {
+        return;
+    }
+    QFile::remove(filePathForKey(dirPath, identity.cacheKey()));
+}
+
+// static
+void Mp3SeekTableCache::validateInBackground(
+        const QString& filePath,
+        const FileIdentity& identity,
+        Mp3SeekTable seekTable) {
+    {
+        QMutexLocker locked(&s_mutex);
+        if (s_validatedKeys.contains(identity.cacheKey())) {
+            return;
+        }
+        s_validatedKeys.insert(identity.cacheKey());
+    }
+    // Nobody waits for the result
+    const QFuture<bool> future = QtConcurrent::run(
+            [filePath, identity, seekTable = std::move(seekTable)] {
+                return validate(filePath, identity, seekTable);
+            });
+    Q_UNUSED(future);
+}
+
+// static
+bool Mp3SeekTableCache::validate(
+        const QString& filePath,
+        const FileIdentity& identity,
+        const Mp3SeekTable& seekTable) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        // The file might have been moved, this does not
+        // invalidate the table
+        return true;
+    }
+    const quint64 fileSize = file.size();
+    unsigned char* pFileData = file.map(0, fileSize);
+    if (!pFileData) {
+        return true;
+    }
+    bool valid = FileIdentity::fromFileData(
+                         pFileData, fileSize, QFileInfo(file).lastModified()) == identity;
+
+    mad_stream madStream;
+    mad_header madHeader;
+    mad_stream_init(&madStream);
+    mad_stream_options(&madStream, MAD_OPTION_IGNORECRC);
+    mad_header_init(&madHeader);
+    std::vector<unsigned char> tailBuffer(kTailSize + MAD_BUFFER_GUARD);
+    for (std::size_t i = 0; valid && i < seekTable.seekFrames.size(); ++i) {
+        const auto& seekFrame = seekTable.seekFrames[i];
+        const SINT expectedFrameLength = (i + 1 < seekTable.seekFrames.size()
+                                                         ? seekTable.seekFrames[i + 1].frameIndex
+                                                         : seekTable.frameCount) -
+                seekFrame.frameIndex;
+        const unsigned char* pFrameData = pFileData + seekFrame.byteOffset;
+        quint64 frameDataSize = fileSize - seekFrame.byteOffset;
+        if (frameDataSize < kTailSize) {
+            // MAD requires some 0 bytes after the last frame
+            std::fill(std::copy(pFrameData, pFrameData + frameDataSize, tailBuffer.begin()),
+                    tailBuffer.end(),
+                    0);
+            pFrameData = tailBuffer.data();
+            frameDataSize += MAD_BUFFER_GUARD;
+        }
+        mad_stream_buffer(&madStream, pFrameData, frameDataSize);
+        if (mad_header_decode(&madHeader, &madStream) != 0) {
+            valid = false;
+            break;
+        }
+        const long madFrameLength = mad_timer_count(
+                madHeader.duration, static_cast<mad_units>(madHeader.samplerate));
+        valid = madFrameLength == expectedFrameLength;
+    }
+    mad_header_finish(&madHeader);
+    mad_stream_finish(&madStream);
+    file.unmap(pFileData);
+
+    if (!valid) {
+        kLogger.info() << "Removing outdated seek table of" << filePath;
+        remove(identity);
+    }
+    return valid;
+}
+
+} // namespace mixxx
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QString>
+#include <optional>
+#include <vector>
+
+#include "audio/types.h"
+#include "util/fileidentity.h"
+#include "util/types.h"
+
+namespace mixxx {
+
+/// The result of scanning all MP3 frame headers of a file when opening it.
+struct Mp3SeekTable {
+    struct SeekFrame {
+        SINT frameIndex;
+        quint64 byteOffset;
+    };
+    /// Ordered by frameIndex and byteOffset, starting at frame index 0.
+    /// The list is not terminated by an entry for the end of the stream.
+    std::vector<SeekFrame> seekFrames;
+    SINT frameCount = 0;
+    audio::ChannelCount channelCount;
+    audio::SampleRate sampleRate;
+    audio::Bitrate bitrate;
+};
+
+/// Persists the seek tables of MP3 files in a directory with one compact,
+/// compressed binary file per table, so SoundSourceMp3 does not need to scan
+/// all frame headers each time the same file is opened by a deck, the
+/// analyzer, or the preview deck.
+///
+/// A table that is loaded from the cache is validated against the file once
+/// per session on a background thread and removed if it turns out to be
+/// outdated.
+///
+/// All functions are thread-safe.
+class Mp3SeekTableCache final {
+  public:
+    /// Called from the main thread at startup. An empty path disables the
+    /// cache, which is the default.
+    static void setDirectory(const QString& dirPath);
+    static QString directory();
+    static bool isEnabled() {
+        return !directory().isEmpty();
+    }
+
+    static std::optional<Mp3SeekTable> load(const FileIdentity& identity);
+    static bool store(const FileIdentity& identity, const Mp3SeekTable& seekTable);
+    static void remove(const FileIdentity& identity);
+
+    /// Checks on a background thread that the frame headers of the file match
+    /// the seek table. Tables that have already been validated during this
+    /// session are skipped.
+    static void validateInBackground(
+            const QString& filePath,
+            const FileIdentity& identity,
+            Mp3SeekTable seekTable);
+
+    /// Performs the validation on the calling thread and removes the cache
+    /// entry if the table is invalid.
+    static bool validate(
+            const QString& filePath,
+            const FileIdentity& identity,
+            const Mp3SeekTable& seekTable);
+};
+
+} // namespace mixxx
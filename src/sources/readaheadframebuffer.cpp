@@ -43,7 +43,8 @@ ReadAheadFrameBuffer::ReadAheadFrameBuffer(
                           ? m_signalInfo.frames2samples(
                                     validateCapacity(initialCapacity))
                           : kEmptyCapacity),
-          m_readIndex(kUnknownFrameIndex) {
+          m_readIndex(kUnknownFrameIndex),
+          m_copiedSampleCount(0) {
 }
 
 void ReadAheadFrameBuffer::adjustCapacityBeforeBuffering(
@@ -185,6 +186,7 @@ ReadableSampleFrames ReadAheadFrameBuffer::fillBuffer(
             writableSamples.data(),
             inputBuffer.readableData(),
             copySampleCount);
+    m_copiedSampleCount += copySampleCount;
     pInputSamples += copySampleCount;
     inputRange.shrinkFront(inputRange.length());
     DEBUG_ASSERT(inputRange.empty());
@@ -253,6 +255,7 @@ WritableSampleFrames ReadAheadFrameBuffer::drainBuffer(
                 pOutputSamples,
                 consumableSamples.data(),
                 consumableSamples.length());
+        m_copiedSampleCount += consumableSamples.length();
         pOutputSamples += consumableSamples.length();
     }
     outputRange.shrinkFront(consumableRange->length());
@@ -456,6 +459,7 @@ WritableSampleFrames ReadAheadFrameBuffer::consumeAndFillBuffer(
                         pOutputSampleData,
                         pInputSampleData,
                         copySampleCount);
+                m_copiedSampleCount += copySampleCount;
                 pOutputSampleData += copySampleCount;
             }
             pInputSampleData += copySampleCount;
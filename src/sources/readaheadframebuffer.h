@@ -86,6 +86,13 @@ class ReadAheadFrameBuffer final {
     void reset(
             FrameIndex currentIndex = kUnknownFrameIndex);
 
+    /// The total number of samples that have been copied into the
+    /// internal buffer or from the input or internal buffer into an
+    /// output buffer. Only used for instrumentation.
+    quint64 copiedSampleCount() const {
+        return m_copiedSampleCount;
+    }
+
     /// Try to reposition the buffer to a new read position
     /// within the buffered range, keeping all remaining data
     /// ahead of the read position.
@@ -172,6 +179,7 @@ class ReadAheadFrameBuffer final {
     audio::SignalInfo m_signalInfo;
     ReadAheadSampleBuffer m_sampleBuffer;
     FrameIndex m_readIndex;
+    quint64 m_copiedSampleCount;
 };
 
 } // namespace mixxx
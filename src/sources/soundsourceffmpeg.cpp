@@ -476,7 +476,8 @@ SoundSourceFFmpeg::SoundSourceFFmpeg(const QUrl& url)
           m_pavPacket(av_packet_alloc()),
           m_pavDecodedFrame(nullptr),
           m_pavResampledFrame(nullptr),
-          m_seekPrerollFrameCount(0) {
+          m_seekPrerollFrameCount(0),
+          m_seekIndexFollowsReadPosition(false) {
     DEBUG_ASSERT(m_pavPacket);
 #if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100) // FFmpeg 5.1
     av_channel_layout_default(&m_avStreamChannelLayout, 0);
@@ -726,9 +727,103 @@ SoundSource::OpenResult SoundSourceFFmpeg::tryOpen(
     kLogger.debug() << "Frame buffer capacity:" << m_frameBuffer.capacity();
 #endif
 
+    initSeekIndex();
+
     return OpenResult::Succeeded;
 }
 
+void SoundSourceFFmpeg::initSeekIndex() {
+    const auto streamInfo = FFmpegSeekIndex::StreamInfo{
+            m_pavStream->index,
+            static_cast<int>(m_pavStream->codecpar->codec_id),
+            m_pavStream->time_base.num,
+            m_pavStream->time_base.den,
+            m_pavStream->codecpar->sample_rate};
+    m_seekIndex = FFmpegSeekIndex(streamInfo);
+    m_seekIndexCacheKey.clear();
+    // Recording starts with the first packet of the stream
+    m_seekIndexFollowsReadPosition = true;
+    if (!FFmpegSeekIndexCache::isEnabled()) {
+        return;
+    }
+    m_seekIndexCacheKey = FFmpegSeekIndexCache::cacheKeyForFile(getLocalFileName());
+    auto cachedSeekIndex = FFmpegSeekIndexCache::load(m_seekIndexCacheKey, streamInfo);
+    if (!cachedSeekIndex) {
+        return;
+    }
+    m_seekIndex = std::move(*cachedSeekIndex);
+    DEBUG_ASSERT(m_seekIndex.isComplete());
+    // Demuxers with a generic index look up the byte offset of the
+    // seek position in the stream's index. Populating it with all
+    // packets allows them to seek exactly to each packet. Other
+    // demuxers maintain their own index and only profit from seeking
+    // to the exact time stamp of a packet.
+    if (m_pavInputFormatContext->iformat->flags & AVFMT_GENERIC_INDEX) {
+        for (const auto& entry : m_seekIndex.entries()) {
+            av_add_index_entry(m_pavStream,
+                    entry.pos,
+                    entry.pts,
+                    entry.size,
+                    /*distance*/ 0,
+                    AVINDEX_KEYFRAME);
+        }
+    }
+#if VERBOSE_DEBUG_LOG
+    kLogger.debug()
+            << "Loaded seek index with"
+            << m_seekIndex.entries().size()
+            << "packets";
+#endif
+}
+
+void SoundSourceFFmpeg::updateSeekIndex(
+        const AVPacket& avPacket,
+        SINT packetFrameIndex) {
+    if (m_seekIndex.isComplete()) {
+        return;
+    }
+    if (!avPacket.data) {
+        // End of stream
+        if (m_seekIndexFollowsReadPosition && !m_seekIndex.isEmpty()) {
+            completeSeekIndex();
+        }
+        return;
+    }
+    if (avPacket.pts == AV_NOPTS_VALUE || avPacket.pos < 0) {
+        // Not every packet is a seek target, e.g. only the first packet
+        // of an Ogg page has a position
+        return;
+    }
+    if (!m_seekIndexFollowsReadPosition) {
+        // Continue recording after reading the last packet again
+        m_seekIndexFollowsReadPosition = !m_seekIndex.isEmpty() &&
+                m_seekIndex.entries().back().pts == avPacket.pts;
+        return;
+    }
+    if (!m_seekIndex.append(FFmpegSeekIndex::Entry{
+                avPacket.pts,
+                avPacket.pos,
+                avPacket.size,
+                packetFrameIndex})) {
+        m_seekIndexFollowsReadPosition = false;
+        return;
+    }
+    if (avPacket.duration > 0 &&
+            convertStreamTimeToFrameIndex(*m_pavStream, avPacket.pts + avPacket.duration) >=
+                    frameIndexRange().end()) {
+        // The last packet has been recorded before reaching the end
+        // of the stream
+        completeSeekIndex();
+    }
+}
+
+void SoundSourceFFmpeg::completeSeekIndex() {
+    m_seekIndex.setComplete();
+    if (!m_seekIndexCacheKey.isEmpty()) {
+        FFmpegSeekIndexCache::storeInBackground(m_seekIndexCacheKey, m_seekIndex);
+    }
+}
+
 bool SoundSourceFFmpeg::initResampling(
         audio::ChannelCount* pResampledChannelCount,
         audio::SampleRate* pResampledSampleRate) {
@@ -869,6 +964,9 @@ void SoundSourceFFmpeg::close() {
     m_pavCodecContext.close();
     m_pavInputFormatContext.close();
     m_pavStream = nullptr;
+    m_seekIndex = FFmpegSeekIndex();
+    m_seekIndexCacheKey.clear();
+    m_seekIndexFollowsReadPosition = false;
 }
 
 namespace {
@@ -949,12 +1047,21 @@ bool SoundSourceFFmpeg::adjustCurrentPosition(SINT startIndex) {
         return true;
     }
 
+    // Seek exactly to the start of the packet that contains the seek
+    // position if it is known from the seek index. Otherwise the actual
+    // position depends on the accuracy of the demuxer.
+    int64_t seekTimestamp;
+    const auto* pSeekIndexEntry = m_seekIndex.findEntry(seekIndex);
+    if (pSeekIndexEntry) {
+        seekTimestamp = pSeekIndexEntry->pts;
+    } else {
+        seekTimestamp = convertFrameIndexToStreamTime(*m_pavStream, seekIndex);
+    }
+
     // Flush internal decoder state before seeking
     avcodec_flush_buffers(m_pavCodecContext);
 
     // Seek to new position
-    const int64_t seekTimestamp =
-            convertFrameIndexToStreamTime(*m_pavStream, seekIndex);
     int av_seek_frame_result = av_seek_frame(
             m_pavInputFormatContext,
             m_pavStream->index,
@@ -971,6 +1078,8 @@ bool SoundSourceFFmpeg::adjustCurrentPosition(SINT startIndex) {
     // The current position remains unknown until actually reading data
     // from the stream
     m_frameBuffer.reset();
+    // Recording of the seek index continues when reaching its end
+    m_seekIndexFollowsReadPosition = m_seekIndex.isEmpty() && seekIndex <= kMinFrameIndex;
 
     return true;
 }
@@ -991,6 +1100,7 @@ bool SoundSourceFFmpeg::consumeNextAVPacket(
             m_frameBuffer.invalidate();
             return false;
         }
+        updateSeekIndex(*m_pavPacket, packetFrameIndex);
         *ppavNextPacket = m_pavPacket;
     }
     auto* pavNextPacket = *ppavNextPacket;
@@ -1076,6 +1186,37 @@ const CSAMPLE* SoundSourceFFmpeg::resampleDecodedAVFrame() {
     }
 }
 
+bool SoundSourceFFmpeg::resampleDecodedAVFrameInto(CSAMPLE* pSampleData) {
+    DEBUG_ASSERT(m_pSwrContext);
+    DEBUG_ASSERT(pSampleData);
+    // The sample rate is never changed while resampling, i.e. the
+    // number of frames is preserved and no samples are delayed.
+    const int frameCount = m_pavDecodedFrame->nb_samples;
+    uint8_t* const outputData[] = {reinterpret_cast<uint8_t*>(pSampleData)};
+    const auto swr_convert_result = swr_convert(
+            m_pSwrContext,
+            outputData,
+            frameCount,
+            const_cast<const uint8_t**>(m_pavDecodedFrame->extended_data),
+            frameCount);
+    if (swr_convert_result != frameCount) {
+        if (swr_convert_result < 0) {
+            kLogger.warning().noquote()
+                    << "swr_convert() failed:"
+                    << formatErrorString(swr_convert_result);
+        } else {
+            kLogger.warning()
+                    << "swr_convert() returned"
+                    << swr_convert_result
+                    << "instead of"
+                    << frameCount
+                    << "sample frames";
+        }
+        return false;
+    }
+    return true;
+}
+
 ReadableSampleFrames SoundSourceFFmpeg::readSampleFramesClamped(
         const WritableSampleFrames& originalWritableSampleFrames) {
     DEBUG_ASSERT(m_frameBuffer.signalInfo() == getSignalInfo());
@@ -1092,7 +1233,10 @@ ReadableSampleFrames SoundSourceFFmpeg::readSampleFramesClamped(
 
     // Consume all buffered sample data before decoding any new data
     if (m_frameBuffer.isReady()) {
+        const auto copiedSampleCount = m_frameBuffer.copiedSampleCount();
         writableSampleFrames = m_frameBuffer.drainBuffer(writableSampleFrames);
+        countCopiedSamples(static_cast<SINT>(
+                m_frameBuffer.copiedSampleCount() - copiedSampleCount));
 #if VERBOSE_DEBUG_LOG
         kLogger.debug() << "After consuming buffered sample data:"
                         << "writableSampleFrames.frameIndexRange()"
@@ -1240,18 +1384,10 @@ ReadableSampleFrames SoundSourceFFmpeg::readSampleFramesClamped(
                     << "decodedFrameRange" << decodedFrameRange;
 #endif
 
-            const CSAMPLE* pDecodedSampleData = resampleDecodedAVFrame();
-            if (!pDecodedSampleData) {
-                // Invalidate current position and abort reading after unrecoverable error
-                m_frameBuffer.invalidate();
-                // Housekeeping before aborting to avoid memory leaks
-                av_frame_unref(m_pavDecodedFrame);
-                break;
-            }
-
             // The decoder may provide some lead-in and lead-out frames
             // before the start position and after the end of the stream.
             // Those frames need to be cut-off before consumption.
+            SINT leadinFrameCount = 0;
             if (decodedFrameRange.start() < frameIndexRange().start()) {
                 const auto leadinRange = IndexRange::between(
                         decodedFrameRange.start(),
@@ -1265,8 +1401,8 @@ ReadableSampleFrames SoundSourceFFmpeg::readSampleFramesClamped(
                             << "before"
                             << frameIndexRange();
 #endif
-                    pDecodedSampleData += getSignalInfo().frames2samples(leadinRange.length());
-                    decodedFrameRange.shrinkFront(leadinRange.length());
+                    leadinFrameCount = leadinRange.length();
+                    decodedFrameRange.shrinkFront(leadinFrameCount);
                 }
             }
             if (decodedFrameRange.end() > frameIndexRange().end()) {
@@ -1294,22 +1430,58 @@ ReadableSampleFrames SoundSourceFFmpeg::readSampleFramesClamped(
                     << "decodedFrameRange" << decodedFrameRange;
 #endif
 
-            const auto decodedSampleFrames = ReadableSampleFrames(
-                    decodedFrameRange,
-                    SampleBuffer::ReadableSlice(
-                            pDecodedSampleData,
-                            getSignalInfo().frames2samples(decodedFrameRange.length())));
-            auto outputSampleFrames = WritableSampleFrames(
-                    writableFrameRange,
-                    SampleBuffer::WritableSlice(
-                            pOutputSampleBuffer,
-                            getSignalInfo().frames2samples(writableFrameRange.length())));
-            outputSampleFrames = m_frameBuffer.consumeAndFillBuffer(
-                    decodedSampleFrames,
-                    outputSampleFrames,
-                    writableSampleFrames.frameIndexRange().start());
-            pOutputSampleBuffer = outputSampleFrames.writableData();
-            writableFrameRange = outputSampleFrames.frameIndexRange();
+            if (m_pSwrContext &&
+                    pOutputSampleBuffer &&
+                    m_frameBuffer.isEmpty() &&
+                    decodedFrameRange.length() == m_pavDecodedFrame->nb_samples &&
+                    decodedFrameRange.start() == writableFrameRange.start() &&
+                    decodedFrameRange.end() <= writableFrameRange.end()) {
+                // Zero-copy: The whole decoded frame is needed and fits
+                // into the output buffer at the current position
+                if (!resampleDecodedAVFrameInto(pOutputSampleBuffer)) {
+                    // Invalidate current position and abort reading after unrecoverable error
+                    m_frameBuffer.invalidate();
+                    // Housekeeping before aborting to avoid memory leaks
+                    av_frame_unref(m_pavDecodedFrame);
+                    break;
+                }
+                pOutputSampleBuffer +=
+                        getSignalInfo().frames2samples(decodedFrameRange.length());
+                writableFrameRange.shrinkFront(decodedFrameRange.length());
+                // Continue with the next decoded frame
+                m_frameBuffer.reset(decodedFrameRange.end());
+            } else {
+                // Fallback: Resample into an intermediate frame and copy
+                // the decoded samples into the output and read-ahead buffers
+                const CSAMPLE* pDecodedSampleData = resampleDecodedAVFrame();
+                if (!pDecodedSampleData) {
+                    // Invalidate current position and abort reading after unrecoverable error
+                    m_frameBuffer.invalidate();
+                    // Housekeeping before aborting to avoid memory leaks
+                    av_frame_unref(m_pavDecodedFrame);
+                    break;
+                }
+                pDecodedSampleData += getSignalInfo().frames2samples(leadinFrameCount);
+                const auto decodedSampleFrames = ReadableSampleFrames(
+                        decodedFrameRange,
+                        SampleBuffer::ReadableSlice(
+                                pDecodedSampleData,
+                                getSignalInfo().frames2samples(decodedFrameRange.length())));
+                auto outputSampleFrames = WritableSampleFrames(
+                        writableFrameRange,
+                        SampleBuffer::WritableSlice(
+                                pOutputSampleBuffer,
+                                getSignalInfo().frames2samples(writableFrameRange.length())));
+                const auto copiedSampleCount = m_frameBuffer.copiedSampleCount();
+                outputSampleFrames = m_frameBuffer.consumeAndFillBuffer(
+                        decodedSampleFrames,
+                        outputSampleFrames,
+                        writableSampleFrames.frameIndexRange().start());
+                countCopiedSamples(static_cast<SINT>(
+                        m_frameBuffer.copiedSampleCount() - copiedSampleCount));
+                pOutputSampleBuffer = outputSampleFrames.writableData();
+                writableFrameRange = outputSampleFrames.frameIndexRange();
+            }
 
 #if VERBOSE_DEBUG_LOG
             kLogger.debug()
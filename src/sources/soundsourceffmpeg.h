@@ -8,6 +8,7 @@ extern "C" {
 
 } // extern "C"
 
+#include "sources/ffmpegseekindex.h"
 #include "sources/readaheadframebuffer.h"
 #include "sources/soundsourceprovider.h"
 
@@ -33,6 +34,9 @@ class SoundSourceFFmpeg : public SoundSource {
             audio::ChannelCount* pResampledChannelCount,
             audio::SampleRate* pResampledSampleRate);
     const CSAMPLE* resampleDecodedAVFrame();
+    // Resamples the whole decoded frame directly into the given
+    // output buffer instead of an intermediate AVFrame.
+    bool resampleDecodedAVFrameInto(CSAMPLE* pSampleData);
 
     // Seek to the requested start index (if needed) or return false
     // upon seek errors.
@@ -42,6 +46,14 @@ class SoundSourceFFmpeg : public SoundSource {
     bool consumeNextAVPacket(
             AVPacket** ppavNextPacket);
 
+    // Loads the seek index from the cache or prepares recording it.
+    void initSeekIndex();
+    // Records the packet that has just been read from the stream.
+    void updateSeekIndex(
+            const AVPacket& avPacket,
+            SINT packetFrameIndex);
+    void completeSeekIndex();
+
     // Takes ownership of an input format context and ensures that
     // the corresponding AVFormatContext is closed, either explicitly
     // or implicitly by the destructor. The wrapper can only be
@@ -190,6 +202,12 @@ class SoundSourceFFmpeg : public SoundSource {
     FrameCount m_seekPrerollFrameCount;
 
     ReadAheadFrameBuffer m_frameBuffer;
+
+    FFmpegSeekIndex m_seekIndex;
+    QString m_seekIndexCacheKey;
+    // True while the packets are read in sequence after the
+    // last entry of the seek index
+    bool m_seekIndexFollowsReadPosition;
 };
 
 class SoundSourceProviderFFmpeg : public SoundSourceProvider {
@@ -89,10 +89,10 @@ SoundSourceProviderPriority SoundSourceProviderFLAC::getPriorityHint(
 
 SoundSourceFLAC::SoundSourceFLAC(const QUrl& url)
         : SoundSource(url),
-          m_file(getLocalFileName()),
           m_decoder(nullptr),
           m_maxBlocksize(0),
           m_bitsPerSample(kBitsPerSampleDefault),
+          m_directFrameCount(0),
           m_curFrameIndex(0) {
 }
 
@@ -102,12 +102,12 @@ SoundSourceFLAC::~SoundSourceFLAC() {
 
 SoundSource::OpenResult SoundSourceFLAC::tryOpen(
         OpenMode /*mode*/,
-        const OpenParams& /*config*/) {
+        const OpenParams& params) {
     DEBUG_ASSERT(!m_file.isOpen());
-    if (!m_file.open(QIODevice::ReadOnly)) {
+    if (!m_file.open(getLocalFileName(), params.getAccessPattern())) {
         kLogger.warning()
                 << "Failed to open FLAC file:"
-                << m_file.fileName();
+                << getLocalFileName();
         return OpenResult::Failed;
     }
 
@@ -158,6 +158,10 @@ void SoundSourceFLAC::close() {
     m_file.close();
 }
 
+void SoundSourceFLAC::adviseAccessPattern(AccessPattern accessPattern) {
+    m_file.adviseAccessPattern(accessPattern);
+}
+
 ReadableSampleFrames SoundSourceFLAC::readSampleFramesClamped(
         const WritableSampleFrames& writableSampleFrames) {
     const SINT firstFrameIndex = writableSampleFrames.frameIndexRange().start();
@@ -185,14 +189,14 @@ ReadableSampleFrames SoundSourceFLAC::readSampleFramesClamped(
                 // Failure
                 kLogger.warning()
                         << "Seek error at" << seekFrameIndex
-                        << "in file" << m_file.fileName();
+                        << "in file" << getLocalFileName();
                 if (FLAC__STREAM_DECODER_SEEK_ERROR == FLAC__stream_decoder_get_state(m_decoder)) {
                     // Flush the input stream of the decoder according to the
                     // documentation of FLAC__stream_decoder_seek_absolute()
                     if (!FLAC__stream_decoder_flush(m_decoder)) {
                         kLogger.warning()
                                 << "Failed to flush input buffer of the FLAC decoder after seek failure"
-                                << "in file" << m_file.fileName();
+                                << "in file" << getLocalFileName();
                         invalidateCurFrameIndex();
                         // ...and abort
                         return ReadableSampleFrames(
@@ -261,14 +265,24 @@ ReadableSampleFrames SoundSourceFLAC::readSampleFramesClamped(
         if (m_sampleBuffer.empty()) {
             // Save the current frame index
             const SINT curFrameIndexBeforeProcessing = m_curFrameIndex;
+            // Offer the remaining output buffer for decoding in-place
+            if (writableSampleFrames.writableData()) {
+                m_directWritableSlice = SampleBuffer::WritableSlice(
+                        writableSampleFrames.writableData(outputSampleOffset),
+                        numberOfSamplesRemaining);
+            }
+            DEBUG_ASSERT(m_directFrameCount == 0);
             // Documentation of FLAC__stream_decoder_process_single():
             // "Depending on what was decoded, the metadata or write callback
             // will be called with the decoded metadata block or audio frame."
             // See also: https://xiph.org/flac/api/group__flac__stream__decoder.html#ga9d6df4a39892c05955122cf7f987f856
-            if (!FLAC__stream_decoder_process_single(m_decoder)) {
+            const bool processed = FLAC__stream_decoder_process_single(m_decoder);
+            m_directWritableSlice = SampleBuffer::WritableSlice();
+            if (!processed) {
+                m_directFrameCount = 0;
                 kLogger.warning()
                         << "Failed to decode FLAC file"
-                        << m_file.fileName();
+                        << getLocalFileName();
                 break; // abort
             }
             // After decoding we might first need to skip some samples if the
@@ -280,7 +294,7 @@ ReadableSampleFrames SoundSourceFLAC::readSampleFramesClamped(
                             << "Trying to adjust frame index"
                             << m_curFrameIndex << "<" << curFrameIndexBeforeProcessing
                             << "while decoding FLAC file"
-                            << m_file.fileName();
+                            << getLocalFileName();
                     const auto skipFrames =
                             IndexRange::between(m_curFrameIndex, curFrameIndexBeforeProcessing);
                     if (skipFrames != readSampleFramesClamped(WritableSampleFrames(skipFrames)).frameIndexRange()) {
@@ -288,7 +302,7 @@ ReadableSampleFrames SoundSourceFLAC::readSampleFramesClamped(
                                 << "Failed to skip sample frames"
                                 << skipFrames
                                 << "while decoding FLAC file"
-                                << m_file.fileName();
+                                << getLocalFileName();
                         break; // abort
                     }
                 } else {
@@ -296,16 +310,29 @@ ReadableSampleFrames SoundSourceFLAC::readSampleFramesClamped(
                             << "Unexpected frame index"
                             << m_curFrameIndex << ">" << curFrameIndexBeforeProcessing
                             << "while decoding FLAC file"
-                            << m_file.fileName();
+                            << getLocalFileName();
                     break; // abort
                 }
             }
             DEBUG_ASSERT(curFrameIndexBeforeProcessing == m_curFrameIndex);
         }
+        if (m_directFrameCount > 0) {
+            // Decoded in-place
+            DEBUG_ASSERT(m_sampleBuffer.empty());
+            const SINT numberOfSamplesDecoded =
+                    getSignalInfo().frames2samples(m_directFrameCount);
+            DEBUG_ASSERT(numberOfSamplesDecoded <= numberOfSamplesRemaining);
+            m_directFrameCount = 0;
+            outputSampleOffset += numberOfSamplesDecoded;
+            m_curFrameIndex += getSignalInfo().samples2frames(numberOfSamplesDecoded);
+            numberOfSamplesRemaining -= numberOfSamplesDecoded;
+            continue;
+        }
         if (m_sampleBuffer.empty()) {
             break; // EOF
         }
 
+        // Decoded into temporary buffer
         const SINT numberOfSamplesRead =
                 std::min(m_sampleBuffer.readableLength(), numberOfSamplesRemaining);
         const SampleBuffer::ReadableSlice readableSlice(
@@ -316,6 +343,7 @@ ReadableSampleFrames SoundSourceFLAC::readSampleFramesClamped(
                     writableSampleFrames.writableData(outputSampleOffset),
                     readableSlice.data(),
                     readableSlice.length());
+            countCopiedSamples(readableSlice.length());
             outputSampleOffset += numberOfSamplesRead;
         }
         m_curFrameIndex += getSignalInfo().samples2frames(numberOfSamplesRead);
@@ -341,7 +369,7 @@ FLAC__StreamDecoderReadStatus SoundSourceFLAC::flacRead(FLAC__byte buffer[],
         return FLAC__STREAM_DECODER_READ_STATUS_CONTINUE;
     }
 
-    const qint64 readlen = m_file.read((char*)buffer, maxlen);
+    const qint64 readlen = m_file.read(buffer, maxlen);
 
     if (0 < readlen) {
         *bytes = readlen;
@@ -362,32 +390,23 @@ FLAC__StreamDecoderSeekStatus SoundSourceFLAC::flacSeek(FLAC__uint64 absolute_by
     } else {
         kLogger.warning()
                 << "SoundSourceFLAC: An unrecoverable error occurred ("
-                << m_file.fileName() << ")";
+                << getLocalFileName() << ")";
         return FLAC__STREAM_DECODER_SEEK_STATUS_ERROR;
     }
 }
 
 FLAC__StreamDecoderTellStatus SoundSourceFLAC::flacTell(FLAC__uint64* offset) {
-    if (m_file.isSequential()) {
-        return FLAC__STREAM_DECODER_TELL_STATUS_UNSUPPORTED;
-    }
     *offset = m_file.pos();
     return FLAC__STREAM_DECODER_TELL_STATUS_OK;
 }
 
 FLAC__StreamDecoderLengthStatus SoundSourceFLAC::flacLength(
         FLAC__uint64* length) {
-    if (m_file.isSequential()) {
-        return FLAC__STREAM_DECODER_LENGTH_STATUS_UNSUPPORTED;
-    }
     *length = m_file.size();
     return FLAC__STREAM_DECODER_LENGTH_STATUS_OK;
 }
 
 FLAC__bool SoundSourceFLAC::flacEOF() {
-    if (m_file.isSequential()) {
-        return false;
-    }
     return m_file.atEnd();
 }
 
@@ -460,13 +479,24 @@ FLAC__StreamDecoderWriteStatus SoundSourceFLAC::flacWrite(
     // According to the API docs the decoder will always report the current
     // position in "FLAC samples" (= "Mixxx frames") for convenience
     DEBUG_ASSERT(frame->header.number_type == FLAC__FRAME_NUMBER_TYPE_SAMPLE_NUMBER);
-    m_curFrameIndex = frame->header.number.sample_number;
+    const auto frameIndex = static_cast<SINT>(frame->header.number.sample_number);
 
     // Decode buffer should be empty before decoding the next frame
     DEBUG_ASSERT(m_sampleBuffer.empty());
-    const SampleBuffer::WritableSlice writableSlice(
-            m_sampleBuffer.growForWriting(
-                    getSignalInfo().frames2samples(numReadableFrames)));
+    const SINT numReadableSamples = getSignalInfo().frames2samples(numReadableFrames);
+    SampleBuffer::WritableSlice writableSlice;
+    if (frameIndex == m_curFrameIndex &&
+            m_directWritableSlice.length() >= numReadableSamples) {
+        // Decode in-place if the whole frame fits into the output buffer
+        // at the expected position
+        writableSlice = SampleBuffer::WritableSlice(
+                m_directWritableSlice.data(),
+                numReadableSamples);
+        m_directFrameCount = numReadableFrames;
+    } else {
+        writableSlice = m_sampleBuffer.growForWriting(numReadableSamples);
+    }
+    m_curFrameIndex = frameIndex;
 
     const SINT numWritableFrames =
             getSignalInfo().samples2frames(writableSlice.length());
@@ -589,7 +619,7 @@ void SoundSourceFLAC::flacError(FLAC__StreamDecoderErrorStatus status) {
     }
     kLogger.warning()
             << "FLAC decoding error" << error
-            << "in file" << m_file.fileName();
+            << "in file" << getLocalFileName();
     // not much else to do here... whatever function that initiated whatever
     // decoder method resulted in this error will return an error, and the caller
     // will bail. libFLAC docs say to not close the decoder here -- bkgood
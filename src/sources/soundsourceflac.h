@@ -2,8 +2,7 @@
 
 #include <FLAC/stream_decoder.h>
 
-#include <QFile>
-
+#include "sources/mappedfilereader.h"
 #include "sources/soundsourceprovider.h"
 #include "util/readaheadsamplebuffer.h"
 
@@ -16,6 +15,8 @@ class SoundSourceFLAC final : public SoundSource {
 
     void close() override;
 
+    void adviseAccessPattern(AccessPattern accessPattern) override;
+
     // Internal callbacks
     FLAC__StreamDecoderReadStatus flacRead(FLAC__byte buffer[], size_t* bytes);
     FLAC__StreamDecoderSeekStatus flacSeek(FLAC__uint64 offset);
@@ -36,7 +37,7 @@ class SoundSourceFLAC final : public SoundSource {
             OpenMode mode,
             const OpenParams& params) override;
 
-    QFile m_file;
+    MappedFileReader m_file;
 
     FLAC__StreamDecoder* m_decoder;
     // misc bits about the flac format:
@@ -49,6 +50,12 @@ class SoundSourceFLAC final : public SoundSource {
 
     ReadAheadSampleBuffer m_sampleBuffer;
 
+    // The remaining portion of the caller's output buffer while decoding
+    // the next FLAC frame. Frames that fit entirely are decoded in-place
+    // instead of into m_sampleBuffer, see flacWrite().
+    SampleBuffer::WritableSlice m_directWritableSlice;
+    SINT m_directFrameCount;
+
     void invalidateCurFrameIndex() {
         m_curFrameIndex = frameIndexMax();
     }
@@ -607,6 +607,7 @@ ReadableSampleFrames SoundSourceM4A::readSampleFramesClamped(
                                              outputSampleOffset),
                             readableSlice.data(),
                             readableSlice.length());
+                    countCopiedSamples(readableSlice.length());
                     outputSampleOffset += readableSlice.length();
                 }
                 m_curFrameIndex +=
@@ -808,6 +809,7 @@ ReadableSampleFrames SoundSourceM4A::readSampleFramesClamped(
                             writableSampleFrames.writableData(outputSampleOffset),
                             readableSlice.data(),
                             readableSlice.length());
+                    countCopiedSamples(readableSlice.length());
                     outputSampleOffset += numberOfSamplesRead;
                 }
             }
@@ -312,6 +312,7 @@ ReadableSampleFrames SoundSourceMediaFoundation::readSampleFramesClamped(
                         pSampleBuffer,
                         readableSlice.data(),
                         readableSlice.length());
+                countCopiedSamples(readableSlice.length());
                 pSampleBuffer += readableSlice.length();
             }
             m_currentFrameIndex += getSignalInfo().samples2frames(readableSlice.length());
@@ -478,6 +479,7 @@ ReadableSampleFrames SoundSourceMediaFoundation::readSampleFramesClamped(
                             pSampleBuffer,
                             pLockedSampleBuffer,
                             copySamplesCount);
+                    countCopiedSamples(copySamplesCount);
                     pSampleBuffer += copySamplesCount;
                 }
                 pLockedSampleBuffer += copySamplesCount;
@@ -494,6 +496,7 @@ ReadableSampleFrames SoundSourceMediaFoundation::readSampleFramesClamped(
                     writableSlice.data(),
                     pLockedSampleBuffer,
                     writableSlice.length());
+            countCopiedSamples(writableSlice.length());
             HRESULT hrUnlock = pMediaBuffer->Unlock();
             VERIFY_OR_DEBUG_ASSERT(SUCCEEDED(hrUnlock)) {
                 kLogger.warning()
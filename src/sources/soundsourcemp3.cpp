@@ -6,6 +6,8 @@
 
 #include <id3tag.h>
 
+#include <QFileInfo>
+
 namespace mixxx {
 
 namespace {
@@ -176,7 +178,8 @@ SoundSourceMp3::SoundSourceMp3(const QUrl& url)
           m_avgSeekFrameCount(0),
           m_curFrameIndex(0),
           m_madSynthCount(0),
-          m_leftoverBuffer(kMaxBytesPerMp3Frame + MAD_BUFFER_GUARD) {
+          m_leftoverBuffer(kMaxBytesPerMp3Frame + MAD_BUFFER_GUARD),
+          m_pLeftoverFileData(nullptr) {
     m_seekFrameList.reserve(kSeekFrameListCapacity);
     initDecoding();
 }
@@ -218,14 +221,53 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
     // described in the following bug report:
     // https://github.com/mixxxdj/mixxx/issues/8011
 
-    // Transfer it to the mad stream-buffer:
+    DEBUG_ASSERT(m_seekFrameList.empty());
+    m_avgSeekFrameCount = 0;
+    m_curFrameIndex = 0;
+
+    // Scanning all frame headers of long files takes a lot of time,
+    // so the results are cached
+    const auto fileIdentity = FileIdentity::fromFileData(
+            m_pFileData, m_fileSize, QFileInfo(m_file).lastModified());
+    if (auto cachedSeekTable = Mp3SeekTableCache::load(fileIdentity);
+            cachedSeekTable && initFromSeekTable(*cachedSeekTable)) {
+        Mp3SeekTableCache::validateInBackground(
+                m_file.fileName(), fileIdentity, std::move(*cachedSeekTable));
+    } else {
+        const auto scanResult = scanFrameHeaders();
+        if (scanResult != OpenResult::Succeeded) {
+            return scanResult;
+        }
+        if (Mp3SeekTableCache::isEnabled()) {
+            Mp3SeekTableCache::store(fileIdentity, seekTable());
+        }
+    }
+
+    DEBUG_ASSERT(m_seekFrameList.size() > 0); // see above
+    m_avgSeekFrameCount = frameLength() / static_cast<SINT>(m_seekFrameList.size());
+
+    // Terminate m_seekFrameList
+    addSeekFrame(m_curFrameIndex, nullptr);
+    DEBUG_ASSERT(m_seekFrameList.back().frameIndex == frameIndexMax());
+
+    // Restart decoding at the beginning of the audio stream
+    restartDecoding(m_seekFrameList.front());
+
+    if (m_curFrameIndex != frameIndexMin()) {
+        kLogger.warning() << "Failed to start decoding:" << m_file.fileName();
+        // Abort
+        return OpenResult::Failed;
+    }
+
+    return OpenResult::Succeeded;
+}
+
+SoundSource::OpenResult SoundSourceMp3::scanFrameHeaders() {
+    // Transfer the file to the mad stream-buffer:
     mad_stream_options(&m_madStream, MAD_OPTION_IGNORECRC);
     mad_stream_buffer(&m_madStream, m_pFileData, m_fileSize);
     DEBUG_ASSERT(m_pFileData == m_madStream.this_frame);
 
-    DEBUG_ASSERT(m_seekFrameList.empty());
-    m_avgSeekFrameCount = 0;
-    m_curFrameIndex = 0;
     int headerPerSampleRate[kSampleRateCount];
     for (int i = 0; i < kSampleRateCount; ++i) {
         headerPerSampleRate[i] = 0;
@@ -442,8 +484,6 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
     initFrameIndexRangeOnce(IndexRange::forward(0, m_curFrameIndex));
 
     // Calculate average bitrate values
-    DEBUG_ASSERT(m_seekFrameList.size() > 0); // see above
-    m_avgSeekFrameCount = frameLength() / static_cast<SINT>(m_seekFrameList.size());
     if (cntBitrateFrames > 0) {
         const unsigned long avgBitrate = sumBitrateFrames / cntBitrateFrames;
         initBitrateOnce(avgBitrate / 1000); // bps -> kbps
@@ -451,20 +491,52 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
         kLogger.warning() << "Bitrate cannot be calculated from headers";
     }
 
-    // Terminate m_seekFrameList
-    addSeekFrame(m_curFrameIndex, nullptr);
-    DEBUG_ASSERT(m_seekFrameList.back().frameIndex == frameIndexMax());
-
-    // Restart decoding at the beginning of the audio stream
-    restartDecoding(m_seekFrameList.front());
+    return OpenResult::Succeeded;
+}
 
-    if (m_curFrameIndex != frameIndexMin()) {
-        kLogger.warning() << "Failed to start decoding:" << m_file.fileName();
-        // Abort
-        return OpenResult::Failed;
+bool SoundSourceMp3::initFromSeekTable(const Mp3SeekTable& seekTable) {
+    DEBUG_ASSERT(m_seekFrameList.empty());
+    if (!seekTable.channelCount.isValid() ||
+            seekTable.channelCount > kChannelCountMax ||
+            getIndexBySampleRate(seekTable.sampleRate) >= kSampleRateCount ||
+            seekTable.seekFrames.empty()) {
+        kLogger.warning() << "Ignoring invalid cached seek table of" << m_file.fileName();
+        return false;
+    }
+    initChannelCountOnce(seekTable.channelCount);
+    initSampleRateOnce(seekTable.sampleRate);
+    initFrameIndexRangeOnce(IndexRange::forward(0, seekTable.frameCount));
+    if (seekTable.bitrate.isValid()) {
+        initBitrateOnce(seekTable.bitrate);
     }
+    for (const auto& seekFrame : seekTable.seekFrames) {
+        addSeekFrame(seekFrame.frameIndex, m_pFileData + seekFrame.byteOffset);
+    }
+    m_curFrameIndex = seekTable.frameCount;
+    return true;
+}
 
-    return OpenResult::Succeeded;
+Mp3SeekTable SoundSourceMp3::seekTable() const {
+    Mp3SeekTable seekTable;
+    seekTable.seekFrames.reserve(m_seekFrameList.size());
+    const unsigned char* pLeftoverBuffer = m_leftoverBuffer.data();
+    for (const auto& seekFrame : m_seekFrameList) {
+        const unsigned char* pInputData = seekFrame.pInputData;
+        if (pInputData >= pLeftoverBuffer &&
+                pInputData < pLeftoverBuffer + m_leftoverBuffer.size()) {
+            // The last frame is decoded from a copy
+            DEBUG_ASSERT(m_pLeftoverFileData);
+            pInputData = m_pLeftoverFileData + (pInputData - pLeftoverBuffer);
+        }
+        seekTable.seekFrames.push_back(Mp3SeekTable::SeekFrame{
+                seekFrame.frameIndex,
+                static_cast<quint64>(pInputData - m_pFileData)});
+    }
+    seekTable.frameCount = m_curFrameIndex;
+    seekTable.channelCount = getSignalInfo().getChannelCount();
+    seekTable.sampleRate = getSignalInfo().getSampleRate();
+    seekTable.bitrate = getBitrate();
+    return seekTable;
 }
 
 void SoundSourceMp3::close() {
@@ -832,6 +904,7 @@ bool SoundSourceMp3::copyLeftoverFrame() {
         DEBUG_ASSERT(remainingBytes <= kMaxBytesPerMp3Frame); // only last MP3 frame
         const SINT leftoverBytes = remainingBytes + MAD_BUFFER_GUARD;
         if ((remainingBytes > 0) && (leftoverBytes <= SINT(m_leftoverBuffer.size()))) {
+            m_pLeftoverFileData = m_madStream.next_frame;
             // Copy the data of the last MP3 frame into the leftover buffer...
             std::copy(m_madStream.next_frame,
                     m_madStream.next_frame + remainingBytes,
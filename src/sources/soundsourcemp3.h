@@ -1,5 +1,6 @@
 #pragma once
 
+#include "sources/mp3seektablecache.h"
 #include "sources/soundsourceprovider.h"
 
 #ifdef _MSC_VER
@@ -32,6 +33,13 @@ class SoundSourceMp3 final : public SoundSource {
             OpenMode mode,
             const OpenParams& params) override;
 
+    /// Decodes all frame headers to build the seek frame list
+    /// and to initialize the audio properties.
+    OpenResult scanFrameHeaders();
+    /// Restores the results of scanFrameHeaders() from the cache.
+    bool initFromSeekTable(const Mp3SeekTable& seekTable);
+    Mp3SeekTable seekTable() const;
+
     QFile m_file;
     quint64 m_fileSize;
     unsigned char* m_pFileData;
@@ -74,6 +82,8 @@ class SoundSourceMp3 final : public SoundSource {
     SINT m_madSynthCount; // left overs from the previous read
 
     std::vector<unsigned char> m_leftoverBuffer;
+    // The location of the data in m_leftoverBuffer in the file
+    const unsigned char* m_pLeftoverFileData;
 };
 
 class SoundSourceProviderMp3 : public SoundSourceProvider {
@@ -0,0 +1,230 @@
+#include "sources/soundsourcepool.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <algorithm>
+
+#include "util/cmdlineargs.h"
+#include "util/logger.h"
+#include "util/stat.h"
+#include "util/time.h"
+#include "util/timer.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("SoundSourcePool");
+
+QString entryKey(
+        const QString& localFileName,
+        const SoundSourceProviderPointer& pProvider,
+        const AudioSource::OpenParams& params) {
+    return localFileName +
+            QChar('|') +
+            pProvider->getDisplayName() +
+            QChar('|') +
+            QString::number(params.getSignalInfo().getChannelCount()) +
+            QChar('|') +
+            QString::number(params.getSignalInfo().getSampleRate());
+}
+
+} // anonymous namespace
+
+class SoundSourcePool::Entry {
+  public:
+    Entry(QString key,
+            SoundSourcePointer pSoundSource,
+            SoundSourceProviderPointer pProvider)
+            : m_key(std::move(key)),
+              m_pSoundSource(std::move(pSoundSource)),
+              m_pProvider(std::move(pProvider)),
+              m_localFileName(m_pSoundSource->getLocalFileName()),
+              m_fileInfo(m_localFileName),
+              m_fileSize(m_fileInfo.size()),
+              m_lastModified(m_fileInfo.lastModified()),
+              m_releasedAt(Time::elapsed()) {
+    }
+    ~Entry() {
+        if (m_pSoundSource) {
+            m_pSoundSource->close();
+        }
+    }
+
+    const QString& key() const {
+        return m_key;
+    }
+
+    const QString& localFileName() const {
+        return m_localFileName;
+    }
+
+    bool isIdle() const {
+        return Time::elapsed() - m_releasedAt > kMaxIdleDuration;
+    }
+
+    /// Checks if the file is still the one that has been opened.
+    bool isFileUnmodified() {
+        m_fileInfo.refresh();
+        return m_fileInfo.exists() &&
+                m_fileInfo.size() == m_fileSize &&
+                m_fileInfo.lastModified() == m_lastModified;
+    }
+
+    std::pair<SoundSourcePointer, SoundSourceProviderPointer> release() {
+        return std::make_pair(std::move(m_pSoundSource), std::move(m_pProvider));
+    }
+
+  private:
+    const QString m_key;
+    SoundSourcePointer m_pSoundSource;
+    SoundSourceProviderPointer m_pProvider;
+    const QString m_localFileName;
+    QFileInfo m_fileInfo;
+    const qint64 m_fileSize;
+    const QDateTime m_lastModified;
+    const Duration m_releasedAt;
+};
+
+SoundSourcePool::SoundSourcePool()
+        : m_capacity(0) {
+}
+
+SoundSourcePool::~SoundSourcePool() {
+    clear();
+}
+
+void SoundSourcePool::setCapacity(int capacity) {
+    VERIFY_OR_DEBUG_ASSERT(capacity >= 0) {
+        capacity = 0;
+    }
+    QMutexLocker locked(&m_mutex);
+    m_capacity = capacity;
+    // Shrinking closes the least recently released entries
+    evictLeastRecentlyReleasedEntries(m_capacity);
+}
+
+int SoundSourcePool::capacity() const {
+    QMutexLocker locked(&m_mutex);
+    return m_capacity;
+}
+
+std::pair<SoundSourcePointer, SoundSourceProviderPointer> SoundSourcePool::take(
+        const QString& localFileName,
+        const SoundSourceProviderPointer& pProvider,
+        const AudioSource::OpenParams& params) {
+    VERIFY_OR_DEBUG_ASSERT(pProvider) {
+        return {};
+    }
+    QMutexLocker locked(&m_mutex);
+    if (m_entries.empty()) {
+        return {};
+    }
+    evictIdleEntries();
+    const QString key = entryKey(localFileName, pProvider, params);
+    const auto it = std::find_if(m_entries.begin(),
+            m_entries.end(),
+            [&key](const auto& pEntry) { return pEntry->key() == key; });
+    if (it == m_entries.end()) {
+        return {};
+    }
+    const auto pEntry = std::move(*it);
+    m_entries.erase(it);
+    if (!pEntry->isFileUnmodified()) {
+        kLogger.debug()
+                << "Discarding decoder of modified file"
+                << localFileName;
+        ++m_metrics.evictedCount;
+        return {};
+    }
+    return pEntry->release();
+}
+
+void SoundSourcePool::put(
+        SoundSourcePointer pSoundSource,
+        SoundSourceProviderPointer pProvider,
+        const AudioSource::OpenParams& params) {
+    VERIFY_OR_DEBUG_ASSERT(pSoundSource && pProvider) {
+        return;
+    }
+    QMutexLocker locked(&m_mutex);
+    if (m_capacity <= 0) {
+        pSoundSource->close();
+        return;
+    }
+    if (pSoundSource.use_count() > 1) {
+        // Still in use, sharing it with a later reader is unsafe
+        pSoundSource->close();
+        return;
+    }
+    evictIdleEntries();
+    const QString key = entryKey(pSoundSource->getLocalFileName(), pProvider, params);
+    // Replaces an existing entry with the same key
+    const auto it = std::find_if(m_entries.begin(),
+            m_entries.end(),
+            [&key](const auto& pEntry) { return pEntry->key() == key; });
+    if (it != m_entries.end()) {
+        m_entries.erase(it);
+        ++m_metrics.evictedCount;
+    }
+    // Closes the least recently released entry if the pool is full
+    evictLeastRecentlyReleasedEntries(m_capacity - 1);
+    m_entries.push_back(std::make_unique<Entry>(
+            key, std::move(pSoundSource), std::move(pProvider)));
+}
+
+void SoundSourcePool::evict(const QString& localFileName) {
+    QMutexLocker locked(&m_mutex);
+    m_metrics.evictedCount += static_cast<int>(m_entries.remove_if(
+            [&localFileName](const auto& pEntry) {
+                return pEntry->localFileName() == localFileName;
+            }));
+}
+
+void SoundSourcePool::clear() {
+    QMutexLocker locked(&m_mutex);
+    m_metrics.evictedCount += static_cast<int>(m_entries.size());
+    m_entries.clear();
+}
+
+void SoundSourcePool::evictIdleEntries() {
+    m_metrics.evictedCount += static_cast<int>(m_entries.remove_if(
+            [](const auto& pEntry) { return pEntry->isIdle(); }));
+}
+
+void SoundSourcePool::evictLeastRecentlyReleasedEntries(int capacity) {
+    while (static_cast<int>(m_entries.size()) > std::max(capacity, 0)) {
+        m_entries.pop_front();
+        ++m_metrics.evictedCount;
+    }
+}
+
+void SoundSourcePool::recordOpen(bool warm, bool succeeded, Duration latency) {
+    {
+        QMutexLocker locked(&m_mutex);
+        if (!succeeded) {
+            ++m_metrics.failedOpenCount;
+        } else if (warm) {
+            ++m_metrics.warmOpenCount;
+            m_metrics.warmOpenDuration += latency;
+        } else {
+            ++m_metrics.coldOpenCount;
+            m_metrics.coldOpenDuration += latency;
+        }
+    }
+    if (succeeded && CmdlineArgs::Instance().getDeveloper()) {
+        Stat::track(warm ? QStringLiteral("SoundSourceProxy::openAudioSource warm")
+                         : QStringLiteral("SoundSourceProxy::openAudioSource cold"),
+                Stat::DURATION_NANOSEC,
+                kDefaultComputeFlags,
+                latency.toIntegerNanos());
+    }
+}
+
+SoundSourcePool::Metrics SoundSourcePool::metrics() const {
+    QMutexLocker locked(&m_mutex);
+    return m_metrics;
+}
+
+} // namespace mixxx
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QMutex>
+#include <QString>
+#include <list>
+#include <memory>
+#include <utility>
+
+#include "sources/soundsourceprovider.h"
+#include "util/duration.h"
+
+namespace mixxx {
+
+/// A bounded pool of open SoundSources that have recently been released by
+/// their reader.
+///
+/// Loading the same track again shortly afterwards, e.g. when browsing the
+/// library with the preview deck or when reloading a sampler, reuses the
+/// open decoder instead of probing the container and initializing the codec
+/// again. Entries are keyed by file, provider, and the requested signal and
+/// are discarded if the file has been modified in the meantime or if they
+/// have not been used for a while.
+///
+/// Pooled SoundSources keep their file open. Callers that need exclusive
+/// access to a file, e.g. for writing metadata, must evict it first.
+///
+/// All functions are thread-safe.
+class SoundSourcePool final {
+  public:
+    struct Metrics {
+        int warmOpenCount = 0;
+        int coldOpenCount = 0;
+        int failedOpenCount = 0;
+        int evictedCount = 0;
+        Duration warmOpenDuration;
+        Duration coldOpenDuration;
+    };
+
+    /// Entries that have not been reused within this time are closed on
+    /// the next access of the pool, i.e. on the next take() or put().
+    static constexpr Duration kMaxIdleDuration = Duration::fromSeconds(60);
+
+    /// The pool is disabled until a capacity > 0 is set.
+    SoundSourcePool();
+    ~SoundSourcePool();
+
+    void setCapacity(int capacity);
+    int capacity() const;
+
+    /// Takes an open SoundSource for the file out of the pool. Returns a
+    /// pair of null pointers if none is available.
+    std::pair<SoundSourcePointer, SoundSourceProviderPointer> take(
+            const QString& localFileName,
+            const SoundSourceProviderPointer& pProvider,
+            const AudioSource::OpenParams& params);
+
+    /// Returns a SoundSource that is still open. It is closed instead if the
+    /// pool is disabled or if it is still referenced elsewhere, e.g. by the
+    /// SoundSourceProxy that opened it.
+    void put(
+            SoundSourcePointer pSoundSource,
+            SoundSourceProviderPointer pProvider,
+            const AudioSource::OpenParams& params);
+
+    /// Closes all pooled SoundSources of the file.
+    void evict(const QString& localFileName);
+    /// Closes all pooled SoundSources.
+    void clear();
+
+    void recordOpen(bool warm, bool succeeded, Duration latency);
+    Metrics metrics() const;
+
+  private:
+    class Entry;
+
+    void evictIdleEntries();
+    void evictLeastRecentlyReleasedEntries(int capacity);
+
+    mutable QMutex m_mutex;
+    int m_capacity;
+    /// Ordered from the least to the most recently released entry. Looking
+    /// up an entry doesn't change the order.
+    std::list<std::unique_ptr<Entry>> m_entries;
+    Metrics m_metrics;
+};
+
+} // namespace mixxx
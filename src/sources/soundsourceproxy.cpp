@@ -1,11 +1,17 @@
 #include "sources/soundsourceproxy.h"
 
 #include <QApplication>
+#include <QCache>
+#include <QDateTime>
+#include <QFileInfo>
 #include <QMimeDatabase>
 #include <QMimeType>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QRegularExpression>
 #include <QStandardPaths>
 
+#include "sources/audiosourceproxy.h"
 #include "sources/audiosourcetrackproxy.h"
 
 #ifdef __MAD__
@@ -44,6 +50,7 @@
 #include "track/track.h"
 #include "util/cmdlineargs.h"
 #include "util/logger.h"
+#include "util/performancetimer.h"
 #include "util/regex.h"
 
 //Static memory allocation
@@ -51,6 +58,8 @@
 /*static*/ QStringList SoundSourceProxy::s_supportedFileNamePatterns;
 /*static*/ QRegularExpression SoundSourceProxy::s_supportedFileNamesRegex;
 /*static*/ QHash<QMimeType, QString> SoundSourceProxy::s_fileTypeByMimeType;
+/*static*/ mixxx::SoundSourcePool SoundSourceProxy::s_soundSourcePool;
+/*static*/ mixxx::TrackMetadataPrefetcher SoundSourceProxy::s_trackMetadataPrefetcher;
 
 namespace {
 
@@ -183,6 +192,104 @@ QList<QMimeType> mimeTypesForFileType(const QString& fileType) {
     return mimeTypes;
 }
 
+/// Detecting the file type reads the file content for looking up the
+/// MIME type. The result is cached for recently used files, which are
+/// often opened repeatedly by different components.
+struct CachedFileType {
+    qint64 fileSize;
+    QDateTime lastModified;
+    QString fileType;
+};
+
+constexpr int kFileTypeCacheCapacity = 256;
+
+QMutex s_fileTypeCacheMutex;
+QCache<QString, CachedFileType> s_fileTypeCache(kFileTypeCacheCapacity);
+
+QString getTypeFromUrlCached(const QUrl& url) {
+    if (!url.isLocalFile()) {
+        return mixxx::SoundSource::getTypeFromUrl(url);
+    }
+    const QFileInfo fileInfo(url.toLocalFile());
+    const qint64 fileSize = fileInfo.size();
+    const QDateTime lastModified = fileInfo.lastModified();
+    {
+        QMutexLocker locked(&s_fileTypeCacheMutex);
+        const CachedFileType* pCached = s_fileTypeCache.object(fileInfo.filePath());
+        if (pCached &&
+                pCached->fileSize == fileSize &&
+                pCached->lastModified == lastModified) {
+            return pCached->fileType;
+        }
+    }
+    const QString fileType = mixxx::SoundSource::getTypeFromFile(fileInfo);
+    if (fileInfo.exists() && !fileType.isEmpty()) {
+        QMutexLocker locked(&s_fileTypeCacheMutex);
+        s_fileTypeCache.insert(fileInfo.filePath(),
+                new CachedFileType{fileSize, lastModified, fileType});
+    }
+    return fileType;
+}
+
+/// Returns the SoundSource into the pool instead of closing it when
+/// the reader is done.
+class PooledAudioSource : public mixxx::AudioSourceProxy {
+  public:
+    PooledAudioSource(
+            mixxx::SoundSourcePool* pPool,
+            mixxx::SoundSourcePointer pSoundSource,
+            mixxx::SoundSourceProviderPointer pProvider,
+            const mixxx::AudioSource::OpenParams& params)
+            : mixxx::AudioSourceProxy(mixxx::AudioSourcePointer(pSoundSource)),
+              m_pPool(pPool),
+              m_pSoundSource(std::move(pSoundSource)),
+              m_pProvider(std::move(pProvider)),
+              m_params(params) {
+    }
+    ~PooledAudioSource() override {
+        release();
+    }
+
+    void close() override {
+        release();
+    }
+
+    void adviseAccessPattern(AccessPattern accessPattern) override {
+        if (!m_pSoundSource) {
+            // Owned by the pool
+            return;
+        }
+        mixxx::AudioSourceProxy::adviseAccessPattern(accessPattern);
+    }
+
+  protected:
+    mixxx::ReadableSampleFrames readSampleFramesClamped(
+            const mixxx::WritableSampleFrames& sampleFrames) override {
+        VERIFY_OR_DEBUG_ASSERT(m_pSoundSource) {
+            // Owned by the pool
+            return mixxx::ReadableSampleFrames();
+        }
+        return mixxx::AudioSourceProxy::readSampleFramesClamped(sampleFrames);
+    }
+
+  private:
+    void release() {
+        if (!m_pSoundSource) {
+            // Already released
+            return;
+        }
+        // Drop the reference of the proxy first, the pool expects
+        // to be the only owner of the SoundSource
+        m_pAudioSource.reset();
+        m_pPool->put(std::move(m_pSoundSource), std::move(m_pProvider), m_params);
+    }
+
+    mixxx::SoundSourcePool* const m_pPool;
+    mixxx::SoundSourcePointer m_pSoundSource;
+    mixxx::SoundSourceProviderPointer m_pProvider;
+    const mixxx::AudioSource::OpenParams m_params;
+};
+
 } // anonymous namespace
 
 // static
@@ -348,8 +455,7 @@ SoundSourceProxy::allProviderRegistrationsForUrl(
         // silently ignore empty URLs
         return {};
     }
-    const QString fileType =
-            mixxx::SoundSource::getTypeFromUrl(url);
+    const QString fileType = getTypeFromUrlCached(url);
     if (fileType.isEmpty()) {
         kLogger.warning()
                 << "Unknown file type:"
@@ -367,6 +473,11 @@ SoundSourceProxy::allProviderRegistrationsForUrl(
     return providerRegistrations;
 }
 
+// static
+void SoundSourceProxy::evictFromSoundSourcePool(const mixxx::FileInfo& fileInfo) {
+    s_soundSourcePool.evict(fileInfo.toQUrl().toLocalFile());
+}
+
 //static
 ExportTrackMetadataResult
 SoundSourceProxy::exportTrackMetadataBeforeSaving(
@@ -374,6 +485,9 @@ SoundSourceProxy::exportTrackMetadataBeforeSaving(
         const SyncTrackMetadataParams& syncParams) {
     DEBUG_ASSERT(pTrack);
     const auto fileInfo = pTrack->getFileInfo();
+    // Pooled decoders keep the file open, which might prevent
+    // writing the file on some platforms.
+    evictFromSoundSourcePool(fileInfo);
     mixxx::SoundSourcePointer pSoundSource;
     {
         auto proxy = SoundSourceProxy(fileInfo.toQUrl());
@@ -589,6 +703,29 @@ SoundSourceProxy::importTrackMetadataAndCoverImage(
             resetMissingTagMetadata);
 }
 
+std::pair<mixxx::MetadataSource::ImportResult, QDateTime>
+SoundSourceProxy::importPrefetchedTrackMetadataAndCoverImage(
+        mixxx::TrackMetadata* pTrackMetadata,
+        QImage* pCoverImage,
+        bool resetMissingTagMetadata) const {
+    DEBUG_ASSERT(pTrackMetadata);
+    auto prefetched = s_trackMetadataPrefetcher.take(
+            m_pTrack->getLocation(),
+            *pTrackMetadata,
+            resetMissingTagMetadata);
+    if (!prefetched) {
+        return importTrackMetadataAndCoverImage(
+                pTrackMetadata,
+                pCoverImage,
+                resetMissingTagMetadata);
+    }
+    *pTrackMetadata = std::move(prefetched->trackMetadata);
+    if (pCoverImage) {
+        *pCoverImage = std::move(prefetched->coverImage);
+    }
+    return std::make_pair(prefetched->importResult, prefetched->sourceSynchronizedAt);
+}
+
 namespace {
 
 inline bool shouldUpdateTrackMetadataFromSource(
@@ -690,8 +827,9 @@ SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromS
 
     // Parse the tags stored in the audio file and the date and time when the
     // file has been last modified to detect future changes of the tags.
+    // The file might already have been parsed in advance.
     auto [metadataImportResult, sourceSynchronizedAt] =
-            importTrackMetadataAndCoverImage(
+            importPrefetchedTrackMetadataAndCoverImage(
                     &trackMetadata,
                     pCoverImg,
                     syncParams.resetMissingTagMetadataOnImport);
@@ -927,11 +1065,35 @@ mixxx::AudioSourcePointer SoundSourceProxy::openAudioSource(
     VERIFY_OR_DEBUG_ASSERT(m_pTrack) {
         return nullptr;
     }
-    if (!openSoundSource(params)) {
+    PerformanceTimer timer;
+    timer.start();
+    bool warm = false;
+    if (m_pProvider && m_pSoundSource) {
+        auto [pSoundSource, pProvider] = s_soundSourcePool.take(
+                m_pSoundSource->getLocalFileName(),
+                m_pProvider,
+                params);
+        if (pSoundSource) {
+            // Reuse the decoder that is already open, e.g. by the
+            // analyzer that read it sequentially before
+            pSoundSource->adviseAccessPattern(params.getAccessPattern());
+            m_pSoundSource = std::move(pSoundSource);
+            m_pProvider = std::move(pProvider);
+            warm = true;
+        }
+    }
+    if (!warm && !openSoundSource(params)) {
+        s_soundSourcePool.recordOpen(false, false, timer.elapsed());
         return nullptr;
     }
+    s_soundSourcePool.recordOpen(warm, true, timer.elapsed());
     // Overwrite metadata with actual audio properties
     m_pTrack->updateStreamInfoFromSource(
             m_pSoundSource->getStreamInfo());
-    return mixxx::AudioSourceTrackProxy::create(m_pTrack, m_pSoundSource);
+    return mixxx::AudioSourceTrackProxy::create(m_pTrack,
+            std::make_shared<PooledAudioSource>(
+                    &s_soundSourcePool,
+                    m_pSoundSource,
+                    m_pProvider,
+                    params));
 }
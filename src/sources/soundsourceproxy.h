@@ -2,7 +2,9 @@
 
 #include <QMimeType>
 
+#include "sources/soundsourcepool.h"
 #include "sources/soundsourceproviderregistry.h"
+#include "sources/trackmetadataprefetcher.h"
 #include "track/track_decl.h"
 #include "util/sandbox.h"
 
@@ -60,6 +62,43 @@ class SoundSourceProxy {
     static mixxx::SoundSourceProviderPointer getPrimaryProviderForFileType(
             const QString& fileType);
 
+    /// Sets the number of recently released audio sources that are kept
+    /// open for reopening the same file with the same provider without
+    /// probing it again. The pool is disabled by default and setting the
+    /// capacity to 0 closes all pooled audio sources.
+    static void setSoundSourcePoolCapacity(int capacity) {
+        s_soundSourcePool.setCapacity(capacity);
+    }
+    /// Closes the pooled audio sources of a file before it is deleted or
+    /// after it has been moved.
+    static void evictFromSoundSourcePool(const mixxx::FileInfo& fileInfo);
+    /// Counters and accumulated latencies of openAudioSource().
+    static mixxx::SoundSourcePool::Metrics getSoundSourcePoolMetrics() {
+        return s_soundSourcePool.metrics();
+    }
+
+    /// Imports file tags and embedded cover art of many files concurrently
+    /// in advance, e.g. for a batch of new files that are added to the
+    /// library. updateTrackFromSource() picks up the results instead of
+    /// parsing the files again.
+    static mixxx::TrackMetadataPrefetcher::BatchId prefetchTrackMetadata(
+            const QList<mixxx::TrackMetadataPrefetcher::Request>& requests) {
+        return s_trackMetadataPrefetcher.prefetch(requests);
+    }
+    /// Returns false if the timeout expired before all prefetched files
+    /// have been imported.
+    static bool waitForPrefetchedTrackMetadata(int msecs = -1) {
+        return s_trackMetadataPrefetcher.waitForDone(msecs);
+    }
+    /// Only cancels the requests of the given prefetchTrackMetadata() call
+    static void cancelPrefetchingTrackMetadata(
+            mixxx::TrackMetadataPrefetcher::BatchId batchId) {
+        s_trackMetadataPrefetcher.cancel(batchId);
+    }
+    static mixxx::TrackMetadataPrefetcher::Metrics getTrackMetadataPrefetcherMetrics() {
+        return s_trackMetadataPrefetcher.metrics();
+    }
+
     explicit SoundSourceProxy(TrackPointer pTrack);
 
     // Only needed for testing all available providers explicitly
@@ -186,6 +225,10 @@ class SoundSourceProxy {
     /// last reference is dropped. One of these references is hold
     /// by SoundSourceProxy as a member.
     ///
+    /// If the pool is enabled then closing or releasing the audio
+    /// source returns the decoder into the pool, from where it is
+    /// reused when opening the same file again.
+    ///
     /// Note: If opening the audio stream fails the selection
     /// process may continue among the available providers and
     /// sound sources might be resumed and continue until a
@@ -199,6 +242,8 @@ class SoundSourceProxy {
     static QStringList s_supportedFileNamePatterns;
     static QRegularExpression s_supportedFileNamesRegex;
     static QHash<QMimeType, QString> s_fileTypeByMimeType;
+    static mixxx::SoundSourcePool s_soundSourcePool;
+    static mixxx::TrackMetadataPrefetcher s_trackMetadataPrefetcher;
 
     friend class TrackCollectionManager;
     static ExportTrackMetadataResult exportTrackMetadataBeforeSaving(
@@ -212,6 +257,14 @@ class SoundSourceProxy {
     bool openSoundSource(
             const mixxx::AudioSource::OpenParams& params = mixxx::AudioSource::OpenParams());
 
+    /// Picks up the result of prefetchTrackMetadata() if available and
+    /// otherwise imports from the file.
+    std::pair<mixxx::MetadataSource::ImportResult, QDateTime>
+    importPrefetchedTrackMetadataAndCoverImage(
+            mixxx::TrackMetadata* pTrackMetadata,
+            QImage* pCoverImage,
+            bool resetMissingTagMetadata) const;
+
     const TrackPointer m_pTrack;
 
     const QUrl m_url;
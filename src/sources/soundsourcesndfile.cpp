@@ -1,7 +1,5 @@
 #include "sources/soundsourcesndfile.h"
 
-#include <QDir>
-
 #include "util/logger.h"
 #include "util/semanticversion.h"
 
@@ -40,6 +38,54 @@ QStringList getSupportedFileTypesFiltered() {
     return supportedFileTypes;
 };
 
+sf_count_t sfVirtualGetFileLength(void* pUserData) {
+    return static_cast<MappedFileReader*>(pUserData)->size();
+}
+
+sf_count_t sfVirtualSeek(sf_count_t offset, int whence, void* pUserData) {
+    auto* pFile = static_cast<MappedFileReader*>(pUserData);
+    switch (whence) {
+    case SEEK_SET:
+        break;
+    case SEEK_CUR:
+        offset += pFile->pos();
+        break;
+    case SEEK_END:
+        offset += pFile->size();
+        break;
+    default:
+        return -1;
+    }
+    if (!pFile->seek(offset)) {
+        return -1;
+    }
+    return pFile->pos();
+}
+
+sf_count_t sfVirtualRead(void* pData, sf_count_t count, void* pUserData) {
+    const qint64 readCount = static_cast<MappedFileReader*>(pUserData)->read(pData, count);
+    if (readCount < 0) {
+        return 0;
+    }
+    return readCount;
+}
+
+sf_count_t sfVirtualWrite(const void* /*pData*/, sf_count_t /*count*/, void* /*pUserData*/) {
+    // Files are only opened for reading
+    return 0;
+}
+
+sf_count_t sfVirtualTell(void* pUserData) {
+    return static_cast<MappedFileReader*>(pUserData)->pos();
+}
+
+SF_VIRTUAL_IO s_sfVirtualIO = {
+        sfVirtualGetFileLength,
+        sfVirtualSeek,
+        sfVirtualRead,
+        sfVirtualWrite,
+        sfVirtualTell};
+
 } // anonymous namespace
 
 //static
@@ -77,23 +123,14 @@ SoundSourceSndFile::~SoundSourceSndFile() {
 
 SoundSource::OpenResult SoundSourceSndFile::tryOpen(
         OpenMode /*mode*/,
-        const OpenParams& /*config*/) {
+        const OpenParams& params) {
     DEBUG_ASSERT(!m_pSndFile);
+    if (!m_file.open(getLocalFileName(), params.getAccessPattern())) {
+        return OpenResult::Failed;
+    }
     SF_INFO sfInfo;
     memset(&sfInfo, 0, sizeof(sfInfo));
-#ifdef __WINDOWS__
-    // Note: we cannot use QString::toStdWString since QT 4 is compiled with
-    // '/Zc:wchar_t-' flag and QT 5 not
-    const QString localFileName(QDir::toNativeSeparators(getLocalFileName()));
-    const ushort* const fileNameUtf16 = localFileName.utf16();
-    static_assert(sizeof(wchar_t) == sizeof(ushort), "QString::utf16(): wchar_t and ushort have different sizes");
-    m_pSndFile = sf_wchar_open(
-            reinterpret_cast<wchar_t*>(const_cast<ushort*>(fileNameUtf16)),
-            SFM_READ,
-            &sfInfo);
-#else
-    m_pSndFile = sf_open(QFile::encodeName(getLocalFileName()), SFM_READ, &sfInfo);
-#endif
+    m_pSndFile = sf_open_virtual(&s_sfVirtualIO, SFM_READ, &sfInfo, &m_file);
 
     switch (sf_error(m_pSndFile)) {
     case SF_ERR_NO_ERROR:
@@ -127,16 +164,21 @@ SoundSource::OpenResult SoundSourceSndFile::tryOpen(
 
 void SoundSourceSndFile::close() {
     if (m_pSndFile != nullptr) {
+        // The handle is released even if closing fails
         const int closeResult = sf_close(m_pSndFile);
-        if (0 == closeResult) {
-            m_pSndFile = nullptr;
-            m_curFrameIndex = frameIndexMin();
-        } else {
+        if (0 != closeResult) {
             kLogger.warning() << "Failed to close file:" << closeResult
-                              << sf_strerror(m_pSndFile)
+                              << sf_error_number(closeResult)
                               << getUrlString();
         }
+        m_pSndFile = nullptr;
+        m_curFrameIndex = frameIndexMin();
     }
+    m_file.close();
+}
+
+void SoundSourceSndFile::adviseAccessPattern(AccessPattern accessPattern) {
+    m_file.adviseAccessPattern(accessPattern);
 }
 
 ReadableSampleFrames SoundSourceSndFile::readSampleFramesClamped(
@@ -1,15 +1,10 @@
 #pragma once
 
-#include "sources/soundsourceprovider.h"
-
-#ifdef Q_OS_WIN
-//Enable unicode in libsndfile on Windows
-//(sf_open uses UTF-8 otherwise)
-#include <windows.h>
-#define ENABLE_SNDFILE_WINDOWS_PROTOTYPES 1
-#endif
 #include <sndfile.h>
 
+#include "sources/mappedfilereader.h"
+#include "sources/soundsourceprovider.h"
+
 namespace mixxx {
 
 class SoundSourceSndFile final : public SoundSource {
@@ -19,6 +14,8 @@ class SoundSourceSndFile final : public SoundSource {
 
     void close() override;
 
+    void adviseAccessPattern(AccessPattern accessPattern) override;
+
   protected:
     ReadableSampleFrames readSampleFramesClamped(
             const WritableSampleFrames& sampleFrames) override;
@@ -28,6 +25,8 @@ class SoundSourceSndFile final : public SoundSource {
             OpenMode mode,
             const OpenParams& params) override;
 
+    // Unicode paths on Windows are handled by QFile
+    MappedFileReader m_file;
     SNDFILE* m_pSndFile;
 
     SINT m_curFrameIndex;
@@ -2,6 +2,10 @@
 
 #include <wavpack.h>
 
+#include <QFile>
+#include <cstdio>
+
+#include "sources/mappedfilereader.h"
 #include "util/logger.h"
 
 namespace mixxx {
@@ -69,13 +73,18 @@ SoundSource::OpenResult SoundSourceWV::tryOpen(
     // We use WavpackOpenFileInputEx to support Unicode paths on windows
     // http://www.wavpack.com/lib_use.txt
     QString wavPackFileName = getLocalFileName();
-    m_pWVFile = new QFile(wavPackFileName);
-    m_pWVFile->open(QFile::ReadOnly);
+    m_pWVFile = new MappedFileReader();
+    if (!m_pWVFile->open(wavPackFileName, params.getAccessPattern())) {
+        return OpenResult::Failed;
+    }
     QString correctionFileName(wavPackFileName + "c");
     if (QFile::exists(correctionFileName)) {
         // If there is a correction file, open it as well
-        m_pWVCFile = new QFile(correctionFileName);
-        m_pWVCFile->open(QFile::ReadOnly);
+        m_pWVCFile = new MappedFileReader();
+        if (!m_pWVCFile->open(correctionFileName, params.getAccessPattern())) {
+            delete m_pWVCFile;
+            m_pWVCFile = nullptr;
+        }
     }
     m_wpc = WavpackOpenFileInputEx(&s_streamReader, m_pWVFile, m_pWVCFile, msg, openFlags, 0);
     if (!m_wpc) {
@@ -130,6 +139,15 @@ void SoundSourceWV::close() {
     }
 }
 
+void SoundSourceWV::adviseAccessPattern(AccessPattern accessPattern) {
+    if (m_pWVFile) {
+        m_pWVFile->adviseAccessPattern(accessPattern);
+    }
+    if (m_pWVCFile) {
+        m_pWVCFile->adviseAccessPattern(accessPattern);
+    }
+}
+
 ReadableSampleFrames SoundSourceWV::readSampleFramesClamped(
         const WritableSampleFrames& writableSampleFrames) {
     const SINT firstFrameIndex = writableSampleFrames.frameIndexRange().start();
@@ -177,16 +195,20 @@ ReadableSampleFrames SoundSourceWV::readSampleFramesClamped(
 
 //static
 int32_t SoundSourceWV::ReadBytesCallback(void* id, void* data, int bcount) {
-    QFile* pFile = static_cast<QFile*>(id);
+    MappedFileReader* pFile = static_cast<MappedFileReader*>(id);
     if (!pFile) {
         return 0;
     }
-    return pFile->read((char*)data, bcount);
+    const qint64 readCount = pFile->read(data, bcount);
+    if (readCount < 0) {
+        return 0;
+    }
+    return static_cast<int32_t>(readCount);
 }
 
 // static
 uint32_t SoundSourceWV::GetPosCallback(void* id) {
-    QFile* pFile = static_cast<QFile*>(id);
+    MappedFileReader* pFile = static_cast<MappedFileReader*>(id);
     if (!pFile) {
         return 0;
     }
@@ -195,7 +217,7 @@ uint32_t SoundSourceWV::GetPosCallback(void* id) {
 
 //static
 int SoundSourceWV::SetPosAbsCallback(void* id, unsigned int pos) {
-    QFile* pFile = static_cast<QFile*>(id);
+    MappedFileReader* pFile = static_cast<MappedFileReader*>(id);
     if (!pFile) {
         return 0;
     }
@@ -204,7 +226,7 @@ int SoundSourceWV::SetPosAbsCallback(void* id, unsigned int pos) {
 
 //static
 int SoundSourceWV::SetPosRelCallback(void* id, int delta, int mode) {
-    QFile* pFile = static_cast<QFile*>(id);
+    MappedFileReader* pFile = static_cast<MappedFileReader*>(id);
     if (!pFile) {
         return 0;
     }
@@ -223,17 +245,16 @@ int SoundSourceWV::SetPosRelCallback(void* id, int delta, int mode) {
 
 //static
 int SoundSourceWV::PushBackByteCallback(void* id, int c) {
-    QFile* pFile = static_cast<QFile*>(id);
+    MappedFileReader* pFile = static_cast<MappedFileReader*>(id);
     if (!pFile) {
         return 0;
     }
-    pFile->ungetChar((char)c);
-    return 1;
+    return pFile->ungetByte(static_cast<char>(c)) ? c : EOF;
 }
 
 //static
 uint32_t SoundSourceWV::GetlengthCallback(void* id) {
-    QFile* pFile = static_cast<QFile*>(id);
+    MappedFileReader* pFile = static_cast<MappedFileReader*>(id);
     if (!pFile) {
         return 0;
     }
@@ -242,20 +263,20 @@ uint32_t SoundSourceWV::GetlengthCallback(void* id) {
 
 //static
 int SoundSourceWV::CanSeekCallback(void* id) {
-    QFile* pFile = static_cast<QFile*>(id);
+    MappedFileReader* pFile = static_cast<MappedFileReader*>(id);
     if (!pFile) {
         return 0;
     }
-    return pFile->isSequential() ? 0 : 1;
+    return 1;
 }
 
 //static
 int32_t SoundSourceWV::WriteBytesCallback(void* id, void* data, int32_t bcount) {
-    QFile* pFile = static_cast<QFile*>(id);
-    if (!pFile) {
-        return 0;
-    }
-    return (int32_t)pFile->write((char*)data, bcount);
+    Q_UNUSED(id);
+    Q_UNUSED(data);
+    Q_UNUSED(bcount);
+    // Files are only opened for reading
+    return 0;
 }
 
 } // namespace mixxx
@@ -3,10 +3,10 @@
 #include "sources/soundsource.h"
 #include "sources/soundsourceprovider.h"
 
-QT_FORWARD_DECLARE_CLASS(QFile);
-
 namespace mixxx {
 
+class MappedFileReader;
+
 class SoundSourceWV : public SoundSource {
   public:
     static int32_t ReadBytesCallback(void* id, void* data, int bcount);
@@ -23,6 +23,8 @@ class SoundSourceWV : public SoundSource {
 
     void close() override;
 
+    void adviseAccessPattern(AccessPattern accessPattern) override;
+
   protected:
     ReadableSampleFrames readSampleFramesClamped(
             const WritableSampleFrames& sampleFrames) override;
@@ -40,8 +42,8 @@ class SoundSourceWV : public SoundSource {
     void* m_wpc;
 
     CSAMPLE m_sampleScaleFactor;
-    QFile* m_pWVFile;
-    QFile* m_pWVCFile;
+    MappedFileReader* m_pWVFile;
+    MappedFileReader* m_pWVCFile;
 
     SINT m_curFrameIndex;
 };
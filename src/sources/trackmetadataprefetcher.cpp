@@ -0,0 +1,237 @@
+#include "sources/trackmetadataprefetcher.h"
+
+#include <QFile>
+#include <QFuture>
+#include <QMutexLocker>
+#include <QtConcurrentRun>
+#include <tuple>
+
+#include "sources/soundsourceproxy.h"
+#include "track/track.h"
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("TrackMetadataPrefetcher");
+
+QDateTime fileSynchronizedAt(const QString& location) {
+    return MetadataSource::getFileSynchronizedAt(QFile(location));
+}
+
+} // anonymous namespace
+
+TrackMetadataPrefetcher::TrackMetadataPrefetcher(int capacity)
+        : m_capacity(capacity),
+          m_sequenceNumber(0),
+          m_batchId(0) {
+    DEBUG_ASSERT(m_capacity > 0);
+    m_threadPool.setObjectName(QStringLiteral("TrackMetadataPrefetcher"));
+}
+
+TrackMetadataPrefetcher::~TrackMetadataPrefetcher() {
+    cancelPending();
+    m_threadPool.waitForDone();
+}
+
+TrackMetadataPrefetcher::BatchId TrackMetadataPrefetcher::prefetch(
+        const QList<Request>& requests) {
+    QMutexLocker locked(&m_mutex);
+    const BatchId batchId = ++m_batchId;
+    for (const auto& request : requests) {
+        const QString location = request.fileAccess.info().location();
+        auto& entry = m_entries[location];
+        if (entry.state == State::Done) {
+            m_doneLocations.removeOne(location);
+        }
+        // A worker that is currently importing the file for a
+        // previous request will discard its result
+        entry.request = request;
+        entry.state = State::Pending;
+        entry.sequenceNumber = ++m_sequenceNumber;
+        entry.batchId = batchId;
+        entry.result = Result();
+        const quint64 sequenceNumber = entry.sequenceNumber;
+        // Nobody waits for the result
+        const QFuture<void> future = QtConcurrent::run(
+                &m_threadPool,
+                [this, location, sequenceNumber] {
+                    importFile(location, sequenceNumber);
+                });
+        Q_UNUSED(future);
+    }
+    // Wake up workers that wait for room for replaced requests
+    m_entryTaken.wakeAll();
+    return batchId;
+}
+
+bool TrackMetadataPrefetcher::waitForDone(int msecs) {
+    return m_threadPool.waitForDone(msecs);
+}
+
+template<typename Predicate>
+void TrackMetadataPrefetcher::discardEntries(Predicate predicate) {
+    for (auto i = m_entries.begin(); i != m_entries.end();) {
+        if (i->state == State::InProgress || !predicate(*i)) {
+            ++i;
+            continue;
+        }
+        if (i->state == State::Done) {
+            // Results that are never taken would otherwise occupy the
+            // room for new results forever
+            m_doneLocations.removeOne(i.key());
+            ++m_metrics.discardedCount;
+        }
+        i = m_entries.erase(i);
+    }
+    // Wake up workers that are waiting for room
+    m_entryTaken.wakeAll();
+}
+
+void TrackMetadataPrefetcher::cancel(BatchId batchId) {
+    // The queued imports of the batch return immediately
+    QMutexLocker locked(&m_mutex);
+    discardEntries([batchId](const Entry& entry) {
+        return entry.batchId == batchId;
+    });
+}
+
+void TrackMetadataPrefetcher::cancelPending() {
+    m_threadPool.clear();
+    QMutexLocker locked(&m_mutex);
+    discardEntries([](const Entry&) {
+        return true;
+    });
+}
+
+bool TrackMetadataPrefetcher::isPending(
+        const QString& location,
+        quint64 sequenceNumber) const {
+    const auto i = m_entries.constFind(location);
+    // Otherwise canceled, taken, or replaced by a newer request
+    return i != m_entries.constEnd() &&
+            i->sequenceNumber == sequenceNumber &&
+            i->state == State::Pending;
+}
+
+bool TrackMetadataPrefetcher::waitForRoomForResult(
+        const QString& location,
+        quint64 sequenceNumber) {
+    // Results are kept until they are picked up, because the consumer
+    // takes them in the order they have been requested, i.e. the oldest
+    // results are the most valuable ones
+    while (m_doneLocations.size() >= m_capacity) {
+        m_entryTaken.wait(&m_mutex);
+        if (!isPending(location, sequenceNumber)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TrackMetadataPrefetcher::importFile(
+        const QString& location,
+        quint64 sequenceNumber) {
+    Request request;
+    {
+        QMutexLocker locked(&m_mutex);
+        if (!isPending(location, sequenceNumber)) {
+            return;
+        }
+        // Don't start importing more files than can be picked up
+        if (!waitForRoomForResult(location, sequenceNumber)) {
+            return;
+        }
+        auto& entry = m_entries[location];
+        entry.state = State::InProgress;
+        request = entry.request;
+    }
+
+    Result result;
+    result.trackMetadata = request.trackMetadata;
+    const QDateTime synchronizedBefore = fileSynchronizedAt(location);
+    // The file is only read once for both track metadata and the
+    // cover image. Instead of locking GlobalTrackCache while reading
+    // the modification time of the file is checked afterwards.
+    std::tie(result.importResult, result.sourceSynchronizedAt) =
+            SoundSourceProxy(Track::newTemporary(std::move(request.fileAccess)))
+                    .importTrackMetadataAndCoverImage(
+                            &result.trackMetadata,
+                            &result.coverImage,
+                            request.resetMissingTagMetadata);
+    const bool fileModified = synchronizedBefore != fileSynchronizedAt(location);
+
+    QMutexLocker locked(&m_mutex);
+    const auto i = m_entries.find(location);
+    if (i == m_entries.end() || i->sequenceNumber != sequenceNumber) {
+        // Replaced by a newer request
+        ++m_metrics.discardedCount;
+        return;
+    }
+    DEBUG_ASSERT(i->state == State::InProgress);
+    if (fileModified) {
+        kLogger.debug()
+                << "Discarding metadata of file that has been modified while reading"
+                << location;
+        m_entries.erase(i);
+        ++m_metrics.discardedCount;
+    } else {
+        i->result = std::move(result);
+        i->state = State::Done;
+        m_doneLocations.append(location);
+    }
+    m_entryDone.wakeAll();
+}
+
+std::optional<TrackMetadataPrefetcher::Result> TrackMetadataPrefetcher::take(
+        const QString& location,
+        const TrackMetadata& trackMetadata,
+        bool resetMissingTagMetadata) {
+    Entry entry;
+    {
+        QMutexLocker locked(&m_mutex);
+        auto i = m_entries.find(location);
+        while (i != m_entries.end() && i->state == State::InProgress) {
+            m_entryDone.wait(&m_mutex);
+            i = m_entries.find(location);
+        }
+        if (i == m_entries.end()) {
+            ++m_metrics.missCount;
+            return std::nullopt;
+        }
+        if (i->state == State::Pending) {
+            // Importing the file on a worker thread would only
+            // delay the caller
+            m_entries.erase(i);
+            ++m_metrics.missCount;
+            // The worker might be waiting for room
+            m_entryTaken.wakeAll();
+            return std::nullopt;
+        }
+        DEBUG_ASSERT(i->state == State::Done);
+        entry = std::move(*i);
+        m_entries.erase(i);
+        m_doneLocations.removeOne(location);
+        m_entryTaken.wakeAll();
+    }
+    const bool matching =
+            entry.request.resetMissingTagMetadata == resetMissingTagMetadata &&
+            entry.request.trackMetadata == trackMetadata &&
+            entry.result.sourceSynchronizedAt == fileSynchronizedAt(location);
+    QMutexLocker locked(&m_mutex);
+    if (!matching) {
+        ++m_metrics.discardedCount;
+        return std::nullopt;
+    }
+    ++m_metrics.hitCount;
+    return std::move(entry.result);
+}
+
+TrackMetadataPrefetcher::Metrics TrackMetadataPrefetcher::metrics() const {
+    QMutexLocker locked(&m_mutex);
+    return m_metrics;
+}
+
+} // namespace mixxx
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QMutex>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <optional>
+
+#include "sources/metadatasource.h"
+#include "track/trackmetadata.h"
+#include "util/fileaccess.h"
+
+namespace mixxx {
+
+/// Imports file tags, embedded cover art, Serato markers, and ReplayGain
+/// of many files concurrently ahead of time, e.g. while adding new files
+/// to the library or when re-importing the metadata of many tracks.
+///
+/// Each file is opened and parsed only once on a worker thread. The
+/// results are picked up by SoundSourceProxy::updateTrackFromSource()
+/// instead of parsing the file again on the calling thread.
+///
+/// Results are only handed out if both the file and the metadata of
+/// the track that the tags are merged into are still the same as when
+/// the import has been requested. Otherwise the caller imports the file
+/// itself as before.
+///
+/// All functions are thread-safe.
+class TrackMetadataPrefetcher final {
+  public:
+    struct Request {
+        FileAccess fileAccess;
+        /// The current metadata of the track that the file tags
+        /// will be merged into
+        TrackMetadata trackMetadata;
+        bool resetMissingTagMetadata = false;
+    };
+
+    struct Result {
+        MetadataSource::ImportResult importResult =
+                MetadataSource::ImportResult::Unavailable;
+        QDateTime sourceSynchronizedAt;
+        TrackMetadata trackMetadata;
+        QImage coverImage;
+    };
+
+    struct Metrics {
+        /// Results that have been handed out
+        int hitCount = 0;
+        /// Requests for files that have not been prefetched
+        int missCount = 0;
+        /// Results that have been discarded, e.g. because the file
+        /// has been modified in the meantime or the request has been
+        /// replaced
+        int discardedCount = 0;
+    };
+
+    /// The maximum number of imported results that are kept until they
+    /// are picked up. Workers don't start importing more files until a
+    /// result has been taken.
+    static constexpr int kDefaultCapacity = 256;
+
+    explicit TrackMetadataPrefetcher(int capacity = kDefaultCapacity);
+    ~TrackMetadataPrefetcher();
+
+    /// Identifies the requests of a single prefetch() call
+    typedef quint64 BatchId;
+
+    /// Starts importing the requested files on worker threads and
+    /// returns immediately. Requests for files that are already
+    /// pending replace the previous request. The returned id allows
+    /// to cancel the requests later.
+    BatchId prefetch(const QList<Request>& requests);
+
+    /// Blocks until all imports have finished or the timeout has expired.
+    /// Returns false on timeout, e.g. if more files than the capacity have
+    /// been requested and the results are not picked up.
+    bool waitForDone(int msecs = -1);
+
+    /// Discards the requests of a batch that have not been started yet and
+    /// the results of the batch that have not been taken. Requests that
+    /// have been replaced by another batch in the meantime are kept.
+    void cancel(BatchId batchId);
+    /// Discards all requests that have not been started yet and all
+    /// results that have not been taken.
+    void cancelPending();
+
+    /// Takes the result for the given file if it has been imported for
+    /// the same track metadata. Waits if the import is currently in
+    /// progress. A request that has not been started yet is discarded,
+    /// because the caller is supposed to import the file immediately.
+    std::optional<Result> take(
+            const QString& location,
+            const TrackMetadata& trackMetadata,
+            bool resetMissingTagMetadata);
+
+    Metrics metrics() const;
+
+  private:
+    enum class State {
+        Pending,
+        InProgress,
+        Done,
+    };
+
+    struct Entry {
+        Request request;
+        State state = State::Pending;
+        /// Distinguishes replaced requests for the same file
+        quint64 sequenceNumber = 0;
+        BatchId batchId = 0;
+        Result result;
+    };
+
+    void importFile(const QString& location, quint64 sequenceNumber);
+    /// Waits until there is room for another result. Returns false if
+    /// the request is no longer pending in the meantime. Requires that
+    /// m_mutex is locked.
+    bool waitForRoomForResult(const QString& location, quint64 sequenceNumber);
+    /// Requires that m_mutex is locked.
+    bool isPending(const QString& location, quint64 sequenceNumber) const;
+    /// Discards all entries that are pending or done and match the
+    /// predicate. Requires that m_mutex is locked.
+    template<typename Predicate>
+    void discardEntries(Predicate predicate);
+
+    const int m_capacity;
+
+    QThreadPool m_threadPool;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_entryDone;
+    QWaitCondition m_entryTaken;
+    QHash<QString, Entry> m_entries;
+    /// The locations of all entries in the order they have been done
+    QList<QString> m_doneLocations;
+    quint64 m_sequenceNumber;
+    BatchId m_batchId;
+    Metrics m_metrics;
+};
+
+} // namespace mixxx
@@ -0,0 +1,62 @@
+#include "util/cachedirectory.h"
+
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+namespace {
+
+class CacheDirectoryTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_cacheDir.isValid());
+    }
+
+    QString filePath(const QString& fileName) const {
+        return QDir(m_cacheDir.path()).filePath(fileName);
+    }
+
+    // Creates a file with size bytes that has been used secondsAgo
+    void createFile(const QString& fileName, int size, int secondsAgo) {
+        QFile file(filePath(fileName));
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        ASSERT_EQ(size, file.write(QByteArray(size, 'x')));
+        ASSERT_TRUE(file.setFileTime(
+                QDateTime::currentDateTimeUtc().addSecs(-secondsAgo),
+                QFileDevice::FileModificationTime));
+    }
+
+    QTemporaryDir m_cacheDir;
+};
+
+TEST_F(CacheDirectoryTest, RemovesLeastRecentlyUsedFiles) {
+    createFile("newest.cache", 100, 10);
+    createFile("middle.cache", 100, 20);
+    createFile("oldest.cache", 100, 30);
+    createFile("other.txt", 1000, 40);
+
+    EXPECT_EQ(0, mixxx::pruneCacheDirectory(m_cacheDir.path(), "*.cache", 300));
+    EXPECT_EQ(1, mixxx::pruneCacheDirectory(m_cacheDir.path(), "*.cache", 250));
+
+    EXPECT_TRUE(QFile::exists(filePath("newest.cache")));
+    EXPECT_TRUE(QFile::exists(filePath("middle.cache")));
+    EXPECT_FALSE(QFile::exists(filePath("oldest.cache")));
+    // Does not match the filter
+    EXPECT_TRUE(QFile::exists(filePath("other.txt")));
+}
+
+TEST_F(CacheDirectoryTest, TouchedFilesAreKept) {
+    createFile("first.cache", 100, 20);
+    createFile("second.cache", 100, 10);
+
+    mixxx::touchCacheFile(filePath("first.cache"));
+    EXPECT_EQ(1, mixxx::pruneCacheDirectory(m_cacheDir.path(), "*.cache", 100));
+
+    EXPECT_TRUE(QFile::exists(filePath("first.cache")));
+    EXPECT_FALSE(QFile::exists(filePath("second.cache")));
+}
+
+} // namespace
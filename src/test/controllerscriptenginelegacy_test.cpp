@@ -1,10 +1,13 @@
 #include "controllers/scripting/legacy/controllerscriptenginelegacy.h"
 
+#include <benchmark/benchmark.h>
+
 #include <QScopedPointer>
 #include <QTemporaryFile>
 #include <QThread>
 #include <QtDebug>
 #include <memory>
+#include <vector>
 
 #include "control/controlobject.h"
 #include "control/controlpotmeter.h"
@@ -54,6 +57,10 @@ class ControllerScriptEngineLegacyTest : public MixxxTest {
         return !evaluate(code).isError();
     }
 
+    void addIncomingDataFunction(const QString& functionName) {
+        cEngine->m_incomingDataFunctions.append(cEngine->wrapFunctionCode(functionName, 2));
+    }
+
     void processEvents() {
         // QCoreApplication::processEvents() only processes events that were
         // queued when the method was called. Hence, all subsequent events that
@@ -620,3 +627,236 @@ TEST_F(ControllerScriptEngineLegacyTest, connectionExecutesWithCorrectThisObject
     // The counter should have been incremented exactly once.
     EXPECT_DOUBLE_EQ(1.0, pass->get());
 }
+
+TEST_F(ControllerScriptEngineLegacyTest, getControl_getSetValue) {
+    auto co = std::make_unique<ControlPotmeter>(ConfigKey("[Test]", "co"),
+            -10.0,
+            10.0);
+    EXPECT_TRUE(evaluateAndAssert(
+            "var control = engine.getControl('[Test]', 'co');"
+            "control.value = control.value + 1;"));
+    EXPECT_DOUBLE_EQ(1.0, co->get());
+    EXPECT_TRUE(evaluateAndAssert("control.parameter = 1.0;"));
+    EXPECT_DOUBLE_EQ(10.0, co->get());
+    EXPECT_TRUE(evaluateAndAssert("control.value = NaN;"));
+    EXPECT_DOUBLE_EQ(10.0, co->get());
+    EXPECT_EQ("[Test]", evaluate("control.group").toString());
+    EXPECT_EQ("co", evaluate("control.item").toString());
+}
+
+TEST_F(ControllerScriptEngineLegacyTest, getControl_InvalidControl) {
+    EXPECT_TRUE(evaluate("engine.getControl('[Nothing]', 'nothing');").isUndefined());
+}
+
+TEST_F(ControllerScriptEngineLegacyTest, getControl_softTakeover) {
+    auto co = std::make_unique<ControlPotmeter>(ConfigKey("[Test]", "co"),
+            -10.0,
+            10.0);
+    co->setParameter(0.0);
+    EXPECT_TRUE(evaluateAndAssert(
+            "engine.softTakeover('[Test]', 'co', true);"
+            "var control = engine.getControl('[Test]', 'co');"
+            "control.parameter = 1.0;"));
+    // The first set after enabling is always ignored.
+    EXPECT_DOUBLE_EQ(-10.0, co->get());
+
+    // Ignore the change since it occurred after the threshold and is too large.
+    mixxx::Time::setTestElapsedTime(SoftTakeover::TestAccess::getTimeThreshold() * 2);
+    co->setParameter(0.5);
+    EXPECT_TRUE(evaluateAndAssert("control.parameter = 0.0;"));
+    EXPECT_DOUBLE_EQ(0.0, co->get());
+}
+
+TEST_F(ControllerScriptEngineLegacyTest, setValues) {
+    auto co1 = std::make_unique<ControlObject>(ConfigKey("[Test]", "co1"));
+    auto co2 = std::make_unique<ControlObject>(ConfigKey("[Test]", "co2"));
+    EXPECT_TRUE(evaluateAndAssert(
+            "engine.setValues(["
+            "  [engine.getControl('[Test]', 'co1'), 1.0],"
+            "  [engine.getControl('[Test]', 'co2'), 2.0],"
+            "]);"));
+    EXPECT_DOUBLE_EQ(1.0, co1->get());
+    EXPECT_DOUBLE_EQ(2.0, co2->get());
+
+    // Invalid pairs are skipped
+    EXPECT_TRUE(evaluateAndAssert(
+            "engine.setValues(["
+            "  [{}, 3.0],"
+            "  [engine.getControl('[Test]', 'co2'), 4.0],"
+            "]);"));
+    EXPECT_DOUBLE_EQ(1.0, co1->get());
+    EXPECT_DOUBLE_EQ(4.0, co2->get());
+}
+
+TEST_F(ControllerScriptEngineLegacyTest, incomingData_recycledArrays) {
+    EXPECT_TRUE(evaluateAndAssert(
+            "var Test = {packets: []};"
+            "Test.incomingData = function(data, length) {"
+            "  Test.packets.push(data);"
+            "};"));
+    addIncomingDataFunction(QStringLiteral("Test.incomingData"));
+
+    cEngine->handleIncomingData(QByteArray(3, 1));
+    cEngine->handleIncomingData(QByteArray(3, 2));
+    EXPECT_TRUE(evaluate("Test.packets[0] !== Test.packets[1]").toBool());
+    EXPECT_EQ(1, evaluate("Test.packets[0][2]").toInt());
+    EXPECT_EQ(3u, evaluate("Test.packets[1].length").toUInt());
+    EXPECT_EQ(4u, cEngine->incomingDataAllocationCount());
+
+    cEngine->setIncomingDataRecycling(true);
+    const int count = ControllerScriptEngineLegacy::kRecycledIncomingDataArrayCount;
+    for (int i = 0; i <= count; ++i) {
+        cEngine->handleIncomingData(QByteArray(3, static_cast<char>(10 + i)));
+    }
+    // The first array is filled in place with the data of the last packet
+    EXPECT_TRUE(evaluate(QStringLiteral("Test.packets[2] === Test.packets[%1]")
+                                 .arg(2 + count))
+                        .toBool());
+    EXPECT_EQ(10 + count, evaluate("Test.packets[2][0]").toInt());
+    EXPECT_EQ(11, evaluate("Test.packets[3][0]").toInt());
+    EXPECT_EQ(4u + 2u * count, cEngine->incomingDataAllocationCount());
+    EXPECT_EQ(1u, cEngine->incomingDataRecycledCount());
+
+    // Packets of a different size are passed in different arrays
+    cEngine->handleIncomingData(QByteArray(5, 42));
+    EXPECT_EQ(5u, evaluate("Test.packets[Test.packets.length - 1].length").toUInt());
+    EXPECT_EQ(6u + 2u * count, cEngine->incomingDataAllocationCount());
+}
+
+namespace {
+
+constexpr int kBenchmarkDeckCount = 4;
+
+/// A reference mapping, that updates the controls of a deck for each jog
+/// wheel message like mappings based on Components JS do. The same logic is
+/// implemented with the string based API, with control handles and with
+/// control handles and batched updates.
+const QString kReferenceMappingScript = QStringLiteral(
+        "var Reference = {};"
+        "Reference.groups = ['[Channel1]', '[Channel2]', '[Channel3]', '[Channel4]'];"
+        "Reference.handles = Reference.groups.map(function(group) {"
+        "  return {"
+        "    play: engine.getControl(group, 'play'),"
+        "    rate: engine.getControl(group, 'rate'),"
+        "    jog: engine.getControl(group, 'jog'),"
+        "    volume: engine.getControl(group, 'volume'),"
+        "    pfl: engine.getControl(group, 'pfl'),"
+        "  };"
+        "});"
+        "Reference.inputByName = function(channel, control, value, status, group) {"
+        "  var deck = Reference.groups[channel];"
+        "  var delta = (value - 64) / 64;"
+        "  if (engine.getValue(deck, 'play') > 0) {"
+        "    engine.setValue(deck, 'jog', engine.getValue(deck, 'jog') + delta);"
+        "  } else {"
+        "    engine.setValue(deck, 'rate', delta);"
+        "  }"
+        "  engine.setValue(deck, 'volume', value / 127);"
+        "  engine.setValue(deck, 'pfl', engine.getValue(deck, 'volume') > 0.5 ? 1 : 0);"
+        "};"
+        "Reference.inputByHandle = function(channel, control, value, status, group) {"
+        "  var deck = Reference.handles[channel];"
+        "  var delta = (value - 64) / 64;"
+        "  if (deck.play.value > 0) {"
+        "    deck.jog.value = deck.jog.value + delta;"
+        "  } else {"
+        "    deck.rate.value = delta;"
+        "  }"
+        "  deck.volume.value = value / 127;"
+        "  deck.pfl.value = deck.volume.value > 0.5 ? 1 : 0;"
+        "};"
+        "Reference.inputBatched = function(channel, control, value, status, group) {"
+        "  var deck = Reference.handles[channel];"
+        "  var delta = (value - 64) / 64;"
+        "  var volume = value / 127;"
+        "  engine.setValues(["
+        "    deck.play.value > 0 ? [deck.jog, deck.jog.value + delta] : [deck.rate, delta],"
+        "    [deck.volume, volume],"
+        "    [deck.pfl, volume > 0.5 ? 1 : 0],"
+        "  ]);"
+        "};");
+
+} // namespace
+
+/// Runs the reference mapping with synthetic jog wheel messages. The range
+/// selects the input function, see kReferenceMappingScript.
+static void BM_ControllerScriptReferenceMapping(benchmark::State& state) {
+    std::vector<std::unique_ptr<ControlObject>> controls;
+    for (int deck = 1; deck <= kBenchmarkDeckCount; ++deck) {
+        const QString group = QStringLiteral("[Channel%1]").arg(deck);
+        for (const auto& item : {"play", "rate", "jog", "volume", "pfl"}) {
+            controls.push_back(std::make_unique<ControlPotmeter>(
+                    ConfigKey(group, QString::fromLatin1(item)), -10.0, 10.0));
+        }
+    }
+
+    QTemporaryFile scriptFile;
+    scriptFile.open();
+    scriptFile.write(kReferenceMappingScript.toUtf8());
+    scriptFile.close();
+    LegacyControllerMapping::ScriptFileInfo scriptFileInfo;
+    scriptFileInfo.file = QFileInfo(scriptFile.fileName());
+
+    ControllerScriptEngineLegacy engine(nullptr, logger);
+    engine.setTesting(true);
+    engine.setScriptFiles({scriptFileInfo});
+    if (!engine.initialize()) {
+        state.SkipWithError("Failed to evaluate the reference mapping");
+        return;
+    }
+
+    const QString functions[] = {
+            QStringLiteral("Reference.inputByName"),
+            QStringLiteral("Reference.inputByHandle"),
+            QStringLiteral("Reference.inputBatched"),
+    };
+    const int function = engine.bindFunctionCode(functions[state.range(0)], 5);
+    int i = 0;
+    for (auto _ : state) {
+        const int channel = i % kBenchmarkDeckCount;
+        const int value = (i / kBenchmarkDeckCount) % 128;
+        engine.executeBoundFunction(function,
+                QJSValueList{channel, 0x21, value, 0xB0 | channel, QString()});
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ControllerScriptReferenceMapping)->DenseRange(0, 2);
+
+/// Passes 64 byte packets, as sent by HID controllers with 1 kHz, to an
+/// incomingData function. The range selects whether the arrays are recycled.
+static void BM_ControllerScriptIncomingData(benchmark::State& state) {
+    QTemporaryFile scriptFile;
+    scriptFile.open();
+    scriptFile.write(
+            "var Incoming = {sum: 0};"
+            "Incoming.incomingData = function(data, length) {"
+            "  Incoming.sum += data[1] + data[length - 1];"
+            "};");
+    scriptFile.close();
+    LegacyControllerMapping::ScriptFileInfo scriptFileInfo;
+    scriptFileInfo.file = QFileInfo(scriptFile.fileName());
+    scriptFileInfo.functionPrefix = QStringLiteral("Incoming");
+
+    ControllerScriptEngineLegacy engine(nullptr, logger);
+    engine.setScriptFiles({scriptFileInfo});
+    if (!engine.initialize()) {
+        state.SkipWithError("Failed to evaluate the script");
+        return;
+    }
+    engine.setIncomingDataRecycling(state.range(0) != 0);
+
+    QByteArray packet(64, 0);
+    int i = 0;
+    for (auto _ : state) {
+        packet[1] = static_cast<char>(i);
+        packet[63] = static_cast<char>(i >> 8);
+        engine.handleIncomingData(packet);
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["allocations"] = benchmark::Counter(
+            static_cast<double>(engine.incomingDataAllocationCount()),
+            benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_ControllerScriptIncomingData)->DenseRange(0, 1);
@@ -0,0 +1,319 @@
+#include "controllers/controllerthread.h"
+
+#include <gtest/gtest.h>
+
+#include <QJSEngine>
+#include <QStringList>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "control/controlpotmeter.h"
+#include "controllers/controllermanager.h"
+#include "controllers/midi/legacymidicontrollermapping.h"
+#include "controllers/midi/midicontroller.h"
+#include "controllers/midi/midiutils.h"
+#include "controllers/scripting/controllerscriptwatchdog.h"
+#include "test/mixxxtest.h"
+#include "util/time.h"
+
+namespace {
+
+constexpr unsigned char kControl = 0x10;
+
+/// Receives the messages that are queued by the test like the messages
+/// of a MIDI device and counts the polls.
+class FakeMidiController : public MidiController {
+  public:
+    explicit FakeMidiController(const QString& deviceName)
+            : MidiController(deviceName),
+              m_receivedCount(0),
+              m_pollCount(0) {
+        setPolling(true);
+    }
+    ~FakeMidiController() override {
+        DEBUG_ASSERT(!isOpen());
+    }
+
+    int open() override {
+        setOpen(true);
+        return 0;
+    }
+    int close() override {
+        MidiController::close();
+        setOpen(false);
+        return 0;
+    }
+    bool poll() override {
+        m_pollCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    void receivedShortMessage(unsigned char status,
+            unsigned char control,
+            unsigned char value,
+            mixxx::Duration timestamp) override {
+        DEBUG_ASSERT(thread() == QThread::currentThread());
+        ++m_receivedCount;
+        MidiController::receivedShortMessage(status, control, value, timestamp);
+    }
+
+    int receivedCount() const {
+        return m_receivedCount;
+    }
+    int pollCount() const {
+        return m_pollCount.load(std::memory_order_relaxed);
+    }
+
+  protected:
+    void sendShortMsg(unsigned char, unsigned char, unsigned char) override {
+    }
+    void sendBytes(const QByteArray&) override {
+    }
+
+  private:
+    /// Only accessed by the thread of the controller
+    int m_receivedCount;
+    std::atomic<int> m_pollCount;
+};
+
+/// Advances the time of the test by its poll duration and logs its polls
+class SlowFakeMidiController : public FakeMidiController {
+  public:
+    SlowFakeMidiController(const QString& deviceName,
+            mixxx::Duration pollDuration,
+            QStringList* pPollLog)
+            : FakeMidiController(deviceName),
+              m_pollDuration(pollDuration),
+              m_pPollLog(pPollLog) {
+    }
+
+    bool poll() override {
+        m_pPollLog->append(getName());
+        mixxx::Time::setTestElapsedTime(mixxx::Time::elapsed() + m_pollDuration);
+        return FakeMidiController::poll();
+    }
+
+  private:
+    const mixxx::Duration m_pollDuration;
+    QStringList* const m_pPollLog;
+};
+
+class ControllerThreadTest : public MixxxTest {
+};
+
+TEST_F(ControllerThreadTest, concurrentInputOfMultipleControllers) {
+    constexpr int kControllerCount = 4;
+    constexpr int kMessageCount = 5000;
+
+    std::vector<std::unique_ptr<ControlPotmeter>> controls;
+    std::vector<std::unique_ptr<FakeMidiController>> controllers;
+    std::vector<std::unique_ptr<ControllerThread>> threads;
+    for (int i = 0; i < kControllerCount; ++i) {
+        const ConfigKey key(QStringLiteral("[Test]"), QStringLiteral("stress_%1").arg(i));
+        controls.push_back(std::make_unique<ControlPotmeter>(key, 0.0, 127.0));
+
+        auto pMapping = std::make_shared<LegacyMidiControllerMapping>();
+        const MidiKey midiKey(MidiUtils::statusFromOpCodeAndChannel(
+                                      MidiOpCode::ControlChange, 0),
+                kControl);
+        pMapping->addInputMapping(midiKey.key,
+                MidiInputMapping(midiKey, MidiOptions(), key));
+
+        auto pController = std::make_unique<FakeMidiController>(
+                QStringLiteral("Stress %1").arg(i));
+        pController->setMapping(pMapping->clone());
+        threads.push_back(std::make_unique<ControllerThread>(
+                pController.get(), mixxx::Duration::fromMillis(1)));
+        // Not started yet, i.e. the controller is not accessed concurrently
+        pController->open();
+        threads.back()->start();
+        controllers.push_back(std::move(pController));
+    }
+
+    // Drive the input of all controllers concurrently, like the threads of
+    // the devices do
+    std::vector<std::thread> devices;
+    for (const auto& pController : controllers) {
+        devices.emplace_back([pController = pController.get()] {
+            for (int i = 0; i < kMessageCount; ++i) {
+                // The last message sets the maximum
+                const unsigned char value = (i % 2 == 0) ? 0x00 : 0x7F;
+                QMetaObject::invokeMethod(
+                        pController,
+                        [pController, value] {
+                            pController->receivedShortMessage(0xB0,
+                                    kControl,
+                                    value,
+                                    mixxx::Time::elapsed());
+                        },
+                        Qt::QueuedConnection);
+            }
+        });
+    }
+    for (auto& device : devices) {
+        device.join();
+    }
+
+    for (int i = 0; i < kControllerCount; ++i) {
+        FakeMidiController* pController = controllers[i].get();
+        // Processed after all messages have been received
+        int receivedCount = 0;
+        QMetaObject::invokeMethod(
+                pController,
+                [pController, &receivedCount] {
+                    receivedCount = pController->receivedCount();
+                },
+                Qt::BlockingQueuedConnection);
+        EXPECT_EQ(kMessageCount, receivedCount);
+        EXPECT_DOUBLE_EQ(127.0, controls[i]->get());
+
+        // Each controller is polled by its own thread
+        for (int wait = 0; wait < 1000 && pController->pollCount() == 0; ++wait) {
+            QThread::msleep(1);
+        }
+        EXPECT_LT(0, pController->pollCount());
+
+        QMetaObject::invokeMethod(
+                pController,
+                [pController] {
+                    pController->close();
+                },
+                Qt::BlockingQueuedConnection);
+        threads[i]->stop();
+        EXPECT_EQ(QThread::currentThread(), pController->thread());
+    }
+}
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+TEST(ControllerScriptWatchdogTest, interruptEndlessLoop) {
+    QJSEngine engine;
+    ControllerScriptWatchdog watchdog(&engine, mixxx::Duration::fromMillis(50));
+
+    QJSValue endlessLoop = engine.evaluate(QStringLiteral("(function() { while (true) {} })"));
+    QJSValue result;
+    {
+        const ControllerScriptWatchdog::Callback callback(&watchdog);
+        result = endlessLoop.call();
+    }
+    EXPECT_TRUE(result.isError());
+    EXPECT_EQ(1, watchdog.overrunCount());
+
+    // The engine continues with the next callback
+    QJSValue function = engine.evaluate(QStringLiteral("(function() { return 1 + 1; })"));
+    {
+        const ControllerScriptWatchdog::Callback callback(&watchdog);
+        result = function.call();
+    }
+    EXPECT_EQ(2, result.toInt());
+    EXPECT_EQ(1, watchdog.overrunCount());
+}
+#endif
+
+} // namespace
+
+class ControllerManagerTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        mixxx::Time::setTestMode(true);
+        mixxx::Time::setTestElapsedTime(mixxx::Duration::fromSeconds(1));
+        m_pManager = std::make_unique<ControllerManager>(config());
+    }
+
+    void TearDown() override {
+        m_pManager.reset();
+        mixxx::Time::setTestMode(false);
+    }
+
+    /// Opens the controllers and adds them to the manager, which polls
+    /// them in its own thread
+    void addControllers(const QList<Controller*>& controllers) {
+        ControllerManager* pManager = m_pManager.get();
+        for (Controller* pController : controllers) {
+            pController->open();
+            pController->moveToThread(pManager->thread());
+        }
+        QMetaObject::invokeMethod(
+                pManager,
+                [pManager, &controllers] {
+                    pManager->m_controllers.append(controllers);
+                },
+                Qt::BlockingQueuedConnection);
+    }
+
+    /// Closes the controllers and moves them back to the current thread
+    void removeControllers(const QList<Controller*>& controllers) {
+        ControllerManager* pManager = m_pManager.get();
+        QThread* pThread = QThread::currentThread();
+        QMetaObject::invokeMethod(
+                pManager,
+                [pManager, pThread, &controllers] {
+                    for (Controller* pController : controllers) {
+                        pManager->m_controllers.removeOne(pController);
+                        pController->close();
+                        pController->moveToThread(pThread);
+                    }
+                },
+                Qt::BlockingQueuedConnection);
+    }
+
+    void pollDevices() {
+        ControllerManager* pManager = m_pManager.get();
+        QMetaObject::invokeMethod(
+                pManager,
+                [pManager] {
+                    pManager->pollDevices();
+                },
+                Qt::BlockingQueuedConnection);
+    }
+
+    std::unique_ptr<ControllerManager> m_pManager;
+};
+
+TEST_F(ControllerManagerTest, pollBudget) {
+    QStringList pollLog;
+    SlowFakeMidiController slow(
+            QStringLiteral("Slow"), 3 * ControllerManager::kPollInterval, &pollLog);
+    SlowFakeMidiController fast1(QStringLiteral("Fast 1"), mixxx::Duration(), &pollLog);
+    SlowFakeMidiController fast2(QStringLiteral("Fast 2"), mixxx::Duration(), &pollLog);
+    const QList<Controller*> controllers{&slow, &fast1, &fast2};
+    addControllers(controllers);
+
+    // The slow controller exceeds its budget
+    pollDevices();
+    EXPECT_EQ(QStringList({QStringLiteral("Slow"),
+                      QStringLiteral("Fast 1"),
+                      QStringLiteral("Fast 2")}),
+            pollLog);
+    pollLog.clear();
+
+    // The whole cycle has exceeded the poll interval and the next one is
+    // skipped
+    pollDevices();
+    EXPECT_TRUE(pollLog.isEmpty());
+
+    // The slow controller is skipped for the 3 cycles its poll has taken,
+    // while the controller that is polled first is rotated
+    pollDevices();
+    EXPECT_EQ(QStringList({QStringLiteral("Fast 1"), QStringLiteral("Fast 2")}),
+            pollLog);
+    pollLog.clear();
+    pollDevices();
+    EXPECT_EQ(QStringList({QStringLiteral("Fast 2"), QStringLiteral("Fast 1")}),
+            pollLog);
+    pollLog.clear();
+    pollDevices();
+    EXPECT_EQ(QStringList({QStringLiteral("Fast 1"), QStringLiteral("Fast 2")}),
+            pollLog);
+    pollLog.clear();
+
+    pollDevices();
+    EXPECT_EQ(QStringList({QStringLiteral("Fast 1"),
+                      QStringLiteral("Fast 2"),
+                      QStringLiteral("Slow")}),
+            pollLog);
+
+    removeControllers(controllers);
+}
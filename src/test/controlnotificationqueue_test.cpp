@@ -0,0 +1,103 @@
+#include "control/controlnotificationqueue.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+#include "control/controlobject.h"
+#include "control/controlproxy.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+constexpr int kCallbackCount = 1000;
+
+class ControlNotificationQueueTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        // Discard leftovers of other tests
+        ControlNotificationQueue::dispatch();
+
+        m_pControl = std::make_unique<ControlObject>(ConfigKey("[Test]", "deferred"));
+        m_pControl->setDeferredNotification(true);
+        m_pProxy = std::make_unique<ControlProxy>(m_pControl->getKey());
+        m_pProxy->connectValueChanged(m_pProxy.get(), [this](double value) {
+            ++m_notificationCount;
+            m_lastValue = value;
+        });
+    }
+
+    std::unique_ptr<ControlObject> m_pControl;
+    std::unique_ptr<ControlProxy> m_pProxy;
+    int m_notificationCount = 0;
+    double m_lastValue = 0.0;
+};
+
+TEST_F(ControlNotificationQueueTest, notifyImmediatelyOutsideOfProducerThread) {
+    m_pControl->set(1.0);
+    EXPECT_EQ(1, m_notificationCount);
+    EXPECT_EQ(1.0, m_lastValue);
+    EXPECT_EQ(0, ControlNotificationQueue::dispatch());
+}
+
+TEST_F(ControlNotificationQueueTest, coalesceNotifications) {
+    {
+        const ControlNotificationQueue::ProducerScope scope;
+        m_pControl->set(1.0);
+        m_pControl->set(2.0);
+        m_pControl->set(3.0);
+        // Changes by other senders are not deferred
+        m_pProxy->set(4.0);
+        m_pControl->set(5.0);
+    }
+    EXPECT_EQ(0, m_notificationCount);
+    EXPECT_EQ(5.0, m_pProxy->get());
+
+    EXPECT_EQ(1, ControlNotificationQueue::dispatch());
+    EXPECT_EQ(1, m_notificationCount);
+    EXPECT_EQ(5.0, m_lastValue);
+    EXPECT_EQ(0, ControlNotificationQueue::dispatch());
+}
+
+TEST_F(ControlNotificationQueueTest, skipDestroyedControls) {
+    {
+        const ControlNotificationQueue::ProducerScope scope;
+        m_pControl->set(1.0);
+    }
+    m_pProxy.reset();
+    m_pControl.reset();
+    EXPECT_EQ(0, ControlNotificationQueue::dispatch());
+}
+
+TEST_F(ControlNotificationQueueTest, dispatchConcurrently) {
+    ControlObject otherControl(ConfigKey("[Test]", "deferred2"));
+    otherControl.setDeferredNotification(true);
+
+    const int overflowCount = ControlNotificationQueue::overflowCount();
+    std::atomic<bool> finished = false;
+    std::thread engineThread([&] {
+        const ControlNotificationQueue::ProducerScope scope;
+        for (int i = 0; i < kCallbackCount; ++i) {
+            m_pControl->set(i);
+            otherControl.set(i);
+            std::this_thread::yield();
+        }
+        finished = true;
+    });
+
+    // The main thread dispatches concurrently
+    int dispatchCount = 0;
+    while (!finished) {
+        dispatchCount += ControlNotificationQueue::dispatch();
+        std::this_thread::yield();
+    }
+    engineThread.join();
+    dispatchCount += ControlNotificationQueue::dispatch();
+
+    EXPECT_EQ(overflowCount, ControlNotificationQueue::overflowCount());
+    EXPECT_GE(dispatchCount, 2);
+    EXPECT_EQ(kCallbackCount - 1, m_lastValue);
+}
+
+} // namespace
@@ -0,0 +1,172 @@
+#include "control/controlregistry.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "control/control.h"
+#include "control/controlobject.h"
+#include "control/controlproxy.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+constexpr int kKeyCount = 2000;
+constexpr int kLookupCount = 1000000;
+constexpr int kThreadCount = 4;
+
+ConfigKey makeKey(int index) {
+    return ConfigKey(QStringLiteral("[Channel%1]").arg(index % 8 + 1),
+            QStringLiteral("control_%1").arg(index));
+}
+
+std::vector<std::unique_ptr<ControlObject>> createControls() {
+    std::vector<std::unique_ptr<ControlObject>> controls;
+    controls.reserve(kKeyCount);
+    for (int i = 0; i < kKeyCount; ++i) {
+        controls.push_back(std::make_unique<ControlObject>(makeKey(i)));
+    }
+    return controls;
+}
+
+class ControlRegistryTest : public MixxxTest {
+};
+
+TEST_F(ControlRegistryTest, internedIdsAreStable) {
+    const ConfigKey key("[Test]", "interned");
+    EXPECT_EQ(ControlRegistry::kInvalidId, ControlRegistry::findId(key));
+
+    auto pControl = std::make_unique<ControlObject>(key);
+    const int id = ControlDoublePrivate::getControl(key)->getId();
+    EXPECT_NE(ControlRegistry::kInvalidId, id);
+    EXPECT_EQ(id, ControlRegistry::findId(key));
+    EXPECT_EQ(ControlDoublePrivate::getControl(key), ControlRegistry::lookup(id));
+
+    pControl.reset();
+    EXPECT_EQ(id, ControlRegistry::findId(key));
+    EXPECT_TRUE(ControlRegistry::lookup(id).isNull());
+
+    // The id is reused for a new control with the same key
+    pControl = std::make_unique<ControlObject>(key);
+    EXPECT_EQ(id, ControlDoublePrivate::getControl(key)->getId());
+    EXPECT_EQ(ControlDoublePrivate::getControl(key), ControlRegistry::lookup(id));
+}
+
+TEST_F(ControlRegistryTest, aliases) {
+    const ConfigKey key("[Test]", "original");
+    const ConfigKey alias("[Test]", "alias");
+    ControlObject control(key);
+    ControlDoublePrivate::insertAlias(alias, key);
+
+    EXPECT_EQ(ControlRegistry::findId(key), ControlRegistry::findId(alias));
+    EXPECT_EQ(ControlRegistry::lookup(key), ControlRegistry::lookup(alias));
+
+    // Aliases are not listed separately
+    const auto pControl = ControlRegistry::lookup(key);
+    EXPECT_EQ(1, ControlDoublePrivate::getAllInstances().count(pControl));
+
+    // All aliases are removed with the controls
+    const auto controls = ControlDoublePrivate::takeAllInstances();
+    EXPECT_EQ(1, controls.count(pControl));
+    EXPECT_EQ(ControlRegistry::kInvalidId, ControlRegistry::findId(alias));
+    EXPECT_TRUE(ControlRegistry::lookup(key).isNull());
+}
+
+TEST_F(ControlRegistryTest, concurrentLookups) {
+    const auto controls = createControls();
+
+    std::atomic<int> missingCount = 0;
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < kThreadCount; ++thread) {
+        threads.emplace_back([&missingCount] {
+            for (int i = 0; i < kKeyCount * 10; ++i) {
+                if (!ControlDoublePrivate::getControl(makeKey(i % kKeyCount))) {
+                    missingCount.fetch_add(1);
+                }
+            }
+        });
+    }
+    // Create new controls concurrently
+    for (int i = 0; i < 100; ++i) {
+        ControlObject control(ConfigKey("[Test]", QStringLiteral("new_%1").arg(i)));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(0, missingCount);
+}
+
+/// The controls for the benchmarks, created by the first thread.
+std::vector<std::unique_ptr<ControlObject>> s_benchmarkControls;
+
+void setUpBenchmarkControls(const benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        s_benchmarkControls = createControls();
+    }
+}
+
+void tearDownBenchmarkControls(const benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        s_benchmarkControls.clear();
+    }
+}
+
+static void BM_ControlRegistryLookupByKey(benchmark::State& state) {
+    setUpBenchmarkControls(state);
+    std::vector<ConfigKey> keys;
+    for (int i = 0; i < kKeyCount; ++i) {
+        keys.push_back(makeKey(i));
+    }
+    std::size_t i = state.thread_index();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+                ControlDoublePrivate::getControl(keys[i++ % keys.size()]));
+    }
+    tearDownBenchmarkControls(state);
+}
+BENCHMARK(BM_ControlRegistryLookupByKey)
+        ->Threads(kThreadCount)
+        ->Iterations(kLookupCount / kThreadCount);
+
+static void BM_ControlRegistryLookupById(benchmark::State& state) {
+    setUpBenchmarkControls(state);
+    std::vector<int> ids;
+    for (int i = 0; i < kKeyCount; ++i) {
+        // Might be called before the first thread has created the controls
+        ids.push_back(ControlRegistry::intern(makeKey(i)));
+    }
+    std::size_t i = state.thread_index();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ControlRegistry::lookup(ids[i++ % ids.size()]));
+    }
+    tearDownBenchmarkControls(state);
+}
+BENCHMARK(BM_ControlRegistryLookupById)
+        ->Threads(kThreadCount)
+        ->Iterations(kLookupCount / kThreadCount);
+
+/// Connects a proxy for each control like when loading a skin.
+static void BM_ControlProxySkinLoad(benchmark::State& state) {
+    setUpBenchmarkControls(state);
+    std::vector<ConfigKey> keys;
+    for (int i = 0; i < kKeyCount; ++i) {
+        keys.push_back(makeKey(i));
+    }
+    for (auto _ : state) {
+        std::vector<std::unique_ptr<ControlProxy>> proxies;
+        proxies.reserve(keys.size());
+        for (const auto& key : keys) {
+            proxies.push_back(std::make_unique<ControlProxy>(key));
+        }
+        benchmark::DoNotOptimize(proxies.data());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+    tearDownBenchmarkControls(state);
+}
+BENCHMARK(BM_ControlProxySkinLoad)->Unit(benchmark::kMillisecond);
+
+} // namespace
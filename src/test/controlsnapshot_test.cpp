@@ -0,0 +1,90 @@
+#include "control/controlsnapshot.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <thread>
+
+#include "control/controlobject.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+class ControlSnapshotTest : public MixxxTest {
+  protected:
+    ControlSnapshotTest()
+            : m_control1(ConfigKey("[Test]", "snapshot1")),
+              m_control2(ConfigKey("[Test]", "snapshot2")) {
+    }
+
+    ControlObject m_control1;
+    ControlObject m_control2;
+};
+
+TEST_F(ControlSnapshotTest, readValuesOfLastRefresh) {
+    m_control1.set(1.0);
+    m_control2.set(2.0);
+    ControlSnapshot snapshot({
+            m_control2.getKey(),
+            ConfigKey("[Test]", "missing"),
+            m_control1.getKey(),
+    });
+    ASSERT_EQ(3, snapshot.size());
+
+    std::array<double, 3> values;
+    const quint64 version = snapshot.read(values.data());
+    EXPECT_EQ(2.0, values[0]);
+    EXPECT_EQ(0.0, values[1]);
+    EXPECT_EQ(1.0, values[2]);
+
+    // Values are only updated on refresh
+    m_control1.set(3.0);
+    EXPECT_EQ(version, snapshot.read(values.data()));
+    EXPECT_EQ(1.0, values[2]);
+
+    ControlSnapshot::refreshAll();
+    EXPECT_EQ(version + 1, snapshot.read(values.data()));
+    EXPECT_EQ(3.0, values[2]);
+}
+
+TEST_F(ControlSnapshotTest, refreshIfEngineIdle) {
+    ControlSnapshot snapshot({m_control1.getKey()});
+    ControlSnapshot::refreshAllIfEngineIdle();
+    const quint64 version = snapshot.version();
+
+    // The engine has refreshed since the last invocation
+    ControlSnapshot::refreshAll();
+    ControlSnapshot::refreshAllIfEngineIdle();
+    EXPECT_EQ(version + 1, snapshot.version());
+
+    ControlSnapshot::refreshAllIfEngineIdle();
+    EXPECT_EQ(version + 2, snapshot.version());
+}
+
+TEST_F(ControlSnapshotTest, coherentReadsWhileRefreshing) {
+    ControlSnapshot snapshot({m_control1.getKey(), m_control2.getKey()});
+
+    std::atomic<bool> finished = false;
+    std::thread engineThread([&] {
+        for (int i = 1; i <= 10000; ++i) {
+            m_control1.set(i);
+            m_control2.set(i);
+            ControlSnapshot::refreshAll();
+        }
+        finished = true;
+    });
+
+    int incoherentCount = 0;
+    std::array<double, 2> values;
+    while (!finished) {
+        snapshot.read(values.data());
+        if (values[0] != values[1]) {
+            ++incoherentCount;
+        }
+    }
+    engineThread.join();
+    EXPECT_EQ(0, incoherentCount);
+}
+
+} // namespace
@@ -1,7 +1,9 @@
 #include <gtest/gtest.h>
 #include <QFileInfo>
+#include <QTemporaryDir>
 
 #include "library/coverartcache.h"
+#include "library/coverartthumbnailpack.h"
 #include "library/coverartutils.h"
 #include "library/trackcollection.h"
 #include "test/librarytest.h"
@@ -92,3 +94,60 @@ TEST_F(CoverArtCacheTest, loadCoverFromFileAbsolute) {
             getTestDir().filePath(kCoverLocationTest),
             getTestDir().filePath(kCoverLocationTest));
 }
+
+TEST_F(CoverArtCacheTest, loadCoverFromThumbnailPack) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString packFilePath = tempDir.filePath(QStringLiteral("thumbnails.pack"));
+    CoverArtThumbnailPack::setFilePath(packFilePath);
+
+    EXPECT_EQ(0, CoverArtThumbnailPack::thumbnailWidth(0));
+    EXPECT_EQ(64, CoverArtThumbnailPack::thumbnailWidth(64));
+    EXPECT_EQ(128, CoverArtThumbnailPack::thumbnailWidth(65));
+    EXPECT_EQ(0, CoverArtThumbnailPack::thumbnailWidth(257));
+
+    const QString absoluteCoverLocation = getTestDir().filePath(kCoverLocationTest);
+    CoverInfo info;
+    info.type = CoverInfo::FILE;
+    info.source = CoverInfo::GUESSED;
+    info.coverLocation = absoluteCoverLocation;
+    info.setImage(QImage(absoluteCoverLocation));
+    ASSERT_FALSE(info.imageDigest().isEmpty());
+
+    // The thumbnails are stored after loading the original image
+    const auto metricsBefore = CoverArtThumbnailPack::metrics();
+    auto res = CoverArtCache::loadCover(nullptr, TrackPointer(), info, 100, false);
+    EXPECT_EQ(100, res.coverArt.loadedImage.image.width());
+    auto metrics = CoverArtThumbnailPack::metrics();
+    EXPECT_EQ(metricsBefore.missCount + 1, metrics.missCount);
+    EXPECT_EQ(metricsBefore.storedCount + 1, metrics.storedCount);
+    EXPECT_LT(0, metrics.fileSize);
+
+    // Loaded from the pack without touching the original image
+    info.coverLocation = tempDir.filePath(QStringLiteral("missing.jpg"));
+    res = CoverArtCache::loadCover(nullptr, TrackPointer(), info, 100, false);
+    EXPECT_EQ(CoverInfo::LoadedImage::Result::Ok, res.coverArt.loadedImage.result);
+    EXPECT_EQ(100, res.coverArt.loadedImage.image.width());
+    EXPECT_EQ(metrics.hitCount + 1, CoverArtThumbnailPack::metrics().hitCount);
+
+    // Full size covers are never loaded from the pack
+    res = CoverArtCache::loadCover(nullptr, TrackPointer(), info, 0, false);
+    EXPECT_NE(CoverInfo::LoadedImage::Result::Ok, res.coverArt.loadedImage.result);
+
+    // Thumbnails are restored when reopening the pack file
+    CoverArtThumbnailPack::setFilePath(packFilePath);
+    EXPECT_EQ(48, CoverArtThumbnailPack::load(info.cacheKey(), 48).width());
+    EXPECT_EQ(256, CoverArtThumbnailPack::load(info.cacheKey(), 256).width());
+
+    // A truncated record is discarded, the 64 px thumbnail is stored last
+    CoverArtThumbnailPack::setFilePath(QString());
+    {
+        QFile packFile(packFilePath);
+        ASSERT_TRUE(packFile.resize(packFile.size() - 1));
+    }
+    CoverArtThumbnailPack::setFilePath(packFilePath);
+    EXPECT_TRUE(CoverArtThumbnailPack::load(info.cacheKey(), 64).isNull());
+    EXPECT_FALSE(CoverArtThumbnailPack::load(info.cacheKey(), 128).isNull());
+
+    CoverArtThumbnailPack::setFilePath(QString());
+}
@@ -0,0 +1,243 @@
+// Built as a separate test executable, because it replaces the global
+// allocation functions for counting the allocations on the engine thread.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "control/controlnotificationqueue.h"
+#include "control/controlproxy.h"
+#include "test/signalpathtest.h"
+
+namespace {
+
+// Allocations are only counted on the thread that has enabled counting
+thread_local bool s_countAllocations = false;
+thread_local int s_allocationCount = 0;
+// The sizes of the first allocations, for reporting them on failure
+constexpr int kMaxRecordedAllocations = 16;
+thread_local std::size_t s_allocationSizes[kMaxRecordedAllocations];
+
+class ScopedAllocationCounter final {
+  public:
+    ScopedAllocationCounter() {
+        s_allocationCount = 0;
+        s_countAllocations = true;
+    }
+    ~ScopedAllocationCounter() {
+        s_countAllocations = false;
+    }
+
+    /// The sizes of the allocations of the last counting scope
+    static std::vector<std::size_t> sizes() {
+        return std::vector<std::size_t>(s_allocationSizes,
+                s_allocationSizes + std::min(s_allocationCount, kMaxRecordedAllocations));
+    }
+};
+
+void countAllocation(std::size_t size) noexcept {
+    if (!s_countAllocations) {
+        return;
+    }
+    if (s_allocationCount < kMaxRecordedAllocations) {
+        s_allocationSizes[s_allocationCount] = size;
+    }
+    ++s_allocationCount;
+}
+
+void* allocate(std::size_t size) noexcept {
+    countAllocation(size);
+    return std::malloc(size > 0 ? size : 1);
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment) noexcept {
+    countAllocation(size);
+    const auto alignmentBytes = static_cast<std::size_t>(alignment);
+    // Rounded up to a multiple of the alignment
+    const std::size_t alignedSize =
+            std::max((size + alignmentBytes - 1) / alignmentBytes, std::size_t{1}) *
+            alignmentBytes;
+#ifdef _WIN32
+    return _aligned_malloc(alignedSize, alignmentBytes);
+#else
+    return std::aligned_alloc(alignmentBytes, alignedSize);
+#endif
+}
+
+void deallocateAligned(void* p) noexcept {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+} // namespace
+
+// All replaceable allocation functions are replaced, otherwise allocations
+// through the nothrow or aligned variants would not be counted.
+
+void* operator new(std::size_t size) {
+    void* p = allocate(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    void* p = allocateAligned(size, alignment);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    deallocateAligned(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    deallocateAligned(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    deallocateAligned(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+    deallocateAligned(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    deallocateAligned(p);
+}
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    deallocateAligned(p);
+}
+
+namespace {
+
+constexpr int kWarmUpCallbackCount = 10;
+constexpr int kCallbackCount = 200;
+
+class EngineAllocationTest : public BaseSignalPathTest {
+  protected:
+    /// Runs the audio callbacks on a separate engine thread like
+    /// SoundManager does, while the main thread dispatches the deferred
+    /// notifications concurrently. Returns the sizes of the allocations on
+    /// the engine thread after warming up, at most kMaxRecordedAllocations.
+    std::vector<std::size_t> processOnEngineThread() {
+        std::atomic<bool> finished = false;
+        std::vector<std::size_t> allocationSizes;
+        std::thread engineThread([&] {
+            for (int i = 0; i < kWarmUpCallbackCount; ++i) {
+                m_pEngineMaster->process(kProcessBufferSize);
+            }
+            {
+                const ScopedAllocationCounter counter;
+                for (int i = 0; i < kCallbackCount; ++i) {
+                    m_pEngineMaster->process(kProcessBufferSize);
+                    std::this_thread::yield();
+                }
+            }
+            allocationSizes = ScopedAllocationCounter::sizes();
+            finished = true;
+        });
+        while (!finished) {
+            ControlNotificationQueue::dispatch();
+            std::this_thread::yield();
+        }
+        engineThread.join();
+        ControlNotificationQueue::dispatch();
+        return allocationSizes;
+    }
+};
+
+TEST_F(EngineAllocationTest, deferredNotificationsDontAllocate) {
+    const int overflowCount = ControlNotificationQueue::overflowCount();
+    // After warming up, the callbacks of the engine without any tracks
+    // don't allocate. Allocations are reported with their sizes.
+    EXPECT_EQ(std::vector<std::size_t>{}, processOnEngineThread());
+
+    // Listeners on the main thread, e.g. widgets, would receive queued
+    // signals that allocate an event for every change
+    const ConfigKey keys[] = {
+            ConfigKey(m_sMasterGroup, QStringLiteral("VuMeter")),
+            ConfigKey(m_sMasterGroup, QStringLiteral("VuMeterL")),
+            ConfigKey(m_sMasterGroup, QStringLiteral("VuMeterR")),
+            ConfigKey(m_sMasterGroup, QStringLiteral("PeakIndicator")),
+            ConfigKey(m_sGroup1, QStringLiteral("playposition")),
+            ConfigKey(m_sInternalClockGroup, QStringLiteral("beat_distance")),
+    };
+    int notificationCount = 0;
+    std::vector<std::unique_ptr<ControlProxy>> listeners;
+    for (const auto& key : keys) {
+        listeners.push_back(std::make_unique<ControlProxy>(key));
+        listeners.back()->connectValueChanged(listeners.back().get(),
+                [&notificationCount](double) {
+                    ++notificationCount;
+                });
+    }
+
+    EXPECT_EQ(std::vector<std::size_t>{}, processOnEngineThread());
+    EXPECT_LT(0, notificationCount);
+    EXPECT_EQ(overflowCount, ControlNotificationQueue::overflowCount());
+}
+
+} // namespace
@@ -0,0 +1,155 @@
+#include "engine/effects/engineeffectslatencycompensator.h"
+
+#include <gtest/gtest.h>
+
+#include "engine/effects/engineeffectsdelay.h"
+#include "engine/engine.h"
+#include "test/mixxxtest.h"
+#include "util/sample.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr SINT kBufferFrames = 256;
+constexpr SINT kBufferSamples = kBufferFrames * mixxx::kEngineChannelCount;
+
+class EngineEffectsLatencyCompensatorTest : public MixxxTest {
+  protected:
+    EngineEffectsLatencyCompensatorTest()
+            : m_main(m_factory.getOrCreateHandle("[Master]")),
+              m_headphones(m_factory.getOrCreateHandle("[Headphone]")),
+              m_deck1(m_factory.getOrCreateHandle("[Channel1]")),
+              m_deck2(m_factory.getOrCreateHandle("[Channel2]")),
+              m_source(kBufferSamples),
+              m_frame(0) {
+    }
+
+    // Fills m_source with the next buffer of a signal without repetitions
+    void nextSourceBuffer() {
+        for (SINT i = 0; i < kBufferFrames; ++i) {
+            const auto value = static_cast<CSAMPLE>(m_frame++ % 9973) / 9973;
+            m_source[i * mixxx::kEngineChannelCount] = value;
+            m_source[i * mixxx::kEngineChannelCount + 1] = -value;
+        }
+    }
+
+    ChannelHandleFactory m_factory;
+    const ChannelHandle m_main;
+    const ChannelHandle m_headphones;
+    const ChannelHandle m_deck1;
+    const ChannelHandle m_deck2;
+    EngineEffectsLatencyCompensator m_compensator;
+    mixxx::SampleBuffer m_source;
+    SINT m_frame;
+};
+
+TEST_F(EngineEffectsLatencyCompensatorTest, WithoutLatencyNothingIsDelayed) {
+    mixxx::SampleBuffer deck1(kBufferSamples);
+    mixxx::SampleBuffer deck2(kBufferSamples);
+    for (int callback = 0; callback < 4; ++callback) {
+        m_compensator.onCallbackStart();
+        nextSourceBuffer();
+        SampleUtil::copy(deck1.data(), m_source.data(), kBufferSamples);
+        SampleUtil::copy(deck2.data(), m_source.data(), kBufferSamples);
+        EXPECT_FALSE(m_compensator.isDelaying(m_deck1, m_main, 0));
+        m_compensator.process(m_deck1, m_main, 0, deck1.data(), kBufferSamples);
+        m_compensator.process(m_deck2, m_main, 0, deck2.data(), kBufferSamples);
+        for (SINT i = 0; i < kBufferSamples; ++i) {
+            ASSERT_EQ(m_source[i], deck1[i]);
+            ASSERT_EQ(m_source[i], deck2[i]);
+        }
+    }
+    EXPECT_EQ(0, m_compensator.getOutputLatencyFrames(m_main));
+}
+
+TEST_F(EngineEffectsLatencyCompensatorTest, ChannelsAreSampleAligned) {
+    // An odd latency that is not a multiple of the buffer size
+    constexpr SINT kLatencyFrames = 321;
+    // Simulates a latent effect on deck 1
+    EngineEffectsDelay effect;
+    effect.setDelayFrames(kLatencyFrames);
+
+    mixxx::SampleBuffer deck1(kBufferSamples);
+    mixxx::SampleBuffer deck2(kBufferSamples);
+    // The first callback plans the latency, the second callback crossfades
+    // to the planned delay and the third callback still needs the history
+    // from before the delay line of deck 2 was acquired.
+    for (int callback = 0; callback < 8; ++callback) {
+        SCOPED_TRACE(callback);
+        m_compensator.onCallbackStart();
+        nextSourceBuffer();
+        SampleUtil::copy(deck1.data(), m_source.data(), kBufferSamples);
+        SampleUtil::copy(deck2.data(), m_source.data(), kBufferSamples);
+        effect.process(deck1.data(), kBufferSamples);
+
+        m_compensator.process(m_deck1, m_main, kLatencyFrames, deck1.data(), kBufferSamples);
+        m_compensator.process(m_deck2, m_main, 0, deck2.data(), kBufferSamples);
+        if (callback < 3) {
+            continue;
+        }
+        EXPECT_EQ(kLatencyFrames, m_compensator.getOutputLatencyFrames(m_main));
+        for (SINT i = 0; i < kBufferSamples; ++i) {
+            ASSERT_EQ(deck1[i], deck2[i]) << "sample " << i;
+        }
+    }
+}
+
+TEST_F(EngineEffectsLatencyCompensatorTest, LatencyIsPlannedPerOutput) {
+    constexpr SINT kLatencyFrames = 100;
+    mixxx::SampleBuffer deck1(kBufferSamples);
+    mixxx::SampleBuffer deck2(kBufferSamples);
+    for (int callback = 0; callback < 4; ++callback) {
+        m_compensator.onCallbackStart();
+        nextSourceBuffer();
+        SampleUtil::copy(deck1.data(), m_source.data(), kBufferSamples);
+        SampleUtil::copy(deck2.data(), m_source.data(), kBufferSamples);
+        // Only the main mix contains a latent channel
+        m_compensator.process(m_deck1, m_main, kLatencyFrames, deck1.data(), kBufferSamples);
+        m_compensator.process(m_deck2, m_headphones, 0, deck2.data(), kBufferSamples);
+        for (SINT i = 0; i < kBufferSamples; ++i) {
+            ASSERT_EQ(m_source[i], deck2[i]);
+        }
+    }
+    EXPECT_EQ(kLatencyFrames, m_compensator.getOutputLatencyFrames(m_main));
+    EXPECT_EQ(0, m_compensator.getOutputLatencyFrames(m_headphones));
+}
+
+TEST_F(EngineEffectsLatencyCompensatorTest, LatencyDropIsFollowed) {
+    constexpr SINT kLatencyFrames = 500;
+    EngineEffectsDelay effect;
+    effect.setDelayFrames(kLatencyFrames);
+
+    mixxx::SampleBuffer deck1(kBufferSamples);
+    mixxx::SampleBuffer deck2(kBufferSamples);
+    for (int callback = 0; callback < 10; ++callback) {
+        SCOPED_TRACE(callback);
+        m_compensator.onCallbackStart();
+        nextSourceBuffer();
+        SampleUtil::copy(deck1.data(), m_source.data(), kBufferSamples);
+        SampleUtil::copy(deck2.data(), m_source.data(), kBufferSamples);
+        // The latent effect on deck 1 is disabled after 4 callbacks
+        const SINT latencyFrames = callback < 4 ? kLatencyFrames : 0;
+        effect.setDelayFrames(latencyFrames);
+        effect.process(deck1.data(), kBufferSamples);
+
+        m_compensator.process(m_deck1, m_main, latencyFrames, deck1.data(), kBufferSamples);
+        m_compensator.process(m_deck2, m_main, 0, deck2.data(), kBufferSamples);
+        if (callback == 4) {
+            // Deck 1 is delayed by the old latency until the plan is updated
+            EXPECT_TRUE(m_compensator.isDelaying(m_deck1, m_main, 0));
+        }
+        if (callback < 3 || callback == 4 || callback == 5) {
+            // The delays are crossfaded
+            continue;
+        }
+        for (SINT i = 0; i < kBufferSamples; ++i) {
+            ASSERT_FLOAT_EQ(deck1[i], deck2[i]) << "sample " << i;
+        }
+    }
+    EXPECT_EQ(0, m_compensator.getOutputLatencyFrames(m_main));
+    // The delay lines are released
+    EXPECT_FALSE(m_compensator.isDelaying(m_deck1, m_main, 0));
+    EXPECT_FALSE(m_compensator.isDelaying(m_deck2, m_main, 0));
+}
+
+} // namespace
@@ -0,0 +1,186 @@
+#include "engine/effects/engineeffectsmanager.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "effects/backends/builtin/echoeffect.h"
+#include "effects/backends/builtin/flangereffect.h"
+#include "effects/backends/builtin/phasereffect.h"
+#include "engine/engine.h"
+#include "test/mixxxtest.h"
+#include "test/testengineeffectchains.h"
+#include "util/sample.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr int kNumDecks = 4;
+constexpr unsigned int kSampleRate = 44100;
+constexpr SINT kBufferSamples = 256 * mixxx::kEngineChannelCount;
+
+/// Processes the same postfader chains with two EngineEffectsManagers, one of
+/// them with helper threads.
+class EngineEffectsManagerParallelTest : public MixxxTest {
+  protected:
+    EngineEffectsManagerParallelTest()
+            : m_pBackendManager(new EffectsBackendManager()),
+              m_main(m_factory.getOrCreateHandle("[Master]"), "[Master]") {
+        QSet<ChannelHandleAndGroup> inputChannels;
+        for (int i = 0; i < kNumDecks; ++i) {
+            const QString group = QStringLiteral("[Channel%1]").arg(i + 1);
+            m_decks.emplace_back(m_factory.getOrCreateHandle(group), group);
+            inputChannels.insert(m_decks.back());
+            m_inputs.emplace_back(kBufferSamples);
+            m_features.emplace_back();
+        }
+
+        m_pSerialManager = makeManager();
+        m_pParallelManager = makeManager();
+        m_pParallelManager->setParallelProcessingThreads(2);
+        for (auto* pManager : {m_pSerialManager.get(), m_pParallelManager.get()}) {
+            auto pChains = std::make_unique<TestEngineEffectChains>(
+                    pManager,
+                    m_pBackendManager,
+                    inputChannels,
+                    QSet<ChannelHandleAndGroup>{m_main});
+            // Deck 1 and 2 share a chain, i.e. are processed by the same thread
+            pChains->addChain({EchoEffect::getId()},
+                    {m_decks[0].handle(), m_decks[1].handle()},
+                    0.5);
+            pChains->addChain({FlangerEffect::getId()}, {m_decks[2].handle()});
+            pChains->addChain({PhaserEffect::getId(), EchoEffect::getId()},
+                    {m_decks[3].handle()});
+            m_chains.push_back(std::move(pChains));
+        }
+    }
+
+    ~EngineEffectsManagerParallelTest() override {
+        // Remove the chains before the managers are deleted
+        m_chains.clear();
+    }
+
+    std::unique_ptr<EngineEffectsManager> makeManager() {
+        auto pipes = TwoWayMessagePipe<EffectsRequest*, EffectsResponse>::makeTwoWayMessagePipe(
+                8, 8);
+        m_requestPipes.push_back(std::move(pipes.first));
+        return std::make_unique<EngineEffectsManager>(std::move(pipes.second));
+    }
+
+    // Fills the inputs of the decks with different signals
+    void nextInputs(int callback) {
+        for (int deck = 0; deck < kNumDecks; ++deck) {
+            for (SINT i = 0; i < kBufferSamples; ++i) {
+                const SINT frame = callback * kBufferSamples + i;
+                m_inputs[deck][i] = static_cast<CSAMPLE>((frame * (deck + 3)) % 1009) / 1009 -
+                        0.5f;
+            }
+        }
+    }
+
+    /// Mixes the decks like ChannelMixer does with both managers and
+    /// expects bit-identical results.
+    void expectParallelMatchesSerial(bool inPlace) {
+        std::vector<mixxx::SampleBuffer> serialBuffers;
+        std::vector<mixxx::SampleBuffer> parallelBuffers;
+        for (int deck = 0; deck < kNumDecks; ++deck) {
+            serialBuffers.emplace_back(kBufferSamples);
+            parallelBuffers.emplace_back(kBufferSamples);
+        }
+        mixxx::SampleBuffer serialOut(kBufferSamples);
+        mixxx::SampleBuffer parallelOut(kBufferSamples);
+
+        for (int callback = 0; callback < 16; ++callback) {
+            SCOPED_TRACE(callback);
+            nextInputs(callback);
+            std::array<EngineEffectsManager::PostFaderChannel, kNumDecks> channels;
+            for (int deck = 0; deck < kNumDecks; ++deck) {
+                SampleUtil::copy(serialBuffers[deck].data(),
+                        m_inputs[deck].data(),
+                        kBufferSamples);
+                SampleUtil::copy(parallelBuffers[deck].data(),
+                        m_inputs[deck].data(),
+                        kBufferSamples);
+                // A ramping gain on one of the decks
+                const CSAMPLE_GAIN oldGain = deck == 1 && callback % 2 ? 0.5f : 1.0f;
+                const CSAMPLE_GAIN newGain = deck == 1 && callback % 2 ? 0.8f : 1.0f;
+                channels[deck] = EngineEffectsManager::PostFaderChannel{
+                        m_decks[deck].handle(),
+                        parallelBuffers[deck].data(),
+                        &m_features[deck],
+                        oldGain,
+                        newGain,
+                        false};
+            }
+
+            m_pSerialManager->onCallbackStart();
+            SampleUtil::clear(serialOut.data(), kBufferSamples);
+            for (int deck = 0; deck < kNumDecks; ++deck) {
+                const auto& channel = channels[deck];
+                if (inPlace) {
+                    m_pSerialManager->processPostFaderChannelInPlace(channel.inputHandle,
+                            m_main.handle(),
+                            serialBuffers[deck].data(),
+                            kBufferSamples,
+                            kSampleRate,
+                            *channel.pGroupFeatures,
+                            channel.oldGain,
+                            channel.newGain,
+                            channel.fadeout);
+                    SampleUtil::add(serialOut.data(),
+                            serialBuffers[deck].data(),
+                            kBufferSamples);
+                } else {
+                    m_pSerialManager->processPostFaderAndMix(channel.inputHandle,
+                            m_main.handle(),
+                            serialBuffers[deck].data(),
+                            serialOut.data(),
+                            kBufferSamples,
+                            kSampleRate,
+                            *channel.pGroupFeatures,
+                            channel.oldGain,
+                            channel.newGain,
+                            channel.fadeout);
+                }
+            }
+
+            m_pParallelManager->onCallbackStart();
+            SampleUtil::clear(parallelOut.data(), kBufferSamples);
+            ASSERT_TRUE(m_pParallelManager->processPostFaderChannelsInParallel(
+                    m_main.handle(),
+                    channels.data(),
+                    kNumDecks,
+                    parallelOut.data(),
+                    inPlace,
+                    kBufferSamples,
+                    kSampleRate));
+
+            for (SINT i = 0; i < kBufferSamples; ++i) {
+                ASSERT_EQ(serialOut[i], parallelOut[i]) << "sample " << i;
+            }
+        }
+    }
+
+    ChannelHandleFactory m_factory;
+    EffectsBackendManagerPointer m_pBackendManager;
+    const ChannelHandleAndGroup m_main;
+    std::vector<ChannelHandleAndGroup> m_decks;
+    std::vector<mixxx::SampleBuffer> m_inputs;
+    std::vector<GroupFeatureState> m_features;
+    std::vector<std::unique_ptr<EffectsRequestPipe>> m_requestPipes;
+    std::unique_ptr<EngineEffectsManager> m_pSerialManager;
+    std::unique_ptr<EngineEffectsManager> m_pParallelManager;
+    std::vector<std::unique_ptr<TestEngineEffectChains>> m_chains;
+};
+
+TEST_F(EngineEffectsManagerParallelTest, MixIsBitIdenticalToSerialProcessing) {
+    expectParallelMatchesSerial(false);
+}
+
+TEST_F(EngineEffectsManagerParallelTest, InPlaceIsBitIdenticalToSerialProcessing) {
+    expectParallelMatchesSerial(true);
+}
+
+} // namespace
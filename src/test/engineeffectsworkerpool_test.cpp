@@ -0,0 +1,81 @@
+#include "engine/effects/engineeffectsworkerpool.h"
+
+#include <gtest/gtest.h>
+
+#include <QThread>
+#include <array>
+#include <atomic>
+
+#include "test/mixxxtest.h"
+
+namespace {
+
+constexpr int kMaxSlots = 8;
+
+class CountingTask : public EngineEffectsWorkerTask {
+  public:
+    CountingTask() {
+        for (auto& count : m_runCount) {
+            count.store(0);
+        }
+        m_threads.fill(nullptr);
+    }
+
+    void run(int slot) override {
+        ASSERT_GE(slot, 0);
+        ASSERT_LT(slot, kMaxSlots);
+        m_threads[slot] = QThread::currentThread();
+        m_runCount[slot].fetch_add(1);
+    }
+
+    std::array<std::atomic<int>, kMaxSlots> m_runCount;
+    std::array<QThread*, kMaxSlots> m_threads;
+};
+
+class EngineEffectsWorkerPoolTest : public MixxxTest {
+};
+
+TEST_F(EngineEffectsWorkerPoolTest, NoHelperThreads) {
+    EngineEffectsWorkerPool pool(0);
+    EXPECT_EQ(1, pool.numSlots());
+
+    CountingTask task;
+    pool.run(&task, 1);
+    EXPECT_EQ(1, task.m_runCount[0].load());
+    EXPECT_EQ(QThread::currentThread(), task.m_threads[0]);
+}
+
+TEST_F(EngineEffectsWorkerPoolTest, EachSlotRunsOncePerCall) {
+    EngineEffectsWorkerPool pool(3);
+    ASSERT_EQ(4, pool.numSlots());
+
+    CountingTask task;
+    constexpr int kNumCalls = 100;
+    for (int i = 0; i < kNumCalls; ++i) {
+        pool.run(&task, pool.numSlots());
+        // All slots must have been joined when run() returns
+        for (int slot = 0; slot < pool.numSlots(); ++slot) {
+            EXPECT_EQ(i + 1, task.m_runCount[slot].load());
+        }
+    }
+    EXPECT_EQ(0, task.m_runCount[4].load());
+
+    // Slot 0 is processed by the calling thread, the others by the helpers
+    EXPECT_EQ(QThread::currentThread(), task.m_threads[0]);
+    for (int slot = 1; slot < pool.numSlots(); ++slot) {
+        EXPECT_NE(QThread::currentThread(), task.m_threads[slot]);
+    }
+}
+
+TEST_F(EngineEffectsWorkerPoolTest, FewerSlotsThanThreads) {
+    EngineEffectsWorkerPool pool(3);
+
+    CountingTask task;
+    pool.run(&task, 2);
+    EXPECT_EQ(1, task.m_runCount[0].load());
+    EXPECT_EQ(1, task.m_runCount[1].load());
+    EXPECT_EQ(0, task.m_runCount[2].load());
+    EXPECT_EQ(0, task.m_runCount[3].load());
+}
+
+} // namespace
@@ -0,0 +1,190 @@
+#include "engine/filters/enginefilteroversampler.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "engine/engine.h"
+#include "util/math.h"
+#include "util/sample.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr SINT kNumFrames = 1024;
+constexpr SINT kNumSamples = kNumFrames * mixxx::kEngineChannelCount;
+constexpr double kSampleRate = 44100;
+
+constexpr int kFactors[] = {2, 4, 8};
+
+void noopProcessor(CSAMPLE*, SINT) {
+}
+
+class EngineFilterOversamplerTest : public testing::Test {
+  protected:
+    // Fills both channels with a sine wave, the right channel inverted
+    static void fillSine(CSAMPLE* pBuffer, double frequency, SINT numFrames) {
+        for (SINT frame = 0; frame < numFrames; ++frame) {
+            const auto value = static_cast<CSAMPLE>(
+                    0.5 * std::sin(2 * M_PI * frequency * frame / kSampleRate));
+            pBuffer[frame * 2] = value;
+            pBuffer[frame * 2 + 1] = -value;
+        }
+    }
+};
+
+TEST_F(EngineFilterOversamplerTest, FactorOneIsBypass) {
+    EngineFilterOversampler oversampler;
+    oversampler.setFactor(1);
+    EXPECT_EQ(0, oversampler.getLatencyFrames());
+
+    mixxx::SampleBuffer input(kNumSamples);
+    mixxx::SampleBuffer output(kNumSamples);
+    fillSine(input.data(), 1000, kNumFrames);
+
+    SINT processedSamples = 0;
+    oversampler.process(input.data(),
+            output.data(),
+            kNumSamples,
+            [&processedSamples](CSAMPLE*, SINT numSamples) {
+                processedSamples += numSamples;
+            });
+    EXPECT_EQ(kNumSamples, processedSamples);
+    for (SINT i = 0; i < kNumSamples; ++i) {
+        EXPECT_EQ(input[i], output[i]);
+    }
+}
+
+TEST_F(EngineFilterOversamplerTest, ProcessorSeesOversampledBuffer) {
+    for (int factor : kFactors) {
+        SCOPED_TRACE(factor);
+        EngineFilterOversampler oversampler;
+        oversampler.setFactor(factor);
+
+        mixxx::SampleBuffer buffer(kNumSamples);
+        buffer.fill(0);
+
+        SINT processedSamples = 0;
+        oversampler.process(buffer.data(),
+                buffer.data(),
+                kNumSamples,
+                [&processedSamples](CSAMPLE*, SINT numSamples) {
+                    processedSamples += numSamples;
+                });
+        EXPECT_EQ(kNumSamples * factor, processedSamples);
+    }
+}
+
+TEST_F(EngineFilterOversamplerTest, ImpulseIsDelayedByLatency) {
+    for (int factor : kFactors) {
+        SCOPED_TRACE(factor);
+        EngineFilterOversampler oversampler;
+        oversampler.setFactor(factor);
+        const SINT latency = oversampler.getLatencyFrames();
+        EXPECT_EQ(EngineFilterOversampler::latencyFramesForFactor(factor), latency);
+        EXPECT_GT(latency, 0);
+        EXPECT_LT(latency, kNumFrames);
+
+        mixxx::SampleBuffer buffer(kNumSamples);
+        buffer.fill(0);
+        buffer[0] = 1;
+        buffer[1] = -1;
+        oversampler.process(buffer.data(), buffer.data(), kNumSamples, noopProcessor);
+
+        SINT peakFrame = 0;
+        for (SINT frame = 0; frame < kNumFrames; ++frame) {
+            if (std::abs(buffer[frame * 2]) > std::abs(buffer[peakFrame * 2])) {
+                peakFrame = frame;
+            }
+            // The channels are processed independently
+            EXPECT_FLOAT_EQ(buffer[frame * 2], -buffer[frame * 2 + 1]);
+        }
+        EXPECT_EQ(latency, peakFrame);
+        // The band limited impulse spreads a little energy to its neighbors
+        EXPECT_GT(buffer[peakFrame * 2], 0.9f);
+    }
+}
+
+TEST_F(EngineFilterOversamplerTest, PassbandIsTransparent) {
+    for (int factor : kFactors) {
+        SCOPED_TRACE(factor);
+        EngineFilterOversampler oversampler;
+        oversampler.setFactor(factor);
+        const SINT latency = oversampler.getLatencyFrames();
+
+        for (double frequency : {100.0, 1000.0, 10000.0}) {
+            oversampler.reset();
+            mixxx::SampleBuffer input(kNumSamples);
+            mixxx::SampleBuffer output(kNumSamples);
+            fillSine(input.data(), frequency, kNumFrames);
+            oversampler.process(input.data(), output.data(), kNumSamples, noopProcessor);
+
+            // Skip the settling time of the filters
+            for (SINT frame = 2 * latency; frame < kNumFrames; ++frame) {
+                EXPECT_NEAR(input[(frame - latency) * 2], output[frame * 2], 1e-3)
+                        << "frequency " << frequency << " frame " << frame;
+            }
+        }
+    }
+}
+
+TEST_F(EngineFilterOversamplerTest, TransitionBandIsNotAmplified) {
+    for (int factor : kFactors) {
+        SCOPED_TRACE(factor);
+        EngineFilterOversampler oversampler;
+        oversampler.setFactor(factor);
+
+        mixxx::SampleBuffer input(kNumSamples);
+        mixxx::SampleBuffer output(kNumSamples);
+        fillSine(input.data(), 20000, kNumFrames);
+        oversampler.process(input.data(), output.data(), kNumSamples, noopProcessor);
+
+        const SINT settledOffset = 2 * oversampler.getLatencyFrames() *
+                mixxx::kEngineChannelCount;
+        EXPECT_LE(SampleUtil::maxAbsAmplitude(output.data() + settledOffset,
+                          kNumSamples - settledOffset),
+                0.5f);
+    }
+}
+
+TEST_F(EngineFilterOversamplerTest, OutputIsIndependentOfBufferSize) {
+    for (int factor : kFactors) {
+        SCOPED_TRACE(factor);
+        EngineFilterOversampler oneBuffer;
+        EngineFilterOversampler oddBuffers;
+        oneBuffer.setFactor(factor);
+        oddBuffers.setFactor(factor);
+
+        mixxx::SampleBuffer input(kNumSamples);
+        mixxx::SampleBuffer expected(kNumSamples);
+        mixxx::SampleBuffer actual(kNumSamples);
+        fillSine(input.data(), 440, kNumFrames);
+
+        const auto clip = [](CSAMPLE* pSamples, SINT numSamples) {
+            for (SINT i = 0; i < numSamples; ++i) {
+                pSamples[i] = CSAMPLE_clamp(pSamples[i] * 4);
+            }
+        };
+        oneBuffer.process(input.data(), expected.data(), kNumSamples, clip);
+
+        // Buffer sizes that are not multiples of the internal block size
+        SINT offset = 0;
+        for (SINT frames : {1, 37, 128, 200, 3}) {
+            oddBuffers.process(input.data() + offset,
+                    actual.data() + offset,
+                    frames * mixxx::kEngineChannelCount,
+                    clip);
+            offset += frames * mixxx::kEngineChannelCount;
+        }
+        oddBuffers.process(input.data() + offset,
+                actual.data() + offset,
+                kNumSamples - offset,
+                clip);
+
+        for (SINT i = 0; i < kNumSamples; ++i) {
+            EXPECT_FLOAT_EQ(expected[i], actual[i]) << "sample " << i;
+        }
+    }
+}
+
+} // namespace
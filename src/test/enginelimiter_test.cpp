@@ -0,0 +1,227 @@
+#include "engine/enginelimiter.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "control/controlobject.h"
+#include "engine/engine.h"
+#include "engine/enginebuslimiter.h"
+#include "test/mixxxtest.h"
+#include "util/math.h"
+#include "util/sample.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr SINT kNumFrames = 8192;
+constexpr SINT kNumSamples = kNumFrames * mixxx::kEngineChannelCount;
+constexpr mixxx::audio::SampleRate kSampleRate(48000);
+
+class EngineLimiterTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        m_limiter.setSampleRate(kSampleRate);
+    }
+
+    static void fillSine(CSAMPLE* pBuffer,
+            SINT numFrames,
+            double frequency,
+            double amplitude,
+            double phase = 0) {
+        for (SINT frame = 0; frame < numFrames; ++frame) {
+            const auto value = static_cast<CSAMPLE>(amplitude *
+                    std::sin(2 * M_PI * frequency * frame / kSampleRate.toDouble() +
+                            phase));
+            pBuffer[frame * 2] = value;
+            pBuffer[frame * 2 + 1] = value;
+        }
+    }
+
+    EngineLimiter m_limiter;
+};
+
+TEST_F(EngineLimiterTest, BelowCeilingIsTransparent) {
+    m_limiter.setCeiling(1.0f);
+    const SINT latency = m_limiter.getLatencyFrames();
+    EXPECT_GT(latency, EngineLimiter::kDetectorDelayFrames);
+
+    mixxx::SampleBuffer input(kNumSamples);
+    fillSine(input.data(), kNumFrames, 1000, 0.5);
+    mixxx::SampleBuffer output(kNumSamples);
+    SampleUtil::copy(output.data(), input.data(), kNumSamples);
+    m_limiter.process(output.data(), kNumSamples);
+
+    EXPECT_EQ(CSAMPLE_GAIN_ONE, m_limiter.getMinimumGain());
+    for (SINT i = 0; i < latency * 2; ++i) {
+        EXPECT_EQ(CSAMPLE_ZERO, output[i]);
+    }
+    for (SINT i = latency * 2; i < kNumSamples; ++i) {
+        EXPECT_EQ(input[i - latency * 2], output[i]);
+    }
+}
+
+TEST_F(EngineLimiterTest, OutputNeverExceedsCeiling) {
+    constexpr CSAMPLE_GAIN kCeiling = 0.5f;
+    m_limiter.setCeiling(kCeiling);
+
+    mixxx::SampleBuffer buffer(kNumSamples);
+    fillSine(buffer.data(), kNumFrames, 440, 0.4);
+    // Add some single frame spikes
+    for (SINT frame = 1000; frame < kNumFrames; frame += 1777) {
+        buffer[frame * 2] = 4.0f;
+        buffer[frame * 2 + 1] = -3.0f;
+    }
+    m_limiter.process(buffer.data(), kNumSamples);
+
+    EXPECT_LT(m_limiter.getMinimumGain(), 0.2f);
+    EXPECT_LE(SampleUtil::maxAbsAmplitude(buffer.data(), kNumSamples),
+            kCeiling * 1.0001f);
+}
+
+TEST_F(EngineLimiterTest, InterSamplePeaksAreLimited) {
+    // A sine at a quarter of the sample rate with a phase offset of 45°
+    // never hits its peaks at the sample positions. All samples are at
+    // +-0.707 of the amplitude, so a sample peak limiter would not react.
+    constexpr double kAmplitude = 1.0;
+    constexpr CSAMPLE_GAIN kCeiling = 0.9f;
+    m_limiter.setCeiling(kCeiling);
+
+    mixxx::SampleBuffer buffer(kNumSamples);
+    fillSine(buffer.data(), kNumFrames, kSampleRate.toDouble() / 4, kAmplitude, M_PI / 4);
+    ASSERT_LT(SampleUtil::maxAbsAmplitude(buffer.data(), kNumSamples), kCeiling);
+    m_limiter.process(buffer.data(), kNumSamples);
+
+    // After the attack, the true peak of the output is below the ceiling
+    const SINT settledOffset = m_limiter.getLatencyFrames() * 4;
+    const CSAMPLE samplePeak = SampleUtil::maxAbsAmplitude(
+            buffer.data() + settledOffset, kNumSamples - settledOffset);
+    EXPECT_LE(samplePeak * M_SQRT2, kCeiling * 1.02);
+    EXPECT_GE(samplePeak * M_SQRT2, kCeiling * 0.9);
+}
+
+TEST_F(EngineLimiterTest, GainChangesSmoothly) {
+    constexpr CSAMPLE_GAIN kCeiling = 1.0f;
+    m_limiter.setCeiling(kCeiling);
+    const SINT latency = m_limiter.getLatencyFrames();
+
+    // A DC step from 0.5 to 2 requires a gain of 0.5
+    mixxx::SampleBuffer buffer(kNumSamples);
+    buffer.fill(0.5f);
+    for (SINT i = kNumSamples / 2; i < kNumSamples; ++i) {
+        buffer[i] = 2.0f;
+    }
+    m_limiter.process(buffer.data(), kNumSamples);
+
+    // The gain reduction must have fully ramped in when the step reaches
+    // the output and must not change more than the moving average over the
+    // look-ahead window allows.
+    const SINT lookaheadFrames = latency - EngineLimiter::kDetectorDelayFrames + 1;
+    const CSAMPLE maxGainStep = 1.0f / lookaheadFrames;
+    CSAMPLE previousGain = 1.0f;
+    for (SINT frame = latency + 1; frame < kNumFrames; ++frame) {
+        const CSAMPLE input = frame - latency < kNumFrames / 2 ? 0.5f : 2.0f;
+        const CSAMPLE gain = buffer[frame * 2] / input;
+        EXPECT_LE(input * gain, kCeiling * 1.0001f) << "frame " << frame;
+        EXPECT_LE(std::abs(gain - previousGain), maxGainStep * 1.001f) << "frame " << frame;
+        previousGain = gain;
+    }
+    // The overshoot of the interpolated step is limited as well and
+    // released slowly.
+    EXPECT_LE(previousGain, 0.5f);
+    EXPECT_GT(previousGain, 0.45f);
+}
+
+TEST_F(EngineLimiterTest, OutputIsIndependentOfBufferSize) {
+    m_limiter.setCeiling(0.5f);
+    EngineLimiter limiter;
+    limiter.setSampleRate(kSampleRate);
+    limiter.setCeiling(0.5f);
+
+    mixxx::SampleBuffer expected(kNumSamples);
+    fillSine(expected.data(), kNumFrames, 100, 1.0);
+    mixxx::SampleBuffer actual(kNumSamples);
+    SampleUtil::copy(actual.data(), expected.data(), kNumSamples);
+
+    m_limiter.process(expected.data(), kNumSamples);
+    SINT offset = 0;
+    for (SINT frames : {1, 64, 300, 1000, 7}) {
+        limiter.process(actual.data() + offset, frames * mixxx::kEngineChannelCount);
+        offset += frames * mixxx::kEngineChannelCount;
+    }
+    limiter.process(actual.data() + offset, kNumSamples - offset);
+
+    for (SINT i = 0; i < kNumSamples; ++i) {
+        EXPECT_FLOAT_EQ(expected[i], actual[i]) << "sample " << i;
+    }
+}
+
+class EngineBusLimiterTest : public MixxxTest {
+  protected:
+    EngineBusLimiterTest()
+            : m_sampleRate(ConfigKey("[Master]", "samplerate")) {
+        m_sampleRate.set(kSampleRate.toDouble());
+    }
+
+    ControlObject m_sampleRate;
+};
+
+TEST_F(EngineBusLimiterTest, AlignedBusesStayInPhase) {
+    EngineBusLimiter limited("[Master]", "limiter");
+    EngineBusLimiter bypassed("[Master]", "booth_limiter");
+    ControlObject::set(ConfigKey("[Master]", "limiter"), 1.0);
+
+    limited.onCallbackStart();
+    bypassed.onCallbackStart();
+    const SINT latency = limited.getLatencyFrames();
+    EXPECT_GT(latency, 0);
+    EXPECT_EQ(0, bypassed.getLatencyFrames());
+    limited.setAlignedLatencyFrames(latency);
+    bypassed.setAlignedLatencyFrames(latency);
+
+    // The alignment delay fades in during the first buffer
+    constexpr SINT kBufferSamples = 1024 * mixxx::kEngineChannelCount;
+    mixxx::SampleBuffer limitedBuffer(kBufferSamples);
+    mixxx::SampleBuffer bypassedBuffer(kBufferSamples);
+    limitedBuffer.clear();
+    bypassedBuffer.clear();
+    limited.process(limitedBuffer.data(), kBufferSamples);
+    bypassed.process(bypassedBuffer.data(), kBufferSamples);
+
+    // An impulse below the ceiling passes both buses unchanged
+    limitedBuffer.clear();
+    bypassedBuffer.clear();
+    limitedBuffer[0] = 0.25f;
+    bypassedBuffer[0] = 0.25f;
+    limited.process(limitedBuffer.data(), kBufferSamples);
+    bypassed.process(bypassedBuffer.data(), kBufferSamples);
+
+    for (SINT i = 0; i < kBufferSamples; ++i) {
+        EXPECT_EQ(limitedBuffer[i], bypassedBuffer[i]) << "sample " << i;
+    }
+    EXPECT_EQ(0.25f, bypassedBuffer[latency * mixxx::kEngineChannelCount]);
+}
+
+static void BM_EngineLimiter(benchmark::State& state) {
+    const SINT numFrames = static_cast<SINT>(state.range(0));
+    const SINT numSamples = numFrames * mixxx::kEngineChannelCount;
+
+    EngineLimiter limiter;
+    limiter.setSampleRate(kSampleRate);
+    limiter.setCeiling(0.5f);
+    mixxx::SampleBuffer input(numSamples);
+    for (SINT i = 0; i < numSamples; ++i) {
+        input[i] = static_cast<CSAMPLE>(std::sin(i * 0.01));
+    }
+    mixxx::SampleBuffer buffer(numSamples);
+    for (auto _ : state) {
+        SampleUtil::copy(buffer.data(), input.data(), numSamples);
+        limiter.process(buffer.data(), numSamples);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.SetItemsProcessed(state.iterations() * numFrames);
+}
+BENCHMARK(BM_EngineLimiter)->Range(64, 4096);
+
+} // namespace
@@ -2,16 +2,21 @@
 #include <gmock/gmock.h>
 
 #include <QtDebug>
+#include <vector>
 
 #include "control/controlproxy.h"
+#include "effects/backends/builtin/distortioneffect.h"
 #include "engine/channels/enginechannel.h"
+#include "engine/effects/engineeffectsmanager.h"
 #include "engine/enginemaster.h"
 #include "test/mixxxtest.h"
 #include "test/signalpathtest.h"
+#include "test/testengineeffectchains.h"
 #include "util/defs.h"
 #include "util/sample.h"
 #include "util/types.h"
 
+using ::testing::AnyNumber;
 using ::testing::Return;
 using ::testing::_;
 
@@ -476,4 +481,82 @@ TEST_F(EngineMasterTest, ThreeChannelPFLOutputWorks) {
     assertHeadphoneBufferMatchesGolden(testName);
 }
 
+TEST_F(EngineMasterTest, LatentEffectKeepsChannelsAligned) {
+    EngineChannelMock* pChannel1 = new EngineChannelMock(
+            "[Test1]", EngineChannel::LEFT, m_pEngineMaster);
+    m_pEngineMaster->addChannel(pChannel1);
+    EngineChannelMock* pChannel2 = new EngineChannelMock(
+            "[Test2]", EngineChannel::RIGHT, m_pEngineMaster);
+    m_pEngineMaster->addChannel(pChannel2);
+
+    for (auto* pChannel : {pChannel1, pChannel2}) {
+        EXPECT_CALL(*pChannel, updateActiveState())
+                .WillRepeatedly(Return(EngineChannel::ActiveState::Active));
+        EXPECT_CALL(*pChannel, isActive())
+                .WillRepeatedly(Return(true));
+        EXPECT_CALL(*pChannel, isMasterEnabled())
+                .WillRepeatedly(Return(true));
+        EXPECT_CALL(*pChannel, isPflEnabled())
+                .WillRepeatedly(Return(false));
+        EXPECT_CALL(*pChannel, collectFeatures(_))
+                .Times(AnyNumber());
+        EXPECT_CALL(*pChannel, postProcess(_))
+                .Times(AnyNumber());
+        EXPECT_CALL(*pChannel, process(_, _))
+                .WillRepeatedly(Return());
+    }
+
+    // A Distortion with 8x oversampling and the chain mix at 0 delays
+    // channel 1 by the latency of the oversampler without changing it
+    const ChannelHandleAndGroup test1 = m_pEngineMaster->registerChannelGroup("[Test1]");
+    const ChannelHandleAndGroup test2 = m_pEngineMaster->registerChannelGroup("[Test2]");
+    const ChannelHandleAndGroup main = m_pEngineMaster->registerChannelGroup(m_sMasterGroup);
+    EngineEffectsManager* pEngineEffectsManager = m_pEffectsManager->getEngineEffectsManager();
+    TestEngineEffectChains chains(pEngineEffectsManager,
+            m_pEffectsManager->getBackendManager(),
+            QSet<ChannelHandleAndGroup>{test1, test2},
+            QSet<ChannelHandleAndGroup>{main});
+    chains.addChain({DistortionEffect::getId()}, {test1.handle()}, 0.0);
+    chains.setParameter(chains.effect(0), 2, 3);
+
+    constexpr int kBufferSize = 1024;
+    constexpr int kImpulseCallback = 4;
+    constexpr SINT kImpulseFrame = 100;
+    CSAMPLE* pChannel1Buffer = const_cast<CSAMPLE*>(m_pEngineMaster->getChannelBuffer("[Test1]"));
+    CSAMPLE* pChannel2Buffer = const_cast<CSAMPLE*>(m_pEngineMaster->getChannelBuffer("[Test2]"));
+    std::vector<CSAMPLE> output;
+    for (int callback = 0; callback < kImpulseCallback + 2; ++callback) {
+        SampleUtil::clear(pChannel1Buffer, kBufferSize);
+        SampleUtil::clear(pChannel2Buffer, kBufferSize);
+        if (callback == kImpulseCallback) {
+            // The same impulse on both channels
+            pChannel1Buffer[kImpulseFrame * 2] = 0.5f;
+            pChannel1Buffer[kImpulseFrame * 2 + 1] = 0.5f;
+            pChannel2Buffer[kImpulseFrame * 2] = 0.5f;
+            pChannel2Buffer[kImpulseFrame * 2 + 1] = 0.5f;
+        }
+        m_pEngineMaster->process(kBufferSize);
+        if (callback >= kImpulseCallback) {
+            const CSAMPLE* pMaster = m_pEngineMaster->getMasterBuffer();
+            output.insert(output.end(), pMaster, pMaster + kBufferSize);
+        }
+    }
+
+    // Both impulses arrive delayed once by the latency of the effect, i.e.
+    // channel 2 is aligned to channel 1 and the buses and the main channel
+    // are not delayed again.
+    const SINT latencyFrames = pEngineEffectsManager->getLatencyFrames(main.handle());
+    ASSERT_GT(latencyFrames, 0);
+    const SINT expectedFrame = kImpulseFrame + latencyFrames;
+    for (SINT frame = 0; frame < static_cast<SINT>(output.size()) / 2; ++frame) {
+        if (frame == expectedFrame) {
+            EXPECT_GT(output[frame * 2], 0.0f);
+            EXPECT_GT(output[frame * 2 + 1], 0.0f);
+        } else {
+            EXPECT_EQ(0.0f, output[frame * 2]) << "frame " << frame;
+            EXPECT_EQ(0.0f, output[frame * 2 + 1]) << "frame " << frame;
+        }
+    }
+}
+
 }  // namespace
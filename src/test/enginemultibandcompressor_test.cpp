@@ -0,0 +1,313 @@
+#include "engine/enginemultibandcompressor.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+
+#include "engine/engine.h"
+#include "util/math.h"
+#include "util/sample.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr SINT kMaxFrames = 1024;
+constexpr SINT kNumFrames = 16384;
+constexpr SINT kNumSamples = kNumFrames * mixxx::kEngineChannelCount;
+constexpr mixxx::audio::SampleRate kSampleRate(48000);
+
+class EngineMultiBandCompressorTest : public testing::Test {
+  protected:
+    static void fillSine(CSAMPLE* pBuffer, SINT numFrames, double frequency, double amplitude) {
+        for (SINT frame = 0; frame < numFrames; ++frame) {
+            const auto value = static_cast<CSAMPLE>(amplitude *
+                    std::sin(2 * M_PI * frequency * frame / kSampleRate.toDouble()));
+            pBuffer[frame * 2] = value;
+            pBuffer[frame * 2 + 1] = value;
+        }
+    }
+
+    static double rms(const CSAMPLE* pBuffer, SINT numSamples) {
+        double sum = 0;
+        for (SINT i = 0; i < numSamples; ++i) {
+            sum += pBuffer[i] * pBuffer[i];
+        }
+        return std::sqrt(sum / numSamples);
+    }
+
+    static void setAllBands(EngineMultiBandCompressor* pCompressor,
+            CSAMPLE threshold,
+            CSAMPLE ratio,
+            CSAMPLE_GAIN minimumGain) {
+        for (int band = 0; band < EngineMultiBandCompressor::kNumBands; ++band) {
+            pCompressor->setBandParameters(band, {threshold, ratio, minimumGain});
+        }
+    }
+};
+
+TEST_F(EngineMultiBandCompressorTest, BelowThresholdIsBitExact) {
+    EngineMultiBandCompressor compressor(kMaxFrames);
+    compressor.setSampleRate(kSampleRate);
+    setAllBands(&compressor, 0.5f, 4.0f, CSAMPLE_GAIN_ZERO);
+
+    mixxx::SampleBuffer input(kNumSamples);
+    fillSine(input.data(), kNumFrames, 1000, 0.4);
+    mixxx::SampleBuffer output(kNumSamples);
+    compressor.process(input.data(), output.data(), kNumSamples);
+
+    for (int band = 0; band < EngineMultiBandCompressor::kNumBands; ++band) {
+        EXPECT_EQ(CSAMPLE_GAIN_ONE, compressor.getGain(band));
+    }
+    for (SINT i = 0; i < kNumSamples; ++i) {
+        EXPECT_EQ(input[i], output[i]) << "sample " << i;
+    }
+}
+
+TEST_F(EngineMultiBandCompressorTest, BandsSumUpFlat) {
+    for (double frequency : {50.0, 246.0, 1000.0, 2484.0, 10000.0}) {
+        SCOPED_TRACE(frequency);
+        EngineMultiBandCompressor compressor(kMaxFrames);
+        compressor.setSampleRate(kSampleRate);
+        // Engage the processing with a gain just below unity
+        setAllBands(&compressor, 0.001f, 1.0001f, CSAMPLE_GAIN_ZERO);
+
+        mixxx::SampleBuffer input(kNumSamples);
+        fillSine(input.data(), kNumFrames, frequency, 0.4);
+        mixxx::SampleBuffer output(kNumSamples);
+        compressor.process(input.data(), output.data(), kNumSamples);
+        EXPECT_LT(compressor.getGain(EngineMultiBandCompressor::Mid), CSAMPLE_GAIN_ONE);
+
+        // The crossover is an allpass, only the phase is changed.
+        const SINT settledOffset = kNumSamples / 2;
+        EXPECT_NEAR(rms(input.data() + settledOffset, kNumSamples - settledOffset),
+                rms(output.data() + settledOffset, kNumSamples - settledOffset),
+                0.002);
+    }
+}
+
+TEST_F(EngineMultiBandCompressorTest, OnlyTheBandOfTheKeyIsCompressed) {
+    EngineMultiBandCompressor compressor(kMaxFrames);
+    compressor.setSampleRate(kSampleRate);
+    compressor.setAttackMs(0);
+    compressor.setReleaseMs(1000);
+    setAllBands(&compressor, 0.1f, 2.0f, CSAMPLE_GAIN_ZERO);
+
+    mixxx::SampleBuffer buffer(kNumSamples);
+    fillSine(buffer.data(), kNumFrames, 1000, 0.4);
+    compressor.process(buffer.data(), buffer.data(), kNumSamples);
+
+    // 12 dB above the threshold with a ratio of 2 reduce the mid band by 6 dB
+    EXPECT_NEAR(0.5f, compressor.getGain(EngineMultiBandCompressor::Mid), 0.02f);
+    EXPECT_GT(compressor.getGain(EngineMultiBandCompressor::Low), 0.95f);
+    EXPECT_GT(compressor.getGain(EngineMultiBandCompressor::High), 0.95f);
+}
+
+TEST_F(EngineMultiBandCompressorTest, SidechainKeyDucksPrograms) {
+    constexpr CSAMPLE_GAIN kMinimumGain = 0.25f;
+    constexpr SINT kBufferFrames = 512;
+    constexpr SINT kBufferSamples = kBufferFrames * mixxx::kEngineChannelCount;
+    EngineMultiBandCompressor compressor(kBufferFrames, 2);
+    compressor.setSampleRate(kSampleRate);
+    compressor.setAttackMs(5);
+    compressor.setReleaseMs(200);
+    setAllBands(&compressor, 0.01f, std::numeric_limits<CSAMPLE>::infinity(), kMinimumGain);
+
+    // Key with energy in all bands
+    mixxx::SampleBuffer key(kBufferSamples);
+    key.fill(CSAMPLE_ZERO);
+    mixxx::SampleBuffer sine(kBufferSamples);
+    for (double frequency : {93.75, 937.5, 9375.0}) {
+        fillSine(sine.data(), kBufferFrames, frequency, 0.5);
+        SampleUtil::add(key.data(), sine.data(), kBufferSamples);
+    }
+    mixxx::SampleBuffer program(kBufferSamples);
+    fillSine(program.data(), kBufferFrames, 440, 0.5);
+    mixxx::SampleBuffer output0(kBufferSamples);
+    mixxx::SampleBuffer output1(kBufferSamples);
+
+    for (int i = 0; i < 50; ++i) {
+        compressor.processKey(key.data(), kBufferSamples);
+        compressor.processProgram(0, program.data(), output0.data(), kBufferSamples);
+        compressor.processProgram(1, program.data(), output1.data(), kBufferSamples);
+    }
+    for (int band = 0; band < EngineMultiBandCompressor::kNumBands; ++band) {
+        EXPECT_NEAR(kMinimumGain, compressor.getGain(band), 0.01f) << "band " << band;
+    }
+    // Both programs are ducked with the same gains
+    EXPECT_NEAR(rms(program.data(), kBufferSamples) * kMinimumGain,
+            rms(output0.data(), kBufferSamples),
+            0.01);
+    for (SINT i = 0; i < kBufferSamples; ++i) {
+        EXPECT_EQ(output0[i], output1[i]);
+    }
+
+    // The gains are released when the key is silent
+    key.fill(CSAMPLE_ZERO);
+    for (int i = 0; i < 200; ++i) {
+        compressor.processKey(key.data(), kBufferSamples);
+        compressor.processProgram(0, program.data(), output0.data(), kBufferSamples);
+    }
+    for (int band = 0; band < EngineMultiBandCompressor::kNumBands; ++band) {
+        EXPECT_GT(compressor.getGain(band), 0.99f) << "band " << band;
+    }
+}
+
+TEST_F(EngineMultiBandCompressorTest, LinkedBandsDuckAllBandsAlike) {
+    constexpr CSAMPLE_GAIN kMinimumGain = 0.25f;
+    constexpr SINT kBufferFrames = 512;
+    constexpr SINT kBufferSamples = kBufferFrames * mixxx::kEngineChannelCount;
+    EngineMultiBandCompressor compressor(kBufferFrames);
+    compressor.setSampleRate(kSampleRate);
+    compressor.setAttackMs(5);
+    compressor.setReleaseMs(200);
+    compressor.setBandsLinked(true);
+    compressor.setBandParameters(EngineMultiBandCompressor::Low,
+            {0.1f, std::numeric_limits<CSAMPLE>::infinity(), kMinimumGain, true});
+
+    // A key in the mid band only, like speech
+    mixxx::SampleBuffer key(kBufferSamples);
+    fillSine(key.data(), kBufferFrames, 937.5, 0.5);
+    // A program in the low band
+    mixxx::SampleBuffer program(kBufferSamples);
+    fillSine(program.data(), kBufferFrames, 93.75, 0.5);
+    mixxx::SampleBuffer output(kBufferSamples);
+
+    for (int i = 0; i < 50; ++i) {
+        compressor.processKey(key.data(), kBufferSamples);
+        compressor.processProgram(0, program.data(), output.data(), kBufferSamples);
+    }
+    EXPECT_NEAR(kMinimumGain, compressor.getGain(EngineMultiBandCompressor::Low), 0.01f);
+    EXPECT_EQ(compressor.getGain(EngineMultiBandCompressor::Low),
+            compressor.getGain(EngineMultiBandCompressor::Mid));
+    EXPECT_EQ(compressor.getGain(EngineMultiBandCompressor::Low),
+            compressor.getGain(EngineMultiBandCompressor::High));
+    // The program is only scaled, not split into bands and phase shifted
+    for (SINT i = 0; i < kBufferSamples; ++i) {
+        EXPECT_NEAR(program[i] * kMinimumGain, output[i], 0.01f) << "sample " << i;
+    }
+}
+
+TEST_F(EngineMultiBandCompressorTest, ForcedKeyRampsPerSample) {
+    constexpr CSAMPLE_GAIN kMinimumGain = 0.1f;
+    constexpr SINT kBufferSamples = kMaxFrames * mixxx::kEngineChannelCount;
+    EngineMultiBandCompressor compressor(kMaxFrames);
+    compressor.setSampleRate(kSampleRate);
+    compressor.setAttackMs(5);
+    setAllBands(&compressor, 0.1f, std::numeric_limits<CSAMPLE>::infinity(), kMinimumGain);
+
+    // 1 kHz has a period of 48 frames
+    constexpr SINT kPeriodFrames = 48;
+    mixxx::SampleBuffer buffer(kBufferSamples);
+    fillSine(buffer.data(), kMaxFrames, 1000, 0.5);
+    compressor.processForcedKey(true, kBufferSamples);
+    compressor.processProgram(0, buffer.data(), buffer.data(), kBufferSamples);
+
+    // A single large buffer is not ducked with a single step, the level
+    // decreases continuously from period to period.
+    CSAMPLE previousPeak = SampleUtil::maxAbsAmplitude(buffer.data(), kPeriodFrames * 2);
+    EXPECT_GT(previousPeak, 0.4f);
+    for (SINT frame = kPeriodFrames; frame + kPeriodFrames <= kMaxFrames;
+            frame += kPeriodFrames) {
+        const CSAMPLE peak = SampleUtil::maxAbsAmplitude(
+                buffer.data() + frame * 2, kPeriodFrames * 2);
+        EXPECT_LT(peak, previousPeak) << "frame " << frame;
+        EXPECT_GT(peak, previousPeak * 0.7f) << "frame " << frame;
+        previousPeak = peak;
+    }
+    EXPECT_LT(previousPeak, 0.1f);
+
+    for (int i = 0; i < 20; ++i) {
+        compressor.processForcedKey(true, kBufferSamples);
+    }
+    for (int band = 0; band < EngineMultiBandCompressor::kNumBands; ++band) {
+        EXPECT_EQ(kMinimumGain, compressor.getGain(band)) << "band " << band;
+    }
+}
+
+TEST_F(EngineMultiBandCompressorTest, LookaheadDelaysProgram) {
+    EngineMultiBandCompressor compressor(kMaxFrames);
+    EngineMultiBandCompressor lookahead(kMaxFrames);
+    compressor.setSampleRate(kSampleRate);
+    lookahead.setSampleRate(kSampleRate);
+    lookahead.setLookaheadMs(2);
+    const SINT lookaheadFrames = lookahead.getLookaheadFrames();
+    EXPECT_EQ(96, lookaheadFrames);
+    EXPECT_EQ(0, compressor.getLookaheadFrames());
+
+    mixxx::SampleBuffer input(kNumSamples);
+    fillSine(input.data(), kNumFrames, 300, 0.5);
+    mixxx::SampleBuffer expected(kNumSamples);
+    mixxx::SampleBuffer actual(kNumSamples);
+    compressor.process(input.data(), expected.data(), kNumSamples);
+    lookahead.process(input.data(), actual.data(), kNumSamples);
+
+    for (SINT i = 0; i < lookaheadFrames * 2; ++i) {
+        EXPECT_EQ(CSAMPLE_ZERO, actual[i]);
+    }
+    for (SINT i = lookaheadFrames * 2; i < kNumSamples; ++i) {
+        EXPECT_FLOAT_EQ(expected[i - lookaheadFrames * 2], actual[i]) << "sample " << i;
+    }
+}
+
+TEST_F(EngineMultiBandCompressorTest, OutputIsIndependentOfBufferSize) {
+    EngineMultiBandCompressor oneBuffer(kNumFrames);
+    EngineMultiBandCompressor oddBuffers(kNumFrames);
+    for (auto* pCompressor : {&oneBuffer, &oddBuffers}) {
+        pCompressor->setSampleRate(kSampleRate);
+        pCompressor->setAttackMs(1);
+        pCompressor->setReleaseMs(20);
+        pCompressor->setLookaheadMs(1);
+        setAllBands(pCompressor, 0.2f, 3.0f, 0.1f);
+    }
+
+    mixxx::SampleBuffer input(kNumSamples);
+    for (SINT frame = 0; frame < kNumFrames; ++frame) {
+        // Bursts of a chirp
+        const double envelope = (frame / 2000) % 2 ? 0.1 : 1.0;
+        const auto value = static_cast<CSAMPLE>(envelope * std::cos(frame * frame * 2e-5));
+        input[frame * 2] = value;
+        input[frame * 2 + 1] = -value;
+    }
+    mixxx::SampleBuffer expected(kNumSamples);
+    mixxx::SampleBuffer actual(kNumSamples);
+    oneBuffer.process(input.data(), expected.data(), kNumSamples);
+
+    SINT offset = 0;
+    for (SINT frames : {1, 37, 256, 300, 1000, 3}) {
+        const SINT samples = frames * mixxx::kEngineChannelCount;
+        oddBuffers.process(input.data() + offset, actual.data() + offset, samples);
+        offset += samples;
+    }
+    oddBuffers.process(input.data() + offset, actual.data() + offset, kNumSamples - offset);
+
+    for (SINT i = 0; i < kNumSamples; ++i) {
+        EXPECT_FLOAT_EQ(expected[i], actual[i]) << "sample " << i;
+    }
+}
+
+static void BM_EngineMultiBandCompressor(benchmark::State& state) {
+    const SINT numFrames = static_cast<SINT>(state.range(0));
+    const SINT numSamples = numFrames * mixxx::kEngineChannelCount;
+
+    EngineMultiBandCompressor compressor(numFrames);
+    compressor.setSampleRate(kSampleRate);
+    compressor.setLookaheadMs(1);
+    for (int band = 0; band < EngineMultiBandCompressor::kNumBands; ++band) {
+        compressor.setBandParameters(band, {0.1f, 4.0f, CSAMPLE_GAIN_ZERO});
+    }
+    mixxx::SampleBuffer input(numSamples);
+    for (SINT i = 0; i < numSamples; ++i) {
+        input[i] = static_cast<CSAMPLE>(std::sin(i * 0.01));
+    }
+    mixxx::SampleBuffer output(numSamples);
+    for (auto _ : state) {
+        compressor.process(input.data(), output.data(), numSamples);
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(state.iterations() * numFrames);
+}
+BENCHMARK(BM_EngineMultiBandCompressor)->Range(64, 4096);
+
+} // namespace
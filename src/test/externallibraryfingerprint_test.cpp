@@ -0,0 +1,84 @@
+#include "library/externallibraryfingerprint.h"
+
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "test/mixxxdbtest.h"
+
+namespace {
+
+const QString kSettingsKey = QStringLiteral("mixxx.test.fingerprint");
+
+class ExternalLibraryFingerprintTest : public MixxxDbTest {
+  protected:
+    ExternalLibraryFingerprintTest()
+            : MixxxDbTest(true) {
+    }
+
+    void SetUp() override {
+        ASSERT_TRUE(MixxxDb::initDatabaseSchema(dbConnection()));
+        ASSERT_TRUE(m_tempDir.isValid());
+        m_filePath = m_tempDir.filePath("library.xml");
+        writeFile("<plist>1</plist>");
+    }
+
+    void writeFile(const QByteArray& contents) {
+        QFile file(m_filePath);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        ASSERT_EQ(contents.size(), file.write(contents));
+    }
+
+    void setLastModified(const QDateTime& lastModified) {
+        QFile file(m_filePath);
+        ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+        ASSERT_TRUE(file.setFileTime(lastModified, QFileDevice::FileModificationTime));
+    }
+
+    QTemporaryDir m_tempDir;
+    QString m_filePath;
+};
+
+TEST_F(ExternalLibraryFingerprintTest, matchUnmodifiedFile) {
+    const auto fingerprint = ExternalLibraryFingerprint::fromFile(m_filePath);
+    ASSERT_TRUE(fingerprint.isValid());
+    EXPECT_TRUE(fingerprint.matchesFile(m_filePath));
+    EXPECT_FALSE(fingerprint.matchesFile(m_tempDir.filePath("other.xml")));
+}
+
+TEST_F(ExternalLibraryFingerprintTest, matchTouchedFile) {
+    const auto fingerprint = ExternalLibraryFingerprint::fromFile(m_filePath);
+    setLastModified(QDateTime::currentDateTimeUtc().addDays(1));
+    EXPECT_TRUE(fingerprint.matchesFile(m_filePath));
+}
+
+TEST_F(ExternalLibraryFingerprintTest, detectModifiedFile) {
+    const auto fingerprint = ExternalLibraryFingerprint::fromFile(m_filePath);
+
+    // Same size but different contents
+    writeFile("<plist>2</plist>");
+    setLastModified(QDateTime::currentDateTimeUtc().addDays(1));
+    EXPECT_FALSE(fingerprint.matchesFile(m_filePath));
+
+    writeFile("<plist>23</plist>");
+    EXPECT_FALSE(fingerprint.matchesFile(m_filePath));
+}
+
+TEST_F(ExternalLibraryFingerprintTest, saveAndLoad) {
+    // The file path might contain the separator
+    m_filePath = m_tempDir.filePath("iTunes Music Library.xml");
+    writeFile("<plist/>");
+    const auto fingerprint = ExternalLibraryFingerprint::fromFile(m_filePath);
+    ASSERT_TRUE(fingerprint.isValid());
+
+    EXPECT_FALSE(ExternalLibraryFingerprint::load(dbConnection(), kSettingsKey).isValid());
+    ASSERT_TRUE(fingerprint.save(dbConnection(), kSettingsKey));
+    EXPECT_EQ(fingerprint, ExternalLibraryFingerprint::load(dbConnection(), kSettingsKey));
+
+    ASSERT_TRUE(ExternalLibraryFingerprint::reset(dbConnection(), kSettingsKey));
+    EXPECT_FALSE(ExternalLibraryFingerprint::load(dbConnection(), kSettingsKey).isValid());
+}
+
+} // anonymous namespace
@@ -0,0 +1,86 @@
+#include "util/fileidentity.h"
+
+#include <gtest/gtest.h>
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+namespace {
+
+class FileIdentityTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+    }
+
+    QString writeFile(const QString& fileName, const QByteArray& data) {
+        const QString filePath = QDir(m_tempDir.path()).filePath(fileName);
+        QFile file(filePath);
+        EXPECT_TRUE(file.open(QIODevice::WriteOnly));
+        EXPECT_EQ(data.size(), file.write(data));
+        return filePath;
+    }
+
+    static mixxx::FileIdentity fromData(const QString& filePath, const QByteArray& data) {
+        return mixxx::FileIdentity::fromFileData(
+                reinterpret_cast<const unsigned char*>(data.constData()),
+                static_cast<quint64>(data.size()),
+                QFileInfo(filePath).lastModified());
+    }
+
+    QTemporaryDir m_tempDir;
+};
+
+TEST_F(FileIdentityTest, FileMatchesFileData) {
+    // Smaller than one, between one and two, and larger than two blocks
+    for (const int size : {100, 1500, 10000}) {
+        SCOPED_TRACE(size);
+        QByteArray data(size, '\0');
+        for (int i = 0; i < size; ++i) {
+            data[i] = static_cast<char>(i * 7);
+        }
+        const QString filePath = writeFile(QStringLiteral("file.bin"), data);
+        const auto identity = mixxx::FileIdentity::fromFile(filePath);
+        EXPECT_TRUE(identity.isValid());
+        EXPECT_EQ(static_cast<quint64>(size), identity.fileSize());
+        EXPECT_EQ(fromData(filePath, data), identity);
+    }
+}
+
+TEST_F(FileIdentityTest, DetectsModifiedTail) {
+    QByteArray data(10000, 'x');
+    const QString filePath = writeFile(QStringLiteral("original.bin"), data);
+    const auto original = mixxx::FileIdentity::fromFile(filePath);
+    data[data.size() - 1] = 'y';
+    EXPECT_NE(original, fromData(filePath, data));
+    EXPECT_NE(original.cacheKey(), fromData(filePath, data).cacheKey());
+}
+
+TEST_F(FileIdentityTest, EmptyOrMissingFileIsInvalid) {
+    EXPECT_FALSE(mixxx::FileIdentity::fromFile(
+            writeFile(QStringLiteral("empty.bin"), QByteArray()))
+                         .isValid());
+    EXPECT_FALSE(mixxx::FileIdentity::fromFile(
+            QDir(m_tempDir.path()).filePath(QStringLiteral("missing.bin")))
+                         .isValid());
+}
+
+TEST_F(FileIdentityTest, Serialization) {
+    const auto identity = mixxx::FileIdentity::fromFile(
+            writeFile(QStringLiteral("file.bin"), QByteArray(3000, 'x')));
+    QByteArray buffer;
+    {
+        QDataStream out(&buffer, QIODevice::WriteOnly);
+        out << identity;
+    }
+    QDataStream in(buffer);
+    mixxx::FileIdentity deserialized;
+    in >> deserialized;
+    EXPECT_EQ(QDataStream::Ok, in.status());
+    EXPECT_EQ(identity, deserialized);
+}
+
+} // namespace
@@ -4,6 +4,8 @@
 
 #include <QtDebug>
 
+#include "util/cache.h"
+
 namespace {
 
 class ImageUtilsTest : public testing::Test {
@@ -25,6 +27,28 @@ TEST_F(ImageUtilsTest, OneBitImageDigest) {
     EXPECT_FALSE(mixxx::digestImage(QImage(1, 1, QImage::Format_Mono)).isEmpty());
 }
 
+TEST_F(ImageUtilsTest, ImageDigest) {
+    QImage image(16, 16, QImage::Format_RGB32);
+    fillImageWithColor(image, QRgb(0x84CA2F));
+    const auto digest = mixxx::digestImage(image);
+    EXPECT_EQ(static_cast<int>(sizeof(mixxx::cache_key_t)), digest.size());
+    EXPECT_TRUE(mixxx::isValidCacheKey(mixxx::cacheKeyFromMessageDigest(digest)));
+
+    // Same pixels
+    EXPECT_EQ(digest, mixxx::digestImage(image.copy()));
+
+    // Different pixels
+    QImage modifiedImage = image.copy();
+    modifiedImage.setPixel(15, 15, QRgb(0x84CA30));
+    EXPECT_NE(digest, mixxx::digestImage(modifiedImage));
+
+    // Same pixel data with different dimensions
+    QImage reshapedImage(32, 8, QImage::Format_RGB32);
+    fillImageWithColor(reshapedImage, QRgb(0x84CA2F));
+    ASSERT_EQ(image.sizeInBytes(), reshapedImage.sizeInBytes());
+    EXPECT_NE(digest, mixxx::digestImage(reshapedImage));
+}
+
 TEST_F(ImageUtilsTest, NullImageBackgroundColor) {
     EXPECT_EQ(QColor(), mixxx::extractImageBackgroundColor(QImage()));
 }
@@ -0,0 +1,151 @@
+#include "library/itunes/itunesdao.h"
+
+#include <gtest/gtest.h>
+
+#include <QSqlQuery>
+#include <QStringList>
+#include <memory>
+
+#include "database/mixxxdb.h"
+#include "library/itunes/itunespathmapping.h"
+#include "library/treeitem.h"
+#include "test/mixxxdbtest.h"
+
+namespace {
+
+ITunesTrack makeTrack(int id, const QString& title) {
+    return ITunesTrack{
+            .id = id,
+            .artist = "Artist",
+            .title = title,
+            .album = "Album",
+            .albumArtist = "Artist",
+            .genre = "House",
+            .grouping = "",
+            .year = 2023,
+            .duration = 300,
+            .location = "/Volumes/iTunes Media/" + title + ".m4a",
+            .rating = 3,
+            .comment = "",
+            .trackNumber = id,
+            .bpm = 124,
+            .bitrate = 256,
+    };
+}
+
+class ITunesDAOTest : public MixxxDbTest {
+  protected:
+    ITunesDAOTest()
+            : MixxxDbTest(true) {
+    }
+
+    void SetUp() override {
+        ASSERT_TRUE(MixxxDb::initDatabaseSchema(dbConnection()));
+    }
+
+    std::unique_ptr<ITunesDAO> makeDAO() {
+        auto pDao = std::make_unique<ITunesDAO>();
+        pDao->initialize(dbConnection());
+        EXPECT_TRUE(pDao->loadExistingRows());
+        return pDao;
+    }
+
+    /// Imports 3 tracks and the playlists "Folder" > "Playlist A" and
+    /// "Playlist B".
+    void importLibrary(ITunesDAO* pDao, const QString& secondTitle, bool withPlaylistB) {
+        ASSERT_TRUE(pDao->importTrack(makeTrack(1, "One")));
+        ASSERT_TRUE(pDao->importTrack(makeTrack(2, secondTitle)));
+        ASSERT_TRUE(pDao->importTrack(makeTrack(3, "Three")));
+
+        ASSERT_TRUE(pDao->importPlaylist(ITunesPlaylist{.id = 10, .name = "Folder"}));
+        ASSERT_TRUE(pDao->importPlaylistRelation(kRootITunesPlaylistId, 10));
+        ASSERT_TRUE(pDao->importPlaylist(ITunesPlaylist{.id = 11, .name = "Playlist A"}));
+        ASSERT_TRUE(pDao->importPlaylistTrack(11, 1, 1));
+        ASSERT_TRUE(pDao->importPlaylistTrack(11, 2, 2));
+        ASSERT_TRUE(pDao->importPlaylistRelation(10, 11));
+        if (withPlaylistB) {
+            ASSERT_TRUE(pDao->importPlaylist(ITunesPlaylist{.id = 12, .name = "Playlist B"}));
+            ASSERT_TRUE(pDao->importPlaylistTrack(12, 3, 1));
+            ASSERT_TRUE(pDao->importPlaylistRelation(kRootITunesPlaylistId, 12));
+        }
+        // The tracks are imported with the localhost token before the
+        // "Music Folder" key has been parsed
+        ASSERT_TRUE(pDao->applyPathMapping(ITunesPathMapping{
+                .dbITunesRoot = "/Volumes/iTunes Media",
+                .mixxxITunesRoot = "/Music",
+        }));
+        ASSERT_TRUE(pDao->finishImport());
+    }
+
+    int totalChanges() {
+        QSqlQuery query(dbConnection());
+        EXPECT_TRUE(query.exec("SELECT total_changes()"));
+        EXPECT_TRUE(query.next());
+        return query.value(0).toInt();
+    }
+
+    QStringList selectStrings(const QString& statement) {
+        QStringList result;
+        QSqlQuery query(dbConnection());
+        EXPECT_TRUE(query.exec(statement));
+        while (query.next()) {
+            result.append(query.value(0).toString());
+        }
+        return result;
+    }
+};
+
+TEST_F(ITunesDAOTest, importUnchangedLibrary) {
+    auto pDao = makeDAO();
+    EXPECT_FALSE(pDao->isIncremental());
+    importLibrary(pDao.get(), "Two", true);
+    EXPECT_EQ(QStringList({"/Music/One.m4a", "/Music/Two.m4a", "/Music/Three.m4a"}),
+            selectStrings("SELECT location FROM itunes_library ORDER BY id"));
+
+    const int changes = totalChanges();
+    pDao = makeDAO();
+    EXPECT_TRUE(pDao->isIncremental());
+    importLibrary(pDao.get(), "Two", true);
+    EXPECT_EQ(changes, totalChanges());
+}
+
+TEST_F(ITunesDAOTest, importModifiedLibrary) {
+    importLibrary(makeDAO().get(), "Two", true);
+
+    auto pDao = makeDAO();
+    ASSERT_TRUE(pDao->importTrack(makeTrack(1, "One")));
+    ASSERT_TRUE(pDao->importTrack(makeTrack(2, "Two (Remix)")));
+    ASSERT_TRUE(pDao->importTrack(makeTrack(4, "Four")));
+    ASSERT_TRUE(pDao->importPlaylist(ITunesPlaylist{.id = 10, .name = "Folder"}));
+    ASSERT_TRUE(pDao->importPlaylistRelation(kRootITunesPlaylistId, 10));
+    ASSERT_TRUE(pDao->importPlaylist(ITunesPlaylist{.id = 11, .name = "Playlist A"}));
+    ASSERT_TRUE(pDao->importPlaylistTrack(11, 4, 1));
+    ASSERT_TRUE(pDao->importPlaylistRelation(10, 11));
+    ASSERT_TRUE(pDao->finishImport());
+
+    EXPECT_EQ(QStringList({"One", "Two (Remix)", "Four"}),
+            selectStrings("SELECT title FROM itunes_library ORDER BY id"));
+    EXPECT_EQ(QStringList({"Folder", "Playlist A"}),
+            selectStrings("SELECT name FROM itunes_playlists ORDER BY position"));
+    EXPECT_EQ(QStringList({"11:4"}),
+            selectStrings("SELECT playlist_id || ':' || track_id "
+                          "FROM itunes_playlist_tracks ORDER BY position"));
+}
+
+TEST_F(ITunesDAOTest, restorePlaylistTree) {
+    importLibrary(makeDAO().get(), "Two", true);
+
+    ITunesDAO dao;
+    dao.initialize(dbConnection());
+    ASSERT_TRUE(dao.loadPlaylistTree());
+    TreeItem root;
+    dao.appendPlaylistTree(&root);
+
+    ASSERT_EQ(2, root.children().size());
+    EXPECT_EQ("Folder", root.child(0)->getLabel());
+    EXPECT_EQ("Playlist B", root.child(1)->getLabel());
+    ASSERT_EQ(1, root.child(0)->children().size());
+    EXPECT_EQ("Playlist A", root.child(0)->child(0)->getLabel());
+}
+
+} // anonymous namespace
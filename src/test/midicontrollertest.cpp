@@ -1,6 +1,10 @@
+#include <benchmark/benchmark.h>
 #include <gmock/gmock.h>
 
 #include <QScopedPointer>
+#include <chrono>
+#include <memory>
+#include <vector>
 
 #include "control/controlpotmeter.h"
 #include "control/controlpushbutton.h"
@@ -11,6 +15,9 @@
 #include "test/mixxxtest.h"
 #include "util/time.h"
 
+using ::testing::_;
+using ::testing::InSequence;
+
 class MockMidiController : public MidiController {
   public:
     explicit MockMidiController()
@@ -24,7 +31,10 @@ class MockMidiController : public MidiController {
                                     unsigned char byte1,
                                     unsigned char byte2));
     MOCK_METHOD1(sendBytes, void(const QByteArray& data));
-    MOCK_CONST_METHOD0(isPolling, bool());
+
+    using MidiController::flushOutput;
+    using MidiController::queueShortMsg;
+    using MidiController::receivedShortMessage;
 };
 
 class MidiControllerTest : public MixxxTest {
@@ -596,3 +606,187 @@ TEST_F(MidiControllerTest, ReceiveMessage_PotMeterCO_14BitPitchBend) {
     receivedShortMessage(MidiOpCode::PitchBendChange, channel, 0x01, 0x40);
     EXPECT_LT(kMiddleValue, potmeter.get());
 }
+
+TEST_F(MidiControllerTest, ReceiveMessage_ControlCreatedAfterMapping) {
+    ConfigKey key("[Channel1]", "volume");
+    unsigned char channel = 0x01;
+    unsigned char control = 0x10;
+
+    addMapping(MidiInputMapping(
+            MidiKey(MidiUtils::statusFromOpCodeAndChannel(
+                            MidiOpCode::ControlChange, channel),
+                    control),
+            MidiOptions(),
+            key));
+    m_pController->setMapping(m_pMapping->clone());
+
+    // Ignored while the control does not exist
+    receivedShortMessage(MidiOpCode::ControlChange, channel, control, 0x7F);
+
+    {
+        ControlPotmeter potmeter(key, 0.0, 1.0);
+        receivedShortMessage(MidiOpCode::ControlChange, channel, control, 0x7F);
+        EXPECT_DOUBLE_EQ(1.0, potmeter.get());
+    }
+
+    // A control that is created again for the same key is resolved again
+    ControlPotmeter potmeter(key, 0.0, 1.0);
+    receivedShortMessage(MidiOpCode::ControlChange, channel, control, 0x7F);
+    EXPECT_DOUBLE_EQ(1.0, potmeter.get());
+}
+
+TEST_F(MidiControllerTest, QueueShortMsg_CoalescedWithinFrame) {
+    m_pController->setOutputFrameInterval(std::chrono::milliseconds(1000));
+
+    // Nothing is sent before the end of the frame
+    EXPECT_CALL(*m_pController, sendShortMsg(_, _, _)).Times(0);
+    m_pController->queueShortMsg(0xB0, 0x10, 0x01);
+    m_pController->queueShortMsg(0x90, 0x20, 0x7F);
+    m_pController->queueShortMsg(0xB0, 0x10, 0x02);
+    m_pController->queueShortMsg(0xB0, 0x10, 0x03);
+    // Addresses the same note as the note on
+    m_pController->queueShortMsg(0x80, 0x20, 0x00);
+    ::testing::Mock::VerifyAndClearExpectations(m_pController.data());
+
+    {
+        // Only the last message for each address in the order of their
+        // first message
+        InSequence sequence;
+        EXPECT_CALL(*m_pController, sendShortMsg(0xB0, 0x10, 0x03));
+        EXPECT_CALL(*m_pController, sendShortMsg(0x80, 0x20, 0x00));
+    }
+    m_pController->flushOutput();
+    ::testing::Mock::VerifyAndClearExpectations(m_pController.data());
+
+    // Unchanged values are not sent again
+    EXPECT_CALL(*m_pController, sendShortMsg(_, _, _)).Times(0);
+    m_pController->queueShortMsg(0xB0, 0x10, 0x03);
+    m_pController->queueShortMsg(0x90, 0x20, 0x7F);
+    m_pController->queueShortMsg(0x80, 0x20, 0x00);
+    m_pController->flushOutput();
+    ::testing::Mock::VerifyAndClearExpectations(m_pController.data());
+
+    EXPECT_EQ(2u, m_pController->outputSentCount());
+    EXPECT_EQ(6u, m_pController->outputSuppressedCount());
+}
+
+TEST_F(MidiControllerTest, QueueShortMsg_SentImmediatelyWithoutFrameInterval) {
+    // The last message is sent again, e.g. to override LEDs that are toggled
+    // by the device itself
+    EXPECT_CALL(*m_pController, sendShortMsg(0xB0, 0x10, 0x01)).Times(2);
+    m_pController->queueShortMsg(0xB0, 0x10, 0x01);
+    m_pController->queueShortMsg(0xB0, 0x10, 0x01);
+
+    EXPECT_EQ(2u, m_pController->outputSentCount());
+    EXPECT_EQ(0u, m_pController->outputSuppressedCount());
+}
+
+namespace {
+
+constexpr int kBenchmarkDeckCount = 4;
+constexpr unsigned char kBenchmarkJogControl = 0x21;
+constexpr unsigned char kBenchmarkVolumeMsbControl = 0x13;
+constexpr unsigned char kBenchmarkVolumeLsbControl = 0x33;
+/// Buttons and knobs mapped in addition, like in a typical mapping
+constexpr unsigned char kBenchmarkButtonCount = 64;
+
+struct ShortMessage {
+    unsigned char status;
+    unsigned char control;
+    unsigned char value;
+};
+
+/// The messages of high-resolution jog wheels, pitch faders and 14-bit
+/// volume faders of all decks, interleaved like they are received while
+/// scratching on all decks at once.
+std::vector<ShortMessage> makeBenchmarkMessages() {
+    std::vector<ShortMessage> messages;
+    for (int i = 0; i < 1024; ++i) {
+        const unsigned char channel = i % kBenchmarkDeckCount;
+        const unsigned char value = i % 0x80;
+        const unsigned char ccStatus = MidiUtils::statusFromOpCodeAndChannel(
+                MidiOpCode::ControlChange, channel);
+        switch ((i / kBenchmarkDeckCount) % 4) {
+        case 0:
+        case 1:
+            // Relative jog wheel ticks
+            messages.push_back({ccStatus,
+                    kBenchmarkJogControl,
+                    static_cast<unsigned char>((i & 1) ? 0x41 : 0x3F)});
+            break;
+        case 2:
+            messages.push_back({MidiUtils::statusFromOpCodeAndChannel(
+                                        MidiOpCode::PitchBendChange, channel),
+                    value,
+                    0x40});
+            break;
+        default:
+            messages.push_back({ccStatus, kBenchmarkVolumeMsbControl, value});
+            messages.push_back({ccStatus, kBenchmarkVolumeLsbControl, value});
+            break;
+        }
+    }
+    return messages;
+}
+
+} // namespace
+
+static void BM_MidiControllerReceiveShortMessage(benchmark::State& state) {
+    std::vector<std::unique_ptr<ControlObject>> controls;
+    auto pMapping = std::make_shared<LegacyMidiControllerMapping>();
+    const auto addBenchmarkMapping = [&](const MidiInputMapping& mapping) {
+        controls.push_back(std::make_unique<ControlPotmeter>(mapping.control, 0.0, 127.0));
+        pMapping->addInputMapping(mapping.key.key, mapping);
+    };
+    for (unsigned char channel = 0; channel < kBenchmarkDeckCount; ++channel) {
+        const QString group = QStringLiteral("[Channel%1]").arg(channel + 1);
+        const unsigned char ccStatus = MidiUtils::statusFromOpCodeAndChannel(
+                MidiOpCode::ControlChange, channel);
+        MidiOptions jogOptions;
+        jogOptions.setFlag(MidiOption::Diff);
+        addBenchmarkMapping(MidiInputMapping(MidiKey(ccStatus, kBenchmarkJogControl),
+                jogOptions,
+                ConfigKey(group, QStringLiteral("jog"))));
+        addBenchmarkMapping(MidiInputMapping(
+                MidiKey(MidiUtils::statusFromOpCodeAndChannel(
+                                MidiOpCode::PitchBendChange, channel),
+                        0xFF),
+                MidiOptions(),
+                ConfigKey(group, QStringLiteral("rate"))));
+        MidiOptions msbOptions;
+        msbOptions.setFlag(MidiOption::FourteenBitMSB);
+        addBenchmarkMapping(MidiInputMapping(MidiKey(ccStatus, kBenchmarkVolumeMsbControl),
+                msbOptions,
+                ConfigKey(group, QStringLiteral("volume"))));
+        MidiOptions lsbOptions;
+        lsbOptions.setFlag(MidiOption::FourteenBitLSB);
+        // The control already exists
+        pMapping->addInputMapping(MidiKey(ccStatus, kBenchmarkVolumeLsbControl).key,
+                MidiInputMapping(MidiKey(ccStatus, kBenchmarkVolumeLsbControl),
+                        lsbOptions,
+                        ConfigKey(group, QStringLiteral("volume"))));
+        for (unsigned char button = 0; button < kBenchmarkButtonCount; ++button) {
+            const MidiKey key(MidiUtils::statusFromOpCodeAndChannel(
+                                      MidiOpCode::NoteOn, channel),
+                    button);
+            MidiOptions buttonOptions;
+            buttonOptions.setFlag(MidiOption::Button);
+            addBenchmarkMapping(MidiInputMapping(key,
+                    buttonOptions,
+                    ConfigKey(group, QStringLiteral("button_%1").arg(button))));
+        }
+    }
+
+    MockMidiController controller;
+    controller.setMapping(pMapping);
+    const auto messages = makeBenchmarkMessages();
+    const auto timestamp = mixxx::Time::elapsed();
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const ShortMessage& message = messages[i++ % messages.size()];
+        controller.receivedShortMessage(
+                message.status, message.control, message.value, timestamp);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MidiControllerReceiveShortMessage);
@@ -1,6 +1,10 @@
+#include <benchmark/benchmark.h>
+
+#include "engine/filters/enginefilteroversampler.h"
+#include "util/samplebuffer.h"
+
 #if 0
 // TODO: make this work again
-#include <benchmark/benchmark.h>
 #include <gtest/gtest.h>
 
 #include "control/controlpotmeter.h"
@@ -19,10 +23,45 @@
 #include "engine/channelhandle.h"
 #include "engine/effects/groupfeaturestate.h"
 #include "test/baseeffecttest.h"
-#include "util/samplebuffer.h"
+#endif
 
 namespace {
 
+// Measures the overhead of the oversampling that the Distortion and the
+// Bitcrusher effects use to suppress aliasing.
+// Args: oversampling factor, buffer size in samples
+void BM_EngineFilterOversampler_HardClip(benchmark::State& state) {
+    const int factor = static_cast<int>(state.range(0));
+    const SINT numSamples = static_cast<SINT>(state.range(1));
+
+    EngineFilterOversampler oversampler;
+    oversampler.setFactor(factor);
+    mixxx::SampleBuffer buffer(numSamples);
+    for (SINT i = 0; i < numSamples; ++i) {
+        buffer[i] = static_cast<CSAMPLE>(i % 100) / 50 - 1;
+    }
+
+    for (auto _ : state) {
+        oversampler.process(buffer.data(),
+                buffer.data(),
+                numSamples,
+                [](CSAMPLE* pSamples, SINT numOversampledSamples) {
+                    for (SINT i = 0; i < numOversampledSamples; ++i) {
+                        pSamples[i] = CSAMPLE_clamp(pSamples[i] * 4);
+                    }
+                });
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.SetItemsProcessed(state.iterations() * numSamples);
+}
+BENCHMARK(BM_EngineFilterOversampler_HardClip)
+        ->Args({1, 1024})
+        ->Args({2, 1024})
+        ->Args({4, 1024})
+        ->Args({8, 1024})
+        ->Args({8, 4096});
+
+#if 0
 class EffectsBenchmarkTest : public BaseEffectTest {
   protected:
     void SetUp() override {
@@ -91,6 +130,6 @@ DECLARE_EFFECT_BENCHMARK(LinkwitzRiley8EQEffect)
 DECLARE_EFFECT_BENCHMARK(MoogLadder4FilterEffect)
 DECLARE_EFFECT_BENCHMARK(PhaserEffect)
 DECLARE_EFFECT_BENCHMARK(ReverbEffect)
+#endif
 
 }  // namespace
-#endif
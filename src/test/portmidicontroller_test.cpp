@@ -9,6 +9,7 @@
 
 using ::testing::_;
 using ::testing::DoAll;
+using ::testing::Invoke;
 using ::testing::NotNull;
 using ::testing::Return;
 using ::testing::Sequence;
@@ -36,6 +37,14 @@ class MockPortMidiController : public PortMidiController {
         PortMidiController::sendSysexMsg(data, length);
     }
 
+    void queueShortMsg(unsigned char status, unsigned char byte1, unsigned char byte2) {
+        PortMidiController::queueShortMsg(status, byte1, byte2);
+    }
+
+    void flushOutput() {
+        PortMidiController::flushOutput();
+    }
+
     MOCK_METHOD4(receivedShortMessage,
             void(unsigned char, unsigned char, unsigned char, mixxx::Duration));
     MOCK_METHOD2(receive, void(const QByteArray&, mixxx::Duration));
@@ -58,6 +67,7 @@ class MockPortMidiDevice : public PortMidiDevice {
     MOCK_METHOD0(poll, PmError());
     MOCK_METHOD2(read, int(PmEvent*, int32_t));
     MOCK_METHOD1(writeShort, PmError(int32_t));
+    MOCK_METHOD2(write, PmError(PmEvent*, int32_t));
     MOCK_METHOD1(writeSysEx, PmError(unsigned char*));
 };
 
@@ -179,6 +189,32 @@ TEST_F(PortMidiControllerTest, WriteShort) {
     m_pController->sendShortMsg(0x80, 0x3C, 0x40);
 };
 
+TEST_F(PortMidiControllerTest, WriteQueuedShortMessagesAtOnce) {
+    m_pController->setOutputFrameInterval(std::chrono::milliseconds(10));
+
+    std::vector<PmMessage> messages;
+    EXPECT_CALL(*m_mockOutput, isOpen())
+            .WillRepeatedly(Return(true));
+    EXPECT_CALL(*m_mockOutput, writeShort(_))
+            .Times(0);
+    EXPECT_CALL(*m_mockOutput, write(NotNull(), 2))
+            .WillOnce(Invoke([&messages](PmEvent* pEvents, int32_t length) {
+                for (int32_t i = 0; i < length; ++i) {
+                    messages.push_back(pEvents[i].message);
+                }
+                return pmNoError;
+            }));
+
+    m_pController->queueShortMsg(0x90, 0x3C, 0x40);
+    m_pController->queueShortMsg(0xB0, 0x07, 0x10);
+    m_pController->queueShortMsg(0xB0, 0x07, 0x20);
+    // Supersedes the note on message for the same note
+    m_pController->queueShortMsg(0x80, 0x3C, 0x00);
+    m_pController->flushOutput();
+
+    EXPECT_EQ((std::vector<PmMessage>{0x003C80, 0x2007B0}), messages);
+};
+
 TEST_F(PortMidiControllerTest, WriteSysex) {
     QList<int> sysex;
     sysex.append(0xF0);
@@ -0,0 +1,133 @@
+#include "engine/positionscratchcontroller.h"
+
+#include <gtest/gtest.h>
+
+#include <QList>
+#include <memory>
+
+#include "control/controlobject.h"
+#include "test/mixxxtest.h"
+#include "util/inputtimestamp.h"
+#include "util/time.h"
+
+class PositionScratchControllerTest : public MixxxTest {
+  protected:
+    static constexpr int kMaxJogEvents = PositionScratchController::kMaxJogEvents;
+
+    PositionScratchControllerTest()
+            : m_pSampleRate(std::make_unique<ControlObject>(
+                      ConfigKey("[Master]", "samplerate"))),
+              m_pController(std::make_unique<PositionScratchController>(
+                      QStringLiteral("[Channel1]"))) {
+        m_pSampleRate->set(44100);
+    }
+
+    void SetUp() override {
+        mixxx::Time::setTestMode(true);
+        setTime(1000);
+        m_pController->resetJogTrajectory(mixxx::Time::elapsed());
+    }
+
+    void TearDown() override {
+        mixxx::Time::setTestMode(false);
+    }
+
+    static void setTime(qint64 millis) {
+        mixxx::Time::setTestElapsedTime(mixxx::Duration::fromMillis(millis));
+    }
+
+    /// Sets the position like a widget or a controller would do
+    static void setScratchPosition(double position) {
+        ControlObject::set(ConfigKey("[Channel1]", "scratch_position"), position);
+    }
+
+    double interpolate(qint64 millis) {
+        m_pController->receiveJogEvents();
+        return m_pController->interpolateScratchPosition(
+                mixxx::Duration::fromMillis(millis));
+    }
+
+    int jogTrajectorySize() const {
+        return m_pController->m_jogTrajectorySize;
+    }
+
+    std::unique_ptr<ControlObject> m_pSampleRate;
+    std::unique_ptr<PositionScratchController> m_pController;
+};
+
+TEST_F(PositionScratchControllerTest, interpolateBetweenJogEvents) {
+    setTime(1010);
+    setScratchPosition(10);
+    setTime(1020);
+    setScratchPosition(30);
+
+    EXPECT_DOUBLE_EQ(0, interpolate(1000));
+    EXPECT_DOUBLE_EQ(5, interpolate(1005));
+    EXPECT_DOUBLE_EQ(20, interpolate(1015));
+    EXPECT_DOUBLE_EQ(30, interpolate(1020));
+    // Hold the last position
+    EXPECT_DOUBLE_EQ(30, interpolate(1100));
+    EXPECT_EQ(1, jogTrajectorySize());
+}
+
+TEST_F(PositionScratchControllerTest, useInputTimestamps) {
+    // Both positions are processed at once, but have been received
+    // 10 ms apart
+    setTime(1050);
+    {
+        const mixxx::InputTimestamp::Scope timestampScope(
+                mixxx::Duration::fromMillis(1030));
+        setScratchPosition(10);
+    }
+    {
+        const mixxx::InputTimestamp::Scope timestampScope(
+                mixxx::Duration::fromMillis(1040));
+        setScratchPosition(20);
+    }
+
+    EXPECT_DOUBLE_EQ(10, interpolate(1030));
+    EXPECT_DOUBLE_EQ(15, interpolate(1035));
+    EXPECT_DOUBLE_EQ(20, interpolate(1040));
+}
+
+TEST_F(PositionScratchControllerTest, dropOldestJogEventsOnOverflow) {
+    // More events than fit into the FIFO, the excess is dropped
+    for (int i = 1; i <= 2 * kMaxJogEvents; ++i) {
+        setTime(1000 + i);
+        setScratchPosition(i);
+    }
+    // The initial position is dropped to make room for the received events
+    EXPECT_DOUBLE_EQ(1, interpolate(1000));
+    EXPECT_EQ(kMaxJogEvents, jogTrajectorySize());
+    EXPECT_DOUBLE_EQ(kMaxJogEvents, interpolate(1000 + kMaxJogEvents));
+    EXPECT_EQ(1, jogTrajectorySize());
+
+    // Not affected by the dropped events
+    setTime(2000);
+    setScratchPosition(-1);
+    EXPECT_DOUBLE_EQ(-1, interpolate(2000));
+}
+
+TEST_F(PositionScratchControllerTest, updateRateEveryCallback) {
+    // Buffers longer than the former 16 ms sampling window of the jog
+    // events, i.e. every callback needs to follow the jog events
+    constexpr int kBufferSize = 2048;
+    const double dt = static_cast<double>(kBufferSize) / m_pSampleRate->get() / 2;
+    ControlObject::set(ConfigKey("[Channel1]", "scratch_position_enable"), 1);
+
+    double currentSample = 0;
+    QList<double> rates;
+    for (int i = 0; i < 12; ++i) {
+        const auto now = mixxx::Duration::fromMillis(1000) +
+                mixxx::Duration::fromSeconds(i * dt);
+        mixxx::Time::setTestElapsedTime(now);
+        // Accelerating, so the rate never settles
+        setScratchPosition(100.0 * i * i);
+        m_pController->process(currentSample, 0, kBufferSize, 1);
+        rates.append(m_pController->getRate());
+        currentSample += m_pController->getRate() * kBufferSize;
+    }
+    for (int i = 3; i < rates.size(); ++i) {
+        EXPECT_NE(rates[i - 1], rates[i]) << "callback " << i;
+    }
+}
@@ -0,0 +1,488 @@
+#include "library/rekordbox/rekordboxpdbimporter.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <QtEndian>
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "library/rekordbox/rekordboxconstants.h"
+#include "library/treeitem.h"
+#include "test/mixxxdbtest.h"
+#include "util/assert.h"
+
+namespace {
+
+constexpr int kPageSize = 4096;
+constexpr int kPageHeaderSize = 40;
+constexpr int kRowGroupSize = 36;
+constexpr int kRowsPerGroup = 16;
+
+constexpr uint32_t kPageTypeTracks = 0;
+constexpr uint32_t kPageTypeGenres = 1;
+constexpr uint32_t kPageTypeArtists = 2;
+constexpr uint32_t kPageTypeAlbums = 3;
+constexpr uint32_t kPageTypeKeys = 5;
+constexpr uint32_t kPageTypePlaylistTree = 7;
+constexpr uint32_t kPageTypePlaylistEntries = 8;
+
+const QString kDevice = QStringLiteral("USB");
+
+void appendU1(std::string* pRow, uint8_t value) {
+    pRow->push_back(static_cast<char>(value));
+}
+
+void appendU2(std::string* pRow, uint16_t value) {
+    char bytes[2];
+    qToLittleEndian(value, bytes);
+    pRow->append(bytes, sizeof(bytes));
+}
+
+void appendU4(std::string* pRow, uint32_t value) {
+    char bytes[4];
+    qToLittleEndian(value, bytes);
+    pRow->append(bytes, sizeof(bytes));
+}
+
+/// A short ASCII string in the DeviceSQL format
+void appendString(std::string* pRow, const std::string& text) {
+    DEBUG_ASSERT(text.size() < 127);
+    appendU1(pRow, static_cast<uint8_t>(2 * text.size() + 3));
+    pRow->append(text);
+}
+
+/// Generates a synthetic export.pdb file with all tables that are
+/// imported. Rows are distributed across as many pages as needed.
+class PdbFileGenerator {
+  public:
+    void addKey(uint32_t id, const std::string& name) {
+        std::string row;
+        appendU4(&row, id);
+        appendU4(&row, id);
+        appendString(&row, name);
+        m_rows[kPageTypeKeys].push_back(std::move(row));
+    }
+
+    void addGenre(uint32_t id, const std::string& name) {
+        std::string row;
+        appendU4(&row, id);
+        appendString(&row, name);
+        m_rows[kPageTypeGenres].push_back(std::move(row));
+    }
+
+    void addArtist(uint32_t id, const std::string& name) {
+        std::string row;
+        appendU2(&row, 0x60);
+        appendU2(&row, 0);
+        appendU4(&row, id);
+        appendU1(&row, 3);
+        appendU1(&row, 10); // offset of the name
+        appendString(&row, name);
+        m_rows[kPageTypeArtists].push_back(std::move(row));
+    }
+
+    void addAlbum(uint32_t id, const std::string& name) {
+        std::string row;
+        appendU2(&row, 0x80);
+        appendU2(&row, 0);
+        appendU4(&row, 0);
+        appendU4(&row, 0);
+        appendU4(&row, id);
+        appendU4(&row, 0);
+        appendU1(&row, 3);
+        appendU1(&row, 22); // offset of the name
+        appendString(&row, name);
+        m_rows[kPageTypeAlbums].push_back(std::move(row));
+    }
+
+    void addTrack(
+            uint32_t id,
+            uint32_t artistId,
+            uint32_t albumId,
+            uint32_t genreId,
+            uint32_t keyId,
+            const std::string& title) {
+        std::string row;
+        appendU2(&row, 0x24);
+        appendU2(&row, 0);
+        appendU4(&row, 0);
+        appendU4(&row, 44100);     // sample rate
+        appendU4(&row, 0);         // composer
+        appendU4(&row, 1000000);   // file size
+        appendU4(&row, 0);
+        appendU2(&row, 0);
+        appendU2(&row, 0);
+        appendU4(&row, 0);         // artwork
+        appendU4(&row, keyId);
+        appendU4(&row, 0);         // original artist
+        appendU4(&row, 0);         // label
+        appendU4(&row, 0);         // remixer
+        appendU4(&row, 320);       // bitrate
+        appendU4(&row, id);        // track number
+        appendU4(&row, 12800);     // tempo
+        appendU4(&row, genreId);
+        appendU4(&row, albumId);
+        appendU4(&row, artistId);
+        appendU4(&row, id);
+        appendU2(&row, 1);         // disc number
+        appendU2(&row, 0);         // play count
+        appendU2(&row, 2021);      // year
+        appendU2(&row, 16);        // sample depth
+        appendU2(&row, 300);       // duration
+        appendU2(&row, 0x29);
+        appendU1(&row, 1);         // color
+        appendU1(&row, 3);         // rating
+        appendU2(&row, 1);
+        appendU2(&row, 3);
+        constexpr int kFixedSize = 136;
+        const int ofsStringsPos = static_cast<int>(row.size());
+        row.resize(kFixedSize);
+
+        std::vector<uint16_t> ofsStrings(21);
+        const auto appendStringAt = [&row, &ofsStrings](int index, const std::string& text) {
+            ofsStrings[index] = static_cast<uint16_t>(row.size());
+            appendString(&row, text);
+        };
+        const std::string idText = std::to_string(id);
+        // All unused strings refer to a common empty string
+        appendStringAt(0, std::string());
+        std::fill(ofsStrings.begin(), ofsStrings.end(), ofsStrings[0]);
+        appendStringAt(14, "/PIONEER/USBANLZ/P000/" + idText + "/ANLZ0000.DAT");
+        appendStringAt(16, "Comment " + idText);
+        appendStringAt(17, title);
+        appendStringAt(20, "/Contents/" + idText + ".mp3");
+        for (int i = 0; i < 21; ++i) {
+            qToLittleEndian(ofsStrings[i], &row[ofsStringsPos + 2 * i]);
+        }
+        m_rows[kPageTypeTracks].push_back(std::move(row));
+    }
+
+    void addPlaylistTreeNode(
+            uint32_t id,
+            uint32_t parentId,
+            uint32_t sortOrder,
+            bool isFolder,
+            const std::string& name) {
+        std::string row;
+        appendU4(&row, parentId);
+        appendU4(&row, 0);
+        appendU4(&row, sortOrder);
+        appendU4(&row, id);
+        appendU4(&row, isFolder ? 1 : 0);
+        appendString(&row, name);
+        m_rows[kPageTypePlaylistTree].push_back(std::move(row));
+    }
+
+    void addPlaylistEntry(uint32_t playlistId, uint32_t entryIndex, uint32_t trackId) {
+        std::string row;
+        appendU4(&row, entryIndex);
+        appendU4(&row, trackId);
+        appendU4(&row, playlistId);
+        m_rows[kPageTypePlaylistEntries].push_back(std::move(row));
+    }
+
+    bool write(const QString& filePath) const {
+        // The first page contains the file header
+        std::vector<std::string> pages(1);
+        struct Table {
+            uint32_t type;
+            uint32_t firstPage;
+            uint32_t lastPage;
+        };
+        std::vector<Table> tables;
+        for (const auto& [type, rows] : m_rows) {
+            const auto firstPage = static_cast<uint32_t>(pages.size());
+            std::size_t rowIndex = 0;
+            while (rowIndex < rows.size()) {
+                pages.push_back(makePage(
+                        static_cast<uint32_t>(pages.size()), type, rows, &rowIndex));
+            }
+            const auto lastPage = static_cast<uint32_t>(pages.size() - 1);
+            // Link the pages of each table
+            for (uint32_t index = firstPage; index < lastPage; ++index) {
+                qToLittleEndian(index + 1, &pages[index][12]);
+            }
+            tables.push_back(Table{type, firstPage, lastPage});
+        }
+
+        std::string header;
+        appendU4(&header, 0);
+        appendU4(&header, kPageSize);
+        appendU4(&header, static_cast<uint32_t>(tables.size()));
+        appendU4(&header, static_cast<uint32_t>(pages.size()));
+        appendU4(&header, 5);
+        appendU4(&header, 1); // sequence
+        appendU4(&header, 0);
+        for (const auto& table : tables) {
+            appendU4(&header, table.type);
+            appendU4(&header, 0);
+            appendU4(&header, table.firstPage);
+            appendU4(&header, table.lastPage);
+        }
+        header.resize(kPageSize);
+        pages[0] = std::move(header);
+
+        QFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly)) {
+            return false;
+        }
+        for (const auto& page : pages) {
+            if (file.write(page.data(), page.size()) != static_cast<qint64>(page.size())) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+  private:
+    static std::string makePage(
+            uint32_t pageIndex,
+            uint32_t type,
+            const std::vector<std::string>& rows,
+            std::size_t* pRowIndex) {
+        std::string page(kPageSize, '\0');
+        qToLittleEndian(pageIndex, &page[4]);
+        qToLittleEndian(type, &page[8]);
+        int heapPos = kPageHeaderSize;
+        int numRows = 0;
+        while (*pRowIndex < rows.size()) {
+            const std::string& row = rows[*pRowIndex];
+            const int numGroups = numRows / kRowsPerGroup + 1;
+            if (heapPos + static_cast<int>(row.size()) >
+                    kPageSize - numGroups * kRowGroupSize) {
+                break;
+            }
+            const int groupBase = kPageSize - (numRows / kRowsPerGroup) * kRowGroupSize;
+            const int indexInGroup = numRows % kRowsPerGroup;
+            qToLittleEndian(static_cast<uint16_t>(heapPos - kPageHeaderSize),
+                    &page[groupBase - 6 - 2 * indexInGroup]);
+            const auto presentFlags = qFromLittleEndian<uint16_t>(&page[groupBase - 4]);
+            qToLittleEndian(static_cast<uint16_t>(presentFlags | (1 << indexInGroup)),
+                    &page[groupBase - 4]);
+            std::copy(row.begin(), row.end(), page.begin() + heapPos);
+            heapPos += static_cast<int>(row.size());
+            ++numRows;
+            ++*pRowIndex;
+        }
+        DEBUG_ASSERT(numRows > 0);
+        page[24] = static_cast<char>(numRows & 0xff);
+        page[27] = 0x24; // data page
+        qToLittleEndian(static_cast<uint16_t>(numRows), &page[34]);
+        return page;
+    }
+
+    // Ordered by page type
+    std::map<uint32_t, std::vector<std::string>> m_rows;
+};
+
+/// All tracks are contained in a single playlist within
+/// a folder and every second track in another playlist.
+PdbFileGenerator generatePdbFile(int trackCount) {
+    PdbFileGenerator generator;
+    constexpr int kLookupCount = 100;
+    for (int i = 1; i <= kLookupCount; ++i) {
+        const std::string text = std::to_string(i);
+        generator.addKey(i, std::to_string(i % 12 + 1) + "A");
+        generator.addGenre(i, "Genre " + text);
+        generator.addArtist(i, "Artist " + text);
+        generator.addAlbum(i, "Album " + text);
+    }
+    for (int i = 1; i <= trackCount; ++i) {
+        const int lookupId = (i - 1) % kLookupCount + 1;
+        generator.addTrack(i, lookupId, lookupId, lookupId, lookupId, "Title " + std::to_string(i));
+    }
+    generator.addPlaylistTreeNode(1, 0, 0, true, "Folder");
+    generator.addPlaylistTreeNode(2, 1, 0, false, "All");
+    generator.addPlaylistTreeNode(3, 0, 1, false, "Odd");
+    for (int i = 1; i <= trackCount; ++i) {
+        generator.addPlaylistEntry(2, i, i);
+        if (i % 2 == 1) {
+            generator.addPlaylistEntry(3, (i + 1) / 2, i);
+        }
+    }
+    return generator;
+}
+
+int countRows(const QSqlDatabase& database, const QString& tableName) {
+    QSqlQuery query(database);
+    if (!query.exec("SELECT COUNT(*) FROM " + tableName) || !query.next()) {
+        return -1;
+    }
+    return query.value(0).toInt();
+}
+
+} // anonymous namespace
+
+class RekordboxPdbImporterTest : public MixxxDbTest {
+  protected:
+    static constexpr int kTrackCount = 500;
+
+    RekordboxPdbImporterTest()
+            : m_pdbPath(getTestDir().filePath(QStringLiteral("export.pdb"))),
+              m_devicePath(getTestDir().path()) {
+    }
+
+    void SetUp() override {
+        ASSERT_TRUE(generatePdbFile(kTrackCount).write(m_pdbPath));
+        QSqlDatabase database = dbConnection();
+        ASSERT_TRUE(RekordboxPdbImporter::createTables(database));
+    }
+
+    void TearDown() override {
+        QSqlDatabase database = dbConnection();
+        RekordboxPdbImporter::dropTables(database);
+    }
+
+    void expectEmptyTables() {
+        EXPECT_EQ(0, countRows(dbConnection(),
+                             mixxx::rekordboxconstants::kRekordboxLibraryTable));
+        EXPECT_EQ(0, countRows(dbConnection(),
+                             mixxx::rekordboxconstants::kRekordboxPlaylistsTable));
+        EXPECT_EQ(0, countRows(dbConnection(),
+                             mixxx::rekordboxconstants::kRekordboxPlaylistTracksTable));
+    }
+
+    const QString m_pdbPath;
+    const QString m_devicePath;
+};
+
+TEST_F(RekordboxPdbImporterTest, importTracksAndPlaylists) {
+    RekordboxPdbImporter importer(kDevice, m_devicePath);
+    // Spread the import across multiple transactions
+    importer.setBatchSize(64);
+    int lastProcessedPages = 0;
+    int lastTotalPages = 0;
+    importer.setProgressCallback([&](int processedPages, int totalPages) {
+        EXPECT_LE(lastProcessedPages, processedPages);
+        EXPECT_LE(processedPages, totalPages);
+        lastProcessedPages = processedPages;
+        lastTotalPages = totalPages;
+    });
+
+    TreeItem deviceItem(kDevice);
+    const auto result = importer.importPdb(dbConnection(), m_pdbPath, &deviceItem);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(kTrackCount, result->trackCount);
+    EXPECT_EQ(3, result->playlistCount);
+    EXPECT_LT(1, lastProcessedPages);
+    EXPECT_EQ(lastProcessedPages, lastTotalPages);
+
+    EXPECT_EQ(kTrackCount,
+            countRows(dbConnection(), mixxx::rekordboxconstants::kRekordboxLibraryTable));
+    // The device playlist and a playlist for each node including the folder
+    EXPECT_EQ(4,
+            countRows(dbConnection(), mixxx::rekordboxconstants::kRekordboxPlaylistsTable));
+    EXPECT_EQ(kTrackCount + kTrackCount + kTrackCount / 2,
+            countRows(dbConnection(),
+                    mixxx::rekordboxconstants::kRekordboxPlaylistTracksTable));
+
+    QSqlQuery query(dbConnection());
+    query.prepare("SELECT artist, title, album, genre, key, location, bpm FROM " +
+            mixxx::rekordboxconstants::kRekordboxLibraryTable +
+            " WHERE rb_id=:rb_id");
+    query.bindValue(":rb_id", 123);
+    ASSERT_TRUE(query.exec());
+    ASSERT_TRUE(query.next());
+    EXPECT_EQ(QStringLiteral("Artist 23"), query.value(0).toString());
+    EXPECT_EQ(QStringLiteral("Title 123"), query.value(1).toString());
+    EXPECT_EQ(QStringLiteral("Album 23"), query.value(2).toString());
+    EXPECT_EQ(QStringLiteral("Genre 23"), query.value(3).toString());
+    EXPECT_EQ(QStringLiteral("12A"), query.value(4).toString());
+    EXPECT_EQ(m_devicePath + QStringLiteral("/Contents/123.mp3"), query.value(5).toString());
+    EXPECT_DOUBLE_EQ(128.0, query.value(6).toDouble());
+
+    // Playlist tracks refer to the imported tracks in order
+    query.prepare("SELECT " + mixxx::rekordboxconstants::kRekordboxLibraryTable +
+            ".rb_id FROM " +
+            mixxx::rekordboxconstants::kRekordboxPlaylistTracksTable + " JOIN " +
+            mixxx::rekordboxconstants::kRekordboxPlaylistsTable + " ON playlist_id=" +
+            mixxx::rekordboxconstants::kRekordboxPlaylistsTable + ".id JOIN " +
+            mixxx::rekordboxconstants::kRekordboxLibraryTable + " ON track_id=" +
+            mixxx::rekordboxconstants::kRekordboxLibraryTable + ".id WHERE name=:name" +
+            " ORDER BY position");
+    query.bindValue(":name",
+            m_devicePath + mixxx::rekordboxconstants::kPLaylistPathDelimiter + "Odd");
+    ASSERT_TRUE(query.exec());
+    for (int rbId = 1; rbId <= kTrackCount; rbId += 2) {
+        ASSERT_TRUE(query.next());
+        EXPECT_EQ(rbId, query.value(0).toInt());
+    }
+    EXPECT_FALSE(query.next());
+
+    ASSERT_EQ(2, deviceItem.childRows());
+    EXPECT_EQ(QStringLiteral("Folder"), deviceItem.child(0)->getLabel());
+    ASSERT_EQ(1, deviceItem.child(0)->childRows());
+    EXPECT_EQ(QStringLiteral("All"), deviceItem.child(0)->child(0)->getLabel());
+    EXPECT_EQ(QStringLiteral("Odd"), deviceItem.child(1)->getLabel());
+
+    QSqlDatabase database = dbConnection();
+    EXPECT_TRUE(RekordboxPdbImporter::clearDevice(database, kDevice, m_devicePath));
+    expectEmptyTables();
+}
+
+TEST_F(RekordboxPdbImporterTest, cancelImport) {
+    RekordboxPdbImporter importer(kDevice, m_devicePath);
+    // Some tracks have already been committed when canceled
+    importer.setBatchSize(1);
+    importer.setProgressCallback([&](int processedPages, int totalPages) {
+        Q_UNUSED(processedPages);
+        Q_UNUSED(totalPages);
+        if (countRows(dbConnection(),
+                    mixxx::rekordboxconstants::kRekordboxLibraryTable) > 0) {
+            importer.cancel();
+        }
+    });
+
+    EXPECT_FALSE(importer.importPdb(dbConnection(), m_pdbPath, nullptr));
+    EXPECT_TRUE(importer.isCanceled());
+    expectEmptyTables();
+}
+
+TEST_F(RekordboxPdbImporterTest, importCorruptFile) {
+    QFile file(m_pdbPath);
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    // Truncate the last pages
+    ASSERT_TRUE(file.resize(file.size() - 3 * kPageSize));
+    file.close();
+
+    RekordboxPdbImporter importer(kDevice, m_devicePath);
+    importer.setBatchSize(1);
+    EXPECT_FALSE(importer.importPdb(dbConnection(), m_pdbPath, nullptr));
+    expectEmptyTables();
+}
+
+static void BM_RekordboxPdbImporter_Import(benchmark::State& state) {
+    QTemporaryDir tempDir;
+    const QString pdbPath = tempDir.filePath(QStringLiteral("export.pdb"));
+    if (!generatePdbFile(static_cast<int>(state.range(0))).write(pdbPath)) {
+        state.SkipWithError("Failed to generate PDB file");
+        return;
+    }
+    const QString connectionName = QStringLiteral("BM_RekordboxPdbImporter_Import");
+    {
+        QSqlDatabase database = QSqlDatabase::addDatabase(
+                QStringLiteral("QSQLITE"), connectionName);
+        database.setDatabaseName(QStringLiteral(":memory:"));
+        if (!database.open()) {
+            state.SkipWithError("Failed to open database");
+            return;
+        }
+        for (auto _ : state) {
+            state.PauseTiming();
+            RekordboxPdbImporter::dropTables(database);
+            RekordboxPdbImporter::createTables(database);
+            state.ResumeTiming();
+            RekordboxPdbImporter importer(kDevice, tempDir.path());
+            benchmark::DoNotOptimize(importer.importPdb(database, pdbPath, nullptr));
+        }
+        database.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RekordboxPdbImporter_Import)->Range(1 << 10, 1 << 14);
@@ -1,3 +1,4 @@
+#include <benchmark/benchmark.h>
 #include <gtest/gtest.h>
 
 #include <QDir>
@@ -18,6 +19,34 @@ bool dumpToFile(const QString& filename, const QByteArray& data) {
     return data.size() == outfile.write(data);
 }
 
+struct Markers2Fixture {
+    QByteArray data;
+    mixxx::taglib::FileType fileType;
+};
+
+QList<Markers2Fixture> readMarkers2Fixtures() {
+    const QList<std::pair<QString, mixxx::taglib::FileType>> dirs = {
+            {QStringLiteral("serato/data/mp3/markers2/"), mixxx::taglib::FileType::MP3},
+            {QStringLiteral("serato/data/mp4/markers2/"), mixxx::taglib::FileType::MP4},
+            {QStringLiteral("serato/data/flac/markers2/"), mixxx::taglib::FileType::FLAC},
+            {QStringLiteral("serato/data/ogg/markers2/"), mixxx::taglib::FileType::OGG},
+    };
+    QList<Markers2Fixture> fixtures;
+    for (const auto& [path, fileType] : dirs) {
+        QDir dir(MixxxTest::getOrInitTestDir().filePath(path));
+        dir.setFilter(QDir::Files);
+        dir.setNameFilters(QStringList() << "*.octet-stream");
+        const QFileInfoList fileList = dir.entryInfoList();
+        for (const QFileInfo& fileInfo : fileList) {
+            QFile file(fileInfo.filePath());
+            if (file.open(QIODevice::ReadOnly)) {
+                fixtures.append(Markers2Fixture{file.readAll(), fileType});
+            }
+        }
+    }
+    return fixtures;
+}
+
 } // namespace
 
 class SeratoTagsTest : public testing::Test {
@@ -341,3 +370,67 @@ TEST_F(SeratoTagsTest, Markers2RoundTrip) {
         }
     }
 }
+
+TEST_F(SeratoTagsTest, Markers2LazyParsing) {
+    const QList<Markers2Fixture> fixtures = readMarkers2Fixtures();
+    ASSERT_FALSE(fixtures.isEmpty());
+    for (const auto& fixture : fixtures) {
+        mixxx::SeratoTags seratoTags;
+        EXPECT_TRUE(seratoTags.parseMarkers2(fixture.data, fixture.fileType));
+        EXPECT_EQ(fixture.data.isEmpty(), seratoTags.isEmpty());
+
+        // Unmodified tags are compared and written back without decoding
+        const mixxx::SeratoTags copiedTags = seratoTags;
+        EXPECT_EQ(seratoTags, copiedTags);
+        EXPECT_EQ(fixture.data, seratoTags.dumpMarkers2(fixture.fileType));
+
+        // Decoding on first access
+        EXPECT_NE(mixxx::SeratoTags::ParserStatus::Failed, seratoTags.status());
+        EXPECT_EQ(copiedTags.getCueInfos(), seratoTags.getCueInfos());
+        EXPECT_EQ(seratoTags, copiedTags);
+    }
+}
+
+TEST_F(SeratoTagsTest, Markers2LazyParsingInvalidData) {
+    mixxx::SeratoTags seratoTags;
+    EXPECT_TRUE(seratoTags.parseMarkers2(
+            QByteArrayLiteral("invalid"), mixxx::taglib::FileType::MP3));
+    EXPECT_EQ(mixxx::SeratoTags::ParserStatus::Failed, seratoTags.status());
+    EXPECT_TRUE(seratoTags.getCueInfos().isEmpty());
+}
+
+namespace {
+
+/// Stores the tags and compares them with a copy, like when copying and
+/// comparing TrackMetadata. Doesn't include the decoding on import, see
+/// BM_SeratoTagsDecodeMarkers2.
+static void BM_SeratoTagsCopyAndCompareMarkers2(benchmark::State& state) {
+    const QList<Markers2Fixture> fixtures = readMarkers2Fixtures();
+    for (auto _ : state) {
+        for (const auto& fixture : fixtures) {
+            mixxx::SeratoTags seratoTags;
+            seratoTags.parseMarkers2(fixture.data, fixture.fileType);
+            const mixxx::SeratoTags copiedTags = seratoTags;
+            benchmark::DoNotOptimize(copiedTags == seratoTags);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * fixtures.size());
+}
+BENCHMARK(BM_SeratoTagsCopyAndCompareMarkers2);
+
+/// Stores the tags and decodes the cues like when importing the metadata of
+/// a track.
+static void BM_SeratoTagsDecodeMarkers2(benchmark::State& state) {
+    const QList<Markers2Fixture> fixtures = readMarkers2Fixtures();
+    for (auto _ : state) {
+        for (const auto& fixture : fixtures) {
+            mixxx::SeratoTags seratoTags;
+            seratoTags.parseMarkers2(fixture.data, fixture.fileType);
+            benchmark::DoNotOptimize(seratoTags.getCueInfos());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * fixtures.size());
+}
+BENCHMARK(BM_SeratoTagsDecodeMarkers2);
+
+} // namespace
@@ -1,8 +1,22 @@
+#include <benchmark/benchmark.h>
+
 #include <QTemporaryDir>
 #include <QTemporaryFile>
+#include <QThreadPool>
 #include <QtDebug>
+#include <random>
 
 #include "sources/audiosourcestereoproxy.h"
+#include "sources/mappedfilereader.h"
+#include "sources/soundsourceflac.h"
+#ifdef __FFMPEG__
+#include "sources/ffmpegseekindex.h"
+#include "sources/soundsourceffmpeg.h"
+#endif
+#ifdef __MAD__
+#include "sources/mp3seektablecache.h"
+#include "sources/soundsourcemp3.h"
+#endif
 #include "sources/soundsourceproxy.h"
 #include "test/mixxxtest.h"
 #include "test/soundsourceproviderregistration.h"
@@ -303,6 +317,116 @@ TEST_F(SoundSourceProxyTest, TOAL_TPE2) {
     EXPECT_TRUE(trackMetadata.getTrackInfo().getComment().isNull());
 }
 
+TEST_F(SoundSourceProxyTest, prefetchTrackMetadata) {
+    const QStringList filePaths = getFilePaths();
+    QList<mixxx::TrackMetadataPrefetcher::Request> requests;
+    for (const auto& filePath : filePaths) {
+        mixxx::TrackMetadataPrefetcher::Request request;
+        request.fileAccess = mixxx::FileAccess(mixxx::FileInfo(filePath));
+        request.trackMetadata = Track::newTemporary(filePath)->getMetadata();
+        requests.append(std::move(request));
+    }
+    const auto metricsBefore = SoundSourceProxy::getTrackMetadataPrefetcherMetrics();
+    SoundSourceProxy::prefetchTrackMetadata(requests);
+    ASSERT_TRUE(SoundSourceProxy::waitForPrefetchedTrackMetadata());
+
+    for (const auto& filePath : filePaths) {
+        SCOPED_TRACE(filePath.toStdString());
+        // The prefetched result is picked up by the first track
+        const auto pPrefetched = Track::newTemporary(filePath);
+        const auto prefetchedResult =
+                SoundSourceProxy(pPrefetched)
+                        .updateTrackFromSource(
+                                SoundSourceProxy::UpdateTrackFromSourceMode::Once,
+                                SyncTrackMetadataParams{});
+        const auto pImported = Track::newTemporary(filePath);
+        const auto importedResult =
+                SoundSourceProxy(pImported)
+                        .updateTrackFromSource(
+                                SoundSourceProxy::UpdateTrackFromSourceMode::Once,
+                                SyncTrackMetadataParams{});
+        EXPECT_EQ(importedResult, prefetchedResult);
+        EXPECT_TRUE(pImported->getMetadata() == pPrefetched->getMetadata());
+        EXPECT_EQ(pImported->getCoverInfo(), pPrefetched->getCoverInfo());
+    }
+    const auto metricsAfter = SoundSourceProxy::getTrackMetadataPrefetcherMetrics();
+    EXPECT_EQ(metricsBefore.hitCount + filePaths.size(), metricsAfter.hitCount);
+    EXPECT_EQ(metricsBefore.missCount + filePaths.size(), metricsAfter.missCount);
+
+    // Results that have been prefetched for different track
+    // metadata must not be used
+    const QString filePath = getTestDir().filePath(
+            QStringLiteral("id3-test-data/cover-test-jpg.mp3"));
+    const auto pModified = Track::newTemporary(filePath);
+    mixxx::TrackMetadataPrefetcher::Request request;
+    request.fileAccess = mixxx::FileAccess(mixxx::FileInfo(filePath));
+    request.trackMetadata = pModified->getMetadata();
+    SoundSourceProxy::prefetchTrackMetadata({request});
+    ASSERT_TRUE(SoundSourceProxy::waitForPrefetchedTrackMetadata());
+    pModified->setComment(QStringLiteral("modified"));
+    SoundSourceProxy(pModified).updateTrackFromSource(
+            SoundSourceProxy::UpdateTrackFromSourceMode::Once,
+            SyncTrackMetadataParams{});
+    EXPECT_EQ(metricsAfter.discardedCount + 1,
+            SoundSourceProxy::getTrackMetadataPrefetcherMetrics().discardedCount);
+    EXPECT_EQ("test22kMono", pModified->getTitle());
+}
+
+TEST_F(SoundSourceProxyTest, prefetchTrackMetadataKeepsResultsUntilTaken) {
+    const QStringList filePaths = getFilePaths();
+    ASSERT_LE(2, filePaths.size());
+    QList<mixxx::TrackMetadataPrefetcher::Request> requests;
+    for (int i = 0; i < 2; ++i) {
+        mixxx::TrackMetadataPrefetcher::Request request;
+        request.fileAccess = mixxx::FileAccess(mixxx::FileInfo(filePaths[i]));
+        request.trackMetadata = Track::newTemporary(filePaths[i])->getMetadata();
+        requests.append(std::move(request));
+    }
+    mixxx::TrackMetadataPrefetcher prefetcher(1);
+    prefetcher.prefetch(requests);
+    // The second import waits until the first result has been taken
+    EXPECT_FALSE(prefetcher.waitForDone(100));
+
+    for (const auto& request : requests) {
+        prefetcher.take(request.fileAccess.info().location(),
+                request.trackMetadata,
+                request.resetMissingTagMetadata);
+    }
+    EXPECT_TRUE(prefetcher.waitForDone());
+    const auto metrics = prefetcher.metrics();
+    EXPECT_EQ(2, metrics.hitCount + metrics.missCount);
+    EXPECT_EQ(0, metrics.discardedCount);
+}
+
+TEST_F(SoundSourceProxyTest, prefetchTrackMetadataCancelDiscardsResultsOfBatch) {
+    const QStringList filePaths = getFilePaths();
+    ASSERT_LE(2, filePaths.size());
+    QList<mixxx::TrackMetadataPrefetcher::Request> requests;
+    for (int i = 0; i < 2; ++i) {
+        mixxx::TrackMetadataPrefetcher::Request request;
+        request.fileAccess = mixxx::FileAccess(mixxx::FileInfo(filePaths[i]));
+        request.trackMetadata = Track::newTemporary(filePaths[i])->getMetadata();
+        requests.append(std::move(request));
+    }
+    mixxx::TrackMetadataPrefetcher prefetcher(1);
+    const auto canceledBatchId = prefetcher.prefetch({requests[0]});
+    ASSERT_TRUE(prefetcher.waitForDone());
+    // The result of the first batch is never taken
+    prefetcher.prefetch({requests[1]});
+    EXPECT_FALSE(prefetcher.waitForDone(100));
+
+    // Canceling the first batch makes room for the second one
+    prefetcher.cancel(canceledBatchId);
+    EXPECT_TRUE(prefetcher.waitForDone());
+    EXPECT_EQ(1, prefetcher.metrics().discardedCount);
+    EXPECT_FALSE(prefetcher.take(requests[0].fileAccess.info().location(),
+            requests[0].trackMetadata,
+            requests[0].resetMissingTagMetadata));
+    EXPECT_TRUE(prefetcher.take(requests[1].fileAccess.info().location(),
+            requests[1].trackMetadata,
+            requests[1].resetMissingTagMetadata));
+}
+
 TEST_F(SoundSourceProxyTest, seekForwardBackward) {
     constexpr SINT kReadFrameCount = 10000;
 
@@ -944,3 +1068,651 @@ TEST_F(SoundSourceProxyTest, fileSuffixWithDifferingType) {
                 SoundSourceProxy::isFileSuffixSupported(fileSuffix));
     }
 }
+
+TEST_F(SoundSourceProxyTest, reopenFromSoundSourcePool) {
+    SoundSourceProxy::setSoundSourcePoolCapacity(4);
+    const QStringList filePaths = getFilePaths();
+    for (const auto& filePath : filePaths) {
+        SCOPED_TRACE(filePath.toStdString());
+        const auto providerRegistrations =
+                SoundSourceProxy::allProviderRegistrationsForUrl(
+                        QUrl::fromLocalFile(filePath));
+        ASSERT_FALSE(providerRegistrations.isEmpty());
+        const auto pProvider = providerRegistrations.first().getProvider();
+        const auto metricsBefore = SoundSourceProxy::getSoundSourcePoolMetrics();
+
+        auto pAudioSource = openAudioSource(filePath, pProvider);
+        if (!pAudioSource) {
+            // skip test file
+            continue;
+        }
+        const auto readRange = mixxx::IndexRange::forward(
+                pAudioSource->frameIndexMin(),
+                math_min(kMaxReadFrameCount, pAudioSource->frameLength()));
+        mixxx::SampleBuffer expectedBuffer(
+                pAudioSource->getSignalInfo().frames2samples(readRange.length()));
+        EXPECT_EQ(readRange,
+                pAudioSource->readSampleFrames(
+                                    mixxx::WritableSampleFrames(readRange,
+                                            mixxx::SampleBuffer::WritableSlice(
+                                                    expectedBuffer)))
+                        .frameIndexRange());
+        // Returns the decoder into the pool
+        pAudioSource->close();
+        pAudioSource.reset();
+
+        pAudioSource = openAudioSource(filePath, pProvider);
+        ASSERT_NE(nullptr, pAudioSource);
+        const auto metricsAfter = SoundSourceProxy::getSoundSourcePoolMetrics();
+        EXPECT_EQ(metricsBefore.coldOpenCount + 1, metricsAfter.coldOpenCount);
+        EXPECT_EQ(metricsBefore.warmOpenCount + 1, metricsAfter.warmOpenCount);
+
+        // The reused decoder needs to seek back to the start
+        mixxx::SampleBuffer actualBuffer(expectedBuffer.size());
+        EXPECT_EQ(readRange,
+                pAudioSource->readSampleFrames(
+                                    mixxx::WritableSampleFrames(readRange,
+                                            mixxx::SampleBuffer::WritableSlice(
+                                                    actualBuffer)))
+                        .frameIndexRange());
+        expectDecodedSamplesEqual(
+                expectedBuffer.size(),
+                expectedBuffer.data(),
+                actualBuffer.data(),
+                "Decoding differs after reopening from the pool");
+        pAudioSource->close();
+    }
+    SoundSourceProxy::setSoundSourcePoolCapacity(0);
+}
+
+TEST_F(SoundSourceProxyTest, closeSoundSourceStillReferencedByProxy) {
+    SoundSourceProxy::setSoundSourcePoolCapacity(4);
+    const QStringList filePaths = getFilePaths();
+    for (const auto& filePath : filePaths) {
+        SCOPED_TRACE(filePath.toStdString());
+        const auto metricsBefore = SoundSourceProxy::getSoundSourcePoolMetrics();
+        {
+            // Like updateTrackFromSource() that closes the audio source
+            // while the proxy is still alive
+            SoundSourceProxy proxy(Track::newTemporary(filePath));
+            const auto pAudioSource = proxy.openAudioSource();
+            if (!pAudioSource) {
+                // skip test file
+                continue;
+            }
+            pAudioSource->close();
+        }
+
+        // The decoder has been closed instead of pooled
+        const auto pAudioSource = openAudioSource(filePath);
+        ASSERT_NE(nullptr, pAudioSource);
+        const auto metricsAfter = SoundSourceProxy::getSoundSourcePoolMetrics();
+        EXPECT_EQ(metricsBefore.coldOpenCount + 2, metricsAfter.coldOpenCount);
+        EXPECT_EQ(metricsBefore.warmOpenCount, metricsAfter.warmOpenCount);
+        pAudioSource->close();
+    }
+    SoundSourceProxy::setSoundSourcePoolCapacity(0);
+}
+
+namespace {
+
+/// Reads all sample frames in consecutive portions of the given size.
+mixxx::SampleBuffer readAllSampleFrames(
+        mixxx::AudioSource* pAudioSource,
+        SINT readFrameCount) {
+    const auto& signalInfo = pAudioSource->getSignalInfo();
+    mixxx::SampleBuffer sampleBuffer(
+            signalInfo.frames2samples(pAudioSource->frameLength()));
+    auto remainingRange = pAudioSource->frameIndexRange();
+    SINT sampleOffset = 0;
+    while (!remainingRange.empty()) {
+        const auto readRange = remainingRange.splitAndShrinkFront(
+                math_min(readFrameCount, remainingRange.length()));
+        const auto readSampleCount = signalInfo.frames2samples(readRange.length());
+        EXPECT_EQ(readRange,
+                pAudioSource->readSampleFrames(
+                                    mixxx::WritableSampleFrames(readRange,
+                                            mixxx::SampleBuffer::WritableSlice(
+                                                    sampleBuffer.data(sampleOffset),
+                                                    readSampleCount)))
+                        .frameIndexRange());
+        sampleOffset += readSampleCount;
+    }
+    return sampleBuffer;
+}
+
+/// Decodes the whole stream from the start, e.g. for recording the
+/// seek index.
+void decodeSequentially(mixxx::AudioSource* pAudioSource) {
+    mixxx::SampleBuffer buffer(
+            pAudioSource->getSignalInfo().frames2samples(kMaxReadFrameCount));
+    auto remainingRange = pAudioSource->frameIndexRange();
+    while (!remainingRange.empty()) {
+        const auto readRange = mixxx::IndexRange::forward(
+                remainingRange.start(),
+                math_min(kMaxReadFrameCount, remainingRange.length()));
+        pAudioSource->readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        readRange,
+                        mixxx::SampleBuffer::WritableSlice(buffer)));
+        remainingRange.shrinkFront(readRange.length());
+    }
+}
+
+/// The statistics of reading after opening, which already reads
+/// some frames for verification.
+mixxx::AudioSource::CopyStats copyStatsSince(
+        const mixxx::AudioSource& audioSource,
+        const mixxx::AudioSource::CopyStats& copyStatsBefore) {
+    const auto copyStats = audioSource.getCopyStats();
+    mixxx::AudioSource::CopyStats copyStatsSince;
+    copyStatsSince.readFrameCount =
+            copyStats.readFrameCount - copyStatsBefore.readFrameCount;
+    copyStatsSince.copiedByteCount =
+            copyStats.copiedByteCount - copyStatsBefore.copiedByteCount;
+    return copyStatsSince;
+}
+
+} // anonymous namespace
+
+TEST_F(SoundSourceProxyTest, zeroCopyDecoding) {
+    // The size of CachingReaderChunk
+    constexpr SINT kChunkFrameCount = 8192;
+    // Not aligned with the block size of any codec
+    constexpr SINT kUnalignedFrameCount = 1000;
+
+    const QStringList filePaths = getFilePaths();
+    for (const auto& filePath : filePaths) {
+        const auto providerRegistrations =
+                SoundSourceProxy::allProviderRegistrationsForUrl(
+                        QUrl::fromLocalFile(filePath));
+        for (const auto& providerRegistration : providerRegistrations) {
+            const auto pProvider = providerRegistration.getProvider();
+            SCOPED_TRACE((filePath + QChar(' ') + pProvider->getDisplayName()).toStdString());
+
+            // Decode with the native number of channels
+            auto pAudioSource = SoundSourceProxy(
+                    Track::newTemporary(filePath), pProvider)
+                                        .openAudioSource();
+            if (!pAudioSource) {
+                // skip test file
+                continue;
+            }
+            const auto channelCount = pAudioSource->getSignalInfo().getChannelCount();
+            const auto bytesPerFrame = static_cast<double>(
+                    pAudioSource->getSignalInfo().frames2samples(1) * sizeof(CSAMPLE));
+
+            auto copyStatsBefore = pAudioSource->getCopyStats();
+            const auto alignedSamples =
+                    readAllSampleFrames(pAudioSource.get(), kChunkFrameCount);
+            const auto alignedCopyStats = copyStatsSince(*pAudioSource, copyStatsBefore);
+            EXPECT_EQ(static_cast<quint64>(pAudioSource->frameLength()),
+                    alignedCopyStats.readFrameCount);
+            if (pProvider->getDisplayName() == mixxx::SoundSourceProviderFLAC::kDisplayName) {
+                // Only the FLAC frames at chunk boundaries are buffered
+                EXPECT_LT(alignedCopyStats.copiedBytesPerFrame(), bytesPerFrame);
+            }
+            pAudioSource->close();
+
+            // Decoding into unaligned portions falls back to copying
+            // but must produce the same result
+            pAudioSource = SoundSourceProxy(
+                    Track::newTemporary(filePath), pProvider)
+                                   .openAudioSource();
+            ASSERT_NE(nullptr, pAudioSource);
+            copyStatsBefore = pAudioSource->getCopyStats();
+            const auto unalignedSamples =
+                    readAllSampleFrames(pAudioSource.get(), kUnalignedFrameCount);
+            ASSERT_EQ(alignedSamples.size(), unalignedSamples.size());
+            expectDecodedSamplesEqual(
+                    alignedSamples.size(),
+                    alignedSamples.data(),
+                    unalignedSamples.data(),
+                    "Decoding into unaligned buffers differs");
+            const auto unalignedCopyStats = copyStatsSince(*pAudioSource, copyStatsBefore);
+            EXPECT_EQ(alignedCopyStats.readFrameCount, unalignedCopyStats.readFrameCount);
+            EXPECT_LE(alignedCopyStats.copiedByteCount, unalignedCopyStats.copiedByteCount);
+            pAudioSource->close();
+
+            // The channel conversion of the proxy is accounted for the
+            // wrapped source
+            if (channelCount == 1) {
+                pAudioSource = SoundSourceProxy(
+                        Track::newTemporary(filePath), pProvider)
+                                       .openAudioSource();
+                ASSERT_NE(nullptr, pAudioSource);
+                auto pStereoSource = mixxx::AudioSourceStereoProxy::create(
+                        pAudioSource, kChunkFrameCount);
+                copyStatsBefore = pAudioSource->getCopyStats();
+                readAllSampleFrames(pStereoSource.get(), kChunkFrameCount);
+                EXPECT_EQ(pAudioSource->getCopyStats().copiedByteCount,
+                        pStereoSource->getCopyStats().copiedByteCount);
+                // At least one copy of each stereo frame
+                EXPECT_GE(copyStatsSince(*pAudioSource, copyStatsBefore)
+                                  .copiedBytesPerFrame(),
+                        2 * bytesPerFrame);
+                pStereoSource->close();
+            }
+        }
+    }
+}
+
+#ifdef __MAD__
+namespace {
+
+const QString kMp3SeekTableTestFile = QStringLiteral("id3-test-data/cover-test-vbr.mp3");
+
+/// Reads chunks from a few positions across the whole file to make sure the
+/// seek table is actually used.
+mixxx::SampleBuffer readMp3SampleFrames(mixxx::AudioSource* pAudioSource) {
+    constexpr SINT kChunkFrames = 1024;
+    const auto frameIndexRange = pAudioSource->frameIndexRange();
+    const auto channelCount = pAudioSource->getSignalInfo().getChannelCount();
+    const SINT chunkSamples = kChunkFrames * channelCount;
+    mixxx::SampleBuffer samples(4 * chunkSamples);
+    samples.clear();
+    // Backward jumps first, which require a seek in any case
+    const SINT frameIndices[] = {
+            frameIndexRange.end() - kChunkFrames,
+            frameIndexRange.start() + frameIndexRange.length() / 2,
+            frameIndexRange.start() + frameIndexRange.length() / 3,
+            frameIndexRange.start(),
+    };
+    for (int i = 0; i < 4; ++i) {
+        const auto readRange = mixxx::intersect(
+                mixxx::IndexRange::forward(frameIndices[i], kChunkFrames),
+                frameIndexRange);
+        pAudioSource->readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        readRange,
+                        mixxx::SampleBuffer::WritableSlice(
+                                samples.data(i * chunkSamples),
+                                readRange.length() * channelCount)));
+    }
+    return samples;
+}
+
+} // anonymous namespace
+
+TEST_F(SoundSourceProxyTest, mp3SeekTableCache) {
+    const QString filePath = getTestDir().filePath(kMp3SeekTableTestFile);
+    const auto fileUrl = QUrl::fromLocalFile(filePath);
+
+    // Scan all frame headers
+    mixxx::Mp3SeekTableCache::setDirectory(QString());
+    mixxx::SoundSourceMp3 uncachedSource(fileUrl);
+    ASSERT_EQ(mixxx::AudioSource::OpenResult::Succeeded,
+            uncachedSource.open(mixxx::AudioSource::OpenMode::Strict));
+    const auto expectedSamples = readMp3SampleFrames(&uncachedSource);
+    uncachedSource.close();
+
+    QTemporaryDir cacheDir;
+    ASSERT_TRUE(cacheDir.isValid());
+    mixxx::Mp3SeekTableCache::setDirectory(cacheDir.path());
+    {
+        // Populates the cache
+        mixxx::SoundSourceMp3 source(fileUrl);
+        ASSERT_EQ(mixxx::AudioSource::OpenResult::Succeeded,
+                source.open(mixxx::AudioSource::OpenMode::Strict));
+    }
+    EXPECT_EQ(1, QDir(cacheDir.path()).entryList(QDir::Files).size());
+
+    // Restores the seek table from the cache
+    mixxx::SoundSourceMp3 cachedSource(fileUrl);
+    ASSERT_EQ(mixxx::AudioSource::OpenResult::Succeeded,
+            cachedSource.open(mixxx::AudioSource::OpenMode::Strict));
+    EXPECT_EQ(uncachedSource.frameIndexRange(), cachedSource.frameIndexRange());
+    EXPECT_EQ(uncachedSource.getSignalInfo(), cachedSource.getSignalInfo());
+    const auto actualSamples = readMp3SampleFrames(&cachedSource);
+    ASSERT_EQ(expectedSamples.size(), actualSamples.size());
+    for (SINT i = 0; i < expectedSamples.size(); ++i) {
+        ASSERT_EQ(expectedSamples[i], actualSamples[i]) << "sample " << i;
+    }
+    mixxx::Mp3SeekTableCache::setDirectory(QString());
+}
+
+/// Arg 0: Scans all frame headers on each open
+/// Arg 1: Restores the seek table from a warm cache
+static void BM_SoundSourceMp3_Open(benchmark::State& state) {
+    const auto fileUrl = QUrl::fromLocalFile(
+            MixxxTest::getOrInitTestDir().filePath(kMp3SeekTableTestFile));
+    QTemporaryDir cacheDir;
+    if (state.range(0) != 0) {
+        mixxx::Mp3SeekTableCache::setDirectory(cacheDir.path());
+        mixxx::SoundSourceMp3 source(fileUrl);
+        source.open(mixxx::AudioSource::OpenMode::Strict);
+    } else {
+        mixxx::Mp3SeekTableCache::setDirectory(QString());
+    }
+    for (auto _ : state) {
+        mixxx::SoundSourceMp3 source(fileUrl);
+        if (source.open(mixxx::AudioSource::OpenMode::Strict) !=
+                mixxx::AudioSource::OpenResult::Succeeded) {
+            state.SkipWithError("Failed to open the test file");
+            break;
+        }
+    }
+    mixxx::Mp3SeekTableCache::setDirectory(QString());
+}
+BENCHMARK(BM_SoundSourceMp3_Open)->Arg(0)->Arg(1);
+#endif // __MAD__
+
+#ifdef __FFMPEG__
+namespace {
+
+const QString kFFmpegSeekIndexTestFiles[] = {
+        QStringLiteral("id3-test-data/cover-test-itunes-12.7.0-aac.m4a"),
+        QStringLiteral("id3-test-data/cover-test-itunes-12.7.0-alac.m4a"),
+        QStringLiteral("id3-test-data/cover-test-vbr.mp3"),
+        QStringLiteral("id3-test-data/cover-test.flac"),
+        QStringLiteral("id3-test-data/cover-test.ogg"),
+        QStringLiteral("id3-test-data/cover-test.opus"),
+        QStringLiteral("id3-test-data/cover-test.wav"),
+};
+
+constexpr SINT kRandomSeekReadFrameCount = 1024;
+
+std::unique_ptr<mixxx::SoundSourceFFmpeg> openSoundSourceFFmpeg(
+        const QString& fileName) {
+    auto pSoundSource = std::make_unique<mixxx::SoundSourceFFmpeg>(
+            QUrl::fromLocalFile(MixxxTest::getOrInitTestDir().filePath(fileName)));
+    if (pSoundSource->open(mixxx::AudioSource::OpenMode::Strict) !=
+            mixxx::AudioSource::OpenResult::Succeeded) {
+        return nullptr;
+    }
+    return pSoundSource;
+}
+
+mixxx::IndexRange randomReadRange(
+        mixxx::AudioSource* pAudioSource,
+        std::mt19937* pRandomGenerator) {
+    const auto frameIndexRange = pAudioSource->frameIndexRange();
+    std::uniform_int_distribution<SINT> startDistribution(
+            frameIndexRange.start(),
+            math_max(frameIndexRange.start(),
+                    frameIndexRange.end() - kRandomSeekReadFrameCount));
+    return mixxx::intersect(
+            mixxx::IndexRange::forward(
+                    startDistribution(*pRandomGenerator),
+                    kRandomSeekReadFrameCount),
+            frameIndexRange);
+}
+
+} // anonymous namespace
+
+TEST_F(SoundSourceProxyTest, ffmpegSeekIndex) {
+    QTemporaryDir cacheDir;
+    ASSERT_TRUE(cacheDir.isValid());
+    int indexedFileCount = 0;
+    for (const auto& fileName : kFFmpegSeekIndexTestFiles) {
+        SCOPED_TRACE(fileName.toStdString());
+        mixxx::FFmpegSeekIndexCache::setDirectory(QString());
+        const auto pReference = openSoundSourceFFmpeg(fileName);
+        if (!pReference) {
+            // skip test file
+            continue;
+        }
+
+        mixxx::FFmpegSeekIndexCache::setDirectory(cacheDir.path());
+        auto pIndexed = openSoundSourceFFmpeg(fileName);
+        ASSERT_NE(nullptr, pIndexed);
+        decodeSequentially(pIndexed.get());
+        ++indexedFileCount;
+        // Wait until the index has been stored
+        QThreadPool::globalInstance()->waitForDone();
+        const QString cacheKey =
+                mixxx::FFmpegSeekIndexCache::cacheKeyForFile(
+                        getTestDir().filePath(fileName));
+        ASSERT_FALSE(cacheKey.isEmpty());
+        // Reopening loads the index from the cache
+        pIndexed->close();
+        pIndexed = openSoundSourceFFmpeg(fileName);
+        ASSERT_NE(nullptr, pIndexed);
+
+        const auto signalInfo = pReference->getSignalInfo();
+        ASSERT_EQ(signalInfo, pIndexed->getSignalInfo());
+        ASSERT_EQ(pReference->frameIndexRange(), pIndexed->frameIndexRange());
+        mixxx::SampleBuffer expected(signalInfo.frames2samples(kRandomSeekReadFrameCount));
+        mixxx::SampleBuffer actual(expected.size());
+        std::mt19937 randomGenerator;
+        for (int i = 0; i < 20; ++i) {
+            const auto readRange = randomReadRange(pReference.get(), &randomGenerator);
+            const auto expectedRange =
+                    pReference
+                            ->readSampleFrames(mixxx::WritableSampleFrames(readRange,
+                                    mixxx::SampleBuffer::WritableSlice(expected)))
+                            .frameIndexRange();
+            const auto actualRange =
+                    pIndexed
+                            ->readSampleFrames(mixxx::WritableSampleFrames(readRange,
+                                    mixxx::SampleBuffer::WritableSlice(actual)))
+                            .frameIndexRange();
+            ASSERT_EQ(expectedRange, actualRange);
+            expectDecodedSamplesEqual(
+                    signalInfo.frames2samples(actualRange.length()),
+                    expected.data(),
+                    actual.data(),
+                    "Decoding with seek index differs");
+        }
+    }
+    mixxx::FFmpegSeekIndexCache::setDirectory(QString());
+    if (indexedFileCount > 0) {
+        // Not all demuxers provide the positions of packets
+        EXPECT_FALSE(QDir(cacheDir.path()).entryList(QDir::Files).isEmpty());
+    }
+}
+
+/// Arg 0: The index of the test file
+/// Arg 1: 0 = without, 1 = with a complete seek index
+static void BM_SoundSourceFFmpeg_RandomSeek(benchmark::State& state) {
+    const QString& fileName = kFFmpegSeekIndexTestFiles[state.range(0)];
+    state.SetLabel(QFileInfo(fileName).fileName().toStdString());
+    mixxx::FFmpegSeekIndexCache::setDirectory(QString());
+    const auto pSoundSource = openSoundSourceFFmpeg(fileName);
+    if (!pSoundSource) {
+        state.SkipWithError("Unsupported file type");
+        return;
+    }
+    if (state.range(1) != 0) {
+        decodeSequentially(pSoundSource.get());
+    }
+    mixxx::SampleBuffer buffer(
+            pSoundSource->getSignalInfo().frames2samples(kRandomSeekReadFrameCount));
+    std::mt19937 randomGenerator;
+    for (auto _ : state) {
+        const auto readRange = randomReadRange(pSoundSource.get(), &randomGenerator);
+        benchmark::DoNotOptimize(
+                pSoundSource->readSampleFrames(mixxx::WritableSampleFrames(readRange,
+                        mixxx::SampleBuffer::WritableSlice(buffer))));
+    }
+}
+BENCHMARK(BM_SoundSourceFFmpeg_RandomSeek)
+        ->ArgsProduct({benchmark::CreateDenseRange(0,
+                               std::size(kFFmpegSeekIndexTestFiles) - 1,
+                               /*step*/ 1),
+                {0, 1}});
+#endif // __FFMPEG__
+
+namespace {
+
+const QString kMappedFileReaderTestFiles[] = {
+        QStringLiteral("id3-test-data/cover-test.flac"),
+        QStringLiteral("id3-test-data/cover-test.wav"),
+        QStringLiteral("id3-test-data/cover-test.wv"),
+};
+
+/// Reads the whole file in portions of varying sizes.
+QByteArray readAllFromMappedFileReader(mixxx::MappedFileReader* pReader) {
+    QByteArray data(static_cast<int>(pReader->size()), '\0');
+    const qint64 readSizes[] = {
+            1, 17, 4096, mixxx::MappedFileReader::kBlockSize + 1, 333};
+    int i = 0;
+    while (!pReader->atEnd()) {
+        const qint64 readSize = pReader->read(
+                data.data() + pReader->pos(),
+                readSizes[i++ % std::size(readSizes)]);
+        if (readSize <= 0) {
+            break;
+        }
+    }
+    return data;
+}
+
+/// Returns the generated files in soundFileFormats if available,
+/// otherwise the much smaller files in id3-test-data.
+QStringList getReadThroughputFilePaths() {
+    QStringList filePaths;
+    const QDir generatedFilesDir(
+            MixxxTest::getOrInitTestDir().filePath(QStringLiteral("soundFileFormats")));
+    const auto fileInfos = generatedFilesDir.entryInfoList(QDir::Files, QDir::Name);
+    for (const auto& fileInfo : fileInfos) {
+        if (SoundSourceProxy::isFileNameSupported(fileInfo.fileName())) {
+            filePaths.append(fileInfo.filePath());
+        }
+    }
+    if (!filePaths.isEmpty()) {
+        return filePaths;
+    }
+    for (const auto& fileName : kMappedFileReaderTestFiles) {
+        const QString filePath = MixxxTest::getOrInitTestDir().filePath(fileName);
+        if (SoundSourceProxy::isFileNameSupported(filePath)) {
+            filePaths.append(filePath);
+        }
+    }
+    return filePaths;
+}
+
+} // anonymous namespace
+
+TEST_F(SoundSourceProxyTest, mappedFileReader) {
+    for (const auto& fileName : kMappedFileReaderTestFiles) {
+        SCOPED_TRACE(fileName.toStdString());
+        const QString filePath = getTestDir().filePath(fileName);
+        QFile file(filePath);
+        ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+        const QByteArray expected = file.readAll();
+        ASSERT_FALSE(expected.isEmpty());
+
+        for (const auto backend : {mixxx::MappedFileReader::Backend::Mapped,
+                     mixxx::MappedFileReader::Backend::Blocks}) {
+            mixxx::MappedFileReader reader;
+            ASSERT_TRUE(reader.open(filePath,
+                    mixxx::AudioSource::AccessPattern::Random,
+                    backend));
+            EXPECT_EQ(backend == mixxx::MappedFileReader::Backend::Mapped,
+                    reader.isMapped());
+            EXPECT_EQ(expected.size(), reader.size());
+            EXPECT_EQ(expected, readAllFromMappedFileReader(&reader));
+            EXPECT_TRUE(reader.atEnd());
+            EXPECT_EQ(0, reader.read(nullptr, 1));
+
+            // Seek backwards and push back the byte that has just been read
+            const qint64 pos = expected.size() / 2;
+            ASSERT_TRUE(reader.seek(pos));
+            reader.adviseAccessPattern(mixxx::AudioSource::AccessPattern::Sequential);
+            char byte;
+            ASSERT_EQ(1, reader.read(&byte, 1));
+            EXPECT_EQ(expected.at(static_cast<int>(pos)), byte);
+            EXPECT_FALSE(reader.ungetByte(static_cast<char>(~byte)));
+            EXPECT_TRUE(reader.ungetByte(byte));
+            EXPECT_EQ(pos, reader.pos());
+            EXPECT_FALSE(reader.seek(expected.size() + 1));
+        }
+    }
+}
+
+TEST_F(SoundSourceProxyTest, mappedFileReaderTruncatedFile) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString filePath = tempDir.filePath(QStringLiteral("truncated.wav"));
+    mixxxtest::copyFile(
+            getTestDir().filePath(QStringLiteral("id3-test-data/cover-test.wav")),
+            filePath);
+    QFile file(filePath);
+    file.setPermissions(file.permissions() | QFileDevice::WriteOwner);
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    const QByteArray expected = file.read(file.size() / 2);
+
+    mixxx::MappedFileReader reader;
+    ASSERT_TRUE(reader.open(filePath,
+            mixxx::AudioSource::AccessPattern::Sequential,
+            mixxx::MappedFileReader::Backend::Mapped));
+    ASSERT_TRUE(reader.isMapped());
+    const qint64 originalSize = reader.size();
+
+    // Truncate the file while it is mapped
+    ASSERT_TRUE(file.resize(expected.size()));
+    QByteArray data(static_cast<int>(originalSize), '\0');
+    EXPECT_EQ(expected.size(), reader.read(data.data(), originalSize));
+    EXPECT_FALSE(reader.isMapped());
+    EXPECT_EQ(expected, data.left(expected.size()));
+}
+
+TEST_F(SoundSourceProxyTest, mappedFileReaderTruncatedFileBlocks) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString filePath = tempDir.filePath(QStringLiteral("truncated.wav"));
+    mixxxtest::copyFile(
+            getTestDir().filePath(QStringLiteral("id3-test-data/cover-test.wav")),
+            filePath);
+    QFile file(filePath);
+    file.setPermissions(file.permissions() | QFileDevice::WriteOwner);
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    const QByteArray expected = file.read(file.size() / 2);
+
+    mixxx::MappedFileReader reader;
+    ASSERT_TRUE(reader.open(filePath,
+            mixxx::AudioSource::AccessPattern::Random,
+            mixxx::MappedFileReader::Backend::Blocks));
+
+    // The size is updated after the first short read
+    ASSERT_TRUE(file.resize(expected.size()));
+    EXPECT_EQ(expected, readAllFromMappedFileReader(&reader).left(expected.size()));
+    EXPECT_EQ(expected.size(), reader.size());
+    EXPECT_TRUE(reader.atEnd());
+}
+
+TEST_F(SoundSourceProxyTest, mappedFileReaderRandomAccessReadsBlocks) {
+    const QString filePath =
+            getTestDir().filePath(QStringLiteral("id3-test-data/cover-test.wav"));
+    mixxx::MappedFileReader reader;
+    ASSERT_TRUE(reader.open(filePath, mixxx::AudioSource::AccessPattern::Random));
+    EXPECT_FALSE(reader.isMapped());
+
+    ASSERT_TRUE(reader.open(filePath, mixxx::AudioSource::AccessPattern::Sequential));
+    reader.adviseAccessPattern(mixxx::AudioSource::AccessPattern::Random);
+    EXPECT_FALSE(reader.isMapped());
+}
+
+/// Arg 0: The access pattern, 1 = sequential, 2 = random
+static void BM_SoundSource_ReadThroughput(benchmark::State& state) {
+    if (!SoundSourceProxy::isFileSuffixSupported(QStringLiteral("wav"))) {
+        SoundSourceProxy::registerProviders();
+    }
+    const auto accessPattern =
+            static_cast<mixxx::AudioSource::AccessPattern>(state.range(0));
+    const QStringList filePaths = getReadThroughputFilePaths();
+    if (filePaths.isEmpty()) {
+        state.SkipWithError("No test files");
+        return;
+    }
+    mixxx::AudioSource::OpenParams openParams;
+    openParams.setAccessPattern(accessPattern);
+    qint64 fileBytes = 0;
+    for (auto _ : state) {
+        for (const auto& filePath : filePaths) {
+            auto pAudioSource =
+                    SoundSourceProxy(Track::newTemporary(filePath))
+                            .openAudioSource(openParams);
+            if (!pAudioSource) {
+                continue;
+            }
+            decodeSequentially(pAudioSource.get());
+            fileBytes += QFileInfo(filePath).size();
+        }
+    }
+    state.SetBytesProcessed(fileBytes);
+}
+BENCHMARK(BM_SoundSource_ReadThroughput)
+        ->Arg(static_cast<int>(mixxx::AudioSource::AccessPattern::Sequential))
+        ->Arg(static_cast<int>(mixxx::AudioSource::AccessPattern::Random));
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <QList>
+#include <QSet>
+#include <QStringList>
+#include <memory>
+#include <vector>
+
+#include "effects/backends/effectsbackendmanager.h"
+#include "engine/effects/engineeffect.h"
+#include "engine/effects/engineeffectchain.h"
+#include "engine/effects/engineeffectsmanager.h"
+#include "engine/effects/message.h"
+#include "util/messagepipe.h"
+
+/// Builds postfader EngineEffectChains with built-in effects and adds them to
+/// an EngineEffectsManager directly from the calling thread, i.e. without the
+/// EffectsManager and the message pipes of the main thread. Must be destroyed
+/// before the EngineEffectsManager.
+class TestEngineEffectChains {
+  public:
+    TestEngineEffectChains(EngineEffectsManager* pManager,
+            EffectsBackendManagerPointer pBackendManager,
+            const QSet<ChannelHandleAndGroup>& inputChannels,
+            const QSet<ChannelHandleAndGroup>& outputChannels)
+            : m_pManager(pManager),
+              m_pBackendManager(pBackendManager),
+              m_inputChannels(inputChannels),
+              m_outputChannels(outputChannels) {
+        auto pipes = TwoWayMessagePipe<EffectsRequest*, EffectsResponse>::makeTwoWayMessagePipe(
+                kPipeSize, kPipeSize);
+        m_pRequestPipe = std::move(pipes.first);
+        m_pResponsePipe = std::move(pipes.second);
+    }
+
+    ~TestEngineEffectChains() {
+        for (const auto& pChain : m_chains) {
+            EffectsRequest request;
+            request.type = EffectsRequest::REMOVE_EFFECT_CHAIN;
+            request.RemoveEffectChain.pChain = pChain.get();
+            request.RemoveEffectChain.signalProcessingStage = SignalProcessingStage::Postfader;
+            apply(m_pManager, &request);
+        }
+    }
+
+    /// Adds an enabled chain with the built-in effects effectIds, that is
+    /// enabled for the inputChannels.
+    EngineEffectChain* addChain(const QStringList& effectIds,
+            const QList<ChannelHandle>& inputChannels,
+            double mix = 1.0) {
+        m_chains.push_back(std::make_unique<EngineEffectChain>(
+                QStringLiteral("[TestEffectChain%1]").arg(m_chains.size() + 1),
+                m_inputChannels,
+                m_outputChannels));
+        EngineEffectChain* pChain = m_chains.back().get();
+
+        {
+            EffectsRequest request;
+            request.type = EffectsRequest::ADD_EFFECT_CHAIN;
+            request.AddEffectChain.pChain = pChain;
+            request.AddEffectChain.signalProcessingStage = SignalProcessingStage::Postfader;
+            apply(m_pManager, &request);
+        }
+
+        for (int i = 0; i < effectIds.size(); ++i) {
+            m_effects.push_back(std::make_unique<EngineEffect>(
+                    m_pBackendManager->getManifest(effectIds[i], EffectBackendType::BuiltIn),
+                    m_pBackendManager,
+                    m_inputChannels,
+                    m_inputChannels,
+                    m_outputChannels));
+            EngineEffect* pEffect = m_effects.back().get();
+
+            EffectsRequest addRequest;
+            addRequest.type = EffectsRequest::ADD_EFFECT_TO_CHAIN;
+            addRequest.pTargetChain = pChain;
+            addRequest.AddEffectToChain.pEffect = pEffect;
+            addRequest.AddEffectToChain.iIndex = i;
+            apply(pChain, &addRequest);
+
+            EffectsRequest enableRequest;
+            enableRequest.type = EffectsRequest::SET_EFFECT_PARAMETERS;
+            enableRequest.pTargetEffect = pEffect;
+            enableRequest.SetEffectParameters.enabled = true;
+            apply(pEffect, &enableRequest);
+        }
+
+        {
+            EffectsRequest request;
+            request.type = EffectsRequest::SET_EFFECT_CHAIN_PARAMETERS;
+            request.pTargetChain = pChain;
+            request.SetEffectChainParameters.enabled = true;
+            request.SetEffectChainParameters.mix_mode = EffectChainMixMode::DrySlashWet;
+            request.SetEffectChainParameters.mix = mix;
+            apply(pChain, &request);
+        }
+
+        for (const auto& inputChannel : inputChannels) {
+            EffectsRequest request;
+            request.type = EffectsRequest::ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL;
+            request.pTargetChain = pChain;
+            request.EnableInputChannelForChain.channelHandle = inputChannel;
+            apply(pChain, &request);
+        }
+        return pChain;
+    }
+
+    /// The effects of all chains in the order they have been added
+    EngineEffect* effect(int index) const {
+        return m_effects.at(index).get();
+    }
+
+    void setParameter(EngineEffect* pEffect, int parameterIndex, double value) {
+        EffectsRequest request;
+        request.type = EffectsRequest::SET_PARAMETER_PARAMETERS;
+        request.pTargetEffect = pEffect;
+        request.SetParameterParameters.iParameter = parameterIndex;
+        request.value = value;
+        apply(pEffect, &request);
+    }
+
+  private:
+    static constexpr int kPipeSize = 64;
+
+    void apply(EffectsRequestHandler* pHandler, EffectsRequest* pRequest) {
+        pHandler->processEffectsRequest(*pRequest, m_pResponsePipe.get());
+        EffectsResponse response;
+        while (m_pRequestPipe->readMessage(&response)) {
+        }
+    }
+
+    EngineEffectsManager* const m_pManager;
+    const EffectsBackendManagerPointer m_pBackendManager;
+    const QSet<ChannelHandleAndGroup> m_inputChannels;
+    const QSet<ChannelHandleAndGroup> m_outputChannels;
+    std::unique_ptr<EffectsRequestPipe> m_pRequestPipe;
+    std::unique_ptr<EffectsResponsePipe> m_pResponsePipe;
+    std::vector<std::unique_ptr<EngineEffectChain>> m_chains;
+    std::vector<std::unique_ptr<EngineEffect>> m_effects;
+};
@@ -0,0 +1,46 @@
+#include "util/xxhash64.h"
+
+#include <gtest/gtest.h>
+
+#include <QByteArray>
+
+namespace {
+
+class XxHash64Test : public testing::Test {
+  protected:
+    static quint64 hash(const QByteArray& data, quint64 seed = 0) {
+        return mixxx::xxHash64(data.constData(), data.size(), seed);
+    }
+};
+
+TEST_F(XxHash64Test, ReferenceValues) {
+    EXPECT_EQ(0xEF46DB3751D8E999ULL, hash(QByteArray()));
+    EXPECT_EQ(0xD24EC4F1A98C6E5BULL, hash(QByteArrayLiteral("a")));
+    EXPECT_EQ(0x44BC2CF5AD770999ULL, hash(QByteArrayLiteral("abc")));
+    // Longer than a single stripe of 32 bytes
+    EXPECT_EQ(0xFBCEA83C8A378BF1ULL,
+            hash(QByteArrayLiteral("Nobody inspects the spammish repetition")));
+}
+
+TEST_F(XxHash64Test, Seed) {
+    const QByteArray data = QByteArrayLiteral("Nobody inspects the spammish repetition");
+    EXPECT_EQ(hash(data, 1), hash(data, 1));
+    EXPECT_NE(hash(data, 0), hash(data, 1));
+}
+
+TEST_F(XxHash64Test, AllTailLengths) {
+    // Covers all code paths for the remaining bytes after the stripes
+    QByteArray data;
+    quint64 previousHash = hash(data);
+    for (int i = 0; i < 72; ++i) {
+        data.append(static_cast<char>(i));
+        const quint64 nextHash = hash(data);
+        EXPECT_NE(previousHash, nextHash);
+        // Independent of the alignment of the input
+        QByteArray shifted = QByteArray(1, '\0') + data;
+        EXPECT_EQ(nextHash, mixxx::xxHash64(shifted.constData() + 1, data.size()));
+        previousHash = nextHash;
+    }
+}
+
+} // anonymous namespace
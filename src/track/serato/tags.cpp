@@ -174,12 +174,13 @@ double SeratoTags::guessTimingOffsetMillis(
 }
 
 BeatsImporterPointer SeratoTags::importBeats() const {
-    if (m_seratoBeatGrid.isEmpty() || !m_seratoBeatGrid.terminalMarker()) {
+    const SeratoBeatGrid& seratoBeatGrid = m_seratoBeatGrid.get();
+    if (seratoBeatGrid.isEmpty() || !seratoBeatGrid.terminalMarker()) {
         return nullptr;
     }
     return std::make_shared<SeratoBeatsImporter>(
-            m_seratoBeatGrid.nonTerminalMarkers(),
-            m_seratoBeatGrid.terminalMarker());
+            seratoBeatGrid.nonTerminalMarkers(),
+            seratoBeatGrid.terminalMarker());
 }
 
 std::unique_ptr<CueInfoImporter> SeratoTags::createCueInfoImporter() const {
@@ -197,7 +198,7 @@ QList<CueInfo> SeratoTags::getCueInfos() const {
     // Serato will use the values from "Serato Markers_").
 
     QMap<int, CueInfo> cueMap;
-    const QList<CueInfo> cuesMarkers2 = m_seratoMarkers2.getCues();
+    const QList<CueInfo> cuesMarkers2 = m_seratoMarkers2.get().getCues();
     for (const CueInfo& cueInfo : cuesMarkers2) {
         if (!isCueInfoValid(cueInfo)) {
             continue;
@@ -221,7 +222,7 @@ QList<CueInfo> SeratoTags::getCueInfos() const {
         }
     };
 
-    const QList<CueInfo> cuesMarkers = m_seratoMarkers.getCues();
+    const QList<CueInfo> cuesMarkers = m_seratoMarkers.get().getCues();
     if (cuesMarkers.size() > 0) {
         // The "Serato Markers_" tag always contains entries for the first five
         // cues. If a cue is not set, that entry is present but empty.
@@ -339,16 +340,16 @@ void SeratoTags::setCueInfos(const QList<CueInfo>& cueInfos, double timingOffset
         }
     };
 
-    m_seratoMarkers.setCues(cueList);
-    m_seratoMarkers2.setCues(cueList);
+    m_seratoMarkers.ref().setCues(cueList);
+    m_seratoMarkers2.ref().setCues(cueList);
 }
 
 std::optional<RgbColor::optional_t> SeratoTags::getTrackColor() const {
-    std::optional<mixxx::SeratoStoredTrackColor> pStoredColor = m_seratoMarkers.getTrackColor();
+    std::optional<mixxx::SeratoStoredTrackColor> pStoredColor = m_seratoMarkers.get().getTrackColor();
 
     if (!pStoredColor) {
         // Markers_ is empty, but we may have a color in Markers2
-        pStoredColor = m_seratoMarkers2.getTrackColor();
+        pStoredColor = m_seratoMarkers2.get().getTrackColor();
     }
 
     if (!pStoredColor) {
@@ -361,16 +362,16 @@ std::optional<RgbColor::optional_t> SeratoTags::getTrackColor() const {
 
 void SeratoTags::setTrackColor(const RgbColor::optional_t& color) {
     auto storedColor = SeratoStoredTrackColor::fromDisplayedColor(color);
-    m_seratoMarkers.setTrackColor(storedColor);
-    m_seratoMarkers2.setTrackColor(storedColor);
+    m_seratoMarkers.ref().setTrackColor(storedColor);
+    m_seratoMarkers2.ref().setTrackColor(storedColor);
 }
 
 bool SeratoTags::isBpmLocked() const {
-    return m_seratoMarkers2.isBpmLocked();
+    return m_seratoMarkers2.get().isBpmLocked();
 }
 
 void SeratoTags::setBpmLocked(bool bpmLocked) {
-    m_seratoMarkers2.setBpmLocked(bpmLocked);
+    m_seratoMarkers2.ref().setBpmLocked(bpmLocked);
 }
 
 } // namespace mixxx
@@ -13,6 +13,17 @@ namespace mixxx {
 
 /// DTO for storing information from the SeratoMarkers_/2 tags used by the
 /// Serato DJ Pro software.
+///
+/// The raw data of the tags is kept as read from the file and only decoded
+/// on first access. Importing the metadata of a track into the library
+/// accesses the beat grid, the cues and the track color, i.e. all tags are
+/// still decoded once per import. Only the many copies and comparisons of
+/// the metadata DTOs afterwards don't decode the tags, and unmodified tags
+/// are written back without re-encoding them.
+///
+/// Decoding modifies the internal state of const objects, i.e. like for all
+/// other metadata DTOs, concurrent access to a single instance must be
+/// synchronized by the owner.
 class SeratoTags final {
   public:
     enum class ParserStatus {
@@ -21,12 +32,6 @@ class SeratoTags final {
         Failed = 2,
     };
 
-    SeratoTags()
-            : m_seratoBeatGridParserStatus(ParserStatus::None),
-              m_seratoMarkersParserStatus(ParserStatus::None),
-              m_seratoMarkers2ParserStatus(ParserStatus::None) {
-    }
-
     static double guessTimingOffsetMillis(
             const QString& filePath, const audio::SignalInfo& signalInfo);
 
@@ -38,38 +43,42 @@ class SeratoTags final {
     /// Return the cumulated parse status for all Serato tags. If no tags were parsed,
     /// this returns `ParserStatus::None`. If any tag failed to parse, this
     /// returns `ParserStatus::Failed`.
+    ///
+    /// All tags are decoded if not done yet.
     ParserStatus status() const {
-        if (m_seratoBeatGridParserStatus == ParserStatus::Failed ||
-                m_seratoMarkersParserStatus == ParserStatus::Failed ||
-                m_seratoMarkers2ParserStatus == ParserStatus::Failed) {
+        const ParserStatus beatGridStatus = m_seratoBeatGrid.status();
+        const ParserStatus markersStatus = m_seratoMarkers.status();
+        const ParserStatus markers2Status = m_seratoMarkers2.status();
+        if (beatGridStatus == ParserStatus::Failed ||
+                markersStatus == ParserStatus::Failed ||
+                markers2Status == ParserStatus::Failed) {
             return ParserStatus::Failed;
         }
 
-        if (m_seratoBeatGridParserStatus == ParserStatus::None ||
-                m_seratoMarkersParserStatus == ParserStatus::None ||
-                m_seratoMarkers2ParserStatus == ParserStatus::None) {
+        if (beatGridStatus == ParserStatus::None ||
+                markersStatus == ParserStatus::None ||
+                markers2Status == ParserStatus::None) {
             return ParserStatus::None;
         }
 
         return ParserStatus::Parsed;
     }
 
+    /// Stores the data for decoding it on first access. Decoding errors
+    /// are reported by status().
     bool parseBeatGrid(const QByteArray& data, taglib::FileType fileType) {
-        bool success = SeratoBeatGrid::parse(&m_seratoBeatGrid, data, fileType);
-        m_seratoBeatGridParserStatus = success ? ParserStatus::Parsed : ParserStatus::Failed;
-        return success;
+        m_seratoBeatGrid.setData(data, fileType);
+        return true;
     }
 
     bool parseMarkers(const QByteArray& data, taglib::FileType fileType) {
-        bool success = SeratoMarkers::parse(&m_seratoMarkers, data, fileType);
-        m_seratoMarkersParserStatus = success ? ParserStatus::Parsed : ParserStatus::Failed;
-        return success;
+        m_seratoMarkers.setData(data, fileType);
+        return true;
     }
 
     bool parseMarkers2(const QByteArray& data, taglib::FileType fileType) {
-        bool success = SeratoMarkers2::parse(&m_seratoMarkers2, data, fileType);
-        m_seratoMarkers2ParserStatus = success ? ParserStatus::Parsed : ParserStatus::Failed;
-        return success;
+        m_seratoMarkers2.setData(data, fileType);
+        return true;
     }
 
     QByteArray dumpBeatGrid(taglib::FileType fileType) const {
@@ -94,7 +103,7 @@ class SeratoTags final {
             const audio::SignalInfo& signalInfo,
             const Duration& duration,
             double timingOffset) {
-        m_seratoBeatGrid.setBeats(pBeats, signalInfo, duration, timingOffset);
+        m_seratoBeatGrid.ref().setBeats(pBeats, signalInfo, duration, timingOffset);
     }
 
     /// Return the track color.
@@ -114,24 +123,92 @@ class SeratoTags final {
     bool isBpmLocked() const;
     void setBpmLocked(bool bpmLocked);
 
+    friend bool operator==(const SeratoTags& lhs, const SeratoTags& rhs) {
+        return lhs.m_seratoBeatGrid == rhs.m_seratoBeatGrid &&
+                lhs.m_seratoMarkers == rhs.m_seratoMarkers &&
+                lhs.m_seratoMarkers2 == rhs.m_seratoMarkers2;
+    }
+
   private:
-    SeratoBeatGrid m_seratoBeatGrid;
-    ParserStatus m_seratoBeatGridParserStatus;
-    SeratoMarkers m_seratoMarkers;
-    ParserStatus m_seratoMarkersParserStatus;
-    SeratoMarkers2 m_seratoMarkers2;
-    ParserStatus m_seratoMarkers2ParserStatus;
-};
+    /// A tag that is decoded on first access.
+    template<typename T>
+    class LazyTag final {
+      public:
+        LazyTag()
+                : m_fileType(taglib::FileType::Unknown),
+                  m_status(ParserStatus::None),
+                  m_isDecoded(true) {
+        }
 
-inline bool operator==(const SeratoTags& lhs, const SeratoTags& rhs) {
-    // FIXME: Find a more efficient way to do this
-    return (lhs.dumpBeatGrid(taglib::FileType::MP3) ==
-                    rhs.dumpBeatGrid(taglib::FileType::MP3) &&
-            lhs.dumpMarkers(taglib::FileType::MP3) ==
-                    rhs.dumpMarkers(taglib::FileType::MP3) &&
-            lhs.dumpMarkers2(taglib::FileType::MP3) ==
-                    rhs.dumpMarkers2(taglib::FileType::MP3));
-}
+        void setData(QByteArray data, taglib::FileType fileType) {
+            m_data = std::move(data);
+            m_fileType = fileType;
+            m_isDecoded = false;
+        }
+
+        bool isEmpty() const {
+            return m_isDecoded ? m_value.isEmpty() : m_data.isEmpty();
+        }
+
+        ParserStatus status() const {
+            decode();
+            return m_status;
+        }
+
+        const T& get() const {
+            decode();
+            return m_value;
+        }
+
+        /// The raw data is discarded when accessing the tag for modification.
+        T& ref() {
+            decode();
+            m_data = QByteArray();
+            return m_value;
+        }
+
+        QByteArray dump(taglib::FileType fileType) const {
+            if (!m_data.isEmpty() && fileType == m_fileType) {
+                return m_data;
+            }
+            return get().dump(fileType);
+        }
+
+        friend bool operator==(const LazyTag& lhs, const LazyTag& rhs) {
+            if (!lhs.m_data.isEmpty() &&
+                    lhs.m_fileType == rhs.m_fileType &&
+                    lhs.m_data == rhs.m_data) {
+                return true;
+            }
+            // FIXME: Find a more efficient way to do this
+            return lhs.dump(taglib::FileType::MP3) == rhs.dump(taglib::FileType::MP3);
+        }
+
+      private:
+        void decode() const {
+            if (m_isDecoded) {
+                return;
+            }
+            m_isDecoded = true;
+            if (T::parse(&m_value, m_data, m_fileType)) {
+                m_status = ParserStatus::Parsed;
+            } else {
+                m_value = T();
+                m_status = ParserStatus::Failed;
+            }
+        }
+
+        QByteArray m_data;
+        taglib::FileType m_fileType;
+        mutable T m_value;
+        mutable ParserStatus m_status;
+        mutable bool m_isDecoded;
+    };
+
+    LazyTag<SeratoBeatGrid> m_seratoBeatGrid;
+    LazyTag<SeratoMarkers> m_seratoMarkers;
+    LazyTag<SeratoMarkers2> m_seratoMarkers2;
+};
 
 inline bool operator!=(const SeratoTags& lhs, const SeratoTags& rhs) {
     return !(lhs == rhs);
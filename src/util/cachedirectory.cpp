@@ -0,0 +1,58 @@
+#include "util/cachedirectory.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("CacheDirectory");
+
+} // anonymous namespace
+
+int pruneCacheDirectory(
+        const QString& dirPath,
+        const QString& nameFilter,
+        qint64 maxTotalSize) {
+    // Most recently used first
+    const QFileInfoList fileInfos = QDir(dirPath).entryInfoList(
+            QStringList{nameFilter},
+            QDir::Files | QDir::NoDotAndDotDot,
+            QDir::Time);
+    qint64 totalSize = 0;
+    int deletedCount = 0;
+    for (const auto& fileInfo : fileInfos) {
+        totalSize += fileInfo.size();
+        if (totalSize <= maxTotalSize) {
+            continue;
+        }
+        if (QFile::remove(fileInfo.filePath())) {
+            ++deletedCount;
+        } else {
+            // Might be opened by another process on Windows. It still
+            // counts towards the total size.
+            kLogger.warning() << "Failed to remove" << fileInfo.filePath();
+        }
+    }
+    if (deletedCount > 0) {
+        kLogger.info() << "Removed" << deletedCount
+                       << "least recently used files from" << dirPath;
+    }
+    return deletedCount;
+}
+
+void touchCacheFile(const QString& filePath) {
+    // Setting the file time requires write access on Windows
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadWrite | QIODevice::ExistingOnly)) {
+        return;
+    }
+    file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+}
+
+} // namespace mixxx
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <QString>
+
+namespace mixxx {
+
+/// Deletes the least recently used files of a cache directory until their
+/// total size does not exceed maxTotalSize bytes. Only files that match the
+/// nameFilter wildcard (e.g. "*.mp3seek") are considered.
+///
+/// The modification time of the files is used as their last access time,
+/// because the access time is not maintained by most file systems.
+/// Returns the number of deleted files.
+int pruneCacheDirectory(
+        const QString& dirPath,
+        const QString& nameFilter,
+        qint64 maxTotalSize);
+
+/// Updates the modification time of a cache file when it has been read, so
+/// pruneCacheDirectory() keeps it.
+void touchCacheFile(const QString& filePath);
+
+} // namespace mixxx
@@ -0,0 +1,80 @@
+#include "util/fileidentity.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QFile>
+#include <QFileInfo>
+#include <algorithm>
+
+namespace mixxx {
+
+namespace {
+
+// The number of bytes at the beginning and the end of the file
+// that are hashed
+constexpr quint64 kDigestBlockSize = 1024;
+
+} // anonymous namespace
+
+// static
+FileIdentity FileIdentity::fromFileData(
+        const unsigned char* pFileData,
+        quint64 fileSize,
+        const QDateTime& lastModified) {
+    FileIdentity identity;
+    if (!pFileData || fileSize == 0) {
+        return identity;
+    }
+    identity.m_fileSize = fileSize;
+    identity.m_lastModifiedMs = lastModified.toMSecsSinceEpoch();
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    const quint64 headSize = std::min(fileSize, kDigestBlockSize);
+    hash.addData(reinterpret_cast<const char*>(pFileData), static_cast<int>(headSize));
+    if (fileSize > headSize) {
+        const quint64 tailSize = std::min(fileSize - headSize, kDigestBlockSize);
+        hash.addData(reinterpret_cast<const char*>(pFileData + fileSize - tailSize),
+                static_cast<int>(tailSize));
+    }
+    identity.m_digest = hash.result();
+    return identity;
+}
+
+// static
+FileIdentity FileIdentity::fromFile(const QString& fileName) {
+    FileIdentity identity;
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly) || file.size() <= 0) {
+        return identity;
+    }
+    const auto fileSize = static_cast<quint64>(file.size());
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    const quint64 headSize = std::min(fileSize, kDigestBlockSize);
+    hash.addData(file.read(static_cast<qint64>(headSize)));
+    if (fileSize > headSize) {
+        const quint64 tailSize = std::min(fileSize - headSize, kDigestBlockSize);
+        if (!file.seek(static_cast<qint64>(fileSize - tailSize))) {
+            return identity;
+        }
+        hash.addData(file.read(static_cast<qint64>(tailSize)));
+    }
+    identity.m_fileSize = fileSize;
+    identity.m_lastModifiedMs = QFileInfo(file).lastModified().toMSecsSinceEpoch();
+    identity.m_digest = hash.result();
+    return identity;
+}
+
+QString FileIdentity::cacheKey() const {
+    return QStringLiteral("%1-%2").arg(
+            QString::fromLatin1(m_digest.toHex()),
+            QString::number(m_fileSize));
+}
+
+QDataStream& operator<<(QDataStream& out, const FileIdentity& identity) {
+    return out << identity.m_fileSize << identity.m_lastModifiedMs << identity.m_digest;
+}
+
+QDataStream& operator>>(QDataStream& in, FileIdentity& identity) {
+    return in >> identity.m_fileSize >> identity.m_lastModifiedMs >> identity.m_digest;
+}
+
+} // namespace mixxx
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QString>
+
+class QDataStream;
+
+namespace mixxx {
+
+/// Identifies the content of a file without reading all of it, e.g. for
+/// the entries of a persistent cache.
+///
+/// The size and the modification time detect almost all changes of a file.
+/// The digest of the first and the last KiB additionally detects files that
+/// have been replaced while preserving the time stamp, e.g. by copying them
+/// from a backup.
+class FileIdentity final {
+  public:
+    FileIdentity()
+            : m_fileSize(0),
+              m_lastModifiedMs(0) {
+    }
+
+    /// For files that have already been read or mapped into memory
+    static FileIdentity fromFileData(
+            const unsigned char* pFileData,
+            quint64 fileSize,
+            const QDateTime& lastModified);
+    /// Only reads the first and the last KiB of the file
+    static FileIdentity fromFile(const QString& fileName);
+
+    bool isValid() const {
+        return !m_digest.isEmpty();
+    }
+
+    quint64 fileSize() const {
+        return m_fileSize;
+    }
+    qint64 lastModifiedMs() const {
+        return m_lastModifiedMs;
+    }
+
+    /// The digest and the size, but not the modification time, i.e. a
+    /// cache entry is replaced when only the time stamp has changed.
+    QString cacheKey() const;
+
+    friend bool operator==(const FileIdentity& lhs, const FileIdentity& rhs) {
+        return lhs.m_fileSize == rhs.m_fileSize &&
+                lhs.m_lastModifiedMs == rhs.m_lastModifiedMs &&
+                lhs.m_digest == rhs.m_digest;
+    }
+
+    friend QDataStream& operator<<(QDataStream& out, const FileIdentity& identity);
+    friend QDataStream& operator>>(QDataStream& in, FileIdentity& identity);
+
+  private:
+    quint64 m_fileSize;
+    qint64 m_lastModifiedMs;
+    QByteArray m_digest;
+};
+
+inline bool operator!=(const FileIdentity& lhs, const FileIdentity& rhs) {
+    return !(lhs == rhs);
+}
+
+} // namespace mixxx
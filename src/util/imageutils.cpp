@@ -1,13 +1,9 @@
 #include "util/imageutils.h"
 
 #include <QByteArray>
-#include <QCryptographicHash>
+#include <QtEndian>
 
-namespace {
-
-constexpr QCryptographicHash::Algorithm kImageHashAlgorithm = QCryptographicHash::Sha256;
-
-} // anonymous namespace
+#include "util/xxhash64.h"
 
 namespace mixxx {
 
@@ -15,12 +11,21 @@ ImageDigest digestImage(const QImage& image) {
     if (image.isNull()) {
         return ImageDigest();
     }
-    QCryptographicHash cryptoHash(kImageHashAlgorithm);
-    const QByteArray data = QByteArray::fromRawData(
-            reinterpret_cast<const char*>(image.constBits()),
-            image.sizeInBytes());
-    cryptoHash.addData(data);
-    return cryptoHash.result();
+    // Identical pixel data with different dimensions or formats
+    // must result in different digests
+    const quint64 seed =
+            (static_cast<quint64>(image.width()) << 40) ^
+            (static_cast<quint64>(image.height()) << 16) ^
+            static_cast<quint64>(image.format());
+    const quint64 hash = xxHash64(
+            image.constBits(),
+            static_cast<std::size_t>(image.sizeInBytes()),
+            seed);
+    // Big endian byte order, i.e. cacheKeyFromMessageDigest()
+    // restores the hash value
+    ImageDigest digest(sizeof(hash), Qt::Uninitialized);
+    qToBigEndian(hash, digest.data());
+    return digest;
 }
 
 QColor extractImageBackgroundColor(const QImage& image) {
@@ -8,6 +8,11 @@ namespace mixxx {
 
 typedef QByteArray ImageDigest;
 
+/// A fast, non-cryptographic 64-bit digest of the decoded pixels.
+///
+/// Digests that have been calculated by previous versions with SHA-256
+/// are still valid cache keys, they only differ from newly calculated
+/// digests of the same image.
 ImageDigest digestImage(const QImage& image);
 
 QColor extractImageBackgroundColor(const QImage& image);
@@ -0,0 +1,33 @@
+#include "util/inputtimestamp.h"
+
+#include "util/time.h"
+
+namespace mixxx {
+
+namespace {
+
+/// Zero if unknown
+thread_local Duration s_timestamp;
+
+} // anonymous namespace
+
+InputTimestamp::Scope::Scope(Duration timestamp)
+        : m_previousTimestamp(s_timestamp) {
+    if (timestamp != Duration::empty()) {
+        s_timestamp = timestamp;
+    }
+}
+
+InputTimestamp::Scope::~Scope() {
+    s_timestamp = m_previousTimestamp;
+}
+
+// static
+Duration InputTimestamp::current() {
+    if (s_timestamp == Duration::empty()) {
+        return Time::elapsed();
+    }
+    return s_timestamp;
+}
+
+} // namespace mixxx
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "util/duration.h"
+
+namespace mixxx {
+
+/// The time at which the input event that is currently processed on this
+/// thread has been received, e.g. a controller message, in the time base
+/// of Time::elapsed().
+///
+/// Controllers might process input with a delay, e.g. when polling the
+/// device or after a stall of the controller thread. Code that reacts to
+/// the input, e.g. scratching, should use the time of the input instead of
+/// the time of processing it.
+class InputTimestamp final {
+  public:
+    /// Sets the timestamp of the current input event for the lifetime of
+    /// the scope. A zero timestamp, i.e. unknown, is ignored.
+    class Scope final {
+      public:
+        explicit Scope(Duration timestamp);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+      private:
+        const Duration m_previousTimestamp;
+    };
+
+    /// Returns the timestamp of the current input event, or Time::elapsed()
+    /// if no input event is processed on this thread.
+    static Duration current();
+};
+
+} // namespace mixxx
@@ -0,0 +1,101 @@
+#include "util/xxhash64.h"
+
+#include <QtEndian>
+#include <cstring>
+
+namespace mixxx {
+
+namespace {
+
+constexpr quint64 kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr quint64 kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr quint64 kPrime3 = 0x165667B19E3779F9ULL;
+constexpr quint64 kPrime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr quint64 kPrime5 = 0x27D4EB2F165667C5ULL;
+
+// Input is processed in stripes of 4 lanes with 8 bytes each
+constexpr std::size_t kStripeSize = 32;
+
+inline quint64 rotateLeft(quint64 value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline quint64 read64(const unsigned char* pData) {
+    quint64 value;
+    std::memcpy(&value, pData, sizeof(value));
+    return qFromLittleEndian(value);
+}
+
+inline quint32 read32(const unsigned char* pData) {
+    quint32 value;
+    std::memcpy(&value, pData, sizeof(value));
+    return qFromLittleEndian(value);
+}
+
+inline quint64 accumulate(quint64 acc, quint64 lane) {
+    acc += lane * kPrime2;
+    acc = rotateLeft(acc, 31);
+    return acc * kPrime1;
+}
+
+inline quint64 mergeAccumulator(quint64 hash, quint64 acc) {
+    hash ^= accumulate(0, acc);
+    return hash * kPrime1 + kPrime4;
+}
+
+} // anonymous namespace
+
+quint64 xxHash64(const void* pData, std::size_t size, quint64 seed) {
+    const auto* pInput = static_cast<const unsigned char*>(pData);
+    const unsigned char* const pEnd = pInput + size;
+
+    quint64 hash;
+    if (size >= kStripeSize) {
+        quint64 acc1 = seed + kPrime1 + kPrime2;
+        quint64 acc2 = seed + kPrime2;
+        quint64 acc3 = seed;
+        quint64 acc4 = seed - kPrime1;
+        const unsigned char* const pLastStripe = pEnd - kStripeSize;
+        do {
+            acc1 = accumulate(acc1, read64(pInput));
+            acc2 = accumulate(acc2, read64(pInput + 8));
+            acc3 = accumulate(acc3, read64(pInput + 16));
+            acc4 = accumulate(acc4, read64(pInput + 24));
+            pInput += kStripeSize;
+        } while (pInput <= pLastStripe);
+        hash = rotateLeft(acc1, 1) + rotateLeft(acc2, 7) +
+                rotateLeft(acc3, 12) + rotateLeft(acc4, 18);
+        hash = mergeAccumulator(hash, acc1);
+        hash = mergeAccumulator(hash, acc2);
+        hash = mergeAccumulator(hash, acc3);
+        hash = mergeAccumulator(hash, acc4);
+    } else {
+        hash = seed + kPrime5;
+    }
+    hash += static_cast<quint64>(size);
+
+    // Remaining bytes of the last incomplete stripe
+    for (; pInput + 8 <= pEnd; pInput += 8) {
+        hash ^= accumulate(0, read64(pInput));
+        hash = rotateLeft(hash, 27) * kPrime1 + kPrime4;
+    }
+    if (pInput + 4 <= pEnd) {
+        hash ^= static_cast<quint64>(read32(pInput)) * kPrime1;
+        hash = rotateLeft(hash, 23) * kPrime2 + kPrime3;
+        pInput += 4;
+    }
+    for (; pInput < pEnd; ++pInput) {
+        hash ^= static_cast<quint64>(*pInput) * kPrime5;
+        hash = rotateLeft(hash, 11) * kPrime1;
+    }
+
+    // Avalanche
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    hash *= kPrime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+} // namespace mixxx
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <QtGlobal>
+#include <cstddef>
+
+namespace mixxx {
+
+/// 64-bit XXH64 hash of a block of memory.
+///
+/// A fast, non-cryptographic hash function that is suitable for cache
+/// keys and for detecting accidental modifications, but not for
+/// detecting malicious ones. The result does not depend on the byte
+/// order of the host and could be persisted.
+///
+/// Reference: https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+quint64 xxHash64(const void* pData, std::size_t size, quint64 seed = 0);
+
+} // namespace mixxx
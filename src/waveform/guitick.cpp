@@ -1,7 +1,9 @@
 #include <QTimer>
 
 #include "waveform/guitick.h"
+#include "control/controlnotificationqueue.h"
 #include "control/controlobject.h"
+#include "control/controlsnapshot.h"
 
 GuiTick::GuiTick() {
     m_pCOGuiTickTime = std::make_unique<ControlObject>(ConfigKey("[Master]", "guiTickTime"));
@@ -12,6 +14,10 @@ GuiTick::GuiTick() {
 // this is called from WaveformWidgetFactory::render in the main thread with the
 // configured waveform frame rate
 void GuiTick::process() {
+    // Deliver the control changes from the engine thread once per frame
+    ControlNotificationQueue::dispatch();
+    ControlSnapshot::refreshAllIfEngineIdle();
+
     m_cpuTimeLastTick += m_cpuTimer.restart();
     double cpuTimeLastTickSeconds = m_cpuTimeLastTick.toDoubleSeconds();
     m_pCOGuiTickTime->set(cpuTimeLastTickSeconds);
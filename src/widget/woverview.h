@@ -16,8 +16,10 @@
 #include <QMouseEvent>
 #include <QPaintEvent>
 #include <QPixmap>
+#include <array>
 
 #include "analyzer/analyzerprogress.h"
+#include "control/controlsnapshot.h"
 #include "skin/legacy/skincontext.h"
 #include "track/track_decl.h"
 #include "track/trackid.h"
@@ -88,6 +90,10 @@ class WOverview : public WWidget, public TrackDropTarget {
             return 0.0;
         }
     }
+    /// The track samples of the timing snapshot, only valid while painting
+    double getPaintTrackSamples() const {
+        return m_trackLoaded ? m_timing[kTimingTrackSamples] : 0.0;
+    }
 
     QImage m_waveformSourceImage;
     QImage m_waveformImageScaled;
@@ -149,11 +155,20 @@ class WOverview : public WWidget, public TrackDropTarget {
     bool m_endOfTrack;
     bool m_bPassthroughEnabled;
     ControlProxy* m_pRateRatioControl;
-    ControlProxy* m_trackSampleRateControl;
     ControlProxy* m_trackSamplesControl;
-    ControlProxy* m_playpositionControl;
     ControlProxy* m_pPassthroughControl;
 
+    /// The controls that are updated by the engine, read once per paint
+    /// event for consistent values in all labels.
+    enum TimingControl {
+        kTimingPlayPosition,
+        kTimingTrackSamples,
+        kTimingTrackSampleRate,
+        kTimingControlCount,
+    };
+    ControlSnapshot m_timingSnapshot;
+    std::array<double, kTimingControlCount> m_timing;
+
     // Current active track
     TrackPointer m_pCurrentTrack;
     ConstWaveformPointer m_pWaveform;
@@ -1141,17 +1141,49 @@ void WTrackMenu::slotUpdateReplayGainFromPregain() {
 }
 
 void WTrackMenu::slotImportMetadataFromFileTags() {
+    const auto pTrackPointerIter = newTrackPointerIterator();
+    if (!pTrackPointerIter) {
+        // Empty, i.e. nothing to do
+        return;
+    }
+    // Load all tracks upfront to parse their files concurrently while
+    // the operation is applied to one track after another
+    const auto syncParams = SyncTrackMetadataParams::readFromUserSettings(*m_pConfig);
+    TrackPointerList tracks;
+    QList<mixxx::TrackMetadataPrefetcher::Request> prefetchRequests;
+    while (auto nextTrackPointer = pTrackPointerIter->nextItem()) {
+        const auto pTrack = *nextTrackPointer;
+        if (!pTrack) {
+            continue;
+        }
+        mixxx::TrackMetadataPrefetcher::Request request;
+        request.fileAccess = pTrack->getFileAccess();
+        request.trackMetadata = pTrack->getMetadata();
+        request.resetMissingTagMetadata = syncParams.resetMissingTagMetadataOnImport;
+        prefetchRequests.append(std::move(request));
+        tracks.append(pTrack);
+    }
+    const auto prefetchBatchId =
+            SoundSourceProxy::prefetchTrackMetadata(prefetchRequests);
+
     const auto progressLabelText =
-            tr("Importing metadata of %n track(s) from file tags", "", getTrackCount());
+            tr("Importing metadata of %n track(s) from file tags", "", tracks.size());
     const auto trackOperator =
             ImportMetadataFromFileTagsTrackPointerOperation(*m_pConfig);
-    applyTrackPointerOperation(
-            progressLabelText,
+    mixxx::TrackPointerListIterator trackPointerListIter(tracks);
+    mixxx::ModalTrackBatchOperationProcessor modalOperation(
             &trackOperator,
             // Update the database to reflect the recent changes. This is
             // crucial for additional metadata like custom tags that are
             // directly fetched from the database for certain use cases!
             mixxx::ModalTrackBatchOperationProcessor::Mode::ApplyAndSave);
+    modalOperation.processTracks(
+            progressLabelText,
+            m_pLibrary->trackCollectionManager(),
+            &trackPointerListIter);
+    // Only needed if the operation has been aborted. Doesn't affect the
+    // prefetching of a concurrent library scan.
+    SoundSourceProxy::cancelPrefetchingTrackMetadata(prefetchBatchId);
 }
 
 namespace {
@@ -1963,6 +1995,9 @@ class RemoveTrackFilesFromDiskTrackPointerOperation : public mixxx::TrackPointer
             return;
         }
         QString location = pTrack->getLocation();
+        // Pooled decoders keep the file open, which prevents deleting
+        // it on some platforms
+        SoundSourceProxy::evictFromSoundSourcePool(pTrack->getFileInfo());
         QFile file(location);
         if (file.exists() && !file.remove()) {
             // Deletion failed, log warning and queue location for the